@@ -0,0 +1,458 @@
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <algorithm>
+#include <vector>
+
+#include "render_backend.h"
+
+#include "frame_graph.h"
+
+static const uint32_t g_frame_graph_invalid_index = 0XFFFFFFFFU;
+// the physical texture unused for more frames is destroyed (e.g. the transient textures of the old resolution)
+static const uint32_t g_frame_graph_max_unused_frame_count = 4U;
+
+static inline bool frame_graph_texture_desc_equal(render_backend_texture_desc_t const &a, render_backend_texture_desc_t const &b);
+
+static inline RENDER_BACKEND_TEXTURE_STATE frame_graph_initial_texture_state(render_backend_texture_desc_t const &desc);
+
+void FrameGraph::Init(RenderBackend *render_backend)
+{
+	m_render_backend = render_backend;
+	m_compiled = false;
+	memset(&m_statistics, 0, sizeof(frame_graph_statistics_t));
+}
+
+void FrameGraph::Destroy()
+{
+	for (size_t physical_index = 0U; physical_index < m_physical_textures.size(); ++physical_index)
+	{
+		m_render_backend->DestroyTexture(m_physical_textures[physical_index].texture);
+	}
+	m_physical_textures.clear();
+
+	m_resources.clear();
+	m_passes.clear();
+	m_compiled = false;
+}
+
+void FrameGraph::Reset()
+{
+	m_resources.clear();
+	m_passes.clear();
+	m_compiled = false;
+}
+
+frame_graph_resource_t FrameGraph::ImportTexture(render_backend_texture_t *texture, RENDER_BACKEND_TEXTURE_STATE state)
+{
+	assert(!m_compiled);
+
+	resource_t resource;
+	memset(&resource, 0, sizeof(resource_t));
+	resource.imported = true;
+	resource.imported_texture = texture;
+	resource.imported_state = state;
+	resource.physical_index = g_frame_graph_invalid_index;
+	m_resources.push_back(resource);
+
+	return static_cast<frame_graph_resource_t>(m_resources.size() - 1U);
+}
+
+frame_graph_resource_t FrameGraph::CreateTexture(render_backend_texture_desc_t const &desc)
+{
+	assert(!m_compiled);
+
+	resource_t resource;
+	memset(&resource, 0, sizeof(resource_t));
+	resource.desc = desc;
+	resource.imported = false;
+	resource.imported_texture = NULL;
+	resource.physical_index = g_frame_graph_invalid_index;
+	m_resources.push_back(resource);
+
+	return static_cast<frame_graph_resource_t>(m_resources.size() - 1U);
+}
+
+frame_graph_pass_t FrameGraph::AddPass(char const *name, pfn_frame_graph_execute_t execute, void *user_data)
+{
+	assert(!m_compiled);
+
+	pass_t pass;
+	pass.name = name;
+	pass.execute = execute;
+	pass.user_data = user_data;
+	pass.read_count = 0U;
+	for (uint32_t slot = 0U; slot < RENDER_BACKEND_MAX_COLOR_ATTACHMENT_COUNT; ++slot)
+	{
+		pass.color_attachments[slot] = g_frame_graph_invalid_index;
+		pass.clear_color[slot] = false;
+		pass.clear_color_value[slot][0] = 0.0f;
+		pass.clear_color_value[slot][1] = 0.0f;
+		pass.clear_color_value[slot][2] = 0.0f;
+		pass.clear_color_value[slot][3] = 0.0f;
+	}
+	pass.color_attachment_count = 0U;
+	pass.depth_attachment = g_frame_graph_invalid_index;
+	pass.clear_depth = false;
+	pass.clear_depth_value = 1.0f;
+	pass.side_effect = false;
+	pass.culled = false;
+	m_passes.push_back(pass);
+
+	return static_cast<frame_graph_pass_t>(m_passes.size() - 1U);
+}
+
+void FrameGraph::AddRead(frame_graph_pass_t pass_index, frame_graph_resource_t resource)
+{
+	assert(!m_compiled && pass_index < m_passes.size() && resource < m_resources.size());
+
+	pass_t &pass = m_passes[pass_index];
+	assert(pass.read_count < FRAME_GRAPH_MAX_PASS_READ_COUNT);
+	// the backbuffer can NOT be sampled
+	assert(!(m_resources[resource].imported && NULL == m_resources[resource].imported_texture));
+	pass.reads[pass.read_count] = resource;
+	++pass.read_count;
+}
+
+void FrameGraph::SetColorAttachment(frame_graph_pass_t pass_index, uint32_t slot, frame_graph_resource_t resource, bool clear, float const clear_color_value[4])
+{
+	assert(!m_compiled && pass_index < m_passes.size() && resource < m_resources.size() && slot < RENDER_BACKEND_MAX_COLOR_ATTACHMENT_COUNT);
+
+	pass_t &pass = m_passes[pass_index];
+	pass.color_attachments[slot] = resource;
+	pass.clear_color[slot] = clear;
+	if (clear)
+	{
+		pass.clear_color_value[slot][0] = clear_color_value[0];
+		pass.clear_color_value[slot][1] = clear_color_value[1];
+		pass.clear_color_value[slot][2] = clear_color_value[2];
+		pass.clear_color_value[slot][3] = clear_color_value[3];
+	}
+	pass.color_attachment_count = std::max(pass.color_attachment_count, slot + 1U);
+}
+
+void FrameGraph::SetDepthAttachment(frame_graph_pass_t pass_index, frame_graph_resource_t resource, bool clear, float clear_depth_value)
+{
+	assert(!m_compiled && pass_index < m_passes.size() && resource < m_resources.size());
+
+	pass_t &pass = m_passes[pass_index];
+	pass.depth_attachment = resource;
+	pass.clear_depth = clear;
+	pass.clear_depth_value = clear_depth_value;
+}
+
+void FrameGraph::SetSideEffect(frame_graph_pass_t pass_index)
+{
+	assert(!m_compiled && pass_index < m_passes.size());
+
+	m_passes[pass_index].side_effect = true;
+}
+
+void FrameGraph::Compile()
+{
+	assert(!m_compiled);
+
+	uint32_t const pass_count = static_cast<uint32_t>(m_passes.size());
+	uint32_t const resource_count = static_cast<uint32_t>(m_resources.size());
+
+	m_statistics.pass_count = pass_count;
+	m_statistics.culled_pass_count = 0U;
+	m_statistics.resource_count = resource_count;
+	m_statistics.transient_texture_count = 0U;
+	m_statistics.physical_texture_count = 0U;
+	m_statistics.created_texture_count = 0U;
+	m_statistics.destroyed_texture_count = 0U;
+
+	// culling: the backward liveness, the imported textures outlive the frame
+	for (uint32_t resource_index = 0U; resource_index < resource_count; ++resource_index)
+	{
+		m_resources[resource_index].needed = m_resources[resource_index].imported;
+	}
+
+	for (uint32_t pass_index = pass_count; pass_index > 0U; --pass_index)
+	{
+		pass_t &pass = m_passes[pass_index - 1U];
+
+		bool color_needed = false;
+		for (uint32_t slot = 0U; slot < pass.color_attachment_count; ++slot)
+		{
+			// the slots are contiguous
+			assert(g_frame_graph_invalid_index != pass.color_attachments[slot]);
+			color_needed = color_needed || m_resources[pass.color_attachments[slot]].needed;
+		}
+		bool const depth_needed = (g_frame_graph_invalid_index != pass.depth_attachment) && m_resources[pass.depth_attachment].needed;
+		pass.culled = !(pass.side_effect || color_needed || depth_needed);
+		if (pass.culled)
+		{
+			++m_statistics.culled_pass_count;
+			continue;
+		}
+
+		// the cleared attachment does NOT depend on the previous contents, the loaded one reads them (the earlier writer is needed even if nothing else reads the attachment)
+		for (uint32_t slot = 0U; slot < pass.color_attachment_count; ++slot)
+		{
+			m_resources[pass.color_attachments[slot]].needed = !pass.clear_color[slot];
+		}
+
+		if (g_frame_graph_invalid_index != pass.depth_attachment)
+		{
+			m_resources[pass.depth_attachment].needed = !pass.clear_depth;
+		}
+
+		for (uint32_t read_index = 0U; read_index < pass.read_count; ++read_index)
+		{
+			m_resources[pass.reads[read_index]].needed = true;
+		}
+	}
+
+	// lifetimes
+	for (uint32_t resource_index = 0U; resource_index < resource_count; ++resource_index)
+	{
+		m_resources[resource_index].first_pass_index = g_frame_graph_invalid_index;
+		m_resources[resource_index].last_pass_index = 0U;
+		m_resources[resource_index].physical_index = g_frame_graph_invalid_index;
+	}
+
+	for (uint32_t pass_index = 0U; pass_index < pass_count; ++pass_index)
+	{
+		pass_t const &pass = m_passes[pass_index];
+		if (pass.culled)
+		{
+			continue;
+		}
+
+		frame_graph_resource_t used_resources[FRAME_GRAPH_MAX_PASS_RESOURCE_COUNT];
+		uint32_t const used_resource_count = this->GetPassResources(pass, used_resources);
+		for (uint32_t used_index = 0U; used_index < used_resource_count; ++used_index)
+		{
+			resource_t &resource = m_resources[used_resources[used_index]];
+			resource.first_pass_index = std::min(resource.first_pass_index, pass_index);
+			resource.last_pass_index = std::max(resource.last_pass_index, pass_index);
+		}
+	}
+
+	// aliasing
+	// the physical textures of the previous frames which have been unused for too long are destroyed before any index is assigned
+	for (size_t physical_index = 0U; physical_index < m_physical_textures.size();)
+	{
+		if (m_physical_textures[physical_index].unused_frame_count >= g_frame_graph_max_unused_frame_count)
+		{
+			m_render_backend->DestroyTexture(m_physical_textures[physical_index].texture);
+			m_physical_textures[physical_index] = m_physical_textures.back();
+			m_physical_textures.pop_back();
+			++m_statistics.destroyed_texture_count;
+		}
+		else
+		{
+			m_physical_textures[physical_index].busy_until_pass_index = g_frame_graph_invalid_index;
+			++m_physical_textures[physical_index].unused_frame_count;
+			++physical_index;
+		}
+	}
+
+	// the transient textures are assigned in the order of the first use, such that the free physical texture is the one of which the owner has ended
+	for (uint32_t pass_index = 0U; pass_index < pass_count; ++pass_index)
+	{
+		pass_t const &pass = m_passes[pass_index];
+		if (pass.culled)
+		{
+			continue;
+		}
+
+		frame_graph_resource_t used_resources[FRAME_GRAPH_MAX_PASS_RESOURCE_COUNT];
+		uint32_t const used_resource_count = this->GetPassResources(pass, used_resources);
+		for (uint32_t used_index = 0U; used_index < used_resource_count; ++used_index)
+		{
+			resource_t &resource = m_resources[used_resources[used_index]];
+			// the same texture may be read more than once by the pass
+			if (!resource.imported && pass_index == resource.first_pass_index && g_frame_graph_invalid_index == resource.physical_index)
+			{
+				resource.physical_index = this->AcquirePhysicalTexture(resource.desc, resource.first_pass_index, resource.last_pass_index);
+				++m_statistics.transient_texture_count;
+			}
+		}
+	}
+
+	for (size_t physical_index = 0U; physical_index < m_physical_textures.size(); ++physical_index)
+	{
+		m_statistics.physical_texture_count += (0U == m_physical_textures[physical_index].unused_frame_count) ? 1U : 0U;
+	}
+
+	m_compiled = true;
+}
+
+uint32_t FrameGraph::GetPassResources(pass_t const &pass, frame_graph_resource_t resources[FRAME_GRAPH_MAX_PASS_RESOURCE_COUNT]) const
+{
+	uint32_t resource_count = 0U;
+	for (uint32_t read_index = 0U; read_index < pass.read_count; ++read_index)
+	{
+		resources[resource_count++] = pass.reads[read_index];
+	}
+	for (uint32_t slot = 0U; slot < pass.color_attachment_count; ++slot)
+	{
+		resources[resource_count++] = pass.color_attachments[slot];
+	}
+	if (g_frame_graph_invalid_index != pass.depth_attachment)
+	{
+		resources[resource_count++] = pass.depth_attachment;
+	}
+	return resource_count;
+}
+
+uint32_t FrameGraph::AcquirePhysicalTexture(render_backend_texture_desc_t const &desc, uint32_t first_pass_index, uint32_t last_pass_index)
+{
+	for (size_t physical_index = 0U; physical_index < m_physical_textures.size(); ++physical_index)
+	{
+		physical_texture_t &physical_texture = m_physical_textures[physical_index];
+		bool const free = (g_frame_graph_invalid_index == physical_texture.busy_until_pass_index) || (physical_texture.busy_until_pass_index < first_pass_index);
+		if (free && frame_graph_texture_desc_equal(desc, physical_texture.desc))
+		{
+			physical_texture.busy_until_pass_index = last_pass_index;
+			physical_texture.unused_frame_count = 0U;
+			return static_cast<uint32_t>(physical_index);
+		}
+	}
+
+	physical_texture_t physical_texture;
+	physical_texture.desc = desc;
+	physical_texture.texture = m_render_backend->CreateTexture(desc, NULL);
+	assert(NULL != physical_texture.texture);
+	physical_texture.state = frame_graph_initial_texture_state(desc);
+	physical_texture.busy_until_pass_index = last_pass_index;
+	physical_texture.unused_frame_count = 0U;
+	m_physical_textures.push_back(physical_texture);
+	++m_statistics.created_texture_count;
+
+	return static_cast<uint32_t>(m_physical_textures.size() - 1U);
+}
+
+void FrameGraph::TransitionTexture(frame_graph_resource_t resource_index, RENDER_BACKEND_TEXTURE_STATE state)
+{
+	resource_t &resource = m_resources[resource_index];
+
+	RENDER_BACKEND_TEXTURE_STATE *current_state;
+	render_backend_texture_t *texture;
+	if (resource.imported)
+	{
+		// the backbuffer is only the attachment
+		if (NULL == resource.imported_texture)
+		{
+			return;
+		}
+		current_state = &resource.imported_state;
+		texture = resource.imported_texture;
+	}
+	else
+	{
+		current_state = &m_physical_textures[resource.physical_index].state;
+		texture = m_physical_textures[resource.physical_index].texture;
+	}
+
+	if (state != (*current_state))
+	{
+		m_render_backend->Barrier(texture, (*current_state), state);
+		(*current_state) = state;
+		++m_statistics.barrier_count;
+	}
+}
+
+void FrameGraph::Execute()
+{
+	assert(m_compiled);
+
+	m_statistics.barrier_count = 0U;
+
+	for (uint32_t pass_index = 0U; pass_index < static_cast<uint32_t>(m_passes.size()); ++pass_index)
+	{
+		pass_t const &pass = m_passes[pass_index];
+		if (pass.culled)
+		{
+			continue;
+		}
+
+		// the pass without the color attachment is NOT supported by the "RenderBackend" (NULL is the backbuffer)
+		assert(pass.color_attachment_count > 0U);
+
+		for (uint32_t read_index = 0U; read_index < pass.read_count; ++read_index)
+		{
+			this->TransitionTexture(pass.reads[read_index], RENDER_BACKEND_TEXTURE_STATE_SAMPLED);
+		}
+
+		for (uint32_t slot = 0U; slot < pass.color_attachment_count; ++slot)
+		{
+			this->TransitionTexture(pass.color_attachments[slot], RENDER_BACKEND_TEXTURE_STATE_COLOR_ATTACHMENT);
+		}
+
+		if (g_frame_graph_invalid_index != pass.depth_attachment)
+		{
+			this->TransitionTexture(pass.depth_attachment, RENDER_BACKEND_TEXTURE_STATE_DEPTH_ATTACHMENT);
+		}
+
+		render_backend_pass_desc_t pass_desc;
+		pass_desc.color_attachment_count = pass.color_attachment_count;
+		for (uint32_t slot = 0U; slot < pass.color_attachment_count; ++slot)
+		{
+			pass_desc.color_attachments[slot] = this->GetTexture(pass.color_attachments[slot]);
+			pass_desc.clear_color[slot] = pass.clear_color[slot];
+			pass_desc.clear_color_value[slot][0] = pass.clear_color_value[slot][0];
+			pass_desc.clear_color_value[slot][1] = pass.clear_color_value[slot][1];
+			pass_desc.clear_color_value[slot][2] = pass.clear_color_value[slot][2];
+			pass_desc.clear_color_value[slot][3] = pass.clear_color_value[slot][3];
+		}
+		pass_desc.depth_attachment = (g_frame_graph_invalid_index != pass.depth_attachment) ? this->GetTexture(pass.depth_attachment) : NULL;
+		pass_desc.clear_depth = pass.clear_depth;
+		pass_desc.clear_depth_value = pass.clear_depth_value;
+
+		m_render_backend->BeginPass(pass_desc);
+		pass.execute(m_render_backend, this, pass.user_data);
+		m_render_backend->EndPass();
+	}
+}
+
+render_backend_texture_t *FrameGraph::GetTexture(frame_graph_resource_t resource_index) const
+{
+	assert(m_compiled && resource_index < m_resources.size());
+
+	resource_t const &resource = m_resources[resource_index];
+	if (resource.imported)
+	{
+		return resource.imported_texture;
+	}
+
+	// the texture which is NOT used by any pass (e.g. all the users are culled) has no physical texture
+	assert(g_frame_graph_invalid_index != resource.physical_index);
+	return m_physical_textures[resource.physical_index].texture;
+}
+
+bool FrameGraph::IsPassCulled(frame_graph_pass_t pass_index) const
+{
+	assert(m_compiled && pass_index < m_passes.size());
+
+	return m_passes[pass_index].culled;
+}
+
+frame_graph_statistics_t const &FrameGraph::GetStatistics() const
+{
+	return m_statistics;
+}
+
+static inline bool frame_graph_texture_desc_equal(render_backend_texture_desc_t const &a, render_backend_texture_desc_t const &b)
+{
+	return a.width == b.width && a.height == b.height && a.depth == b.depth && a.mip_level_count == b.mip_level_count && a.format == b.format && a.usage == b.usage && a.view_dimension == b.view_dimension;
+}
+
+static inline RENDER_BACKEND_TEXTURE_STATE frame_graph_initial_texture_state(render_backend_texture_desc_t const &desc)
+{
+	if (0U != (desc.usage & RENDER_BACKEND_TEXTURE_USAGE_COLOR_ATTACHMENT))
+	{
+		return RENDER_BACKEND_TEXTURE_STATE_COLOR_ATTACHMENT;
+	}
+	else if (0U != (desc.usage & RENDER_BACKEND_TEXTURE_USAGE_DEPTH_ATTACHMENT))
+	{
+		return RENDER_BACKEND_TEXTURE_STATE_DEPTH_ATTACHMENT;
+	}
+	else
+	{
+		return RENDER_BACKEND_TEXTURE_STATE_SAMPLED;
+	}
+}
@@ -0,0 +1,152 @@
+#ifndef _BACKEND_FRAME_GRAPH_H_
+#define _BACKEND_FRAME_GRAPH_H_ 1
+
+//
+// The passes of the frame declare the textures which they read (sample) and write (attach), and the graph sequences them on the "RenderBackend".
+// [O'Donnell 2017] [Yuriy O'Donnell. "FrameGraph: Extensible Rendering Architecture in Frostbite." GDC 2017.](https://www.gdcvault.com/play/1024612/FrameGraph-Extensible-Rendering-Architecture-in)
+//
+// Every frame: "Reset", declare the resources and the passes, "Compile", "Execute".
+// Compile:
+// 1. Culling: the pass is culled if nothing it writes is read by the later passes (or is imported, which outlives the frame).
+//    The attachment which is NOT cleared is loaded, which counts as the read of the previous contents.
+// 2. Lifetimes: the transient texture lives from the first to the last pass (NOT culled) which uses it.
+// 3. Aliasing: the transient textures of which the lifetimes do NOT overlap share the same physical texture if the descs are the same
+//    (e.g. the depth of the light pass is free to be reused after the light pass).
+//    The physical textures are kept across the frames, and destroyed when unused for a few frames.
+// Execute: the barriers (see "RenderBackend::Barrier") are inserted before each pass which uses the texture in the different state.
+//
+// The graph never allocates from the heap once the containers have grown to the size of the frame.
+//
+
+#include <stdint.h>
+#include <vector>
+
+#include "render_backend.h"
+
+// the index of the resource of the current frame
+typedef uint32_t frame_graph_resource_t;
+// the index of the pass of the current frame
+typedef uint32_t frame_graph_pass_t;
+
+#define FRAME_GRAPH_MAX_PASS_READ_COUNT 8U
+// the reads and the attachments
+#define FRAME_GRAPH_MAX_PASS_RESOURCE_COUNT (FRAME_GRAPH_MAX_PASS_READ_COUNT + RENDER_BACKEND_MAX_COLOR_ATTACHMENT_COUNT + 1U)
+
+class FrameGraph;
+
+// [in] render_backend: between the "BeginPass" and the "EndPass" of the pass
+// [in] frame_graph: "GetTexture" of the resources declared by the pass
+typedef void (*pfn_frame_graph_execute_t)(RenderBackend *render_backend, FrameGraph const *frame_graph, void *user_data);
+
+struct frame_graph_statistics_t
+{
+	// the last "Compile"
+	uint32_t pass_count;
+	uint32_t culled_pass_count;
+	uint32_t resource_count;
+	uint32_t transient_texture_count;
+	// the physical textures used by the frame (at most "transient_texture_count")
+	uint32_t physical_texture_count;
+	uint32_t created_texture_count;
+	uint32_t destroyed_texture_count;
+	// the last "Execute"
+	uint32_t barrier_count;
+};
+
+class FrameGraph
+{
+	struct resource_t
+	{
+		render_backend_texture_desc_t desc;
+		// imported: the texture is owned by the caller (NULL is the backbuffer)
+		bool imported;
+		render_backend_texture_t *imported_texture;
+		RENDER_BACKEND_TEXTURE_STATE imported_state;
+		// transient: the index of the physical texture (compiled)
+		uint32_t physical_index;
+		// the lifetime (compiled)
+		uint32_t first_pass_index;
+		uint32_t last_pass_index;
+		// the liveness of the culling (compiled)
+		bool needed;
+	};
+
+	struct pass_t
+	{
+		char const *name;
+		pfn_frame_graph_execute_t execute;
+		void *user_data;
+		frame_graph_resource_t reads[FRAME_GRAPH_MAX_PASS_READ_COUNT];
+		uint32_t read_count;
+		// -1: NOT written
+		frame_graph_resource_t color_attachments[RENDER_BACKEND_MAX_COLOR_ATTACHMENT_COUNT];
+		bool clear_color[RENDER_BACKEND_MAX_COLOR_ATTACHMENT_COUNT];
+		float clear_color_value[RENDER_BACKEND_MAX_COLOR_ATTACHMENT_COUNT][4];
+		// the slots after the last one set are NOT attached
+		uint32_t color_attachment_count;
+		frame_graph_resource_t depth_attachment;
+		bool clear_depth;
+		float clear_depth_value;
+		// the pass is never culled (e.g. the readback)
+		bool side_effect;
+		// compiled
+		bool culled;
+	};
+
+	struct physical_texture_t
+	{
+		render_backend_texture_desc_t desc;
+		render_backend_texture_t *texture;
+		RENDER_BACKEND_TEXTURE_STATE state;
+		// the last pass of the transient texture which currently owns the physical texture (-1: free in the current frame)
+		uint32_t busy_until_pass_index;
+		uint32_t unused_frame_count;
+	};
+
+	RenderBackend *m_render_backend;
+
+	std::vector<resource_t> m_resources;
+	std::vector<pass_t> m_passes;
+	std::vector<physical_texture_t> m_physical_textures;
+	bool m_compiled;
+
+	frame_graph_statistics_t m_statistics;
+
+	uint32_t GetPassResources(pass_t const &pass, frame_graph_resource_t resources[FRAME_GRAPH_MAX_PASS_RESOURCE_COUNT]) const;
+	uint32_t AcquirePhysicalTexture(render_backend_texture_desc_t const &desc, uint32_t first_pass_index, uint32_t last_pass_index);
+	void TransitionTexture(frame_graph_resource_t resource, RENDER_BACKEND_TEXTURE_STATE state);
+
+public:
+	void Init(RenderBackend *render_backend);
+	// destroys the physical textures
+	void Destroy();
+
+	// Starts the declaration of the new frame, the resources and the passes of the previous frame are discarded.
+	void Reset();
+
+	// [in] texture: NULL means the backbuffer
+	// [in] state: the state of the texture before the frame (ignored by the backbuffer), the texture is left in the state of its last use
+	frame_graph_resource_t ImportTexture(render_backend_texture_t *texture, RENDER_BACKEND_TEXTURE_STATE state);
+	// the physical texture is assigned by the "Compile", the contents are undefined until the first pass writes it
+	frame_graph_resource_t CreateTexture(render_backend_texture_desc_t const &desc);
+
+	// The passes are executed in the order of the declaration.
+	frame_graph_pass_t AddPass(char const *name, pfn_frame_graph_execute_t execute, void *user_data);
+	void AddRead(frame_graph_pass_t pass, frame_graph_resource_t resource);
+	// [in] slot: the render target index of the shader, the slots before it must be set as well (e.g. the G-buffer)
+	// [in] clear_color_value: ignored if "clear" is false (the previous contents are loaded)
+	void SetColorAttachment(frame_graph_pass_t pass, uint32_t slot, frame_graph_resource_t resource, bool clear, float const clear_color_value[4]);
+	void SetDepthAttachment(frame_graph_pass_t pass, frame_graph_resource_t resource, bool clear, float clear_depth_value);
+	void SetSideEffect(frame_graph_pass_t pass);
+
+	void Compile();
+	void Execute();
+
+	// valid within the "Execute" (NULL is the backbuffer)
+	render_backend_texture_t *GetTexture(frame_graph_resource_t resource) const;
+	bool IsPassCulled(frame_graph_pass_t pass) const;
+
+	frame_graph_statistics_t const &GetStatistics() const;
+};
+
+#endif
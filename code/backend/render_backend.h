@@ -0,0 +1,239 @@
+#ifndef _BACKEND_RENDER_BACKEND_H_
+#define _BACKEND_RENDER_BACKEND_H_ 1
+
+//
+// The thin interface between the "Demo" and the graphics API.
+//
+// The objects are opaque handles, each backend casts them to its own types.
+// The programs are fixed (the shaders of the demo), such that the backend owns the shader bytecode and the vertex input layout.
+// D3D11: "render_backend_d3d11.h"
+// Null: "render_backend_null.h" (records the command counts and the byte volumes)
+// CPU: "render_backend_cpu.h" (drives the software LTC renderer, see "cpu/software_renderer.h")
+//
+// The passes of the frame are sequenced by the frame graph ("frame_graph.h").
+//
+
+#include <stdint.h>
+
+struct render_backend_buffer_t;
+struct render_backend_texture_t;
+struct render_backend_sampler_t;
+struct render_backend_pipeline_t;
+
+enum RENDER_BACKEND_BUFFER_USAGE
+{
+	RENDER_BACKEND_BUFFER_USAGE_VERTEX = 0,
+	RENDER_BACKEND_BUFFER_USAGE_CONSTANT = 1
+};
+
+enum RENDER_BACKEND_FORMAT
+{
+	RENDER_BACKEND_FORMAT_R8G8B8A8_SNORM = 0,
+	RENDER_BACKEND_FORMAT_R8G8_UNORM = 1,
+	RENDER_BACKEND_FORMAT_R16G16B16A16_FLOAT = 2,
+	RENDER_BACKEND_FORMAT_D32_FLOAT = 3,
+	RENDER_BACKEND_FORMAT_R32G32B32A32_FLOAT = 4
+};
+
+enum RENDER_BACKEND_TEXTURE_USAGE
+{
+	RENDER_BACKEND_TEXTURE_USAGE_SAMPLED = 0X1,
+	RENDER_BACKEND_TEXTURE_USAGE_COLOR_ATTACHMENT = 0X2,
+	RENDER_BACKEND_TEXTURE_USAGE_DEPTH_ATTACHMENT = 0X4
+};
+
+// The texture is in exactly one state at a time (see "RenderBackend::Barrier").
+enum RENDER_BACKEND_TEXTURE_STATE
+{
+	RENDER_BACKEND_TEXTURE_STATE_SAMPLED = 0,
+	RENDER_BACKEND_TEXTURE_STATE_COLOR_ATTACHMENT = 1,
+	RENDER_BACKEND_TEXTURE_STATE_DEPTH_ATTACHMENT = 2
+};
+
+enum RENDER_BACKEND_TEXTURE_VIEW_DIMENSION
+{
+	RENDER_BACKEND_TEXTURE_VIEW_DIMENSION_2D = 0,
+	// the LTC LUTs are declared as the "Texture2DArray" in the shaders
+	RENDER_BACKEND_TEXTURE_VIEW_DIMENSION_2D_ARRAY = 1,
+	// only sampled (the tonemap LUT)
+	RENDER_BACKEND_TEXTURE_VIEW_DIMENSION_3D = 2
+};
+
+enum RENDER_BACKEND_FILTER
+{
+	RENDER_BACKEND_FILTER_MIN_POINT_MAG_LINEAR_MIP_POINT = 0,
+	RENDER_BACKEND_FILTER_MIN_MAG_MIP_LINEAR = 1
+};
+
+enum RENDER_BACKEND_PROGRAM
+{
+	// vertex input: POSITION (slot 0, float3), NORMAL (slot 1, float3)
+	// constant buffers 0, 1, 2: per view, per light set, per material (see "demo_uniform_buffer.h")
+	RENDER_BACKEND_PROGRAM_PLANE = 0,
+	// no vertex input
+	// constant buffers 0, 1: per view, per light set
+	RENDER_BACKEND_PROGRAM_RECT_LIGHT = 1,
+	// no vertex input, the full screen triangle
+	// sampler 0, texture 0: the HDR color
+	// sampler 1 (linear), texture 1: the tonemap LUT (3D, see "cpu/tonemap_lut.h")
+	// texture 2: the exposure (1x1, see the "AUTO_EXPOSURE"), the HDR color is multiplied by the "x" before the tone mapping
+	RENDER_BACKEND_PROGRAM_POST_PROCESS = 2,
+	// the same inputs as the "PLANE", writes the G-buffer instead of the lighting
+	// color attachments 0, 1, 2, 3: position (RGBA32F, w: coverage), normal (RGBA16F, w: roughness), diffuse color (RGBA16F), specular color (RGBA16F)
+	RENDER_BACKEND_PROGRAM_PLANE_GBUFFER = 3,
+	// no vertex input, the full screen triangle
+	// constant buffers 0, 1, 3: per view, per light set, per frame (the checkerboard packing of the color attachment)
+	// the same samplers and textures 0, 1, 2 as the "PLANE", textures 3, 4, 5, 6: the G-buffer (see the "PLANE_GBUFFER")
+	RENDER_BACKEND_PROGRAM_DEFERRED_LIGHTING = 4,
+	// the same inputs as the "PLANE", no pixel shader (only the depth is written, see "RENDER_BACKEND_DEPTH_TEST_EQUAL")
+	RENDER_BACKEND_PROGRAM_PLANE_DEPTH = 5,
+	// no vertex input, the full screen triangle
+	// constant buffers 0, 3: per view, per frame
+	// sampler 0: linear, textures 0, 1, 2, 3: the checkerboard of the "DEFERRED_LIGHTING", the G-buffer position, the G-buffer normal, the history (the output of the previous frame)
+	// the shaded pixels are copied, the skipped pixels are reconstructed by the reprojected history and the neighbors
+	RENDER_BACKEND_PROGRAM_CHECKERBOARD_RESOLVE = 6,
+	// no vertex input, the full screen triangle into the "AUTO_EXPOSURE_HISTOGRAM_BIN_COUNT x AUTO_EXPOSURE_HISTOGRAM_GROUP_COUNT" target (RGBA32F, see "cpu/auto_exposure.h")
+	// sampler 0: linear, texture 0: the HDR color
+	// the "x" of the texel (bin, group) is the count of the taps of the rows of the group which fall into the bin, the histogram is the sum over the groups
+	RENDER_BACKEND_PROGRAM_AUTO_EXPOSURE_HISTOGRAM = 7,
+	// no vertex input, the full screen triangle into the 1x1 target (RGBA32F, x: the exposure, y: the adapted log2 luminance)
+	// constant buffer 3: per frame
+	// textures 0, 1: the histogram of the "AUTO_EXPOSURE_HISTOGRAM", the exposure of the previous frame
+	RENDER_BACKEND_PROGRAM_AUTO_EXPOSURE = 8,
+	RENDER_BACKEND_PROGRAM_COUNT = 9
+};
+
+enum RENDER_BACKEND_DEPTH_TEST
+{
+	// neither tested nor written
+	RENDER_BACKEND_DEPTH_TEST_NONE = 0,
+	// "less", written
+	RENDER_BACKEND_DEPTH_TEST_LESS = 1,
+	// "equal", NOT written
+	// The draw after the depth pre-pass of the same geometry (by the same vertex shader) only shades the visible fragments.
+	RENDER_BACKEND_DEPTH_TEST_EQUAL = 2,
+	RENDER_BACKEND_DEPTH_TEST_COUNT = 3
+};
+
+#define RENDER_BACKEND_MAX_COLOR_ATTACHMENT_COUNT 4U
+
+// The feature bits of the "PLANE" and the "DEFERRED_LIGHTING" programs (ignored by the other programs).
+// Every combination is compiled into the separate pixel shader by the build (see "LTC.vcxproj"), such that the pixel shader has no branches on the uniforms.
+enum RENDER_BACKEND_PERMUTATION_BIT
+{
+	// both the faces of the quad emit (the "twoSided" of the light set is NOT read by the shader)
+	RENDER_BACKEND_PERMUTATION_TWO_SIDED_BIT = 0x1,
+	// Burley, otherwise Lambert
+	RENDER_BACKEND_PERMUTATION_DIFFUSE_BURLEY_BIT = 0x2,
+	// the dual specular lobes, otherwise the single GGX lobe
+	RENDER_BACKEND_PERMUTATION_DUAL_LOBE_BIT = 0x4,
+	// the quad straddling the horizon is clipped, otherwise approximated by the proxy sphere
+	RENDER_BACKEND_PERMUTATION_HORIZON_CLIPPING_BIT = 0x8,
+	RENDER_BACKEND_PERMUTATION_COUNT = 16
+};
+
+struct render_backend_subresource_data_t
+{
+	void const *data;
+	uint32_t row_pitch;
+	uint32_t slice_pitch;
+};
+
+struct render_backend_texture_desc_t
+{
+	uint32_t width;
+	uint32_t height;
+	// 1 unless the view dimension is 3D
+	uint32_t depth;
+	uint32_t mip_level_count;
+	RENDER_BACKEND_FORMAT format;
+	// RENDER_BACKEND_TEXTURE_USAGE
+	uint32_t usage;
+	RENDER_BACKEND_TEXTURE_VIEW_DIMENSION view_dimension;
+};
+
+struct render_backend_pipeline_desc_t
+{
+	RENDER_BACKEND_PROGRAM program;
+	// RENDER_BACKEND_PERMUTATION_BIT
+	uint32_t permutation;
+	// the back faces are always culled
+	bool front_counter_clockwise;
+	// only takes effect when the pass has the depth attachment
+	RENDER_BACKEND_DEPTH_TEST depth_test;
+};
+
+struct render_backend_pass_desc_t
+{
+	// at least one, the same size
+	uint32_t color_attachment_count;
+	// NULL means the backbuffer (only as the single color attachment)
+	render_backend_texture_t *color_attachments[RENDER_BACKEND_MAX_COLOR_ATTACHMENT_COUNT];
+	bool clear_color[RENDER_BACKEND_MAX_COLOR_ATTACHMENT_COUNT];
+	float clear_color_value[RENDER_BACKEND_MAX_COLOR_ATTACHMENT_COUNT][4];
+	// NULL means no depth
+	render_backend_texture_t *depth_attachment;
+	bool clear_depth;
+	float clear_depth_value;
+};
+
+class RenderBackend
+{
+public:
+	virtual ~RenderBackend() {}
+
+	virtual char const *GetName() const = 0;
+
+	virtual uint32_t GetBackbufferWidth() const = 0;
+	virtual uint32_t GetBackbufferHeight() const = 0;
+
+	// The duration of the passes of the most recent frame which has completed on the device, from the first "BeginPass" to the "Present" (ms).
+	// The device runs behind the "Present", such that the value lags by the frames in flight (the controller of the dynamic resolution, see "cpu/dynamic_resolution.h").
+	// [return] negative if no frame has completed yet, or if the backend does NOT measure it
+	virtual float GetGPUFrameTime() const = 0;
+
+	// The live resize: only the backbuffer is recreated (the contents are undefined), the other objects are kept.
+	// Called between the frames (no pass is active), the size is NOT 0.
+	virtual void ResizeBackbuffer(uint32_t width, uint32_t height) = 0;
+
+	// [in] data: NULL means uninitialized
+	virtual render_backend_buffer_t *CreateBuffer(RENDER_BACKEND_BUFFER_USAGE usage, uint32_t size, void const *data) = 0;
+	virtual void DestroyBuffer(render_backend_buffer_t *buffer) = 0;
+
+	// [in] subresource_data: one per mip level, NULL means uninitialized (the "slice_pitch" of the 3D texture is the size of one depth slice)
+	virtual render_backend_texture_t *CreateTexture(render_backend_texture_desc_t const &desc, render_backend_subresource_data_t const *subresource_data) = 0;
+	virtual void DestroyTexture(render_backend_texture_t *texture) = 0;
+
+	// the address mode is always "clamp"
+	virtual render_backend_sampler_t *CreateSampler(RENDER_BACKEND_FILTER filter) = 0;
+	virtual void DestroySampler(render_backend_sampler_t *sampler) = 0;
+
+	virtual render_backend_pipeline_t *CreatePipeline(render_backend_pipeline_desc_t const &desc) = 0;
+	virtual void DestroyPipeline(render_backend_pipeline_t *pipeline) = 0;
+
+	// the whole buffer is updated
+	virtual void UpdateBuffer(render_backend_buffer_t *buffer, void const *data, uint32_t size) = 0;
+
+	// The viewport is the size of the attachments.
+	// The bindings persist across the passes, the texture sampled by the previous pass must be transitioned by the "Barrier" before it is used as the attachment.
+	virtual void BeginPass(render_backend_pass_desc_t const &desc) = 0;
+	virtual void EndPass() = 0;
+
+	// The hazard between the sampling and the attachment (inserted by the frame graph, see "frame_graph.h").
+	// D3D11: the views of the "before" state which are still bound are unbound.
+	virtual void Barrier(render_backend_texture_t *texture, RENDER_BACKEND_TEXTURE_STATE before, RENDER_BACKEND_TEXTURE_STATE after) = 0;
+
+	virtual void SetPipeline(render_backend_pipeline_t *pipeline) = 0;
+	virtual void SetVertexBuffers(uint32_t first_slot, uint32_t buffer_count, render_backend_buffer_t *const *buffers, uint32_t const *strides) = 0;
+	// bound to both the vertex and the fragment stages
+	virtual void SetConstantBuffer(uint32_t slot, render_backend_buffer_t *buffer) = 0;
+	// bound to the fragment stage
+	virtual void SetTexture(uint32_t slot, render_backend_texture_t *texture) = 0;
+	virtual void SetSampler(uint32_t slot, render_backend_sampler_t *sampler) = 0;
+	// the triangle strip, not instanced
+	virtual void Draw(uint32_t vertex_count) = 0;
+
+	virtual void Present() = 0;
+};
+
+#endif
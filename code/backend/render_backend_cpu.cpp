@@ -0,0 +1,946 @@
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <cmath>
+#include <algorithm>
+#include <new>
+#include <vector>
+
+#include "../cpu/thread_pool.h"
+#include "../cpu/software_renderer.h"
+#include "../cpu/tonemap_encoder.h"
+#include "../cpu/shared_framebuffer.h"
+
+#include "../demo_uniform_buffer.h"
+
+#include "render_backend_cpu.h"
+
+struct cpu_buffer_t
+{
+	std::vector<uint8_t> data;
+};
+
+struct cpu_texture_t
+{
+	render_backend_texture_desc_t desc;
+	// RGBA32F, only the color attachments are stored (the sampled textures of the demo are the LUTs, which the software renderer has its own)
+	std::vector<float> color;
+};
+
+struct cpu_pipeline_t
+{
+	render_backend_pipeline_desc_t desc;
+};
+
+// "SampleLevel" of the linear clamp sampler
+static inline void cpu_sample_bilinear(cpu_texture_t const *texture, float u, float v, float color[3]);
+
+// the draws of the forward shading are rendered separately
+static inline void cpu_accumulate_statistics(software_renderer_statistics_t &sum, software_renderer_statistics_t const &statistics);
+
+void RenderBackendCPU::Init(ThreadPool *thread_pool, uint32_t width, uint32_t height, software_renderer_shadow_settings_t const &shadow_settings)
+{
+	m_thread_pool = thread_pool;
+	m_shadow_settings = shadow_settings;
+	m_renderer_initialized = false;
+	memset(&m_statistics, 0, sizeof(software_renderer_statistics_t));
+	m_frame_index = 0U;
+
+	m_frame_time_recording = false;
+	m_gpu_frame_time = -1.0f;
+
+	m_backbuffer_width = width;
+	m_backbuffer_height = height;
+	m_backbuffer.assign(static_cast<size_t>(width) * height * 4U, 0U);
+	m_backbuffer_target = &m_backbuffer[0];
+	m_backbuffer_acquired = false;
+	m_shared_framebuffer = NULL;
+	m_shared_framebuffer_writing = false;
+
+	m_auto_exposure_histogram.Init(thread_pool->GetThreadCount());
+
+	memset(&m_scene, 0, sizeof(software_renderer_scene_t));
+	m_gbuffer_drawn = false;
+
+	m_forward_draw_count = 0U;
+
+	for (uint32_t slot = 0U; slot < RENDER_BACKEND_MAX_COLOR_ATTACHMENT_COUNT; ++slot)
+	{
+		m_color_attachments[slot] = NULL;
+	}
+	m_color_attachment_count = 0U;
+	m_pass_active = false;
+	m_pipeline = NULL;
+	m_vertex_buffers[0] = NULL;
+	m_vertex_buffers[1] = NULL;
+	m_vertex_buffer_strides[0] = 0U;
+	m_vertex_buffer_strides[1] = 0U;
+	m_constant_buffers[0] = NULL;
+	m_constant_buffers[1] = NULL;
+	m_constant_buffers[2] = NULL;
+	m_constant_buffers[3] = NULL;
+	for (int texture_index = 0; texture_index < 4; ++texture_index)
+	{
+		m_textures[texture_index] = NULL;
+	}
+}
+
+void RenderBackendCPU::Destroy()
+{
+	if (m_renderer_initialized)
+	{
+		m_renderer.Destroy();
+		m_renderer_initialized = false;
+	}
+
+	m_backbuffer.clear();
+	m_auto_exposure_histogram.Destroy();
+	m_triangle_vertices.clear();
+	m_forward_depth.clear();
+}
+
+software_renderer_statistics_t const &RenderBackendCPU::GetStatistics() const
+{
+	return m_statistics;
+}
+
+uint8_t const *RenderBackendCPU::GetBackbuffer() const
+{
+	return m_backbuffer_target;
+}
+
+void RenderBackendCPU::SetSharedFramebuffer(SharedFramebuffer *shared_framebuffer)
+{
+	assert(!m_backbuffer_acquired);
+	m_shared_framebuffer = shared_framebuffer;
+	m_backbuffer_target = &m_backbuffer[0];
+}
+
+char const *RenderBackendCPU::GetName() const
+{
+	return "cpu";
+}
+
+uint32_t RenderBackendCPU::GetBackbufferWidth() const
+{
+	return m_backbuffer_width;
+}
+
+uint32_t RenderBackendCPU::GetBackbufferHeight() const
+{
+	return m_backbuffer_height;
+}
+
+float RenderBackendCPU::GetGPUFrameTime() const
+{
+	return m_gpu_frame_time;
+}
+
+void RenderBackendCPU::ResizeBackbuffer(uint32_t width, uint32_t height)
+{
+	assert(width > 0U && height > 0U && !m_pass_active);
+	m_backbuffer_width = width;
+	m_backbuffer_height = height;
+	// the capacity is kept, such that the smaller size never touches the heap
+	m_backbuffer.assign(static_cast<size_t>(width) * height * 4U, 0U);
+	m_backbuffer_target = &m_backbuffer[0];
+}
+
+render_backend_buffer_t *RenderBackendCPU::CreateBuffer(RENDER_BACKEND_BUFFER_USAGE, uint32_t size, void const *data)
+{
+	cpu_buffer_t *buffer = new (std::nothrow) cpu_buffer_t;
+	assert(NULL != buffer);
+	buffer->data.assign(size, 0U);
+	if (NULL != data)
+	{
+		memcpy(&buffer->data[0], data, size);
+	}
+	return reinterpret_cast<render_backend_buffer_t *>(buffer);
+}
+
+void RenderBackendCPU::DestroyBuffer(render_backend_buffer_t *buffer)
+{
+	delete reinterpret_cast<cpu_buffer_t *>(buffer);
+}
+
+render_backend_texture_t *RenderBackendCPU::CreateTexture(render_backend_texture_desc_t const &desc, render_backend_subresource_data_t const *subresource_data)
+{
+	cpu_texture_t *texture = new (std::nothrow) cpu_texture_t;
+	assert(NULL != texture);
+	texture->desc = desc;
+	if (0U != (desc.usage & RENDER_BACKEND_TEXTURE_USAGE_COLOR_ATTACHMENT))
+	{
+		texture->color.assign(static_cast<size_t>(desc.width) * desc.height * 4U, 0.0f);
+
+		// the other formats are only written by the draws
+		if (NULL != subresource_data && RENDER_BACKEND_FORMAT_R32G32B32A32_FLOAT == desc.format)
+		{
+			for (uint32_t y = 0U; y < desc.height; ++y)
+			{
+				memcpy(&texture->color[static_cast<size_t>(desc.width) * y * 4U], static_cast<uint8_t const *>(subresource_data[0].data) + static_cast<size_t>(subresource_data[0].row_pitch) * y, sizeof(float) * 4U * desc.width);
+			}
+		}
+	}
+	return reinterpret_cast<render_backend_texture_t *>(texture);
+}
+
+void RenderBackendCPU::DestroyTexture(render_backend_texture_t *texture)
+{
+	// the new texture may be allocated at the same address
+	for (int texture_index = 0; texture_index < 4; ++texture_index)
+	{
+		m_textures[texture_index] = (reinterpret_cast<cpu_texture_t *>(texture) != m_textures[texture_index]) ? m_textures[texture_index] : NULL;
+	}
+
+	delete reinterpret_cast<cpu_texture_t *>(texture);
+}
+
+render_backend_sampler_t *RenderBackendCPU::CreateSampler(RENDER_BACKEND_FILTER)
+{
+	// the post process samples the texel centers, the filter does not matter
+	return reinterpret_cast<render_backend_sampler_t *>(static_cast<uintptr_t>(16U));
+}
+
+void RenderBackendCPU::DestroySampler(render_backend_sampler_t *)
+{
+}
+
+render_backend_pipeline_t *RenderBackendCPU::CreatePipeline(render_backend_pipeline_desc_t const &desc)
+{
+	cpu_pipeline_t *pipeline = new (std::nothrow) cpu_pipeline_t;
+	assert(NULL != pipeline);
+	pipeline->desc = desc;
+	return reinterpret_cast<render_backend_pipeline_t *>(pipeline);
+}
+
+void RenderBackendCPU::DestroyPipeline(render_backend_pipeline_t *pipeline)
+{
+	delete reinterpret_cast<cpu_pipeline_t *>(pipeline);
+}
+
+void RenderBackendCPU::UpdateBuffer(render_backend_buffer_t *buffer_handle, void const *data, uint32_t size)
+{
+	cpu_buffer_t *buffer = reinterpret_cast<cpu_buffer_t *>(buffer_handle);
+	assert(size == buffer->data.size());
+	memcpy(&buffer->data[0], data, size);
+}
+
+void RenderBackendCPU::BeginPass(render_backend_pass_desc_t const &desc)
+{
+	assert(!m_pass_active);
+	m_pass_active = true;
+
+	if (!m_frame_time_recording)
+	{
+		m_frame_begin_time = std::chrono::steady_clock::now();
+		m_frame_time_recording = true;
+	}
+
+	assert(desc.color_attachment_count > 0U && desc.color_attachment_count <= RENDER_BACKEND_MAX_COLOR_ATTACHMENT_COUNT);
+	m_color_attachment_count = desc.color_attachment_count;
+	for (uint32_t slot = 0U; slot < desc.color_attachment_count; ++slot)
+	{
+		m_color_attachments[slot] = reinterpret_cast<cpu_texture_t *>(desc.color_attachments[slot]);
+		if (!desc.clear_color[slot])
+		{
+			continue;
+		}
+
+		if (NULL != m_color_attachments[slot])
+		{
+			cpu_texture_t *const color_attachment = m_color_attachments[slot];
+			size_t const pixel_count = static_cast<size_t>(color_attachment->desc.width) * color_attachment->desc.height;
+			for (size_t pixel_index = 0U; pixel_index < pixel_count; ++pixel_index)
+			{
+				memcpy(&color_attachment->color[4U * pixel_index], desc.clear_color_value[slot], sizeof(float) * 4U);
+			}
+		}
+		else
+		{
+			uint8_t clear_color_unorm[4];
+			for (int component = 0; component < 4; ++component)
+			{
+				clear_color_unorm[component] = static_cast<uint8_t>(std::min(std::max(desc.clear_color_value[slot][component], 0.0f), 1.0f) * 255.0f + 0.5f);
+			}
+			uint8_t *const backbuffer = this->AcquireBackbuffer();
+			size_t const pixel_count = static_cast<size_t>(m_backbuffer_width) * m_backbuffer_height;
+			for (size_t pixel_index = 0U; pixel_index < pixel_count; ++pixel_index)
+			{
+				memcpy(backbuffer + 4U * pixel_index, clear_color_unorm, 4U);
+			}
+		}
+	}
+
+	// the depth is resolved by the ray casting, the depth attachment is not used
+	m_triangle_vertices.clear();
+	m_gbuffer_drawn = false;
+	m_forward_draw_count = 0U;
+}
+
+void RenderBackendCPU::EndPass()
+{
+	assert(m_pass_active);
+	m_pass_active = false;
+
+	if (m_gbuffer_drawn)
+	{
+		this->PrepareRenderer();
+
+		// The BVH is rebuilt every pass, which is cheap for the demo scene (2 triangles per overdraw layer).
+		m_scene.triangle_vertices = m_triangle_vertices.empty() ? NULL : &m_triangle_vertices[0];
+		m_scene.triangle_count = static_cast<uint32_t>(m_triangle_vertices.size() / 9U);
+		m_renderer.SetScene(m_scene);
+		m_renderer.RenderGBuffer(m_thread_pool, m_statistics);
+
+		// "plane_gbuffer_fs.hlsl"
+		uint32_t const width = m_renderer.GetWidth();
+		float const *const position = m_renderer.GetPosition();
+		float const *const normal = m_renderer.GetNormal();
+		float const *const depth = m_renderer.GetDepth();
+		software_renderer_scene_t const &scene = m_scene;
+		cpu_texture_t *const *const color_attachments = m_color_attachments;
+		uint32_t const color_attachment_count = m_color_attachment_count;
+		m_thread_pool->ParallelFor(m_renderer.GetHeight(), 8U, [=, &scene](uint32_t begin, uint32_t end, uint32_t) {
+			for (size_t pixel_index = static_cast<size_t>(begin) * width; pixel_index < static_cast<size_t>(end) * width; ++pixel_index)
+			{
+				// the pixel NOT covered keeps the clear color
+				if (!(depth[pixel_index] < INFINITY))
+				{
+					continue;
+				}
+
+				float const gbuffer[4][4] = {
+					{position[3U * pixel_index + 0U], position[3U * pixel_index + 1U], position[3U * pixel_index + 2U], 1.0f},
+					{normal[3U * pixel_index + 0U], normal[3U * pixel_index + 1U], normal[3U * pixel_index + 2U], scene.roughness},
+					{scene.diffuse_color[0], scene.diffuse_color[1], scene.diffuse_color[2], 1.0f},
+					{scene.specular_color[0], scene.specular_color[1], scene.specular_color[2], 1.0f}};
+				for (uint32_t slot = 0U; slot < color_attachment_count; ++slot)
+				{
+					memcpy(&color_attachments[slot]->color[4U * pixel_index], gbuffer[slot], sizeof(float) * 4U);
+				}
+			}
+		});
+	}
+
+	for (uint32_t slot = 0U; slot < RENDER_BACKEND_MAX_COLOR_ATTACHMENT_COUNT; ++slot)
+	{
+		m_color_attachments[slot] = NULL;
+	}
+	m_color_attachment_count = 0U;
+	m_gbuffer_drawn = false;
+}
+
+void RenderBackendCPU::Barrier(render_backend_texture_t *texture, RENDER_BACKEND_TEXTURE_STATE before, RENDER_BACKEND_TEXTURE_STATE)
+{
+	// the same bookkeeping as the D3D11: the sampled texture is unbound before it becomes the attachment
+	if (RENDER_BACKEND_TEXTURE_STATE_SAMPLED == before)
+	{
+		for (int texture_index = 0; texture_index < 4; ++texture_index)
+		{
+			m_textures[texture_index] = (reinterpret_cast<cpu_texture_t *>(texture) != m_textures[texture_index]) ? m_textures[texture_index] : NULL;
+		}
+	}
+}
+
+void RenderBackendCPU::SetPipeline(render_backend_pipeline_t *pipeline)
+{
+	m_pipeline = reinterpret_cast<cpu_pipeline_t *>(pipeline);
+}
+
+void RenderBackendCPU::SetVertexBuffers(uint32_t first_slot, uint32_t buffer_count, render_backend_buffer_t *const *buffers, uint32_t const *strides)
+{
+	for (uint32_t buffer_index = 0U; buffer_index < buffer_count; ++buffer_index)
+	{
+		uint32_t const slot = first_slot + buffer_index;
+		if (slot < 2U)
+		{
+			m_vertex_buffers[slot] = reinterpret_cast<cpu_buffer_t *>(buffers[buffer_index]);
+			m_vertex_buffer_strides[slot] = strides[buffer_index];
+		}
+	}
+}
+
+void RenderBackendCPU::SetConstantBuffer(uint32_t slot, render_backend_buffer_t *buffer)
+{
+	if (slot < 4U)
+	{
+		m_constant_buffers[slot] = reinterpret_cast<cpu_buffer_t *>(buffer);
+	}
+}
+
+void RenderBackendCPU::SetTexture(uint32_t slot, render_backend_texture_t *texture)
+{
+	if (slot < 4U)
+	{
+		m_textures[slot] = reinterpret_cast<cpu_texture_t *>(texture);
+	}
+}
+
+void RenderBackendCPU::SetSampler(uint32_t, render_backend_sampler_t *)
+{
+}
+
+void RenderBackendCPU::Draw(uint32_t vertex_count)
+{
+	assert(m_pass_active && NULL != m_pipeline);
+
+	switch (m_pipeline->desc.program)
+	{
+	case RENDER_BACKEND_PROGRAM_PLANE:
+	case RENDER_BACKEND_PROGRAM_PLANE_DEPTH:
+		this->DrawPlane(vertex_count);
+		break;
+	case RENDER_BACKEND_PROGRAM_PLANE_GBUFFER:
+		this->GatherPlane(vertex_count);
+		m_gbuffer_drawn = true;
+		break;
+	case RENDER_BACKEND_PROGRAM_DEFERRED_LIGHTING:
+		this->DrawDeferredLighting();
+		break;
+	case RENDER_BACKEND_PROGRAM_CHECKERBOARD_RESOLVE:
+		this->DrawCheckerboardResolve();
+		break;
+	case RENDER_BACKEND_PROGRAM_AUTO_EXPOSURE_HISTOGRAM:
+		this->DrawAutoExposureHistogram();
+		break;
+	case RENDER_BACKEND_PROGRAM_AUTO_EXPOSURE:
+		this->DrawAutoExposure();
+		break;
+	case RENDER_BACKEND_PROGRAM_POST_PROCESS:
+		this->DrawPostProcess();
+		break;
+	default:
+		break;
+	}
+}
+
+void RenderBackendCPU::Present()
+{
+	if (m_frame_time_recording)
+	{
+		m_gpu_frame_time = static_cast<float>(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_frame_begin_time).count());
+		m_frame_time_recording = false;
+	}
+
+	// the publication of the slot is the single store of the index (see "cpu/shared_framebuffer.h")
+	if (m_shared_framebuffer_writing)
+	{
+		m_shared_framebuffer->Publish(m_frame_index);
+		m_shared_framebuffer_writing = false;
+	}
+	m_backbuffer_acquired = false;
+
+	++m_frame_index;
+}
+
+uint8_t *RenderBackendCPU::AcquireBackbuffer()
+{
+	if (!m_backbuffer_acquired)
+	{
+		m_backbuffer_acquired = true;
+
+		uint8_t *const slot = (NULL != m_shared_framebuffer) ? m_shared_framebuffer->BeginWrite(m_backbuffer_width, m_backbuffer_height) : NULL;
+		m_shared_framebuffer_writing = (NULL != slot);
+		m_backbuffer_target = (NULL != slot) ? slot : &m_backbuffer[0];
+	}
+
+	return m_backbuffer_target;
+}
+
+void RenderBackendCPU::PrepareRenderer()
+{
+	assert(NULL != m_color_attachments[0]);
+
+	uint32_t const width = m_color_attachments[0]->desc.width;
+	uint32_t const height = m_color_attachments[0]->desc.height;
+	if (!m_renderer_initialized || width != m_renderer.GetWidth() || height != m_renderer.GetHeight())
+	{
+		if (m_renderer_initialized)
+		{
+			m_renderer.Destroy();
+		}
+		m_renderer.Init(width, height);
+		m_renderer_initialized = true;
+	}
+
+	for (uint32_t slot = 1U; slot < m_color_attachment_count; ++slot)
+	{
+		assert(NULL != m_color_attachments[slot] && width == m_color_attachments[slot]->desc.width && height == m_color_attachments[slot]->desc.height);
+	}
+}
+
+void RenderBackendCPU::DrawPlane(uint32_t vertex_count)
+{
+	assert(1U == m_color_attachment_count && NULL != m_color_attachments[0]);
+
+	m_triangle_vertices.clear();
+	this->GatherPlane(vertex_count);
+
+	this->PrepareRenderer();
+
+	m_scene.triangle_vertices = m_triangle_vertices.empty() ? NULL : &m_triangle_vertices[0];
+	m_scene.triangle_count = static_cast<uint32_t>(m_triangle_vertices.size() / 9U);
+	m_renderer.SetScene(m_scene);
+
+	uint32_t const width = m_renderer.GetWidth();
+	uint32_t const height = m_renderer.GetHeight();
+	if (0U == m_forward_draw_count)
+	{
+		memset(&m_statistics, 0, sizeof(software_renderer_statistics_t));
+		m_forward_depth.assign(static_cast<size_t>(width) * height, INFINITY);
+	}
+	++m_forward_draw_count;
+
+	RENDER_BACKEND_DEPTH_TEST const depth_test = m_pipeline->desc.depth_test;
+	bool const depth_only = (RENDER_BACKEND_PROGRAM_PLANE_DEPTH == m_pipeline->desc.program);
+
+	software_renderer_statistics_t statistics;
+	m_renderer.RenderGBuffer(m_thread_pool, statistics);
+	if (RENDER_BACKEND_DEPTH_TEST_EQUAL == depth_test)
+	{
+		// the early depth rejection: the LTC and the shadows are skipped where the draw is occluded
+		m_renderer.RejectDepth(m_thread_pool, &m_forward_depth[0], statistics);
+	}
+	if (!depth_only)
+	{
+		m_renderer.RenderLighting(m_thread_pool, m_shadow_settings, m_frame_index, statistics);
+	}
+	cpu_accumulate_statistics(m_statistics, statistics);
+
+	// the depth test of the draws
+	// The emissive quad is in front of the scene of the draw, and is overwritten by the later draw which is in front of the quad.
+	// "equal": the rejected pixels are already missed, and the depth is NOT written
+	float const *const radiance = m_renderer.GetRadiance();
+	float const *const depth = m_renderer.GetDepth();
+	uint8_t const *const emissive = m_renderer.GetEmissive();
+	float *const forward_depth = &m_forward_depth[0];
+	float *const color = &m_color_attachments[0]->color[0];
+	bool const depth_equal = (RENDER_BACKEND_DEPTH_TEST_EQUAL == depth_test);
+	m_thread_pool->ParallelFor(height, 8U, [width, radiance, depth, emissive, forward_depth, color, depth_only, depth_equal](uint32_t begin, uint32_t end, uint32_t) {
+		for (size_t pixel_index = static_cast<size_t>(begin) * width; pixel_index < static_cast<size_t>(end) * width; ++pixel_index)
+		{
+			if (depth_only)
+			{
+				forward_depth[pixel_index] = std::min(forward_depth[pixel_index], depth[pixel_index]);
+			}
+			else if (depth_equal ? (0U != emissive[pixel_index] || depth[pixel_index] < INFINITY) : (0U != emissive[pixel_index] || depth[pixel_index] < forward_depth[pixel_index]))
+			{
+				forward_depth[pixel_index] = (0U != emissive[pixel_index]) ? forward_depth[pixel_index] : depth[pixel_index];
+				color[4U * pixel_index + 0U] = radiance[3U * pixel_index + 0U];
+				color[4U * pixel_index + 1U] = radiance[3U * pixel_index + 1U];
+				color[4U * pixel_index + 2U] = radiance[3U * pixel_index + 2U];
+				color[4U * pixel_index + 3U] = 1.0f;
+			}
+		}
+	});
+}
+
+void RenderBackendCPU::DrawDeferredLighting()
+{
+	// the checkerboard packing of the color attachment (NULL: the full width)
+	uint32_t width_scale = 1U;
+	uint32_t parity = 0U;
+	if (NULL != m_constant_buffers[DEMO_UNIFORM_BUFFER_PER_FRAME_BINDING])
+	{
+		uniform_buffer_per_frame_binding_t const &frame = *reinterpret_cast<uniform_buffer_per_frame_binding_t const *>(&m_constant_buffers[DEMO_UNIFORM_BUFFER_PER_FRAME_BINDING]->data[0]);
+		width_scale = frame.checkerboard_width_scale;
+		parity = frame.checkerboard_parity;
+	}
+	assert(1U == width_scale || 2U == width_scale);
+
+	// the G-buffer of the software renderer is of the same size (the half width with the checkerboard)
+	assert(1U == m_color_attachment_count && NULL != m_color_attachments[0]);
+	assert(m_renderer_initialized && m_color_attachments[0]->desc.width == (m_renderer.GetWidth() / width_scale) && m_color_attachments[0]->desc.height == m_renderer.GetHeight());
+
+	if (2U == width_scale)
+	{
+		m_renderer.RejectCheckerboard(m_thread_pool, parity, m_statistics);
+	}
+	m_renderer.RenderLighting(m_thread_pool, m_shadow_settings, m_frame_index, m_statistics);
+
+	// "deferred_lighting_fs.hlsl": the pixel NOT covered by the G-buffer is discarded (the emissive quad is drawn by the "RECT_LIGHT")
+	uint32_t const width = m_renderer.GetWidth();
+	uint32_t const color_width = m_color_attachments[0]->desc.width;
+	float const *const radiance = m_renderer.GetRadiance();
+	float const *const depth = m_renderer.GetDepth();
+	uint8_t const *const emissive = m_renderer.GetEmissive();
+	float *const color = &m_color_attachments[0]->color[0];
+	m_thread_pool->ParallelFor(m_renderer.GetHeight(), 8U, [width, color_width, width_scale, parity, radiance, depth, emissive, color](uint32_t begin, uint32_t end, uint32_t) {
+		for (uint32_t y = begin; y < end; ++y)
+		{
+			for (uint32_t color_x = 0U; color_x < color_width; ++color_x)
+			{
+				uint32_t const x = color_x * width_scale + ((y + parity) & 1U) * (width_scale - 1U);
+				size_t const pixel_index = static_cast<size_t>(width) * y + x;
+				size_t const color_index = static_cast<size_t>(color_width) * y + color_x;
+				if (0U != emissive[pixel_index] || depth[pixel_index] < INFINITY)
+				{
+					color[4U * color_index + 0U] = radiance[3U * pixel_index + 0U];
+					color[4U * color_index + 1U] = radiance[3U * pixel_index + 1U];
+					color[4U * color_index + 2U] = radiance[3U * pixel_index + 2U];
+					color[4U * color_index + 3U] = 1.0f;
+				}
+			}
+		}
+	});
+}
+
+void RenderBackendCPU::DrawCheckerboardResolve()
+{
+	cpu_texture_t const *const checkerboard = m_textures[0];
+	cpu_texture_t const *const gbuffer_position = m_textures[1];
+	cpu_texture_t const *const gbuffer_normal = m_textures[2];
+	cpu_texture_t const *const history = m_textures[3];
+	assert(NULL != checkerboard && NULL != gbuffer_position && NULL != gbuffer_normal && NULL != history);
+	assert(1U == m_color_attachment_count && NULL != m_color_attachments[0]);
+	assert(NULL != m_constant_buffers[DEMO_UNIFORM_BUFFER_PER_VIEW_BINDING] && NULL != m_constant_buffers[DEMO_UNIFORM_BUFFER_PER_FRAME_BINDING]);
+
+	uniform_buffer_per_view_binding_t const &view = *reinterpret_cast<uniform_buffer_per_view_binding_t const *>(&m_constant_buffers[DEMO_UNIFORM_BUFFER_PER_VIEW_BINDING]->data[0]);
+	uniform_buffer_per_frame_binding_t const &frame = *reinterpret_cast<uniform_buffer_per_frame_binding_t const *>(&m_constant_buffers[DEMO_UNIFORM_BUFFER_PER_FRAME_BINDING]->data[0]);
+
+	uint32_t const width = m_color_attachments[0]->desc.width;
+	uint32_t const height = m_color_attachments[0]->desc.height;
+	uint32_t const checkerboard_width = checkerboard->desc.width;
+	float *const color = &m_color_attachments[0]->color[0];
+
+	// the emissive quad of the software renderer of the same frame
+	assert(m_renderer_initialized && width == m_renderer.GetWidth() && height == m_renderer.GetHeight());
+	float const *const radiance = m_renderer.GetRadiance();
+	uint8_t const *const emissive = m_renderer.GetEmissive();
+
+	m_thread_pool->ParallelFor(height, 8U, [=, &view, &frame](uint32_t begin, uint32_t end, uint32_t) {
+		for (uint32_t y = begin; y < end; ++y)
+		{
+			for (uint32_t x = 0U; x < width; ++x)
+			{
+				size_t const pixel_index = static_cast<size_t>(width) * y + x;
+				float *const out_color = color + 4U * pixel_index;
+				out_color[3] = 1.0f;
+
+				if (0U != emissive[pixel_index])
+				{
+					out_color[0] = radiance[3U * pixel_index + 0U];
+					out_color[1] = radiance[3U * pixel_index + 1U];
+					out_color[2] = radiance[3U * pixel_index + 2U];
+					continue;
+				}
+
+				float const *const position = &gbuffer_position->color[4U * pixel_index];
+				if (position[3] <= 0.0f)
+				{
+					out_color[0] = 0.0f;
+					out_color[1] = 0.0f;
+					out_color[2] = 0.0f;
+					continue;
+				}
+
+				if (0U == ((x + y + frame.checkerboard_parity) & 1U))
+				{
+					memcpy(out_color, &checkerboard->color[4U * (static_cast<size_t>(checkerboard_width) * y + x / 2U)], sizeof(float) * 3U);
+					continue;
+				}
+
+				float const *const normal = &gbuffer_normal->color[4U * pixel_index];
+				float const normal_length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+				float const N[3] = {normal[0] / normal_length, normal[1] / normal_length, normal[2] / normal_length};
+				float const to_eye[3] = {view.eye_position.x - position[0], view.eye_position.y - position[1], view.eye_position.z - position[2]};
+				float const eye_distance = std::max(std::sqrt(to_eye[0] * to_eye[0] + to_eye[1] * to_eye[1] + to_eye[2] * to_eye[2]), 1e-4f);
+
+				static int const neighbor_offsets[4][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+
+				float spatial_sum[3] = {0.0f, 0.0f, 0.0f};
+				float spatial_weight_sum = 0.0f;
+				float neighbor_min[3] = {1e+30f, 1e+30f, 1e+30f};
+				float neighbor_max[3] = {0.0f, 0.0f, 0.0f};
+				uint32_t neighbor_count = 0U;
+				for (int neighbor_index = 0; neighbor_index < 4; ++neighbor_index)
+				{
+					int const neighbor_x = static_cast<int>(x) + neighbor_offsets[neighbor_index][0];
+					int const neighbor_y = static_cast<int>(y) + neighbor_offsets[neighbor_index][1];
+					if (neighbor_x < 0 || neighbor_y < 0 || neighbor_x >= static_cast<int>(width) || neighbor_y >= static_cast<int>(height))
+					{
+						continue;
+					}
+
+					size_t const neighbor_pixel_index = static_cast<size_t>(width) * neighbor_y + neighbor_x;
+					float const *const neighbor_position = &gbuffer_position->color[4U * neighbor_pixel_index];
+					if (neighbor_position[3] <= 0.0f)
+					{
+						continue;
+					}
+
+					float const *const neighbor_normal = &gbuffer_normal->color[4U * neighbor_pixel_index];
+					float const neighbor_normal_length = std::sqrt(neighbor_normal[0] * neighbor_normal[0] + neighbor_normal[1] * neighbor_normal[1] + neighbor_normal[2] * neighbor_normal[2]);
+					float const *const neighbor_color = &checkerboard->color[4U * (static_cast<size_t>(checkerboard_width) * neighbor_y + neighbor_x / 2)];
+
+					float const n_dot_nn = (N[0] * neighbor_normal[0] + N[1] * neighbor_normal[1] + N[2] * neighbor_normal[2]) / neighbor_normal_length;
+					float const plane_distance = std::abs(N[0] * (neighbor_position[0] - position[0]) + N[1] * (neighbor_position[1] - position[1]) + N[2] * (neighbor_position[2] - position[2])) / eye_distance;
+					// "CHECKERBOARD_NORMAL_POWER" and "CHECKERBOARD_PLANE_DISTANCE_SCALE"
+					float const weight = std::pow(std::min(std::max(n_dot_nn, 0.0f), 1.0f), 8.0f) * std::min(std::max(1.0f - plane_distance * 64.0f, 0.0f), 1.0f);
+
+					for (int component = 0; component < 3; ++component)
+					{
+						spatial_sum[component] += neighbor_color[component] * weight;
+						neighbor_min[component] = std::min(neighbor_min[component], neighbor_color[component]);
+						neighbor_max[component] = std::max(neighbor_max[component], neighbor_color[component]);
+					}
+					spatial_weight_sum += weight;
+					++neighbor_count;
+				}
+
+				for (int component = 0; component < 3; ++component)
+				{
+					out_color[component] = (spatial_weight_sum > 0.0f) ? (spatial_sum[component] / spatial_weight_sum) : ((neighbor_count > 0U) ? (0.5f * (neighbor_min[component] + neighbor_max[component])) : 0.0f);
+				}
+
+				if (0U != frame.history_valid && neighbor_count > 0U)
+				{
+					// the row vector (see "demo_uniform_buffer.h")
+					DirectX::XMFLOAT4X4 const &m = frame.previous_view_projection_transform;
+					float previous_clip_position[4];
+					for (int column = 0; column < 4; ++column)
+					{
+						previous_clip_position[column] = position[0] * m.m[0][column] + position[1] * m.m[1][column] + position[2] * m.m[2][column] + m.m[3][column];
+					}
+					if (previous_clip_position[3] > 0.0f)
+					{
+						float const previous_u = 0.5f * (previous_clip_position[0] / previous_clip_position[3]) + 0.5f;
+						float const previous_v = -0.5f * (previous_clip_position[1] / previous_clip_position[3]) + 0.5f;
+						if (previous_u >= 0.0f && previous_v >= 0.0f && previous_u <= 1.0f && previous_v <= 1.0f)
+						{
+							float history_color[3];
+							cpu_sample_bilinear(history, previous_u, previous_v, history_color);
+							for (int component = 0; component < 3; ++component)
+							{
+								out_color[component] = std::min(std::max(history_color[component], neighbor_min[component]), neighbor_max[component]);
+							}
+						}
+					}
+				}
+			}
+		}
+	});
+}
+
+void RenderBackendCPU::GatherPlane(uint32_t vertex_count)
+{
+	cpu_buffer_t const *const view_buffer = m_constant_buffers[DEMO_UNIFORM_BUFFER_PER_VIEW_BINDING];
+	cpu_buffer_t const *const light_set_buffer = m_constant_buffers[DEMO_UNIFORM_BUFFER_PER_LIGHT_SET_BINDING];
+	cpu_buffer_t const *const material_buffer = m_constant_buffers[DEMO_UNIFORM_BUFFER_PER_MATERIAL_BINDING];
+	assert(NULL != view_buffer && sizeof(uniform_buffer_per_view_binding_t) == view_buffer->data.size());
+	assert(NULL != light_set_buffer && sizeof(uniform_buffer_per_light_set_binding_t) == light_set_buffer->data.size());
+	assert(NULL != material_buffer && sizeof(uniform_buffer_per_material_binding_t) == material_buffer->data.size());
+	assert(NULL != m_vertex_buffers[0]);
+
+	uniform_buffer_per_view_binding_t view;
+	memcpy(&view, &view_buffer->data[0], sizeof(uniform_buffer_per_view_binding_t));
+	uniform_buffer_per_light_set_binding_t light_set;
+	memcpy(&light_set, &light_set_buffer->data[0], sizeof(uniform_buffer_per_light_set_binding_t));
+	uniform_buffer_per_material_binding_t material;
+	memcpy(&material, &material_buffer->data[0], sizeof(uniform_buffer_per_material_binding_t));
+
+	// triangle strip -> triangle list (transformed to the world space)
+	// The winding order does NOT matter (the normal faces the eye in the "PassPrimary").
+	{
+		DirectX::XMFLOAT4X4 const &m = material.model_transform;
+		uint8_t const *const positions = &m_vertex_buffers[0]->data[0];
+		uint32_t const stride = m_vertex_buffer_strides[0];
+		assert(vertex_count < 3U || (static_cast<size_t>(vertex_count - 1U) * stride + sizeof(float) * 3U) <= m_vertex_buffers[0]->data.size());
+
+		for (uint32_t triangle_index = 0U; (triangle_index + 2U) < vertex_count; ++triangle_index)
+		{
+			for (uint32_t vertex_index = 0U; vertex_index < 3U; ++vertex_index)
+			{
+				float position[3];
+				memcpy(position, positions + static_cast<size_t>(triangle_index + vertex_index) * stride, sizeof(float) * 3U);
+
+				// row vector (the same as the "XMVector3Transform")
+				for (int column = 0; column < 3; ++column)
+				{
+					m_triangle_vertices.push_back(position[0] * m.m[0][column] + position[1] * m.m[1][column] + position[2] * m.m[2][column] + m.m[3][column]);
+				}
+			}
+		}
+	}
+
+	// material
+	// "ToLinear" in "plane_fs.hlsl"
+	m_scene.diffuse_color[0] = std::pow(material.dcolor.x, 2.2f);
+	m_scene.diffuse_color[1] = std::pow(material.dcolor.y, 2.2f);
+	m_scene.diffuse_color[2] = std::pow(material.dcolor.z, 2.2f);
+	m_scene.specular_color[0] = std::pow(material.scolor.x, 2.2f);
+	m_scene.specular_color[1] = std::pow(material.scolor.y, 2.2f);
+	m_scene.specular_color[2] = std::pow(material.scolor.z, 2.2f);
+	m_scene.roughness = material.roughness;
+
+	// light
+	// The software renderer is one-sided, with the Burley diffuse, the dual specular lobes and the horizon-clipping (the permutation of the pipeline and the "twoSided" are ignored).
+	for (int vertex_index = 0; vertex_index < 4; ++vertex_index)
+	{
+		m_scene.rect_light_vertices[vertex_index][0] = light_set.rect_light_vetices[vertex_index].x;
+		m_scene.rect_light_vertices[vertex_index][1] = light_set.rect_light_vetices[vertex_index].y;
+		m_scene.rect_light_vertices[vertex_index][2] = light_set.rect_light_vetices[vertex_index].z;
+	}
+	m_scene.intensity = light_set.intensity;
+
+	// camera
+	// "XMMatrixLookToRH": the columns of the view transform are the right, the up and the backward axes
+	{
+		DirectX::XMFLOAT4X4 const &v = view.view_transform;
+		m_scene.eye_position[0] = view.eye_position.x;
+		m_scene.eye_position[1] = view.eye_position.y;
+		m_scene.eye_position[2] = view.eye_position.z;
+		m_scene.eye_direction[0] = -v.m[0][2];
+		m_scene.eye_direction[1] = -v.m[1][2];
+		m_scene.eye_direction[2] = -v.m[2][2];
+		m_scene.up_direction[0] = v.m[0][1];
+		m_scene.up_direction[1] = v.m[1][1];
+		m_scene.up_direction[2] = v.m[2][1];
+		// "XMMatrixPerspectiveFovRH": _22 = 1 / tan(fov_angle_y / 2)
+		m_scene.fov_angle_y = 2.0f * std::atan(1.0f / view.projection_transform.m[1][1]);
+	}
+}
+
+void RenderBackendCPU::DrawAutoExposureHistogram()
+{
+	cpu_texture_t const *const source = m_textures[0];
+	assert(NULL != source && !source->color.empty());
+	assert(1U == m_color_attachment_count && NULL != m_color_attachments[0]);
+
+	cpu_texture_t *const histogram = m_color_attachments[0];
+	assert(AUTO_EXPOSURE_HISTOGRAM_BIN_COUNT == histogram->desc.width);
+
+	m_auto_exposure_histogram.Build(m_thread_pool, &source->color[0], source->desc.width, source->desc.height);
+
+	std::fill(histogram->color.begin(), histogram->color.end(), 0.0f);
+	for (uint32_t bin_index = 0U; bin_index < AUTO_EXPOSURE_HISTOGRAM_BIN_COUNT; ++bin_index)
+	{
+		histogram->color[4U * bin_index] = static_cast<float>(m_auto_exposure_histogram.GetHistogram()[bin_index]);
+	}
+}
+
+void RenderBackendCPU::DrawAutoExposure()
+{
+	cpu_texture_t const *const histogram = m_textures[0];
+	cpu_texture_t const *const previous_exposure = m_textures[1];
+	assert(NULL != histogram && NULL != previous_exposure);
+	assert(AUTO_EXPOSURE_HISTOGRAM_BIN_COUNT == histogram->desc.width);
+	assert(1U == m_color_attachment_count && NULL != m_color_attachments[0]);
+	assert(NULL != m_constant_buffers[DEMO_UNIFORM_BUFFER_PER_FRAME_BINDING]);
+
+	uniform_buffer_per_frame_binding_t const &frame = *reinterpret_cast<uniform_buffer_per_frame_binding_t const *>(&m_constant_buffers[DEMO_UNIFORM_BUFFER_PER_FRAME_BINDING]->data[0]);
+
+	// the sum over the groups
+	float bins[AUTO_EXPOSURE_HISTOGRAM_BIN_COUNT];
+	for (uint32_t bin_index = 0U; bin_index < AUTO_EXPOSURE_HISTOGRAM_BIN_COUNT; ++bin_index)
+	{
+		bins[bin_index] = 0.0f;
+		for (uint32_t group_index = 0U; group_index < histogram->desc.height; ++group_index)
+		{
+			bins[bin_index] += histogram->color[4U * (static_cast<size_t>(AUTO_EXPOSURE_HISTOGRAM_BIN_COUNT) * group_index + bin_index)];
+		}
+	}
+
+	float const adapted_log2_luminance = AutoExposureAdapt(bins, previous_exposure->color[1], 0U != frame.exposure_valid);
+
+	float *const exposure = &m_color_attachments[0]->color[0];
+	exposure[0] = AutoExposureFromLuminance(adapted_log2_luminance);
+	exposure[1] = adapted_log2_luminance;
+	exposure[2] = 0.0f;
+	exposure[3] = 1.0f;
+}
+
+void RenderBackendCPU::DrawPostProcess()
+{
+	cpu_texture_t const *const source = m_textures[0];
+	assert(NULL != source && !source->color.empty());
+	// only the backbuffer is the target of the post process
+	assert(1U == m_color_attachment_count && NULL == m_color_attachments[0]);
+
+	uint32_t const source_width = source->desc.width;
+	uint32_t const source_height = source->desc.height;
+	uint32_t const width = m_backbuffer_width;
+	uint32_t const height = m_backbuffer_height;
+	float const *const source_color = &source->color[0];
+	// the texture 2 is the 1x1 exposure
+	float const exposure = (NULL != m_textures[2]) ? m_textures[2]->color[0] : 1.0f;
+	uint8_t *const backbuffer = this->AcquireBackbuffer();
+
+	m_thread_pool->ParallelFor(height, 8U, [=](uint32_t begin, uint32_t end, uint32_t) {
+		for (uint32_t y = begin; y < end; ++y)
+		{
+			uint8_t *const row = backbuffer + static_cast<size_t>(width) * y * 4U;
+
+			if (source_width == width && source_height == height)
+			{
+				// the full resolution: the row is encoded in place
+				TonemapEncodeRow(source_color + static_cast<size_t>(source_width) * y * 4U, width, exposure, row);
+			}
+			else
+			{
+				// the dynamic resolution: the bilinear upscale (the same as the magnification of the sampler 0), gathered into the chunks on the stack
+				float const v = (static_cast<float>(y) + 0.5f) / static_cast<float>(height);
+				float texels[64U * 4U];
+				for (uint32_t chunk_begin = 0U; chunk_begin < width; chunk_begin += 64U)
+				{
+					uint32_t const chunk_end = std::min(chunk_begin + 64U, width);
+					for (uint32_t x = chunk_begin; x < chunk_end; ++x)
+					{
+						float *const texel = texels + (x - chunk_begin) * 4U;
+						cpu_sample_bilinear(source, (static_cast<float>(x) + 0.5f) / static_cast<float>(width), v, texel);
+						texel[3] = 1.0f;
+					}
+					TonemapEncodeRow(texels, chunk_end - chunk_begin, exposure, row + chunk_begin * 4U);
+				}
+			}
+		}
+	});
+}
+
+static inline void cpu_accumulate_statistics(software_renderer_statistics_t &sum, software_renderer_statistics_t const &statistics)
+{
+	sum.primary_milliseconds += statistics.primary_milliseconds;
+	sum.shading_milliseconds += statistics.shading_milliseconds;
+	sum.shadow_milliseconds += statistics.shadow_milliseconds;
+	sum.denoise_milliseconds += statistics.denoise_milliseconds;
+	sum.total_milliseconds += statistics.total_milliseconds;
+	sum.light_back_face_pixel_count += statistics.light_back_face_pixel_count;
+	sum.horizon_below_pixel_count += statistics.horizon_below_pixel_count;
+	sum.horizon_above_pixel_count += statistics.horizon_above_pixel_count;
+	sum.horizon_straddle_pixel_count += statistics.horizon_straddle_pixel_count;
+	sum.shadow_ray_count += statistics.shadow_ray_count;
+	sum.penumbra_pixel_count += statistics.penumbra_pixel_count;
+	sum.lit_pixel_count += statistics.lit_pixel_count;
+	sum.max_pixel_sample_count = std::max(sum.max_pixel_sample_count, statistics.max_pixel_sample_count);
+	sum.denoised_tile_count += statistics.denoised_tile_count;
+	sum.tile_count += statistics.tile_count;
+	sum.depth_rejected_pixel_count += statistics.depth_rejected_pixel_count;
+	sum.checkerboard_skipped_pixel_count += statistics.checkerboard_skipped_pixel_count;
+}
+
+static inline void cpu_sample_bilinear(cpu_texture_t const *texture, float u, float v, float color[3])
+{
+	uint32_t const width = texture->desc.width;
+	uint32_t const height = texture->desc.height;
+
+	// the texel centers are at the half texels
+	float const x = std::min(std::max(u * width - 0.5f, 0.0f), static_cast<float>(width - 1U));
+	float const y = std::min(std::max(v * height - 0.5f, 0.0f), static_cast<float>(height - 1U));
+	uint32_t const x0 = static_cast<uint32_t>(x);
+	uint32_t const y0 = static_cast<uint32_t>(y);
+	uint32_t const x1 = std::min(x0 + 1U, width - 1U);
+	uint32_t const y1 = std::min(y0 + 1U, height - 1U);
+	float const fx = x - static_cast<float>(x0);
+	float const fy = y - static_cast<float>(y0);
+
+	float const *const c00 = &texture->color[4U * (static_cast<size_t>(width) * y0 + x0)];
+	float const *const c10 = &texture->color[4U * (static_cast<size_t>(width) * y0 + x1)];
+	float const *const c01 = &texture->color[4U * (static_cast<size_t>(width) * y1 + x0)];
+	float const *const c11 = &texture->color[4U * (static_cast<size_t>(width) * y1 + x1)];
+	for (int component = 0; component < 3; ++component)
+	{
+		float const top = c00[component] + (c10[component] - c00[component]) * fx;
+		float const bottom = c01[component] + (c11[component] - c01[component]) * fx;
+		color[component] = top + (bottom - top) * fy;
+	}
+}
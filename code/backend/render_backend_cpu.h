@@ -0,0 +1,153 @@
+#ifndef _BACKEND_RENDER_BACKEND_CPU_H_
+#define _BACKEND_RENDER_BACKEND_CPU_H_ 1
+
+//
+// Drives the software LTC renderer (see "cpu/software_renderer.h") by the commands of the "Demo".
+//
+// The programs are interpreted rather than executed:
+// RENDER_BACKEND_PROGRAM_PLANE: the triangles of the vertex buffer (slot 0, transformed by the "model_transform") are the scene of the draw,
+//                               the camera, the light and the material are read from the constant buffers (see "demo_uniform_buffer.h").
+//                               Each draw is rendered by the software renderer, and merged into the color attachment by the depth (the forward shading pays for the overdraw).
+//                               With the "equal" depth test, the pixels which are NOT visible in the depth of the "PLANE_DEPTH" draws are rejected before the lighting.
+// RENDER_BACKEND_PROGRAM_PLANE_DEPTH: the primary visibility only, into the depth of the draws of the current pass.
+// RENDER_BACKEND_PROGRAM_PLANE_GBUFFER: the triangles of all the draws of the pass are gathered into the scene (the same as the "PLANE"),
+//                                       the primary visibility is rendered when the pass ends and copied into the G-buffer attachments.
+// RENDER_BACKEND_PROGRAM_DEFERRED_LIGHTING: the lighting of the software renderer over its G-buffer of the last "PLANE_GBUFFER" pass
+//                                           (the same contents as the G-buffer textures, which are NOT read back).
+//                                           With the checkerboard (see "demo_uniform_buffer.h"), the skipped pixels are rejected before the lighting.
+// RENDER_BACKEND_PROGRAM_CHECKERBOARD_RESOLVE: the same reconstruction as the "checkerboard_resolve_fs.hlsl" over the textures,
+//                                              and the emissive pixels of the software renderer (the stand-in of the "RECT_LIGHT" drawn after the resolve).
+// RENDER_BACKEND_PROGRAM_RECT_LIGHT: ignored (the software renderer shades the emitter itself).
+// RENDER_BACKEND_PROGRAM_AUTO_EXPOSURE_HISTOGRAM: every pixel of the HDR color is counted (instead of the taps of the grid) by the per-thread histograms (see "cpu/auto_exposure.h"),
+//                                                 the whole histogram is written into the group 0 and the other groups are 0.
+// RENDER_BACKEND_PROGRAM_AUTO_EXPOSURE: the same adaptation as the "auto_exposure_fs.hlsl".
+// RENDER_BACKEND_PROGRAM_POST_PROCESS: the same tone mapping as the "post_process_fs.hlsl" evaluated analytically by the SIMD encoder (see "cpu/tonemap_encoder.h") into the BGRA8 backbuffer
+//                                      (the texture 1, the tonemap LUT, is ignored: on the CPU the encoder is both faster and more exact than the lookup).
+//                                      The HDR color smaller than the backbuffer (the dynamic resolution) is upscaled by the bilinear sampling.
+//
+// With the shared framebuffer (see "cpu/shared_framebuffer.h"), the backbuffer of the frame is the slot of the ring itself (the clear and the post process write the slot in place),
+// which is published by the "Present", such that the viewer process maps the frame without any copy.
+//
+// The initial data of the RGBA32F color attachments is kept (the exposure of the first frame), the other textures are NOT read back.
+//
+
+#include <stdint.h>
+#include <chrono>
+#include <vector>
+
+#include "../cpu/software_renderer.h"
+#include "../cpu/auto_exposure.h"
+
+#include "render_backend.h"
+
+class RenderBackendCPU : public RenderBackend
+{
+	class ThreadPool *m_thread_pool;
+	software_renderer_shadow_settings_t m_shadow_settings;
+	SoftwareRenderer m_renderer;
+	bool m_renderer_initialized;
+	software_renderer_statistics_t m_statistics;
+	uint32_t m_frame_index;
+
+	// the wall time from the first "BeginPass" to the "Present" (the passes are executed synchronously)
+	bool m_frame_time_recording;
+	std::chrono::steady_clock::time_point m_frame_begin_time;
+	float m_gpu_frame_time;
+
+	// BGRA8 (the same as the swap chain of the D3D11 backend), the row 0 is the top of the image
+	uint32_t m_backbuffer_width;
+	uint32_t m_backbuffer_height;
+	std::vector<uint8_t> m_backbuffer;
+	// the memory of the backbuffer of the current (or the last) frame: the "m_backbuffer" or the slot of the shared framebuffer
+	uint8_t *m_backbuffer_target;
+	bool m_backbuffer_acquired;
+	class SharedFramebuffer *m_shared_framebuffer;
+	bool m_shared_framebuffer_writing;
+
+	AutoExposureHistogram m_auto_exposure_histogram;
+
+	// the scene gathered by the draw (forward) or by the draws of the current pass (G-buffer)
+	std::vector<float> m_triangle_vertices;
+	software_renderer_scene_t m_scene;
+	bool m_gbuffer_drawn;
+
+	// forward: the depth of the draws of the current pass (the depth attachment is NOT used), also written by the depth pre-pass
+	uint32_t m_forward_draw_count;
+	std::vector<float> m_forward_depth;
+
+	// bindings
+	struct cpu_texture_t *m_color_attachments[RENDER_BACKEND_MAX_COLOR_ATTACHMENT_COUNT];
+	uint32_t m_color_attachment_count;
+	bool m_pass_active;
+	struct cpu_pipeline_t *m_pipeline;
+	struct cpu_buffer_t *m_vertex_buffers[2];
+	uint32_t m_vertex_buffer_strides[2];
+	struct cpu_buffer_t *m_constant_buffers[4];
+	struct cpu_texture_t *m_textures[4];
+
+	// the backbuffer of the frame, acquired by its first write
+	uint8_t *AcquireBackbuffer();
+
+	// the software renderer of the size of the color attachments
+	void PrepareRenderer();
+	void GatherPlane(uint32_t vertex_count);
+	void DrawPlane(uint32_t vertex_count);
+	void DrawDeferredLighting();
+	void DrawCheckerboardResolve();
+	void DrawAutoExposureHistogram();
+	void DrawAutoExposure();
+	void DrawPostProcess();
+
+public:
+	// [in] thread_pool: owned by the caller, used by the software renderer and the post process
+	void Init(class ThreadPool *thread_pool, uint32_t width, uint32_t height, software_renderer_shadow_settings_t const &shadow_settings);
+	void Destroy();
+
+	// the statistics of the software renderer of the last frame (the sum of the draws of the forward shading)
+	software_renderer_statistics_t const &GetStatistics() const;
+	// BGRA8, the row 0 is the top of the image
+	uint8_t const *GetBackbuffer() const;
+
+	// [in] shared_framebuffer: the producer (see "SharedFramebuffer::Create"), owned by the caller, NULL means the own backbuffer
+	// Called between the frames. The frame of which the backbuffer exceeds the size of the slot is rendered into the own backbuffer (NOT published).
+	void SetSharedFramebuffer(class SharedFramebuffer *shared_framebuffer);
+
+	char const *GetName() const;
+
+	uint32_t GetBackbufferWidth() const;
+	uint32_t GetBackbufferHeight() const;
+
+	float GetGPUFrameTime() const;
+
+	void ResizeBackbuffer(uint32_t width, uint32_t height);
+
+	render_backend_buffer_t *CreateBuffer(RENDER_BACKEND_BUFFER_USAGE usage, uint32_t size, void const *data);
+	void DestroyBuffer(render_backend_buffer_t *buffer);
+
+	render_backend_texture_t *CreateTexture(render_backend_texture_desc_t const &desc, render_backend_subresource_data_t const *subresource_data);
+	void DestroyTexture(render_backend_texture_t *texture);
+
+	render_backend_sampler_t *CreateSampler(RENDER_BACKEND_FILTER filter);
+	void DestroySampler(render_backend_sampler_t *sampler);
+
+	render_backend_pipeline_t *CreatePipeline(render_backend_pipeline_desc_t const &desc);
+	void DestroyPipeline(render_backend_pipeline_t *pipeline);
+
+	void UpdateBuffer(render_backend_buffer_t *buffer, void const *data, uint32_t size);
+
+	void BeginPass(render_backend_pass_desc_t const &desc);
+	void EndPass();
+
+	void Barrier(render_backend_texture_t *texture, RENDER_BACKEND_TEXTURE_STATE before, RENDER_BACKEND_TEXTURE_STATE after);
+
+	void SetPipeline(render_backend_pipeline_t *pipeline);
+	void SetVertexBuffers(uint32_t first_slot, uint32_t buffer_count, render_backend_buffer_t *const *buffers, uint32_t const *strides);
+	void SetConstantBuffer(uint32_t slot, render_backend_buffer_t *buffer);
+	void SetTexture(uint32_t slot, render_backend_texture_t *texture);
+	void SetSampler(uint32_t slot, render_backend_sampler_t *sampler);
+	void Draw(uint32_t vertex_count);
+
+	void Present();
+};
+
+#endif
@@ -0,0 +1,1000 @@
+#include <sdkddkver.h>
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX 1
+#include <windows.h>
+
+#include <stdint.h>
+#include <assert.h>
+#include <new>
+
+#include <dxgi.h>
+#include <d3d11.h>
+
+#include "render_backend_d3d11.h"
+
+#include "../../shaders/plane_vs.hlsl.inl"
+
+// the permutations are compiled by the "CompileFsPermutations" of the "LTC.vcxproj" (the index is the permutation)
+#include "../../shaders/plane_fs_permutation_0.hlsl.inl"
+
+#include "../../shaders/plane_fs_permutation_1.hlsl.inl"
+
+#include "../../shaders/plane_fs_permutation_2.hlsl.inl"
+
+#include "../../shaders/plane_fs_permutation_3.hlsl.inl"
+
+#include "../../shaders/plane_fs_permutation_4.hlsl.inl"
+
+#include "../../shaders/plane_fs_permutation_5.hlsl.inl"
+
+#include "../../shaders/plane_fs_permutation_6.hlsl.inl"
+
+#include "../../shaders/plane_fs_permutation_7.hlsl.inl"
+
+#include "../../shaders/plane_fs_permutation_8.hlsl.inl"
+
+#include "../../shaders/plane_fs_permutation_9.hlsl.inl"
+
+#include "../../shaders/plane_fs_permutation_10.hlsl.inl"
+
+#include "../../shaders/plane_fs_permutation_11.hlsl.inl"
+
+#include "../../shaders/plane_fs_permutation_12.hlsl.inl"
+
+#include "../../shaders/plane_fs_permutation_13.hlsl.inl"
+
+#include "../../shaders/plane_fs_permutation_14.hlsl.inl"
+
+#include "../../shaders/plane_fs_permutation_15.hlsl.inl"
+
+#include "../../shaders/deferred_lighting_fs_permutation_0.hlsl.inl"
+
+#include "../../shaders/deferred_lighting_fs_permutation_1.hlsl.inl"
+
+#include "../../shaders/deferred_lighting_fs_permutation_2.hlsl.inl"
+
+#include "../../shaders/deferred_lighting_fs_permutation_3.hlsl.inl"
+
+#include "../../shaders/deferred_lighting_fs_permutation_4.hlsl.inl"
+
+#include "../../shaders/deferred_lighting_fs_permutation_5.hlsl.inl"
+
+#include "../../shaders/deferred_lighting_fs_permutation_6.hlsl.inl"
+
+#include "../../shaders/deferred_lighting_fs_permutation_7.hlsl.inl"
+
+#include "../../shaders/deferred_lighting_fs_permutation_8.hlsl.inl"
+
+#include "../../shaders/deferred_lighting_fs_permutation_9.hlsl.inl"
+
+#include "../../shaders/deferred_lighting_fs_permutation_10.hlsl.inl"
+
+#include "../../shaders/deferred_lighting_fs_permutation_11.hlsl.inl"
+
+#include "../../shaders/deferred_lighting_fs_permutation_12.hlsl.inl"
+
+#include "../../shaders/deferred_lighting_fs_permutation_13.hlsl.inl"
+
+#include "../../shaders/deferred_lighting_fs_permutation_14.hlsl.inl"
+
+#include "../../shaders/deferred_lighting_fs_permutation_15.hlsl.inl"
+
+#include "../../shaders/plane_gbuffer_fs.hlsl.inl"
+
+#include "../../shaders/rect_light_vs.hlsl.inl"
+
+#include "../../shaders/rect_light_fs.hlsl.inl"
+
+#include "../../shaders/post_process_vs.hlsl.inl"
+
+#include "../../shaders/post_process_fs.hlsl.inl"
+
+#include "../../shaders/checkerboard_resolve_fs.hlsl.inl"
+
+#include "../../shaders/auto_exposure_histogram_fs.hlsl.inl"
+
+#include "../../shaders/auto_exposure_fs.hlsl.inl"
+
+// the "render_backend_buffer_t" is the "ID3D11Buffer"
+// the "render_backend_sampler_t" is the "ID3D11SamplerState"
+
+struct d3d11_texture_t
+{
+	// ID3D11Texture2D or ID3D11Texture3D (see "RENDER_BACKEND_TEXTURE_VIEW_DIMENSION_3D")
+	ID3D11Resource *texture;
+	ID3D11ShaderResourceView *srv;
+	ID3D11RenderTargetView *rtv;
+	ID3D11DepthStencilView *dsv;
+	uint32_t width;
+	uint32_t height;
+};
+
+// the sub-states are owned by the backend (see "m_programs", "m_rasterizer_state" and "m_depth_stencil_state")
+struct d3d11_pipeline_t
+{
+	ID3D11InputLayout *vao;
+	ID3D11VertexShader *vs;
+	ID3D11PixelShader *fs;
+	ID3D11RasterizerState *rs;
+	ID3D11DepthStencilState *dss;
+};
+
+struct d3d11_bytecode_t
+{
+	void const *bytecode;
+	size_t bytecode_size;
+};
+
+static d3d11_bytecode_t const plane_fs_permutations[RENDER_BACKEND_PERMUTATION_COUNT] = {
+	{plane_fs_permutation_0_bytecode, sizeof(plane_fs_permutation_0_bytecode)},
+	{plane_fs_permutation_1_bytecode, sizeof(plane_fs_permutation_1_bytecode)},
+	{plane_fs_permutation_2_bytecode, sizeof(plane_fs_permutation_2_bytecode)},
+	{plane_fs_permutation_3_bytecode, sizeof(plane_fs_permutation_3_bytecode)},
+	{plane_fs_permutation_4_bytecode, sizeof(plane_fs_permutation_4_bytecode)},
+	{plane_fs_permutation_5_bytecode, sizeof(plane_fs_permutation_5_bytecode)},
+	{plane_fs_permutation_6_bytecode, sizeof(plane_fs_permutation_6_bytecode)},
+	{plane_fs_permutation_7_bytecode, sizeof(plane_fs_permutation_7_bytecode)},
+	{plane_fs_permutation_8_bytecode, sizeof(plane_fs_permutation_8_bytecode)},
+	{plane_fs_permutation_9_bytecode, sizeof(plane_fs_permutation_9_bytecode)},
+	{plane_fs_permutation_10_bytecode, sizeof(plane_fs_permutation_10_bytecode)},
+	{plane_fs_permutation_11_bytecode, sizeof(plane_fs_permutation_11_bytecode)},
+	{plane_fs_permutation_12_bytecode, sizeof(plane_fs_permutation_12_bytecode)},
+	{plane_fs_permutation_13_bytecode, sizeof(plane_fs_permutation_13_bytecode)},
+	{plane_fs_permutation_14_bytecode, sizeof(plane_fs_permutation_14_bytecode)},
+	{plane_fs_permutation_15_bytecode, sizeof(plane_fs_permutation_15_bytecode)}};
+
+static d3d11_bytecode_t const deferred_lighting_fs_permutations[RENDER_BACKEND_PERMUTATION_COUNT] = {
+	{deferred_lighting_fs_permutation_0_bytecode, sizeof(deferred_lighting_fs_permutation_0_bytecode)},
+	{deferred_lighting_fs_permutation_1_bytecode, sizeof(deferred_lighting_fs_permutation_1_bytecode)},
+	{deferred_lighting_fs_permutation_2_bytecode, sizeof(deferred_lighting_fs_permutation_2_bytecode)},
+	{deferred_lighting_fs_permutation_3_bytecode, sizeof(deferred_lighting_fs_permutation_3_bytecode)},
+	{deferred_lighting_fs_permutation_4_bytecode, sizeof(deferred_lighting_fs_permutation_4_bytecode)},
+	{deferred_lighting_fs_permutation_5_bytecode, sizeof(deferred_lighting_fs_permutation_5_bytecode)},
+	{deferred_lighting_fs_permutation_6_bytecode, sizeof(deferred_lighting_fs_permutation_6_bytecode)},
+	{deferred_lighting_fs_permutation_7_bytecode, sizeof(deferred_lighting_fs_permutation_7_bytecode)},
+	{deferred_lighting_fs_permutation_8_bytecode, sizeof(deferred_lighting_fs_permutation_8_bytecode)},
+	{deferred_lighting_fs_permutation_9_bytecode, sizeof(deferred_lighting_fs_permutation_9_bytecode)},
+	{deferred_lighting_fs_permutation_10_bytecode, sizeof(deferred_lighting_fs_permutation_10_bytecode)},
+	{deferred_lighting_fs_permutation_11_bytecode, sizeof(deferred_lighting_fs_permutation_11_bytecode)},
+	{deferred_lighting_fs_permutation_12_bytecode, sizeof(deferred_lighting_fs_permutation_12_bytecode)},
+	{deferred_lighting_fs_permutation_13_bytecode, sizeof(deferred_lighting_fs_permutation_13_bytecode)},
+	{deferred_lighting_fs_permutation_14_bytecode, sizeof(deferred_lighting_fs_permutation_14_bytecode)},
+	{deferred_lighting_fs_permutation_15_bytecode, sizeof(deferred_lighting_fs_permutation_15_bytecode)}};
+
+static DXGI_FORMAT d3d11_format(RENDER_BACKEND_FORMAT format);
+
+// the RTV of the buffer 0 of the swap chain (by the "Init" and the "ResizeBackbuffer")
+static ID3D11RenderTargetView *d3d11_create_backbuffer_rtv(ID3D11Device *d3d11_device, IDXGISwapChain *dxgi_swap_chain);
+
+void RenderBackendD3D11::Init(HWND hWnd, uint32_t width, uint32_t height)
+{
+	m_d3d11_device = NULL;
+	m_d3d11_device_context = NULL;
+	m_dxgi_swap_chain = NULL;
+	{
+		IDXGIFactory1 *dxgi_factory = NULL;
+		HRESULT res_create_dxgi_factory = CreateDXGIFactory1(IID_PPV_ARGS(&dxgi_factory));
+		assert(SUCCEEDED(res_create_dxgi_factory));
+
+		IDXGIAdapter1 *dxgi_adapter = NULL;
+		// "0U" means "default" adapter // perhaps user-select
+		HRESULT res_dxgi_factory_enum_adapters = dxgi_factory->EnumAdapters1(0U, &dxgi_adapter);
+		assert(SUCCEEDED(res_dxgi_factory_enum_adapters));
+
+		D3D_FEATURE_LEVEL pFeatureLevels[1] = { D3D_FEATURE_LEVEL_11_0 };
+		HRESULT res_d3d11_create_device = D3D11CreateDevice(
+			dxgi_adapter,
+			D3D_DRIVER_TYPE_UNKNOWN,
+			NULL,
+#ifndef NDEBUG
+			D3D11_CREATE_DEVICE_SINGLETHREADED | D3D11_CREATE_DEVICE_DEBUG,
+#else
+			D3D11_CREATE_DEVICE_SINGLETHREADED,
+#endif
+			pFeatureLevels,
+			sizeof(pFeatureLevels) / sizeof(pFeatureLevels[0]),
+			D3D11_SDK_VERSION,
+			&m_d3d11_device,
+			NULL,
+			&m_d3d11_device_context
+		);
+		assert(SUCCEEDED(res_d3d11_create_device));
+
+		DXGI_SWAP_CHAIN_DESC dxgi_swap_chain_desc;
+		dxgi_swap_chain_desc.BufferDesc.Width = width;
+		dxgi_swap_chain_desc.BufferDesc.Height = height;
+		dxgi_swap_chain_desc.BufferDesc.RefreshRate.Numerator = 60U;
+		dxgi_swap_chain_desc.BufferDesc.RefreshRate.Denominator = 1U;
+		dxgi_swap_chain_desc.BufferDesc.Format = DXGI_FORMAT_B8G8R8A8_UNORM;
+		dxgi_swap_chain_desc.BufferDesc.ScanlineOrdering = DXGI_MODE_SCANLINE_ORDER_UNSPECIFIED;
+		dxgi_swap_chain_desc.BufferDesc.Scaling = DXGI_MODE_SCALING_UNSPECIFIED;
+		dxgi_swap_chain_desc.SampleDesc.Count = 1U;
+		dxgi_swap_chain_desc.SampleDesc.Quality = 0U;
+		dxgi_swap_chain_desc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
+		dxgi_swap_chain_desc.BufferCount = 1U;
+		dxgi_swap_chain_desc.OutputWindow = hWnd;
+		dxgi_swap_chain_desc.Windowed = TRUE;
+		dxgi_swap_chain_desc.SwapEffect = DXGI_SWAP_EFFECT_DISCARD;
+		dxgi_swap_chain_desc.Flags = 0U;
+		HRESULT res_dxgi_factory_create_swap_chain = dxgi_factory->CreateSwapChain(m_d3d11_device, &dxgi_swap_chain_desc, &m_dxgi_swap_chain);
+		assert(SUCCEEDED(res_dxgi_factory_create_swap_chain));
+
+		dxgi_adapter->Release();
+		dxgi_factory->Release();
+	}
+
+	m_attachment_backbuffer_rtv = d3d11_create_backbuffer_rtv(m_d3d11_device, m_dxgi_swap_chain);
+	m_backbuffer_width = width;
+	m_backbuffer_height = height;
+
+	for (int depth_test = 0; depth_test < RENDER_BACKEND_DEPTH_TEST_COUNT; ++depth_test)
+	{
+		D3D11_DEPTH_STENCIL_DESC d3d_depth_stencil_desc;
+		d3d_depth_stencil_desc.DepthEnable = (RENDER_BACKEND_DEPTH_TEST_NONE != depth_test) ? TRUE : FALSE;
+		d3d_depth_stencil_desc.DepthWriteMask = (RENDER_BACKEND_DEPTH_TEST_EQUAL != depth_test) ? D3D11_DEPTH_WRITE_MASK_ALL : D3D11_DEPTH_WRITE_MASK_ZERO;
+		d3d_depth_stencil_desc.DepthFunc = (RENDER_BACKEND_DEPTH_TEST_EQUAL != depth_test) ? D3D11_COMPARISON_LESS : D3D11_COMPARISON_EQUAL;
+		d3d_depth_stencil_desc.StencilEnable = FALSE;
+		d3d_depth_stencil_desc.StencilReadMask = D3D11_DEFAULT_STENCIL_READ_MASK;
+		d3d_depth_stencil_desc.StencilWriteMask = D3D11_DEFAULT_STENCIL_WRITE_MASK;
+		d3d_depth_stencil_desc.FrontFace.StencilFailOp = D3D11_STENCIL_OP_KEEP;
+		d3d_depth_stencil_desc.FrontFace.StencilDepthFailOp = D3D11_STENCIL_OP_KEEP;
+		d3d_depth_stencil_desc.FrontFace.StencilPassOp = D3D11_STENCIL_OP_KEEP;
+		d3d_depth_stencil_desc.FrontFace.StencilFunc = D3D11_COMPARISON_ALWAYS;
+		d3d_depth_stencil_desc.BackFace = d3d_depth_stencil_desc.FrontFace;
+
+		m_depth_stencil_state[depth_test] = NULL;
+		HRESULT res_d3d_device_create_depth_stencil_state = m_d3d11_device->CreateDepthStencilState(&d3d_depth_stencil_desc, &m_depth_stencil_state[depth_test]);
+		assert(SUCCEEDED(res_d3d_device_create_depth_stencil_state));
+	}
+
+	for (int front_counter_clockwise = 0; front_counter_clockwise < 2; ++front_counter_clockwise)
+	{
+		D3D11_RASTERIZER_DESC d3d_rasterizer_desc;
+		d3d_rasterizer_desc.FillMode = D3D11_FILL_SOLID;
+		d3d_rasterizer_desc.CullMode = D3D11_CULL_BACK;
+		d3d_rasterizer_desc.FrontCounterClockwise = (0 != front_counter_clockwise) ? TRUE : FALSE;
+		d3d_rasterizer_desc.DepthBias = 0;
+		d3d_rasterizer_desc.SlopeScaledDepthBias = 0.0f;
+		d3d_rasterizer_desc.DepthBiasClamp = 0.0f;
+		d3d_rasterizer_desc.DepthClipEnable = TRUE;
+		d3d_rasterizer_desc.ScissorEnable = FALSE;
+		d3d_rasterizer_desc.MultisampleEnable = FALSE;
+		d3d_rasterizer_desc.AntialiasedLineEnable = FALSE;
+
+		m_rasterizer_state[front_counter_clockwise] = NULL;
+		HRESULT res_d3d_device_create_rasterizer_state = m_d3d11_device->CreateRasterizerState(&d3d_rasterizer_desc, &m_rasterizer_state[front_counter_clockwise]);
+		assert(SUCCEEDED(res_d3d_device_create_rasterizer_state));
+	}
+
+	for (int program = 0; program < RENDER_BACKEND_PROGRAM_COUNT; ++program)
+	{
+		void const *vs_bytecode = NULL;
+		size_t vs_bytecode_size = 0U;
+		void const *fs_bytecode = NULL;
+		size_t fs_bytecode_size = 0U;
+		switch (program)
+		{
+		case RENDER_BACKEND_PROGRAM_PLANE:
+			// the pixel shader is created per permutation by the "CreatePipeline"
+			vs_bytecode = plane_vs_bytecode;
+			vs_bytecode_size = sizeof(plane_vs_bytecode);
+			break;
+		case RENDER_BACKEND_PROGRAM_RECT_LIGHT:
+			vs_bytecode = rect_light_vs_bytecode;
+			vs_bytecode_size = sizeof(rect_light_vs_bytecode);
+			fs_bytecode = rect_light_fs_bytecode;
+			fs_bytecode_size = sizeof(rect_light_fs_bytecode);
+			break;
+		case RENDER_BACKEND_PROGRAM_POST_PROCESS:
+			vs_bytecode = post_process_vs_bytecode;
+			vs_bytecode_size = sizeof(post_process_vs_bytecode);
+			fs_bytecode = post_process_fs_bytecode;
+			fs_bytecode_size = sizeof(post_process_fs_bytecode);
+			break;
+		case RENDER_BACKEND_PROGRAM_PLANE_GBUFFER:
+			vs_bytecode = plane_vs_bytecode;
+			vs_bytecode_size = sizeof(plane_vs_bytecode);
+			fs_bytecode = plane_gbuffer_fs_bytecode;
+			fs_bytecode_size = sizeof(plane_gbuffer_fs_bytecode);
+			break;
+		case RENDER_BACKEND_PROGRAM_DEFERRED_LIGHTING:
+			// the pixel shader is created per permutation by the "CreatePipeline"
+			vs_bytecode = post_process_vs_bytecode;
+			vs_bytecode_size = sizeof(post_process_vs_bytecode);
+			break;
+		case RENDER_BACKEND_PROGRAM_PLANE_DEPTH:
+			// the same vertex shader as the "PLANE", such that the "equal" depth test of the "PLANE" matches exactly
+			vs_bytecode = plane_vs_bytecode;
+			vs_bytecode_size = sizeof(plane_vs_bytecode);
+			break;
+		case RENDER_BACKEND_PROGRAM_CHECKERBOARD_RESOLVE:
+			vs_bytecode = post_process_vs_bytecode;
+			vs_bytecode_size = sizeof(post_process_vs_bytecode);
+			fs_bytecode = checkerboard_resolve_fs_bytecode;
+			fs_bytecode_size = sizeof(checkerboard_resolve_fs_bytecode);
+			break;
+		case RENDER_BACKEND_PROGRAM_AUTO_EXPOSURE_HISTOGRAM:
+			vs_bytecode = post_process_vs_bytecode;
+			vs_bytecode_size = sizeof(post_process_vs_bytecode);
+			fs_bytecode = auto_exposure_histogram_fs_bytecode;
+			fs_bytecode_size = sizeof(auto_exposure_histogram_fs_bytecode);
+			break;
+		case RENDER_BACKEND_PROGRAM_AUTO_EXPOSURE:
+			vs_bytecode = post_process_vs_bytecode;
+			vs_bytecode_size = sizeof(post_process_vs_bytecode);
+			fs_bytecode = auto_exposure_fs_bytecode;
+			fs_bytecode_size = sizeof(auto_exposure_fs_bytecode);
+			break;
+		default:
+			assert(false);
+		}
+
+		m_programs[program].vao = NULL;
+		if (RENDER_BACKEND_PROGRAM_PLANE == program || RENDER_BACKEND_PROGRAM_PLANE_GBUFFER == program || RENDER_BACKEND_PROGRAM_PLANE_DEPTH == program)
+		{
+			D3D11_INPUT_ELEMENT_DESC d3d_input_elements_desc[] =
+			{
+				{"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0},
+				{"NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 1, 0, D3D11_INPUT_PER_VERTEX_DATA, 0},
+			};
+
+			HRESULT res_d3d_create_input_layout = m_d3d11_device->CreateInputLayout(
+				d3d_input_elements_desc,
+				sizeof(d3d_input_elements_desc) / sizeof(d3d_input_elements_desc[0]),
+				vs_bytecode,
+				vs_bytecode_size,
+				&m_programs[program].vao);
+			assert(SUCCEEDED(res_d3d_create_input_layout));
+		}
+
+		m_programs[program].vs = NULL;
+		HRESULT res_d3d_device_create_vertex_shader = m_d3d11_device->CreateVertexShader(vs_bytecode, vs_bytecode_size, NULL, &m_programs[program].vs);
+		assert(SUCCEEDED(res_d3d_device_create_vertex_shader));
+
+		m_programs[program].fs = NULL;
+		if (NULL != fs_bytecode)
+		{
+			HRESULT res_d3d_device_create_pixel_shader = m_d3d11_device->CreatePixelShader(fs_bytecode, fs_bytecode_size, NULL, &m_programs[program].fs);
+			assert(SUCCEEDED(res_d3d_device_create_pixel_shader));
+		}
+	}
+
+	for (uint32_t permutation = 0U; permutation < RENDER_BACKEND_PERMUTATION_COUNT; ++permutation)
+	{
+		m_plane_fs_permutations[permutation] = NULL;
+		m_deferred_lighting_fs_permutations[permutation] = NULL;
+	}
+
+	// the initial state of the device context
+	m_bound_vao = NULL;
+	m_bound_vs = NULL;
+	m_bound_fs = NULL;
+	m_bound_rs = NULL;
+	m_bound_dss = NULL;
+
+	for (uint32_t slot = 0U; slot < D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT; ++slot)
+	{
+		m_bound_textures[slot] = NULL;
+	}
+	m_bound_texture_slot_count = 0U;
+	for (uint32_t slot = 0U; slot < RENDER_BACKEND_MAX_COLOR_ATTACHMENT_COUNT; ++slot)
+	{
+		m_bound_color_attachments[slot] = NULL;
+	}
+	m_bound_depth_attachment = NULL;
+
+	for (uint32_t query_index = 0U; query_index < RENDER_BACKEND_D3D11_FRAME_TIME_QUERY_COUNT; ++query_index)
+	{
+		D3D11_QUERY_DESC d3d_query_desc;
+		d3d_query_desc.MiscFlags = 0U;
+
+		d3d_query_desc.Query = D3D11_QUERY_TIMESTAMP_DISJOINT;
+		HRESULT res_d3d_device_create_disjoint_query = m_d3d11_device->CreateQuery(&d3d_query_desc, &m_frame_time_disjoint_queries[query_index]);
+		assert(SUCCEEDED(res_d3d_device_create_disjoint_query));
+
+		d3d_query_desc.Query = D3D11_QUERY_TIMESTAMP;
+		HRESULT res_d3d_device_create_begin_query = m_d3d11_device->CreateQuery(&d3d_query_desc, &m_frame_time_begin_queries[query_index]);
+		assert(SUCCEEDED(res_d3d_device_create_begin_query));
+		HRESULT res_d3d_device_create_end_query = m_d3d11_device->CreateQuery(&d3d_query_desc, &m_frame_time_end_queries[query_index]);
+		assert(SUCCEEDED(res_d3d_device_create_end_query));
+	}
+	m_frame_time_issued_count = 0U;
+	m_frame_time_resolved_count = 0U;
+	m_frame_time_recording = false;
+	m_gpu_frame_time = -1.0f;
+}
+
+void RenderBackendD3D11::Destroy()
+{
+	for (uint32_t query_index = 0U; query_index < RENDER_BACKEND_D3D11_FRAME_TIME_QUERY_COUNT; ++query_index)
+	{
+		m_frame_time_end_queries[query_index]->Release();
+		m_frame_time_begin_queries[query_index]->Release();
+		m_frame_time_disjoint_queries[query_index]->Release();
+	}
+	for (int program = 0; program < RENDER_BACKEND_PROGRAM_COUNT; ++program)
+	{
+		if (NULL != m_programs[program].vao)
+		{
+			m_programs[program].vao->Release();
+		}
+		m_programs[program].vs->Release();
+		if (NULL != m_programs[program].fs)
+		{
+			m_programs[program].fs->Release();
+		}
+	}
+	for (uint32_t permutation = 0U; permutation < RENDER_BACKEND_PERMUTATION_COUNT; ++permutation)
+	{
+		if (NULL != m_plane_fs_permutations[permutation])
+		{
+			m_plane_fs_permutations[permutation]->Release();
+		}
+		if (NULL != m_deferred_lighting_fs_permutations[permutation])
+		{
+			m_deferred_lighting_fs_permutations[permutation]->Release();
+		}
+	}
+	m_rasterizer_state[0]->Release();
+	m_rasterizer_state[1]->Release();
+	for (int depth_test = 0; depth_test < RENDER_BACKEND_DEPTH_TEST_COUNT; ++depth_test)
+	{
+		m_depth_stencil_state[depth_test]->Release();
+	}
+	m_attachment_backbuffer_rtv->Release();
+	m_dxgi_swap_chain->Release();
+	m_d3d11_device_context->Release();
+	m_d3d11_device->Release();
+}
+
+char const *RenderBackendD3D11::GetName() const
+{
+	return "d3d11";
+}
+
+uint32_t RenderBackendD3D11::GetBackbufferWidth() const
+{
+	return m_backbuffer_width;
+}
+
+uint32_t RenderBackendD3D11::GetBackbufferHeight() const
+{
+	return m_backbuffer_height;
+}
+
+float RenderBackendD3D11::GetGPUFrameTime() const
+{
+	return m_gpu_frame_time;
+}
+
+void RenderBackendD3D11::ResizeBackbuffer(uint32_t width, uint32_t height)
+{
+	assert(width > 0U && height > 0U);
+
+	// The "ResizeBuffers" fails unless all the references to the buffers of the swap chain are released, including the binding of the device context.
+	m_d3d11_device_context->OMSetRenderTargets(0U, NULL, NULL);
+	for (uint32_t slot = 0U; slot < RENDER_BACKEND_MAX_COLOR_ATTACHMENT_COUNT; ++slot)
+	{
+		m_bound_color_attachments[slot] = NULL;
+	}
+	m_bound_depth_attachment = NULL;
+	m_attachment_backbuffer_rtv->Release();
+	// the destruction of the unbound view is deferred until the flush
+	m_d3d11_device_context->Flush();
+
+	// the count and the format are kept
+	HRESULT res_dxgi_swap_chain_resize_buffers = m_dxgi_swap_chain->ResizeBuffers(0U, width, height, DXGI_FORMAT_UNKNOWN, 0U);
+	assert(SUCCEEDED(res_dxgi_swap_chain_resize_buffers));
+
+	m_attachment_backbuffer_rtv = d3d11_create_backbuffer_rtv(m_d3d11_device, m_dxgi_swap_chain);
+	m_backbuffer_width = width;
+	m_backbuffer_height = height;
+}
+
+render_backend_buffer_t *RenderBackendD3D11::CreateBuffer(RENDER_BACKEND_BUFFER_USAGE usage, uint32_t size, void const *data)
+{
+	D3D11_BUFFER_DESC d3d_buffer_desc;
+	d3d_buffer_desc.ByteWidth = size;
+	d3d_buffer_desc.Usage = D3D11_USAGE_DEFAULT;
+	d3d_buffer_desc.BindFlags = (RENDER_BACKEND_BUFFER_USAGE_CONSTANT == usage) ? D3D11_BIND_CONSTANT_BUFFER : D3D11_BIND_VERTEX_BUFFER;
+	d3d_buffer_desc.CPUAccessFlags = 0U;
+	d3d_buffer_desc.MiscFlags = 0U;
+	d3d_buffer_desc.StructureByteStride = 0U;
+
+	D3D11_SUBRESOURCE_DATA d3d_subresource_data;
+	d3d_subresource_data.pSysMem = data;
+	d3d_subresource_data.SysMemPitch = size;
+	d3d_subresource_data.SysMemSlicePitch = size;
+
+	ID3D11Buffer *buffer = NULL;
+	HRESULT res_d3d_device_create_buffer = m_d3d11_device->CreateBuffer(&d3d_buffer_desc, (NULL != data) ? &d3d_subresource_data : NULL, &buffer);
+	assert(SUCCEEDED(res_d3d_device_create_buffer));
+
+	return reinterpret_cast<render_backend_buffer_t *>(buffer);
+}
+
+void RenderBackendD3D11::DestroyBuffer(render_backend_buffer_t *buffer)
+{
+	reinterpret_cast<ID3D11Buffer *>(buffer)->Release();
+}
+
+render_backend_texture_t *RenderBackendD3D11::CreateTexture(render_backend_texture_desc_t const &desc, render_backend_subresource_data_t const *subresource_data)
+{
+	d3d11_texture_t *texture = new (std::nothrow) d3d11_texture_t;
+	assert(NULL != texture);
+	texture->texture = NULL;
+	texture->srv = NULL;
+	texture->rtv = NULL;
+	texture->dsv = NULL;
+	texture->width = desc.width;
+	texture->height = desc.height;
+
+	bool const depth = (0U != (desc.usage & RENDER_BACKEND_TEXTURE_USAGE_DEPTH_ATTACHMENT));
+	DXGI_FORMAT const format = d3d11_format(desc.format);
+
+	D3D11_SUBRESOURCE_DATA d3d_subresource_data[D3D11_REQ_MIP_LEVELS];
+	assert(desc.mip_level_count <= D3D11_REQ_MIP_LEVELS);
+	if (NULL != subresource_data)
+	{
+		for (uint32_t level_index = 0U; level_index < desc.mip_level_count; ++level_index)
+		{
+			d3d_subresource_data[level_index].pSysMem = subresource_data[level_index].data;
+			d3d_subresource_data[level_index].SysMemPitch = subresource_data[level_index].row_pitch;
+			d3d_subresource_data[level_index].SysMemSlicePitch = subresource_data[level_index].slice_pitch;
+		}
+	}
+
+	if (RENDER_BACKEND_TEXTURE_VIEW_DIMENSION_3D == desc.view_dimension)
+	{
+		// only sampled
+		assert(RENDER_BACKEND_TEXTURE_USAGE_SAMPLED == desc.usage);
+
+		D3D11_TEXTURE3D_DESC d3d_texture3d_desc;
+		d3d_texture3d_desc.Width = desc.width;
+		d3d_texture3d_desc.Height = desc.height;
+		d3d_texture3d_desc.Depth = desc.depth;
+		d3d_texture3d_desc.MipLevels = desc.mip_level_count;
+		d3d_texture3d_desc.Format = format;
+		d3d_texture3d_desc.Usage = (NULL != subresource_data) ? D3D11_USAGE_IMMUTABLE : D3D11_USAGE_DEFAULT;
+		d3d_texture3d_desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+		d3d_texture3d_desc.CPUAccessFlags = 0U;
+		d3d_texture3d_desc.MiscFlags = 0U;
+
+		ID3D11Texture3D *d3d_texture3d = NULL;
+		HRESULT res_d3d_device_create_texture = m_d3d11_device->CreateTexture3D(&d3d_texture3d_desc, (NULL != subresource_data) ? d3d_subresource_data : NULL, &d3d_texture3d);
+		assert(SUCCEEDED(res_d3d_device_create_texture));
+		texture->texture = d3d_texture3d;
+	}
+	else
+	{
+		D3D11_TEXTURE2D_DESC d3d_texture2d_desc;
+		d3d_texture2d_desc.Width = desc.width;
+		d3d_texture2d_desc.Height = desc.height;
+		d3d_texture2d_desc.MipLevels = desc.mip_level_count;
+		d3d_texture2d_desc.ArraySize = 1U;
+		// the depth is typeless such that it can be sampled
+		d3d_texture2d_desc.Format = depth ? DXGI_FORMAT_R32_TYPELESS : format;
+		d3d_texture2d_desc.SampleDesc.Count = 1U;
+		d3d_texture2d_desc.SampleDesc.Quality = 0U;
+		d3d_texture2d_desc.Usage = (NULL != subresource_data && RENDER_BACKEND_TEXTURE_USAGE_SAMPLED == desc.usage) ? D3D11_USAGE_IMMUTABLE : D3D11_USAGE_DEFAULT;
+		d3d_texture2d_desc.BindFlags = 0U;
+		d3d_texture2d_desc.BindFlags |= (0U != (desc.usage & RENDER_BACKEND_TEXTURE_USAGE_SAMPLED)) ? D3D11_BIND_SHADER_RESOURCE : 0U;
+		d3d_texture2d_desc.BindFlags |= (0U != (desc.usage & RENDER_BACKEND_TEXTURE_USAGE_COLOR_ATTACHMENT)) ? D3D11_BIND_RENDER_TARGET : 0U;
+		d3d_texture2d_desc.BindFlags |= depth ? D3D11_BIND_DEPTH_STENCIL : 0U;
+		d3d_texture2d_desc.CPUAccessFlags = 0U;
+		d3d_texture2d_desc.MiscFlags = 0U;
+
+		ID3D11Texture2D *d3d_texture2d = NULL;
+		HRESULT res_d3d_device_create_texture = m_d3d11_device->CreateTexture2D(&d3d_texture2d_desc, (NULL != subresource_data) ? d3d_subresource_data : NULL, &d3d_texture2d);
+		assert(SUCCEEDED(res_d3d_device_create_texture));
+		texture->texture = d3d_texture2d;
+	}
+
+	if (0U != (desc.usage & RENDER_BACKEND_TEXTURE_USAGE_SAMPLED))
+	{
+		D3D11_SHADER_RESOURCE_VIEW_DESC d3d_shader_resource_view_desc;
+		d3d_shader_resource_view_desc.Format = depth ? DXGI_FORMAT_R32_FLOAT : format;
+		if (RENDER_BACKEND_TEXTURE_VIEW_DIMENSION_3D == desc.view_dimension)
+		{
+			d3d_shader_resource_view_desc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE3D;
+			d3d_shader_resource_view_desc.Texture3D.MostDetailedMip = 0U;
+			d3d_shader_resource_view_desc.Texture3D.MipLevels = desc.mip_level_count;
+		}
+		else if (RENDER_BACKEND_TEXTURE_VIEW_DIMENSION_2D_ARRAY == desc.view_dimension)
+		{
+			d3d_shader_resource_view_desc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2DARRAY;
+			d3d_shader_resource_view_desc.Texture2DArray.MostDetailedMip = 0U;
+			d3d_shader_resource_view_desc.Texture2DArray.MipLevels = desc.mip_level_count;
+			d3d_shader_resource_view_desc.Texture2DArray.FirstArraySlice = 0U;
+			d3d_shader_resource_view_desc.Texture2DArray.ArraySize = 1U;
+		}
+		else
+		{
+			d3d_shader_resource_view_desc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+			d3d_shader_resource_view_desc.Texture2D.MostDetailedMip = 0U;
+			d3d_shader_resource_view_desc.Texture2D.MipLevels = desc.mip_level_count;
+		}
+
+		HRESULT res_d3d_device_create_shader_resource_view = m_d3d11_device->CreateShaderResourceView(texture->texture, &d3d_shader_resource_view_desc, &texture->srv);
+		assert(SUCCEEDED(res_d3d_device_create_shader_resource_view));
+	}
+
+	if (0U != (desc.usage & RENDER_BACKEND_TEXTURE_USAGE_COLOR_ATTACHMENT))
+	{
+		D3D11_RENDER_TARGET_VIEW_DESC d3d_render_target_view_desc;
+		d3d_render_target_view_desc.Format = format;
+		d3d_render_target_view_desc.ViewDimension = D3D11_RTV_DIMENSION_TEXTURE2D;
+		d3d_render_target_view_desc.Texture2D.MipSlice = 0U;
+
+		HRESULT res_d3d_device_create_render_target_view = m_d3d11_device->CreateRenderTargetView(texture->texture, &d3d_render_target_view_desc, &texture->rtv);
+		assert(SUCCEEDED(res_d3d_device_create_render_target_view));
+	}
+
+	if (depth)
+	{
+		D3D11_DEPTH_STENCIL_VIEW_DESC d3d_depth_stencil_view_desc;
+		d3d_depth_stencil_view_desc.Format = format;
+		d3d_depth_stencil_view_desc.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2D;
+		d3d_depth_stencil_view_desc.Flags = 0U;
+		d3d_depth_stencil_view_desc.Texture2D.MipSlice = 0U;
+
+		HRESULT res_d3d_device_create_depth_stencil_view = m_d3d11_device->CreateDepthStencilView(texture->texture, &d3d_depth_stencil_view_desc, &texture->dsv);
+		assert(SUCCEEDED(res_d3d_device_create_depth_stencil_view));
+	}
+
+	return reinterpret_cast<render_backend_texture_t *>(texture);
+}
+
+void RenderBackendD3D11::DestroyTexture(render_backend_texture_t *texture_handle)
+{
+	d3d11_texture_t *texture = reinterpret_cast<d3d11_texture_t *>(texture_handle);
+
+	// the new texture may be allocated at the same address
+	for (uint32_t slot = 0U; slot < m_bound_texture_slot_count; ++slot)
+	{
+		m_bound_textures[slot] = (texture != m_bound_textures[slot]) ? m_bound_textures[slot] : NULL;
+	}
+	for (uint32_t slot = 0U; slot < RENDER_BACKEND_MAX_COLOR_ATTACHMENT_COUNT; ++slot)
+	{
+		m_bound_color_attachments[slot] = (texture != m_bound_color_attachments[slot]) ? m_bound_color_attachments[slot] : NULL;
+	}
+	m_bound_depth_attachment = (texture != m_bound_depth_attachment) ? m_bound_depth_attachment : NULL;
+
+	if (NULL != texture->dsv)
+	{
+		texture->dsv->Release();
+	}
+
+	if (NULL != texture->rtv)
+	{
+		texture->rtv->Release();
+	}
+
+	if (NULL != texture->srv)
+	{
+		texture->srv->Release();
+	}
+
+	texture->texture->Release();
+
+	delete texture;
+}
+
+render_backend_sampler_t *RenderBackendD3D11::CreateSampler(RENDER_BACKEND_FILTER filter)
+{
+	D3D11_SAMPLER_DESC d3d_sampler_desc;
+	d3d_sampler_desc.Filter = (RENDER_BACKEND_FILTER_MIN_MAG_MIP_LINEAR == filter) ? D3D11_FILTER_MIN_MAG_MIP_LINEAR : D3D11_FILTER_MIN_POINT_MAG_LINEAR_MIP_POINT;
+	d3d_sampler_desc.AddressU = D3D11_TEXTURE_ADDRESS_CLAMP;
+	d3d_sampler_desc.AddressV = D3D11_TEXTURE_ADDRESS_CLAMP;
+	d3d_sampler_desc.AddressW = D3D11_TEXTURE_ADDRESS_CLAMP;
+	d3d_sampler_desc.MipLODBias = 0.0;
+	d3d_sampler_desc.MaxAnisotropy = 0U;
+	d3d_sampler_desc.ComparisonFunc = D3D11_COMPARISON_ALWAYS;
+	d3d_sampler_desc.BorderColor[0] = 0.0;
+	d3d_sampler_desc.BorderColor[1] = 0.0;
+	d3d_sampler_desc.BorderColor[2] = 0.0;
+	d3d_sampler_desc.BorderColor[3] = 1.0;
+	d3d_sampler_desc.MinLOD = 0.0;
+	d3d_sampler_desc.MaxLOD = 4096.0;
+
+	ID3D11SamplerState *sampler = NULL;
+	HRESULT res_d3d_device_create_sampler = m_d3d11_device->CreateSamplerState(&d3d_sampler_desc, &sampler);
+	assert(SUCCEEDED(res_d3d_device_create_sampler));
+
+	return reinterpret_cast<render_backend_sampler_t *>(sampler);
+}
+
+void RenderBackendD3D11::DestroySampler(render_backend_sampler_t *sampler)
+{
+	reinterpret_cast<ID3D11SamplerState *>(sampler)->Release();
+}
+
+render_backend_pipeline_t *RenderBackendD3D11::CreatePipeline(render_backend_pipeline_desc_t const &desc)
+{
+	assert(desc.program < RENDER_BACKEND_PROGRAM_COUNT);
+
+	d3d11_pipeline_t *pipeline = new (std::nothrow) d3d11_pipeline_t;
+	assert(NULL != pipeline);
+	// the sub-states are owned by the backend and shared by all the pipelines
+	pipeline->vao = m_programs[desc.program].vao;
+	pipeline->vs = m_programs[desc.program].vs;
+	pipeline->fs = m_programs[desc.program].fs;
+	if (RENDER_BACKEND_PROGRAM_PLANE == desc.program || RENDER_BACKEND_PROGRAM_DEFERRED_LIGHTING == desc.program)
+	{
+		assert(desc.permutation < RENDER_BACKEND_PERMUTATION_COUNT);
+
+		bool const plane = (RENDER_BACKEND_PROGRAM_PLANE == desc.program);
+		ID3D11PixelShader **fs_permutation = plane ? &m_plane_fs_permutations[desc.permutation] : &m_deferred_lighting_fs_permutations[desc.permutation];
+		d3d11_bytecode_t const &fs_bytecode = plane ? plane_fs_permutations[desc.permutation] : deferred_lighting_fs_permutations[desc.permutation];
+
+		// created when the permutation is first used, and kept until the "Destroy"
+		if (NULL == (*fs_permutation))
+		{
+			HRESULT res_d3d_device_create_pixel_shader = m_d3d11_device->CreatePixelShader(fs_bytecode.bytecode, fs_bytecode.bytecode_size, NULL, fs_permutation);
+			assert(SUCCEEDED(res_d3d_device_create_pixel_shader));
+		}
+
+		pipeline->fs = (*fs_permutation);
+	}
+	pipeline->rs = m_rasterizer_state[desc.front_counter_clockwise ? 1 : 0];
+	assert(desc.depth_test < RENDER_BACKEND_DEPTH_TEST_COUNT);
+	pipeline->dss = m_depth_stencil_state[desc.depth_test];
+
+	return reinterpret_cast<render_backend_pipeline_t *>(pipeline);
+}
+
+void RenderBackendD3D11::DestroyPipeline(render_backend_pipeline_t *pipeline_handle)
+{
+	d3d11_pipeline_t *pipeline = reinterpret_cast<d3d11_pipeline_t *>(pipeline_handle);
+
+	delete pipeline;
+}
+
+void RenderBackendD3D11::UpdateBuffer(render_backend_buffer_t *buffer, void const *data, uint32_t size)
+{
+	m_d3d11_device_context->UpdateSubresource(reinterpret_cast<ID3D11Buffer *>(buffer), 0U, NULL, data, size, size);
+}
+
+void RenderBackendD3D11::BeginPass(render_backend_pass_desc_t const &desc)
+{
+	assert(desc.color_attachment_count > 0U && desc.color_attachment_count <= RENDER_BACKEND_MAX_COLOR_ATTACHMENT_COUNT);
+
+	// the first pass of the frame (skipped if the queries of all the frames in flight are still pending)
+	if (!m_frame_time_recording && (m_frame_time_issued_count - m_frame_time_resolved_count) < RENDER_BACKEND_D3D11_FRAME_TIME_QUERY_COUNT)
+	{
+		uint32_t const query_index = m_frame_time_issued_count % RENDER_BACKEND_D3D11_FRAME_TIME_QUERY_COUNT;
+		m_d3d11_device_context->Begin(m_frame_time_disjoint_queries[query_index]);
+		m_d3d11_device_context->End(m_frame_time_begin_queries[query_index]);
+		m_frame_time_recording = true;
+	}
+
+	d3d11_texture_t *color_attachments[RENDER_BACKEND_MAX_COLOR_ATTACHMENT_COUNT];
+	ID3D11RenderTargetView *rtvs[RENDER_BACKEND_MAX_COLOR_ATTACHMENT_COUNT];
+	for (uint32_t slot = 0U; slot < desc.color_attachment_count; ++slot)
+	{
+		color_attachments[slot] = reinterpret_cast<d3d11_texture_t *>(desc.color_attachments[slot]);
+		rtvs[slot] = (NULL != color_attachments[slot]) ? color_attachments[slot]->rtv : m_attachment_backbuffer_rtv;
+	}
+	d3d11_texture_t *depth_attachment = reinterpret_cast<d3d11_texture_t *>(desc.depth_attachment);
+
+	ID3D11DepthStencilView *dsv = (NULL != depth_attachment) ? depth_attachment->dsv : NULL;
+	m_d3d11_device_context->OMSetRenderTargets(desc.color_attachment_count, rtvs, dsv);
+	for (uint32_t slot = 0U; slot < RENDER_BACKEND_MAX_COLOR_ATTACHMENT_COUNT; ++slot)
+	{
+		m_bound_color_attachments[slot] = (slot < desc.color_attachment_count) ? color_attachments[slot] : NULL;
+	}
+	m_bound_depth_attachment = depth_attachment;
+
+	for (uint32_t slot = 0U; slot < desc.color_attachment_count; ++slot)
+	{
+		if (desc.clear_color[slot])
+		{
+			m_d3d11_device_context->ClearRenderTargetView(rtvs[slot], desc.clear_color_value[slot]);
+		}
+	}
+
+	if (desc.clear_depth && NULL != dsv)
+	{
+		m_d3d11_device_context->ClearDepthStencilView(dsv, D3D11_CLEAR_DEPTH, desc.clear_depth_value, 0U);
+	}
+
+	uint32_t const width = (NULL != color_attachments[0]) ? color_attachments[0]->width : m_backbuffer_width;
+	uint32_t const height = (NULL != color_attachments[0]) ? color_attachments[0]->height : m_backbuffer_height;
+	D3D11_VIEWPORT viewport = { 0.0f, 0.0f, static_cast<FLOAT>(width), static_cast<FLOAT>(height), 0.0f, 1.0f };
+	m_d3d11_device_context->RSSetViewports(1U, &viewport);
+
+	m_d3d11_device_context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
+}
+
+void RenderBackendD3D11::EndPass()
+{
+}
+
+void RenderBackendD3D11::Barrier(render_backend_texture_t *texture_handle, RENDER_BACKEND_TEXTURE_STATE before, RENDER_BACKEND_TEXTURE_STATE)
+{
+	d3d11_texture_t *texture = reinterpret_cast<d3d11_texture_t *>(texture_handle);
+
+	// The runtime refuses to bind the resource as both the SRV and the RTV/DSV (and silently unbinds the SRV with the warning).
+	if (RENDER_BACKEND_TEXTURE_STATE_SAMPLED == before)
+	{
+		for (uint32_t slot = 0U; slot < m_bound_texture_slot_count; ++slot)
+		{
+			if (texture == m_bound_textures[slot])
+			{
+				ID3D11ShaderResourceView *srv = NULL;
+				m_d3d11_device_context->PSSetShaderResources(slot, 1U, &srv);
+				m_bound_textures[slot] = NULL;
+			}
+		}
+	}
+	else
+	{
+		bool bound = (texture == m_bound_depth_attachment);
+		for (uint32_t slot = 0U; slot < RENDER_BACKEND_MAX_COLOR_ATTACHMENT_COUNT; ++slot)
+		{
+			bound = bound || (texture == m_bound_color_attachments[slot]);
+		}
+
+		if (bound)
+		{
+			m_d3d11_device_context->OMSetRenderTargets(0U, NULL, NULL);
+			for (uint32_t slot = 0U; slot < RENDER_BACKEND_MAX_COLOR_ATTACHMENT_COUNT; ++slot)
+			{
+				m_bound_color_attachments[slot] = NULL;
+			}
+			m_bound_depth_attachment = NULL;
+		}
+	}
+}
+
+void RenderBackendD3D11::SetPipeline(render_backend_pipeline_t *pipeline_handle)
+{
+	d3d11_pipeline_t *pipeline = reinterpret_cast<d3d11_pipeline_t *>(pipeline_handle);
+
+	// the different pipelines share most of the sub-states (e.g. the light pass of the odd and the even frame only differ in the "FrontCounterClockwise")
+	if (pipeline->rs != m_bound_rs)
+	{
+		m_d3d11_device_context->RSSetState(pipeline->rs);
+	}
+	if (pipeline->dss != m_bound_dss)
+	{
+		m_d3d11_device_context->OMSetDepthStencilState(pipeline->dss, 0U);
+	}
+	if (pipeline->vs != m_bound_vs)
+	{
+		m_d3d11_device_context->VSSetShader(pipeline->vs, NULL, 0U);
+	}
+	if (pipeline->fs != m_bound_fs)
+	{
+		m_d3d11_device_context->PSSetShader(pipeline->fs, NULL, 0U);
+	}
+	if (pipeline->vao != m_bound_vao)
+	{
+		m_d3d11_device_context->IASetInputLayout(pipeline->vao);
+	}
+	m_bound_vao = pipeline->vao;
+	m_bound_vs = pipeline->vs;
+	m_bound_fs = pipeline->fs;
+	m_bound_rs = pipeline->rs;
+	m_bound_dss = pipeline->dss;
+}
+
+void RenderBackendD3D11::SetVertexBuffers(uint32_t first_slot, uint32_t buffer_count, render_backend_buffer_t *const *buffers, uint32_t const *strides)
+{
+	ID3D11Buffer *vertex_buffers[D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT];
+	UINT offsets[D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT];
+	assert(buffer_count <= D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT);
+	for (uint32_t buffer_index = 0U; buffer_index < buffer_count; ++buffer_index)
+	{
+		vertex_buffers[buffer_index] = reinterpret_cast<ID3D11Buffer *>(buffers[buffer_index]);
+		offsets[buffer_index] = 0U;
+	}
+
+	m_d3d11_device_context->IASetVertexBuffers(first_slot, buffer_count, vertex_buffers, strides, offsets);
+}
+
+void RenderBackendD3D11::SetConstantBuffer(uint32_t slot, render_backend_buffer_t *buffer)
+{
+	ID3D11Buffer *constant_buffer = reinterpret_cast<ID3D11Buffer *>(buffer);
+	m_d3d11_device_context->VSSetConstantBuffers(slot, 1U, &constant_buffer);
+	m_d3d11_device_context->PSSetConstantBuffers(slot, 1U, &constant_buffer);
+}
+
+void RenderBackendD3D11::SetTexture(uint32_t slot, render_backend_texture_t *texture)
+{
+	ID3D11ShaderResourceView *srv = reinterpret_cast<d3d11_texture_t *>(texture)->srv;
+	m_d3d11_device_context->PSSetShaderResources(slot, 1U, &srv);
+
+	m_bound_textures[slot] = reinterpret_cast<d3d11_texture_t *>(texture);
+	m_bound_texture_slot_count = (m_bound_texture_slot_count > (slot + 1U)) ? m_bound_texture_slot_count : (slot + 1U);
+}
+
+void RenderBackendD3D11::SetSampler(uint32_t slot, render_backend_sampler_t *sampler)
+{
+	ID3D11SamplerState *sampler_state = reinterpret_cast<ID3D11SamplerState *>(sampler);
+	m_d3d11_device_context->PSSetSamplers(slot, 1U, &sampler_state);
+}
+
+void RenderBackendD3D11::Draw(uint32_t vertex_count)
+{
+	m_d3d11_device_context->DrawInstanced(vertex_count, 1U, 0U, 0U);
+}
+
+void RenderBackendD3D11::Present()
+{
+	if (m_frame_time_recording)
+	{
+		uint32_t const query_index = m_frame_time_issued_count % RENDER_BACKEND_D3D11_FRAME_TIME_QUERY_COUNT;
+		m_d3d11_device_context->End(m_frame_time_end_queries[query_index]);
+		m_d3d11_device_context->End(m_frame_time_disjoint_queries[query_index]);
+		++m_frame_time_issued_count;
+		m_frame_time_recording = false;
+	}
+
+	HRESULT res_dxgi_swap_chain_present = m_dxgi_swap_chain->Present(1U, 0U);
+	assert(SUCCEEDED(res_dxgi_swap_chain_present));
+
+	// the completed frames are read back in order, the "DONOTFLUSH" never waits for the device
+	while (m_frame_time_resolved_count != m_frame_time_issued_count)
+	{
+		uint32_t const query_index = m_frame_time_resolved_count % RENDER_BACKEND_D3D11_FRAME_TIME_QUERY_COUNT;
+
+		D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjoint;
+		if (S_OK != m_d3d11_device_context->GetData(m_frame_time_disjoint_queries[query_index], &disjoint, sizeof(disjoint), D3D11_ASYNC_GETDATA_DONOTFLUSH))
+		{
+			break;
+		}
+
+		UINT64 begin_timestamp = 0U;
+		UINT64 end_timestamp = 0U;
+		HRESULT res_begin = m_d3d11_device_context->GetData(m_frame_time_begin_queries[query_index], &begin_timestamp, sizeof(begin_timestamp), D3D11_ASYNC_GETDATA_DONOTFLUSH);
+		HRESULT res_end = m_d3d11_device_context->GetData(m_frame_time_end_queries[query_index], &end_timestamp, sizeof(end_timestamp), D3D11_ASYNC_GETDATA_DONOTFLUSH);
+
+		// the timestamps are NOT reliable if the clock changed within the frame (e.g. the power state)
+		if (S_OK == res_begin && S_OK == res_end && (!disjoint.Disjoint) && disjoint.Frequency > 0U && end_timestamp >= begin_timestamp)
+		{
+			m_gpu_frame_time = static_cast<float>(static_cast<double>(end_timestamp - begin_timestamp) * 1000.0 / static_cast<double>(disjoint.Frequency));
+		}
+
+		++m_frame_time_resolved_count;
+	}
+}
+
+static DXGI_FORMAT d3d11_format(RENDER_BACKEND_FORMAT format)
+{
+	switch (format)
+	{
+	case RENDER_BACKEND_FORMAT_R8G8B8A8_SNORM:
+		return DXGI_FORMAT_R8G8B8A8_SNORM;
+	case RENDER_BACKEND_FORMAT_R8G8_UNORM:
+		return DXGI_FORMAT_R8G8_UNORM;
+	case RENDER_BACKEND_FORMAT_R16G16B16A16_FLOAT:
+		return DXGI_FORMAT_R16G16B16A16_FLOAT;
+	case RENDER_BACKEND_FORMAT_D32_FLOAT:
+		return DXGI_FORMAT_D32_FLOAT;
+	case RENDER_BACKEND_FORMAT_R32G32B32A32_FLOAT:
+		return DXGI_FORMAT_R32G32B32A32_FLOAT;
+	default:
+		assert(false);
+		return DXGI_FORMAT_UNKNOWN;
+	}
+}
+
+static ID3D11RenderTargetView *d3d11_create_backbuffer_rtv(ID3D11Device *d3d11_device, IDXGISwapChain *dxgi_swap_chain)
+{
+	ID3D11Texture2D *attachment_backbuffer = NULL;
+	HRESULT res_dxgi_swap_chain_get_buffer = dxgi_swap_chain->GetBuffer(0U, IID_PPV_ARGS(&attachment_backbuffer));
+	assert(SUCCEEDED(res_dxgi_swap_chain_get_buffer));
+
+	D3D11_RENDER_TARGET_VIEW_DESC d3d_render_target_view_desc;
+	d3d_render_target_view_desc.Format = DXGI_FORMAT_B8G8R8A8_UNORM;
+	d3d_render_target_view_desc.ViewDimension = D3D11_RTV_DIMENSION_TEXTURE2D;
+	d3d_render_target_view_desc.Texture2D.MipSlice = 0U;
+
+	ID3D11RenderTargetView *attachment_backbuffer_rtv = NULL;
+	HRESULT res_d3d_device_create_render_target_view = d3d11_device->CreateRenderTargetView(attachment_backbuffer, &d3d_render_target_view_desc, &attachment_backbuffer_rtv);
+	assert(SUCCEEDED(res_d3d_device_create_render_target_view));
+
+	attachment_backbuffer->Release();
+	return attachment_backbuffer_rtv;
+}
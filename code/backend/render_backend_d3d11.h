@@ -0,0 +1,113 @@
+#ifndef _BACKEND_RENDER_BACKEND_D3D11_H_
+#define _BACKEND_RENDER_BACKEND_D3D11_H_ 1
+
+#include <sdkddkver.h>
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN 1
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX 1
+#endif
+#include <windows.h>
+
+#include <dxgi.h>
+#include <d3d11.h>
+
+#include "render_backend.h"
+
+// the frames of which the timestamps may be pending at the same time (see "GetGPUFrameTime")
+#define RENDER_BACKEND_D3D11_FRAME_TIME_QUERY_COUNT 4U
+
+class RenderBackendD3D11 : public RenderBackend
+{
+	ID3D11Device *m_d3d11_device;
+	ID3D11DeviceContext *m_d3d11_device_context;
+	IDXGISwapChain *m_dxgi_swap_chain;
+	ID3D11RenderTargetView *m_attachment_backbuffer_rtv;
+	uint32_t m_backbuffer_width;
+	uint32_t m_backbuffer_height;
+
+	// The pipelines differ in few sub-states, which are created once by the "Init" and shared by the pipelines.
+	// indexed by the "program" of the pipeline
+	struct
+	{
+		ID3D11InputLayout *vao;
+		ID3D11VertexShader *vs;
+		// NULL: the "PLANE" and the "DEFERRED_LIGHTING" programs, of which the pixel shader is per permutation, and the "PLANE_DEPTH" which has no pixel shader
+		ID3D11PixelShader *fs;
+	} m_programs[RENDER_BACKEND_PROGRAM_COUNT];
+	// the pixel shaders of the "PLANE" and the "DEFERRED_LIGHTING" programs, indexed by the permutation (NULL: NOT used yet)
+	ID3D11PixelShader *m_plane_fs_permutations[RENDER_BACKEND_PERMUTATION_COUNT];
+	ID3D11PixelShader *m_deferred_lighting_fs_permutations[RENDER_BACKEND_PERMUTATION_COUNT];
+	// indexed by the "front_counter_clockwise" of the pipeline
+	ID3D11RasterizerState *m_rasterizer_state[2];
+	// indexed by the "depth_test" of the pipeline
+	ID3D11DepthStencilState *m_depth_stencil_state[RENDER_BACKEND_DEPTH_TEST_COUNT];
+
+	// the sub-states which are currently bound, the "SetPipeline" skips the unchanged ones
+	ID3D11InputLayout *m_bound_vao;
+	ID3D11VertexShader *m_bound_vs;
+	ID3D11PixelShader *m_bound_fs;
+	ID3D11RasterizerState *m_bound_rs;
+	ID3D11DepthStencilState *m_bound_dss;
+
+	// the views which are still bound, unbound by the "Barrier"
+	struct d3d11_texture_t *m_bound_textures[D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT];
+	uint32_t m_bound_texture_slot_count;
+	struct d3d11_texture_t *m_bound_color_attachments[RENDER_BACKEND_MAX_COLOR_ATTACHMENT_COUNT];
+	struct d3d11_texture_t *m_bound_depth_attachment;
+
+	// The timestamps of the first "BeginPass" and of the "Present" of each frame, read back without stalling (the oldest pending frame is polled by each "Present").
+	// The frame is NOT measured if all the queries are still pending.
+	ID3D11Query *m_frame_time_disjoint_queries[RENDER_BACKEND_D3D11_FRAME_TIME_QUERY_COUNT];
+	ID3D11Query *m_frame_time_begin_queries[RENDER_BACKEND_D3D11_FRAME_TIME_QUERY_COUNT];
+	ID3D11Query *m_frame_time_end_queries[RENDER_BACKEND_D3D11_FRAME_TIME_QUERY_COUNT];
+	// the frames issued and read back, the query of the frame is the index modulo the count
+	uint32_t m_frame_time_issued_count;
+	uint32_t m_frame_time_resolved_count;
+	bool m_frame_time_recording;
+	float m_gpu_frame_time;
+
+public:
+	void Init(HWND hWnd, uint32_t width, uint32_t height);
+	void Destroy();
+
+	char const *GetName() const;
+
+	uint32_t GetBackbufferWidth() const;
+	uint32_t GetBackbufferHeight() const;
+
+	float GetGPUFrameTime() const;
+
+	void ResizeBackbuffer(uint32_t width, uint32_t height);
+
+	render_backend_buffer_t *CreateBuffer(RENDER_BACKEND_BUFFER_USAGE usage, uint32_t size, void const *data);
+	void DestroyBuffer(render_backend_buffer_t *buffer);
+
+	render_backend_texture_t *CreateTexture(render_backend_texture_desc_t const &desc, render_backend_subresource_data_t const *subresource_data);
+	void DestroyTexture(render_backend_texture_t *texture);
+
+	render_backend_sampler_t *CreateSampler(RENDER_BACKEND_FILTER filter);
+	void DestroySampler(render_backend_sampler_t *sampler);
+
+	render_backend_pipeline_t *CreatePipeline(render_backend_pipeline_desc_t const &desc);
+	void DestroyPipeline(render_backend_pipeline_t *pipeline);
+
+	void UpdateBuffer(render_backend_buffer_t *buffer, void const *data, uint32_t size);
+
+	void BeginPass(render_backend_pass_desc_t const &desc);
+	void EndPass();
+
+	void Barrier(render_backend_texture_t *texture, RENDER_BACKEND_TEXTURE_STATE before, RENDER_BACKEND_TEXTURE_STATE after);
+
+	void SetPipeline(render_backend_pipeline_t *pipeline);
+	void SetVertexBuffers(uint32_t first_slot, uint32_t buffer_count, render_backend_buffer_t *const *buffers, uint32_t const *strides);
+	void SetConstantBuffer(uint32_t slot, render_backend_buffer_t *buffer);
+	void SetTexture(uint32_t slot, render_backend_texture_t *texture);
+	void SetSampler(uint32_t slot, render_backend_sampler_t *sampler);
+	void Draw(uint32_t vertex_count);
+
+	void Present();
+};
+
+#endif
@@ -0,0 +1,188 @@
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <algorithm>
+#include <new>
+
+#include "render_backend_null.h"
+
+// the size is required by the "DestroyBuffer"
+struct null_buffer_t
+{
+	RENDER_BACKEND_BUFFER_USAGE usage;
+	uint32_t size;
+};
+
+// The other handles are never dereferenced, any non-NULL value is fine.
+// The values are unique, such that the layers above (e.g. "render_backend_state_tracker.h") can tell the handles apart.
+template <typename T>
+static inline T *null_handle(uintptr_t &handle_count)
+{
+	++handle_count;
+	return reinterpret_cast<T *>(static_cast<uintptr_t>(16U) * handle_count);
+}
+
+void RenderBackendNull::Init(uint32_t width, uint32_t height)
+{
+	m_backbuffer_width = width;
+	m_backbuffer_height = height;
+	m_handle_count = 0U;
+	memset(&m_statistics, 0, sizeof(render_backend_null_statistics_t));
+}
+
+render_backend_null_statistics_t const &RenderBackendNull::GetStatistics() const
+{
+	return m_statistics;
+}
+
+char const *RenderBackendNull::GetName() const
+{
+	return "null";
+}
+
+uint32_t RenderBackendNull::GetBackbufferWidth() const
+{
+	return m_backbuffer_width;
+}
+
+uint32_t RenderBackendNull::GetBackbufferHeight() const
+{
+	return m_backbuffer_height;
+}
+
+float RenderBackendNull::GetGPUFrameTime() const
+{
+	// nothing is executed
+	return -1.0f;
+}
+
+void RenderBackendNull::ResizeBackbuffer(uint32_t width, uint32_t height)
+{
+	assert(width > 0U && height > 0U);
+	m_backbuffer_width = width;
+	m_backbuffer_height = height;
+	++m_statistics.resize_count;
+}
+
+render_backend_buffer_t *RenderBackendNull::CreateBuffer(RENDER_BACKEND_BUFFER_USAGE usage, uint32_t size, void const *data)
+{
+	null_buffer_t *buffer = new (std::nothrow) null_buffer_t;
+	assert(NULL != buffer);
+	buffer->usage = usage;
+	buffer->size = size;
+
+	++m_statistics.buffer_count;
+	m_statistics.create_byte_count += (NULL != data) ? size : 0U;
+	m_statistics.constant_buffer_byte_count += (RENDER_BACKEND_BUFFER_USAGE_CONSTANT == usage) ? size : 0U;
+	return reinterpret_cast<render_backend_buffer_t *>(buffer);
+}
+
+void RenderBackendNull::DestroyBuffer(render_backend_buffer_t *buffer_handle)
+{
+	null_buffer_t *buffer = reinterpret_cast<null_buffer_t *>(buffer_handle);
+
+	assert(m_statistics.buffer_count > 0U);
+	--m_statistics.buffer_count;
+	m_statistics.constant_buffer_byte_count -= (RENDER_BACKEND_BUFFER_USAGE_CONSTANT == buffer->usage) ? buffer->size : 0U;
+
+	delete buffer;
+}
+
+render_backend_texture_t *RenderBackendNull::CreateTexture(render_backend_texture_desc_t const &desc, render_backend_subresource_data_t const *subresource_data)
+{
+	++m_statistics.texture_count;
+	if (NULL != subresource_data)
+	{
+		for (uint32_t level_index = 0U; level_index < desc.mip_level_count; ++level_index)
+		{
+			m_statistics.create_byte_count += static_cast<uint64_t>(subresource_data[level_index].slice_pitch) * std::max(1U, desc.depth >> level_index);
+		}
+	}
+	return null_handle<render_backend_texture_t>(m_handle_count);
+}
+
+void RenderBackendNull::DestroyTexture(render_backend_texture_t *)
+{
+	assert(m_statistics.texture_count > 0U);
+	--m_statistics.texture_count;
+}
+
+render_backend_sampler_t *RenderBackendNull::CreateSampler(RENDER_BACKEND_FILTER)
+{
+	++m_statistics.sampler_count;
+	return null_handle<render_backend_sampler_t>(m_handle_count);
+}
+
+void RenderBackendNull::DestroySampler(render_backend_sampler_t *)
+{
+	assert(m_statistics.sampler_count > 0U);
+	--m_statistics.sampler_count;
+}
+
+render_backend_pipeline_t *RenderBackendNull::CreatePipeline(render_backend_pipeline_desc_t const &)
+{
+	++m_statistics.pipeline_count;
+	return null_handle<render_backend_pipeline_t>(m_handle_count);
+}
+
+void RenderBackendNull::DestroyPipeline(render_backend_pipeline_t *)
+{
+	assert(m_statistics.pipeline_count > 0U);
+	--m_statistics.pipeline_count;
+}
+
+void RenderBackendNull::UpdateBuffer(render_backend_buffer_t *, void const *, uint32_t size)
+{
+	++m_statistics.update_buffer_count;
+	m_statistics.update_buffer_byte_count += size;
+}
+
+void RenderBackendNull::BeginPass(render_backend_pass_desc_t const &)
+{
+	++m_statistics.pass_count;
+}
+
+void RenderBackendNull::EndPass()
+{
+}
+
+void RenderBackendNull::Barrier(render_backend_texture_t *, RENDER_BACKEND_TEXTURE_STATE, RENDER_BACKEND_TEXTURE_STATE)
+{
+	++m_statistics.barrier_count;
+}
+
+void RenderBackendNull::SetPipeline(render_backend_pipeline_t *)
+{
+	++m_statistics.set_pipeline_count;
+}
+
+void RenderBackendNull::SetVertexBuffers(uint32_t, uint32_t buffer_count, render_backend_buffer_t *const *, uint32_t const *)
+{
+	m_statistics.set_vertex_buffer_count += buffer_count;
+}
+
+void RenderBackendNull::SetConstantBuffer(uint32_t, render_backend_buffer_t *)
+{
+	++m_statistics.set_constant_buffer_count;
+}
+
+void RenderBackendNull::SetTexture(uint32_t, render_backend_texture_t *)
+{
+	++m_statistics.set_texture_count;
+}
+
+void RenderBackendNull::SetSampler(uint32_t, render_backend_sampler_t *)
+{
+	++m_statistics.set_sampler_count;
+}
+
+void RenderBackendNull::Draw(uint32_t vertex_count)
+{
+	++m_statistics.draw_count;
+	m_statistics.vertex_count += vertex_count;
+}
+
+void RenderBackendNull::Present()
+{
+	++m_statistics.present_count;
+}
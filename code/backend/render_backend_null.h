@@ -0,0 +1,95 @@
+#ifndef _BACKEND_RENDER_BACKEND_NULL_H_
+#define _BACKEND_RENDER_BACKEND_NULL_H_ 1
+
+//
+// Executes nothing, only records the command counts and the byte volumes.
+// Used to measure the CPU overhead of the "Demo" itself (see "support/headless_main.h").
+//
+
+#include <stdint.h>
+
+#include "render_backend.h"
+
+struct render_backend_null_statistics_t
+{
+	// resources
+	uint32_t buffer_count;
+	uint32_t texture_count;
+	uint32_t sampler_count;
+	uint32_t pipeline_count;
+	// the initial data of the buffers and the textures
+	uint64_t create_byte_count;
+	// the size of all the constant buffers, which would be uploaded per frame without the dirty tracking
+	uint32_t constant_buffer_byte_count;
+
+	// commands
+	uint64_t update_buffer_count;
+	uint64_t update_buffer_byte_count;
+	uint64_t pass_count;
+	uint64_t barrier_count;
+	uint64_t set_pipeline_count;
+	uint64_t set_vertex_buffer_count;
+	uint64_t set_constant_buffer_count;
+	uint64_t set_texture_count;
+	uint64_t set_sampler_count;
+	uint64_t draw_count;
+	uint64_t vertex_count;
+	uint64_t present_count;
+	uint64_t resize_count;
+};
+
+class RenderBackendNull : public RenderBackend
+{
+	uint32_t m_backbuffer_width;
+	uint32_t m_backbuffer_height;
+
+	// the handles other than the buffers
+	uintptr_t m_handle_count;
+
+	render_backend_null_statistics_t m_statistics;
+
+public:
+	void Init(uint32_t width, uint32_t height);
+
+	// The statistics are cumulative since the "Init".
+	render_backend_null_statistics_t const &GetStatistics() const;
+
+	char const *GetName() const;
+
+	uint32_t GetBackbufferWidth() const;
+	uint32_t GetBackbufferHeight() const;
+
+	float GetGPUFrameTime() const;
+
+	void ResizeBackbuffer(uint32_t width, uint32_t height);
+
+	render_backend_buffer_t *CreateBuffer(RENDER_BACKEND_BUFFER_USAGE usage, uint32_t size, void const *data);
+	void DestroyBuffer(render_backend_buffer_t *buffer);
+
+	render_backend_texture_t *CreateTexture(render_backend_texture_desc_t const &desc, render_backend_subresource_data_t const *subresource_data);
+	void DestroyTexture(render_backend_texture_t *texture);
+
+	render_backend_sampler_t *CreateSampler(RENDER_BACKEND_FILTER filter);
+	void DestroySampler(render_backend_sampler_t *sampler);
+
+	render_backend_pipeline_t *CreatePipeline(render_backend_pipeline_desc_t const &desc);
+	void DestroyPipeline(render_backend_pipeline_t *pipeline);
+
+	void UpdateBuffer(render_backend_buffer_t *buffer, void const *data, uint32_t size);
+
+	void BeginPass(render_backend_pass_desc_t const &desc);
+	void EndPass();
+
+	void Barrier(render_backend_texture_t *texture, RENDER_BACKEND_TEXTURE_STATE before, RENDER_BACKEND_TEXTURE_STATE after);
+
+	void SetPipeline(render_backend_pipeline_t *pipeline);
+	void SetVertexBuffers(uint32_t first_slot, uint32_t buffer_count, render_backend_buffer_t *const *buffers, uint32_t const *strides);
+	void SetConstantBuffer(uint32_t slot, render_backend_buffer_t *buffer);
+	void SetTexture(uint32_t slot, render_backend_texture_t *texture);
+	void SetSampler(uint32_t slot, render_backend_sampler_t *sampler);
+	void Draw(uint32_t vertex_count);
+
+	void Present();
+};
+
+#endif
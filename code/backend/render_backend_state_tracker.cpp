@@ -0,0 +1,333 @@
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <vector>
+
+#include "render_backend.h"
+
+#include "render_backend_state_tracker.h"
+
+// the FNV-1a style hash of the fields, each field is mixed as the 32-bit word rather than byte by byte (the "bool" members leave the padding in the struct, such that the struct is NOT hashed as the bytes)
+static inline uint32_t render_backend_state_tracker_pipeline_hash(render_backend_pipeline_desc_t const &desc);
+
+static inline bool render_backend_state_tracker_pipeline_desc_equal(render_backend_pipeline_desc_t const &a, render_backend_pipeline_desc_t const &b);
+
+void RenderBackendStateTracker::Init(RenderBackend *render_backend)
+{
+	m_render_backend = render_backend;
+
+	m_pipeline = NULL;
+	for (uint32_t slot = 0U; slot < RENDER_BACKEND_STATE_TRACKER_VERTEX_BUFFER_SLOT_COUNT; ++slot)
+	{
+		m_vertex_buffers[slot] = NULL;
+		m_vertex_buffer_strides[slot] = 0U;
+	}
+	for (uint32_t slot = 0U; slot < RENDER_BACKEND_STATE_TRACKER_CONSTANT_BUFFER_SLOT_COUNT; ++slot)
+	{
+		m_constant_buffers[slot] = NULL;
+	}
+	for (uint32_t slot = 0U; slot < RENDER_BACKEND_STATE_TRACKER_TEXTURE_SLOT_COUNT; ++slot)
+	{
+		m_textures[slot] = NULL;
+	}
+	for (uint32_t slot = 0U; slot < RENDER_BACKEND_STATE_TRACKER_SAMPLER_SLOT_COUNT; ++slot)
+	{
+		m_samplers[slot] = NULL;
+	}
+
+	memset(&m_statistics, 0, sizeof(render_backend_state_tracker_statistics_t));
+}
+
+void RenderBackendStateTracker::Destroy()
+{
+	// all the pipelines should have been destroyed by the caller
+	assert(m_pipeline_cache.empty());
+	m_pipeline_cache.clear();
+}
+
+render_backend_state_tracker_statistics_t const &RenderBackendStateTracker::GetStatistics() const
+{
+	return m_statistics;
+}
+
+char const *RenderBackendStateTracker::GetName() const
+{
+	return m_render_backend->GetName();
+}
+
+uint32_t RenderBackendStateTracker::GetBackbufferWidth() const
+{
+	return m_render_backend->GetBackbufferWidth();
+}
+
+uint32_t RenderBackendStateTracker::GetBackbufferHeight() const
+{
+	return m_render_backend->GetBackbufferHeight();
+}
+
+float RenderBackendStateTracker::GetGPUFrameTime() const
+{
+	return m_render_backend->GetGPUFrameTime();
+}
+
+void RenderBackendStateTracker::ResizeBackbuffer(uint32_t width, uint32_t height)
+{
+	// the backbuffer is NOT tracked (the attachments are set by each pass)
+	m_render_backend->ResizeBackbuffer(width, height);
+}
+
+render_backend_buffer_t *RenderBackendStateTracker::CreateBuffer(RENDER_BACKEND_BUFFER_USAGE usage, uint32_t size, void const *data)
+{
+	return m_render_backend->CreateBuffer(usage, size, data);
+}
+
+void RenderBackendStateTracker::DestroyBuffer(render_backend_buffer_t *buffer)
+{
+	// the new buffer may be allocated at the same address
+	for (uint32_t slot = 0U; slot < RENDER_BACKEND_STATE_TRACKER_VERTEX_BUFFER_SLOT_COUNT; ++slot)
+	{
+		m_vertex_buffers[slot] = (buffer != m_vertex_buffers[slot]) ? m_vertex_buffers[slot] : NULL;
+	}
+	for (uint32_t slot = 0U; slot < RENDER_BACKEND_STATE_TRACKER_CONSTANT_BUFFER_SLOT_COUNT; ++slot)
+	{
+		m_constant_buffers[slot] = (buffer != m_constant_buffers[slot]) ? m_constant_buffers[slot] : NULL;
+	}
+
+	m_render_backend->DestroyBuffer(buffer);
+}
+
+render_backend_texture_t *RenderBackendStateTracker::CreateTexture(render_backend_texture_desc_t const &desc, render_backend_subresource_data_t const *subresource_data)
+{
+	return m_render_backend->CreateTexture(desc, subresource_data);
+}
+
+void RenderBackendStateTracker::DestroyTexture(render_backend_texture_t *texture)
+{
+	for (uint32_t slot = 0U; slot < RENDER_BACKEND_STATE_TRACKER_TEXTURE_SLOT_COUNT; ++slot)
+	{
+		m_textures[slot] = (texture != m_textures[slot]) ? m_textures[slot] : NULL;
+	}
+
+	m_render_backend->DestroyTexture(texture);
+}
+
+render_backend_sampler_t *RenderBackendStateTracker::CreateSampler(RENDER_BACKEND_FILTER filter)
+{
+	return m_render_backend->CreateSampler(filter);
+}
+
+void RenderBackendStateTracker::DestroySampler(render_backend_sampler_t *sampler)
+{
+	for (uint32_t slot = 0U; slot < RENDER_BACKEND_STATE_TRACKER_SAMPLER_SLOT_COUNT; ++slot)
+	{
+		m_samplers[slot] = (sampler != m_samplers[slot]) ? m_samplers[slot] : NULL;
+	}
+
+	m_render_backend->DestroySampler(sampler);
+}
+
+render_backend_pipeline_t *RenderBackendStateTracker::CreatePipeline(render_backend_pipeline_desc_t const &desc)
+{
+	uint32_t const hash = render_backend_state_tracker_pipeline_hash(desc);
+
+	for (size_t entry_index = 0U; entry_index < m_pipeline_cache.size(); ++entry_index)
+	{
+		pipeline_cache_entry_t &entry = m_pipeline_cache[entry_index];
+		if (hash == entry.hash && render_backend_state_tracker_pipeline_desc_equal(desc, entry.desc))
+		{
+			++entry.reference_count;
+			++m_statistics.pipeline_cache_hit_count;
+			return entry.pipeline;
+		}
+	}
+
+	pipeline_cache_entry_t entry;
+	entry.hash = hash;
+	entry.desc = desc;
+	entry.pipeline = m_render_backend->CreatePipeline(desc);
+	entry.reference_count = 1U;
+	m_pipeline_cache.push_back(entry);
+	++m_statistics.pipeline_count;
+
+	return entry.pipeline;
+}
+
+void RenderBackendStateTracker::DestroyPipeline(render_backend_pipeline_t *pipeline)
+{
+	for (size_t entry_index = 0U; entry_index < m_pipeline_cache.size(); ++entry_index)
+	{
+		pipeline_cache_entry_t &entry = m_pipeline_cache[entry_index];
+		if (pipeline == entry.pipeline)
+		{
+			assert(entry.reference_count > 0U);
+			--entry.reference_count;
+			if (0U == entry.reference_count)
+			{
+				m_pipeline = (pipeline != m_pipeline) ? m_pipeline : NULL;
+				m_render_backend->DestroyPipeline(pipeline);
+
+				m_pipeline_cache[entry_index] = m_pipeline_cache.back();
+				m_pipeline_cache.pop_back();
+				assert(m_statistics.pipeline_count > 0U);
+				--m_statistics.pipeline_count;
+			}
+			return;
+		}
+	}
+
+	// NOT created by the tracker
+	assert(false);
+}
+
+void RenderBackendStateTracker::UpdateBuffer(render_backend_buffer_t *buffer, void const *data, uint32_t size)
+{
+	m_render_backend->UpdateBuffer(buffer, data, size);
+}
+
+void RenderBackendStateTracker::BeginPass(render_backend_pass_desc_t const &desc)
+{
+	m_render_backend->BeginPass(desc);
+}
+
+void RenderBackendStateTracker::EndPass()
+{
+	m_render_backend->EndPass();
+}
+
+void RenderBackendStateTracker::Barrier(render_backend_texture_t *texture, RENDER_BACKEND_TEXTURE_STATE before, RENDER_BACKEND_TEXTURE_STATE after)
+{
+	// the backend unbinds the sampled texture
+	if (RENDER_BACKEND_TEXTURE_STATE_SAMPLED == before)
+	{
+		for (uint32_t slot = 0U; slot < RENDER_BACKEND_STATE_TRACKER_TEXTURE_SLOT_COUNT; ++slot)
+		{
+			m_textures[slot] = (texture != m_textures[slot]) ? m_textures[slot] : NULL;
+		}
+	}
+
+	m_render_backend->Barrier(texture, before, after);
+}
+
+void RenderBackendStateTracker::SetPipeline(render_backend_pipeline_t *pipeline)
+{
+	++m_statistics.set_pipeline_count;
+
+	if (pipeline == m_pipeline)
+	{
+		++m_statistics.elided_set_pipeline_count;
+		return;
+	}
+
+	m_pipeline = pipeline;
+	m_render_backend->SetPipeline(pipeline);
+}
+
+void RenderBackendStateTracker::SetVertexBuffers(uint32_t first_slot, uint32_t buffer_count, render_backend_buffer_t *const *buffers, uint32_t const *strides)
+{
+	++m_statistics.set_vertex_buffer_count;
+
+	if ((first_slot + buffer_count) > RENDER_BACKEND_STATE_TRACKER_VERTEX_BUFFER_SLOT_COUNT)
+	{
+		m_render_backend->SetVertexBuffers(first_slot, buffer_count, buffers, strides);
+		return;
+	}
+
+	bool redundant = true;
+	for (uint32_t buffer_index = 0U; buffer_index < buffer_count; ++buffer_index)
+	{
+		uint32_t const slot = first_slot + buffer_index;
+		redundant = redundant && (buffers[buffer_index] == m_vertex_buffers[slot]) && (strides[buffer_index] == m_vertex_buffer_strides[slot]);
+		m_vertex_buffers[slot] = buffers[buffer_index];
+		m_vertex_buffer_strides[slot] = strides[buffer_index];
+	}
+
+	if (redundant)
+	{
+		++m_statistics.elided_set_vertex_buffer_count;
+		return;
+	}
+
+	m_render_backend->SetVertexBuffers(first_slot, buffer_count, buffers, strides);
+}
+
+void RenderBackendStateTracker::SetConstantBuffer(uint32_t slot, render_backend_buffer_t *buffer)
+{
+	++m_statistics.set_constant_buffer_count;
+
+	if (slot < RENDER_BACKEND_STATE_TRACKER_CONSTANT_BUFFER_SLOT_COUNT)
+	{
+		if (buffer == m_constant_buffers[slot])
+		{
+			++m_statistics.elided_set_constant_buffer_count;
+			return;
+		}
+		m_constant_buffers[slot] = buffer;
+	}
+
+	m_render_backend->SetConstantBuffer(slot, buffer);
+}
+
+void RenderBackendStateTracker::SetTexture(uint32_t slot, render_backend_texture_t *texture)
+{
+	++m_statistics.set_texture_count;
+
+	if (slot < RENDER_BACKEND_STATE_TRACKER_TEXTURE_SLOT_COUNT)
+	{
+		if (texture == m_textures[slot])
+		{
+			++m_statistics.elided_set_texture_count;
+			return;
+		}
+		m_textures[slot] = texture;
+	}
+
+	m_render_backend->SetTexture(slot, texture);
+}
+
+void RenderBackendStateTracker::SetSampler(uint32_t slot, render_backend_sampler_t *sampler)
+{
+	++m_statistics.set_sampler_count;
+
+	if (slot < RENDER_BACKEND_STATE_TRACKER_SAMPLER_SLOT_COUNT)
+	{
+		if (sampler == m_samplers[slot])
+		{
+			++m_statistics.elided_set_sampler_count;
+			return;
+		}
+		m_samplers[slot] = sampler;
+	}
+
+	m_render_backend->SetSampler(slot, sampler);
+}
+
+void RenderBackendStateTracker::Draw(uint32_t vertex_count)
+{
+	m_render_backend->Draw(vertex_count);
+}
+
+void RenderBackendStateTracker::Present()
+{
+	m_render_backend->Present();
+}
+
+static inline uint32_t render_backend_state_tracker_pipeline_hash(render_backend_pipeline_desc_t const &desc)
+{
+	uint32_t const fields[4] = {
+		static_cast<uint32_t>(desc.program),
+		desc.permutation,
+		desc.front_counter_clockwise ? 1U : 0U,
+		static_cast<uint32_t>(desc.depth_test)};
+
+	uint32_t hash = 2166136261U;
+	for (int field_index = 0; field_index < 4; ++field_index)
+	{
+		hash = (hash ^ fields[field_index]) * 16777619U;
+	}
+	return hash;
+}
+
+static inline bool render_backend_state_tracker_pipeline_desc_equal(render_backend_pipeline_desc_t const &a, render_backend_pipeline_desc_t const &b)
+{
+	return a.program == b.program && a.permutation == b.permutation && a.front_counter_clockwise == b.front_counter_clockwise && a.depth_test == b.depth_test;
+}
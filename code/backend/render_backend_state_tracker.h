@@ -0,0 +1,116 @@
+#ifndef _BACKEND_RENDER_BACKEND_STATE_TRACKER_H_
+#define _BACKEND_RENDER_BACKEND_STATE_TRACKER_H_ 1
+
+//
+// The layer between the "Demo" and any backend, which forwards the commands except the redundant ones.
+//
+// Pipelines: the pipelines of the same desc are deduplicated by the hashed cache (the same handle is returned, reference counted),
+//            such that the "SetPipeline" of the identical state is elided as well.
+// Bindings: the "SetPipeline", "SetVertexBuffers", "SetConstantBuffer", "SetTexture" and "SetSampler" of the currently bound object are elided.
+//           The bindings persist across the passes (see "RenderBackend::BeginPass"),
+//           the texture transitioned from the "SAMPLED" by the "Barrier" and the destroyed objects are forgotten.
+//
+// The sub-states shared by the different pipelines (e.g. the shaders) are deduplicated by the backend itself (see "render_backend_d3d11.h").
+//
+
+#include <stdint.h>
+#include <vector>
+
+#include "render_backend.h"
+
+#define RENDER_BACKEND_STATE_TRACKER_VERTEX_BUFFER_SLOT_COUNT 2U
+#define RENDER_BACKEND_STATE_TRACKER_CONSTANT_BUFFER_SLOT_COUNT 8U
+#define RENDER_BACKEND_STATE_TRACKER_TEXTURE_SLOT_COUNT 8U
+#define RENDER_BACKEND_STATE_TRACKER_SAMPLER_SLOT_COUNT 8U
+
+struct render_backend_state_tracker_statistics_t
+{
+	// the pipelines created by the backend
+	uint32_t pipeline_count;
+	// the "CreatePipeline" which returned the existing pipeline
+	uint64_t pipeline_cache_hit_count;
+
+	// the commands issued by the caller, and the ones NOT forwarded to the backend
+	uint64_t set_pipeline_count;
+	uint64_t elided_set_pipeline_count;
+	uint64_t set_vertex_buffer_count;
+	uint64_t elided_set_vertex_buffer_count;
+	uint64_t set_constant_buffer_count;
+	uint64_t elided_set_constant_buffer_count;
+	uint64_t set_texture_count;
+	uint64_t elided_set_texture_count;
+	uint64_t set_sampler_count;
+	uint64_t elided_set_sampler_count;
+};
+
+class RenderBackendStateTracker : public RenderBackend
+{
+	struct pipeline_cache_entry_t
+	{
+		uint32_t hash;
+		render_backend_pipeline_desc_t desc;
+		render_backend_pipeline_t *pipeline;
+		uint32_t reference_count;
+	};
+
+	RenderBackend *m_render_backend;
+
+	std::vector<pipeline_cache_entry_t> m_pipeline_cache;
+
+	// the bindings of the backend (NULL: unknown)
+	render_backend_pipeline_t *m_pipeline;
+	render_backend_buffer_t *m_vertex_buffers[RENDER_BACKEND_STATE_TRACKER_VERTEX_BUFFER_SLOT_COUNT];
+	uint32_t m_vertex_buffer_strides[RENDER_BACKEND_STATE_TRACKER_VERTEX_BUFFER_SLOT_COUNT];
+	render_backend_buffer_t *m_constant_buffers[RENDER_BACKEND_STATE_TRACKER_CONSTANT_BUFFER_SLOT_COUNT];
+	render_backend_texture_t *m_textures[RENDER_BACKEND_STATE_TRACKER_TEXTURE_SLOT_COUNT];
+	render_backend_sampler_t *m_samplers[RENDER_BACKEND_STATE_TRACKER_SAMPLER_SLOT_COUNT];
+
+	render_backend_state_tracker_statistics_t m_statistics;
+
+public:
+	// [in] render_backend: owned by the caller
+	void Init(RenderBackend *render_backend);
+	void Destroy();
+
+	// The statistics are cumulative since the "Init".
+	render_backend_state_tracker_statistics_t const &GetStatistics() const;
+
+	char const *GetName() const;
+
+	uint32_t GetBackbufferWidth() const;
+	uint32_t GetBackbufferHeight() const;
+
+	float GetGPUFrameTime() const;
+
+	void ResizeBackbuffer(uint32_t width, uint32_t height);
+
+	render_backend_buffer_t *CreateBuffer(RENDER_BACKEND_BUFFER_USAGE usage, uint32_t size, void const *data);
+	void DestroyBuffer(render_backend_buffer_t *buffer);
+
+	render_backend_texture_t *CreateTexture(render_backend_texture_desc_t const &desc, render_backend_subresource_data_t const *subresource_data);
+	void DestroyTexture(render_backend_texture_t *texture);
+
+	render_backend_sampler_t *CreateSampler(RENDER_BACKEND_FILTER filter);
+	void DestroySampler(render_backend_sampler_t *sampler);
+
+	render_backend_pipeline_t *CreatePipeline(render_backend_pipeline_desc_t const &desc);
+	void DestroyPipeline(render_backend_pipeline_t *pipeline);
+
+	void UpdateBuffer(render_backend_buffer_t *buffer, void const *data, uint32_t size);
+
+	void BeginPass(render_backend_pass_desc_t const &desc);
+	void EndPass();
+
+	void Barrier(render_backend_texture_t *texture, RENDER_BACKEND_TEXTURE_STATE before, RENDER_BACKEND_TEXTURE_STATE after);
+
+	void SetPipeline(render_backend_pipeline_t *pipeline);
+	void SetVertexBuffers(uint32_t first_slot, uint32_t buffer_count, render_backend_buffer_t *const *buffers, uint32_t const *strides);
+	void SetConstantBuffer(uint32_t slot, render_backend_buffer_t *buffer);
+	void SetTexture(uint32_t slot, render_backend_texture_t *texture);
+	void SetSampler(uint32_t slot, render_backend_sampler_t *sampler);
+	void Draw(uint32_t vertex_count);
+
+	void Present();
+};
+
+#endif
@@ -0,0 +1,156 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <assert.h>
+#include <cmath>
+#include <algorithm>
+#include <vector>
+#include <xmmintrin.h>
+#include <emmintrin.h>
+
+#include "simd.h"
+#include "thread_pool.h"
+#include "auto_exposure.h"
+
+void AutoExposureHistogram::Init(uint32_t thread_count)
+{
+	// 4 lanes of "AUTO_EXPOSURE_HISTOGRAM_BIN_COUNT + 1" bins, rounded up to and padded by the cache line (64 bytes), such that the threads never write the same line
+	m_thread_count = std::max(thread_count, 1U);
+	m_thread_stride = ((4U * (AUTO_EXPOSURE_HISTOGRAM_BIN_COUNT + 1U) + 15U) & (~15U)) + 16U;
+	m_thread_histograms.assign(static_cast<size_t>(m_thread_count) * m_thread_stride, 0U);
+	memset(m_histogram, 0, sizeof(m_histogram));
+}
+
+void AutoExposureHistogram::Destroy()
+{
+	m_thread_histograms.clear();
+}
+
+void AutoExposureHistogram::Build(ThreadPool *thread_pool, float const *hdr_color, uint32_t width, uint32_t height)
+{
+	assert(thread_pool->GetThreadCount() <= m_thread_count);
+
+	memset(&m_thread_histograms[0], 0, sizeof(uint32_t) * m_thread_histograms.size());
+
+	uint32_t *const thread_histograms = &m_thread_histograms[0];
+	uint32_t const thread_stride = m_thread_stride;
+
+	thread_pool->ParallelFor(height, 8U, [=](uint32_t begin, uint32_t end, uint32_t thread_index) {
+		uint32_t *const lane_histograms = thread_histograms + static_cast<size_t>(thread_stride) * thread_index;
+
+		simd_float const bin_scale = simd_float(static_cast<float>(AUTO_EXPOSURE_HISTOGRAM_BIN_COUNT) / (AUTO_EXPOSURE_LOG2_MAX - AUTO_EXPOSURE_LOG2_MIN));
+		simd_float const last_bin = simd_float(static_cast<float>(AUTO_EXPOSURE_HISTOGRAM_BIN_COUNT - 1U));
+		simd_float const luminance_min = simd_float(std::exp2(AUTO_EXPOSURE_LOG2_MIN));
+		// the lane "i" counts into the bins "(AUTO_EXPOSURE_HISTOGRAM_BIN_COUNT + 1) * i"
+		__m128i const lane_offset = _mm_set_epi32(static_cast<int>(3U * (AUTO_EXPOSURE_HISTOGRAM_BIN_COUNT + 1U)), static_cast<int>(2U * (AUTO_EXPOSURE_HISTOGRAM_BIN_COUNT + 1U)), static_cast<int>(AUTO_EXPOSURE_HISTOGRAM_BIN_COUNT + 1U), 0);
+
+		for (uint32_t y = begin; y < end; ++y)
+		{
+			float const *const row = hdr_color + static_cast<size_t>(width) * y * 4U;
+
+			uint32_t x = 0U;
+			for (; (x + 4U) <= width; x += 4U)
+			{
+				__m128 r = _mm_loadu_ps(row + 4U * x + 0U);
+				__m128 g = _mm_loadu_ps(row + 4U * x + 4U);
+				__m128 b = _mm_loadu_ps(row + 4U * x + 8U);
+				__m128 a = _mm_loadu_ps(row + 4U * x + 12U);
+				_MM_TRANSPOSE4_PS(r, g, b, a);
+
+				// Rec. 709
+				simd_float const luminance = simd_float(0.2126f) * simd_float(r) + simd_float(0.7152f) * simd_float(g) + simd_float(0.0722f) * simd_float(b);
+
+				// the NaN is NOT counted either (the comparison is false)
+				simd_float const counted = (luminance >= luminance_min);
+				simd_float const bin = min((log2(max(luminance, luminance_min)) - simd_float(AUTO_EXPOSURE_LOG2_MIN)) * bin_scale, last_bin);
+				__m128i const bin_index = _mm_cvttps_epi32(select(counted, bin, simd_float(static_cast<float>(AUTO_EXPOSURE_HISTOGRAM_BIN_COUNT))).v);
+
+				uint32_t bin_indices[4];
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(bin_indices), _mm_add_epi32(bin_index, lane_offset));
+				++lane_histograms[bin_indices[0]];
+				++lane_histograms[bin_indices[1]];
+				++lane_histograms[bin_indices[2]];
+				++lane_histograms[bin_indices[3]];
+			}
+
+			// the last pixels (fewer than 4)
+			for (; x < width; ++x)
+			{
+				float const *const texel = row + 4U * x;
+				float const luminance = 0.2126f * texel[0] + 0.7152f * texel[1] + 0.0722f * texel[2];
+				if (luminance >= std::exp2(AUTO_EXPOSURE_LOG2_MIN))
+				{
+					float const bin = (std::log2(luminance) - AUTO_EXPOSURE_LOG2_MIN) * (static_cast<float>(AUTO_EXPOSURE_HISTOGRAM_BIN_COUNT) / (AUTO_EXPOSURE_LOG2_MAX - AUTO_EXPOSURE_LOG2_MIN));
+					++lane_histograms[std::min(static_cast<uint32_t>(bin), AUTO_EXPOSURE_HISTOGRAM_BIN_COUNT - 1U)];
+				}
+			}
+		}
+	});
+
+	// the merge of the lanes of all threads (the pixels out of the range are dropped)
+	for (uint32_t bin_index = 0U; bin_index < AUTO_EXPOSURE_HISTOGRAM_BIN_COUNT; ++bin_index)
+	{
+		uint32_t count = 0U;
+		for (uint32_t thread_index = 0U; thread_index < m_thread_count; ++thread_index)
+		{
+			uint32_t const *const lane_histograms = thread_histograms + static_cast<size_t>(thread_stride) * thread_index;
+			for (uint32_t lane_index = 0U; lane_index < 4U; ++lane_index)
+			{
+				count += lane_histograms[(AUTO_EXPOSURE_HISTOGRAM_BIN_COUNT + 1U) * lane_index + bin_index];
+			}
+		}
+		m_histogram[bin_index] = count;
+	}
+}
+
+uint32_t const *AutoExposureHistogram::GetHistogram() const
+{
+	return m_histogram;
+}
+
+float AutoExposureAdapt(float const *histogram, float previous_log2_luminance, bool previous_valid)
+{
+	float total_count = 0.0f;
+	for (uint32_t bin_index = 0U; bin_index < AUTO_EXPOSURE_HISTOGRAM_BIN_COUNT; ++bin_index)
+	{
+		total_count += histogram[bin_index];
+	}
+
+	// nothing to meter (e.g. the camera looks away from the plane)
+	if (!(total_count > 0.0f))
+	{
+		return previous_valid ? previous_log2_luminance : std::log2(AUTO_EXPOSURE_KEY);
+	}
+
+	// the part of each bin within the percentiles, weighted by the center of the bin
+	float const window_begin = total_count * AUTO_EXPOSURE_LOW_PERCENTILE;
+	float const window_end = total_count * AUTO_EXPOSURE_HIGH_PERCENTILE;
+	float cumulative_count = 0.0f;
+	float window_count = 0.0f;
+	float window_log2_luminance = 0.0f;
+	for (uint32_t bin_index = 0U; bin_index < AUTO_EXPOSURE_HISTOGRAM_BIN_COUNT; ++bin_index)
+	{
+		float const bin_begin = cumulative_count;
+		cumulative_count += histogram[bin_index];
+		float const count = std::max(std::min(cumulative_count, window_end) - std::max(bin_begin, window_begin), 0.0f);
+
+		float const bin_log2_luminance = AUTO_EXPOSURE_LOG2_MIN + (static_cast<float>(bin_index) + 0.5f) * ((AUTO_EXPOSURE_LOG2_MAX - AUTO_EXPOSURE_LOG2_MIN) / static_cast<float>(AUTO_EXPOSURE_HISTOGRAM_BIN_COUNT));
+		window_count += count;
+		window_log2_luminance += count * bin_log2_luminance;
+	}
+
+	float const average_log2_luminance = window_log2_luminance / window_count;
+	if (!previous_valid)
+	{
+		return average_log2_luminance;
+	}
+
+	float const adaptation = (average_log2_luminance > previous_log2_luminance) ? AUTO_EXPOSURE_ADAPTATION_BRIGHTER : AUTO_EXPOSURE_ADAPTATION_DARKER;
+	return previous_log2_luminance + (average_log2_luminance - previous_log2_luminance) * adaptation;
+}
+
+float AutoExposureFromLuminance(float adapted_log2_luminance)
+{
+	float const log2_exposure = std::log2(AUTO_EXPOSURE_KEY) - adapted_log2_luminance;
+	return std::exp2(std::min(std::max(log2_exposure, AUTO_EXPOSURE_LOG2_EXPOSURE_MIN), AUTO_EXPOSURE_LOG2_EXPOSURE_MAX));
+}
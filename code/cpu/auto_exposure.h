@@ -0,0 +1,70 @@
+#ifndef _CPU_AUTO_EXPOSURE_H_
+#define _CPU_AUTO_EXPOSURE_H_ 1
+
+//
+// The exposure of the post process, adapted to the histogram of the log2 luminance of the HDR color (the HDR color is multiplied by the exposure before the "aces_fitted").
+//
+// The bins cover [AUTO_EXPOSURE_LOG2_MIN, AUTO_EXPOSURE_LOG2_MAX] uniformly, the pixels below the range (the background) are NOT counted, the pixels above are counted by the last bin.
+// The average log2 luminance is taken over the bins between the AUTO_EXPOSURE_LOW_PERCENTILE and the AUTO_EXPOSURE_HIGH_PERCENTILE of the counted pixels,
+// such that neither the dark corners nor the emitter itself drive the exposure.
+// The adapted luminance moves towards the average by the fraction per frame (the eye adapts faster to the brighter scene), and the exposure maps it to the AUTO_EXPOSURE_KEY.
+// [Reinhard 2002] Erik Reinhard, Michael Stark, Peter Shirley, James Ferwerda. "Photographic Tone Reproduction for Digital Images." SIGGRAPH 2002.
+//
+// The GPU counts the AUTO_EXPOSURE_TAP_GRID_SIZE^2 bilinear taps of the HDR color (see "shaders/auto_exposure_histogram_fs.hlsl"),
+// the CPU counts every pixel by the "AutoExposureHistogram", both feed the same "AutoExposureAdapt" (see "shaders/auto_exposure_fs.hlsl").
+//
+
+#include <stdint.h>
+#include <vector>
+
+static const uint32_t AUTO_EXPOSURE_HISTOGRAM_BIN_COUNT = 64U;
+// the same range as the tonemap LUT (see "tonemap_lut.h"), a quarter of the stop per bin
+static const float AUTO_EXPOSURE_LOG2_MIN = -10.0F;
+static const float AUTO_EXPOSURE_LOG2_MAX = 6.0F;
+
+static const float AUTO_EXPOSURE_LOW_PERCENTILE = 0.5F;
+static const float AUTO_EXPOSURE_HIGH_PERCENTILE = 0.95F;
+// the adapted luminance which is mapped to the exposure 1 (the look of the fixed "intensity" of the light set before the auto exposure)
+static const float AUTO_EXPOSURE_KEY = 1.0F;
+// the exposure is clamped to [2^-6, 2^6]
+static const float AUTO_EXPOSURE_LOG2_EXPOSURE_MIN = -6.0F;
+static const float AUTO_EXPOSURE_LOG2_EXPOSURE_MAX = 6.0F;
+// the fraction of the log2 distance to the average closed per frame
+static const float AUTO_EXPOSURE_ADAPTATION_BRIGHTER = 0.1F;
+static const float AUTO_EXPOSURE_ADAPTATION_DARKER = 0.05F;
+
+// GPU: the texel (bin, group) of the histogram counts the taps of the "AUTO_EXPOSURE_TAP_GRID_SIZE / AUTO_EXPOSURE_HISTOGRAM_GROUP_COUNT" rows of the grid
+static const uint32_t AUTO_EXPOSURE_TAP_GRID_SIZE = 64U;
+static const uint32_t AUTO_EXPOSURE_HISTOGRAM_GROUP_COUNT = 16U;
+
+class AutoExposureHistogram
+{
+	// the 4 lanes of each thread count into their own histograms (the neighboring pixels mostly fall into the same bin, which would serialize the increments),
+	// the extra bin of each lane counts the pixels out of the range
+	uint32_t m_thread_count;
+	uint32_t m_thread_stride;
+	std::vector<uint32_t> m_thread_histograms;
+	uint32_t m_histogram[AUTO_EXPOSURE_HISTOGRAM_BIN_COUNT];
+
+public:
+	// [in] thread_count: the "GetThreadCount" of the thread pool passed to the "Build"
+	void Init(uint32_t thread_count);
+	void Destroy();
+
+	// The rows are counted in parallel, each thread into its own histograms, which are merged after the join (neither the lock nor the atomic).
+	// [in] hdr_color: RGBA32F
+	void Build(class ThreadPool *thread_pool, float const *hdr_color, uint32_t width, uint32_t height);
+
+	uint32_t const *GetHistogram() const;
+};
+
+// [in] histogram: the counts of the AUTO_EXPOSURE_HISTOGRAM_BIN_COUNT bins
+// [in] previous_log2_luminance: the adapted luminance of the previous frame
+// [in] previous_valid: false means the first frame, the adapted luminance is the average (no adaptation)
+// [return] the adapted log2 luminance (the previous one if no pixel is counted)
+float AutoExposureAdapt(float const *histogram, float previous_log2_luminance, bool previous_valid);
+
+// the exposure of the adapted log2 luminance
+float AutoExposureFromLuminance(float adapted_log2_luminance);
+
+#endif
@@ -0,0 +1,482 @@
+#include <stdint.h>
+#include <assert.h>
+#include <cmath>
+#include <algorithm>
+#include <vector>
+
+#include "simd.h"
+#include "frame_arena.h"
+
+#include "bvh.h"
+
+// binned SAH [Wald 2007] [Ingo Wald. "On fast Construction of SAH-based Bounding Volume Hierarchies." RT 2007.]
+static const uint32_t g_bvh_bin_count = 12U;
+static const uint32_t g_bvh_max_leaf_triangle_count = 4U;
+// the leaf is forced to split beyond this count even if SAH prefers the leaf
+static const uint32_t g_bvh_max_sah_leaf_triangle_count = 16U;
+static const uint32_t g_bvh_max_stack_size = 64U;
+
+struct bvh_aabb_t
+{
+	float min[3];
+	float max[3];
+};
+
+static inline void bvh_aabb_reset(bvh_aabb_t &aabb);
+static inline void bvh_aabb_grow(bvh_aabb_t &aabb, float const *point);
+static inline void bvh_aabb_grow(bvh_aabb_t &aabb, bvh_aabb_t const &other);
+static inline float bvh_aabb_half_area(bvh_aabb_t const &aabb);
+
+// return: the mask of the lanes of which the ray hits the box, t_entry is the distance of the entry point
+static inline simd_float bvh_ray_aabb(float const *aabb_min, float const *aabb_max, simd_float3 origin, simd_float3 inverse_direction, simd_float t_min, simd_float t_max, simd_float &t_entry);
+
+// [Möller 1997] [Tomas Möller, Ben Trumbore. "Fast, Minimum Storage Ray/Triangle Intersection." JGT 1997.]
+static inline simd_float bvh_ray_triangle(float const *triangle, simd_float3 origin, simd_float3 direction, simd_float t_min, simd_float t_max, simd_float &t_hit);
+
+static inline simd_float bvh_and_not(simd_float a, simd_float b);
+
+void BVH::Build(float const *triangle_vertices, uint32_t triangle_count, FrameArena &scratch)
+{
+	m_nodes.clear();
+	m_triangles.clear();
+	m_triangle_indices.resize(triangle_count);
+	m_max_depth = 0U;
+
+	if (0U == triangle_count)
+	{
+		return;
+	}
+
+	// the capacity of the members is kept, such that rebuilding the same scene never allocates from the heap
+	bvh_aabb_t *const triangle_aabbs = scratch.Allocate<bvh_aabb_t>(triangle_count);
+	float *const triangle_centroids = scratch.Allocate<float>(static_cast<size_t>(3U) * triangle_count);
+	for (uint32_t triangle_index = 0U; triangle_index < triangle_count; ++triangle_index)
+	{
+		float const *triangle = triangle_vertices + static_cast<size_t>(9U) * triangle_index;
+		bvh_aabb_reset(triangle_aabbs[triangle_index]);
+		bvh_aabb_grow(triangle_aabbs[triangle_index], triangle + 0);
+		bvh_aabb_grow(triangle_aabbs[triangle_index], triangle + 3);
+		bvh_aabb_grow(triangle_aabbs[triangle_index], triangle + 6);
+
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			triangle_centroids[static_cast<size_t>(3U) * triangle_index + axis] = (triangle[axis] + triangle[3 + axis] + triangle[6 + axis]) * (1.0f / 3.0f);
+		}
+
+		m_triangle_indices[triangle_index] = triangle_index;
+	}
+
+	m_nodes.reserve(static_cast<size_t>(2U) * triangle_count);
+	{
+		node_t root;
+		root.left_or_first = 0U;
+		root.triangle_count = triangle_count;
+		m_nodes.push_back(root);
+	}
+
+	uint32_t stack_node_index[g_bvh_max_stack_size];
+	uint32_t stack_depth[g_bvh_max_stack_size];
+	uint32_t stack_size = 0U;
+	stack_node_index[stack_size] = 0U;
+	stack_depth[stack_size] = 1U;
+	++stack_size;
+
+	while (stack_size > 0U)
+	{
+		--stack_size;
+		uint32_t const node_index = stack_node_index[stack_size];
+		uint32_t const depth = stack_depth[stack_size];
+		m_max_depth = std::max(m_max_depth, depth);
+
+		uint32_t const first = m_nodes[node_index].left_or_first;
+		uint32_t const count = m_nodes[node_index].triangle_count;
+
+		bvh_aabb_t node_aabb;
+		bvh_aabb_t centroid_aabb;
+		bvh_aabb_reset(node_aabb);
+		bvh_aabb_reset(centroid_aabb);
+		for (uint32_t i = first; i < (first + count); ++i)
+		{
+			bvh_aabb_grow(node_aabb, triangle_aabbs[m_triangle_indices[i]]);
+			bvh_aabb_grow(centroid_aabb, &triangle_centroids[static_cast<size_t>(3U) * m_triangle_indices[i]]);
+		}
+
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			m_nodes[node_index].aabb_min[axis] = node_aabb.min[axis];
+			m_nodes[node_index].aabb_max[axis] = node_aabb.max[axis];
+		}
+
+		// The stack can hold at most one pending sibling per level
+		if (count <= g_bvh_max_leaf_triangle_count || (stack_size + 2U) > g_bvh_max_stack_size)
+		{
+			continue;
+		}
+
+		int split_axis = 0;
+		for (int axis = 1; axis < 3; ++axis)
+		{
+			if ((centroid_aabb.max[axis] - centroid_aabb.min[axis]) > (centroid_aabb.max[split_axis] - centroid_aabb.min[split_axis]))
+			{
+				split_axis = axis;
+			}
+		}
+
+		float const centroid_extent = centroid_aabb.max[split_axis] - centroid_aabb.min[split_axis];
+		if (!(centroid_extent > 0.0f))
+		{
+			// All centroids coincide
+			continue;
+		}
+
+		float const bin_scale = static_cast<float>(g_bvh_bin_count) / centroid_extent;
+
+		uint32_t bin_counts[g_bvh_bin_count];
+		bvh_aabb_t bin_aabbs[g_bvh_bin_count];
+		for (uint32_t bin_index = 0U; bin_index < g_bvh_bin_count; ++bin_index)
+		{
+			bin_counts[bin_index] = 0U;
+			bvh_aabb_reset(bin_aabbs[bin_index]);
+		}
+
+		for (uint32_t i = first; i < (first + count); ++i)
+		{
+			float centroid = triangle_centroids[static_cast<size_t>(3U) * m_triangle_indices[i] + split_axis];
+			uint32_t bin_index = std::min(static_cast<uint32_t>((centroid - centroid_aabb.min[split_axis]) * bin_scale), g_bvh_bin_count - 1U);
+			++bin_counts[bin_index];
+			bvh_aabb_grow(bin_aabbs[bin_index], triangle_aabbs[m_triangle_indices[i]]);
+		}
+
+		// Sweep from the right to get the cost of the right side of each split plane
+		float right_costs[g_bvh_bin_count];
+		{
+			bvh_aabb_t right_aabb;
+			bvh_aabb_reset(right_aabb);
+			uint32_t right_count = 0U;
+			for (uint32_t bin_index = (g_bvh_bin_count - 1U); bin_index > 0U; --bin_index)
+			{
+				bvh_aabb_grow(right_aabb, bin_aabbs[bin_index]);
+				right_count += bin_counts[bin_index];
+				right_costs[bin_index] = (right_count > 0U) ? (bvh_aabb_half_area(right_aabb) * static_cast<float>(right_count)) : 0.0f;
+			}
+		}
+
+		uint32_t best_split = 0U;
+		float best_cost = INFINITY;
+		{
+			bvh_aabb_t left_aabb;
+			bvh_aabb_reset(left_aabb);
+			uint32_t left_count = 0U;
+			for (uint32_t split = 1U; split < g_bvh_bin_count; ++split)
+			{
+				bvh_aabb_grow(left_aabb, bin_aabbs[split - 1U]);
+				left_count += bin_counts[split - 1U];
+				float cost = ((left_count > 0U) ? (bvh_aabb_half_area(left_aabb) * static_cast<float>(left_count)) : 0.0f) + right_costs[split];
+				if (left_count > 0U && left_count < count && cost < best_cost)
+				{
+					best_cost = cost;
+					best_split = split;
+				}
+			}
+		}
+
+		uint32_t left_count;
+		if (0U != best_split && (best_cost < (bvh_aabb_half_area(node_aabb) * static_cast<float>(count)) || count > g_bvh_max_sah_leaf_triangle_count))
+		{
+			uint32_t *middle = std::partition(&m_triangle_indices[first], &m_triangle_indices[first] + count, [&](uint32_t triangle_index) {
+				float centroid = triangle_centroids[static_cast<size_t>(3U) * triangle_index + split_axis];
+				uint32_t bin_index = std::min(static_cast<uint32_t>((centroid - centroid_aabb.min[split_axis]) * bin_scale), g_bvh_bin_count - 1U);
+				return (bin_index < best_split);
+			});
+			left_count = static_cast<uint32_t>(middle - &m_triangle_indices[first]);
+		}
+		else if (count > g_bvh_max_sah_leaf_triangle_count)
+		{
+			// median split
+			left_count = count / 2U;
+			std::nth_element(&m_triangle_indices[first], &m_triangle_indices[first] + left_count, &m_triangle_indices[first] + count, [&](uint32_t a, uint32_t b) {
+				return triangle_centroids[static_cast<size_t>(3U) * a + split_axis] < triangle_centroids[static_cast<size_t>(3U) * b + split_axis];
+			});
+		}
+		else
+		{
+			continue;
+		}
+
+		assert(left_count > 0U && left_count < count);
+
+		uint32_t const left_index = static_cast<uint32_t>(m_nodes.size());
+
+		node_t left;
+		left.left_or_first = first;
+		left.triangle_count = left_count;
+		m_nodes.push_back(left);
+
+		node_t right;
+		right.left_or_first = first + left_count;
+		right.triangle_count = count - left_count;
+		m_nodes.push_back(right);
+
+		m_nodes[node_index].left_or_first = left_index;
+		m_nodes[node_index].triangle_count = 0U;
+
+		stack_node_index[stack_size] = left_index + 1U;
+		stack_depth[stack_size] = depth + 1U;
+		++stack_size;
+		stack_node_index[stack_size] = left_index;
+		stack_depth[stack_size] = depth + 1U;
+		++stack_size;
+	}
+
+	m_triangles.resize(static_cast<size_t>(9U) * triangle_count);
+	for (uint32_t i = 0U; i < triangle_count; ++i)
+	{
+		std::copy(triangle_vertices + static_cast<size_t>(9U) * m_triangle_indices[i], triangle_vertices + static_cast<size_t>(9U) * (m_triangle_indices[i] + 1U), &m_triangles[static_cast<size_t>(9U) * i]);
+	}
+}
+
+simd_float BVH::Occluded(simd_float3 origin, simd_float3 direction, simd_float t_min, simd_float t_max, simd_float active_mask) const
+{
+	simd_float occluded = simd_float(0.0f) > simd_float(0.0f);
+
+	if (m_nodes.empty() || !any(active_mask))
+	{
+		return occluded;
+	}
+
+	simd_float3 const inverse_direction = simd_float3(simd_float(1.0f) / direction.x, simd_float(1.0f) / direction.y, simd_float(1.0f) / direction.z);
+
+	uint32_t stack[g_bvh_max_stack_size];
+	uint32_t stack_size = 0U;
+	stack[stack_size++] = 0U;
+
+	while (stack_size > 0U)
+	{
+		node_t const &node = m_nodes[stack[--stack_size]];
+
+		simd_float const pending = bvh_and_not(occluded, active_mask);
+
+		simd_float t_entry;
+		simd_float hit_aabb = bvh_ray_aabb(node.aabb_min, node.aabb_max, origin, inverse_direction, t_min, t_max, t_entry) & pending;
+		if (!any(hit_aabb))
+		{
+			continue;
+		}
+
+		if (0U != node.triangle_count)
+		{
+			for (uint32_t i = node.left_or_first; i < (node.left_or_first + node.triangle_count); ++i)
+			{
+				simd_float t_hit;
+				occluded = occluded | (bvh_ray_triangle(&m_triangles[static_cast<size_t>(9U) * i], origin, direction, t_min, t_max, t_hit) & hit_aabb);
+			}
+
+			// Any hit is enough for the shadow rays
+			if (!any(bvh_and_not(occluded, active_mask)))
+			{
+				break;
+			}
+		}
+		else
+		{
+			assert((stack_size + 2U) <= g_bvh_max_stack_size);
+			stack[stack_size++] = node.left_or_first + 1U;
+			stack[stack_size++] = node.left_or_first;
+		}
+	}
+
+	return occluded;
+}
+
+simd_float BVH::Intersect(simd_float3 origin, simd_float3 direction, simd_float t_min, simd_float t_max, simd_float active_mask, simd_float &t_hit, int32_t triangle_index[4], simd_float3 &geometric_normal) const
+{
+	simd_float hit = simd_float(0.0f) > simd_float(0.0f);
+	t_hit = t_max;
+	geometric_normal = simd_float3_broadcast(0.0f, 0.0f, 0.0f);
+	triangle_index[0] = -1;
+	triangle_index[1] = -1;
+	triangle_index[2] = -1;
+	triangle_index[3] = -1;
+
+	if (m_nodes.empty() || !any(active_mask))
+	{
+		return hit;
+	}
+
+	simd_float3 const inverse_direction = simd_float3(simd_float(1.0f) / direction.x, simd_float(1.0f) / direction.y, simd_float(1.0f) / direction.z);
+
+	uint32_t stack[g_bvh_max_stack_size];
+	uint32_t stack_size = 0U;
+	stack[stack_size++] = 0U;
+
+	while (stack_size > 0U)
+	{
+		node_t const &node = m_nodes[stack[--stack_size]];
+
+		simd_float t_entry;
+		simd_float hit_aabb = bvh_ray_aabb(node.aabb_min, node.aabb_max, origin, inverse_direction, t_min, t_hit, t_entry) & active_mask;
+		if (!any(hit_aabb))
+		{
+			continue;
+		}
+
+		if (0U != node.triangle_count)
+		{
+			for (uint32_t i = node.left_or_first; i < (node.left_or_first + node.triangle_count); ++i)
+			{
+				float const *triangle = &m_triangles[static_cast<size_t>(9U) * i];
+
+				simd_float t_triangle;
+				simd_float hit_triangle = bvh_ray_triangle(triangle, origin, direction, t_min, t_hit, t_triangle) & hit_aabb;
+				int hit_triangle_lanes = movemask(hit_triangle);
+				if (0 == hit_triangle_lanes)
+				{
+					continue;
+				}
+
+				simd_float3 e1 = simd_float3_broadcast(triangle[3] - triangle[0], triangle[4] - triangle[1], triangle[5] - triangle[2]);
+				simd_float3 e2 = simd_float3_broadcast(triangle[6] - triangle[0], triangle[7] - triangle[1], triangle[8] - triangle[2]);
+
+				hit = hit | hit_triangle;
+				t_hit = select(hit_triangle, t_triangle, t_hit);
+				geometric_normal = select(hit_triangle, cross(e1, e2), geometric_normal);
+				for (int lane = 0; lane < 4; ++lane)
+				{
+					if (0 != (hit_triangle_lanes & (1 << lane)))
+					{
+						triangle_index[lane] = static_cast<int32_t>(m_triangle_indices[i]);
+					}
+				}
+			}
+		}
+		else
+		{
+			// Visit the nearer child first such that "t_hit" shrinks earlier
+			node_t const &left = m_nodes[node.left_or_first];
+			node_t const &right = m_nodes[node.left_or_first + 1U];
+
+			simd_float t_entry_left;
+			simd_float hit_left = bvh_ray_aabb(left.aabb_min, left.aabb_max, origin, inverse_direction, t_min, t_hit, t_entry_left) & active_mask;
+			simd_float t_entry_right;
+			simd_float hit_right = bvh_ray_aabb(right.aabb_min, right.aabb_max, origin, inverse_direction, t_min, t_hit, t_entry_right) & active_mask;
+
+			float nearest_left = INFINITY;
+			float nearest_right = INFINITY;
+			for (int lane = 0; lane < 4; ++lane)
+			{
+				if (0 != (movemask(hit_left) & (1 << lane)))
+				{
+					nearest_left = std::min(nearest_left, simd_float_lane(t_entry_left, lane));
+				}
+
+				if (0 != (movemask(hit_right) & (1 << lane)))
+				{
+					nearest_right = std::min(nearest_right, simd_float_lane(t_entry_right, lane));
+				}
+			}
+
+			assert((stack_size + 2U) <= g_bvh_max_stack_size);
+			if (nearest_left <= nearest_right)
+			{
+				stack[stack_size++] = node.left_or_first + 1U;
+				stack[stack_size++] = node.left_or_first;
+			}
+			else
+			{
+				stack[stack_size++] = node.left_or_first;
+				stack[stack_size++] = node.left_or_first + 1U;
+			}
+		}
+	}
+
+	return hit;
+}
+
+uint32_t BVH::GetNodeCount() const
+{
+	return static_cast<uint32_t>(m_nodes.size());
+}
+
+uint32_t BVH::GetMaxDepth() const
+{
+	return m_max_depth;
+}
+
+static inline void bvh_aabb_reset(bvh_aabb_t &aabb)
+{
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		aabb.min[axis] = INFINITY;
+		aabb.max[axis] = -INFINITY;
+	}
+}
+
+static inline void bvh_aabb_grow(bvh_aabb_t &aabb, float const *point)
+{
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		aabb.min[axis] = std::min(aabb.min[axis], point[axis]);
+		aabb.max[axis] = std::max(aabb.max[axis], point[axis]);
+	}
+}
+
+static inline void bvh_aabb_grow(bvh_aabb_t &aabb, bvh_aabb_t const &other)
+{
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		aabb.min[axis] = std::min(aabb.min[axis], other.min[axis]);
+		aabb.max[axis] = std::max(aabb.max[axis], other.max[axis]);
+	}
+}
+
+static inline float bvh_aabb_half_area(bvh_aabb_t const &aabb)
+{
+	float extent_x = aabb.max[0] - aabb.min[0];
+	float extent_y = aabb.max[1] - aabb.min[1];
+	float extent_z = aabb.max[2] - aabb.min[2];
+	return (extent_x * extent_y + extent_y * extent_z + extent_z * extent_x);
+}
+
+static inline simd_float bvh_ray_aabb(float const *aabb_min, float const *aabb_max, simd_float3 origin, simd_float3 inverse_direction, simd_float t_min, simd_float t_max, simd_float &t_entry)
+{
+	simd_float t0_x = (simd_float(aabb_min[0]) - origin.x) * inverse_direction.x;
+	simd_float t1_x = (simd_float(aabb_max[0]) - origin.x) * inverse_direction.x;
+	simd_float t0_y = (simd_float(aabb_min[1]) - origin.y) * inverse_direction.y;
+	simd_float t1_y = (simd_float(aabb_max[1]) - origin.y) * inverse_direction.y;
+	simd_float t0_z = (simd_float(aabb_min[2]) - origin.z) * inverse_direction.z;
+	simd_float t1_z = (simd_float(aabb_max[2]) - origin.z) * inverse_direction.z;
+
+	simd_float t_near = max(max(min(t0_x, t1_x), min(t0_y, t1_y)), max(min(t0_z, t1_z), t_min));
+	simd_float t_far = min(min(max(t0_x, t1_x), max(t0_y, t1_y)), min(max(t0_z, t1_z), t_max));
+
+	t_entry = t_near;
+	return (t_near <= t_far);
+}
+
+static inline simd_float bvh_ray_triangle(float const *triangle, simd_float3 origin, simd_float3 direction, simd_float t_min, simd_float t_max, simd_float &t_hit)
+{
+	simd_float3 v0 = simd_float3_broadcast(triangle[0], triangle[1], triangle[2]);
+	simd_float3 e1 = simd_float3_broadcast(triangle[3] - triangle[0], triangle[4] - triangle[1], triangle[5] - triangle[2]);
+	simd_float3 e2 = simd_float3_broadcast(triangle[6] - triangle[0], triangle[7] - triangle[1], triangle[8] - triangle[2]);
+
+	simd_float3 p = cross(direction, e2);
+	simd_float determinant = dot(e1, p);
+	simd_float inverse_determinant = simd_float(1.0f) / determinant;
+
+	simd_float3 s = origin - v0;
+	simd_float u = dot(s, p) * inverse_determinant;
+
+	simd_float3 q = cross(s, e1);
+	simd_float v = dot(direction, q) * inverse_determinant;
+
+	t_hit = dot(e2, q) * inverse_determinant;
+
+	// The NaN (parallel to the triangle) fails all comparisons.
+	return (abs(determinant) > simd_float(1e-20f)) & (u >= simd_float(0.0f)) & (v >= simd_float(0.0f)) & ((u + v) <= simd_float(1.0f)) & (t_hit > t_min) & (t_hit < t_max);
+}
+
+static inline simd_float bvh_and_not(simd_float a, simd_float b)
+{
+	// (~a) & b
+	return _mm_andnot_ps(a.v, b.v);
+}
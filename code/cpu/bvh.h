@@ -0,0 +1,59 @@
+#ifndef _CPU_BVH_H_
+#define _CPU_BVH_H_ 1
+
+//
+// The bounding volume hierarchy of the scene triangles for the CPU ray casting.
+// The rays are traced in packets of 4 (one ray per lane of the "simd_float"), the packet descends into a node if any active ray hits the bounding box.
+//
+
+#include <stdint.h>
+#include <vector>
+
+#include "simd.h"
+
+class BVH
+{
+	// 32 bytes
+	struct node_t
+	{
+		float aabb_min[3];
+		// inner node: the index of the left child (the right child is the next one)
+		// leaf node: the index of the first triangle
+		uint32_t left_or_first;
+		float aabb_max[3];
+		// inner node: 0
+		// leaf node: the number of the triangles
+		uint32_t triangle_count;
+	};
+
+	std::vector<node_t> m_nodes;
+	// 9 floats (3 vertices) per triangle, in the order of the leaves
+	std::vector<float> m_triangles;
+	// the index of the triangle in the input of "Build"
+	std::vector<uint32_t> m_triangle_indices;
+
+	uint32_t m_max_depth;
+
+public:
+	// [in] triangle_vertices: 9 floats (3 vertices) per triangle
+	// [in] scratch: the temporaries of the build are allocated from the current frame of the arena
+	void Build(float const *triangle_vertices, uint32_t triangle_count, class FrameArena &scratch);
+
+	// [in] direction: NOT necessarily normalized, the hit position is "origin + direction * t"
+	// [in] active_mask: the inactive lanes are NOT traced
+	// return: the mask of the lanes that hit any triangle in (t_min, t_max)
+	simd_float Occluded(simd_float3 origin, simd_float3 direction, simd_float t_min, simd_float t_max, simd_float active_mask) const;
+
+	// [in] direction: NOT necessarily normalized, the hit position is "origin + direction * t"
+	// [in] active_mask: the inactive lanes are NOT traced
+	// [out] t_hit: the closest hit (t_max if missed)
+	// [out] triangle_index: the index of the triangle in the input of "Build" (-1 if missed)
+	// [out] geometric_normal: NOT normalized, (0, 0, 0) if missed
+	// return: the mask of the lanes that hit any triangle in (t_min, t_max)
+	simd_float Intersect(simd_float3 origin, simd_float3 direction, simd_float t_min, simd_float t_max, simd_float active_mask, simd_float &t_hit, int32_t triangle_index[4], simd_float3 &geometric_normal) const;
+
+	uint32_t GetNodeCount() const;
+	uint32_t GetMaxDepth() const;
+};
+
+#endif
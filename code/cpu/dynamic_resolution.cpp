@@ -0,0 +1,117 @@
+#include <stdint.h>
+#include <assert.h>
+#include <cmath>
+#include <algorithm>
+
+#include "dynamic_resolution.h"
+
+static inline float dynamic_resolution_level_scale(uint32_t level);
+
+void DynamicResolution::Init(float frame_time_budget_ms)
+{
+	assert(frame_time_budget_ms > 0.0f);
+
+	m_frame_time_budget_ms = frame_time_budget_ms;
+	m_level = DYNAMIC_RESOLUTION_LEVEL_COUNT - 1U;
+	m_smoothed_frame_time_ms = -1.0f;
+	m_settle_frame_count = 0U;
+	m_upscale_frame_count = 0U;
+	m_level_change_count = 0U;
+}
+
+void DynamicResolution::Update(float frame_time_ms)
+{
+	if (!(frame_time_ms >= 0.0f))
+	{
+		return;
+	}
+
+	// the frames in flight were recorded at the previous level
+	if (m_settle_frame_count > 0U)
+	{
+		--m_settle_frame_count;
+		return;
+	}
+
+	m_smoothed_frame_time_ms = (m_smoothed_frame_time_ms < 0.0f) ? frame_time_ms : (m_smoothed_frame_time_ms + (frame_time_ms - m_smoothed_frame_time_ms) * DYNAMIC_RESOLUTION_SMOOTHING);
+
+	float const scale = dynamic_resolution_level_scale(m_level);
+	// the cost per unit of the area
+	float const area_cost_ms = m_smoothed_frame_time_ms / (scale * scale);
+
+	uint32_t level = m_level;
+	if (m_smoothed_frame_time_ms > m_frame_time_budget_ms)
+	{
+		// the highest level predicted to fit, at least one level down
+		level = 0U;
+		for (uint32_t level_index = m_level; level_index > 0U; --level_index)
+		{
+			float const lower_scale = dynamic_resolution_level_scale(level_index - 1U);
+			if ((area_cost_ms * lower_scale * lower_scale) <= m_frame_time_budget_ms)
+			{
+				level = level_index - 1U;
+				break;
+			}
+		}
+		m_upscale_frame_count = 0U;
+	}
+	else if (m_level < (DYNAMIC_RESOLUTION_LEVEL_COUNT - 1U))
+	{
+		float const higher_scale = dynamic_resolution_level_scale(m_level + 1U);
+		if ((area_cost_ms * higher_scale * higher_scale) <= (m_frame_time_budget_ms * DYNAMIC_RESOLUTION_UPSCALE_HEADROOM))
+		{
+			++m_upscale_frame_count;
+			if (m_upscale_frame_count >= DYNAMIC_RESOLUTION_UPSCALE_DELAY)
+			{
+				level = m_level + 1U;
+			}
+		}
+		else
+		{
+			m_upscale_frame_count = 0U;
+		}
+	}
+
+	if (level != m_level)
+	{
+		// the prediction of the new level is the start of the average
+		float const new_scale = dynamic_resolution_level_scale(level);
+		m_smoothed_frame_time_ms = area_cost_ms * new_scale * new_scale;
+		m_level = level;
+		m_settle_frame_count = DYNAMIC_RESOLUTION_SETTLE_FRAME_COUNT;
+		m_upscale_frame_count = 0U;
+		++m_level_change_count;
+	}
+}
+
+uint32_t DynamicResolution::GetLevel() const
+{
+	return m_level;
+}
+
+float DynamicResolution::GetScale() const
+{
+	return dynamic_resolution_level_scale(m_level);
+}
+
+void DynamicResolution::GetRenderSize(uint32_t output_width, uint32_t output_height, uint32_t *width, uint32_t *height) const
+{
+	float const scale = dynamic_resolution_level_scale(m_level);
+	(*width) = std::max(static_cast<uint32_t>(static_cast<float>(output_width) * scale + 0.5f), 1U);
+	(*height) = std::max(static_cast<uint32_t>(static_cast<float>(output_height) * scale + 0.5f), 1U);
+}
+
+float DynamicResolution::GetSmoothedFrameTime() const
+{
+	return m_smoothed_frame_time_ms;
+}
+
+uint32_t DynamicResolution::GetLevelChangeCount() const
+{
+	return m_level_change_count;
+}
+
+static inline float dynamic_resolution_level_scale(uint32_t level)
+{
+	return DYNAMIC_RESOLUTION_MIN_SCALE + (1.0f - DYNAMIC_RESOLUTION_MIN_SCALE) * (static_cast<float>(level) / static_cast<float>(DYNAMIC_RESOLUTION_LEVEL_COUNT - 1U));
+}
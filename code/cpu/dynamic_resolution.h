@@ -0,0 +1,57 @@
+#ifndef _CPU_DYNAMIC_RESOLUTION_H_
+#define _CPU_DYNAMIC_RESOLUTION_H_ 1
+
+//
+// The scale of the render resolution (every pass before the post process, which upscales into the backbuffer) driven by the measured frame time towards the budget.
+//
+// The cost of the frame is assumed to be proportional to the pixel count, such that the scale of the axis which fits the budget is "scale * sqrt(budget / frame_time)".
+// The scale is quantized into the DYNAMIC_RESOLUTION_LEVEL_COUNT levels over [DYNAMIC_RESOLUTION_MIN_SCALE, 1], such that the transient textures of the frame graph
+// are only recreated when the level changes.
+//
+// The frame time is smoothed by the exponential moving average, and the level moves by the hysteresis:
+// down as soon as the smoothed time exceeds the budget (directly to the level predicted to fit),
+// up by one level only if that level is predicted to fit within the DYNAMIC_RESOLUTION_UPSCALE_HEADROOM of the budget for DYNAMIC_RESOLUTION_UPSCALE_DELAY frames in a row.
+// The frame time of the device lags the level by the frames in flight, such that the measurements are ignored for DYNAMIC_RESOLUTION_SETTLE_FRAME_COUNT frames after the change.
+//
+
+#include <stdint.h>
+
+static const uint32_t DYNAMIC_RESOLUTION_LEVEL_COUNT = 9U;
+// the levels are 1/16 apart
+static const float DYNAMIC_RESOLUTION_MIN_SCALE = 0.5F;
+// the weight of the new frame time
+static const float DYNAMIC_RESOLUTION_SMOOTHING = 0.25F;
+static const float DYNAMIC_RESOLUTION_UPSCALE_HEADROOM = 0.85F;
+static const uint32_t DYNAMIC_RESOLUTION_UPSCALE_DELAY = 8U;
+static const uint32_t DYNAMIC_RESOLUTION_SETTLE_FRAME_COUNT = 3U;
+
+class DynamicResolution
+{
+	float m_frame_time_budget_ms;
+	// DYNAMIC_RESOLUTION_LEVEL_COUNT - 1 is the full resolution
+	uint32_t m_level;
+	// negative: no frame time is measured since the last change
+	float m_smoothed_frame_time_ms;
+	uint32_t m_settle_frame_count;
+	uint32_t m_upscale_frame_count;
+	uint32_t m_level_change_count;
+
+public:
+	// starts at the full resolution
+	void Init(float frame_time_budget_ms);
+
+	// [in] frame_time_ms: the duration of a recent frame on the device (see "RenderBackend::GetGPUFrameTime"), negative means NOT measured (ignored)
+	void Update(float frame_time_ms);
+
+	uint32_t GetLevel() const;
+	// the scale of each axis
+	float GetScale() const;
+	// [out] width, height: the scaled output size, at least 1
+	void GetRenderSize(uint32_t output_width, uint32_t output_height, uint32_t *width, uint32_t *height) const;
+	// the smoothed frame time (negative if none)
+	float GetSmoothedFrameTime() const;
+	// since the "Init"
+	uint32_t GetLevelChangeCount() const;
+};
+
+#endif
@@ -0,0 +1,164 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <assert.h>
+#include <algorithm>
+
+#include "frame_arena.h"
+
+// the memory of the region is aligned to the cache line, such that any alignment up to 64 is satisfied by the offset alone
+static const size_t g_frame_arena_max_alignment = 64U;
+
+// The memory is allocated by the "new", such that the global allocation counters (see "support/headless_main.cpp") include the arena.
+
+// the header of the overflow block, followed by the allocation
+struct frame_arena_overflow_block_t
+{
+	void *next;
+};
+
+static inline size_t frame_arena_align_up(size_t value, size_t alignment);
+static inline void *frame_arena_aligned_new(size_t size);
+static inline void frame_arena_aligned_delete(void *memory);
+
+void FrameArena::Init(uint32_t frame_in_flight_count, size_t capacity_per_frame)
+{
+	assert(frame_in_flight_count > 0U);
+
+	m_region_count = frame_in_flight_count;
+	m_regions = new region_t[m_region_count];
+	for (uint32_t region_index = 0U; region_index < m_region_count; ++region_index)
+	{
+		region_t &region = m_regions[region_index];
+		region.capacity = frame_arena_align_up(capacity_per_frame, g_frame_arena_max_alignment);
+		region.memory = (region.capacity > 0U) ? static_cast<uint8_t *>(frame_arena_aligned_new(region.capacity)) : NULL;
+		region.offset = 0U;
+		region.overflow_list = NULL;
+		region.used_byte_count = 0U;
+	}
+
+	// the first "BeginFrame" moves to the region 0
+	m_region_index = m_region_count - 1U;
+
+	memset(&m_statistics, 0, sizeof(m_statistics));
+}
+
+void FrameArena::Destroy()
+{
+	for (uint32_t region_index = 0U; region_index < m_region_count; ++region_index)
+	{
+		ResetRegion(m_regions[region_index]);
+		frame_arena_aligned_delete(m_regions[region_index].memory);
+	}
+
+	delete[] m_regions;
+	m_regions = NULL;
+	m_region_count = 0U;
+}
+
+void FrameArena::ResetRegion(region_t &region)
+{
+	void *overflow_block = region.overflow_list;
+	while (NULL != overflow_block)
+	{
+		frame_arena_overflow_block_t *header = static_cast<frame_arena_overflow_block_t *>(overflow_block);
+		overflow_block = header->next;
+		delete[] reinterpret_cast<uint8_t *>(header);
+	}
+
+	region.overflow_list = NULL;
+	region.offset = 0U;
+	region.used_byte_count = 0U;
+}
+
+void FrameArena::BeginFrame()
+{
+	m_region_index = (m_region_index + 1U) % m_region_count;
+	region_t &region = m_regions[m_region_index];
+
+	// grow to the high water mark, such that the overflow happens at most once per region
+	bool const overflowed = (NULL != region.overflow_list);
+	size_t const used_byte_count = region.used_byte_count;
+
+	ResetRegion(region);
+
+	if (overflowed && used_byte_count > region.capacity)
+	{
+		frame_arena_aligned_delete(region.memory);
+		region.capacity = frame_arena_align_up(used_byte_count, g_frame_arena_max_alignment);
+		region.memory = static_cast<uint8_t *>(frame_arena_aligned_new(region.capacity));
+		++m_statistics.grow_count;
+	}
+
+	m_statistics.allocation_count = 0U;
+	m_statistics.byte_count = 0U;
+	++m_statistics.frame_count;
+}
+
+void *FrameArena::Allocate(size_t size, size_t alignment)
+{
+	assert(0U != alignment && 0U == (alignment & (alignment - 1U)) && alignment <= g_frame_arena_max_alignment);
+
+	region_t &region = m_regions[m_region_index];
+
+	++m_statistics.allocation_count;
+	m_statistics.byte_count += size;
+
+	size_t const offset = frame_arena_align_up(region.offset, alignment);
+	// "used_byte_count" counts the padding as well, such that the grown region is enough for the same sequence of the allocations
+	region.used_byte_count += (offset - region.offset) + size;
+	m_statistics.high_water_byte_count = std::max(static_cast<uint64_t>(region.used_byte_count), m_statistics.high_water_byte_count);
+
+	if (offset + size <= region.capacity)
+	{
+		region.offset = offset + size;
+		return region.memory + offset;
+	}
+
+	// overflow: the header, the padding of the alignment and the allocation
+	++m_statistics.overflow_allocation_count;
+	region.used_byte_count += alignment;
+
+	size_t const header_size = frame_arena_align_up(sizeof(frame_arena_overflow_block_t), alignof(frame_arena_overflow_block_t));
+	uint8_t *memory = new uint8_t[header_size + alignment + size];
+
+	uintptr_t const allocation = (reinterpret_cast<uintptr_t>(memory) + header_size + (alignment - 1U)) & ~static_cast<uintptr_t>(alignment - 1U);
+	frame_arena_overflow_block_t *header = reinterpret_cast<frame_arena_overflow_block_t *>(memory);
+	header->next = region.overflow_list;
+	region.overflow_list = header;
+
+	return reinterpret_cast<void *>(allocation);
+}
+
+uint32_t FrameArena::GetFrameInFlightCount() const
+{
+	return m_region_count;
+}
+
+frame_arena_statistics_t const &FrameArena::GetStatistics() const
+{
+	return m_statistics;
+}
+
+static inline size_t frame_arena_align_up(size_t value, size_t alignment)
+{
+	return (value + (alignment - 1U)) & ~(alignment - 1U);
+}
+
+static inline void *frame_arena_aligned_new(size_t size)
+{
+	// the pointer of the "new" is stored just before the aligned memory
+	uint8_t *memory = new uint8_t[size + g_frame_arena_max_alignment + sizeof(void *)];
+
+	uintptr_t const aligned = (reinterpret_cast<uintptr_t>(memory) + sizeof(void *) + (g_frame_arena_max_alignment - 1U)) & ~static_cast<uintptr_t>(g_frame_arena_max_alignment - 1U);
+	reinterpret_cast<uint8_t **>(aligned)[-1] = memory;
+	return reinterpret_cast<void *>(aligned);
+}
+
+static inline void frame_arena_aligned_delete(void *memory)
+{
+	if (NULL != memory)
+	{
+		delete[] static_cast<uint8_t **>(memory)[-1];
+	}
+}
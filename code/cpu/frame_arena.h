@@ -0,0 +1,76 @@
+#ifndef _CPU_FRAME_ARENA_H_
+#define _CPU_FRAME_ARENA_H_ 1
+
+//
+// The linear (bump) allocator of the transient per-frame data (the constant buffer staging, the light lists, the scratch of the CPU passes, etc.).
+//
+// The arena is a ring of "frame_in_flight_count" regions. The "BeginFrame" moves to the next region and resets it,
+// such that the memory allocated in a frame stays valid until the "BeginFrame" is called "frame_in_flight_count" more times.
+// There is no "free", and the destructors are NOT called.
+//
+// The region which runs out of the capacity falls back to the heap (counted by the "overflow_allocation_count"),
+// and grows to the high water mark the next time it is reset, such that the steady state frame never touches the heap.
+//
+
+#include <stdint.h>
+#include <stddef.h>
+
+struct frame_arena_statistics_t
+{
+	// the current frame
+	uint32_t allocation_count;
+	uint64_t byte_count;
+
+	// since the "Init"
+	uint64_t frame_count;
+	uint64_t high_water_byte_count;
+	// the allocations which did NOT fit in the region (heap)
+	uint64_t overflow_allocation_count;
+	// the regions reallocated to the high water mark (heap)
+	uint64_t grow_count;
+};
+
+class FrameArena
+{
+	struct region_t
+	{
+		uint8_t *memory;
+		size_t capacity;
+		size_t offset;
+		// the heap blocks of the overflow, linked by the header of each block
+		void *overflow_list;
+		// including the overflow
+		size_t used_byte_count;
+	};
+
+	region_t *m_regions;
+	uint32_t m_region_count;
+	uint32_t m_region_index;
+
+	frame_arena_statistics_t m_statistics;
+
+	static void ResetRegion(region_t &region);
+
+public:
+	// [in] frame_in_flight_count: the number of the frames of which the memory stays valid (including the current frame)
+	// [in] capacity_per_frame: the initial capacity of each region
+	void Init(uint32_t frame_in_flight_count, size_t capacity_per_frame);
+	void Destroy();
+
+	void BeginFrame();
+
+	// [in] alignment: power of 2, at most 64
+	// return: NOT initialized
+	void *Allocate(size_t size, size_t alignment);
+
+	template <typename T>
+	inline T *Allocate(size_t count)
+	{
+		return static_cast<T *>(this->Allocate(sizeof(T) * count, alignof(T)));
+	}
+
+	uint32_t GetFrameInFlightCount() const;
+	frame_arena_statistics_t const &GetStatistics() const;
+};
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef _CPU_HALF_H_
+#define _CPU_HALF_H_ 1
+
+//
+// The conversion of the float into the half (IEEE 754 binary16) of the RGBA16F textures and of the half EXR.
+// Rounded to the nearest even, the subnormals of the half are kept (NOT flushed to 0).
+// The HDR values beyond the range (including the infinity) are clamped to the max finite value (65504) rather than becoming the infinity, the NaN becomes the quiet NaN.
+//
+// https://gist.github.com/rygorous/2156668
+//
+
+#include <stdint.h>
+#include <string.h>
+
+inline uint16_t float_to_half(float value)
+{
+	// the float of the magnitude "2^16" and above is beyond the max finite half (including the values which round up to "2^16")
+	uint32_t const f16_max = (127U + 16U) << 23U;
+	uint32_t const f32_infinity = 255U << 23U;
+	// the smallest normal half
+	uint32_t const f16_min_normal = (127U - 14U) << 23U;
+	// "0.5": the addition of the float aligns the mantissa of the subnormal to the bits of the half and rounds it to the nearest even
+	uint32_t const denormal_magic = ((127U - 15U) + (23U - 10U) + 1U) << 23U;
+
+	uint32_t f;
+	memcpy(&f, &value, sizeof(uint32_t));
+
+	uint32_t const sign = f & 0X80000000U;
+	f ^= sign;
+
+	uint32_t h;
+	if (f >= f16_max)
+	{
+		h = (f > f32_infinity) ? 0X7E00U : 0X7BFFU;
+	}
+	else if (f < f16_min_normal)
+	{
+		// subnormal or zero
+		float f_value;
+		memcpy(&f_value, &f, sizeof(uint32_t));
+		float denormal_magic_value;
+		memcpy(&denormal_magic_value, &denormal_magic, sizeof(uint32_t));
+		f_value += denormal_magic_value;
+		memcpy(&f, &f_value, sizeof(uint32_t));
+		h = f - denormal_magic;
+	}
+	else
+	{
+		// the exponent is rebiased, and the 13 bits dropped from the mantissa are rounded to the nearest even (the carry into the exponent is correct)
+		uint32_t const mantissa_odd = (f >> 13U) & 1U;
+		f += (static_cast<uint32_t>(15 - 127) << 23U) + 0XFFFU;
+		f += mantissa_odd;
+		h = f >> 13U;
+		// [65520, 65536) rounds up to the infinity
+		h = (h < 0X7C00U) ? h : 0X7BFFU;
+	}
+
+	return static_cast<uint16_t>(h | (sign >> 16U));
+}
+
+#endif
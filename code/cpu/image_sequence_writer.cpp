@@ -0,0 +1,786 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "half.h"
+#include "tonemap_encoder.h"
+#include "image_sequence_writer.h"
+
+// the deflate: the window of the LZ77 and the hash table of the 3-byte prefixes (the latest position of each prefix only, neither the chain nor the lazy matching)
+static uint32_t const g_image_sequence_deflate_window_size = 32768U;
+static uint32_t const g_image_sequence_deflate_hash_bits = 15U;
+static uint32_t const g_image_sequence_deflate_min_match = 3U;
+static uint32_t const g_image_sequence_deflate_max_match = 258U;
+
+// the maximum size of the encoded file of the format
+static size_t image_sequence_max_file_size(image_sequence_format_t format, uint32_t width, uint32_t height);
+
+static size_t image_sequence_encode_exr(float const *radiance, uint32_t width, uint32_t height, uint8_t *file);
+
+static size_t image_sequence_encode_pfm(float const *radiance, uint32_t width, uint32_t height, uint8_t *file);
+
+// [out] display_color: BGRA8 of the "TonemapEncodeRow" of the exposure 1
+static void image_sequence_tonemap_row(float const *radiance_row, uint32_t width, float *row, uint8_t *display_color);
+
+// [in] filtered: the rows of the RGB8 image, each after its filter type byte
+static size_t image_sequence_encode_png(uint8_t *filtered, uint32_t *hash_table, uint32_t width, uint32_t height, uint8_t *file);
+
+// the "filter_rgb8" rows of the PNG are filtered in place: None, Sub or Up, whichever has the minimum sum of the absolute differences
+static void image_sequence_filter_png_rows(uint8_t *filtered, uint32_t width, uint32_t height);
+
+// the zlib stream of the single final block of the fixed Huffman codes
+// [return] the size of the stream
+static size_t image_sequence_deflate(uint8_t const *data, size_t size, uint32_t *hash_table, uint8_t *stream);
+
+static uint32_t image_sequence_crc32(uint8_t const *data, size_t size, uint32_t crc);
+
+static inline uint8_t *image_sequence_store_u32_be(uint8_t *cursor, uint32_t value);
+
+static inline uint8_t *image_sequence_store_u32_le(uint8_t *cursor, uint32_t value);
+
+static inline uint8_t *image_sequence_store_bytes(uint8_t *cursor, void const *data, size_t size);
+
+void ImageSequenceWriter::Init(char const *path_prefix, image_sequence_format_t format, uint32_t width, uint32_t height, uint32_t queue_length, uint32_t writer_thread_count)
+{
+	assert(width > 0U && height > 0U);
+
+	snprintf(m_path_prefix, sizeof(m_path_prefix), "%s", path_prefix);
+	m_format = format;
+	m_width = width;
+	m_height = height;
+
+	m_slot_count = std::max(queue_length, 1U);
+	m_slots = new slot_t[m_slot_count];
+	m_free_slots.reserve(m_slot_count);
+	for (uint32_t slot_index = 0U; slot_index < m_slot_count; ++slot_index)
+	{
+		m_slots[slot_index].frame_index = 0U;
+		m_slots[slot_index].radiance.resize(static_cast<size_t>(width) * height * 3U);
+		m_free_slots.push_back(m_slot_count - 1U - slot_index);
+	}
+	m_queued_slots.assign(m_slot_count, 0U);
+	m_queued_begin = 0U;
+	m_queued_count = 0U;
+	m_quit = false;
+
+	memset(&m_statistics, 0, sizeof(image_sequence_writer_statistics_t));
+
+	m_writer_count = std::max(writer_thread_count, 1U);
+	m_writers = new writer_t[m_writer_count];
+	for (uint32_t writer_index = 0U; writer_index < m_writer_count; ++writer_index)
+	{
+		writer_t &writer = m_writers[writer_index];
+		writer.file.resize(image_sequence_max_file_size(format, width, height));
+		if (IMAGE_SEQUENCE_FORMAT_PNG == format)
+		{
+			writer.filtered.resize(static_cast<size_t>(height) * (1U + 3U * static_cast<size_t>(width)));
+			writer.hash_table.resize(static_cast<size_t>(1U) << g_image_sequence_deflate_hash_bits);
+		}
+		if (IMAGE_SEQUENCE_FORMAT_PNG == format || IMAGE_SEQUENCE_FORMAT_BGRA == format)
+		{
+			writer.row.resize(static_cast<size_t>(width) * 4U);
+			writer.display_row.resize(static_cast<size_t>(width) * 4U);
+		}
+	}
+
+	// the buffers are complete before any writer starts
+	for (uint32_t writer_index = 0U; writer_index < m_writer_count; ++writer_index)
+	{
+		m_writers[writer_index].thread = std::thread(&ImageSequenceWriter::WriterMain, this, writer_index);
+	}
+}
+
+void ImageSequenceWriter::Destroy()
+{
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_quit = true;
+	}
+	m_queued_condition.notify_all();
+
+	for (uint32_t writer_index = 0U; writer_index < m_writer_count; ++writer_index)
+	{
+		m_writers[writer_index].thread.join();
+	}
+
+	delete[] m_writers;
+	m_writers = NULL;
+	m_writer_count = 0U;
+
+	delete[] m_slots;
+	m_slots = NULL;
+	m_slot_count = 0U;
+
+	m_free_slots.clear();
+	m_queued_slots.clear();
+}
+
+void ImageSequenceWriter::Write(uint32_t frame_index, float const *radiance)
+{
+	uint32_t slot_index;
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		if (m_free_slots.empty())
+		{
+			std::chrono::steady_clock::time_point const stall_begin = std::chrono::steady_clock::now();
+			m_free_condition.wait(lock, [this]() { return !m_free_slots.empty(); });
+			m_statistics.stall_milliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - stall_begin).count();
+			++m_statistics.stall_count;
+		}
+
+		slot_index = m_free_slots.back();
+		m_free_slots.pop_back();
+	}
+
+	// the slot is owned by the calling thread until it is queued
+	slot_t &slot = m_slots[slot_index];
+	slot.frame_index = frame_index;
+	memcpy(&slot.radiance[0], radiance, sizeof(float) * slot.radiance.size());
+
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_queued_slots[(m_queued_begin + m_queued_count) % m_slot_count] = slot_index;
+		++m_queued_count;
+	}
+	m_queued_condition.notify_one();
+}
+
+void ImageSequenceWriter::Flush()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_free_condition.wait(lock, [this]() { return m_free_slots.size() == m_slot_count; });
+}
+
+char const *ImageSequenceWriter::GetExtension(image_sequence_format_t format)
+{
+	switch (format)
+	{
+	case IMAGE_SEQUENCE_FORMAT_EXR:
+		return "exr";
+	case IMAGE_SEQUENCE_FORMAT_PFM:
+		return "pfm";
+	case IMAGE_SEQUENCE_FORMAT_PNG:
+		return "png";
+	case IMAGE_SEQUENCE_FORMAT_BGRA:
+		return "bgra";
+	default:
+		assert(false);
+		return "";
+	}
+}
+
+image_sequence_writer_statistics_t const &ImageSequenceWriter::GetStatistics() const
+{
+	return m_statistics;
+}
+
+void ImageSequenceWriter::WriterMain(uint32_t writer_index)
+{
+	writer_t &writer = m_writers[writer_index];
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	for (;;)
+	{
+		m_queued_condition.wait(lock, [this]() { return m_quit || (m_queued_count > 0U); });
+
+		// the queued frames are written before the quit
+		if (0U == m_queued_count)
+		{
+			break;
+		}
+
+		uint32_t const slot_index = m_queued_slots[m_queued_begin];
+		m_queued_begin = (m_queued_begin + 1U) % m_slot_count;
+		--m_queued_count;
+
+		lock.unlock();
+		double encode_milliseconds = 0.0;
+		double io_milliseconds = 0.0;
+		bool const success = this->WriteSlot(writer, m_slots[slot_index], &encode_milliseconds, &io_milliseconds);
+		lock.lock();
+
+		if (success)
+		{
+			++m_statistics.written_frame_count;
+		}
+		else
+		{
+			++m_statistics.failed_frame_count;
+		}
+		m_statistics.encode_milliseconds += encode_milliseconds;
+		m_statistics.io_milliseconds += io_milliseconds;
+
+		// never beyond the capacity reserved by the "Init"
+		m_free_slots.push_back(slot_index);
+		m_free_condition.notify_all();
+	}
+}
+
+bool ImageSequenceWriter::WriteSlot(writer_t &writer, slot_t const &slot, double *encode_milliseconds, double *io_milliseconds)
+{
+	std::chrono::steady_clock::time_point const encode_begin = std::chrono::steady_clock::now();
+
+	float const *const radiance = &slot.radiance[0];
+	uint8_t *const file = &writer.file[0];
+	size_t file_size = 0U;
+	switch (m_format)
+	{
+	case IMAGE_SEQUENCE_FORMAT_EXR:
+	{
+		file_size = image_sequence_encode_exr(radiance, m_width, m_height, file);
+	}
+	break;
+	case IMAGE_SEQUENCE_FORMAT_PFM:
+	{
+		file_size = image_sequence_encode_pfm(radiance, m_width, m_height, file);
+	}
+	break;
+	case IMAGE_SEQUENCE_FORMAT_PNG:
+	{
+		uint8_t *const filtered = &writer.filtered[0];
+		size_t const filtered_stride = 1U + 3U * static_cast<size_t>(m_width);
+		for (uint32_t y = 0U; y < m_height; ++y)
+		{
+			image_sequence_tonemap_row(radiance + static_cast<size_t>(m_width) * y * 3U, m_width, &writer.row[0], &writer.display_row[0]);
+
+			uint8_t *const filtered_row = filtered + filtered_stride * y + 1U;
+			for (uint32_t x = 0U; x < m_width; ++x)
+			{
+				filtered_row[3U * x + 0U] = writer.display_row[4U * x + 2U];
+				filtered_row[3U * x + 1U] = writer.display_row[4U * x + 1U];
+				filtered_row[3U * x + 2U] = writer.display_row[4U * x + 0U];
+			}
+		}
+		image_sequence_filter_png_rows(filtered, m_width, m_height);
+		file_size = image_sequence_encode_png(filtered, &writer.hash_table[0], m_width, m_height, file);
+	}
+	break;
+	case IMAGE_SEQUENCE_FORMAT_BGRA:
+	{
+		for (uint32_t y = 0U; y < m_height; ++y)
+		{
+			image_sequence_tonemap_row(radiance + static_cast<size_t>(m_width) * y * 3U, m_width, &writer.row[0], file + static_cast<size_t>(m_width) * y * 4U);
+		}
+		file_size = static_cast<size_t>(m_width) * m_height * 4U;
+	}
+	break;
+	default:
+		assert(false);
+	}
+	assert(file_size <= writer.file.size());
+
+	std::chrono::steady_clock::time_point const io_begin = std::chrono::steady_clock::now();
+	(*encode_milliseconds) = std::chrono::duration<double, std::milli>(io_begin - encode_begin).count();
+
+	char path[300];
+	snprintf(path, sizeof(path), "%s%05u.%s", m_path_prefix, slot.frame_index, GetExtension(m_format));
+
+	bool success = false;
+	FILE *stream = fopen(path, "wb");
+	if (NULL != stream)
+	{
+		success = (file_size == fwrite(file, 1U, file_size, stream));
+		success = (0 == fclose(stream)) && success;
+	}
+
+	(*io_milliseconds) = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - io_begin).count();
+
+	if (success)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_statistics.written_byte_count += file_size;
+	}
+	return success;
+}
+
+static size_t image_sequence_max_file_size(image_sequence_format_t format, uint32_t width, uint32_t height)
+{
+	size_t const pixel_count = static_cast<size_t>(width) * height;
+	switch (format)
+	{
+	case IMAGE_SEQUENCE_FORMAT_EXR:
+		// the header is fewer than 512 bytes, each scanline: the offset, the "y" and the size, 3 halfs per pixel
+		return 512U + static_cast<size_t>(height) * 16U + pixel_count * 6U;
+	case IMAGE_SEQUENCE_FORMAT_PFM:
+		return 64U + pixel_count * 12U;
+	case IMAGE_SEQUENCE_FORMAT_PNG:
+	{
+		// the fixed Huffman codes never exceed 9 bits per byte (the literal of 9 bits, the shortest match of 25 bits per 3 bytes)
+		size_t const filtered_size = static_cast<size_t>(height) * (1U + 3U * static_cast<size_t>(width));
+		return 8U + 25U + 12U + (2U + (filtered_size * 9U + 7U) / 8U + 2U + 4U) + 12U;
+	}
+	case IMAGE_SEQUENCE_FORMAT_BGRA:
+		return pixel_count * 4U;
+	default:
+		assert(false);
+		return 0U;
+	}
+}
+
+static size_t image_sequence_encode_exr(float const *radiance, uint32_t width, uint32_t height, uint8_t *file)
+{
+	// OpenEXR File Layout: the magic number, the version 2 (the single part scanline image), the attributes "name\0type\0size value" and the 0 which ends the header
+	uint8_t *cursor = file;
+	cursor = image_sequence_store_u32_le(cursor, 20000630U);
+	cursor = image_sequence_store_u32_le(cursor, 2U);
+
+	// the channels in the alphabetical order, each: the name, the pixel type (1: HALF), the pLinear and the 3 reserved bytes, the x and the y sampling
+	{
+		cursor = image_sequence_store_bytes(cursor, "channels\0chlist", 16U);
+		cursor = image_sequence_store_u32_le(cursor, 3U * 18U + 1U);
+		char const *const channel_names[3] = {"B", "G", "R"};
+		for (uint32_t channel_index = 0U; channel_index < 3U; ++channel_index)
+		{
+			cursor = image_sequence_store_bytes(cursor, channel_names[channel_index], 2U);
+			cursor = image_sequence_store_u32_le(cursor, 1U);
+			cursor = image_sequence_store_u32_le(cursor, 0U);
+			cursor = image_sequence_store_u32_le(cursor, 1U);
+			cursor = image_sequence_store_u32_le(cursor, 1U);
+		}
+		(*cursor++) = 0U;
+	}
+
+	// NO_COMPRESSION
+	cursor = image_sequence_store_bytes(cursor, "compression\0compression", 24U);
+	cursor = image_sequence_store_u32_le(cursor, 1U);
+	(*cursor++) = 0U;
+
+	char const *const window_names[2] = {"dataWindow\0box2i", "displayWindow\0box2i"};
+	size_t const window_name_sizes[2] = {17U, 20U};
+	for (uint32_t window_index = 0U; window_index < 2U; ++window_index)
+	{
+		cursor = image_sequence_store_bytes(cursor, window_names[window_index], window_name_sizes[window_index]);
+		cursor = image_sequence_store_u32_le(cursor, 16U);
+		cursor = image_sequence_store_u32_le(cursor, 0U);
+		cursor = image_sequence_store_u32_le(cursor, 0U);
+		cursor = image_sequence_store_u32_le(cursor, width - 1U);
+		cursor = image_sequence_store_u32_le(cursor, height - 1U);
+	}
+
+	// INCREASING_Y: the row 0 is the top of the image
+	cursor = image_sequence_store_bytes(cursor, "lineOrder\0lineOrder", 20U);
+	cursor = image_sequence_store_u32_le(cursor, 1U);
+	(*cursor++) = 0U;
+
+	float const one = 1.0f;
+	float const zero = 0.0f;
+	cursor = image_sequence_store_bytes(cursor, "pixelAspectRatio\0float", 23U);
+	cursor = image_sequence_store_u32_le(cursor, 4U);
+	cursor = image_sequence_store_bytes(cursor, &one, 4U);
+
+	cursor = image_sequence_store_bytes(cursor, "screenWindowCenter\0v2f", 23U);
+	cursor = image_sequence_store_u32_le(cursor, 8U);
+	cursor = image_sequence_store_bytes(cursor, &zero, 4U);
+	cursor = image_sequence_store_bytes(cursor, &zero, 4U);
+
+	cursor = image_sequence_store_bytes(cursor, "screenWindowWidth\0float", 24U);
+	cursor = image_sequence_store_u32_le(cursor, 4U);
+	cursor = image_sequence_store_bytes(cursor, &one, 4U);
+
+	(*cursor++) = 0U;
+
+	// the offset table: the offset of each scanline from the beginning of the file
+	uint32_t const scanline_data_size = width * 3U * 2U;
+	uint64_t const first_scanline_offset = static_cast<uint64_t>(cursor - file) + static_cast<uint64_t>(height) * 8U;
+	for (uint32_t y = 0U; y < height; ++y)
+	{
+		uint64_t const offset = first_scanline_offset + static_cast<uint64_t>(y) * (8U + scanline_data_size);
+		cursor = image_sequence_store_u32_le(cursor, static_cast<uint32_t>(offset));
+		cursor = image_sequence_store_u32_le(cursor, static_cast<uint32_t>(offset >> 32U));
+	}
+
+	// each scanline: the "y", the size, the channels one after another (B, G, R)
+	for (uint32_t y = 0U; y < height; ++y)
+	{
+		cursor = image_sequence_store_u32_le(cursor, y);
+		cursor = image_sequence_store_u32_le(cursor, scanline_data_size);
+
+		float const *const row = radiance + static_cast<size_t>(width) * y * 3U;
+		for (uint32_t channel_index = 0U; channel_index < 3U; ++channel_index)
+		{
+			uint32_t const component_index = 2U - channel_index;
+			for (uint32_t x = 0U; x < width; ++x)
+			{
+				uint16_t const half = float_to_half(row[3U * x + component_index]);
+				cursor[0] = static_cast<uint8_t>(half & 0XFFU);
+				cursor[1] = static_cast<uint8_t>(half >> 8U);
+				cursor += 2U;
+			}
+		}
+	}
+
+	return static_cast<size_t>(cursor - file);
+}
+
+static size_t image_sequence_encode_pfm(float const *radiance, uint32_t width, uint32_t height, uint8_t *file)
+{
+	// The negative scale means little endian, the rows are from the bottom to the top.
+	int const header_size = snprintf(reinterpret_cast<char *>(file), 64U, "PF\n%u %u\n-1.0\n", width, height);
+	assert(header_size > 0 && header_size < 64);
+
+	uint8_t *cursor = file + header_size;
+	size_t const row_size = sizeof(float) * static_cast<size_t>(width) * 3U;
+	for (uint32_t y = 0U; y < height; ++y)
+	{
+		size_t const row_index = height - 1U - y;
+		cursor = image_sequence_store_bytes(cursor, radiance + row_index * width * 3U, row_size);
+	}
+
+	return static_cast<size_t>(cursor - file);
+}
+
+static void image_sequence_tonemap_row(float const *radiance_row, uint32_t width, float *row, uint8_t *display_color)
+{
+	for (uint32_t x = 0U; x < width; ++x)
+	{
+		row[4U * x + 0U] = radiance_row[3U * x + 0U];
+		row[4U * x + 1U] = radiance_row[3U * x + 1U];
+		row[4U * x + 2U] = radiance_row[3U * x + 2U];
+		row[4U * x + 3U] = 1.0f;
+	}
+	TonemapEncodeRow(row, width, 1.0f, display_color);
+}
+
+static size_t image_sequence_encode_png(uint8_t *filtered, uint32_t *hash_table, uint32_t width, uint32_t height, uint8_t *file)
+{
+	static uint8_t const signature[8] = {0X89U, 'P', 'N', 'G', '\r', '\n', 0X1AU, '\n'};
+
+	uint8_t *cursor = file;
+	cursor = image_sequence_store_bytes(cursor, signature, sizeof(signature));
+
+	// IHDR: the bit depth 8, the color type 2 (RGB), the deflate, the adaptive filtering, NOT interlaced
+	{
+		uint8_t *const chunk = cursor;
+		cursor = image_sequence_store_u32_be(cursor, 13U);
+		cursor = image_sequence_store_bytes(cursor, "IHDR", 4U);
+		cursor = image_sequence_store_u32_be(cursor, width);
+		cursor = image_sequence_store_u32_be(cursor, height);
+		uint8_t const format[5] = {8U, 2U, 0U, 0U, 0U};
+		cursor = image_sequence_store_bytes(cursor, format, sizeof(format));
+		cursor = image_sequence_store_u32_be(cursor, image_sequence_crc32(chunk + 4U, 4U + 13U, 0U));
+	}
+
+	// IDAT: the whole zlib stream
+	{
+		size_t const filtered_size = static_cast<size_t>(height) * (1U + 3U * static_cast<size_t>(width));
+		uint8_t *const chunk = cursor;
+		uint32_t const stream_size = static_cast<uint32_t>(image_sequence_deflate(filtered, filtered_size, hash_table, chunk + 8U));
+		cursor = image_sequence_store_u32_be(cursor, stream_size);
+		cursor = image_sequence_store_bytes(cursor, "IDAT", 4U);
+		cursor += stream_size;
+		cursor = image_sequence_store_u32_be(cursor, image_sequence_crc32(chunk + 4U, 4U + stream_size, 0U));
+	}
+
+	// IEND
+	{
+		uint8_t *const chunk = cursor;
+		cursor = image_sequence_store_u32_be(cursor, 0U);
+		cursor = image_sequence_store_bytes(cursor, "IEND", 4U);
+		cursor = image_sequence_store_u32_be(cursor, image_sequence_crc32(chunk + 4U, 4U, 0U));
+	}
+
+	return static_cast<size_t>(cursor - file);
+}
+
+static void image_sequence_filter_png_rows(uint8_t *filtered, uint32_t width, uint32_t height)
+{
+	size_t const stride = 1U + 3U * static_cast<size_t>(width);
+	size_t const row_size = 3U * static_cast<size_t>(width);
+
+	// from the bottom to the top, such that the row above is still unfiltered when the "Up" reads it
+	for (uint32_t y = height; y > 0U; --y)
+	{
+		uint8_t *const row = filtered + stride * (y - 1U) + 1U;
+		uint8_t const *const above = (y > 1U) ? (filtered + stride * (y - 2U) + 1U) : NULL;
+
+		// the filtered bytes as signed
+		uint32_t none_sum = 0U;
+		uint32_t sub_sum = 0U;
+		uint32_t up_sum = 0U;
+		for (size_t i = 0U; i < row_size; ++i)
+		{
+			uint8_t const left = (i >= 3U) ? row[i - 3U] : 0U;
+			uint8_t const up = (NULL != above) ? above[i] : 0U;
+			none_sum += std::min<uint32_t>(row[i], 256U - row[i]);
+			uint8_t const sub = static_cast<uint8_t>(row[i] - left);
+			sub_sum += std::min<uint32_t>(sub, 256U - sub);
+			uint8_t const up_difference = static_cast<uint8_t>(row[i] - up);
+			up_sum += std::min<uint32_t>(up_difference, 256U - up_difference);
+		}
+
+		if (sub_sum < none_sum && sub_sum <= up_sum)
+		{
+			// from the right to the left, such that the left neighbor is still unfiltered
+			for (size_t i = row_size; i > 3U; --i)
+			{
+				row[i - 1U] = static_cast<uint8_t>(row[i - 1U] - row[i - 4U]);
+			}
+			row[-1] = 1U;
+		}
+		else if (up_sum < none_sum && NULL != above)
+		{
+			for (size_t i = 0U; i < row_size; ++i)
+			{
+				row[i] = static_cast<uint8_t>(row[i] - above[i]);
+			}
+			row[-1] = 2U;
+		}
+		else
+		{
+			row[-1] = 0U;
+		}
+	}
+}
+
+namespace
+{
+	// RFC 1951 3.2.6: the codes are reversed, such that they are written from the least significant bit as the other fields
+	struct image_sequence_fixed_huffman_t
+	{
+		uint16_t literal_codes[288];
+		uint8_t literal_code_lengths[288];
+		uint8_t distance_codes[30];
+		// indexed by "length - 3"
+		uint8_t length_symbols[256];
+	};
+
+	struct image_sequence_bit_writer_t
+	{
+		uint8_t *cursor;
+		uint64_t bits;
+		uint32_t bit_count;
+
+		inline void Put(uint32_t value, uint32_t bit_count_value)
+		{
+			bits |= (static_cast<uint64_t>(value) << bit_count);
+			bit_count += bit_count_value;
+			while (bit_count >= 8U)
+			{
+				(*cursor++) = static_cast<uint8_t>(bits & 0XFFU);
+				bits >>= 8U;
+				bit_count -= 8U;
+			}
+		}
+
+		inline void Finish()
+		{
+			if (bit_count > 0U)
+			{
+				(*cursor++) = static_cast<uint8_t>(bits & 0XFFU);
+			}
+			bits = 0U;
+			bit_count = 0U;
+		}
+	};
+}
+
+static uint16_t const g_image_sequence_length_bases[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+static uint8_t const g_image_sequence_length_extra_bits[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+static uint16_t const g_image_sequence_distance_bases[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+static uint8_t const g_image_sequence_distance_extra_bits[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+static inline uint32_t image_sequence_reverse_bits(uint32_t value, uint32_t bit_count)
+{
+	uint32_t reversed = 0U;
+	for (uint32_t bit_index = 0U; bit_index < bit_count; ++bit_index)
+	{
+		reversed = (reversed << 1U) | ((value >> bit_index) & 1U);
+	}
+	return reversed;
+}
+
+static image_sequence_fixed_huffman_t image_sequence_build_fixed_huffman()
+{
+	image_sequence_fixed_huffman_t table;
+	for (uint32_t symbol = 0U; symbol < 288U; ++symbol)
+	{
+		uint32_t code;
+		uint32_t code_length;
+		if (symbol < 144U)
+		{
+			code = 0X30U + symbol;
+			code_length = 8U;
+		}
+		else if (symbol < 256U)
+		{
+			code = 0X190U + (symbol - 144U);
+			code_length = 9U;
+		}
+		else if (symbol < 280U)
+		{
+			code = symbol - 256U;
+			code_length = 7U;
+		}
+		else
+		{
+			code = 0XC0U + (symbol - 280U);
+			code_length = 8U;
+		}
+		table.literal_codes[symbol] = static_cast<uint16_t>(image_sequence_reverse_bits(code, code_length));
+		table.literal_code_lengths[symbol] = static_cast<uint8_t>(code_length);
+	}
+
+	for (uint32_t distance_symbol = 0U; distance_symbol < 30U; ++distance_symbol)
+	{
+		table.distance_codes[distance_symbol] = static_cast<uint8_t>(image_sequence_reverse_bits(distance_symbol, 5U));
+	}
+
+	for (uint32_t length = 3U; length <= 258U; ++length)
+	{
+		uint32_t length_symbol = 28U;
+		while (g_image_sequence_length_bases[length_symbol] > length)
+		{
+			--length_symbol;
+		}
+		table.length_symbols[length - 3U] = static_cast<uint8_t>(length_symbol);
+	}
+
+	return table;
+}
+
+static size_t image_sequence_deflate(uint8_t const *data, size_t size, uint32_t *hash_table, uint8_t *stream)
+{
+	// initialized once (thread safe) by the first writer
+	static image_sequence_fixed_huffman_t const table = image_sequence_build_fixed_huffman();
+
+	// the zlib header: the deflate of the 32K window, the fastest level (the check bits make the header the multiple of 31)
+	stream[0] = 0X78U;
+	stream[1] = 0X01U;
+
+	image_sequence_bit_writer_t bit_writer;
+	bit_writer.cursor = stream + 2U;
+	bit_writer.bits = 0U;
+	bit_writer.bit_count = 0U;
+
+	// BFINAL 1, BTYPE 01 (the fixed Huffman codes)
+	bit_writer.Put(1U, 1U);
+	bit_writer.Put(1U, 2U);
+
+	// the position + 1, 0 means empty
+	memset(hash_table, 0, sizeof(uint32_t) << g_image_sequence_deflate_hash_bits);
+
+	size_t position = 0U;
+	while ((position + g_image_sequence_deflate_min_match) <= size)
+	{
+		uint32_t const prefix = (static_cast<uint32_t>(data[position]) << 16U) | (static_cast<uint32_t>(data[position + 1U]) << 8U) | static_cast<uint32_t>(data[position + 2U]);
+		uint32_t const hash = (prefix * 2654435761U) >> (32U - g_image_sequence_deflate_hash_bits);
+		size_t const candidate = hash_table[hash];
+		hash_table[hash] = static_cast<uint32_t>(position + 1U);
+
+		size_t match_length = 0U;
+		if (candidate > 0U && (position - (candidate - 1U)) <= g_image_sequence_deflate_window_size)
+		{
+			uint8_t const *const match = data + (candidate - 1U);
+			size_t const max_length = std::min(static_cast<size_t>(g_image_sequence_deflate_max_match), size - position);
+			while (match_length < max_length && match[match_length] == data[position + match_length])
+			{
+				++match_length;
+			}
+		}
+
+		if (match_length >= g_image_sequence_deflate_min_match)
+		{
+			uint32_t const length_symbol = table.length_symbols[match_length - 3U];
+			bit_writer.Put(table.literal_codes[257U + length_symbol], table.literal_code_lengths[257U + length_symbol]);
+			bit_writer.Put(static_cast<uint32_t>(match_length) - g_image_sequence_length_bases[length_symbol], g_image_sequence_length_extra_bits[length_symbol]);
+
+			uint32_t const distance = static_cast<uint32_t>(position - (candidate - 1U));
+			uint32_t const distance_symbol = static_cast<uint32_t>(std::upper_bound(g_image_sequence_distance_bases, g_image_sequence_distance_bases + 30, distance) - g_image_sequence_distance_bases) - 1U;
+			bit_writer.Put(table.distance_codes[distance_symbol], 5U);
+			bit_writer.Put(distance - g_image_sequence_distance_bases[distance_symbol], g_image_sequence_distance_extra_bits[distance_symbol]);
+
+			position += match_length;
+		}
+		else
+		{
+			bit_writer.Put(table.literal_codes[data[position]], table.literal_code_lengths[data[position]]);
+			++position;
+		}
+	}
+
+	// the last bytes (fewer than the minimum match)
+	for (; position < size; ++position)
+	{
+		bit_writer.Put(table.literal_codes[data[position]], table.literal_code_lengths[data[position]]);
+	}
+
+	// the end of the block
+	bit_writer.Put(table.literal_codes[256U], table.literal_code_lengths[256U]);
+	bit_writer.Finish();
+
+	// Adler-32 of the uncompressed data (the sums are reduced before they can overflow)
+	uint32_t adler_a = 1U;
+	uint32_t adler_b = 0U;
+	for (size_t begin = 0U; begin < size; begin += 5552U)
+	{
+		size_t const end = std::min(begin + 5552U, size);
+		for (size_t i = begin; i < end; ++i)
+		{
+			adler_a += data[i];
+			adler_b += adler_a;
+		}
+		adler_a %= 65521U;
+		adler_b %= 65521U;
+	}
+	uint8_t *cursor = image_sequence_store_u32_be(bit_writer.cursor, (adler_b << 16U) | adler_a);
+
+	return static_cast<size_t>(cursor - stream);
+}
+
+static uint32_t image_sequence_crc32(uint8_t const *data, size_t size, uint32_t crc)
+{
+	struct crc_table_t
+	{
+		uint32_t entries[256];
+	};
+	// initialized once (thread safe) by the first writer
+	static crc_table_t const table = []() {
+		crc_table_t crc_table;
+		for (uint32_t entry_index = 0U; entry_index < 256U; ++entry_index)
+		{
+			uint32_t value = entry_index;
+			for (uint32_t bit_index = 0U; bit_index < 8U; ++bit_index)
+			{
+				value = (value & 1U) ? (0XEDB88320U ^ (value >> 1U)) : (value >> 1U);
+			}
+			crc_table.entries[entry_index] = value;
+		}
+		return crc_table;
+	}();
+
+	crc = ~crc;
+	for (size_t i = 0U; i < size; ++i)
+	{
+		crc = table.entries[(crc ^ data[i]) & 0XFFU] ^ (crc >> 8U);
+	}
+	return ~crc;
+}
+
+static inline uint8_t *image_sequence_store_u32_be(uint8_t *cursor, uint32_t value)
+{
+	cursor[0] = static_cast<uint8_t>(value >> 24U);
+	cursor[1] = static_cast<uint8_t>(value >> 16U);
+	cursor[2] = static_cast<uint8_t>(value >> 8U);
+	cursor[3] = static_cast<uint8_t>(value);
+	return cursor + 4U;
+}
+
+static inline uint8_t *image_sequence_store_u32_le(uint8_t *cursor, uint32_t value)
+{
+	cursor[0] = static_cast<uint8_t>(value);
+	cursor[1] = static_cast<uint8_t>(value >> 8U);
+	cursor[2] = static_cast<uint8_t>(value >> 16U);
+	cursor[3] = static_cast<uint8_t>(value >> 24U);
+	return cursor + 4U;
+}
+
+static inline uint8_t *image_sequence_store_bytes(uint8_t *cursor, void const *data, size_t size)
+{
+	memcpy(cursor, data, size);
+	return cursor + size;
+}
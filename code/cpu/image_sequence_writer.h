@@ -0,0 +1,113 @@
+#ifndef _CPU_IMAGE_SEQUENCE_WRITER_H_
+#define _CPU_IMAGE_SEQUENCE_WRITER_H_ 1
+
+//
+// The output of the sequence of the rendered frames (e.g. the camera path of the offline render) into the files "<prefix><frame index>.<extension>".
+//
+// The "Write" only copies the radiance into the free slot of the bounded queue, the dedicated writer threads encode and write the queued frames,
+// such that the encoding and the I/O of the frame N overlap the rendering of the frame N + 1.
+// The "Write" blocks only while every slot is queued (the writers are behind), such that the memory is bounded by the "queue_length" frames.
+// The slots and the encoding buffers of each writer are allocated by the "Init", such that the steady state never allocates from the heap.
+//
+// EXR: RGB16F ("HALF"), the single part scanline image without compression (the radiance is clamped to the range of the half)
+// PFM: RGB32F
+// PNG: RGB8 of the tone mapping of the post process (see "tonemap_encoder.h"), the rows are filtered and compressed by the deflate of the fixed Huffman codes on the writer threads
+// BGRA: BGRA8 of the same tone mapping, the raw rows without any header (the same layout as the backbuffer of the CPU backend)
+//
+
+#include <stdint.h>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+enum image_sequence_format_t
+{
+	IMAGE_SEQUENCE_FORMAT_EXR = 0,
+	IMAGE_SEQUENCE_FORMAT_PFM = 1,
+	IMAGE_SEQUENCE_FORMAT_PNG = 2,
+	IMAGE_SEQUENCE_FORMAT_BGRA = 3
+};
+
+struct image_sequence_writer_statistics_t
+{
+	uint32_t written_frame_count;
+	uint32_t failed_frame_count;
+	uint64_t written_byte_count;
+	// the sum over the frames (on the writer threads)
+	double encode_milliseconds;
+	double io_milliseconds;
+	// the time of the "Write" blocked by the full queue (on the calling thread)
+	double stall_milliseconds;
+	uint32_t stall_count;
+};
+
+class ImageSequenceWriter
+{
+	struct slot_t
+	{
+		uint32_t frame_index;
+		// RGB32F, the row 0 is the top of the image
+		std::vector<float> radiance;
+	};
+
+	struct writer_t
+	{
+		std::thread thread;
+		// the encoded file
+		std::vector<uint8_t> file;
+		// PNG: the filtered rows and the hash table of the deflate
+		std::vector<uint8_t> filtered;
+		std::vector<uint32_t> hash_table;
+		// RGBA32F, the row expanded for the "TonemapEncodeRow", and its BGRA8 output
+		std::vector<float> row;
+		std::vector<uint8_t> display_row;
+	};
+
+	char m_path_prefix[256];
+	image_sequence_format_t m_format;
+	uint32_t m_width;
+	uint32_t m_height;
+
+	slot_t *m_slots;
+	uint32_t m_slot_count;
+	writer_t *m_writers;
+	uint32_t m_writer_count;
+
+	std::mutex m_mutex;
+	std::condition_variable m_queued_condition;
+	std::condition_variable m_free_condition;
+	// the slots which are free (the stack) and queued (the ring, in the order of the "Write")
+	std::vector<uint32_t> m_free_slots;
+	std::vector<uint32_t> m_queued_slots;
+	uint32_t m_queued_begin;
+	uint32_t m_queued_count;
+	bool m_quit;
+
+	image_sequence_writer_statistics_t m_statistics;
+
+	void WriterMain(uint32_t writer_index);
+	// [return] false if the file can NOT be written
+	bool WriteSlot(writer_t &writer, slot_t const &slot, double *encode_milliseconds, double *io_milliseconds);
+
+public:
+	// [in] path_prefix: e.g. "frames/shot_", the frame index of 5 digits and the extension are appended
+	// [in] queue_length: the frames which can be queued before the "Write" blocks, at least 1
+	// [in] writer_thread_count: at least 1
+	void Init(char const *path_prefix, image_sequence_format_t format, uint32_t width, uint32_t height, uint32_t queue_length, uint32_t writer_thread_count);
+	// the queued frames are written before the threads exit
+	void Destroy();
+
+	// [in] radiance: RGB32F of the "width" and the "height" of the "Init", the row 0 is the top of the image (the same as "SoftwareRenderer::GetRadiance")
+	void Write(uint32_t frame_index, float const *radiance);
+	// blocks until every queued frame is written
+	void Flush();
+
+	// [return] the extension of the format, e.g. "exr"
+	static char const *GetExtension(image_sequence_format_t format);
+
+	// consistent only after the "Flush"
+	image_sequence_writer_statistics_t const &GetStatistics() const;
+};
+
+#endif
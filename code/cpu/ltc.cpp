@@ -0,0 +1,639 @@
+#include <stdint.h>
+#include <assert.h>
+#include <cmath>
+#include <algorithm>
+
+#include "simd.h"
+
+#include "ltc.h"
+
+#include "../ltc_lut_data.h"
+
+static inline simd_float3 Diffuse_Burley(simd_float3 diffuse_color, simd_float roughness, simd_float NoV, simd_float NoL, simd_float VoH);
+
+static inline void ltc_lut_sample_bilinear(float const *lut_data, int channel_count, float lut_u, float lut_v, float *out_value);
+
+void LTC_DECODE_GGX_LUT(simd_float roughness, simd_float NoV, simd_float3x3 &linear_transform_inversed, simd_float &n_d_norm, simd_float &f_d_norm)
+{
+	static_assert((4U * 64U * 64U) == (sizeof(g_ltc_ggx_matrix_lut_data) / sizeof(g_ltc_ggx_matrix_lut_data[0])), "");
+	static_assert((2U * 64U * 64U) == (sizeof(g_ltc_ggx_norm_lut_data) / sizeof(g_ltc_ggx_norm_lut_data[0])), "");
+
+	// LUT_BIAS + LUT_SCALE * uv in texel space is exactly (LUT_SIZE - 1) * uv
+	float lut_u[4];
+	float lut_v[4];
+	_mm_storeu_ps(lut_u, saturate(roughness).v);
+	_mm_storeu_ps(lut_v, sqrt(simd_float(1.0f) - saturate(NoV)).v);
+
+	float matrix_lanes[4][4];
+	float norm_lanes[2][4];
+	for (int lane = 0; lane < 4; ++lane)
+	{
+		float ltc_ggx_matrix_lut_encoded[4];
+		ltc_lut_sample_bilinear(g_ltc_ggx_matrix_lut_data, 4, lut_u[lane], lut_v[lane], ltc_ggx_matrix_lut_encoded);
+
+		float ltc_ggx_norm_lut_encoded[2];
+		ltc_lut_sample_bilinear(g_ltc_ggx_norm_lut_data, 2, lut_u[lane], lut_v[lane], ltc_ggx_norm_lut_encoded);
+
+		for (int channel = 0; channel < 4; ++channel)
+		{
+			matrix_lanes[channel][lane] = ltc_ggx_matrix_lut_encoded[channel];
+		}
+
+		for (int channel = 0; channel < 2; ++channel)
+		{
+			norm_lanes[channel][lane] = ltc_ggx_norm_lut_encoded[channel];
+		}
+	}
+
+	simd_float m_x = _mm_loadu_ps(matrix_lanes[0]);
+	simd_float m_y = _mm_loadu_ps(matrix_lanes[1]);
+	simd_float m_z = _mm_loadu_ps(matrix_lanes[2]);
+	simd_float m_w = _mm_loadu_ps(matrix_lanes[3]);
+
+	linear_transform_inversed.r0 = simd_float3(m_x, simd_float(0.0f), m_z);
+	linear_transform_inversed.r1 = simd_float3(simd_float(0.0f), simd_float(1.0f), simd_float(0.0f));
+	linear_transform_inversed.r2 = simd_float3(m_y, simd_float(0.0f), m_w);
+
+	n_d_norm = _mm_loadu_ps(norm_lanes[0]);
+	f_d_norm = _mm_loadu_ps(norm_lanes[1]);
+}
+
+void EvaluateWorldToTangentTransform(simd_float3 P, simd_float3 N, simd_float3 V, simd_float3x3 &world_to_tangent_rotation)
+{
+	(void)P;
+
+	// The LUTs are precomputed by assuming that the outgoing direction V is in the XOY plane, since the GGX BRDF is isotropic.
+	simd_float3 T1 = normalize(V - N * dot(V, N));
+
+	simd_float3 T2 = cross(N, T1);
+
+	world_to_tangent_rotation.r0 = T1;
+	world_to_tangent_rotation.r1 = T2;
+	world_to_tangent_rotation.r2 = N;
+}
+
+simd_float EvaluateBRDFLTCLightAttenuation(simd_float3 P, simd_float3 const vertices_world_space[4])
+{
+	// front face: 1.0
+	// back face: 0.0
+	simd_float front_face = dot((vertices_world_space[0] - P), cross(vertices_world_space[1] - vertices_world_space[0], vertices_world_space[2] - vertices_world_space[0])) > simd_float(0.0f);
+	return (front_face & simd_float(1.0f));
+}
+
+simd_float EvaluateBRDFLTCLightHorizon(simd_float3 P, simd_float3 N, simd_float3 const vertices_world_space[4], simd_float &straddle_mask)
+{
+	// The same as the "z" of the vertices in tangent space.
+	simd_float above_0 = dot(N, vertices_world_space[0] - P) > simd_float(0.0f);
+	simd_float above_1 = dot(N, vertices_world_space[1] - P) > simd_float(0.0f);
+	simd_float above_2 = dot(N, vertices_world_space[2] - P) > simd_float(0.0f);
+	simd_float above_3 = dot(N, vertices_world_space[3] - P) > simd_float(0.0f);
+
+	simd_float any_above = above_0 | above_1 | above_2 | above_3;
+	simd_float all_above = above_0 & above_1 & above_2 & above_3;
+	straddle_mask = _mm_andnot_ps(all_above.v, any_above.v);
+	return any_above;
+}
+
+simd_float3 EvaluateBRDFLTC(simd_float3 diffuse_color, simd_float roughness, simd_float3 specular_color, simd_float3 P, simd_float3 N, simd_float3 V, simd_float3 const vertices_world_space[4])
+{
+	simd_float3 radiance = simd_float3_broadcast(0.0f, 0.0f, 0.0f);
+
+	// Transform the vertices to the tangent space of the current shading position.
+	simd_float3 vertices_tangent_space[4];
+	{
+		simd_float3x3 world_to_tangent_rotation;
+		EvaluateWorldToTangentTransform(P, N, V, world_to_tangent_rotation);
+
+		vertices_tangent_space[0] = mul(world_to_tangent_rotation, vertices_world_space[0] - P);
+		vertices_tangent_space[1] = mul(world_to_tangent_rotation, vertices_world_space[1] - P);
+		vertices_tangent_space[2] = mul(world_to_tangent_rotation, vertices_world_space[2] - P);
+		vertices_tangent_space[3] = mul(world_to_tangent_rotation, vertices_world_space[3] - P);
+	}
+
+	radiance = radiance + DiffuseBurleyLTC(diffuse_color, roughness, N, V, vertices_tangent_space);
+
+	radiance = radiance + DualSpecularGGXLTC(0.75f, 1.30f, 0.85f, 1.0f, roughness, specular_color, N, V, vertices_tangent_space);
+
+	return radiance;
+}
+
+simd_float EvaluateBRDFLTCDiskLightAttenuation(simd_float3 P, simd_float3 disk_center_world_space, simd_float3 disk_axis_0_world_space, simd_float3 disk_axis_1_world_space)
+{
+	// front face: 1.0
+	// back face: 0.0
+	simd_float front_face = dot((disk_center_world_space - P), cross(disk_axis_0_world_space, disk_axis_1_world_space)) > simd_float(0.0f);
+	return (front_face & simd_float(1.0f));
+}
+
+simd_float3 EvaluateBRDFLTCDisk(simd_float3 diffuse_color, simd_float roughness, simd_float3 specular_color, simd_float3 P, simd_float3 N, simd_float3 V, simd_float3 disk_center_world_space, simd_float3 disk_axis_0_world_space, simd_float3 disk_axis_1_world_space)
+{
+	simd_float3 radiance = simd_float3_broadcast(0.0f, 0.0f, 0.0f);
+
+	// Transform the disk to the tangent space of the current shading position.
+	simd_float3 disk_tangent_space[3];
+	{
+		simd_float3x3 world_to_tangent_rotation;
+		EvaluateWorldToTangentTransform(P, N, V, world_to_tangent_rotation);
+
+		disk_tangent_space[0] = mul(world_to_tangent_rotation, disk_center_world_space - P);
+		disk_tangent_space[1] = mul(world_to_tangent_rotation, disk_axis_0_world_space);
+		disk_tangent_space[2] = mul(world_to_tangent_rotation, disk_axis_1_world_space);
+	}
+
+	radiance = radiance + DiffuseBurleyLTCDisk(diffuse_color, roughness, N, V, disk_tangent_space);
+
+	radiance = radiance + DualSpecularGGXLTCDisk(0.75f, 1.30f, 0.85f, 1.0f, roughness, specular_color, N, V, disk_tangent_space);
+
+	return radiance;
+}
+
+simd_float3 EvaluateBRDFLTCSphere(simd_float3 diffuse_color, simd_float roughness, simd_float3 specular_color, simd_float3 P, simd_float3 N, simd_float3 V, simd_float3 sphere_center_world_space, simd_float sphere_radius)
+{
+	// The sphere is replaced by the silhouette disk as seen from the shading position, which subtends exactly the same solid angle.
+	// The disk always faces the shading position.
+	simd_float3 to_center = sphere_center_world_space - P;
+	simd_float distance_squared = max(dot(to_center, to_center), simd_float(1e-7f));
+	// The shading position is NOT allowed to be inside the sphere.
+	simd_float radius_squared = min(sphere_radius * sphere_radius, simd_float(0.999f) * distance_squared);
+
+	simd_float silhouette_scale = simd_float(1.0f) - radius_squared / distance_squared;
+	simd_float3 disk_center_world_space = P + to_center * silhouette_scale;
+	simd_float disk_radius = sqrt(radius_squared * silhouette_scale);
+
+	simd_float3 W = to_center * rsqrt(distance_squared);
+	simd_float use_y_up = abs(W.y) < simd_float(0.999f);
+	simd_float3 up = simd_float3(select(use_y_up, simd_float(0.0f), simd_float(1.0f)), select(use_y_up, simd_float(1.0f), simd_float(0.0f)), simd_float(0.0f));
+	simd_float3 T1 = normalize(cross(W, up));
+	simd_float3 T2 = cross(W, T1);
+
+	// cross(T1, T2) = W: the front face
+	return EvaluateBRDFLTCDisk(diffuse_color, roughness, specular_color, P, N, V, disk_center_world_space, T1 * disk_radius, T2 * disk_radius);
+}
+
+simd_float3 DiffuseBurleyLTC(simd_float3 diffuse_color, simd_float roughness, simd_float3 N, simd_float3 V, simd_float3 const vertices_tangent_space[4])
+{
+	simd_float3x3 identity;
+	identity.r0 = simd_float3_broadcast(1.0f, 0.0f, 0.0f);
+	identity.r1 = simd_float3_broadcast(0.0f, 1.0f, 0.0f);
+	identity.r2 = simd_float3_broadcast(0.0f, 0.0f, 1.0f);
+	simd_float3 vector_form_factor_over_quad = EvaluateVectorFormFactorOverQuadClipped(identity, vertices_tangent_space);
+	simd_float form_factor_over_quad = EvaluateFormFactorOverSphere(normalize(vector_form_factor_over_quad).z, sqrt(length(vector_form_factor_over_quad)));
+
+	// UE4: RectIrradianceLambert
+	simd_float3 L_tangent_space = normalize(vector_form_factor_over_quad);
+	simd_float NoL = form_factor_over_quad / length(vector_form_factor_over_quad);
+
+	// The tangent space is (T1, T2, N) and V is in the XOZ plane.
+	simd_float NoV = saturate(dot(N, V));
+	simd_float3 V_tangent_space = simd_float3(sqrt(simd_float(1.0f) - NoV * NoV), simd_float(0.0f), NoV);
+
+	simd_float3 H = normalize(V_tangent_space + L_tangent_space);
+	simd_float VoH = saturate(dot(V_tangent_space, H));
+
+	simd_float3 radiance_diffuse = Diffuse_Burley(diffuse_color, roughness, NoV, NoL, VoH) * (simd_float(SIMD_PI) * form_factor_over_quad);
+	return radiance_diffuse;
+}
+
+simd_float3 SpecularGGXLTC(simd_float roughness, simd_float3 specular_color, simd_float3 N, simd_float3 V, simd_float3 const vertices_tangent_space[4])
+{
+	simd_float3x3 linear_transform_inversed;
+	simd_float n_d_norm;
+	simd_float f_d_norm;
+	LTC_DECODE_GGX_LUT(roughness, saturate(dot(N, V)), linear_transform_inversed, n_d_norm, f_d_norm);
+
+	// LT "linear transform"
+	simd_float3 vector_form_factor_over_quad = EvaluateVectorFormFactorOverQuadClipped(linear_transform_inversed, vertices_tangent_space);
+	simd_float form_factor_over_quad = EvaluateFormFactorOverSphere(normalize(vector_form_factor_over_quad).z, sqrt(length(vector_form_factor_over_quad)));
+
+	// [Hill 2016] [Stephen Hill. "LTC Fresnel Approximation." SIGGRAPH 2016.](https://blog.selfshadow.com/publications/s2016-advances/)
+	simd_float3 radiance_specular = specular_color * (n_d_norm * form_factor_over_quad) + (simd_float3_broadcast(1.0f, 1.0f, 1.0f) - specular_color) * (f_d_norm * form_factor_over_quad);
+
+	return radiance_specular;
+}
+
+simd_float3 DualSpecularGGXLTC(float material_roughness_0, float material_roughness_1, float material_lobe_mix, float subsurface_mask, simd_float roughness, simd_float3 specular_color, simd_float3 N, simd_float3 V, simd_float3 const vertices_tangent_space[4])
+{
+	float material_roughness_average = material_roughness_0 + (material_roughness_1 - material_roughness_0) * material_lobe_mix;
+	float average_to_roughness_0 = material_roughness_0 / material_roughness_average;
+	float average_to_roughness_1 = material_roughness_1 / material_roughness_average;
+
+	simd_float surface_roughness_average = roughness;
+	simd_float surface_roughness_0 = max(saturate(simd_float(average_to_roughness_0) * surface_roughness_average), simd_float(0.02f));
+	simd_float surface_roughness_1 = saturate(simd_float(average_to_roughness_1) * surface_roughness_average);
+
+	// UE4: SubsurfaceProfileBxDF
+	float subsurface_weight = std::min(std::max(10.0f * subsurface_mask, 0.0f), 1.0f);
+	surface_roughness_0 = lerp(simd_float(1.0f), surface_roughness_0, simd_float(subsurface_weight));
+	surface_roughness_1 = lerp(simd_float(1.0f), surface_roughness_1, simd_float(subsurface_weight));
+
+	simd_float3 radiance_specular_0 = SpecularGGXLTC(surface_roughness_0, specular_color, N, V, vertices_tangent_space);
+	simd_float3 radiance_specular_1 = SpecularGGXLTC(surface_roughness_1, specular_color, N, V, vertices_tangent_space);
+	simd_float3 radiance_specular = lerp(radiance_specular_0, radiance_specular_1, simd_float(material_lobe_mix));
+	return radiance_specular;
+}
+
+simd_float3 DiffuseBurleyLTCDisk(simd_float3 diffuse_color, simd_float roughness, simd_float3 N, simd_float3 V, simd_float3 const disk_tangent_space[3])
+{
+	simd_float3 vector_form_factor_over_disk = EvaluateVectorFormFactorOverDisk(disk_tangent_space);
+	simd_float form_factor_over_disk = EvaluateFormFactorOverDisk(vector_form_factor_over_disk);
+
+	// UE4: RectIrradianceLambert
+	simd_float3 L_tangent_space = normalize(vector_form_factor_over_disk);
+	simd_float NoL = form_factor_over_disk / length(vector_form_factor_over_disk);
+
+	// The tangent space is (T1, T2, N) and V is in the XOZ plane.
+	simd_float NoV = saturate(dot(N, V));
+	simd_float3 V_tangent_space = simd_float3(sqrt(simd_float(1.0f) - NoV * NoV), simd_float(0.0f), NoV);
+
+	simd_float3 H = normalize(V_tangent_space + L_tangent_space);
+	simd_float VoH = saturate(dot(V_tangent_space, H));
+
+	simd_float3 radiance_diffuse = Diffuse_Burley(diffuse_color, roughness, NoV, NoL, VoH) * (simd_float(SIMD_PI) * form_factor_over_disk);
+	return radiance_diffuse;
+}
+
+simd_float3 SpecularGGXLTCDisk(simd_float roughness, simd_float3 specular_color, simd_float3 N, simd_float3 V, simd_float3 const disk_tangent_space[3])
+{
+	simd_float3x3 linear_transform_inversed;
+	simd_float n_d_norm;
+	simd_float f_d_norm;
+	LTC_DECODE_GGX_LUT(roughness, saturate(dot(N, V)), linear_transform_inversed, n_d_norm, f_d_norm);
+
+	// LT "linear transform"
+	// The disk is transformed to the ellipse (the linear transform preserves the center and the conjugate semi-axes).
+	simd_float3 disk_tangent_space_linear_transformed[3] = {
+		mul(linear_transform_inversed, disk_tangent_space[0]),
+		mul(linear_transform_inversed, disk_tangent_space[1]),
+		mul(linear_transform_inversed, disk_tangent_space[2])};
+
+	simd_float form_factor_over_disk = EvaluateFormFactorOverDisk(EvaluateVectorFormFactorOverDisk(disk_tangent_space_linear_transformed));
+
+	// [Hill 2016] [Stephen Hill. "LTC Fresnel Approximation." SIGGRAPH 2016.](https://blog.selfshadow.com/publications/s2016-advances/)
+	simd_float3 radiance_specular = specular_color * (n_d_norm * form_factor_over_disk) + (simd_float3_broadcast(1.0f, 1.0f, 1.0f) - specular_color) * (f_d_norm * form_factor_over_disk);
+
+	return radiance_specular;
+}
+
+simd_float3 DualSpecularGGXLTCDisk(float material_roughness_0, float material_roughness_1, float material_lobe_mix, float subsurface_mask, simd_float roughness, simd_float3 specular_color, simd_float3 N, simd_float3 V, simd_float3 const disk_tangent_space[3])
+{
+	float material_roughness_average = material_roughness_0 + (material_roughness_1 - material_roughness_0) * material_lobe_mix;
+	float average_to_roughness_0 = material_roughness_0 / material_roughness_average;
+	float average_to_roughness_1 = material_roughness_1 / material_roughness_average;
+
+	simd_float surface_roughness_average = roughness;
+	simd_float surface_roughness_0 = max(saturate(simd_float(average_to_roughness_0) * surface_roughness_average), simd_float(0.02f));
+	simd_float surface_roughness_1 = saturate(simd_float(average_to_roughness_1) * surface_roughness_average);
+
+	// UE4: SubsurfaceProfileBxDF
+	float subsurface_weight = std::min(std::max(10.0f * subsurface_mask, 0.0f), 1.0f);
+	surface_roughness_0 = lerp(simd_float(1.0f), surface_roughness_0, simd_float(subsurface_weight));
+	surface_roughness_1 = lerp(simd_float(1.0f), surface_roughness_1, simd_float(subsurface_weight));
+
+	simd_float3 radiance_specular_0 = SpecularGGXLTCDisk(surface_roughness_0, specular_color, N, V, disk_tangent_space);
+	simd_float3 radiance_specular_1 = SpecularGGXLTCDisk(surface_roughness_1, specular_color, N, V, disk_tangent_space);
+	simd_float3 radiance_specular = lerp(radiance_specular_0, radiance_specular_1, simd_float(material_lobe_mix));
+	return radiance_specular;
+}
+
+simd_float EvaluateFormFactorOverQuad(simd_float3 const vertices_tangent_space[4])
+{
+	// [Hill 2016] [Stephen Hill, Eric Heitz. "Real-Time Area Lighting: a Journey from Research to Production." SIGGRAPH 2016.](https://blog.selfshadow.com/publications/s2016-advances/)
+	// Theory & Implementation / 3. Clip Polygon to upper hemisphere
+
+	// The vector form factor can be calculated even if the quad id NOT horizon-clipped
+	simd_float3 vector_form_factor_over_quad = EvaluateVectorFormFactorOverQuad(vertices_tangent_space);
+
+	// Introduce the proxy sphere with the same vector form factor
+	simd_float cos_elevation_angle = normalize(vector_form_factor_over_quad).z;
+	simd_float sin_angular_extent = sqrt(length(vector_form_factor_over_quad));
+
+	simd_float form_factor_over_sphere = EvaluateFormFactorOverSphere(cos_elevation_angle, sin_angular_extent);
+
+	return form_factor_over_sphere;
+}
+
+simd_float3 EvaluateVectorFormFactorOverQuad(simd_float3 const vertices_tangent_space[4])
+{
+	// [Heitz 2017] [Eric Heitz. "Geometric Derivation of the Irradiance of Polygonal Lights." Technical report 2017.](https://hal.archives-ouvertes.fr/hal-01458129)
+
+	simd_float3 vertices_normalized[4] = {
+		normalize(vertices_tangent_space[0]),
+		normalize(vertices_tangent_space[1]),
+		normalize(vertices_tangent_space[2]),
+		normalize(vertices_tangent_space[3])};
+
+	simd_float3 vector_form_factor_over_quad = simd_float3_broadcast(0.0f, 0.0f, 0.0f);
+	vector_form_factor_over_quad = vector_form_factor_over_quad + EvaluateVectorFormFactorOverQuadEdge(vertices_normalized[0], vertices_normalized[1]);
+	vector_form_factor_over_quad = vector_form_factor_over_quad + EvaluateVectorFormFactorOverQuadEdge(vertices_normalized[1], vertices_normalized[2]);
+	vector_form_factor_over_quad = vector_form_factor_over_quad + EvaluateVectorFormFactorOverQuadEdge(vertices_normalized[2], vertices_normalized[3]);
+	vector_form_factor_over_quad = vector_form_factor_over_quad + EvaluateVectorFormFactorOverQuadEdge(vertices_normalized[3], vertices_normalized[0]);
+
+	return vector_form_factor_over_quad;
+}
+
+simd_float3 EvaluateVectorFormFactorOverQuadClipped(simd_float3x3 const &linear_transform_inversed, simd_float3 const vertices_tangent_space[4])
+{
+	// [Heitz 2016] [Eric Heitz, Jonathan Dupuy, Stephen Hill, David Neubelt. "Real-Time Polygonal-Light Shading with Linearly Transformed Cosines." SIGGRAPH 2016.](https://eheitzresearch.wordpress.com/415-2/)
+	// ClipQuadToHorizon
+
+	simd_float above[4] = {
+		vertices_tangent_space[0].z > simd_float(0.0f),
+		vertices_tangent_space[1].z > simd_float(0.0f),
+		vertices_tangent_space[2].z > simd_float(0.0f),
+		vertices_tangent_space[3].z > simd_float(0.0f)};
+
+	simd_float all_above = above[0] & above[1] & above[2] & above[3];
+
+	// fast path: the quad is entirely above the horizon in all lanes
+	if (all(all_above))
+	{
+		simd_float3 vertices_tangent_space_linear_transformed[4] = {
+			mul(linear_transform_inversed, vertices_tangent_space[0]),
+			mul(linear_transform_inversed, vertices_tangent_space[1]),
+			mul(linear_transform_inversed, vertices_tangent_space[2]),
+			mul(linear_transform_inversed, vertices_tangent_space[3])};
+
+		return EvaluateVectorFormFactorOverQuad(vertices_tangent_space_linear_transformed);
+	}
+
+	// The same as the HLSL: each edge is clipped independently and the horizon edge from the exit point to the entry point closes the clipped polygon.
+	// The lanes where the edge is entirely below the horizon are masked out.
+	simd_float3 vector_form_factor_over_quad = simd_float3_broadcast(0.0f, 0.0f, 0.0f);
+	simd_float3 exit_point = simd_float3_broadcast(0.0f, 0.0f, 0.0f);
+	simd_float3 entry_point = simd_float3_broadcast(0.0f, 0.0f, 0.0f);
+
+	for (int edge_index = 0; edge_index < 4; ++edge_index)
+	{
+		simd_float3 v1 = vertices_tangent_space[edge_index];
+		simd_float3 v2 = vertices_tangent_space[(edge_index + 1) & 3];
+		simd_float v1_above = above[edge_index];
+		simd_float v2_above = above[(edge_index + 1) & 3];
+		simd_float edge_above = v1_above | v2_above;
+
+		// only used if the edge straddles (the denominator is NOT zero)
+		simd_float edge_straddle = _mm_xor_ps(v1_above.v, v2_above.v);
+		simd_float3 horizon_point = v1 + (v2 - v1) * (v1.z / select(edge_straddle, v1.z - v2.z, simd_float(1.0f)));
+		horizon_point.z = simd_float(0.0f);
+
+		exit_point = select(_mm_andnot_ps(v2_above.v, v1_above.v), horizon_point, exit_point);
+		entry_point = select(_mm_andnot_ps(v1_above.v, v2_above.v), horizon_point, entry_point);
+
+		simd_float3 v1_clipped = select(v1_above, v1, horizon_point);
+		simd_float3 v2_clipped = select(v2_above, v2, horizon_point);
+		simd_float3 edge_vector_form_factor = EvaluateVectorFormFactorOverQuadEdge(normalize(mul(linear_transform_inversed, v1_clipped)), normalize(mul(linear_transform_inversed, v2_clipped)));
+		vector_form_factor_over_quad = vector_form_factor_over_quad + select(edge_above, edge_vector_form_factor, simd_float3_broadcast(0.0f, 0.0f, 0.0f));
+	}
+
+	// The horizon edge only exists in the lanes where the quad straddles the horizon.
+	simd_float quad_straddle = _mm_andnot_ps(all_above.v, (above[0] | above[1] | above[2] | above[3]).v);
+	simd_float3 horizon_vector_form_factor = EvaluateVectorFormFactorOverQuadEdge(normalize(mul(linear_transform_inversed, exit_point)), normalize(mul(linear_transform_inversed, entry_point)));
+	vector_form_factor_over_quad = vector_form_factor_over_quad + select(quad_straddle, horizon_vector_form_factor, simd_float3_broadcast(0.0f, 0.0f, 0.0f));
+
+	return vector_form_factor_over_quad;
+}
+
+simd_float3 EvaluateVectorFormFactorOverQuadEdge(simd_float3 v1, simd_float3 v2)
+{
+	// [Hill 2016] [Stephen Hill, Eric Heitz. "Real-Time Area Lighting: a Journey from Research to Production." SIGGRAPH 2016.](https://blog.selfshadow.com/publications/s2016-advances/)
+	// Theory & Implementation / 4. Compute edge intergrals
+
+	// cubic rational fit
+	// theta_sintheta ≈ (acos(dot(v1, v2)) * (1 / sin(acos(dot(v1, v2)))) * (1 / 2PI))
+	simd_float x = dot(v1, v2);
+	simd_float y = abs(x);
+
+	// (1 / 2PI) has been multiplied here
+	simd_float a = simd_float(0.8543985f) + (simd_float(0.4965155f) + simd_float(0.0145206f) * y) * y;
+	simd_float b = simd_float(3.4175940f) + (simd_float(4.1616724f) + y) * y;
+	simd_float v = a / b;
+
+	simd_float theta_sintheta = select(x > simd_float(0.0f), v, simd_float(0.5f) * rsqrt(max(simd_float(1.0f) - x * x, simd_float(1e-7f))) - v);
+
+	return cross(v1, v2) * theta_sintheta;
+}
+
+simd_float EvaluateFormFactorOverSphere(simd_float cos_omega, simd_float sin_sigma)
+{
+	// [Snyder 1996]. [John Snyder. "Area Light Sources for Real-Time Graphics." Technical Report 1996.](https://www.microsoft.com/en-us/research/publication/area-light-sources-for-real-time-graphics/)
+
+	// Unity3D: PolygonIrradianceFromVectorFormFactor
+	simd_float sin_sigma_2 = sin_sigma * sin_sigma;
+	// The fit is negative if the proxy sphere is below the horizon (the surface faces away from the light).
+	simd_float form_factor_over_sphere = max(sin_sigma_2 * (sin_sigma_2 + cos_omega) / (sin_sigma_2 + simd_float(1.0f)), simd_float(0.0f));
+
+	return form_factor_over_sphere;
+}
+
+simd_float EvaluateFormFactorOverDisk(simd_float3 vector_form_factor_over_disk)
+{
+	// The same as the quad: the horizon-clipping is approximated by the proxy sphere with the same vector form factor
+	simd_float cos_elevation_angle = normalize(vector_form_factor_over_disk).z;
+	simd_float sin_angular_extent = sqrt(length(vector_form_factor_over_disk));
+
+	simd_float form_factor_over_sphere = EvaluateFormFactorOverSphere(cos_elevation_angle, sin_angular_extent);
+
+	return form_factor_over_sphere;
+}
+
+simd_float3 EvaluateVectorFormFactorOverDisk(simd_float3 const disk_tangent_space[3])
+{
+	// [Heitz 2017] [Eric Heitz, Stephen Hill. "Real-Time Line- and Disk-Light Shading." SIGGRAPH 2017.](https://blog.selfshadow.com/publications/s2017-shading-course/)
+	// The solid angle subtended by the ellipse is an elliptic cone, which is symmetric with respect to the average direction.
+
+	simd_float3 C = disk_tangent_space[0];
+	simd_float3 V1 = disk_tangent_space[1];
+	simd_float3 V2 = disk_tangent_space[2];
+
+	// The conjugate semi-axes are NOT necessarily orthogonal after the linear transform.
+	// Find the principal axes by the eigen decomposition.
+	// Both branches of the HLSL version are evaluated and the result is selected per lane.
+	simd_float a;
+	simd_float b;
+	{
+		simd_float d11 = dot(V1, V1);
+		simd_float d22 = dot(V2, V2);
+		simd_float d12 = dot(V1, V2);
+
+		simd_float non_orthogonal = (abs(d12) * rsqrt(d11 * d22)) > simd_float(0.0001f);
+
+		simd_float tr = d11 + d22;
+		simd_float det = sqrt(max(-d12 * d12 + d11 * d22, simd_float(0.0f)));
+
+		// use sqrt matrix to solve for eigenvalues
+		simd_float u = simd_float(0.5f) * sqrt(max(tr - simd_float(2.0f) * det, simd_float(0.0f)));
+		simd_float v = simd_float(0.5f) * sqrt(tr + simd_float(2.0f) * det);
+		simd_float e_max = (u + v) * (u + v);
+		simd_float e_min = (u - v) * (u - v);
+
+		simd_float d11_greater = d11 > d22;
+		simd_float3 V_major = select(d11_greater, V1, V2);
+		simd_float3 V_minor = select(d11_greater, V2, V1);
+		simd_float d_major = select(d11_greater, d11, d22);
+
+		simd_float3 V1_ = d12 * V_major + (e_max - d_major) * V_minor;
+		simd_float3 V2_ = d12 * V_major + (e_min - d_major) * V_minor;
+
+		simd_float a_orthogonal = simd_float(1.0f) / d11;
+		simd_float b_orthogonal = simd_float(1.0f) / d22;
+
+		a = select(non_orthogonal, simd_float(1.0f) / e_max, a_orthogonal);
+		b = select(non_orthogonal, simd_float(1.0f) / e_min, b_orthogonal);
+		V1 = select(non_orthogonal, normalize(V1_), V1 * sqrt(a_orthogonal));
+		V2 = select(non_orthogonal, normalize(V2_), V2 * sqrt(b_orthogonal));
+	}
+
+	simd_float3 V3 = cross(V1, V2);
+	V3 = select(dot(C, V3) < simd_float(0.0f), -V3, V3);
+
+	// The distance from the origin to the plane of the ellipse
+	simd_float L = max(dot(V3, C), simd_float(1e-7f));
+	simd_float x0 = dot(V1, C) / L;
+	simd_float y0 = dot(V2, C) / L;
+
+	a = a * (L * L);
+	b = b * (L * L);
+
+	// The eigenvalues of the cone
+	simd_float c0 = a * b;
+	simd_float c1 = a * b * (simd_float(1.0f) + x0 * x0 + y0 * y0) - a - b;
+	simd_float c2 = simd_float(1.0f) - a * (simd_float(1.0f) + x0 * x0) - b * (simd_float(1.0f) + y0 * y0);
+	simd_float c3 = simd_float(1.0f);
+
+	simd_float3 roots;
+	SolveCubic(c0, c1, c2, c3, roots);
+	simd_float e1 = roots.x;
+	simd_float e2 = roots.y;
+	simd_float e3 = roots.z;
+
+	simd_float3 average_direction = normalize(V1 * (a * x0 / (a - e2)) + V2 * (b * y0 / (b - e2)) + V3);
+
+	simd_float L1 = sqrt(-e2 / e3);
+	simd_float L2 = sqrt(-e2 / e1);
+
+	// The form factor of the elliptic cone without horizon-clipping
+	simd_float form_factor_over_disk = L1 * L2 * rsqrt((simd_float(1.0f) + L1 * L1) * (simd_float(1.0f) + L2 * L2));
+
+	return average_direction * form_factor_over_disk;
+}
+
+void SolveCubic(simd_float c0, simd_float c1, simd_float c2, simd_float c3, simd_float3 &roots)
+{
+	// [Blinn 2007] [James F. Blinn. "How to Solve a Cubic Equation, Part 5: Back to Numerics." IEEE Computer Graphics and Applications 2007.](https://ieeexplore.ieee.org/document/4178165)
+
+	// Normalize the polynomial
+	// Divide middle coefficients by three
+	simd_float A = c3;
+	simd_float B = c2 / c3 / simd_float(3.0f);
+	simd_float C = c1 / c3 / simd_float(3.0f);
+	simd_float D = c0 / c3;
+
+	// Compute the Hessian and the discriminant
+	simd_float delta_x = -B * B + C;
+	simd_float delta_y = -C * B + D;
+	simd_float delta_z = B * D - C * C;
+
+	simd_float discriminant = simd_float(4.0f) * delta_x * delta_z - delta_y * delta_y;
+	simd_float sqrt_discriminant = sqrt(max(discriminant, simd_float(0.0f)));
+
+	// Algorithm A
+	simd_float xlc_x;
+	simd_float xlc_y;
+	{
+		simd_float C_a = delta_x;
+		simd_float D_a = simd_float(-2.0f) * B * delta_x + delta_y;
+
+		// Take the cubic root of a normalized complex number
+		simd_float theta = atan2(sqrt_discriminant, -D_a) / simd_float(3.0f);
+
+		simd_float sqrt_C_a = sqrt(max(-C_a, simd_float(0.0f)));
+		simd_float x_1a = simd_float(2.0f) * sqrt_C_a * cos(theta);
+		simd_float x_3a = simd_float(2.0f) * sqrt_C_a * cos(theta + simd_float((2.0f / 3.0f) * SIMD_PI));
+
+		simd_float xl = select((x_1a + x_3a) > simd_float(2.0f) * B, x_1a, x_3a);
+
+		xlc_x = xl - B;
+		xlc_y = A;
+	}
+
+	// Algorithm D
+	simd_float xsc_x;
+	simd_float xsc_y;
+	{
+		simd_float C_d = delta_z;
+		simd_float D_d = -D * delta_y + simd_float(2.0f) * C * delta_z;
+
+		// Take the cubic root of a normalized complex number
+		simd_float theta = atan2(D * sqrt_discriminant, -D_d) / simd_float(3.0f);
+
+		simd_float sqrt_C_d = sqrt(max(-C_d, simd_float(0.0f)));
+		simd_float x_1d = simd_float(2.0f) * sqrt_C_d * cos(theta);
+		simd_float x_3d = simd_float(2.0f) * sqrt_C_d * cos(theta + simd_float((2.0f / 3.0f) * SIMD_PI));
+
+		simd_float xs = select((x_1d + x_3d) < simd_float(2.0f) * C, x_1d, x_3d);
+
+		xsc_x = -D;
+		xsc_y = xs + C;
+	}
+
+	simd_float E = xlc_y * xsc_y;
+	simd_float F = -xlc_x * xsc_y - xlc_y * xsc_x;
+	simd_float G = xlc_x * xsc_x;
+
+	simd_float xmc_x = C * F - B * G;
+	simd_float xmc_y = -B * F + C * E;
+
+	simd_float root_x = xsc_x / xsc_y;
+	simd_float root_y = xmc_x / xmc_y;
+	simd_float root_z = xlc_x / xlc_y;
+
+	// root.xyz = root.yxz
+	simd_float swap_xy = (root_x < root_y) & (root_x < root_z);
+	// root.xyz = root.xzy
+	simd_float swap_yz = (root_z < root_x) & (root_z < root_y);
+
+	roots.x = select(swap_xy, root_y, root_x);
+	roots.y = select(swap_xy, root_x, select(swap_yz, root_z, root_y));
+	roots.z = select(swap_yz, root_y, root_z);
+}
+
+static inline simd_float3 Diffuse_Burley(simd_float3 diffuse_color, simd_float roughness, simd_float NoV, simd_float NoL, simd_float VoH)
+{
+	// [Burley 2012, "Physically-Based Shading at Disney"]
+	simd_float one_minus_NoV = simd_float(1.0f) - NoV;
+	simd_float one_minus_NoL = simd_float(1.0f) - NoL;
+	simd_float pow5_NoV = one_minus_NoV * one_minus_NoV * one_minus_NoV * one_minus_NoV * one_minus_NoV;
+	simd_float pow5_NoL = one_minus_NoL * one_minus_NoL * one_minus_NoL * one_minus_NoL * one_minus_NoL;
+
+	simd_float FD90 = simd_float(0.5f) + simd_float(2.0f) * VoH * VoH * roughness;
+	simd_float FdV = simd_float(1.0f) + (FD90 - simd_float(1.0f)) * pow5_NoV;
+	simd_float FdL = simd_float(1.0f) + (FD90 - simd_float(1.0f)) * pow5_NoL;
+	return diffuse_color * (simd_float(1.0f / SIMD_PI) * FdV * FdL);
+}
+
+static inline void ltc_lut_sample_bilinear(float const *lut_data, int channel_count, float lut_u, float lut_v, float *out_value)
+{
+	constexpr int const LUT_SIZE = 64;
+
+	float texel_x = lut_u * static_cast<float>(LUT_SIZE - 1);
+	float texel_y = lut_v * static_cast<float>(LUT_SIZE - 1);
+
+	int x0 = std::min(std::max(static_cast<int>(texel_x), 0), LUT_SIZE - 1);
+	int y0 = std::min(std::max(static_cast<int>(texel_y), 0), LUT_SIZE - 1);
+	int x1 = std::min(x0 + 1, LUT_SIZE - 1);
+	int y1 = std::min(y0 + 1, LUT_SIZE - 1);
+
+	float fx = texel_x - static_cast<float>(x0);
+	float fy = texel_y - static_cast<float>(y0);
+
+	for (int channel = 0; channel < channel_count; ++channel)
+	{
+		float v00 = lut_data[(LUT_SIZE * y0 + x0) * channel_count + channel];
+		float v10 = lut_data[(LUT_SIZE * y0 + x1) * channel_count + channel];
+		float v01 = lut_data[(LUT_SIZE * y1 + x0) * channel_count + channel];
+		float v11 = lut_data[(LUT_SIZE * y1 + x1) * channel_count + channel];
+
+		float v0 = v00 + (v10 - v00) * fx;
+		float v1 = v01 + (v11 - v01) * fx;
+		out_value[channel] = v0 + (v1 - v0) * fy;
+	}
+}
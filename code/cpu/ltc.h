@@ -0,0 +1,106 @@
+#ifndef _CPU_LTC_H_
+#define _CPU_LTC_H_ 1
+
+//
+// The CPU port of "shaders/LTC.hlsli".
+// The functions have the same names and the same parameters as the HLSL functions, except that each lane of the "simd_float" is an independent shading position.
+//
+
+#include "simd.h"
+
+// The LUTs are sampled from "ltc_lut_data.h" with the bilinear filter (the same as the "ltc_lut_sampler").
+void LTC_DECODE_GGX_LUT(simd_float roughness, simd_float NoV, simd_float3x3 &linear_transform_inversed, simd_float &n_d_norm, simd_float &f_d_norm);
+
+// [in] P: The surface position in world space.
+// [in] N: The surface normal in world space.
+// [in] V: The outgoing direction in world space.
+// [out] world_to_tangent_rotation: the rows are (T1, T2, N), the position X is transformed by "mul(world_to_tangent_rotation, X - P)"
+void EvaluateWorldToTangentTransform(simd_float3 P, simd_float3 N, simd_float3 V, simd_float3x3 &world_to_tangent_rotation);
+
+// [in] P: The surface position in world space.
+// [in] vertices_world_space: The vertices of the quad in world space. The facing of the quad is determined by the winding order of the vertices.
+simd_float EvaluateBRDFLTCLightAttenuation(simd_float3 P, simd_float3 const vertices_world_space[4]);
+
+// [in] P: The surface position in world space.
+// [in] N: The surface normal in world space.
+// [in] vertices_world_space: The vertices of the quad in world space.
+// [out] straddle_mask: the lanes where the quad straddles the horizon (the tangent plane) of the surface position and is clipped by the "EvaluateBRDFLTC"
+// return: the mask of the lanes where any vertex is above the horizon (the "EvaluateBRDFLTC" is NOT necessary for the other lanes)
+// The "int" of the HLSL is split into the masks (LTC_HORIZON_ABOVE: return & ~straddle_mask, LTC_HORIZON_STRADDLE: straddle_mask, LTC_HORIZON_BELOW: ~return).
+simd_float EvaluateBRDFLTCLightHorizon(simd_float3 P, simd_float3 N, simd_float3 const vertices_world_space[4], simd_float &straddle_mask);
+
+// [in] P: The surface position in world space.
+// [in] N: The surface normal in world space.
+// [in] V: The outgoing direction in world space.
+// [in] vertices_world_space: The vertices of the quad in world space. The facing of the quad is determined by the winding order of the vertices.
+simd_float3 EvaluateBRDFLTC(simd_float3 diffuse_color, simd_float roughness, simd_float3 specular_color, simd_float3 P, simd_float3 N, simd_float3 V, simd_float3 const vertices_world_space[4]);
+
+// [in] P: The surface position in world space.
+// [in] disk_center_world_space: The center of the disk (ellipse) in world space.
+// [in] disk_axis_0_world_space: The first semi-axis of the disk (ellipse) in world space.
+// [in] disk_axis_1_world_space: The second semi-axis of the disk (ellipse) in world space. The facing of the disk is determined by the order of the axes (the same as the winding order of the quad).
+simd_float EvaluateBRDFLTCDiskLightAttenuation(simd_float3 P, simd_float3 disk_center_world_space, simd_float3 disk_axis_0_world_space, simd_float3 disk_axis_1_world_space);
+
+// [in] P: The surface position in world space.
+// [in] N: The surface normal in world space.
+// [in] V: The outgoing direction in world space.
+// [in] disk_center_world_space: The center of the disk (ellipse) in world space.
+// [in] disk_axis_0_world_space: The first semi-axis of the disk (ellipse) in world space.
+// [in] disk_axis_1_world_space: The second semi-axis of the disk (ellipse) in world space. The facing of the disk is determined by the order of the axes (the same as the winding order of the quad).
+simd_float3 EvaluateBRDFLTCDisk(simd_float3 diffuse_color, simd_float roughness, simd_float3 specular_color, simd_float3 P, simd_float3 N, simd_float3 V, simd_float3 disk_center_world_space, simd_float3 disk_axis_0_world_space, simd_float3 disk_axis_1_world_space);
+
+// [in] P: The surface position in world space.
+// [in] N: The surface normal in world space.
+// [in] V: The outgoing direction in world space.
+// [in] sphere_center_world_space: The center of the sphere in world space.
+// [in] sphere_radius: The radius of the sphere.
+simd_float3 EvaluateBRDFLTCSphere(simd_float3 diffuse_color, simd_float roughness, simd_float3 specular_color, simd_float3 P, simd_float3 N, simd_float3 V, simd_float3 sphere_center_world_space, simd_float sphere_radius);
+
+// [in] vertices_tangent_space: The vertices of the quad in tangent space. The facing of the quad is determined by the winding order of the vertices.
+simd_float3 DiffuseBurleyLTC(simd_float3 diffuse_color, simd_float roughness, simd_float3 N, simd_float3 V, simd_float3 const vertices_tangent_space[4]);
+
+// [in] vertices_tangent_space: The vertices of the quad in tangent space. The facing of the quad is determined by the winding order of the vertices.
+simd_float3 SpecularGGXLTC(simd_float roughness, simd_float3 specular_color, simd_float3 N, simd_float3 V, simd_float3 const vertices_tangent_space[4]);
+
+// [in] vertices_tangent_space: The vertices of the quad in tangent space. The facing of the quad is determined by the winding order of the vertices.
+simd_float3 DualSpecularGGXLTC(float material_roughness_0, float material_roughness_1, float material_lobe_mix, float subsurface_mask, simd_float roughness, simd_float3 specular_color, simd_float3 N, simd_float3 V, simd_float3 const vertices_tangent_space[4]);
+
+// [in] disk_tangent_space: The center, the first semi-axis and the second semi-axis of the disk in tangent space.
+simd_float3 DiffuseBurleyLTCDisk(simd_float3 diffuse_color, simd_float roughness, simd_float3 N, simd_float3 V, simd_float3 const disk_tangent_space[3]);
+
+// [in] disk_tangent_space: The center, the first semi-axis and the second semi-axis of the disk in tangent space.
+simd_float3 SpecularGGXLTCDisk(simd_float roughness, simd_float3 specular_color, simd_float3 N, simd_float3 V, simd_float3 const disk_tangent_space[3]);
+
+// [in] disk_tangent_space: The center, the first semi-axis and the second semi-axis of the disk in tangent space.
+simd_float3 DualSpecularGGXLTCDisk(float material_roughness_0, float material_roughness_1, float material_lobe_mix, float subsurface_mask, simd_float roughness, simd_float3 specular_color, simd_float3 N, simd_float3 V, simd_float3 const disk_tangent_space[3]);
+
+// [in] vertices_tangent_space: The vertices of the quad in tangent space. The facing of the quad is determined by the winding order of the vertices.
+simd_float EvaluateFormFactorOverQuad(simd_float3 const vertices_tangent_space[4]);
+
+// [in] vertices_tangent_space: The vertices of the quad in tangent space. The facing of the quad is determined by the winding order of the vertices.
+simd_float3 EvaluateVectorFormFactorOverQuad(simd_float3 const vertices_tangent_space[4]);
+
+// [in] linear_transform_inversed: The inverse of the LTC matrix. The identity matrix means the clamped cosine distribution.
+// [in] vertices_tangent_space: The vertices of the quad in tangent space (NOT linear transformed). The facing of the quad is determined by the winding order of the vertices.
+// The quad is clipped to the upper hemisphere in tangent space before the linear transform, the result is in the linear transformed space.
+simd_float3 EvaluateVectorFormFactorOverQuadClipped(simd_float3x3 const &linear_transform_inversed, simd_float3 const vertices_tangent_space[4]);
+
+// [in] v1: The first normalized vertex which is projected onto the sphere. The facing of the quad is determined by the winding order of the vertices.
+// [in] v2: The second normalized vertex which is projected onto the sphere. The facing of the quad is determined by the winding order of the vertices.
+simd_float3 EvaluateVectorFormFactorOverQuadEdge(simd_float3 v1, simd_float3 v2);
+
+// [in] cos_elevation_angle : implies the direction of the vector irrandiance of the sphere proxy
+// [in] sin_angular_extent : implies the length of the vector irrandiance of the sphere proxy
+simd_float EvaluateFormFactorOverSphere(simd_float cos_elevation_angle, simd_float sin_angular_extent);
+
+// [in] vector_form_factor_over_disk: The "EvaluateVectorFormFactorOverDisk" of the disk (ellipse), which the caller may also use (e.g. the direction of the diffuse), such that it is computed once.
+simd_float EvaluateFormFactorOverDisk(simd_float3 vector_form_factor_over_disk);
+
+// [in] disk_tangent_space: The center, the first semi-axis and the second semi-axis of the disk (ellipse) in tangent space.
+simd_float3 EvaluateVectorFormFactorOverDisk(simd_float3 const disk_tangent_space[3]);
+
+// [in] c0, c1, c2, c3: c0 + c1·x + c2·x² + c3·x³ = 0
+// [out] roots: The three real roots (the middle root is the "y" component).
+void SolveCubic(simd_float c0, simd_float c1, simd_float c2, simd_float c3, simd_float3 &roots);
+
+#endif
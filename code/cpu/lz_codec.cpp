@@ -0,0 +1,192 @@
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+
+#include "lz_codec.h"
+
+static inline uint32_t lz_load_u32(uint8_t const *source);
+
+static inline uint32_t lz_hash(uint32_t sequence);
+
+// the count of the nibble and its extension bytes
+static inline uint8_t *lz_store_length(uint8_t *cursor, uint32_t length);
+
+// [return] false if the extension runs beyond the "end"
+static inline bool lz_load_length(uint8_t const **cursor, uint8_t const *end, uint32_t *length);
+
+uint32_t LZCompressBound(uint32_t source_size)
+{
+	// the incompressible source: a single sequence of the literals, the extension adds a byte per 255 literals
+	return source_size + (source_size / 255U) + 16U;
+}
+
+uint32_t LZCompress(uint8_t const *source, uint32_t source_size, uint8_t *destination, uint32_t *hash_table)
+{
+	uint8_t *cursor = destination;
+
+	uint32_t anchor = 0U;
+	uint32_t position = 0U;
+	// the step grows by 1 per 64 positions without any match (the noise is NOT searched at every byte)
+	uint32_t miss_count = 0U;
+	while ((position + LZ_MIN_MATCH) <= source_size)
+	{
+		uint32_t const sequence = lz_load_u32(source + position);
+		uint32_t const hash = lz_hash(sequence);
+		uint32_t const candidate = hash_table[hash];
+		hash_table[hash] = position;
+
+		if (candidate < position && (position - candidate) <= LZ_MAX_OFFSET && lz_load_u32(source + candidate) == sequence)
+		{
+			uint32_t match_length = LZ_MIN_MATCH;
+			while ((position + match_length) < source_size && source[candidate + match_length] == source[position + match_length])
+			{
+				++match_length;
+			}
+
+			uint32_t const literal_count = position - anchor;
+			uint8_t *const token = cursor++;
+			(*token) = static_cast<uint8_t>(((literal_count < 15U) ? literal_count : 15U) << 4U);
+			if (literal_count >= 15U)
+			{
+				cursor = lz_store_length(cursor, literal_count - 15U);
+			}
+			memcpy(cursor, source + anchor, literal_count);
+			cursor += literal_count;
+
+			uint32_t const offset = position - candidate;
+			cursor[0] = static_cast<uint8_t>(offset & 0XFFU);
+			cursor[1] = static_cast<uint8_t>(offset >> 8U);
+			cursor += 2U;
+
+			uint32_t const match_code = match_length - LZ_MIN_MATCH;
+			(*token) |= static_cast<uint8_t>((match_code < 15U) ? match_code : 15U);
+			if (match_code >= 15U)
+			{
+				cursor = lz_store_length(cursor, match_code - 15U);
+			}
+
+			position += match_length;
+			anchor = position;
+			miss_count = 0U;
+		}
+		else
+		{
+			position += 1U + (miss_count >> 6U);
+			++miss_count;
+		}
+	}
+
+	// the last sequence: the literals only
+	{
+		uint32_t const literal_count = source_size - anchor;
+		(*cursor++) = static_cast<uint8_t>(((literal_count < 15U) ? literal_count : 15U) << 4U);
+		if (literal_count >= 15U)
+		{
+			cursor = lz_store_length(cursor, literal_count - 15U);
+		}
+		memcpy(cursor, source + anchor, literal_count);
+		cursor += literal_count;
+	}
+
+	assert(static_cast<uint32_t>(cursor - destination) <= LZCompressBound(source_size));
+	return static_cast<uint32_t>(cursor - destination);
+}
+
+bool LZDecompress(uint8_t const *source, uint32_t source_size, uint8_t *destination, uint32_t destination_size)
+{
+	uint8_t const *cursor = source;
+	uint8_t const *const end = source + source_size;
+	uint32_t position = 0U;
+
+	while (cursor < end)
+	{
+		uint8_t const token = (*cursor++);
+
+		uint32_t literal_count = token >> 4U;
+		if (15U == literal_count && !lz_load_length(&cursor, end, &literal_count))
+		{
+			return false;
+		}
+		if (literal_count > static_cast<uint32_t>(end - cursor) || literal_count > (destination_size - position))
+		{
+			return false;
+		}
+		memcpy(destination + position, cursor, literal_count);
+		cursor += literal_count;
+		position += literal_count;
+
+		// the last sequence
+		if (cursor == end)
+		{
+			break;
+		}
+
+		if ((end - cursor) < 2)
+		{
+			return false;
+		}
+		uint32_t const offset = static_cast<uint32_t>(cursor[0]) | (static_cast<uint32_t>(cursor[1]) << 8U);
+		cursor += 2U;
+
+		uint32_t match_length = token & 0XFU;
+		if (15U == match_length && !lz_load_length(&cursor, end, &match_length))
+		{
+			return false;
+		}
+		match_length += LZ_MIN_MATCH;
+
+		if (0U == offset || offset > position || match_length > (destination_size - position))
+		{
+			return false;
+		}
+
+		// the match may overlap itself (the run of the short period), such that the bytes are copied one by one
+		uint8_t *const match_destination = destination + position;
+		uint8_t const *const match_source = match_destination - offset;
+		for (uint32_t i = 0U; i < match_length; ++i)
+		{
+			match_destination[i] = match_source[i];
+		}
+		position += match_length;
+	}
+
+	return (position == destination_size);
+}
+
+static inline uint32_t lz_load_u32(uint8_t const *source)
+{
+	uint32_t value;
+	memcpy(&value, source, sizeof(uint32_t));
+	return value;
+}
+
+static inline uint32_t lz_hash(uint32_t sequence)
+{
+	return (sequence * 2654435761U) >> (32U - LZ_HASH_BITS);
+}
+
+static inline uint8_t *lz_store_length(uint8_t *cursor, uint32_t length)
+{
+	while (length >= 255U)
+	{
+		(*cursor++) = 255U;
+		length -= 255U;
+	}
+	(*cursor++) = static_cast<uint8_t>(length);
+	return cursor;
+}
+
+static inline bool lz_load_length(uint8_t const **cursor, uint8_t const *end, uint32_t *length)
+{
+	uint8_t value;
+	do
+	{
+		if ((*cursor) >= end)
+		{
+			return false;
+		}
+		value = *((*cursor)++);
+		(*length) += value;
+	} while (255U == value);
+	return true;
+}
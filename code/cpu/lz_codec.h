@@ -0,0 +1,31 @@
+#ifndef _CPU_LZ_CODEC_H_
+#define _CPU_LZ_CODEC_H_ 1
+
+//
+// The fast LZ77 of the byte oriented sequences (the same scheme as the LZ4 block, NOT compatible with it), used where the speed matters more than the ratio (e.g. the tiles of "tile_delta.h").
+//
+// Each sequence: the token (the high 4 bits: the literal count, the low 4 bits: the match length - LZ_MIN_MATCH, 15 means that the bytes follow, each adds up to 255),
+// the literals, the 2-byte offset (little endian) and the extension of the match length. The last sequence has the literals only (the source ends after them).
+// The match is found by the hash table of the 4-byte prefixes (the latest position of each prefix only), the step grows over the incompressible run.
+//
+
+#include <stdint.h>
+
+static const uint32_t LZ_MIN_MATCH = 4U;
+static const uint32_t LZ_MAX_OFFSET = 65535U;
+static const uint32_t LZ_HASH_BITS = 12U;
+// the entries of the "hash_table" of the "LZCompress"
+static const uint32_t LZ_HASH_TABLE_SIZE = 1U << LZ_HASH_BITS;
+
+// the maximum size of the compressed "source_size" bytes
+uint32_t LZCompressBound(uint32_t source_size);
+
+// [in] hash_table: LZ_HASH_TABLE_SIZE entries, neither initialized nor cleared (the stale entries are rejected by the comparison)
+// [out] destination: at least the "LZCompressBound" bytes
+// [return] the compressed size
+uint32_t LZCompress(uint8_t const *source, uint32_t source_size, uint8_t *destination, uint32_t *hash_table);
+
+// [return] false if the source is corrupted or does NOT decompress into exactly the "destination_size" bytes
+bool LZDecompress(uint8_t const *source, uint32_t source_size, uint8_t *destination, uint32_t destination_size);
+
+#endif
@@ -0,0 +1,332 @@
+#if defined(_WIN32)
+#include <sdkddkver.h>
+#define WIN32_LEAN_AND_MEAN 1
+#define NOMINMAX 1
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <new>
+#include <atomic>
+#include <algorithm>
+
+#include "shared_framebuffer.h"
+
+// [return] the mapping of the "size" bytes, NULL if failed
+static uint8_t *shared_framebuffer_map(char const *name, uint64_t size, bool create, uint64_t *mapped_size);
+
+static void shared_framebuffer_unmap(uint8_t *base, uint64_t size);
+
+static void shared_framebuffer_unlink(char const *name);
+
+bool SharedFramebuffer::Create(char const *name, uint32_t max_width, uint32_t max_height, uint32_t slot_count)
+{
+	assert(max_width > 0U && max_height > 0U);
+
+	snprintf(m_name, sizeof(m_name), "%s", name);
+	m_producer = true;
+	m_published_count = 0U;
+	m_writing_slot_index = -1;
+
+	slot_count = std::max(slot_count, 2U);
+	uint64_t const slot_size = (static_cast<uint64_t>(SHARED_FRAMEBUFFER_SLOT_HEADER_SIZE) + static_cast<uint64_t>(max_width) * max_height * 4U + 4095U) & (~static_cast<uint64_t>(4095U));
+	uint64_t const size = SHARED_FRAMEBUFFER_HEADER_SIZE + slot_size * slot_count;
+
+	m_base = shared_framebuffer_map(m_name, size, true, &m_size);
+	if (NULL == m_base)
+	{
+		return false;
+	}
+
+	// the new mapping is zero (the "published_count" and the sequences are 0)
+	shared_framebuffer_header_t *const header = new (m_base) shared_framebuffer_header_t;
+	header->slot_count = slot_count;
+	header->max_width = max_width;
+	header->max_height = max_height;
+	header->reserved = 0U;
+	header->slot_size = slot_size;
+	header->published_count.store(0U, std::memory_order_relaxed);
+	for (uint32_t slot_index = 0U; slot_index < slot_count; ++slot_index)
+	{
+		shared_framebuffer_slot_header_t *const slot_header = new (m_base + SHARED_FRAMEBUFFER_HEADER_SIZE + slot_size * slot_index) shared_framebuffer_slot_header_t;
+		slot_header->sequence.store(0U, std::memory_order_relaxed);
+		slot_header->width = 0U;
+		slot_header->height = 0U;
+		slot_header->stride = 0U;
+		slot_header->frame_index = 0U;
+	}
+
+	// the viewer which opens the name checks the magic last
+	header->version = SHARED_FRAMEBUFFER_VERSION;
+	std::atomic_thread_fence(std::memory_order_release);
+	header->magic = SHARED_FRAMEBUFFER_MAGIC;
+	return true;
+}
+
+bool SharedFramebuffer::Open(char const *name)
+{
+	snprintf(m_name, sizeof(m_name), "%s", name);
+	m_producer = false;
+	m_published_count = 0U;
+	m_writing_slot_index = -1;
+
+	m_base = shared_framebuffer_map(m_name, 0U, false, &m_size);
+	if (NULL == m_base)
+	{
+		return false;
+	}
+
+	// the magic is written last by the "Create"
+	shared_framebuffer_header_t const *const header = this->GetHeader();
+	bool valid = (m_size >= SHARED_FRAMEBUFFER_HEADER_SIZE) && (SHARED_FRAMEBUFFER_MAGIC == header->magic);
+	std::atomic_thread_fence(std::memory_order_acquire);
+	valid = valid && (SHARED_FRAMEBUFFER_VERSION == header->version) && (header->slot_count >= 2U) && (m_size >= (SHARED_FRAMEBUFFER_HEADER_SIZE + header->slot_size * header->slot_count));
+	if (!valid)
+	{
+		shared_framebuffer_unmap(m_base, m_size);
+		m_base = NULL;
+		m_size = 0U;
+		return false;
+	}
+
+	return true;
+}
+
+void SharedFramebuffer::Destroy()
+{
+	if (NULL != m_base)
+	{
+		shared_framebuffer_unmap(m_base, m_size);
+		m_base = NULL;
+		m_size = 0U;
+	}
+
+	if (m_producer)
+	{
+		shared_framebuffer_unlink(m_name);
+		m_producer = false;
+	}
+}
+
+uint8_t *SharedFramebuffer::BeginWrite(uint32_t width, uint32_t height)
+{
+	assert(m_producer && NULL != m_base && m_writing_slot_index < 0);
+
+	shared_framebuffer_header_t *const header = this->GetHeader();
+	if (width > header->max_width || height > header->max_height)
+	{
+		return NULL;
+	}
+
+	// the slot after the latest published one
+	uint32_t const slot_index = static_cast<uint32_t>(m_published_count % header->slot_count);
+	shared_framebuffer_slot_header_t *const slot_header = this->GetSlotHeader(slot_index);
+
+	// the seqlock: the sequence is odd before any field of the slot is written
+	uint32_t const sequence = slot_header->sequence.load(std::memory_order_relaxed);
+	assert(0U == (sequence & 1U));
+	slot_header->sequence.store(sequence + 1U, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	slot_header->width = width;
+	slot_header->height = height;
+	slot_header->stride = width * 4U;
+
+	m_writing_slot_index = static_cast<int32_t>(slot_index);
+	return reinterpret_cast<uint8_t *>(slot_header) + SHARED_FRAMEBUFFER_SLOT_HEADER_SIZE;
+}
+
+void SharedFramebuffer::Publish(uint64_t frame_index)
+{
+	assert(m_producer && m_writing_slot_index >= 0);
+
+	shared_framebuffer_slot_header_t *const slot_header = this->GetSlotHeader(static_cast<uint32_t>(m_writing_slot_index));
+	slot_header->frame_index = frame_index;
+
+	uint32_t const sequence = slot_header->sequence.load(std::memory_order_relaxed);
+	slot_header->sequence.store(sequence + 1U, std::memory_order_release);
+	m_writing_slot_index = -1;
+
+	// the publication
+	++m_published_count;
+	this->GetHeader()->published_count.store(m_published_count, std::memory_order_release);
+}
+
+bool SharedFramebuffer::AcquireLatest(shared_framebuffer_frame_t *frame) const
+{
+	assert(NULL != m_base);
+
+	shared_framebuffer_header_t const *const header = this->GetHeader();
+	uint64_t const published_count = header->published_count.load(std::memory_order_acquire);
+	if (0U == published_count)
+	{
+		return false;
+	}
+
+	uint32_t const slot_index = static_cast<uint32_t>((published_count - 1U) % header->slot_count);
+	shared_framebuffer_slot_header_t const *const slot_header = this->GetSlotHeader(slot_index);
+
+	uint32_t const sequence = slot_header->sequence.load(std::memory_order_acquire);
+	if (0U != (sequence & 1U))
+	{
+		return false;
+	}
+
+	frame->pixels = reinterpret_cast<uint8_t const *>(slot_header) + SHARED_FRAMEBUFFER_SLOT_HEADER_SIZE;
+	frame->width = slot_header->width;
+	frame->height = slot_header->height;
+	frame->stride = slot_header->stride;
+	frame->frame_index = slot_header->frame_index;
+	frame->published_count = published_count;
+	frame->slot_index = slot_index;
+	frame->sequence = sequence;
+
+	// the fields may be torn as well, such that they are checked before the pixels are touched
+	if (static_cast<uint64_t>(frame->stride) * frame->height + SHARED_FRAMEBUFFER_SLOT_HEADER_SIZE > header->slot_size || frame->stride < (frame->width * 4U))
+	{
+		return false;
+	}
+
+	return true;
+}
+
+bool SharedFramebuffer::Validate(shared_framebuffer_frame_t const &frame) const
+{
+	assert(NULL != m_base);
+
+	// the reads of the pixels are ordered before the sequence is read again
+	std::atomic_thread_fence(std::memory_order_acquire);
+	return (frame.sequence == this->GetSlotHeader(frame.slot_index)->sequence.load(std::memory_order_relaxed));
+}
+
+uint64_t SharedFramebuffer::GetPublishedCount() const
+{
+	return this->GetHeader()->published_count.load(std::memory_order_acquire);
+}
+
+uint32_t SharedFramebuffer::GetSlotCount() const
+{
+	return this->GetHeader()->slot_count;
+}
+
+shared_framebuffer_header_t *SharedFramebuffer::GetHeader() const
+{
+	return reinterpret_cast<shared_framebuffer_header_t *>(m_base);
+}
+
+shared_framebuffer_slot_header_t *SharedFramebuffer::GetSlotHeader(uint32_t slot_index) const
+{
+	return reinterpret_cast<shared_framebuffer_slot_header_t *>(m_base + SHARED_FRAMEBUFFER_HEADER_SIZE + this->GetHeader()->slot_size * slot_index);
+}
+
+#if defined(_WIN32)
+static uint8_t *shared_framebuffer_map(char const *name, uint64_t size, bool create, uint64_t *mapped_size)
+{
+	// the session namespace, such that no privilege is required
+	char object_name[160];
+	snprintf(object_name, sizeof(object_name), "Local\\%s", name);
+
+	HANDLE mapping = create ? CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, static_cast<DWORD>(size >> 32U), static_cast<DWORD>(size), object_name) : OpenFileMappingA(FILE_MAP_READ, FALSE, object_name);
+	if (NULL == mapping)
+	{
+		return NULL;
+	}
+
+	// the view keeps the mapping alive after the handle is closed
+	void *base = MapViewOfFile(mapping, create ? FILE_MAP_WRITE : FILE_MAP_READ, 0U, 0U, 0U);
+	CloseHandle(mapping);
+	if (NULL == base)
+	{
+		return NULL;
+	}
+
+	MEMORY_BASIC_INFORMATION memory_information;
+	VirtualQuery(base, &memory_information, sizeof(memory_information));
+	(*mapped_size) = create ? size : static_cast<uint64_t>(memory_information.RegionSize);
+	return static_cast<uint8_t *>(base);
+}
+
+static void shared_framebuffer_unmap(uint8_t *base, uint64_t)
+{
+	UnmapViewOfFile(base);
+}
+
+static void shared_framebuffer_unlink(char const *)
+{
+	// the mapping is destroyed when the last view is unmapped
+}
+#else
+static uint8_t *shared_framebuffer_map(char const *name, uint64_t size, bool create, uint64_t *mapped_size)
+{
+	char object_name[160];
+	snprintf(object_name, sizeof(object_name), "/%s", name);
+
+	int file_descriptor;
+	if (create)
+	{
+		// the stale object of the previous run is replaced, such that the new mapping is zero
+		shm_unlink(object_name);
+		file_descriptor = shm_open(object_name, O_RDWR | O_CREAT | O_EXCL, 0600);
+		if (file_descriptor < 0)
+		{
+			return NULL;
+		}
+		if (0 != ftruncate(file_descriptor, static_cast<off_t>(size)))
+		{
+			close(file_descriptor);
+			shm_unlink(object_name);
+			return NULL;
+		}
+	}
+	else
+	{
+		file_descriptor = shm_open(object_name, O_RDONLY, 0);
+		if (file_descriptor < 0)
+		{
+			return NULL;
+		}
+		struct stat file_status;
+		if (0 != fstat(file_descriptor, &file_status) || file_status.st_size <= 0)
+		{
+			close(file_descriptor);
+			return NULL;
+		}
+		size = static_cast<uint64_t>(file_status.st_size);
+	}
+
+	// the mapping keeps the object alive after the descriptor is closed
+	void *base = mmap(NULL, static_cast<size_t>(size), create ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, file_descriptor, 0);
+	close(file_descriptor);
+	if (MAP_FAILED == base)
+	{
+		if (create)
+		{
+			shm_unlink(object_name);
+		}
+		return NULL;
+	}
+
+	(*mapped_size) = size;
+	return static_cast<uint8_t *>(base);
+}
+
+static void shared_framebuffer_unmap(uint8_t *base, uint64_t size)
+{
+	munmap(base, static_cast<size_t>(size));
+}
+
+static void shared_framebuffer_unlink(char const *name)
+{
+	char object_name[160];
+	snprintf(object_name, sizeof(object_name), "/%s", name);
+	shm_unlink(object_name);
+}
+#endif
@@ -0,0 +1,110 @@
+#ifndef _CPU_SHARED_FRAMEBUFFER_H_
+#define _CPU_SHARED_FRAMEBUFFER_H_ 1
+
+//
+// The ring of the BGRA8 frames in the named shared memory ("shm_open" on POSIX, the file mapping on Windows), such that the viewer process maps the frames of the renderer
+// without any copy or serialization (e.g. the CPU backend renders the post process directly into the slot, see "backend/render_backend_cpu.h").
+//
+// The layout (SHARED_FRAMEBUFFER_VERSION): the header page, followed by the "slot_count" slots of the "slot_size" bytes, each: the slot header and the pixels at the offset 64.
+//
+// The producer writes the frame into the slot after the latest published one, such that the viewer reading the latest frame has "slot_count - 1" frames of time before the slot is reused.
+// Each slot is guarded by the seqlock: the sequence is odd while the producer writes the slot.
+// The frame is published by the single store (release) of the "published_count" in the header, the latest frame is in the slot "(published_count - 1) % slot_count".
+// The viewer acquires the latest frame (the sequence before the pixels are read) and validates it after the pixels are used (the sequence is unchanged, the pixels are NOT torn).
+//
+
+#include <stdint.h>
+#include <atomic>
+
+static const uint32_t SHARED_FRAMEBUFFER_MAGIC = 0X4246434CU;
+static const uint32_t SHARED_FRAMEBUFFER_VERSION = 1U;
+static const uint32_t SHARED_FRAMEBUFFER_HEADER_SIZE = 4096U;
+static const uint32_t SHARED_FRAMEBUFFER_SLOT_HEADER_SIZE = 64U;
+
+// the atomics are shared by the processes, which requires them to be lock free (address free)
+static_assert(ATOMIC_INT_LOCK_FREE == 2 && ATOMIC_LLONG_LOCK_FREE == 2, "the atomics of the shared memory must be lock free");
+
+struct shared_framebuffer_header_t
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t slot_count;
+	uint32_t max_width;
+	uint32_t max_height;
+	uint32_t reserved;
+	// including the slot header, the multiple of the page
+	uint64_t slot_size;
+	// 0 means no frame is published
+	std::atomic<uint64_t> published_count;
+};
+
+struct shared_framebuffer_slot_header_t
+{
+	// odd while the producer writes the slot
+	std::atomic<uint32_t> sequence;
+	uint32_t width;
+	uint32_t height;
+	// the bytes per row
+	uint32_t stride;
+	// the frame index of the producer
+	uint64_t frame_index;
+};
+
+// the latest frame acquired by the viewer
+struct shared_framebuffer_frame_t
+{
+	// BGRA8, the row 0 is the top of the image
+	uint8_t const *pixels;
+	uint32_t width;
+	uint32_t height;
+	uint32_t stride;
+	uint64_t frame_index;
+	uint64_t published_count;
+	uint32_t slot_index;
+	uint32_t sequence;
+};
+
+class SharedFramebuffer
+{
+	uint8_t *m_base;
+	uint64_t m_size;
+	bool m_producer;
+	char m_name[128];
+
+	// the producer
+	uint64_t m_published_count;
+	int32_t m_writing_slot_index;
+
+	shared_framebuffer_header_t *GetHeader() const;
+	shared_framebuffer_slot_header_t *GetSlotHeader(uint32_t slot_index) const;
+
+public:
+	// The producer: the shared memory of the "name" is created (replaced if it exists).
+	// [in] name: e.g. "ltc_preview", without any slash
+	// [in] slot_count: at least 2
+	// [return] false if the shared memory can NOT be created
+	bool Create(char const *name, uint32_t max_width, uint32_t max_height, uint32_t slot_count);
+	// The viewer: the shared memory of the "name" is mapped read-only.
+	// [return] false if it does NOT exist or is NOT of the SHARED_FRAMEBUFFER_VERSION
+	bool Open(char const *name);
+	// the producer also removes the name (the mappings of the viewers stay valid until they are destroyed)
+	void Destroy();
+
+	// The producer: the slot after the latest published one is locked for the frame.
+	// [return] the pixels of the slot (the stride is "width * 4"), NULL if the size exceeds the "max_width" and the "max_height"
+	uint8_t *BeginWrite(uint32_t width, uint32_t height);
+	// The producer: the slot of the "BeginWrite" is unlocked and published.
+	void Publish(uint64_t frame_index);
+
+	// The viewer: the latest published frame.
+	// [return] false if no frame is published or the slot is being rewritten (retry later)
+	bool AcquireLatest(shared_framebuffer_frame_t *frame) const;
+	// The viewer: after the pixels of the "AcquireLatest" are used.
+	// [return] false if the producer has reused the slot meanwhile (the pixels may be torn)
+	bool Validate(shared_framebuffer_frame_t const &frame) const;
+
+	uint64_t GetPublishedCount() const;
+	uint32_t GetSlotCount() const;
+};
+
+#endif
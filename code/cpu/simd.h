@@ -0,0 +1,174 @@
+#ifndef _CPU_SIMD_H_
+#define _CPU_SIMD_H_ 1
+
+//
+// Four lanes "SoA" math, which mirrors the HLSL intrinsics used by the shaders.
+// Each lane is an independent shading position, such that the HLSL functions can be ported line by line.
+//
+// Only SSE2 is used, which is the baseline of x64.
+//
+
+#include <stdint.h>
+#include <xmmintrin.h>
+#include <emmintrin.h>
+
+struct simd_float
+{
+	__m128 v;
+
+	inline simd_float() {}
+	inline simd_float(__m128 in_v) : v(in_v) {}
+	inline simd_float(float in_f) : v(_mm_set1_ps(in_f)) {}
+};
+
+struct simd_float3
+{
+	simd_float x;
+	simd_float y;
+	simd_float z;
+
+	inline simd_float3() {}
+	inline simd_float3(simd_float in_x, simd_float in_y, simd_float in_z) : x(in_x), y(in_y), z(in_z) {}
+};
+
+// row major (the same as the "float3x3(row0, row1, row2)" constructor of HLSL)
+struct simd_float3x3
+{
+	simd_float3 r0;
+	simd_float3 r1;
+	simd_float3 r2;
+};
+
+static const float SIMD_PI = 3.1415926535897932f;
+
+inline simd_float operator+(simd_float a, simd_float b) { return _mm_add_ps(a.v, b.v); }
+inline simd_float operator-(simd_float a, simd_float b) { return _mm_sub_ps(a.v, b.v); }
+inline simd_float operator*(simd_float a, simd_float b) { return _mm_mul_ps(a.v, b.v); }
+inline simd_float operator/(simd_float a, simd_float b) { return _mm_div_ps(a.v, b.v); }
+inline simd_float operator-(simd_float a) { return _mm_xor_ps(a.v, _mm_set1_ps(-0.0f)); }
+
+// The comparisons return the mask (all bits of the lane are set if true).
+inline simd_float operator<(simd_float a, simd_float b) { return _mm_cmplt_ps(a.v, b.v); }
+inline simd_float operator<=(simd_float a, simd_float b) { return _mm_cmple_ps(a.v, b.v); }
+inline simd_float operator>(simd_float a, simd_float b) { return _mm_cmpgt_ps(a.v, b.v); }
+inline simd_float operator>=(simd_float a, simd_float b) { return _mm_cmpge_ps(a.v, b.v); }
+inline simd_float operator&(simd_float a, simd_float b) { return _mm_and_ps(a.v, b.v); }
+inline simd_float operator|(simd_float a, simd_float b) { return _mm_or_ps(a.v, b.v); }
+
+// mask ? a : b
+inline simd_float select(simd_float mask, simd_float a, simd_float b) { return _mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v)); }
+inline int movemask(simd_float mask) { return _mm_movemask_ps(mask.v); }
+inline bool any(simd_float mask) { return (0 != _mm_movemask_ps(mask.v)); }
+inline bool all(simd_float mask) { return (0XF == _mm_movemask_ps(mask.v)); }
+
+inline simd_float min(simd_float a, simd_float b) { return _mm_min_ps(a.v, b.v); }
+inline simd_float max(simd_float a, simd_float b) { return _mm_max_ps(a.v, b.v); }
+inline simd_float abs(simd_float a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a.v); }
+inline simd_float saturate(simd_float a) { return _mm_min_ps(_mm_max_ps(a.v, _mm_setzero_ps()), _mm_set1_ps(1.0f)); }
+inline simd_float sqrt(simd_float a) { return _mm_sqrt_ps(a.v); }
+// NOT the "_mm_rsqrt_ps" (12 bits) since the precision matters in the form factor
+inline simd_float rsqrt(simd_float a) { return _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(a.v)); }
+inline simd_float lerp(simd_float a, simd_float b, simd_float s) { return a + (b - a) * s; }
+inline simd_float floor(simd_float a)
+{
+	// valid for |a| < 2^31
+	__m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(a.v));
+	return _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, a.v), _mm_set1_ps(1.0f)));
+}
+
+inline simd_float atan(simd_float x)
+{
+	// minimax polynomial over [0, 1] (max error ≈ 1e-5)
+	// atan(x) = π/2 - atan(1/x) when |x| > 1
+	simd_float ax = abs(x);
+	simd_float inverse = ax > simd_float(1.0f);
+	simd_float t = select(inverse, simd_float(1.0f) / ax, ax);
+	simd_float t2 = t * t;
+	simd_float p = t * (simd_float(0.99997726f) + t2 * (simd_float(-0.33262347f) + t2 * (simd_float(0.19354346f) + t2 * (simd_float(-0.11643287f) + t2 * (simd_float(0.05265332f) + t2 * simd_float(-0.01172120f))))));
+	p = select(inverse, simd_float(0.5f * SIMD_PI) - p, p);
+	return _mm_or_ps(p.v, _mm_and_ps(x.v, _mm_set1_ps(-0.0f)));
+}
+
+inline simd_float atan2(simd_float y, simd_float x)
+{
+	simd_float ax = abs(x);
+	simd_float ay = abs(y);
+	simd_float t_max = max(ax, ay);
+	simd_float t_min = min(ax, ay);
+	simd_float t = select(t_max > simd_float(0.0f), t_min / t_max, simd_float(0.0f));
+
+	simd_float p = atan(t);
+	p = select(ay > ax, simd_float(0.5f * SIMD_PI) - p, p);
+	p = select(x < simd_float(0.0f), simd_float(SIMD_PI) - p, p);
+	return _mm_or_ps(p.v, _mm_and_ps(y.v, _mm_set1_ps(-0.0f)));
+}
+
+inline simd_float cos(simd_float x)
+{
+	// range reduction to [-π, π]
+	simd_float k = _mm_cvtepi32_ps(_mm_cvtps_epi32(_mm_mul_ps(x.v, _mm_set1_ps(1.0f / (2.0f * SIMD_PI)))));
+	simd_float r = abs(x - k * simd_float(2.0f * SIMD_PI));
+
+	// cos(r) = -cos(π - r)
+	simd_float reflect = r > simd_float(0.5f * SIMD_PI);
+	r = select(reflect, simd_float(SIMD_PI) - r, r);
+
+	// Taylor series over [0, π/2] (max error ≈ 5e-7)
+	simd_float r2 = r * r;
+	simd_float c = simd_float(1.0f) + r2 * (simd_float(-0.5f) + r2 * (simd_float(1.0f / 24.0f) + r2 * (simd_float(-1.0f / 720.0f) + r2 * (simd_float(1.0f / 40320.0f) + r2 * simd_float(-1.0f / 3628800.0f)))));
+	return select(reflect, -c, c);
+}
+
+inline simd_float log2(simd_float a)
+{
+	// valid for the positive normal "a"
+	// log2(a) = exponent + log2(mantissa), the polynomial of "mantissa - 1" over [0, 1) (max error ≈ 2e-5)
+	__m128i bits = _mm_castps_si128(a.v);
+	simd_float exponent = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127)));
+	simd_float t = simd_float(_mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0X007FFFFF)), _mm_set1_epi32(0X3F800000)))) - simd_float(1.0f);
+	return exponent + t * (simd_float(1.44187984f) + t * (simd_float(-0.70886455f) + t * (simd_float(0.41524326f) + t * (simd_float(-0.19351346f) + t * simd_float(0.04526690f)))));
+}
+
+inline simd_float exp2(simd_float a)
+{
+	// the "a" below -126 is clamped (the denormals are flushed to 2^-126)
+	simd_float x = min(max(a, simd_float(-126.0f)), simd_float(127.0f));
+	simd_float i = floor(x);
+	simd_float t = x - i;
+
+	// 2^t over [0, 1) (max relative error ≈ 4e-6)
+	simd_float p = simd_float(1.0f) + t * (simd_float(0.69301750f) + t * (simd_float(0.24144876f) + t * (simd_float(0.05194775f) + t * simd_float(0.01358178f))));
+	return _mm_mul_ps(p.v, _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(_mm_cvttps_epi32(i.v), _mm_set1_epi32(127)), 23)));
+}
+
+// valid for the non-negative "a" (0 is approximately 0, i.e. 2^-126)
+inline simd_float pow(simd_float a, simd_float b) { return exp2(log2(max(a, simd_float(1.175494351e-38f))) * b); }
+
+inline simd_float3 operator+(simd_float3 a, simd_float3 b) { return simd_float3(a.x + b.x, a.y + b.y, a.z + b.z); }
+inline simd_float3 operator-(simd_float3 a, simd_float3 b) { return simd_float3(a.x - b.x, a.y - b.y, a.z - b.z); }
+inline simd_float3 operator*(simd_float3 a, simd_float3 b) { return simd_float3(a.x * b.x, a.y * b.y, a.z * b.z); }
+inline simd_float3 operator*(simd_float3 a, simd_float s) { return simd_float3(a.x * s, a.y * s, a.z * s); }
+inline simd_float3 operator*(simd_float s, simd_float3 a) { return simd_float3(s * a.x, s * a.y, s * a.z); }
+inline simd_float3 operator/(simd_float3 a, simd_float s) { return simd_float3(a.x / s, a.y / s, a.z / s); }
+inline simd_float3 operator-(simd_float3 a) { return simd_float3(-a.x, -a.y, -a.z); }
+
+inline simd_float3 select(simd_float mask, simd_float3 a, simd_float3 b) { return simd_float3(select(mask, a.x, b.x), select(mask, a.y, b.y), select(mask, a.z, b.z)); }
+inline simd_float3 saturate(simd_float3 a) { return simd_float3(saturate(a.x), saturate(a.y), saturate(a.z)); }
+inline simd_float3 lerp(simd_float3 a, simd_float3 b, simd_float s) { return a + (b - a) * s; }
+inline simd_float dot(simd_float3 a, simd_float3 b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+inline simd_float3 cross(simd_float3 a, simd_float3 b) { return simd_float3(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x); }
+inline simd_float length(simd_float3 a) { return sqrt(dot(a, a)); }
+inline simd_float3 normalize(simd_float3 a) { return a * rsqrt(dot(a, a)); }
+
+inline simd_float3 mul(simd_float3x3 const &m, simd_float3 v) { return simd_float3(dot(m.r0, v), dot(m.r1, v), dot(m.r2, v)); }
+
+inline simd_float3 simd_float3_broadcast(float x, float y, float z) { return simd_float3(simd_float(x), simd_float(y), simd_float(z)); }
+
+inline float simd_float_lane(simd_float a, int lane)
+{
+	float lanes[4];
+	_mm_storeu_ps(lanes, a.v);
+	return lanes[lane];
+}
+
+#endif
@@ -0,0 +1,773 @@
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <cmath>
+#include <algorithm>
+#include <vector>
+#include <chrono>
+
+#include "simd.h"
+#include "ltc.h"
+#include "bvh.h"
+#include "thread_pool.h"
+#include "frame_arena.h"
+
+#include "software_renderer.h"
+
+static const uint32_t g_software_renderer_tile_size = 8U;
+// cross bilateral filter
+static const int g_software_renderer_denoise_radius = 3;
+static const float g_software_renderer_denoise_sigma_spatial = 2.0f;
+static const float g_software_renderer_denoise_sigma_depth = 0.05f;
+static const float g_software_renderer_denoise_normal_power = 8.0f;
+// offset the origin of the shadow rays along the normal (the scene is in the unit of the demo)
+static const float g_software_renderer_shadow_ray_offset = 1e-3f;
+// the per thread counters of the passes (grows on demand, see "frame_arena.h")
+static const size_t g_software_renderer_scratch_capacity = 4096U;
+
+static inline double software_renderer_milliseconds_since(std::chrono::steady_clock::time_point begin);
+
+// the GGX weight of the light sample (the pdf is uniform over the area of the light and is cancelled by the ratio)
+static inline simd_float software_renderer_brdf_weight(simd_float3 N, simd_float3 V, simd_float3 L, float diffuse_albedo, float specular_albedo, float roughness);
+
+static inline float software_renderer_horizontal_sum(simd_float a);
+
+static inline uint32_t software_renderer_hash(uint32_t x);
+
+void SoftwareRenderer::Init(uint32_t width, uint32_t height)
+{
+	// the scratch is only used within the "SetScene" and the "Render"
+	m_scratch.Init(1U, g_software_renderer_scratch_capacity);
+
+	m_width = width;
+	m_height = height;
+
+	size_t const pixel_count = static_cast<size_t>(width) * height;
+	m_position.assign(pixel_count * 3U, 0.0f);
+	m_normal.assign(pixel_count * 3U, 0.0f);
+	m_depth.assign(pixel_count, INFINITY);
+	m_emissive.assign(pixel_count, 0U);
+	m_unshadowed_radiance.assign(pixel_count * 3U, 0.0f);
+	m_shadow_ratio.assign(pixel_count, 1.0f);
+	m_shadow_ratio_denoised.assign(pixel_count, 1.0f);
+	m_shadow_sample_count.assign(pixel_count, 0U);
+	m_radiance.assign(pixel_count * 3U, 0.0f);
+
+	memset(&m_scene, 0, sizeof(software_renderer_scene_t));
+}
+
+void SoftwareRenderer::Destroy()
+{
+	m_scratch.Destroy();
+}
+
+void SoftwareRenderer::SetScene(software_renderer_scene_t const &scene)
+{
+	m_scene = scene;
+
+	m_scratch.BeginFrame();
+	m_bvh.Build(scene.triangle_vertices, scene.triangle_count, m_scratch);
+
+	// NOT owned
+	m_scene.triangle_vertices = NULL;
+}
+
+void SoftwareRenderer::SetCamera(float const eye_position[3], float const eye_direction[3], float const up_direction[3])
+{
+	memcpy(m_scene.eye_position, eye_position, sizeof(m_scene.eye_position));
+	memcpy(m_scene.eye_direction, eye_direction, sizeof(m_scene.eye_direction));
+	memcpy(m_scene.up_direction, up_direction, sizeof(m_scene.up_direction));
+}
+
+void SoftwareRenderer::Render(ThreadPool *thread_pool, software_renderer_shadow_settings_t const &settings, uint32_t frame_index, software_renderer_statistics_t &statistics)
+{
+	this->RenderGBuffer(thread_pool, statistics);
+	this->RenderLighting(thread_pool, settings, frame_index, statistics);
+}
+
+void SoftwareRenderer::RenderGBuffer(ThreadPool *thread_pool, software_renderer_statistics_t &statistics)
+{
+	memset(&statistics, 0, sizeof(software_renderer_statistics_t));
+
+	std::chrono::steady_clock::time_point const begin = std::chrono::steady_clock::now();
+
+	this->PassPrimary(thread_pool);
+
+	statistics.primary_milliseconds = software_renderer_milliseconds_since(begin);
+	statistics.total_milliseconds = statistics.primary_milliseconds;
+}
+
+void SoftwareRenderer::RenderLighting(ThreadPool *thread_pool, software_renderer_shadow_settings_t const &settings, uint32_t frame_index, software_renderer_statistics_t &statistics)
+{
+	m_scratch.BeginFrame();
+
+	std::chrono::steady_clock::time_point const begin = std::chrono::steady_clock::now();
+
+	{
+		std::chrono::steady_clock::time_point const pass_begin = std::chrono::steady_clock::now();
+		this->PassShading(thread_pool, statistics);
+		statistics.shading_milliseconds = software_renderer_milliseconds_since(pass_begin);
+	}
+
+	bool const shadowed = (settings.max_sample_count > 0U);
+	if (shadowed)
+	{
+		std::chrono::steady_clock::time_point const pass_begin = std::chrono::steady_clock::now();
+		this->PassShadow(thread_pool, settings, frame_index, statistics);
+		statistics.shadow_milliseconds = software_renderer_milliseconds_since(pass_begin);
+	}
+
+	if (shadowed && settings.denoise)
+	{
+		std::chrono::steady_clock::time_point const pass_begin = std::chrono::steady_clock::now();
+		this->PassDenoise(thread_pool, statistics);
+		statistics.denoise_milliseconds = software_renderer_milliseconds_since(pass_begin);
+	}
+	else
+	{
+		m_shadow_ratio_denoised = m_shadow_ratio;
+	}
+
+	this->PassComposite(thread_pool, shadowed);
+
+	statistics.total_milliseconds += software_renderer_milliseconds_since(begin);
+}
+
+void SoftwareRenderer::PassPrimary(ThreadPool *thread_pool)
+{
+	// camera basis (right handed: the screen right is "cross(forward, up)")
+	simd_float3 const eye_position = simd_float3_broadcast(m_scene.eye_position[0], m_scene.eye_position[1], m_scene.eye_position[2]);
+	simd_float3 const forward = normalize(simd_float3_broadcast(m_scene.eye_direction[0], m_scene.eye_direction[1], m_scene.eye_direction[2]));
+	simd_float3 const right = normalize(cross(forward, simd_float3_broadcast(m_scene.up_direction[0], m_scene.up_direction[1], m_scene.up_direction[2])));
+	simd_float3 const up = cross(right, forward);
+
+	float const tan_half_fov_y = std::tan(0.5f * m_scene.fov_angle_y);
+	float const aspect_ratio = static_cast<float>(m_width) / static_cast<float>(m_height);
+
+	// the emissive quad
+	float const *const light = &m_scene.rect_light_vertices[0][0];
+	simd_float3 const light_v0 = simd_float3_broadcast(light[0], light[1], light[2]);
+	simd_float3 const light_e1 = simd_float3_broadcast(light[3] - light[0], light[4] - light[1], light[5] - light[2]);
+	simd_float3 const light_e3 = simd_float3_broadcast(light[9] - light[0], light[10] - light[1], light[11] - light[2]);
+	simd_float3 const light_normal = cross(light_e1, light_e3);
+
+	thread_pool->ParallelFor(m_height, 4U, [&](uint32_t begin, uint32_t end, uint32_t) {
+		for (uint32_t y = begin; y < end; ++y)
+		{
+			for (uint32_t x = 0U; x < m_width; x += 4U)
+			{
+				float lane_x[4];
+				float lane_active[4];
+				for (int lane = 0; lane < 4; ++lane)
+				{
+					lane_x[lane] = static_cast<float>(x + lane) + 0.5f;
+					lane_active[lane] = ((x + lane) < m_width) ? 1.0f : 0.0f;
+				}
+
+				simd_float const active = simd_float(_mm_loadu_ps(lane_active)) > simd_float(0.0f);
+				simd_float const ndc_x = (simd_float(_mm_loadu_ps(lane_x)) * simd_float(2.0f / static_cast<float>(m_width)) - simd_float(1.0f)) * simd_float(tan_half_fov_y * aspect_ratio);
+				simd_float const ndc_y = simd_float((1.0f - 2.0f * (static_cast<float>(y) + 0.5f) / static_cast<float>(m_height)) * tan_half_fov_y);
+
+				simd_float3 const direction = normalize(forward + right * ndc_x + up * ndc_y);
+
+				simd_float t_hit;
+				int32_t triangle_index[4];
+				simd_float3 geometric_normal;
+				simd_float const hit = m_bvh.Intersect(eye_position, direction, simd_float(0.0f), simd_float(INFINITY), active, t_hit, triangle_index, geometric_normal);
+
+				// the emissive quad (visible from the front face)
+				simd_float emissive;
+				{
+					simd_float direction_o_normal = dot(direction, light_normal);
+					simd_float t_light = dot(light_v0 - eye_position, light_normal) / direction_o_normal;
+					simd_float3 local = eye_position + direction * t_light - light_v0;
+					simd_float s = dot(local, light_e1) / dot(light_e1, light_e1);
+					simd_float t = dot(local, light_e3) / dot(light_e3, light_e3);
+					emissive = active & (direction_o_normal > simd_float(0.0f)) & (t_light > simd_float(0.0f)) & (t_light < t_hit) & (s >= simd_float(0.0f)) & (s <= simd_float(1.0f)) & (t >= simd_float(0.0f)) & (t <= simd_float(1.0f));
+				}
+
+				// The normal faces the eye
+				simd_float3 N = normalize(select(hit, geometric_normal, simd_float3_broadcast(0.0f, 1.0f, 0.0f)));
+				N = select(dot(N, direction) > simd_float(0.0f), -N, N);
+				simd_float3 const P = eye_position + direction * t_hit;
+
+				int const hit_lanes = movemask(hit);
+				int const emissive_lanes = movemask(emissive);
+				for (int lane = 0; lane < 4 && (x + lane) < m_width; ++lane)
+				{
+					size_t const pixel_index = static_cast<size_t>(m_width) * y + (x + lane);
+					m_emissive[pixel_index] = (0 != (emissive_lanes & (1 << lane))) ? 1U : 0U;
+					if (0 != (hit_lanes & (1 << lane)) && 0U == m_emissive[pixel_index])
+					{
+						m_depth[pixel_index] = simd_float_lane(t_hit, lane);
+						m_position[3U * pixel_index + 0U] = simd_float_lane(P.x, lane);
+						m_position[3U * pixel_index + 1U] = simd_float_lane(P.y, lane);
+						m_position[3U * pixel_index + 2U] = simd_float_lane(P.z, lane);
+						m_normal[3U * pixel_index + 0U] = simd_float_lane(N.x, lane);
+						m_normal[3U * pixel_index + 1U] = simd_float_lane(N.y, lane);
+						m_normal[3U * pixel_index + 2U] = simd_float_lane(N.z, lane);
+					}
+					else
+					{
+						m_depth[pixel_index] = INFINITY;
+					}
+				}
+			}
+		}
+	});
+}
+
+void SoftwareRenderer::PassShading(ThreadPool *thread_pool, software_renderer_statistics_t &statistics)
+{
+	simd_float3 vertices_world_space[4];
+	for (int vertex_index = 0; vertex_index < 4; ++vertex_index)
+	{
+		vertices_world_space[vertex_index] = simd_float3_broadcast(m_scene.rect_light_vertices[vertex_index][0], m_scene.rect_light_vertices[vertex_index][1], m_scene.rect_light_vertices[vertex_index][2]);
+	}
+
+	simd_float3 const eye_position = simd_float3_broadcast(m_scene.eye_position[0], m_scene.eye_position[1], m_scene.eye_position[2]);
+	simd_float3 const diffuse_color = simd_float3_broadcast(m_scene.diffuse_color[0], m_scene.diffuse_color[1], m_scene.diffuse_color[2]);
+	simd_float3 const specular_color = simd_float3_broadcast(m_scene.specular_color[0], m_scene.specular_color[1], m_scene.specular_color[2]);
+	simd_float const roughness = simd_float(m_scene.roughness);
+	simd_float const intensity = simd_float(m_scene.intensity);
+
+	// [thread_index][path]: back face, below, above, straddle
+	uint32_t const thread_count = thread_pool->GetThreadCount();
+	uint32_t *const thread_path_pixel_counts = m_scratch.Allocate<uint32_t>(thread_count * 4U);
+	memset(thread_path_pixel_counts, 0, sizeof(uint32_t) * thread_count * 4U);
+
+	thread_pool->ParallelFor(m_height, 4U, [&](uint32_t begin, uint32_t end, uint32_t thread_index) {
+		for (uint32_t y = begin; y < end; ++y)
+		{
+			// The pixels which hit the scene are compacted into the lanes, such that the missed pixels (also the pixels rejected by the "RejectDepth" or the "RejectCheckerboard") cost no lanes.
+			uint32_t x = 0U;
+			while (x < m_width)
+			{
+				// gather 4 pixels
+				uint32_t lane_x[4];
+				int lane_count = 0;
+				for (; x < m_width && lane_count < 4; ++x)
+				{
+					size_t const pixel_index = static_cast<size_t>(m_width) * y + x;
+					if (m_depth[pixel_index] < INFINITY)
+					{
+						lane_x[lane_count] = x;
+						++lane_count;
+					}
+					else
+					{
+						m_unshadowed_radiance[3U * pixel_index + 0U] = 0.0f;
+						m_unshadowed_radiance[3U * pixel_index + 1U] = 0.0f;
+						m_unshadowed_radiance[3U * pixel_index + 2U] = 0.0f;
+					}
+				}
+				if (0 == lane_count)
+				{
+					continue;
+				}
+
+				float lane_position[3][4];
+				float lane_normal[3][4];
+				float lane_valid[4];
+				for (int lane = 0; lane < 4; ++lane)
+				{
+					size_t const pixel_index = static_cast<size_t>(m_width) * y + lane_x[std::min(lane, lane_count - 1)];
+					bool const valid = (lane < lane_count);
+					for (int component = 0; component < 3; ++component)
+					{
+						// keep the invalid lanes finite
+						lane_position[component][lane] = valid ? m_position[3U * pixel_index + component] : 0.0f;
+						lane_normal[component][lane] = valid ? m_normal[3U * pixel_index + component] : ((1 == component) ? 1.0f : 0.0f);
+					}
+					lane_valid[lane] = valid ? 1.0f : 0.0f;
+				}
+
+				simd_float3 const P(_mm_loadu_ps(lane_position[0]), _mm_loadu_ps(lane_position[1]), _mm_loadu_ps(lane_position[2]));
+				simd_float3 const N(_mm_loadu_ps(lane_normal[0]), _mm_loadu_ps(lane_normal[1]), _mm_loadu_ps(lane_normal[2]));
+				simd_float3 const V = normalize(eye_position - P);
+
+				simd_float const valid = simd_float(_mm_loadu_ps(lane_valid)) > simd_float(0.0f);
+				simd_float const front_face = (EvaluateBRDFLTCLightAttenuation(P, vertices_world_space) > simd_float(0.0f)) & valid;
+
+				simd_float straddle;
+				simd_float const above_any = EvaluateBRDFLTCLightHorizon(P, N, vertices_world_space, straddle) & front_face;
+				straddle = straddle & front_face;
+
+				{
+					int const valid_lanes = movemask(valid);
+					int const front_face_lanes = movemask(front_face);
+					int const above_any_lanes = movemask(above_any);
+					int const straddle_lanes = movemask(straddle);
+					uint32_t *const path_pixel_counts = &thread_path_pixel_counts[4U * thread_index];
+					for (int lane = 0; lane < 4; ++lane)
+					{
+						if (0 != (valid_lanes & (1 << lane)))
+						{
+							uint32_t const path = (0 == (front_face_lanes & (1 << lane))) ? 0U : ((0 == (above_any_lanes & (1 << lane))) ? 1U : ((0 == (straddle_lanes & (1 << lane))) ? 2U : 3U));
+							++path_pixel_counts[path];
+						}
+					}
+				}
+
+				// The lanes where the light is rejected are masked out, the "EvaluateBRDFLTC" is skipped if all lanes are rejected.
+				simd_float3 radiance = simd_float3_broadcast(0.0f, 0.0f, 0.0f);
+				if (any(above_any))
+				{
+					radiance = select(above_any, EvaluateBRDFLTC(diffuse_color, roughness, specular_color, P, N, V, vertices_world_space) * intensity, radiance);
+				}
+
+				for (int lane = 0; lane < lane_count; ++lane)
+				{
+					size_t const pixel_index = static_cast<size_t>(m_width) * y + lane_x[lane];
+					m_unshadowed_radiance[3U * pixel_index + 0U] = simd_float_lane(radiance.x, lane);
+					m_unshadowed_radiance[3U * pixel_index + 1U] = simd_float_lane(radiance.y, lane);
+					m_unshadowed_radiance[3U * pixel_index + 2U] = simd_float_lane(radiance.z, lane);
+				}
+			}
+		}
+	});
+
+	for (uint32_t thread_index = 0U; thread_index < thread_count; ++thread_index)
+	{
+		statistics.light_back_face_pixel_count += thread_path_pixel_counts[4U * thread_index + 0U];
+		statistics.horizon_below_pixel_count += thread_path_pixel_counts[4U * thread_index + 1U];
+		statistics.horizon_above_pixel_count += thread_path_pixel_counts[4U * thread_index + 2U];
+		statistics.horizon_straddle_pixel_count += thread_path_pixel_counts[4U * thread_index + 3U];
+	}
+}
+
+void SoftwareRenderer::PassShadow(ThreadPool *thread_pool, software_renderer_shadow_settings_t const &settings, uint32_t frame_index, software_renderer_statistics_t &statistics)
+{
+	uint32_t const min_sample_count = std::max(4U, (settings.min_sample_count + 3U) & (~3U));
+	uint32_t const max_sample_count = std::max(min_sample_count, std::min(65532U, (settings.max_sample_count + 3U) & (~3U)));
+
+	float const *const light = &m_scene.rect_light_vertices[0][0];
+	simd_float3 const light_v0 = simd_float3_broadcast(light[0], light[1], light[2]);
+	simd_float3 const light_e1 = simd_float3_broadcast(light[3] - light[0], light[4] - light[1], light[5] - light[2]);
+	simd_float3 const light_e3 = simd_float3_broadcast(light[9] - light[0], light[10] - light[1], light[11] - light[2]);
+	// the same facing as "EvaluateBRDFLTCLightAttenuation"
+	simd_float3 const light_normal = normalize(cross(light_e1, simd_float3_broadcast(light[6] - light[0], light[7] - light[1], light[8] - light[2])));
+
+	float const diffuse_albedo = (m_scene.diffuse_color[0] + m_scene.diffuse_color[1] + m_scene.diffuse_color[2]) * (1.0f / 3.0f);
+	float const specular_albedo = (m_scene.specular_color[0] + m_scene.specular_color[1] + m_scene.specular_color[2]) * (1.0f / 3.0f);
+
+	// the R2 sequence [Roberts 2018], each pixel is randomly rotated (Cranley-Patterson)
+	float lane_offset_u[4];
+	float lane_offset_v[4];
+	for (int lane = 0; lane < 4; ++lane)
+	{
+		lane_offset_u[lane] = std::fmod(0.7548776662f * static_cast<float>(lane), 1.0f);
+		lane_offset_v[lane] = std::fmod(0.5698402910f * static_cast<float>(lane), 1.0f);
+	}
+	simd_float const sequence_offset_u = _mm_loadu_ps(lane_offset_u);
+	simd_float const sequence_offset_v = _mm_loadu_ps(lane_offset_v);
+
+	uint32_t const thread_count = thread_pool->GetThreadCount();
+	uint64_t *const thread_shadow_ray_count = m_scratch.Allocate<uint64_t>(thread_count);
+	uint32_t *const thread_penumbra_pixel_count = m_scratch.Allocate<uint32_t>(thread_count);
+	uint32_t *const thread_lit_pixel_count = m_scratch.Allocate<uint32_t>(thread_count);
+	uint32_t *const thread_max_pixel_sample_count = m_scratch.Allocate<uint32_t>(thread_count);
+	memset(thread_shadow_ray_count, 0, sizeof(uint64_t) * thread_count);
+	memset(thread_penumbra_pixel_count, 0, sizeof(uint32_t) * thread_count);
+	memset(thread_lit_pixel_count, 0, sizeof(uint32_t) * thread_count);
+	memset(thread_max_pixel_sample_count, 0, sizeof(uint32_t) * thread_count);
+
+	thread_pool->ParallelFor(m_height, 2U, [&](uint32_t begin, uint32_t end, uint32_t thread_index) {
+		for (uint32_t y = begin; y < end; ++y)
+		{
+			for (uint32_t x = 0U; x < m_width; ++x)
+			{
+				size_t const pixel_index = static_cast<size_t>(m_width) * y + x;
+
+				m_shadow_ratio[pixel_index] = 1.0f;
+				m_shadow_sample_count[pixel_index] = 0U;
+
+				float const *const unshadowed = &m_unshadowed_radiance[3U * pixel_index];
+				if (!(m_depth[pixel_index] < INFINITY) || !((unshadowed[0] + unshadowed[1] + unshadowed[2]) > 0.0f))
+				{
+					continue;
+				}
+
+				++thread_lit_pixel_count[thread_index];
+
+				simd_float3 const P = simd_float3_broadcast(m_position[3U * pixel_index + 0U], m_position[3U * pixel_index + 1U], m_position[3U * pixel_index + 2U]);
+				simd_float3 const N = simd_float3_broadcast(m_normal[3U * pixel_index + 0U], m_normal[3U * pixel_index + 1U], m_normal[3U * pixel_index + 2U]);
+				simd_float3 const V = normalize(simd_float3_broadcast(m_scene.eye_position[0], m_scene.eye_position[1], m_scene.eye_position[2]) - P);
+				simd_float3 const origin = P + N * simd_float(g_software_renderer_shadow_ray_offset);
+
+				uint32_t const seed = software_renderer_hash(static_cast<uint32_t>(pixel_index) ^ software_renderer_hash(frame_index));
+				float const rotation_u = static_cast<float>(seed & 0XFFFFU) * (1.0f / 65536.0f);
+				float const rotation_v = static_cast<float>(seed >> 16U) * (1.0f / 65536.0f);
+
+				// Σw, Σw·v, Σw², Σw²·v
+				float sum_weight = 0.0f;
+				float sum_weight_visibility = 0.0f;
+				float sum_weight_squared = 0.0f;
+				float sum_weight_squared_visibility = 0.0f;
+
+				uint32_t sample_count = 0U;
+				while (sample_count < max_sample_count)
+				{
+					simd_float u = simd_float(rotation_u + 0.7548776662f * static_cast<float>(sample_count)) + sequence_offset_u;
+					simd_float v = simd_float(rotation_v + 0.5698402910f * static_cast<float>(sample_count)) + sequence_offset_v;
+					u = u - floor(u);
+					v = v - floor(v);
+
+					simd_float3 const L_unnormalized = light_v0 + light_e1 * u + light_e3 * v - P;
+					simd_float const distance_squared = dot(L_unnormalized, L_unnormalized);
+					simd_float3 const L = L_unnormalized * rsqrt(distance_squared);
+
+					simd_float const cos_light = dot(L, light_normal);
+					simd_float weight = software_renderer_brdf_weight(N, V, L, diffuse_albedo, specular_albedo, m_scene.roughness) * max(cos_light, simd_float(0.0f)) / distance_squared;
+					simd_float const valid = weight > simd_float(0.0f);
+					weight = weight & valid;
+
+					// The shadow rays end right before the light
+					simd_float const occluded = m_bvh.Occluded(origin, L_unnormalized, simd_float(0.0f), simd_float(1.0f - 1e-4f), valid);
+					simd_float const visibility = select(occluded, simd_float(0.0f), simd_float(1.0f)) & valid;
+
+					sum_weight += software_renderer_horizontal_sum(weight);
+					sum_weight_visibility += software_renderer_horizontal_sum(weight * visibility);
+					sum_weight_squared += software_renderer_horizontal_sum(weight * weight);
+					sum_weight_squared_visibility += software_renderer_horizontal_sum(weight * weight * visibility);
+
+					int const valid_lanes = movemask(valid);
+					thread_shadow_ray_count[thread_index] += static_cast<uint64_t>((valid_lanes & 1) + ((valid_lanes >> 1) & 1) + ((valid_lanes >> 2) & 1) + ((valid_lanes >> 3) & 1));
+					sample_count += 4U;
+
+					if (sample_count >= min_sample_count)
+					{
+						if (!(sum_weight > 0.0f))
+						{
+							break;
+						}
+
+						// The standard error of the weighted mean (v ∈ {0, 1} such that v² = v)
+						// Σw²(v - r)² = Σw²·v·(1 - 2r) + r²·Σw²
+						float const ratio = sum_weight_visibility / sum_weight;
+						float const variance_sum = std::max(sum_weight_squared_visibility * (1.0f - 2.0f * ratio) + ratio * ratio * sum_weight_squared, 0.0f);
+						float const standard_error = std::sqrt(variance_sum) / sum_weight;
+						if (standard_error <= settings.target_standard_error)
+						{
+							break;
+						}
+					}
+				}
+
+				float const ratio = (sum_weight > 0.0f) ? (sum_weight_visibility / sum_weight) : 1.0f;
+				m_shadow_ratio[pixel_index] = ratio;
+				m_shadow_sample_count[pixel_index] = static_cast<uint16_t>(sample_count);
+
+				if (ratio > 0.0f && ratio < 1.0f)
+				{
+					++thread_penumbra_pixel_count[thread_index];
+				}
+
+				thread_max_pixel_sample_count[thread_index] = std::max(thread_max_pixel_sample_count[thread_index], sample_count);
+			}
+		}
+	});
+
+	for (uint32_t thread_index = 0U; thread_index < thread_count; ++thread_index)
+	{
+		statistics.shadow_ray_count += thread_shadow_ray_count[thread_index];
+		statistics.penumbra_pixel_count += thread_penumbra_pixel_count[thread_index];
+		statistics.lit_pixel_count += thread_lit_pixel_count[thread_index];
+		statistics.max_pixel_sample_count = std::max(statistics.max_pixel_sample_count, thread_max_pixel_sample_count[thread_index]);
+	}
+}
+
+void SoftwareRenderer::PassDenoise(ThreadPool *thread_pool, software_renderer_statistics_t &statistics)
+{
+	uint32_t const tile_count_x = (m_width + g_software_renderer_tile_size - 1U) / g_software_renderer_tile_size;
+	uint32_t const tile_count_y = (m_height + g_software_renderer_tile_size - 1U) / g_software_renderer_tile_size;
+
+	float spatial_weights[2 * g_software_renderer_denoise_radius + 1][2 * g_software_renderer_denoise_radius + 1];
+	for (int dy = -g_software_renderer_denoise_radius; dy <= g_software_renderer_denoise_radius; ++dy)
+	{
+		for (int dx = -g_software_renderer_denoise_radius; dx <= g_software_renderer_denoise_radius; ++dx)
+		{
+			spatial_weights[dy + g_software_renderer_denoise_radius][dx + g_software_renderer_denoise_radius] = std::exp(-static_cast<float>(dx * dx + dy * dy) / (2.0f * g_software_renderer_denoise_sigma_spatial * g_software_renderer_denoise_sigma_spatial));
+		}
+	}
+
+	uint32_t const thread_count = thread_pool->GetThreadCount();
+	uint32_t *const thread_denoised_tile_count = m_scratch.Allocate<uint32_t>(thread_count);
+	memset(thread_denoised_tile_count, 0, sizeof(uint32_t) * thread_count);
+
+	thread_pool->ParallelFor(tile_count_x * tile_count_y, 4U, [&](uint32_t begin, uint32_t end, uint32_t thread_index) {
+		for (uint32_t tile_index = begin; tile_index < end; ++tile_index)
+		{
+			int const tile_x0 = static_cast<int>((tile_index % tile_count_x) * g_software_renderer_tile_size);
+			int const tile_y0 = static_cast<int>((tile_index / tile_count_x) * g_software_renderer_tile_size);
+			int const tile_x1 = std::min(tile_x0 + static_cast<int>(g_software_renderer_tile_size), static_cast<int>(m_width));
+			int const tile_y1 = std::min(tile_y0 + static_cast<int>(g_software_renderer_tile_size), static_cast<int>(m_height));
+
+			// The tile (including the apron) without any penumbra is NOT filtered.
+			bool penumbra = false;
+			for (int y = std::max(tile_y0 - g_software_renderer_denoise_radius, 0); y < std::min(tile_y1 + g_software_renderer_denoise_radius, static_cast<int>(m_height)) && !penumbra; ++y)
+			{
+				for (int x = std::max(tile_x0 - g_software_renderer_denoise_radius, 0); x < std::min(tile_x1 + g_software_renderer_denoise_radius, static_cast<int>(m_width)); ++x)
+				{
+					float const ratio = m_shadow_ratio[static_cast<size_t>(m_width) * y + x];
+					if (ratio > 0.0f && ratio < 1.0f)
+					{
+						penumbra = true;
+						break;
+					}
+				}
+			}
+
+			if (!penumbra)
+			{
+				for (int y = tile_y0; y < tile_y1; ++y)
+				{
+					for (int x = tile_x0; x < tile_x1; ++x)
+					{
+						size_t const pixel_index = static_cast<size_t>(m_width) * y + x;
+						m_shadow_ratio_denoised[pixel_index] = m_shadow_ratio[pixel_index];
+					}
+				}
+				continue;
+			}
+
+			++thread_denoised_tile_count[thread_index];
+
+			for (int y = tile_y0; y < tile_y1; ++y)
+			{
+				for (int x = tile_x0; x < tile_x1; ++x)
+				{
+					size_t const pixel_index = static_cast<size_t>(m_width) * y + x;
+
+					float const center_depth = m_depth[pixel_index];
+					if (!(center_depth < INFINITY) || 0U == m_shadow_sample_count[pixel_index])
+					{
+						m_shadow_ratio_denoised[pixel_index] = m_shadow_ratio[pixel_index];
+						continue;
+					}
+
+					float const *const center_normal = &m_normal[3U * pixel_index];
+
+					float sum_weight = 0.0f;
+					float sum_weight_ratio = 0.0f;
+					for (int dy = -g_software_renderer_denoise_radius; dy <= g_software_renderer_denoise_radius; ++dy)
+					{
+						int const neighbor_y = y + dy;
+						if (neighbor_y < 0 || neighbor_y >= static_cast<int>(m_height))
+						{
+							continue;
+						}
+
+						for (int dx = -g_software_renderer_denoise_radius; dx <= g_software_renderer_denoise_radius; ++dx)
+						{
+							int const neighbor_x = x + dx;
+							if (neighbor_x < 0 || neighbor_x >= static_cast<int>(m_width))
+							{
+								continue;
+							}
+
+							size_t const neighbor_index = static_cast<size_t>(m_width) * neighbor_y + neighbor_x;
+							float const neighbor_depth = m_depth[neighbor_index];
+							if (!(neighbor_depth < INFINITY) || 0U == m_shadow_sample_count[neighbor_index])
+							{
+								continue;
+							}
+
+							float const *const neighbor_normal = &m_normal[3U * neighbor_index];
+							float const normal_similarity = std::max(center_normal[0] * neighbor_normal[0] + center_normal[1] * neighbor_normal[1] + center_normal[2] * neighbor_normal[2], 0.0f);
+
+							// The neighbors with more samples are more confident.
+							float const weight =
+								spatial_weights[dy + g_software_renderer_denoise_radius][dx + g_software_renderer_denoise_radius] *
+								std::exp(-std::abs(center_depth - neighbor_depth) / (g_software_renderer_denoise_sigma_depth * center_depth)) *
+								std::pow(normal_similarity, g_software_renderer_denoise_normal_power) *
+								static_cast<float>(m_shadow_sample_count[neighbor_index]);
+
+							sum_weight += weight;
+							sum_weight_ratio += weight * m_shadow_ratio[neighbor_index];
+						}
+					}
+
+					m_shadow_ratio_denoised[pixel_index] = (sum_weight > 0.0f) ? (sum_weight_ratio / sum_weight) : m_shadow_ratio[pixel_index];
+				}
+			}
+		}
+	});
+
+	statistics.tile_count = tile_count_x * tile_count_y;
+	for (uint32_t thread_index = 0U; thread_index < thread_count; ++thread_index)
+	{
+		statistics.denoised_tile_count += thread_denoised_tile_count[thread_index];
+	}
+}
+
+void SoftwareRenderer::PassComposite(ThreadPool *thread_pool, bool shadowed)
+{
+	thread_pool->ParallelFor(m_height, 16U, [&](uint32_t begin, uint32_t end, uint32_t) {
+		for (uint32_t y = begin; y < end; ++y)
+		{
+			for (uint32_t x = 0U; x < m_width; ++x)
+			{
+				size_t const pixel_index = static_cast<size_t>(m_width) * y + x;
+
+				if (0U != m_emissive[pixel_index])
+				{
+					m_radiance[3U * pixel_index + 0U] = m_scene.intensity;
+					m_radiance[3U * pixel_index + 1U] = m_scene.intensity;
+					m_radiance[3U * pixel_index + 2U] = m_scene.intensity;
+					continue;
+				}
+
+				float const ratio = shadowed ? m_shadow_ratio_denoised[pixel_index] : 1.0f;
+				m_radiance[3U * pixel_index + 0U] = m_unshadowed_radiance[3U * pixel_index + 0U] * ratio;
+				m_radiance[3U * pixel_index + 1U] = m_unshadowed_radiance[3U * pixel_index + 1U] * ratio;
+				m_radiance[3U * pixel_index + 2U] = m_unshadowed_radiance[3U * pixel_index + 2U] * ratio;
+			}
+		}
+	});
+}
+
+void SoftwareRenderer::RejectDepth(ThreadPool *thread_pool, float const *visible_depth, software_renderer_statistics_t &statistics)
+{
+	uint32_t const thread_count = thread_pool->GetThreadCount();
+	uint32_t *const thread_rejected_pixel_counts = m_scratch.Allocate<uint32_t>(thread_count);
+	memset(thread_rejected_pixel_counts, 0, sizeof(uint32_t) * thread_count);
+
+	thread_pool->ParallelFor(m_height, 8U, [&](uint32_t begin, uint32_t end, uint32_t thread_index) {
+		for (size_t pixel_index = static_cast<size_t>(begin) * m_width; pixel_index < static_cast<size_t>(end) * m_width; ++pixel_index)
+		{
+			// the same ray cast of the same triangles, such that the visible surface is exactly equal
+			if (m_depth[pixel_index] < INFINITY && m_depth[pixel_index] != visible_depth[pixel_index])
+			{
+				m_depth[pixel_index] = INFINITY;
+				++thread_rejected_pixel_counts[thread_index];
+			}
+		}
+	});
+
+	for (uint32_t thread_index = 0U; thread_index < thread_count; ++thread_index)
+	{
+		statistics.depth_rejected_pixel_count += thread_rejected_pixel_counts[thread_index];
+	}
+}
+
+void SoftwareRenderer::RejectCheckerboard(ThreadPool *thread_pool, uint32_t parity, software_renderer_statistics_t &statistics)
+{
+	uint32_t const thread_count = thread_pool->GetThreadCount();
+	uint32_t *const thread_skipped_pixel_counts = m_scratch.Allocate<uint32_t>(thread_count);
+	memset(thread_skipped_pixel_counts, 0, sizeof(uint32_t) * thread_count);
+
+	thread_pool->ParallelFor(m_height, 8U, [&](uint32_t begin, uint32_t end, uint32_t thread_index) {
+		for (uint32_t y = begin; y < end; ++y)
+		{
+			// the first skipped pixel of the row
+			for (uint32_t x = ((y + parity + 1U) & 1U); x < m_width; x += 2U)
+			{
+				size_t const pixel_index = static_cast<size_t>(m_width) * y + x;
+				if (m_depth[pixel_index] < INFINITY)
+				{
+					m_depth[pixel_index] = INFINITY;
+					++thread_skipped_pixel_counts[thread_index];
+				}
+			}
+		}
+	});
+
+	for (uint32_t thread_index = 0U; thread_index < thread_count; ++thread_index)
+	{
+		statistics.checkerboard_skipped_pixel_count += thread_skipped_pixel_counts[thread_index];
+	}
+}
+
+uint32_t SoftwareRenderer::GetWidth() const
+{
+	return m_width;
+}
+
+uint32_t SoftwareRenderer::GetHeight() const
+{
+	return m_height;
+}
+
+BVH const &SoftwareRenderer::GetBVH() const
+{
+	return m_bvh;
+}
+
+float const *SoftwareRenderer::GetPosition() const
+{
+	return &m_position[0];
+}
+
+float const *SoftwareRenderer::GetNormal() const
+{
+	return &m_normal[0];
+}
+
+float const *SoftwareRenderer::GetDepth() const
+{
+	return &m_depth[0];
+}
+
+uint8_t const *SoftwareRenderer::GetEmissive() const
+{
+	return &m_emissive[0];
+}
+
+float const *SoftwareRenderer::GetRadiance() const
+{
+	return &m_radiance[0];
+}
+
+float const *SoftwareRenderer::GetShadowRatio() const
+{
+	return &m_shadow_ratio_denoised[0];
+}
+
+uint16_t const *SoftwareRenderer::GetShadowSampleCount() const
+{
+	return &m_shadow_sample_count[0];
+}
+
+static inline double software_renderer_milliseconds_since(std::chrono::steady_clock::time_point begin)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+}
+
+static inline simd_float software_renderer_brdf_weight(simd_float3 N, simd_float3 V, simd_float3 L, float diffuse_albedo, float specular_albedo, float roughness)
+{
+	simd_float3 const H = normalize(V + L);
+	simd_float const NoL = saturate(dot(N, L));
+	simd_float const NoV = max(dot(N, V), simd_float(1e-4f));
+	simd_float const NoH = saturate(dot(N, H));
+
+	// UE4: D_GGX
+	simd_float const a = simd_float(roughness * roughness);
+	simd_float const a2 = a * a;
+	simd_float const d = (NoH * a2 - NoH) * NoH + simd_float(1.0f);
+	simd_float const D = a2 / (simd_float(SIMD_PI) * d * d);
+
+	// UE4: Vis_SmithJointApprox
+	simd_float const Vis_SmithV = NoL * (NoV * (simd_float(1.0f) - a) + a);
+	simd_float const Vis_SmithL = NoV * (NoL * (simd_float(1.0f) - a) + a);
+	simd_float const Vis = simd_float(0.5f) / max(Vis_SmithV + Vis_SmithL, simd_float(1e-7f));
+
+	return (simd_float(diffuse_albedo * (1.0f / SIMD_PI)) + D * Vis * simd_float(specular_albedo)) * NoL;
+}
+
+static inline float software_renderer_horizontal_sum(simd_float a)
+{
+	__m128 shuffle = _mm_shuffle_ps(a.v, a.v, _MM_SHUFFLE(2, 3, 0, 1));
+	__m128 sum = _mm_add_ps(a.v, shuffle);
+	shuffle = _mm_movehl_ps(shuffle, sum);
+	sum = _mm_add_ss(sum, shuffle);
+	return _mm_cvtss_f32(sum);
+}
+
+static inline uint32_t software_renderer_hash(uint32_t x)
+{
+	// [Jarzynski 2020] PCG hash
+	uint32_t state = x * 747796405U + 2891336453U;
+	uint32_t word = ((state >> ((state >> 28U) + 4U)) ^ state) * 277803737U;
+	return (word >> 22U) ^ word;
+}
@@ -0,0 +1,165 @@
+#ifndef _CPU_SOFTWARE_RENDERER_H_
+#define _CPU_SOFTWARE_RENDERER_H_ 1
+
+//
+// The CPU renderer of the demo scene, used by the headless mode (see "support/headless_main.h").
+//
+// The primary visibility is ray cast against the BVH, the rect light is shaded by the CPU port of the LTC ("ltc.h").
+// The area light shadows are estimated by the ratio estimator:
+// [Heitz 2018] [Eric Heitz, Stephen Hill, Morgan McGuire. "Combining Analytic Direct Illumination and Stochastic Shadows." I3D 2018.](https://eheitzresearch.wordpress.com/705-2/)
+// shadowed = LTC(unshadowed) * (Σ BRDF·cos·visibility / pdf) / (Σ BRDF·cos / pdf)
+// The same light samples are used by both sums, such that the noise is only in the penumbra.
+//
+
+#include <stdint.h>
+#include <vector>
+
+#include "bvh.h"
+#include "frame_arena.h"
+
+struct software_renderer_scene_t
+{
+	// 9 floats (3 vertices) per triangle, all triangles share the material below
+	float const *triangle_vertices;
+	uint32_t triangle_count;
+
+	// material (linear)
+	float diffuse_color[3];
+	float specular_color[3];
+	float roughness;
+
+	// light
+	// The quad is NOT in the triangles (the light does not occlude itself).
+	// The facing of the quad is determined by the winding order of the vertices (the same as the "EvaluateBRDFLTCLightAttenuation").
+	float rect_light_vertices[4][3];
+	float intensity;
+
+	// camera (right handed, the same as the "XMMatrixLookToRH")
+	float eye_position[3];
+	float eye_direction[3];
+	float up_direction[3];
+	float fov_angle_y;
+};
+
+struct software_renderer_shadow_settings_t
+{
+	// The samples are traced in packets of 4. Both counts are rounded up to the multiple of 4.
+	// 0 means "unshadowed".
+	uint32_t min_sample_count;
+	uint32_t max_sample_count;
+	// The pixel stops sampling once the standard error of the ratio is below this value (after the "min_sample_count").
+	float target_standard_error;
+	bool denoise;
+};
+
+struct software_renderer_statistics_t
+{
+	double primary_milliseconds;
+	double shading_milliseconds;
+	double shadow_milliseconds;
+	double denoise_milliseconds;
+	double total_milliseconds;
+
+	// the paths of the "PassShading" (the pixels which hit the scene)
+	// back face: the surface is behind the light
+	// below: the light is entirely below the horizon of the surface
+	// above: the light is entirely above the horizon of the surface (NOT clipped)
+	// straddle: the light is clipped to the horizon of the surface
+	uint32_t light_back_face_pixel_count;
+	uint32_t horizon_below_pixel_count;
+	uint32_t horizon_above_pixel_count;
+	uint32_t horizon_straddle_pixel_count;
+
+	uint64_t shadow_ray_count;
+	// the pixels of which the ratio is neither 0 nor 1
+	uint32_t penumbra_pixel_count;
+	// the pixels of which the light is in front of the surface
+	uint32_t lit_pixel_count;
+	uint32_t max_pixel_sample_count;
+	uint32_t denoised_tile_count;
+	uint32_t tile_count;
+	// the pixels of the G-buffer which are NOT shaded by the "RenderLighting" (see the "RejectDepth")
+	uint32_t depth_rejected_pixel_count;
+	// the pixels of the G-buffer which are NOT shaded by the "RenderLighting" (see the "RejectCheckerboard")
+	uint32_t checkerboard_skipped_pixel_count;
+};
+
+class SoftwareRenderer
+{
+	uint32_t m_width;
+	uint32_t m_height;
+
+	BVH m_bvh;
+	software_renderer_scene_t m_scene;
+
+	// the transient memory of the "SetScene" and the "Render", such that the steady state frame never allocates from the heap
+	FrameArena m_scratch;
+
+	// G-buffer
+	// depth: the distance to the eye, INFINITY if missed
+	std::vector<float> m_position;
+	std::vector<float> m_normal;
+	std::vector<float> m_depth;
+	std::vector<uint8_t> m_emissive;
+
+	std::vector<float> m_unshadowed_radiance;
+	std::vector<float> m_shadow_ratio;
+	std::vector<float> m_shadow_ratio_denoised;
+	std::vector<uint16_t> m_shadow_sample_count;
+
+	// RGB32F, the row 0 is the top of the image
+	std::vector<float> m_radiance;
+
+	void PassPrimary(class ThreadPool *thread_pool);
+	void PassShading(class ThreadPool *thread_pool, software_renderer_statistics_t &statistics);
+	void PassShadow(class ThreadPool *thread_pool, software_renderer_shadow_settings_t const &settings, uint32_t frame_index, software_renderer_statistics_t &statistics);
+	void PassDenoise(class ThreadPool *thread_pool, software_renderer_statistics_t &statistics);
+	void PassComposite(class ThreadPool *thread_pool, bool shadowed);
+
+public:
+	void Init(uint32_t width, uint32_t height);
+	void Destroy();
+
+	// The triangles are copied into the BVH.
+	void SetScene(software_renderer_scene_t const &scene);
+	// the camera of the "SetScene" is replaced (e.g. along the camera path), the BVH is kept
+	void SetCamera(float const eye_position[3], float const eye_direction[3], float const up_direction[3]);
+
+	// [in] frame_index: the seed of the light samples
+	void Render(class ThreadPool *thread_pool, software_renderer_shadow_settings_t const &settings, uint32_t frame_index, software_renderer_statistics_t &statistics);
+
+	// The "Render" split into the two steps of the deferred shading (see "backend/render_backend_cpu.h").
+	// RenderGBuffer: the primary visibility only, the statistics are reset.
+	// RenderLighting: the shading, the shadows and the composite of the G-buffer of the last "RenderGBuffer", the statistics are accumulated.
+	void RenderGBuffer(class ThreadPool *thread_pool, software_renderer_statistics_t &statistics);
+	void RenderLighting(class ThreadPool *thread_pool, software_renderer_shadow_settings_t const &settings, uint32_t frame_index, software_renderer_statistics_t &statistics);
+	// The early depth rejection between the "RenderGBuffer" and the "RenderLighting" (the "equal" depth test after the depth pre-pass, see "backend/render_backend_cpu.h").
+	// The pixel of which the depth is NOT equal to the "visible_depth" is treated as missed, such that the "RenderLighting" skips it.
+	// [in] visible_depth: the same layout as the "GetDepth"
+	void RejectDepth(class ThreadPool *thread_pool, float const *visible_depth, software_renderer_statistics_t &statistics);
+	// The checkerboard shading between the "RenderGBuffer" and the "RenderLighting" (see "checkerboard_resolve_fs.hlsl").
+	// The pixel of which the "(x + y + parity) & 1" is NOT 0 is treated as missed, such that the "RenderLighting" skips it.
+	void RejectCheckerboard(class ThreadPool *thread_pool, uint32_t parity, software_renderer_statistics_t &statistics);
+
+	uint32_t GetWidth() const;
+	uint32_t GetHeight() const;
+	BVH const &GetBVH() const;
+
+	// G-buffer
+	// RGB32F, the normal faces the eye
+	float const *GetPosition() const;
+	float const *GetNormal() const;
+	// R32F, the distance to the eye, INFINITY if missed (or the emissive quad)
+	float const *GetDepth() const;
+	// R8, 1 where the emissive quad is visible
+	uint8_t const *GetEmissive() const;
+
+	// RGB32F
+	float const *GetRadiance() const;
+	// R32F (denoised if enabled)
+	float const *GetShadowRatio() const;
+	// R16UI
+	uint16_t const *GetShadowSampleCount() const;
+};
+
+#endif
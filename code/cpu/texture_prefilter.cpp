@@ -0,0 +1,253 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <assert.h>
+#include <cmath>
+#include <algorithm>
+#include <vector>
+#include <xmmintrin.h>
+
+#include "half.h"
+#include "thread_pool.h"
+#include "texture_prefilter.h"
+
+// The Gaussian filter applied before each 2x downsampling (in the texels of the finer level).
+static const float g_prefilter_gaussian_sigma = 1.0F;
+// The taps are symmetric around the center of the 2x2 footprint (between the texel "2x" and the texel "2x + 1").
+static const int g_prefilter_tap_count = 8;
+static const int g_prefilter_tap_first = -3;
+
+static inline uint64_t prefilter_align_up(uint64_t value, uint64_t alignment);
+
+// [in] tap_index: g_prefilter_tap_count indices (clamped to the source) per output texel
+static void prefilter_build_tap_index(uint32_t source_size, uint32_t destination_size, std::vector<uint32_t> &tap_index);
+
+void PrefilterAreaLightTexture(ThreadPool *thread_pool, float const *light_image, uint32_t light_width, uint32_t light_height, std::vector<uint8_t> &prefiltered_texture)
+{
+	assert(light_width > 0U && light_height > 0U);
+
+	// The light occupies the center 75% of the level 0 (the same as the "0.125 + 0.75 * uv" of the original implementation).
+	uint32_t const border_x = (light_width + 5U) / 6U;
+	uint32_t const border_y = (light_height + 5U) / 6U;
+
+	area_light_texture_header_t header;
+	memset(&header, 0, sizeof(area_light_texture_header_t));
+	header.magic = AREA_LIGHT_TEXTURE_MAGIC;
+	header.version = AREA_LIGHT_TEXTURE_VERSION;
+	header.light_width = light_width;
+	header.light_height = light_height;
+
+	{
+		uint32_t width = light_width + 2U * border_x;
+		uint32_t height = light_height + 2U * border_y;
+
+		header.uv_scale_bias[0] = static_cast<float>(light_width) / static_cast<float>(width);
+		header.uv_scale_bias[1] = static_cast<float>(light_height) / static_cast<float>(height);
+		header.uv_scale_bias[2] = static_cast<float>(border_x) / static_cast<float>(width);
+		header.uv_scale_bias[3] = static_cast<float>(border_y) / static_cast<float>(height);
+
+		// the full mip chain (the same rule as the D3D11: max(1, size >> level))
+		uint32_t level_count = 0U;
+		for (;;)
+		{
+			header.levels[level_count].width = width;
+			header.levels[level_count].height = height;
+			header.levels[level_count].row_pitch = width * AREA_LIGHT_TEXTURE_TEXEL_SIZE;
+			header.levels[level_count].size = static_cast<uint64_t>(header.levels[level_count].row_pitch) * height;
+			++level_count;
+
+			if ((1U == width && 1U == height) || (AREA_LIGHT_TEXTURE_MAX_LEVEL_COUNT == level_count))
+			{
+				break;
+			}
+
+			width = std::max(1U, width >> 1U);
+			height = std::max(1U, height >> 1U);
+		}
+		header.level_count = level_count;
+	}
+
+	// The layout
+	{
+		// The levels smaller than a chunk are packed in the mip tail (which may span more than 1 chunk in total).
+		uint32_t mip_tail_first_level = header.level_count;
+		while (mip_tail_first_level > 0U && header.levels[mip_tail_first_level - 1U].size < AREA_LIGHT_TEXTURE_CHUNK_ALIGNMENT)
+		{
+			--mip_tail_first_level;
+		}
+		header.mip_tail_first_level = mip_tail_first_level;
+
+		// from the coarse to the fine
+		uint64_t offset = prefilter_align_up(static_cast<uint64_t>(sizeof(area_light_texture_header_t)), 16U);
+		for (uint32_t level_index = header.level_count; level_index > mip_tail_first_level; --level_index)
+		{
+			header.levels[level_index - 1U].offset = offset;
+			offset = prefilter_align_up(offset + header.levels[level_index - 1U].size, 16U);
+		}
+		offset = prefilter_align_up(offset, static_cast<uint64_t>(AREA_LIGHT_TEXTURE_CHUNK_ALIGNMENT));
+		header.mip_tail_chunk_size = offset;
+
+		for (uint32_t level_index = mip_tail_first_level; level_index > 0U; --level_index)
+		{
+			header.levels[level_index - 1U].offset = offset;
+			offset = prefilter_align_up(offset + header.levels[level_index - 1U].size, static_cast<uint64_t>(AREA_LIGHT_TEXTURE_CHUNK_ALIGNMENT));
+		}
+		header.total_size = offset;
+	}
+
+	prefiltered_texture.assign(static_cast<size_t>(header.total_size), 0U);
+	memcpy(&prefiltered_texture[0], &header, sizeof(area_light_texture_header_t));
+
+	// RGBA32F
+	std::vector<float> current_level(static_cast<size_t>(header.levels[0].width) * header.levels[0].height * 4U);
+	std::vector<float> horizontal_level;
+	std::vector<float> next_level;
+
+	std::vector<uint32_t> tap_index_x;
+	std::vector<uint32_t> tap_index_y;
+
+	float tap_weights[g_prefilter_tap_count];
+	{
+		float weight_sum = 0.0F;
+		for (int tap = 0; tap < g_prefilter_tap_count; ++tap)
+		{
+			float distance = static_cast<float>(g_prefilter_tap_first + tap) - 0.5F;
+			tap_weights[tap] = std::exp(-(distance * distance) / (2.0F * g_prefilter_gaussian_sigma * g_prefilter_gaussian_sigma));
+			weight_sum += tap_weights[tap];
+		}
+
+		for (int tap = 0; tap < g_prefilter_tap_count; ++tap)
+		{
+			tap_weights[tap] /= weight_sum;
+		}
+	}
+
+	// Level 0: border extension
+	{
+		uint32_t const width = header.levels[0].width;
+		float *const destination = &current_level[0];
+
+		thread_pool->ParallelFor(header.levels[0].height, 16U, [&](uint32_t begin, uint32_t end, uint32_t) {
+			for (uint32_t y = begin; y < end; ++y)
+			{
+				uint32_t const source_y = static_cast<uint32_t>(std::min(std::max(static_cast<int>(y) - static_cast<int>(border_y), 0), static_cast<int>(light_height) - 1));
+				for (uint32_t x = 0U; x < width; ++x)
+				{
+					uint32_t const source_x = static_cast<uint32_t>(std::min(std::max(static_cast<int>(x) - static_cast<int>(border_x), 0), static_cast<int>(light_width) - 1));
+					_mm_storeu_ps(destination + (static_cast<size_t>(width) * y + x) * 4U, _mm_loadu_ps(light_image + (static_cast<size_t>(light_width) * source_y + source_x) * 4U));
+				}
+			}
+		});
+	}
+
+	for (uint32_t level_index = 0U; level_index < header.level_count; ++level_index)
+	{
+		area_light_texture_level_t const &level = header.levels[level_index];
+
+		// RGBA32F -> RGBA16F
+		{
+			float const *const source = &current_level[0];
+			uint8_t *const destination = &prefiltered_texture[static_cast<size_t>(level.offset)];
+
+			thread_pool->ParallelFor(level.height, 16U, [&](uint32_t begin, uint32_t end, uint32_t) {
+				for (uint32_t y = begin; y < end; ++y)
+				{
+					uint16_t *const destination_row = reinterpret_cast<uint16_t *>(destination + static_cast<size_t>(level.row_pitch) * y);
+					float const *const source_row = source + static_cast<size_t>(level.width) * y * 4U;
+					for (uint32_t i = 0U; i < (level.width * 4U); ++i)
+					{
+						destination_row[i] = float_to_half(source_row[i]);
+					}
+				}
+			});
+		}
+
+		if ((level_index + 1U) >= header.level_count)
+		{
+			break;
+		}
+
+		area_light_texture_level_t const &next = header.levels[level_index + 1U];
+
+		prefilter_build_tap_index(level.width, next.width, tap_index_x);
+		prefilter_build_tap_index(level.height, next.height, tap_index_y);
+
+		horizontal_level.resize(static_cast<size_t>(next.width) * level.height * 4U);
+		next_level.resize(static_cast<size_t>(next.width) * next.height * 4U);
+
+		// Horizontal: level.width x level.height -> next.width x level.height
+		{
+			float const *const source = &current_level[0];
+			float *const destination = &horizontal_level[0];
+			uint32_t const *const tap_index = &tap_index_x[0];
+
+			thread_pool->ParallelFor(level.height, 8U, [&](uint32_t begin, uint32_t end, uint32_t) {
+				for (uint32_t y = begin; y < end; ++y)
+				{
+					float const *const source_row = source + static_cast<size_t>(level.width) * y * 4U;
+					float *const destination_row = destination + static_cast<size_t>(next.width) * y * 4U;
+					for (uint32_t x = 0U; x < next.width; ++x)
+					{
+						uint32_t const *const taps = tap_index + static_cast<size_t>(g_prefilter_tap_count) * x;
+						__m128 sum = _mm_setzero_ps();
+						for (int tap = 0; tap < g_prefilter_tap_count; ++tap)
+						{
+							sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(tap_weights[tap]), _mm_loadu_ps(source_row + static_cast<size_t>(taps[tap]) * 4U)));
+						}
+						_mm_storeu_ps(destination_row + static_cast<size_t>(x) * 4U, sum);
+					}
+				}
+			});
+		}
+
+		// Vertical: next.width x level.height -> next.width x next.height
+		{
+			float const *const source = &horizontal_level[0];
+			float *const destination = &next_level[0];
+			uint32_t const *const tap_index = &tap_index_y[0];
+
+			thread_pool->ParallelFor(next.height, 4U, [&](uint32_t begin, uint32_t end, uint32_t) {
+				for (uint32_t y = begin; y < end; ++y)
+				{
+					float const *source_rows[g_prefilter_tap_count];
+					for (int tap = 0; tap < g_prefilter_tap_count; ++tap)
+					{
+						source_rows[tap] = source + static_cast<size_t>(next.width) * tap_index[static_cast<size_t>(g_prefilter_tap_count) * y + tap] * 4U;
+					}
+
+					float *const destination_row = destination + static_cast<size_t>(next.width) * y * 4U;
+					for (uint32_t x = 0U; x < next.width; ++x)
+					{
+						__m128 sum = _mm_setzero_ps();
+						for (int tap = 0; tap < g_prefilter_tap_count; ++tap)
+						{
+							sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(tap_weights[tap]), _mm_loadu_ps(source_rows[tap] + static_cast<size_t>(x) * 4U)));
+						}
+						_mm_storeu_ps(destination_row + static_cast<size_t>(x) * 4U, sum);
+					}
+				}
+			});
+		}
+
+		current_level.swap(next_level);
+	}
+}
+
+static void prefilter_build_tap_index(uint32_t source_size, uint32_t destination_size, std::vector<uint32_t> &tap_index)
+{
+	tap_index.resize(static_cast<size_t>(g_prefilter_tap_count) * destination_size);
+	for (uint32_t i = 0U; i < destination_size; ++i)
+	{
+		for (int tap = 0; tap < g_prefilter_tap_count; ++tap)
+		{
+			// clamp to edge (the border extension continues)
+			int source_index = static_cast<int>(2U * i) + g_prefilter_tap_first + tap;
+			tap_index[static_cast<size_t>(g_prefilter_tap_count) * i + tap] = static_cast<uint32_t>(std::min(std::max(source_index, 0), static_cast<int>(source_size) - 1));
+		}
+	}
+}
+
+static inline uint64_t prefilter_align_up(uint64_t value, uint64_t alignment)
+{
+	return ((value + alignment - 1U) / alignment) * alignment;
+}
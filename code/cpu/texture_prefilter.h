@@ -0,0 +1,64 @@
+#ifndef _CPU_TEXTURE_PREFILTER_H_
+#define _CPU_TEXTURE_PREFILTER_H_ 1
+
+//
+// The prefiltered texture of the textured area light (Heitz 2016, "Real-Time Polygonal-Light Shading with Linearly Transformed Cosines", section 5.2).
+//
+// The level 0 is the light image extended by the border (clamp to edge) such that the light occupies the center of the texture.
+// The level "n" is the level "n - 1" blurred by the Gaussian filter and downsampled by 2, such that the radius of the filter footprint doubles per level.
+// The shader selects the level by the footprint of the cosine distribution (see "FetchFilteredLightTexture" in "shaders/LTC.hlsli").
+//
+// The blob is the streaming-friendly "mip tail" layout:
+// [header] [mip tail: the coarsest levels packed together] [level "mip_tail_first_level - 1"] ... [level 0]
+// The header and the mip tail are in the first "mip_tail_chunk_size" bytes, such that a single read is enough to render with the blurry levels.
+// This is NOT necessarily a single chunk: each level of the mip tail is smaller than the chunk, but together with the header they may exceed it (e.g. the levels of 48 KB, 12 KB, ... of the R16G16B16A16_FLOAT), and the size is aligned up to the chunk.
+// Each finer level starts at the "AREA_LIGHT_TEXTURE_CHUNK_ALIGNMENT" boundary and can be streamed in independently (from the coarse to the fine).
+//
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+static const uint32_t AREA_LIGHT_TEXTURE_MAGIC = 0X5443544CU; // "LTCT"
+static const uint32_t AREA_LIGHT_TEXTURE_VERSION = 1U;
+static const uint32_t AREA_LIGHT_TEXTURE_MAX_LEVEL_COUNT = 16U;
+// The same as the tile size of the tiled resources (D3D11_2_TILED_RESOURCE_TILE_SIZE_IN_BYTES)
+static const uint32_t AREA_LIGHT_TEXTURE_CHUNK_ALIGNMENT = 65536U;
+// DXGI_FORMAT_R16G16B16A16_FLOAT
+static const uint32_t AREA_LIGHT_TEXTURE_TEXEL_SIZE = 8U;
+
+struct area_light_texture_level_t
+{
+	uint32_t width;
+	uint32_t height;
+	uint32_t row_pitch;
+	uint32_t _padding;
+	// from the beginning of the blob
+	uint64_t offset;
+	uint64_t size;
+};
+
+struct area_light_texture_header_t
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t level_count;
+	// the levels [mip_tail_first_level, level_count) are packed in the mip tail
+	uint32_t mip_tail_first_level;
+	// the size of the header and the mip tail, the multiple of the "AREA_LIGHT_TEXTURE_CHUNK_ALIGNMENT" (may be more than 1 chunk)
+	uint64_t mip_tail_chunk_size;
+	uint64_t total_size;
+	// The size of the light image (excluding the border) in the texels of the level 0.
+	uint32_t light_width;
+	uint32_t light_height;
+	// The texture coordinate of the level 0 = light_uv * uv_scale_bias.xy + uv_scale_bias.zw
+	float uv_scale_bias[4];
+	area_light_texture_level_t levels[AREA_LIGHT_TEXTURE_MAX_LEVEL_COUNT];
+};
+
+// [in] thread_pool: The rows of each pass are processed in parallel.
+// [in] light_image: RGBA32F, the row "0" is the top of the light (the vertex "3" of the quad).
+// [out] prefiltered_texture: The blob of the mip tail layout (the header is at the offset 0).
+void PrefilterAreaLightTexture(class ThreadPool *thread_pool, float const *light_image, uint32_t light_width, uint32_t light_height, std::vector<uint8_t> &prefiltered_texture);
+
+#endif
@@ -0,0 +1,142 @@
+#include <stdint.h>
+#include <assert.h>
+#include <algorithm>
+
+#include "thread_pool.h"
+
+void ThreadPool::Init(uint32_t thread_count)
+{
+	if (0U == thread_count)
+	{
+		thread_count = std::max(1U, static_cast<uint32_t>(std::thread::hardware_concurrency()));
+	}
+
+	m_generation = 0U;
+	m_quit = false;
+
+	m_task = NULL;
+	m_task_user_data = NULL;
+	m_task_count = 0U;
+	m_task_grain = 1U;
+	m_task_next.store(0U, std::memory_order_relaxed);
+	m_task_busy_workers = 0U;
+
+	// The calling thread is the thread "0"
+	m_worker_count = thread_count - 1U;
+	m_workers = (m_worker_count > 0U) ? new std::thread[m_worker_count] : NULL;
+	for (uint32_t worker_index = 0U; worker_index < m_worker_count; ++worker_index)
+	{
+		m_workers[worker_index] = std::thread(&ThreadPool::WorkerMain, this, worker_index + 1U);
+	}
+}
+
+void ThreadPool::Destroy()
+{
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_quit = true;
+	}
+	m_wake_condition.notify_all();
+
+	for (uint32_t worker_index = 0U; worker_index < m_worker_count; ++worker_index)
+	{
+		m_workers[worker_index].join();
+	}
+
+	delete[] m_workers;
+	m_workers = NULL;
+	m_worker_count = 0U;
+}
+
+uint32_t ThreadPool::GetThreadCount() const
+{
+	return m_worker_count + 1U;
+}
+
+void ThreadPool::ParallelFor(uint32_t count, uint32_t grain, pfn_task_t task, void *user_data)
+{
+	if (0U == count)
+	{
+		return;
+	}
+
+	grain = std::max(grain, 1U);
+
+	// Not worth waking the workers
+	if (0U == m_worker_count || count <= grain)
+	{
+		task(user_data, 0U, count, 0U);
+		return;
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		assert(0U == m_task_busy_workers);
+
+		m_task = task;
+		m_task_user_data = user_data;
+		m_task_count = count;
+		m_task_grain = grain;
+		m_task_next.store(0U, std::memory_order_relaxed);
+		m_task_busy_workers = m_worker_count;
+		++m_generation;
+	}
+	m_wake_condition.notify_all();
+
+	this->RunTask(0U);
+
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_done_condition.wait(lock, [this]() { return (0U == m_task_busy_workers); });
+
+		m_task = NULL;
+		m_task_user_data = NULL;
+	}
+}
+
+void ThreadPool::WorkerMain(uint32_t thread_index)
+{
+	uint64_t generation = 0U;
+
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_wake_condition.wait(lock, [this, generation]() { return (m_quit || (generation != m_generation)); });
+
+			if (m_quit)
+			{
+				break;
+			}
+
+			generation = m_generation;
+		}
+
+		this->RunTask(thread_index);
+
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			assert(m_task_busy_workers > 0U);
+			--m_task_busy_workers;
+			if (0U == m_task_busy_workers)
+			{
+				m_done_condition.notify_one();
+			}
+		}
+	}
+}
+
+void ThreadPool::RunTask(uint32_t thread_index)
+{
+	for (;;)
+	{
+		uint32_t begin = m_task_next.fetch_add(m_task_grain, std::memory_order_relaxed);
+		if (begin >= m_task_count)
+		{
+			break;
+		}
+
+		uint32_t end = std::min(begin + m_task_grain, m_task_count);
+		m_task(m_task_user_data, begin, end, thread_index);
+	}
+}
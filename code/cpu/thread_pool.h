@@ -0,0 +1,65 @@
+#ifndef _CPU_THREAD_POOL_H_
+#define _CPU_THREAD_POOL_H_ 1
+
+#include <stdint.h>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// The persistent worker threads for the CPU passes (prefiltering, software rendering, etc.).
+// The calling thread participates in the "ParallelFor" and the call returns when all items have been processed.
+class ThreadPool
+{
+public:
+	// [in] begin, end: the range of items [begin, end)
+	// [in] thread_index: [0, GetThreadCount()), can be used to index the per-thread data without synchronization
+	typedef void (*pfn_task_t)(void *user_data, uint32_t begin, uint32_t end, uint32_t thread_index);
+
+private:
+	std::thread *m_workers;
+	uint32_t m_worker_count;
+
+	std::mutex m_mutex;
+	std::condition_variable m_wake_condition;
+	std::condition_variable m_done_condition;
+	uint64_t m_generation;
+	bool m_quit;
+
+	// the current task
+	pfn_task_t m_task;
+	void *m_task_user_data;
+	uint32_t m_task_count;
+	uint32_t m_task_grain;
+	std::atomic<uint32_t> m_task_next;
+	uint32_t m_task_busy_workers;
+
+	void WorkerMain(uint32_t thread_index);
+	void RunTask(uint32_t thread_index);
+
+public:
+	// [in] thread_count: including the calling thread, 0 means "std::thread::hardware_concurrency"
+	void Init(uint32_t thread_count);
+	void Destroy();
+
+	uint32_t GetThreadCount() const;
+
+	// [in] grain: the number of the items fetched by a thread at once
+	void ParallelFor(uint32_t count, uint32_t grain, pfn_task_t task, void *user_data);
+
+	// void functor(uint32_t begin, uint32_t end, uint32_t thread_index)
+	template <typename F>
+	inline void ParallelFor(uint32_t count, uint32_t grain, F const &functor)
+	{
+		struct _
+		{
+			static void task(void *user_data, uint32_t begin, uint32_t end, uint32_t thread_index)
+			{
+				(*static_cast<F const *>(user_data))(begin, end, thread_index);
+			}
+		};
+		this->ParallelFor(count, grain, &_::task, const_cast<void *>(static_cast<void const *>(&functor)));
+	}
+};
+
+#endif
@@ -0,0 +1,292 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <assert.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "thread_pool.h"
+#include "lz_codec.h"
+#include "tile_delta.h"
+
+static inline uint8_t *tile_delta_store_u32(uint8_t *cursor, uint32_t value);
+
+static inline uint32_t tile_delta_load_u32(uint8_t const *cursor);
+
+uint32_t TileDeltaMaxMessageSize(uint32_t width, uint32_t height)
+{
+	// each tile: the index, the size and the compressed rows (clamped to the size prefix of the message)
+	uint64_t const tile_count = static_cast<uint64_t>((width + TILE_DELTA_TILE_SIZE - 1U) / TILE_DELTA_TILE_SIZE) * ((height + TILE_DELTA_TILE_SIZE - 1U) / TILE_DELTA_TILE_SIZE);
+	uint64_t const message_size = sizeof(tile_delta_message_header_t) + tile_count * (8U + LZCompressBound(TILE_DELTA_TILE_SIZE * TILE_DELTA_TILE_SIZE * 4U));
+	return static_cast<uint32_t>(std::min(message_size, static_cast<uint64_t>(UINT32_MAX)));
+}
+
+void TileDeltaEncoder::Init(uint32_t thread_count, uint32_t width, uint32_t height)
+{
+	m_thread_count = std::max(thread_count, 1U);
+	m_thread_tiles.assign(static_cast<size_t>(m_thread_count) * TILE_DELTA_TILE_SIZE * TILE_DELTA_TILE_SIZE * 4U, 0U);
+	m_thread_hash_tables.assign(static_cast<size_t>(m_thread_count) * LZ_HASH_TABLE_SIZE, 0U);
+
+	this->Allocate(width, height);
+
+	memset(&m_statistics, 0, sizeof(tile_delta_statistics_t));
+}
+
+void TileDeltaEncoder::Destroy()
+{
+	m_previous.clear();
+	m_tile_row_payloads.clear();
+	m_tile_row_payload_sizes.clear();
+	m_tile_row_dirty_counts.clear();
+	m_thread_tiles.clear();
+	m_thread_hash_tables.clear();
+	m_message.clear();
+}
+
+void TileDeltaEncoder::Allocate(uint32_t width, uint32_t height)
+{
+	assert(width > 0U && height > 0U);
+
+	m_width = width;
+	m_height = height;
+	m_tile_column_count = (width + TILE_DELTA_TILE_SIZE - 1U) / TILE_DELTA_TILE_SIZE;
+	m_tile_row_count = (height + TILE_DELTA_TILE_SIZE - 1U) / TILE_DELTA_TILE_SIZE;
+
+	m_previous.assign(static_cast<size_t>(width) * height * 4U, 0U);
+	m_previous_valid = false;
+
+	// each tile: the index, the size and the compressed rows
+	m_tile_row_stride = m_tile_column_count * (8U + LZCompressBound(TILE_DELTA_TILE_SIZE * TILE_DELTA_TILE_SIZE * 4U));
+	m_tile_row_payloads.resize(static_cast<size_t>(m_tile_row_count) * m_tile_row_stride);
+	m_tile_row_payload_sizes.assign(m_tile_row_count, 0U);
+	m_tile_row_dirty_counts.assign(m_tile_row_count, 0U);
+
+	m_message.resize(sizeof(tile_delta_message_header_t) + m_tile_row_payloads.size());
+}
+
+uint8_t const *TileDeltaEncoder::Encode(ThreadPool *thread_pool, uint8_t const *pixels, uint32_t width, uint32_t height, uint32_t frame_index, uint32_t *message_size)
+{
+	assert(thread_pool->GetThreadCount() <= m_thread_count);
+
+	std::chrono::steady_clock::time_point const begin = std::chrono::steady_clock::now();
+
+	if (width != m_width || height != m_height)
+	{
+		this->Allocate(width, height);
+	}
+
+	bool const key_frame = !m_previous_valid;
+	uint32_t const tile_column_count = m_tile_column_count;
+	uint32_t const tile_row_stride = m_tile_row_stride;
+	uint8_t *const previous = &m_previous[0];
+	uint8_t *const tile_row_payloads = &m_tile_row_payloads[0];
+	uint32_t *const tile_row_payload_sizes = &m_tile_row_payload_sizes[0];
+	uint32_t *const tile_row_dirty_counts = &m_tile_row_dirty_counts[0];
+	uint8_t *const thread_tiles = &m_thread_tiles[0];
+	uint32_t *const thread_hash_tables = &m_thread_hash_tables[0];
+
+	thread_pool->ParallelFor(m_tile_row_count, 1U, [=](uint32_t begin_tile_row, uint32_t end_tile_row, uint32_t thread_index) {
+		uint8_t *const tile = thread_tiles + static_cast<size_t>(thread_index) * TILE_DELTA_TILE_SIZE * TILE_DELTA_TILE_SIZE * 4U;
+		uint32_t *const hash_table = thread_hash_tables + static_cast<size_t>(thread_index) * LZ_HASH_TABLE_SIZE;
+
+		for (uint32_t tile_row = begin_tile_row; tile_row < end_tile_row; ++tile_row)
+		{
+			uint8_t *const payload = tile_row_payloads + static_cast<size_t>(tile_row_stride) * tile_row;
+			uint8_t *cursor = payload;
+			uint32_t dirty_count = 0U;
+
+			uint32_t const y0 = tile_row * TILE_DELTA_TILE_SIZE;
+			uint32_t const tile_height = std::min(TILE_DELTA_TILE_SIZE, height - y0);
+			for (uint32_t tile_column = 0U; tile_column < tile_column_count; ++tile_column)
+			{
+				uint32_t const x0 = tile_column * TILE_DELTA_TILE_SIZE;
+				uint32_t const tile_row_size = std::min(TILE_DELTA_TILE_SIZE, width - x0) * 4U;
+
+				bool dirty = key_frame;
+				for (uint32_t y = 0U; y < tile_height && !dirty; ++y)
+				{
+					size_t const offset = (static_cast<size_t>(width) * (y0 + y) + x0) * 4U;
+					dirty = (0 != memcmp(pixels + offset, previous + offset, tile_row_size));
+				}
+
+				if (!dirty)
+				{
+					continue;
+				}
+
+				// the rows of the tile are gathered (the compressed tile is contiguous), and kept as the previous frame
+				for (uint32_t y = 0U; y < tile_height; ++y)
+				{
+					size_t const offset = (static_cast<size_t>(width) * (y0 + y) + x0) * 4U;
+					memcpy(tile + static_cast<size_t>(tile_row_size) * y, pixels + offset, tile_row_size);
+					memcpy(previous + offset, pixels + offset, tile_row_size);
+				}
+
+				cursor = tile_delta_store_u32(cursor, tile_row * tile_column_count + tile_column);
+				uint32_t const compressed_size = LZCompress(tile, tile_row_size * tile_height, cursor + 4U, hash_table);
+				cursor = tile_delta_store_u32(cursor, compressed_size);
+				cursor += compressed_size;
+				++dirty_count;
+			}
+
+			tile_row_payload_sizes[tile_row] = static_cast<uint32_t>(cursor - payload);
+			tile_row_dirty_counts[tile_row] = dirty_count;
+		}
+	});
+
+	// the parts of the tile rows are concatenated in order
+	uint8_t *const message = &m_message[0];
+	uint8_t *cursor = message + sizeof(tile_delta_message_header_t);
+	uint32_t dirty_tile_count = 0U;
+	for (uint32_t tile_row = 0U; tile_row < m_tile_row_count; ++tile_row)
+	{
+		memcpy(cursor, tile_row_payloads + static_cast<size_t>(tile_row_stride) * tile_row, tile_row_payload_sizes[tile_row]);
+		cursor += tile_row_payload_sizes[tile_row];
+		dirty_tile_count += tile_row_dirty_counts[tile_row];
+	}
+
+	tile_delta_message_header_t header;
+	header.magic = TILE_DELTA_MAGIC;
+	header.frame_index = frame_index;
+	header.width = width;
+	header.height = height;
+	header.tile_size = TILE_DELTA_TILE_SIZE;
+	header.dirty_tile_count = dirty_tile_count;
+	header.payload_size = static_cast<uint32_t>(cursor - message) - static_cast<uint32_t>(sizeof(tile_delta_message_header_t));
+	header.key_frame = key_frame ? 1U : 0U;
+	memcpy(message, &header, sizeof(tile_delta_message_header_t));
+
+	m_previous_valid = true;
+
+	m_statistics.tile_count = m_tile_column_count * m_tile_row_count;
+	m_statistics.dirty_tile_count = dirty_tile_count;
+	m_statistics.message_size = static_cast<uint32_t>(cursor - message);
+	m_statistics.encode_milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+
+	(*message_size) = static_cast<uint32_t>(cursor - message);
+	return message;
+}
+
+void TileDeltaEncoder::ForceKeyFrame()
+{
+	m_previous_valid = false;
+}
+
+tile_delta_statistics_t const &TileDeltaEncoder::GetStatistics() const
+{
+	return m_statistics;
+}
+
+void TileDeltaDecoder::Init(uint32_t max_frame_size)
+{
+	m_max_frame_size = max_frame_size;
+	m_width = 0U;
+	m_height = 0U;
+}
+
+void TileDeltaDecoder::Destroy()
+{
+	m_frame.clear();
+	m_tile.clear();
+}
+
+bool TileDeltaDecoder::Apply(uint8_t const *message, uint32_t message_size)
+{
+	if (message_size < sizeof(tile_delta_message_header_t))
+	{
+		return false;
+	}
+
+	tile_delta_message_header_t header;
+	memcpy(&header, message, sizeof(tile_delta_message_header_t));
+	if (TILE_DELTA_MAGIC != header.magic || TILE_DELTA_TILE_SIZE != header.tile_size || 0U == header.width || 0U == header.height || header.width > m_max_frame_size || header.height > m_max_frame_size || header.payload_size != (message_size - sizeof(tile_delta_message_header_t)))
+	{
+		return false;
+	}
+
+	// the byte sizes are NOT computed in 32 bits
+	uint64_t const tile_column_count = (static_cast<uint64_t>(header.width) + TILE_DELTA_TILE_SIZE - 1U) / TILE_DELTA_TILE_SIZE;
+	uint64_t const tile_row_count = (static_cast<uint64_t>(header.height) + TILE_DELTA_TILE_SIZE - 1U) / TILE_DELTA_TILE_SIZE;
+	uint64_t const tile_count = tile_column_count * tile_row_count;
+	if (header.dirty_tile_count > tile_count)
+	{
+		return false;
+	}
+
+	if (header.width != m_width || header.height != m_height)
+	{
+		// the delta of the other size can NOT be applied
+		if (0U == header.key_frame)
+		{
+			return false;
+		}
+		m_width = header.width;
+		m_height = header.height;
+		m_frame.assign(static_cast<size_t>(static_cast<uint64_t>(m_width) * m_height * 4U), 0U);
+	}
+	m_tile.resize(static_cast<size_t>(static_cast<uint64_t>(TILE_DELTA_TILE_SIZE) * TILE_DELTA_TILE_SIZE * 4U));
+
+	uint8_t const *cursor = message + sizeof(tile_delta_message_header_t);
+	uint8_t const *const end = message + message_size;
+	for (uint32_t dirty_tile_index = 0U; dirty_tile_index < header.dirty_tile_count; ++dirty_tile_index)
+	{
+		if ((end - cursor) < 8)
+		{
+			return false;
+		}
+		uint32_t const tile_index = tile_delta_load_u32(cursor);
+		uint32_t const compressed_size = tile_delta_load_u32(cursor + 4U);
+		cursor += 8U;
+		if (tile_index >= tile_count || compressed_size > static_cast<uint64_t>(end - cursor))
+		{
+			return false;
+		}
+
+		uint32_t const x0 = static_cast<uint32_t>(tile_index % tile_column_count) * TILE_DELTA_TILE_SIZE;
+		uint32_t const y0 = static_cast<uint32_t>(tile_index / tile_column_count) * TILE_DELTA_TILE_SIZE;
+		uint32_t const tile_row_size = std::min(TILE_DELTA_TILE_SIZE, m_width - x0) * 4U;
+		uint32_t const tile_height = std::min(TILE_DELTA_TILE_SIZE, m_height - y0);
+		if (!LZDecompress(cursor, compressed_size, &m_tile[0], tile_row_size * tile_height))
+		{
+			return false;
+		}
+		cursor += compressed_size;
+
+		for (uint32_t y = 0U; y < tile_height; ++y)
+		{
+			memcpy(&m_frame[static_cast<size_t>((static_cast<uint64_t>(m_width) * (y0 + y) + x0) * 4U)], &m_tile[static_cast<size_t>(tile_row_size) * y], tile_row_size);
+		}
+	}
+
+	return (cursor == end);
+}
+
+uint8_t const *TileDeltaDecoder::GetFrame() const
+{
+	return m_frame.empty() ? NULL : &m_frame[0];
+}
+
+uint32_t TileDeltaDecoder::GetWidth() const
+{
+	return m_width;
+}
+
+uint32_t TileDeltaDecoder::GetHeight() const
+{
+	return m_height;
+}
+
+static inline uint8_t *tile_delta_store_u32(uint8_t *cursor, uint32_t value)
+{
+	// little endian (the same as the header)
+	memcpy(cursor, &value, sizeof(uint32_t));
+	return cursor + 4U;
+}
+
+static inline uint32_t tile_delta_load_u32(uint8_t const *cursor)
+{
+	uint32_t value;
+	memcpy(&value, cursor, sizeof(uint32_t));
+	return value;
+}
@@ -0,0 +1,106 @@
+#ifndef _CPU_TILE_DELTA_H_
+#define _CPU_TILE_DELTA_H_ 1
+
+//
+// The delta of the BGRA8 frames by the tiles: the frame is compared against the last encoded frame tile by tile, only the changed tiles are compressed (see "lz_codec.h") into the message,
+// such that the static frames (e.g. the fixed light and camera) cost almost nothing to stream (see "support/frame_stream.h").
+//
+// The message: the "tile_delta_message_header_t", followed by the "dirty_tile_count" tiles, each: the tile index (uint32), the compressed size (uint32) and the compressed rows of the tile.
+// The first message and the message after the size changes have every tile (the key frame), the decoder applies the messages in order onto its own copy of the frame.
+// The tile rows are compared and compressed in parallel (see "ThreadPool::ParallelFor"), each thread into its own part of the message which are concatenated after the join.
+//
+
+#include <stdint.h>
+#include <vector>
+
+static const uint32_t TILE_DELTA_MAGIC = 0X44544C54U;
+static const uint32_t TILE_DELTA_TILE_SIZE = 32U;
+
+struct tile_delta_message_header_t
+{
+	uint32_t magic;
+	uint32_t frame_index;
+	uint32_t width;
+	uint32_t height;
+	uint32_t tile_size;
+	uint32_t dirty_tile_count;
+	// the bytes after the header
+	uint32_t payload_size;
+	// 1: every tile is in the message
+	uint32_t key_frame;
+};
+
+struct tile_delta_statistics_t
+{
+	// the last "Encode"
+	uint32_t tile_count;
+	uint32_t dirty_tile_count;
+	uint32_t message_size;
+	double encode_milliseconds;
+};
+
+// the size of the key frame of the incompressible tiles: no message of the frame of the size is larger (e.g. the limit of the "FrameStream::Receive")
+uint32_t TileDeltaMaxMessageSize(uint32_t width, uint32_t height);
+
+class TileDeltaEncoder
+{
+	uint32_t m_width;
+	uint32_t m_height;
+	uint32_t m_tile_column_count;
+	uint32_t m_tile_row_count;
+	// BGRA8, the last encoded frame
+	std::vector<uint8_t> m_previous;
+	bool m_previous_valid;
+
+	// each tile row is compressed into its own part (the bound of every tile of the row)
+	uint32_t m_tile_row_stride;
+	std::vector<uint8_t> m_tile_row_payloads;
+	std::vector<uint32_t> m_tile_row_payload_sizes;
+	std::vector<uint32_t> m_tile_row_dirty_counts;
+	// per thread: the gathered tile and the hash table of the LZ
+	uint32_t m_thread_count;
+	std::vector<uint8_t> m_thread_tiles;
+	std::vector<uint32_t> m_thread_hash_tables;
+
+	std::vector<uint8_t> m_message;
+	tile_delta_statistics_t m_statistics;
+
+	void Allocate(uint32_t width, uint32_t height);
+
+public:
+	// [in] thread_count: the "GetThreadCount" of the thread pool passed to the "Encode"
+	void Init(uint32_t thread_count, uint32_t width, uint32_t height);
+	void Destroy();
+
+	// [in] pixels: BGRA8, the row 0 is the top of the image, "width * 4" bytes per row
+	// [return] the message of the frame (valid until the next "Encode"), the size changes force the key frame
+	uint8_t const *Encode(class ThreadPool *thread_pool, uint8_t const *pixels, uint32_t width, uint32_t height, uint32_t frame_index, uint32_t *message_size);
+	// the next message is the key frame (e.g. the new viewer)
+	void ForceKeyFrame();
+
+	tile_delta_statistics_t const &GetStatistics() const;
+};
+
+class TileDeltaDecoder
+{
+	uint32_t m_max_frame_size;
+	uint32_t m_width;
+	uint32_t m_height;
+	// BGRA8
+	std::vector<uint8_t> m_frame;
+	std::vector<uint8_t> m_tile;
+
+public:
+	// [in] max_frame_size: the width or the height of the header above it is rejected rather than being allocated (the header is NOT trusted)
+	void Init(uint32_t max_frame_size);
+	void Destroy();
+
+	// [return] false if the message is corrupted (including the size beyond the "max_frame_size", the tile size other than the TILE_DELTA_TILE_SIZE and more dirty tiles than the tiles), or is NOT the key frame while the size differs
+	bool Apply(uint8_t const *message, uint32_t message_size);
+
+	uint8_t const *GetFrame() const;
+	uint32_t GetWidth() const;
+	uint32_t GetHeight() const;
+};
+
+#endif
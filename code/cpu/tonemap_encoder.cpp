@@ -0,0 +1,346 @@
+#include <stdint.h>
+#include <string.h>
+#include <xmmintrin.h>
+#include <emmintrin.h>
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+// the intrinsics of the AVX2 are available without the "/arch"
+#define TONEMAP_ENCODER_AVX2_TARGET
+#else
+#include <cpuid.h>
+// only the functions of the AVX2 path are compiled for the AVX2 (the rest of the project is NOT)
+#define TONEMAP_ENCODER_AVX2_TARGET __attribute__((target("avx2,f16c")))
+#endif
+
+#include "simd.h"
+#include "tonemap_encoder.h"
+
+// "post_process_fs.hlsl"
+static inline simd_float tonemap_encoder_rrt_odt_fit(simd_float v);
+
+// the 4 pixels of the SoA color into BGRA8
+static inline void tonemap_encoder_encode(simd_float3 color, simd_float exposure, uint8_t *display_color);
+
+// the 4 pixels of RGBA16F (32 bytes) into the SoA color
+static inline simd_float3 tonemap_encoder_load_half(uint16_t const *hdr_color);
+
+// the CPUID: the AVX2 and the F16C, and the OS saves the YMM registers
+static bool tonemap_encoder_cpu_supports_avx2();
+
+// the CPUID is queried once
+static inline bool tonemap_encoder_avx2();
+
+// The 8 pixels at a time of the AVX2 (and the F16C for the RGBA16F), the same operations in the same order as the 4 pixels of the SSE2, such that the result is the same.
+// [return] the pixels encoded (the multiple of 8), the rest is left to the SSE2
+static uint32_t tonemap_encoder_avx2_encode_row(float const *hdr_color, uint32_t pixel_count, float exposure, uint8_t *display_color);
+
+static uint32_t tonemap_encoder_avx2_encode_row_half(uint16_t const *hdr_color, uint32_t pixel_count, float exposure, uint8_t *display_color);
+
+void TonemapEncodeRow(float const *hdr_color, uint32_t pixel_count, float exposure, uint8_t *display_color)
+{
+	simd_float const simd_exposure = simd_float(exposure);
+
+	uint32_t pixel_index = tonemap_encoder_avx2() ? tonemap_encoder_avx2_encode_row(hdr_color, pixel_count, exposure, display_color) : 0U;
+	for (; (pixel_index + 4U) <= pixel_count; pixel_index += 4U)
+	{
+		__m128 r = _mm_loadu_ps(hdr_color + 4U * pixel_index + 0U);
+		__m128 g = _mm_loadu_ps(hdr_color + 4U * pixel_index + 4U);
+		__m128 b = _mm_loadu_ps(hdr_color + 4U * pixel_index + 8U);
+		__m128 a = _mm_loadu_ps(hdr_color + 4U * pixel_index + 12U);
+		_MM_TRANSPOSE4_PS(r, g, b, a);
+
+		tonemap_encoder_encode(simd_float3(r, g, b), simd_exposure, display_color + 4U * pixel_index);
+	}
+
+	// the last pixels (fewer than 4) are padded by black
+	if (pixel_index < pixel_count)
+	{
+		uint32_t const remaining_count = pixel_count - pixel_index;
+
+		float texels[16];
+		memset(texels, 0, sizeof(texels));
+		memcpy(texels, hdr_color + 4U * pixel_index, sizeof(float) * 4U * remaining_count);
+
+		uint8_t pixels[16];
+		TonemapEncodeRow(texels, 4U, exposure, pixels);
+		memcpy(display_color + 4U * pixel_index, pixels, sizeof(uint8_t) * 4U * remaining_count);
+	}
+}
+
+void TonemapEncodeRowHalf(uint16_t const *hdr_color, uint32_t pixel_count, float exposure, uint8_t *display_color)
+{
+	simd_float const simd_exposure = simd_float(exposure);
+
+	uint32_t pixel_index = tonemap_encoder_avx2() ? tonemap_encoder_avx2_encode_row_half(hdr_color, pixel_count, exposure, display_color) : 0U;
+	for (; (pixel_index + 4U) <= pixel_count; pixel_index += 4U)
+	{
+		tonemap_encoder_encode(tonemap_encoder_load_half(hdr_color + 4U * pixel_index), simd_exposure, display_color + 4U * pixel_index);
+	}
+
+	// the last pixels (fewer than 4) are padded by black
+	if (pixel_index < pixel_count)
+	{
+		uint32_t const remaining_count = pixel_count - pixel_index;
+
+		uint16_t texels[16];
+		memset(texels, 0, sizeof(texels));
+		memcpy(texels, hdr_color + 4U * pixel_index, sizeof(uint16_t) * 4U * remaining_count);
+
+		uint8_t pixels[16];
+		TonemapEncodeRowHalf(texels, 4U, exposure, pixels);
+		memcpy(display_color + 4U * pixel_index, pixels, sizeof(uint8_t) * 4U * remaining_count);
+	}
+}
+
+char const *TonemapEncoderGetPath()
+{
+	return tonemap_encoder_avx2() ? "AVX2+F16C" : "SSE2";
+}
+
+static inline simd_float tonemap_encoder_rrt_odt_fit(simd_float v)
+{
+	simd_float a = v * (v + simd_float(0.0245786f)) - simd_float(0.000090537f);
+	simd_float b = v * (simd_float(0.983729f) * v + simd_float(0.4329510f)) + simd_float(0.238081f);
+	return a / b;
+}
+
+static inline void tonemap_encoder_encode(simd_float3 color, simd_float exposure, uint8_t *display_color)
+{
+	// "aces_fitted"
+	simd_float3x3 const aces_input_mat = {
+		simd_float3_broadcast(0.59719f, 0.35458f, 0.04823f),
+		simd_float3_broadcast(0.07600f, 0.90834f, 0.01566f),
+		simd_float3_broadcast(0.02840f, 0.13383f, 0.83777f)};
+
+	simd_float3x3 const aces_output_mat = {
+		simd_float3_broadcast(1.60475f, -0.53108f, -0.07367f),
+		simd_float3_broadcast(-0.10208f, 1.10813f, -0.00605f),
+		simd_float3_broadcast(-0.00327f, -0.07276f, 1.07602f)};
+
+	color = mul(aces_input_mat, color * exposure);
+
+	// Apply RRT and ODT
+	color = simd_float3(tonemap_encoder_rrt_odt_fit(color.x), tonemap_encoder_rrt_odt_fit(color.y), tonemap_encoder_rrt_odt_fit(color.z));
+
+	// Clamp to [0, 1]
+	color = saturate(mul(aces_output_mat, color));
+
+	// "ToSRGB"
+	simd_float const inverse_gamma = simd_float(1.0f / 2.2f);
+	color = simd_float3(pow(color.x, inverse_gamma), pow(color.y, inverse_gamma), pow(color.z, inverse_gamma));
+
+	// UNORM (the same rounding as the "D3DX_FLOAT4_to_R8G8B8A8_UNORM")
+	__m128i const r = _mm_cvttps_epi32((color.x * simd_float(255.0f) + simd_float(0.5f)).v);
+	__m128i const g = _mm_cvttps_epi32((color.y * simd_float(255.0f) + simd_float(0.5f)).v);
+	__m128i const b = _mm_cvttps_epi32((color.z * simd_float(255.0f) + simd_float(0.5f)).v);
+
+	// BGRA8: the blue is the lowest byte
+	__m128i const pixels = _mm_or_si128(_mm_or_si128(b, _mm_slli_epi32(g, 8)), _mm_or_si128(_mm_slli_epi32(r, 16), _mm_set1_epi32(static_cast<int>(0XFF000000U))));
+	_mm_storeu_si128(reinterpret_cast<__m128i *>(display_color), pixels);
+}
+
+// the half in the low 16 bits of each lane
+static inline __m128 tonemap_encoder_half_to_float(__m128i half)
+{
+	__m128i const sign = _mm_slli_epi32(_mm_and_si128(half, _mm_set1_epi32(0X8000)), 16);
+	__m128i const exponent_mantissa = _mm_slli_epi32(_mm_and_si128(half, _mm_set1_epi32(0X7FFF)), 13);
+
+	// the exponent bias 15 to 127: multiplied by 2^112 (the denormals of the half are normalized as well)
+	__m128 magnitude = _mm_mul_ps(_mm_castsi128_ps(exponent_mantissa), _mm_castsi128_ps(_mm_set1_epi32(0X77800000)));
+
+	// the infinity and the NaN (the exponent 31) keep the exponent 255
+	__m128i const infinity_nan = _mm_cmpgt_epi32(exponent_mantissa, _mm_set1_epi32(0X0F7FFFFF));
+	magnitude = _mm_or_ps(magnitude, _mm_castsi128_ps(_mm_and_si128(infinity_nan, _mm_set1_epi32(0X7F800000))));
+
+	return _mm_or_ps(magnitude, _mm_castsi128_ps(sign));
+}
+
+static inline simd_float3 tonemap_encoder_load_half(uint16_t const *hdr_color)
+{
+	// the pixels 0 1 and 2 3
+	__m128i const pixels_01 = _mm_loadu_si128(reinterpret_cast<__m128i const *>(hdr_color));
+	__m128i const pixels_23 = _mm_loadu_si128(reinterpret_cast<__m128i const *>(hdr_color + 8U));
+
+	__m128i const zero = _mm_setzero_si128();
+	__m128 r = tonemap_encoder_half_to_float(_mm_unpacklo_epi16(pixels_01, zero));
+	__m128 g = tonemap_encoder_half_to_float(_mm_unpackhi_epi16(pixels_01, zero));
+	__m128 b = tonemap_encoder_half_to_float(_mm_unpacklo_epi16(pixels_23, zero));
+	__m128 a = tonemap_encoder_half_to_float(_mm_unpackhi_epi16(pixels_23, zero));
+
+	// the pixels (RGBA) into the channels
+	_MM_TRANSPOSE4_PS(r, g, b, a);
+	return simd_float3(r, g, b);
+}
+
+static bool tonemap_encoder_cpu_supports_avx2()
+{
+#if defined(TONEMAP_ENCODER_NO_AVX2)
+	return false;
+#else
+	// the leaf 1: ECX (the OSXSAVE, the AVX and the F16C), the leaf 7: EBX (the AVX2)
+	uint32_t leaf_1_ecx;
+	uint32_t leaf_7_ebx;
+	uint64_t xcr0 = 0U;
+#if defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7)
+	{
+		return false;
+	}
+	__cpuid(info, 1);
+	leaf_1_ecx = static_cast<uint32_t>(info[2]);
+	__cpuidex(info, 7, 0);
+	leaf_7_ebx = static_cast<uint32_t>(info[1]);
+	if (0U != (leaf_1_ecx & (1U << 27U)))
+	{
+		xcr0 = _xgetbv(0);
+	}
+#else
+	uint32_t eax;
+	uint32_t ebx;
+	uint32_t ecx;
+	uint32_t edx;
+	if (__get_cpuid_max(0U, NULL) < 7U)
+	{
+		return false;
+	}
+	__cpuid(1U, eax, ebx, ecx, edx);
+	leaf_1_ecx = ecx;
+	__cpuid_count(7U, 0U, eax, ebx, ecx, edx);
+	leaf_7_ebx = ebx;
+	if (0U != (leaf_1_ecx & (1U << 27U)))
+	{
+		uint32_t xcr0_low;
+		uint32_t xcr0_high;
+		__asm__ __volatile__("xgetbv" : "=a"(xcr0_low), "=d"(xcr0_high) : "c"(0U));
+		xcr0 = (static_cast<uint64_t>(xcr0_high) << 32U) | xcr0_low;
+	}
+#endif
+	bool const avx = (0U != (leaf_1_ecx & (1U << 28U)));
+	bool const f16c = (0U != (leaf_1_ecx & (1U << 29U)));
+	bool const avx2 = (0U != (leaf_7_ebx & (1U << 5U)));
+	// the XMM and the YMM states
+	bool const os_ymm = (0X6U == (xcr0 & 0X6U));
+	return avx && f16c && avx2 && os_ymm;
+#endif
+}
+
+static inline bool tonemap_encoder_avx2()
+{
+	static bool const supported = tonemap_encoder_cpu_supports_avx2();
+	return supported;
+}
+
+// the "floor" of "simd.h"
+static inline TONEMAP_ENCODER_AVX2_TARGET __m256 tonemap_encoder_avx2_floor(__m256 a)
+{
+	__m256 t = _mm256_cvtepi32_ps(_mm256_cvttps_epi32(a));
+	return _mm256_sub_ps(t, _mm256_and_ps(_mm256_cmp_ps(t, a, _CMP_GT_OQ), _mm256_set1_ps(1.0f)));
+}
+
+// the "pow" of "simd.h"
+static inline TONEMAP_ENCODER_AVX2_TARGET __m256 tonemap_encoder_avx2_pow(__m256 a, __m256 b)
+{
+	// log2
+	__m256i const bits = _mm256_castps_si256(_mm256_max_ps(a, _mm256_set1_ps(1.175494351e-38f)));
+	__m256 const exponent = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(127)));
+	__m256 const t = _mm256_sub_ps(_mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0X007FFFFF)), _mm256_set1_epi32(0X3F800000))), _mm256_set1_ps(1.0f));
+	__m256 polynomial = _mm256_add_ps(_mm256_set1_ps(-0.19351346f), _mm256_mul_ps(t, _mm256_set1_ps(0.04526690f)));
+	polynomial = _mm256_add_ps(_mm256_set1_ps(0.41524326f), _mm256_mul_ps(t, polynomial));
+	polynomial = _mm256_add_ps(_mm256_set1_ps(-0.70886455f), _mm256_mul_ps(t, polynomial));
+	polynomial = _mm256_add_ps(_mm256_set1_ps(1.44187984f), _mm256_mul_ps(t, polynomial));
+	__m256 const log2_a = _mm256_add_ps(exponent, _mm256_mul_ps(t, polynomial));
+
+	// exp2
+	__m256 const x = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(log2_a, b), _mm256_set1_ps(-126.0f)), _mm256_set1_ps(127.0f));
+	__m256 const i = tonemap_encoder_avx2_floor(x);
+	__m256 const f = _mm256_sub_ps(x, i);
+	__m256 p = _mm256_add_ps(_mm256_set1_ps(0.05194775f), _mm256_mul_ps(f, _mm256_set1_ps(0.01358178f)));
+	p = _mm256_add_ps(_mm256_set1_ps(0.24144876f), _mm256_mul_ps(f, p));
+	p = _mm256_add_ps(_mm256_set1_ps(0.69301750f), _mm256_mul_ps(f, p));
+	p = _mm256_add_ps(_mm256_set1_ps(1.0f), _mm256_mul_ps(f, p));
+	return _mm256_mul_ps(p, _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(_mm256_cvttps_epi32(i), _mm256_set1_epi32(127)), 23)));
+}
+
+static inline TONEMAP_ENCODER_AVX2_TARGET __m256 tonemap_encoder_avx2_rrt_odt_fit(__m256 v)
+{
+	__m256 const a = _mm256_sub_ps(_mm256_mul_ps(v, _mm256_add_ps(v, _mm256_set1_ps(0.0245786f))), _mm256_set1_ps(0.000090537f));
+	__m256 const b = _mm256_add_ps(_mm256_mul_ps(v, _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(0.983729f), v), _mm256_set1_ps(0.4329510f))), _mm256_set1_ps(0.238081f));
+	return _mm256_div_ps(a, b);
+}
+
+// the row of the matrix dotted with the color: "(m0 * x + m1 * y) + m2 * z", the same as the "dot" of "simd.h"
+static inline TONEMAP_ENCODER_AVX2_TARGET __m256 tonemap_encoder_avx2_dot(float m0, float m1, float m2, __m256 x, __m256 y, __m256 z)
+{
+	return _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(m0), x), _mm256_mul_ps(_mm256_set1_ps(m1), y)), _mm256_mul_ps(_mm256_set1_ps(m2), z));
+}
+
+// [in] p01, p23, p45, p67: the pixels (RGBA) "0|1", "2|3", "4|5", "6|7" of each 128-bit lane
+// the 8 pixels into BGRA8
+static inline TONEMAP_ENCODER_AVX2_TARGET void tonemap_encoder_avx2_encode(__m256 p01, __m256 p23, __m256 p45, __m256 p67, __m256 exposure, uint8_t *display_color)
+{
+	// the pixels 0-3 in the low lane and the pixels 4-7 in the high lane, followed by the transpose of each lane
+	__m256 const row_0 = _mm256_permute2f128_ps(p01, p45, 0X20);
+	__m256 const row_1 = _mm256_permute2f128_ps(p01, p45, 0X31);
+	__m256 const row_2 = _mm256_permute2f128_ps(p23, p67, 0X20);
+	__m256 const row_3 = _mm256_permute2f128_ps(p23, p67, 0X31);
+	__m256 const rg_01 = _mm256_unpacklo_ps(row_0, row_1);
+	__m256 const ba_01 = _mm256_unpackhi_ps(row_0, row_1);
+	__m256 const rg_23 = _mm256_unpacklo_ps(row_2, row_3);
+	__m256 const ba_23 = _mm256_unpackhi_ps(row_2, row_3);
+	__m256 const r = _mm256_mul_ps(_mm256_shuffle_ps(rg_01, rg_23, _MM_SHUFFLE(1, 0, 1, 0)), exposure);
+	__m256 const g = _mm256_mul_ps(_mm256_shuffle_ps(rg_01, rg_23, _MM_SHUFFLE(3, 2, 3, 2)), exposure);
+	__m256 const b = _mm256_mul_ps(_mm256_shuffle_ps(ba_01, ba_23, _MM_SHUFFLE(1, 0, 1, 0)), exposure);
+
+	// "aces_fitted"
+	__m256 const aces_r = tonemap_encoder_avx2_rrt_odt_fit(tonemap_encoder_avx2_dot(0.59719f, 0.35458f, 0.04823f, r, g, b));
+	__m256 const aces_g = tonemap_encoder_avx2_rrt_odt_fit(tonemap_encoder_avx2_dot(0.07600f, 0.90834f, 0.01566f, r, g, b));
+	__m256 const aces_b = tonemap_encoder_avx2_rrt_odt_fit(tonemap_encoder_avx2_dot(0.02840f, 0.13383f, 0.83777f, r, g, b));
+
+	__m256 const zero = _mm256_setzero_ps();
+	__m256 const one = _mm256_set1_ps(1.0f);
+	__m256 const inverse_gamma = _mm256_set1_ps(1.0f / 2.2f);
+	__m256 const output_r = tonemap_encoder_avx2_pow(_mm256_min_ps(_mm256_max_ps(tonemap_encoder_avx2_dot(1.60475f, -0.53108f, -0.07367f, aces_r, aces_g, aces_b), zero), one), inverse_gamma);
+	__m256 const output_g = tonemap_encoder_avx2_pow(_mm256_min_ps(_mm256_max_ps(tonemap_encoder_avx2_dot(-0.10208f, 1.10813f, -0.00605f, aces_r, aces_g, aces_b), zero), one), inverse_gamma);
+	__m256 const output_b = tonemap_encoder_avx2_pow(_mm256_min_ps(_mm256_max_ps(tonemap_encoder_avx2_dot(-0.00327f, -0.07276f, 1.07602f, aces_r, aces_g, aces_b), zero), one), inverse_gamma);
+
+	// UNORM
+	__m256 const scale = _mm256_set1_ps(255.0f);
+	__m256 const half = _mm256_set1_ps(0.5f);
+	__m256i const unorm_r = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(output_r, scale), half));
+	__m256i const unorm_g = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(output_g, scale), half));
+	__m256i const unorm_b = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(output_b, scale), half));
+
+	// BGRA8: the lanes are in the order of the pixels
+	__m256i const pixels = _mm256_or_si256(_mm256_or_si256(unorm_b, _mm256_slli_epi32(unorm_g, 8)), _mm256_or_si256(_mm256_slli_epi32(unorm_r, 16), _mm256_set1_epi32(static_cast<int>(0XFF000000U))));
+	_mm256_storeu_si256(reinterpret_cast<__m256i *>(display_color), pixels);
+}
+
+static TONEMAP_ENCODER_AVX2_TARGET uint32_t tonemap_encoder_avx2_encode_row(float const *hdr_color, uint32_t pixel_count, float exposure, uint8_t *display_color)
+{
+	__m256 const avx2_exposure = _mm256_set1_ps(exposure);
+
+	uint32_t pixel_index = 0U;
+	for (; (pixel_index + 8U) <= pixel_count; pixel_index += 8U)
+	{
+		float const *const source = hdr_color + 4U * pixel_index;
+		tonemap_encoder_avx2_encode(_mm256_loadu_ps(source), _mm256_loadu_ps(source + 8U), _mm256_loadu_ps(source + 16U), _mm256_loadu_ps(source + 24U), avx2_exposure, display_color + 4U * pixel_index);
+	}
+	return pixel_index;
+}
+
+static TONEMAP_ENCODER_AVX2_TARGET uint32_t tonemap_encoder_avx2_encode_row_half(uint16_t const *hdr_color, uint32_t pixel_count, float exposure, uint8_t *display_color)
+{
+	__m256 const avx2_exposure = _mm256_set1_ps(exposure);
+
+	uint32_t pixel_index = 0U;
+	for (; (pixel_index + 8U) <= pixel_count; pixel_index += 8U)
+	{
+		// the F16C: each 2 pixels (16 bytes) into 8 floats
+		__m128i const *const source = reinterpret_cast<__m128i const *>(hdr_color + 4U * pixel_index);
+		tonemap_encoder_avx2_encode(_mm256_cvtph_ps(_mm_loadu_si128(source + 0U)), _mm256_cvtph_ps(_mm_loadu_si128(source + 1U)), _mm256_cvtph_ps(_mm_loadu_si128(source + 2U)), _mm256_cvtph_ps(_mm_loadu_si128(source + 3U)), avx2_exposure, display_color + 4U * pixel_index);
+	}
+	return pixel_index;
+}
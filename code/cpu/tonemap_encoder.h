@@ -0,0 +1,27 @@
+#ifndef _CPU_TONEMAP_ENCODER_H_
+#define _CPU_TONEMAP_ENCODER_H_ 1
+
+//
+// The tone mapping of the post process ("aces_fitted" followed by "ToSRGB") of the rows of the HDR image into the 8-bit display image, 4 pixels at a time (see "simd.h").
+// The CPU which supports the AVX2 and the F16C (the CPUID at the runtime, the project is NOT built for the AVX2) encodes 8 pixels at a time, with the same result (the RGBA16F is converted by the F16C).
+// The "pow" of the "ToSRGB" is the "exp2(log2(x) / 2.2)" of the polynomial approximations, the result rounds to the same 8-bit value as the "TonemapAnalytic" (see "tonemap_lut.h") except at the rounding boundaries.
+//
+// The output is BGRA8 (DXGI_FORMAT_B8G8R8A8_UNORM), the same as the swap chain of the D3D11 backend, the alpha is 255.
+// The rows are independent, the caller parallelizes over the rows (e.g. "ThreadPool::ParallelFor").
+//
+
+#include <stdint.h>
+
+// [in] hdr_color: RGBA32F, the alpha is ignored
+// [in] exposure: the HDR color is multiplied by the exposure before the tone mapping (see "auto_exposure.h")
+// [out] display_color: BGRA8
+void TonemapEncodeRow(float const *hdr_color, uint32_t pixel_count, float exposure, uint8_t *display_color);
+
+// [in] hdr_color: RGBA16F (the same as the HDR color attachment of the "Demo"), the alpha is ignored
+// [out] display_color: BGRA8
+void TonemapEncodeRowHalf(uint16_t const *hdr_color, uint32_t pixel_count, float exposure, uint8_t *display_color);
+
+// "AVX2+F16C" or "SSE2" (the build defines "TONEMAP_ENCODER_NO_AVX2" to always use the SSE2)
+char const *TonemapEncoderGetPath();
+
+#endif
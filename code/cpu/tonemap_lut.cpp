@@ -0,0 +1,125 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <cmath>
+#include <algorithm>
+#include <vector>
+#include <xmmintrin.h>
+#include <emmintrin.h>
+
+#include "simd.h"
+#include "thread_pool.h"
+#include "tonemap_lut.h"
+
+// the texel coordinate [0, TONEMAP_LUT_SIZE - 1] of each channel of the HDR color (the "w" is undefined)
+static inline __m128 tonemap_lut_texel(float const color[3]);
+
+void BakeTonemapLUT(ThreadPool *thread_pool, std::vector<float> &lut)
+{
+	lut.assign(static_cast<size_t>(TONEMAP_LUT_SIZE) * TONEMAP_LUT_SIZE * TONEMAP_LUT_SIZE * 4U, 0.0F);
+
+	// the HDR value of each texel of the axis (the inverse of the "tonemap_lut_texel")
+	float texel_values[TONEMAP_LUT_SIZE];
+	for (uint32_t texel_index = 0U; texel_index < TONEMAP_LUT_SIZE; ++texel_index)
+	{
+		float const encoded = static_cast<float>(texel_index) / static_cast<float>(TONEMAP_LUT_SIZE - 1U);
+		texel_values[texel_index] = std::exp2(TONEMAP_LUT_LOG2_MIN + (TONEMAP_LUT_LOG2_MAX - TONEMAP_LUT_LOG2_MIN) * encoded);
+	}
+
+	float *const destination = &lut[0];
+
+	thread_pool->ParallelFor(TONEMAP_LUT_SIZE, 1U, [&](uint32_t begin, uint32_t end, uint32_t) {
+		for (uint32_t z = begin; z < end; ++z)
+		{
+			for (uint32_t y = 0U; y < TONEMAP_LUT_SIZE; ++y)
+			{
+				for (uint32_t x = 0U; x < TONEMAP_LUT_SIZE; ++x)
+				{
+					float const color[3] = {texel_values[x], texel_values[y], texel_values[z]};
+					float *const texel = destination + ((static_cast<size_t>(TONEMAP_LUT_SIZE) * z + y) * TONEMAP_LUT_SIZE + x) * 4U;
+					TonemapAnalytic(color, texel);
+					texel[3] = 1.0F;
+				}
+			}
+		}
+	});
+}
+
+void TonemapAnalytic(float const color[3], float display_color[3])
+{
+	// "aces_fitted"
+	static float const aces_input_mat[3][3] = {
+		{0.59719f, 0.35458f, 0.04823f},
+		{0.07600f, 0.90834f, 0.01566f},
+		{0.02840f, 0.13383f, 0.83777f}};
+
+	static float const aces_output_mat[3][3] = {
+		{1.60475f, -0.53108f, -0.07367f},
+		{-0.10208f, 1.10813f, -0.00605f},
+		{-0.00327f, -0.07276f, 1.07602f}};
+
+	float v[3];
+	for (int row = 0; row < 3; ++row)
+	{
+		v[row] = aces_input_mat[row][0] * color[0] + aces_input_mat[row][1] * color[1] + aces_input_mat[row][2] * color[2];
+	}
+
+	// Apply RRT and ODT
+	for (int component = 0; component < 3; ++component)
+	{
+		float const a = v[component] * (v[component] + 0.0245786f) - 0.000090537f;
+		float const b = v[component] * (0.983729f * v[component] + 0.4329510f) + 0.238081f;
+		v[component] = a / b;
+	}
+
+	for (int row = 0; row < 3; ++row)
+	{
+		// Clamp to [0, 1]
+		float const linear = std::min(std::max(aces_output_mat[row][0] * v[0] + aces_output_mat[row][1] * v[1] + aces_output_mat[row][2] * v[2], 0.0f), 1.0f);
+
+		// "ToSRGB"
+		display_color[row] = std::pow(linear, 1.0f / 2.2f);
+	}
+}
+
+void TonemapLUT(float const *lut, float const color[3], float display_color[3])
+{
+	__m128 const texel = tonemap_lut_texel(color);
+	// the last texel is reached by the fraction 1 of the previous one
+	__m128i const texel_index = _mm_cvttps_epi32(_mm_min_ps(texel, _mm_set1_ps(static_cast<float>(TONEMAP_LUT_SIZE - 2U))));
+	__m128 const fraction = _mm_sub_ps(texel, _mm_cvtepi32_ps(texel_index));
+
+	uint32_t texel_indices[4];
+	_mm_storeu_si128(reinterpret_cast<__m128i *>(texel_indices), texel_index);
+
+	size_t const stride_y = static_cast<size_t>(TONEMAP_LUT_SIZE) * 4U;
+	size_t const stride_z = static_cast<size_t>(TONEMAP_LUT_SIZE) * TONEMAP_LUT_SIZE * 4U;
+	float const *const texel_000 = lut + stride_z * texel_indices[2] + stride_y * texel_indices[1] + 4U * texel_indices[0];
+
+	// the texel is loaded as a whole (RGBA)
+	__m128 const fraction_x = _mm_shuffle_ps(fraction, fraction, _MM_SHUFFLE(0, 0, 0, 0));
+	__m128 const fraction_y = _mm_shuffle_ps(fraction, fraction, _MM_SHUFFLE(1, 1, 1, 1));
+	__m128 const fraction_z = _mm_shuffle_ps(fraction, fraction, _MM_SHUFFLE(2, 2, 2, 2));
+
+	__m128 const c00 = _mm_add_ps(_mm_loadu_ps(texel_000), _mm_mul_ps(fraction_x, _mm_sub_ps(_mm_loadu_ps(texel_000 + 4U), _mm_loadu_ps(texel_000))));
+	__m128 const c10 = _mm_add_ps(_mm_loadu_ps(texel_000 + stride_y), _mm_mul_ps(fraction_x, _mm_sub_ps(_mm_loadu_ps(texel_000 + stride_y + 4U), _mm_loadu_ps(texel_000 + stride_y))));
+	__m128 const c01 = _mm_add_ps(_mm_loadu_ps(texel_000 + stride_z), _mm_mul_ps(fraction_x, _mm_sub_ps(_mm_loadu_ps(texel_000 + stride_z + 4U), _mm_loadu_ps(texel_000 + stride_z))));
+	__m128 const c11 = _mm_add_ps(_mm_loadu_ps(texel_000 + stride_z + stride_y), _mm_mul_ps(fraction_x, _mm_sub_ps(_mm_loadu_ps(texel_000 + stride_z + stride_y + 4U), _mm_loadu_ps(texel_000 + stride_z + stride_y))));
+
+	__m128 const c0 = _mm_add_ps(c00, _mm_mul_ps(fraction_y, _mm_sub_ps(c10, c00)));
+	__m128 const c1 = _mm_add_ps(c01, _mm_mul_ps(fraction_y, _mm_sub_ps(c11, c01)));
+
+	float result[4];
+	_mm_storeu_ps(result, _mm_add_ps(c0, _mm_mul_ps(fraction_z, _mm_sub_ps(c1, c0))));
+	display_color[0] = result[0];
+	display_color[1] = result[1];
+	display_color[2] = result[2];
+}
+
+static inline __m128 tonemap_lut_texel(float const color[3])
+{
+	// the NaN and the negative values are black ("maxps" returns the second operand if either is NaN)
+	simd_float const value = max(simd_float(_mm_set_ps(0.0F, color[2], color[1], color[0])), simd_float(std::exp2(TONEMAP_LUT_LOG2_MIN)));
+
+	simd_float const texel = (log2(value) - simd_float(TONEMAP_LUT_LOG2_MIN)) * simd_float(static_cast<float>(TONEMAP_LUT_SIZE - 1U) / (TONEMAP_LUT_LOG2_MAX - TONEMAP_LUT_LOG2_MIN));
+	return min(max(texel, simd_float(0.0F)), simd_float(static_cast<float>(TONEMAP_LUT_SIZE - 1U))).v;
+}
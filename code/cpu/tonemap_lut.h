@@ -0,0 +1,35 @@
+#ifndef _CPU_TONEMAP_LUT_H_
+#define _CPU_TONEMAP_LUT_H_ 1
+
+//
+// The tone mapping of the post process ("aces_fitted" followed by "ToSRGB") baked into the 3D LUT, such that the post process is a single trilinear lookup.
+//
+// The HDR color is encoded per channel by the log2 over [TONEMAP_LUT_LOG2_MIN, TONEMAP_LUT_LOG2_MAX] (the values outside are clamped),
+// the texel "i" of each axis is at the encoded value "i / (TONEMAP_LUT_SIZE - 1)", such that the first and the last texels are exactly the ends of the range.
+// The coordinate of the sampler is "(encoded * (TONEMAP_LUT_SIZE - 1) + 0.5) / TONEMAP_LUT_SIZE" (see "shaders/post_process_fs.hlsl").
+//
+// The LUT stores the display (sRGB) values, the interpolation between the texels is perceptually uniform.
+// The error is the largest where the output matrix of the "aces_fitted" is clipped (the saturated colors), see the "--tonemap" of "support/headless_main.h".
+//
+
+#include <stdint.h>
+#include <vector>
+
+static const uint32_t TONEMAP_LUT_SIZE = 32U;
+// 2^-10 is below the toe of the "rrt_odt_fit" (black), 2^6 is beyond the shoulder (white)
+static const float TONEMAP_LUT_LOG2_MIN = -10.0F;
+static const float TONEMAP_LUT_LOG2_MAX = 6.0F;
+
+// [in] thread_pool: The slices of the LUT are baked in parallel.
+// [out] lut: RGBA32F, TONEMAP_LUT_SIZE^3 texels, the red is the "x" (the fastest) and the blue is the "z" (the slowest), the alpha is 1.
+void BakeTonemapLUT(class ThreadPool *thread_pool, std::vector<float> &lut);
+
+// The reference: the same curve as the "post_process_fs.hlsl" before the LUT.
+// [in] color: the linear HDR color
+// [out] display_color: [0, 1]
+void TonemapAnalytic(float const color[3], float display_color[3]);
+
+// The trilinear lookup of the LUT of the "BakeTonemapLUT".
+void TonemapLUT(float const *lut, float const color[3], float display_color[3]);
+
+#endif
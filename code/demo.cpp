@@ -1,100 +1,70 @@
 
-#include <sdkddkver.h>
-#define WIN32_LEAN_AND_MEAN
-#define NOMINMAX 1
-#include <windows.h>
-
 #include <stdint.h>
+#include <string.h>
 #include <assert.h>
 #include <cmath>
 #include <algorithm>
+#include <vector>
 
 #include <DirectXMath.h>
 
-#include <dxgi.h>
-#include <d3d11.h>
-
-#include "support/resolution.h"
-
 #include "support/camera_controller.h"
 
-#include "demo.h"
-
-#include "ltc_lut_data.h"
-
-#include "../shaders/plane_vs.hlsl.inl"
+#include "cpu/thread_pool.h"
 
-#include "../shaders/plane_fs.hlsl.inl"
+#include "cpu/texture_prefilter.h"
+#include "cpu/tonemap_lut.h"
+#include "cpu/auto_exposure.h"
 
-#include "../shaders/rect_light_vs.hlsl.inl"
+#include "cpu/frame_arena.h"
 
-#include "../shaders/rect_light_fs.hlsl.inl"
+#include "cpu/dynamic_resolution.h"
 
-#include "../shaders/post_process_vs.hlsl.inl"
+#include "demo_uniform_buffer.h"
 
-#include "../shaders/post_process_fs.hlsl.inl"
+#include "demo.h"
 
-struct plane_uniform_buffer_per_frame_binding_t
-{
-	// mesh
-	DirectX::XMFLOAT4X4 model_transform;
-	DirectX::XMFLOAT3 dcolor;
-	float _padding_dcolor;
-	DirectX::XMFLOAT3 scolor;
-	float _padding_scolor;
-	float roughness;
-	float _padding_roughness_1;
-	float _padding_roughness_2;
-	float _padding_roughness_3;
-
-	// camera
-	DirectX::XMFLOAT4X4 view_transform;
-	DirectX::XMFLOAT4X4 projection_transform;
-	DirectX::XMFLOAT3 eye_position;
-	float _padding_eye_position;
+#include "ltc_lut_data.h"
 
-	// light
-	DirectX::XMFLOAT4 rect_light_vetices[4];
-	float intensity;
-	float twoSided;
-	float __padding_align16_1;
-	float __padding_align16_2;
-};
-
-struct rect_light_uniform_buffer_per_frame_binding_t
-{
-	// camera
-	DirectX::XMFLOAT4X4 view_transform;
-	DirectX::XMFLOAT4X4 projection_transform;
-
-	// light
-	DirectX::XMFLOAT4 rect_light_vetices[4];
-	float intensity;
-	float __padding_align16_1;
-	float __padding_align16_2;
-	float __padding_align16_3;
-};
+// the frames of which the transient data may still be read by the backend
+static uint32_t const g_demo_frame_in_flight_count = 2U;
+// the LUT staging of the "Init" is the largest user, the steady state frame uses much less
+static size_t const g_demo_frame_arena_capacity = 64U * 1024U;
+// the distance between the overdraw layers (the depth buffer resolves it over the whole plane)
+static float const g_demo_overdraw_layer_spacing = 0.01f;
+// the live resize: the render resolution is rounded down to the multiple of the bucket until the size is unchanged for the frames
+static uint32_t const g_demo_live_resize_bucket_size = 64U;
+static uint32_t const g_demo_live_resize_settle_frame_count = 8U;
 
 static uint8_t float_to_unorm(float unpacked_input);
 
 static int8_t float_to_snorm(float unpacked_input);
 
-void Demo::Init(ID3D11Device* d3d_device, ID3D11DeviceContext* d3d_device_context, IDXGISwapChain* dxgi_swap_chain)
-{
-	m_attachment_backbuffer_rtv = NULL;
-	{
-		ID3D11Texture2D* attachment_backbuffer = NULL;
-		HRESULT res_dxgi_swap_chain_get_buffer = dxgi_swap_chain->GetBuffer(0U, IID_PPV_ARGS(&attachment_backbuffer));
-		assert(SUCCEEDED(res_dxgi_swap_chain_get_buffer));
+static inline uint32_t demo_live_resize_bucket(uint32_t size);
 
-		D3D11_RENDER_TARGET_VIEW_DESC d3d_render_target_view_desc;
-		d3d_render_target_view_desc.Format = DXGI_FORMAT_B8G8R8A8_UNORM;
-		d3d_render_target_view_desc.ViewDimension = D3D11_RTV_DIMENSION_TEXTURE2D;
-		d3d_render_target_view_desc.Texture2D.MipSlice = 0U;
+static void generate_video_wall_light_image(uint32_t width, uint32_t height, float *light_image);
 
-		HRESULT res_d3d_device_create_render_target_view = d3d_device->CreateRenderTargetView(attachment_backbuffer, &d3d_render_target_view_desc, &m_attachment_backbuffer_rtv);
-		assert(SUCCEEDED(res_d3d_device_create_render_target_view));
-	}
+void Demo::Init(RenderBackend *render_backend, demo_settings_t const &settings)
+{
+	m_settings = settings;
+	m_settings.overdraw_layer_count = std::min(std::max(settings.overdraw_layer_count, 1U), DEMO_MAX_OVERDRAW_LAYER_COUNT);
+	// the G-buffer pass already shades each pixel once
+	m_settings.depth_prepass = settings.depth_prepass && (DEMO_SHADING_MODE_DEFERRED != settings.shading_mode);
+	// the lighting of the forward shading is NOT separated from the rasterization
+	m_settings.checkerboard_shading = settings.checkerboard_shading && (DEMO_SHADING_MODE_DEFERRED == settings.shading_mode);
+	// the history of the checkerboard is reprojected at the full resolution
+	m_settings.dynamic_resolution = settings.dynamic_resolution && (!m_settings.checkerboard_shading) && (settings.frame_time_budget_ms > 0.0f);
+
+	m_output_width = render_backend->GetBackbufferWidth();
+	m_output_height = render_backend->GetBackbufferHeight();
+	m_dynamic_resolution.Init(m_settings.dynamic_resolution ? m_settings.frame_time_budget_ms : 1.0f);
+	m_render_width = m_output_width;
+	m_render_height = m_output_height;
+	m_live_resize_frame_count = g_demo_live_resize_settle_frame_count;
+
+	m_frame_arena.Init(g_demo_frame_in_flight_count, g_demo_frame_arena_capacity);
+	// the staging of the "Init"
+	m_frame_arena.BeginFrame();
 
 	m_plane_vb_position = NULL;
 	{
@@ -104,21 +74,8 @@ void Demo::Init(ID3D11Device* d3d_device, ID3D11DeviceContext* d3d_device_contex
 			-7777.0, 0.0, -7777.0,
 			7777.0, 0.0, -7777.0 };
 
-		D3D11_BUFFER_DESC d3d_buffer_desc;
-		d3d_buffer_desc.ByteWidth = sizeof(vb_position_data);
-		d3d_buffer_desc.Usage = D3D11_USAGE_DEFAULT;
-		d3d_buffer_desc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-		d3d_buffer_desc.CPUAccessFlags = 0U;
-		d3d_buffer_desc.MiscFlags = 0U;
-		d3d_buffer_desc.StructureByteStride = 0U;
-
-		D3D11_SUBRESOURCE_DATA d3d_subresource_data;
-		d3d_subresource_data.pSysMem = vb_position_data;
-		d3d_subresource_data.SysMemPitch = sizeof(vb_position_data);
-		d3d_subresource_data.SysMemSlicePitch = sizeof(vb_position_data);
-
-		HRESULT res_d3d_device_create_buffer = d3d_device->CreateBuffer(&d3d_buffer_desc, &d3d_subresource_data, &m_plane_vb_position);
-		assert(SUCCEEDED(res_d3d_device_create_buffer));
+		m_plane_vb_position = render_backend->CreateBuffer(RENDER_BACKEND_BUFFER_USAGE_VERTEX, sizeof(vb_position_data), vb_position_data);
+		assert(NULL != m_plane_vb_position);
 	}
 
 	m_plane_vb_varying = NULL;
@@ -129,360 +86,422 @@ void Demo::Init(ID3D11Device* d3d_device, ID3D11DeviceContext* d3d_device_contex
 			0.0, 1.0, 0.0,
 			0.0, 1.0, 0.0 };
 
-		D3D11_BUFFER_DESC d3d_buffer_desc;
-		d3d_buffer_desc.ByteWidth = sizeof(vb_varying_data);
-		d3d_buffer_desc.Usage = D3D11_USAGE_DEFAULT;
-		d3d_buffer_desc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-		d3d_buffer_desc.CPUAccessFlags = 0U;
-		d3d_buffer_desc.MiscFlags = 0U;
-		d3d_buffer_desc.StructureByteStride = 0U;
-
-		D3D11_SUBRESOURCE_DATA d3d_subresource_data;
-		d3d_subresource_data.pSysMem = vb_varying_data;
-		d3d_subresource_data.SysMemPitch = sizeof(vb_varying_data);
-		d3d_subresource_data.SysMemSlicePitch = sizeof(vb_varying_data);
+		m_plane_vb_varying = render_backend->CreateBuffer(RENDER_BACKEND_BUFFER_USAGE_VERTEX, sizeof(vb_varying_data), vb_varying_data);
+		assert(NULL != m_plane_vb_varying);
+	}
 
-		HRESULT res_d3d_device_create_buffer = d3d_device->CreateBuffer(&d3d_buffer_desc, &d3d_subresource_data, &m_plane_vb_varying);
-		assert(SUCCEEDED(res_d3d_device_create_buffer));
+	m_plane_pipeline = NULL;
+	{
+		render_backend_pipeline_desc_t pipeline_desc;
+		pipeline_desc.program = RENDER_BACKEND_PROGRAM_PLANE;
+		// the light is one-sided (see the "twoSided" of the light set)
+		pipeline_desc.permutation = RENDER_BACKEND_PERMUTATION_DIFFUSE_BURLEY_BIT | RENDER_BACKEND_PERMUTATION_DUAL_LOBE_BIT | RENDER_BACKEND_PERMUTATION_HORIZON_CLIPPING_BIT;
+		pipeline_desc.front_counter_clockwise = true;
+		// only the fragments which are visible after the depth pre-pass are shaded
+		pipeline_desc.depth_test = m_settings.depth_prepass ? RENDER_BACKEND_DEPTH_TEST_EQUAL : RENDER_BACKEND_DEPTH_TEST_LESS;
+
+		m_plane_pipeline = render_backend->CreatePipeline(pipeline_desc);
+		assert(NULL != m_plane_pipeline);
 	}
 
-	m_plane_vao = NULL;
+	m_plane_depth_pipeline = NULL;
 	{
-		D3D11_INPUT_ELEMENT_DESC d3d_input_elements_desc[] =
-		{
-			{"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0},
-			{"NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 1, 0, D3D11_INPUT_PER_VERTEX_DATA, 0},
-		};
+		render_backend_pipeline_desc_t pipeline_desc;
+		pipeline_desc.program = RENDER_BACKEND_PROGRAM_PLANE_DEPTH;
+		pipeline_desc.permutation = 0U;
+		pipeline_desc.front_counter_clockwise = true;
+		pipeline_desc.depth_test = RENDER_BACKEND_DEPTH_TEST_LESS;
+
+		m_plane_depth_pipeline = render_backend->CreatePipeline(pipeline_desc);
+		assert(NULL != m_plane_depth_pipeline);
+	}
 
-		HRESULT res_d3d_create_input_layout = d3d_device->CreateInputLayout(
-			d3d_input_elements_desc,
-			sizeof(d3d_input_elements_desc) / sizeof(d3d_input_elements_desc[0]),
-			plane_vs_bytecode,
-			sizeof(plane_vs_bytecode),
-			&m_plane_vao);
-		assert(SUCCEEDED(res_d3d_create_input_layout));
+	m_plane_gbuffer_pipeline = NULL;
+	{
+		render_backend_pipeline_desc_t pipeline_desc;
+		pipeline_desc.program = RENDER_BACKEND_PROGRAM_PLANE_GBUFFER;
+		pipeline_desc.permutation = 0U;
+		pipeline_desc.front_counter_clockwise = true;
+		pipeline_desc.depth_test = RENDER_BACKEND_DEPTH_TEST_LESS;
+
+		m_plane_gbuffer_pipeline = render_backend->CreatePipeline(pipeline_desc);
+		assert(NULL != m_plane_gbuffer_pipeline);
 	}
 
-	m_plane_vs = NULL;
+	m_deferred_lighting_pipeline = NULL;
 	{
-		HRESULT res_d3d_device_create_vertex_shader = d3d_device->CreateVertexShader(plane_vs_bytecode, sizeof(plane_vs_bytecode), NULL, &m_plane_vs);
-		assert(SUCCEEDED(res_d3d_device_create_vertex_shader));
+		render_backend_pipeline_desc_t pipeline_desc;
+		pipeline_desc.program = RENDER_BACKEND_PROGRAM_DEFERRED_LIGHTING;
+		// the same permutation as the forward
+		pipeline_desc.permutation = RENDER_BACKEND_PERMUTATION_DIFFUSE_BURLEY_BIT | RENDER_BACKEND_PERMUTATION_DUAL_LOBE_BIT | RENDER_BACKEND_PERMUTATION_HORIZON_CLIPPING_BIT;
+		pipeline_desc.front_counter_clockwise = false;
+		// the depth of the G-buffer pass is kept for the rect light
+		pipeline_desc.depth_test = RENDER_BACKEND_DEPTH_TEST_NONE;
+
+		m_deferred_lighting_pipeline = render_backend->CreatePipeline(pipeline_desc);
+		assert(NULL != m_deferred_lighting_pipeline);
 	}
 
-	m_plane_fs = NULL;
+	m_checkerboard_resolve_pipeline = NULL;
 	{
-		HRESULT res_d3d_device_create_pixel_shader = d3d_device->CreatePixelShader(plane_fs_bytecode, sizeof(plane_fs_bytecode), NULL, &m_plane_fs);
-		assert(SUCCEEDED(res_d3d_device_create_pixel_shader));
+		render_backend_pipeline_desc_t pipeline_desc;
+		pipeline_desc.program = RENDER_BACKEND_PROGRAM_CHECKERBOARD_RESOLVE;
+		pipeline_desc.permutation = 0U;
+		pipeline_desc.front_counter_clockwise = false;
+		// the depth of the G-buffer pass is kept for the rect light
+		pipeline_desc.depth_test = RENDER_BACKEND_DEPTH_TEST_NONE;
+
+		m_checkerboard_resolve_pipeline = render_backend->CreatePipeline(pipeline_desc);
+		assert(NULL != m_checkerboard_resolve_pipeline);
 	}
 
-	m_plane_rs = NULL;
+	m_rect_light_pipeline = NULL;
 	{
-		D3D11_RASTERIZER_DESC d3d_rasterizer_desc;
-		d3d_rasterizer_desc.FillMode = D3D11_FILL_SOLID;
-		d3d_rasterizer_desc.CullMode = D3D11_CULL_BACK;
-		d3d_rasterizer_desc.FrontCounterClockwise = TRUE;
-		d3d_rasterizer_desc.DepthBias = 0;
-		d3d_rasterizer_desc.SlopeScaledDepthBias = 0.0f;
-		d3d_rasterizer_desc.DepthBiasClamp = 0.0f;
-		d3d_rasterizer_desc.DepthClipEnable = TRUE;
-		d3d_rasterizer_desc.ScissorEnable = FALSE;
-		d3d_rasterizer_desc.MultisampleEnable = FALSE;
-		d3d_rasterizer_desc.AntialiasedLineEnable = FALSE;
-		d3d_rasterizer_desc.MultisampleEnable = FALSE;
-		HRESULT res_d3d_device_create_rasterizer_state = d3d_device->CreateRasterizerState(&d3d_rasterizer_desc, &m_plane_rs);
-		assert(SUCCEEDED(res_d3d_device_create_rasterizer_state));
+		render_backend_pipeline_desc_t pipeline_desc;
+		pipeline_desc.program = RENDER_BACKEND_PROGRAM_RECT_LIGHT;
+		pipeline_desc.permutation = 0U;
+		pipeline_desc.front_counter_clockwise = false;
+		pipeline_desc.depth_test = RENDER_BACKEND_DEPTH_TEST_LESS;
+
+		m_rect_light_pipeline = render_backend->CreatePipeline(pipeline_desc);
+		assert(NULL != m_rect_light_pipeline);
 	}
 
-	m_plane_uniform_buffer_per_frame_binding = NULL;
+	m_uniform_buffer_per_view_binding = NULL;
 	{
-		D3D11_BUFFER_DESC d3d_buffer_desc;
-		d3d_buffer_desc.ByteWidth = sizeof(plane_uniform_buffer_per_frame_binding_t);
-		d3d_buffer_desc.Usage = D3D11_USAGE_DEFAULT;
-		d3d_buffer_desc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
-		d3d_buffer_desc.CPUAccessFlags = 0U;
-		d3d_buffer_desc.MiscFlags = 0U;
-		d3d_buffer_desc.StructureByteStride = 0U;
+		m_uniform_buffer_per_view_binding = render_backend->CreateBuffer(RENDER_BACKEND_BUFFER_USAGE_CONSTANT, sizeof(uniform_buffer_per_view_binding_t), NULL);
+		assert(NULL != m_uniform_buffer_per_view_binding);
 
-		HRESULT res_d3d_device_create_buffer = d3d_device->CreateBuffer(&d3d_buffer_desc, NULL, &m_plane_uniform_buffer_per_frame_binding);
-		assert(SUCCEEDED(res_d3d_device_create_buffer));
+		// filled by the first "Tick"
+		memset(&m_uniform_buffer_data_per_view_binding, 0, sizeof(uniform_buffer_per_view_binding_t));
+		m_uniform_buffer_per_view_binding_dirty = true;
 	}
 
-	m_rect_light_vao = NULL;
-
-	m_rect_light_vs = NULL;
+	m_uniform_buffer_per_light_set_binding = NULL;
 	{
-		HRESULT res_d3d_device_create_vertex_shader = d3d_device->CreateVertexShader(rect_light_vs_bytecode, sizeof(rect_light_vs_bytecode), NULL, &m_rect_light_vs);
-		assert(SUCCEEDED(res_d3d_device_create_vertex_shader));
+		m_uniform_buffer_per_light_set_binding = render_backend->CreateBuffer(RENDER_BACKEND_BUFFER_USAGE_CONSTANT, sizeof(uniform_buffer_per_light_set_binding_t), NULL);
+		assert(NULL != m_uniform_buffer_per_light_set_binding);
 	}
 
-	m_rect_light_fs = NULL;
+	for (uint32_t layer_index = 0U; layer_index < DEMO_MAX_OVERDRAW_LAYER_COUNT; ++layer_index)
 	{
-		HRESULT res_d3d_device_create_pixel_shader = d3d_device->CreatePixelShader(rect_light_fs_bytecode, sizeof(rect_light_fs_bytecode), NULL, &m_rect_light_fs);
-		assert(SUCCEEDED(res_d3d_device_create_pixel_shader));
+		m_uniform_buffer_per_material_bindings[layer_index] = NULL;
+		if (layer_index < m_settings.overdraw_layer_count)
+		{
+			m_uniform_buffer_per_material_bindings[layer_index] = render_backend->CreateBuffer(RENDER_BACKEND_BUFFER_USAGE_CONSTANT, sizeof(uniform_buffer_per_material_binding_t), NULL);
+			assert(NULL != m_uniform_buffer_per_material_bindings[layer_index]);
+		}
 	}
 
-	m_rect_light_rs = NULL;
+	m_uniform_buffer_per_frame_binding = NULL;
 	{
-		D3D11_RASTERIZER_DESC d3d_rasterizer_desc;
-		d3d_rasterizer_desc.FillMode = D3D11_FILL_SOLID;
-		d3d_rasterizer_desc.CullMode = D3D11_CULL_BACK;
-		d3d_rasterizer_desc.FrontCounterClockwise = FALSE;
-		d3d_rasterizer_desc.DepthBias = 0;
-		d3d_rasterizer_desc.SlopeScaledDepthBias = 0.0f;
-		d3d_rasterizer_desc.DepthBiasClamp = 0.0f;
-		d3d_rasterizer_desc.DepthClipEnable = TRUE;
-		d3d_rasterizer_desc.ScissorEnable = FALSE;
-		d3d_rasterizer_desc.MultisampleEnable = FALSE;
-		d3d_rasterizer_desc.AntialiasedLineEnable = FALSE;
-		d3d_rasterizer_desc.MultisampleEnable = FALSE;
-		HRESULT res_d3d_device_create_rasterizer_state = d3d_device->CreateRasterizerState(&d3d_rasterizer_desc, &m_rect_light_rs);
-		assert(SUCCEEDED(res_d3d_device_create_rasterizer_state));
+		m_uniform_buffer_per_frame_binding = render_backend->CreateBuffer(RENDER_BACKEND_BUFFER_USAGE_CONSTANT, sizeof(uniform_buffer_per_frame_binding_t), NULL);
+		assert(NULL != m_uniform_buffer_per_frame_binding);
+
+		// filled by the first "Tick"
+		memset(&m_uniform_buffer_data_per_frame_binding, 0, sizeof(uniform_buffer_per_frame_binding_t));
+		m_uniform_buffer_per_frame_binding_dirty = true;
 	}
 
-	m_rect_light_uniform_buffer_per_frame_binding = NULL;
+	m_frame_index = 0U;
+	DirectX::XMStoreFloat4x4(&m_previous_view_projection_transform, DirectX::XMMatrixIdentity());
+
+	m_history_textures[0] = NULL;
+	m_history_textures[1] = NULL;
+	m_history_width = 0U;
+	m_history_height = 0U;
+	// the first frame has no history (the textures are created by the first "Tick")
+	m_history_valid = false;
+
+	m_auto_exposure_histogram_pipeline = NULL;
 	{
-		D3D11_BUFFER_DESC d3d_buffer_desc;
-		d3d_buffer_desc.ByteWidth = sizeof(rect_light_uniform_buffer_per_frame_binding_t);
-		d3d_buffer_desc.Usage = D3D11_USAGE_DEFAULT;
-		d3d_buffer_desc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
-		d3d_buffer_desc.CPUAccessFlags = 0U;
-		d3d_buffer_desc.MiscFlags = 0U;
-		d3d_buffer_desc.StructureByteStride = 0U;
+		render_backend_pipeline_desc_t pipeline_desc;
+		pipeline_desc.program = RENDER_BACKEND_PROGRAM_AUTO_EXPOSURE_HISTOGRAM;
+		pipeline_desc.permutation = 0U;
+		pipeline_desc.front_counter_clockwise = false;
+		pipeline_desc.depth_test = RENDER_BACKEND_DEPTH_TEST_NONE;
+
+		m_auto_exposure_histogram_pipeline = render_backend->CreatePipeline(pipeline_desc);
+		assert(NULL != m_auto_exposure_histogram_pipeline);
+	}
 
-		HRESULT res_d3d_device_create_buffer = d3d_device->CreateBuffer(&d3d_buffer_desc, NULL, &m_rect_light_uniform_buffer_per_frame_binding);
-		assert(SUCCEEDED(res_d3d_device_create_buffer));
+	m_auto_exposure_pipeline = NULL;
+	{
+		render_backend_pipeline_desc_t pipeline_desc;
+		pipeline_desc.program = RENDER_BACKEND_PROGRAM_AUTO_EXPOSURE;
+		pipeline_desc.permutation = 0U;
+		pipeline_desc.front_counter_clockwise = false;
+		pipeline_desc.depth_test = RENDER_BACKEND_DEPTH_TEST_NONE;
+
+		m_auto_exposure_pipeline = render_backend->CreatePipeline(pipeline_desc);
+		assert(NULL != m_auto_exposure_pipeline);
 	}
 
-	m_post_process_vao = NULL;
+	for (uint32_t exposure_index = 0U; exposure_index < 2U; ++exposure_index)
+	{
+		render_backend_texture_desc_t texture_desc;
+		texture_desc.width = 1U;
+		texture_desc.height = 1U;
+		texture_desc.depth = 1U;
+		texture_desc.mip_level_count = 1U;
+		texture_desc.format = RENDER_BACKEND_FORMAT_R32G32B32A32_FLOAT;
+		texture_desc.usage = RENDER_BACKEND_TEXTURE_USAGE_SAMPLED | RENDER_BACKEND_TEXTURE_USAGE_COLOR_ATTACHMENT;
+		texture_desc.view_dimension = RENDER_BACKEND_TEXTURE_VIEW_DIMENSION_2D;
+
+		// the exposure 1 is the adapted luminance of the key
+		float const exposure_data[4] = {1.0f, std::log2(AUTO_EXPOSURE_KEY), 0.0f, 1.0f};
+
+		render_backend_subresource_data_t subresource_data;
+		subresource_data.data = exposure_data;
+		subresource_data.row_pitch = sizeof(exposure_data);
+		subresource_data.slice_pitch = sizeof(exposure_data);
+
+		m_exposure_textures[exposure_index] = render_backend->CreateTexture(texture_desc, &subresource_data);
+		assert(NULL != m_exposure_textures[exposure_index]);
+	}
+	// the first frame is NOT adapted
+	m_exposure_valid = false;
 
-	m_post_process_vs = NULL;
+	m_post_process_pipeline = NULL;
 	{
-		HRESULT res_d3d_device_create_vertex_shader = d3d_device->CreateVertexShader(post_process_vs_bytecode, sizeof(post_process_vs_bytecode), NULL, &m_post_process_vs);
-		assert(SUCCEEDED(res_d3d_device_create_vertex_shader));
+		render_backend_pipeline_desc_t pipeline_desc;
+		pipeline_desc.program = RENDER_BACKEND_PROGRAM_POST_PROCESS;
+		pipeline_desc.permutation = 0U;
+		pipeline_desc.front_counter_clockwise = false;
+		pipeline_desc.depth_test = RENDER_BACKEND_DEPTH_TEST_NONE;
+
+		m_post_process_pipeline = render_backend->CreatePipeline(pipeline_desc);
+		assert(NULL != m_post_process_pipeline);
 	}
 
-	m_post_process_fs = NULL;
+	m_tonemap_lut_sampler = NULL;
 	{
-		HRESULT res_d3d_device_create_pixel_shader = d3d_device->CreatePixelShader(post_process_fs_bytecode, sizeof(post_process_fs_bytecode), NULL, &m_post_process_fs);
-		assert(SUCCEEDED(res_d3d_device_create_pixel_shader));
+		// trilinear (the "MIN_POINT" of the LTC LUT sampler is the nearest texel when the LUT is minified)
+		m_tonemap_lut_sampler = render_backend->CreateSampler(RENDER_BACKEND_FILTER_MIN_MAG_MIP_LINEAR);
+		assert(NULL != m_tonemap_lut_sampler);
 	}
 
-	m_post_process_rs = NULL;
+	m_tonemap_lut = NULL;
 	{
-		D3D11_RASTERIZER_DESC d3d_rasterizer_desc;
-		d3d_rasterizer_desc.FillMode = D3D11_FILL_SOLID;
-		d3d_rasterizer_desc.CullMode = D3D11_CULL_BACK;
-		d3d_rasterizer_desc.FrontCounterClockwise = FALSE;
-		d3d_rasterizer_desc.DepthBias = 0;
-		d3d_rasterizer_desc.SlopeScaledDepthBias = 0.0f;
-		d3d_rasterizer_desc.DepthBiasClamp = 0.0f;
-		d3d_rasterizer_desc.DepthClipEnable = TRUE;
-		d3d_rasterizer_desc.ScissorEnable = FALSE;
-		d3d_rasterizer_desc.MultisampleEnable = FALSE;
-		d3d_rasterizer_desc.AntialiasedLineEnable = FALSE;
-		d3d_rasterizer_desc.MultisampleEnable = FALSE;
-		HRESULT res_d3d_device_create_rasterizer_state = d3d_device->CreateRasterizerState(&d3d_rasterizer_desc, &m_post_process_rs);
-		assert(SUCCEEDED(res_d3d_device_create_rasterizer_state));
+		std::vector<float> tonemap_lut;
+		{
+			ThreadPool thread_pool;
+			thread_pool.Init(0U);
+			BakeTonemapLUT(&thread_pool, tonemap_lut);
+			thread_pool.Destroy();
+		}
+
+		render_backend_texture_desc_t texture_desc;
+		texture_desc.width = TONEMAP_LUT_SIZE;
+		texture_desc.height = TONEMAP_LUT_SIZE;
+		texture_desc.depth = TONEMAP_LUT_SIZE;
+		texture_desc.mip_level_count = 1U;
+		texture_desc.format = RENDER_BACKEND_FORMAT_R32G32B32A32_FLOAT;
+		texture_desc.usage = RENDER_BACKEND_TEXTURE_USAGE_SAMPLED;
+		texture_desc.view_dimension = RENDER_BACKEND_TEXTURE_VIEW_DIMENSION_3D;
+
+		render_backend_subresource_data_t subresource_data;
+		subresource_data.data = &tonemap_lut[0];
+		subresource_data.row_pitch = sizeof(float) * 4U * TONEMAP_LUT_SIZE;
+		subresource_data.slice_pitch = sizeof(float) * 4U * TONEMAP_LUT_SIZE * TONEMAP_LUT_SIZE;
+
+		m_tonemap_lut = render_backend->CreateTexture(texture_desc, &subresource_data);
+		assert(NULL != m_tonemap_lut);
 	}
 
 	m_ltc_lut_sampler = NULL;
 	{
-		D3D11_SAMPLER_DESC d3d_sampler_desc;
-		d3d_sampler_desc.Filter = D3D11_FILTER_MIN_POINT_MAG_LINEAR_MIP_POINT;
-		d3d_sampler_desc.AddressU = D3D11_TEXTURE_ADDRESS_CLAMP;
-		d3d_sampler_desc.AddressV = D3D11_TEXTURE_ADDRESS_CLAMP;
-		d3d_sampler_desc.AddressW = D3D11_TEXTURE_ADDRESS_CLAMP;
-		d3d_sampler_desc.MipLODBias = 0.0;
-		d3d_sampler_desc.MaxAnisotropy = 0U;
-		d3d_sampler_desc.ComparisonFunc = D3D11_COMPARISON_ALWAYS;
-		d3d_sampler_desc.BorderColor[0] = 0.0;
-		d3d_sampler_desc.BorderColor[1] = 0.0;
-		d3d_sampler_desc.BorderColor[2] = 0.0;
-		d3d_sampler_desc.BorderColor[3] = 1.0;
-		d3d_sampler_desc.MinLOD = 0.0;
-		d3d_sampler_desc.MaxLOD = 4096.0;
-
-		HRESULT res_d3d_device_create_sampler = d3d_device->CreateSamplerState(&d3d_sampler_desc, &m_ltc_lut_sampler);
-		assert(SUCCEEDED(res_d3d_device_create_sampler));
+		m_ltc_lut_sampler = render_backend->CreateSampler(RENDER_BACKEND_FILTER_MIN_POINT_MAG_LINEAR_MIP_POINT);
+		assert(NULL != m_ltc_lut_sampler);
 	}
 
 	m_ltc_matrix_lut = NULL;
 	{
 		static_assert((4U * 64U * 64U) == (sizeof(g_ltc_ggx_matrix_lut_data) / sizeof(g_ltc_ggx_matrix_lut_data[0])), "");
 
-		D3D11_TEXTURE2D_DESC d3d_texture2d_desc;
-		d3d_texture2d_desc.Width = 64U;
-		d3d_texture2d_desc.Height = 64U;
-		d3d_texture2d_desc.MipLevels = 1U;
-		d3d_texture2d_desc.ArraySize = 1U;
-		d3d_texture2d_desc.Format = DXGI_FORMAT_R8G8B8A8_SNORM;
-		d3d_texture2d_desc.SampleDesc.Count = 1U;
-		d3d_texture2d_desc.SampleDesc.Quality = 0U;
-		d3d_texture2d_desc.Usage = D3D11_USAGE_DEFAULT;
-		d3d_texture2d_desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
-		d3d_texture2d_desc.CPUAccessFlags = 0U;
-		d3d_texture2d_desc.MiscFlags = 0U;
-
-		int8_t ltc_ggx_matrix_unorm_data[4 * 64 * 64];
+		render_backend_texture_desc_t texture_desc;
+		texture_desc.width = 64U;
+		texture_desc.height = 64U;
+		texture_desc.depth = 1U;
+		texture_desc.mip_level_count = 1U;
+		texture_desc.format = RENDER_BACKEND_FORMAT_R8G8B8A8_SNORM;
+		texture_desc.usage = RENDER_BACKEND_TEXTURE_USAGE_SAMPLED;
+		texture_desc.view_dimension = RENDER_BACKEND_TEXTURE_VIEW_DIMENSION_2D_ARRAY;
+
+		int8_t *ltc_ggx_matrix_unorm_data = m_frame_arena.Allocate<int8_t>(4 * 64 * 64);
 		for (int i = 0; i < (4 * 64 * 64); ++i)
 		{
 			ltc_ggx_matrix_unorm_data[i] = float_to_snorm(g_ltc_ggx_matrix_lut_data[i]);
 		}
 
-		D3D11_SUBRESOURCE_DATA d3d_subresource_data;
-		d3d_subresource_data.pSysMem = ltc_ggx_matrix_unorm_data;
-		d3d_subresource_data.SysMemPitch = sizeof(int8_t) * 4 * 64;
-		d3d_subresource_data.SysMemSlicePitch = sizeof(int8_t) * 4 * 64 * 64;
+		render_backend_subresource_data_t subresource_data;
+		subresource_data.data = ltc_ggx_matrix_unorm_data;
+		subresource_data.row_pitch = sizeof(int8_t) * 4 * 64;
+		subresource_data.slice_pitch = sizeof(int8_t) * 4 * 64 * 64;
 
-		HRESULT res_d3d_device_create_texture = d3d_device->CreateTexture2D(&d3d_texture2d_desc, &d3d_subresource_data, &m_ltc_matrix_lut);
-		assert(SUCCEEDED(res_d3d_device_create_texture));
-	}
-
-	m_ltc_matrix_lut_srv = NULL;
-	{
-		D3D11_SHADER_RESOURCE_VIEW_DESC d3d_shader_resource_view_desc;
-		d3d_shader_resource_view_desc.Format = DXGI_FORMAT_R8G8B8A8_SNORM;
-		d3d_shader_resource_view_desc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2DARRAY;
-		d3d_shader_resource_view_desc.Texture2DArray.MostDetailedMip = 0U;
-		d3d_shader_resource_view_desc.Texture2DArray.MipLevels = 1U;
-		d3d_shader_resource_view_desc.Texture2DArray.FirstArraySlice = 0U;
-		d3d_shader_resource_view_desc.Texture2DArray.ArraySize = 1U;
-
-		HRESULT res_d3d_device_create_shader_resource_view = d3d_device->CreateShaderResourceView(m_ltc_matrix_lut, &d3d_shader_resource_view_desc, &m_ltc_matrix_lut_srv);
-		assert(SUCCEEDED(res_d3d_device_create_shader_resource_view));
+		m_ltc_matrix_lut = render_backend->CreateTexture(texture_desc, &subresource_data);
+		assert(NULL != m_ltc_matrix_lut);
 	}
 
 	m_ltc_norm_lut = NULL;
 	{
 		static_assert((2U * 64U * 64U) == (sizeof(g_ltc_ggx_norm_lut_data) / sizeof(g_ltc_ggx_norm_lut_data[0])), "");
 
-		D3D11_TEXTURE2D_DESC d3d_texture2d_desc;
-		d3d_texture2d_desc.Width = 64U;
-		d3d_texture2d_desc.Height = 64U;
-		d3d_texture2d_desc.MipLevels = 1U;
-		d3d_texture2d_desc.ArraySize = 1U;
-		d3d_texture2d_desc.Format = DXGI_FORMAT_R8G8_UNORM;
-		d3d_texture2d_desc.SampleDesc.Count = 1U;
-		d3d_texture2d_desc.SampleDesc.Quality = 0U;
-		d3d_texture2d_desc.Usage = D3D11_USAGE_DEFAULT;
-		d3d_texture2d_desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
-		d3d_texture2d_desc.CPUAccessFlags = 0U;
-		d3d_texture2d_desc.MiscFlags = 0U;
-
-		int8_t ltc_ggx_unorm_lut_data[2U * 64U * 64U];
-		for (int i = 0; i < (2U * 64U * 64U); ++i)
+		render_backend_texture_desc_t texture_desc;
+		texture_desc.width = 64U;
+		texture_desc.height = 64U;
+		texture_desc.depth = 1U;
+		texture_desc.mip_level_count = 1U;
+		texture_desc.format = RENDER_BACKEND_FORMAT_R8G8_UNORM;
+		texture_desc.usage = RENDER_BACKEND_TEXTURE_USAGE_SAMPLED;
+		texture_desc.view_dimension = RENDER_BACKEND_TEXTURE_VIEW_DIMENSION_2D_ARRAY;
+
+		uint8_t *ltc_ggx_unorm_lut_data = m_frame_arena.Allocate<uint8_t>(2U * 64U * 64U);
+		for (uint32_t i = 0U; i < (2U * 64U * 64U); ++i)
 		{
 			ltc_ggx_unorm_lut_data[i] = float_to_unorm(g_ltc_ggx_norm_lut_data[i]);
 		}
 
-		D3D11_SUBRESOURCE_DATA d3d_subresource_data;
-		d3d_subresource_data.pSysMem = ltc_ggx_unorm_lut_data;
-		d3d_subresource_data.SysMemPitch = sizeof(int8_t) * 2U * 64;
-		d3d_subresource_data.SysMemSlicePitch = sizeof(int8_t) * 2U * 64 * 64;
+		render_backend_subresource_data_t subresource_data;
+		subresource_data.data = ltc_ggx_unorm_lut_data;
+		subresource_data.row_pitch = sizeof(uint8_t) * 2U * 64;
+		subresource_data.slice_pitch = sizeof(uint8_t) * 2U * 64 * 64;
 
-		HRESULT res_d3d_device_create_texture = d3d_device->CreateTexture2D(&d3d_texture2d_desc, &d3d_subresource_data, &m_ltc_norm_lut);
-		assert(SUCCEEDED(res_d3d_device_create_texture));
+		m_ltc_norm_lut = render_backend->CreateTexture(texture_desc, &subresource_data);
+		assert(NULL != m_ltc_norm_lut);
 	}
 
-	m_ltc_norm_lut_srv = NULL;
+	m_light_texture_sampler = NULL;
 	{
-		D3D11_SHADER_RESOURCE_VIEW_DESC d3d_shader_resource_view_desc;
-		d3d_shader_resource_view_desc.Format = DXGI_FORMAT_R8G8_UNORM;
-		d3d_shader_resource_view_desc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2DARRAY;
-		d3d_shader_resource_view_desc.Texture2DArray.MostDetailedMip = 0U;
-		d3d_shader_resource_view_desc.Texture2DArray.MipLevels = 1U;
-		d3d_shader_resource_view_desc.Texture2DArray.FirstArraySlice = 0U;
-		d3d_shader_resource_view_desc.Texture2DArray.ArraySize = 1U;
-
-		HRESULT res_d3d_device_create_shader_resource_view = d3d_device->CreateShaderResourceView(m_ltc_norm_lut, &d3d_shader_resource_view_desc, &m_ltc_norm_lut_srv);
-		assert(SUCCEEDED(res_d3d_device_create_shader_resource_view));
+		m_light_texture_sampler = render_backend->CreateSampler(RENDER_BACKEND_FILTER_MIN_MAG_MIP_LINEAR);
+		assert(NULL != m_light_texture_sampler);
 	}
 
-	m_attachment_backup_odd = NULL;
+	m_light_texture = NULL;
 	{
-		D3D11_TEXTURE2D_DESC d3d_texture2d_desc;
-		d3d_texture2d_desc.Width = g_resolution_width;
-		d3d_texture2d_desc.Height = g_resolution_height;
-		d3d_texture2d_desc.MipLevels = 1U;
-		d3d_texture2d_desc.ArraySize = 1U;
-		d3d_texture2d_desc.Format = DXGI_FORMAT_R16G16B16A16_FLOAT;
-		d3d_texture2d_desc.SampleDesc.Count = 1U;
-		d3d_texture2d_desc.SampleDesc.Quality = 0U;
-		d3d_texture2d_desc.Usage = D3D11_USAGE_DEFAULT;
-		d3d_texture2d_desc.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET;
-		d3d_texture2d_desc.CPUAccessFlags = 0U;
-		d3d_texture2d_desc.MiscFlags = 0U;
+		// The prefiltering is the offline step, which is performed at the initialization for the demo.
+		static uint32_t const light_image_width = 240U;
+		static uint32_t const light_image_height = 240U;
 
-		HRESULT res_d3d_device_create_buffer = d3d_device->CreateTexture2D(&d3d_texture2d_desc, NULL, &m_attachment_backup_odd);
-		assert(SUCCEEDED(res_d3d_device_create_buffer));
-	}
+		std::vector<float> light_image(static_cast<size_t>(light_image_width) * light_image_height * 4U);
+		generate_video_wall_light_image(light_image_width, light_image_height, &light_image[0]);
 
-	m_attachment_backup_odd_rtv = NULL;
-	{
-		D3D11_RENDER_TARGET_VIEW_DESC d3d_render_target_view_desc;
-		d3d_render_target_view_desc.Format = DXGI_FORMAT_R16G16B16A16_FLOAT;
-		d3d_render_target_view_desc.ViewDimension = D3D11_RTV_DIMENSION_TEXTURE2D;
-		d3d_render_target_view_desc.Texture2D.MipSlice = 0U;
-
-		HRESULT res_d3d_device_create_render_target_view = d3d_device->CreateRenderTargetView(m_attachment_backup_odd, &d3d_render_target_view_desc, &m_attachment_backup_odd_rtv);
-		assert(SUCCEEDED(res_d3d_device_create_render_target_view));
-	}
+		std::vector<uint8_t> prefiltered_texture;
+		{
+			ThreadPool thread_pool;
+			thread_pool.Init(0U);
+			PrefilterAreaLightTexture(&thread_pool, &light_image[0], light_image_width, light_image_height, prefiltered_texture);
+			thread_pool.Destroy();
+		}
 
-	m_attachment_backup_odd_srv = NULL;
-	{
-		D3D11_SHADER_RESOURCE_VIEW_DESC d3d_shader_resource_view_desc;
-		d3d_shader_resource_view_desc.Format = DXGI_FORMAT_R16G16B16A16_FLOAT;
-		d3d_shader_resource_view_desc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
-		d3d_shader_resource_view_desc.Texture2D.MostDetailedMip = 0U;
-		d3d_shader_resource_view_desc.Texture2D.MipLevels = 1U;
+		area_light_texture_header_t const *header = reinterpret_cast<area_light_texture_header_t const *>(&prefiltered_texture[0]);
+		assert(AREA_LIGHT_TEXTURE_MAGIC == header->magic && AREA_LIGHT_TEXTURE_VERSION == header->version);
+
+		m_light_texture_uv_scale_bias[0] = header->uv_scale_bias[0];
+		m_light_texture_uv_scale_bias[1] = header->uv_scale_bias[1];
+		m_light_texture_uv_scale_bias[2] = header->uv_scale_bias[2];
+		m_light_texture_uv_scale_bias[3] = header->uv_scale_bias[3];
+
+		render_backend_texture_desc_t texture_desc;
+		texture_desc.width = header->levels[0].width;
+		texture_desc.height = header->levels[0].height;
+		texture_desc.depth = 1U;
+		texture_desc.mip_level_count = header->level_count;
+		texture_desc.format = RENDER_BACKEND_FORMAT_R16G16B16A16_FLOAT;
+		texture_desc.usage = RENDER_BACKEND_TEXTURE_USAGE_SAMPLED;
+		texture_desc.view_dimension = RENDER_BACKEND_TEXTURE_VIEW_DIMENSION_2D;
+
+		render_backend_subresource_data_t subresource_data[AREA_LIGHT_TEXTURE_MAX_LEVEL_COUNT];
+		for (uint32_t level_index = 0U; level_index < header->level_count; ++level_index)
+		{
+			subresource_data[level_index].data = &prefiltered_texture[static_cast<size_t>(header->levels[level_index].offset)];
+			subresource_data[level_index].row_pitch = header->levels[level_index].row_pitch;
+			subresource_data[level_index].slice_pitch = static_cast<uint32_t>(header->levels[level_index].size);
+		}
 
-		HRESULT res_d3d_device_create_shader_resource_view = d3d_device->CreateShaderResourceView(m_attachment_backup_odd, &d3d_shader_resource_view_desc, &m_attachment_backup_odd_srv);
-		assert(SUCCEEDED(res_d3d_device_create_shader_resource_view));
+		m_light_texture = render_backend->CreateTexture(texture_desc, subresource_data);
+		assert(NULL != m_light_texture);
 	}
 
-	m_attachment_depth = NULL;
-	{
-		D3D11_TEXTURE2D_DESC d3d_texture2d_desc;
-		d3d_texture2d_desc.Width = g_resolution_width;
-		d3d_texture2d_desc.Height = g_resolution_width;
-		d3d_texture2d_desc.MipLevels = 1U;
-		d3d_texture2d_desc.ArraySize = 1U;
-		d3d_texture2d_desc.Format = DXGI_FORMAT_R32_TYPELESS;
-		d3d_texture2d_desc.SampleDesc.Count = 1U;
-		d3d_texture2d_desc.SampleDesc.Quality = 0U;
-		d3d_texture2d_desc.Usage = D3D11_USAGE_DEFAULT;
-		d3d_texture2d_desc.BindFlags = D3D11_BIND_DEPTH_STENCIL;
-		d3d_texture2d_desc.CPUAccessFlags = 0U;
-		d3d_texture2d_desc.MiscFlags = 0U;
+	m_frame_graph.Init(render_backend);
+	m_frame_graph_hdr_color = 0U;
+	m_frame_graph_gbuffer[0] = 0U;
+	m_frame_graph_gbuffer[1] = 0U;
+	m_frame_graph_gbuffer[2] = 0U;
+	m_frame_graph_gbuffer[3] = 0U;
+	m_frame_graph_checkerboard_color = 0U;
+	m_frame_graph_history = 0U;
+	m_frame_graph_exposure_histogram = 0U;
+	m_frame_graph_exposure = 0U;
+	m_frame_graph_previous_exposure = 0U;
 
-		HRESULT res_d3d_device_create_buffer = d3d_device->CreateTexture2D(&d3d_texture2d_desc, NULL, &m_attachment_depth);
-		assert(SUCCEEDED(res_d3d_device_create_buffer));
+	// light
+	// The light and the material are constant, which are uploaded only once.
+	{
+		memset(&m_uniform_buffer_data_per_light_set_binding, 0, sizeof(uniform_buffer_per_light_set_binding_t));
+		m_uniform_buffer_data_per_light_set_binding.rect_light_vetices[0] = DirectX::XMFLOAT4(-4.0, 2.0, 32.0, 1.0);
+		m_uniform_buffer_data_per_light_set_binding.rect_light_vetices[1] = DirectX::XMFLOAT4(4.0, 2.0, 32.0, 1.0);
+		m_uniform_buffer_data_per_light_set_binding.rect_light_vetices[2] = DirectX::XMFLOAT4(4.0, 10.0, 32.0, 1.0);
+		m_uniform_buffer_data_per_light_set_binding.rect_light_vetices[3] = DirectX::XMFLOAT4(-4.0, 10.0, 32.0, 1.0);
+		m_uniform_buffer_data_per_light_set_binding.twoSided = -1.0;
+		m_uniform_buffer_data_per_light_set_binding.intensity = 4.0;
+		m_uniform_buffer_data_per_light_set_binding.light_texture_uv_scale_bias = DirectX::XMFLOAT4(m_light_texture_uv_scale_bias);
+		m_uniform_buffer_per_light_set_binding_dirty = true;
 	}
 
-	m_attachment_depth_dsv = NULL;
+	// mesh
 	{
-		D3D11_DEPTH_STENCIL_VIEW_DESC d3d_depth_stencil_view_desc;
-		d3d_depth_stencil_view_desc.Format = DXGI_FORMAT_D32_FLOAT;
-		d3d_depth_stencil_view_desc.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2D;
-		d3d_depth_stencil_view_desc.Flags = 0U;
-		d3d_depth_stencil_view_desc.Texture2D.MipSlice = 0U;
-
-		HRESULT res_d3d_device_create_shader_resource_view = d3d_device->CreateDepthStencilView(m_attachment_depth, &d3d_depth_stencil_view_desc, &m_attachment_depth_dsv);
-		assert(SUCCEEDED(res_d3d_device_create_shader_resource_view));
+		memset(&m_uniform_buffer_data_per_material_binding, 0, sizeof(uniform_buffer_per_material_binding_t));
+		DirectX::XMFLOAT4X4 model_transform;
+		DirectX::XMStoreFloat4x4(&model_transform, DirectX::XMMatrixIdentity());
+		m_uniform_buffer_data_per_material_binding.model_transform = model_transform;
+		m_uniform_buffer_data_per_material_binding.dcolor = DirectX::XMFLOAT3(1.0, 1.0, 1.0);
+		m_uniform_buffer_data_per_material_binding.scolor = DirectX::XMFLOAT3(0.23, 0.23, 0.23);
+		m_uniform_buffer_data_per_material_binding.roughness = 0.25;
+		m_uniform_buffer_per_material_binding_dirty = true;
 	}
 
-	g_camera_controller.m_eye_position = DirectX::XMFLOAT3(0.00000000, 6.00000000, -0.500000000);
-	g_camera_controller.m_eye_direction = DirectX::XMFLOAT3(0.00000000, 0.174311504, 1.99238944);
-	g_camera_controller.m_up_direction = DirectX::XMFLOAT3(0.0, 1.0, 0.0);
+	g_camera_controller.Init(DirectX::XMFLOAT3(0.00000000, 6.00000000, -0.500000000), DirectX::XMFLOAT3(0.00000000, 0.174311504, 1.99238944), DirectX::XMFLOAT3(0.0, 1.0, 0.0));
 }
 
-void Demo::Tick(ID3D11Device* d3d_device, ID3D11DeviceContext* d3d_device_context, IDXGISwapChain* dxgi_swap_chain)
+void Demo::Tick(RenderBackend *render_backend)
 {
+	m_frame_arena.BeginFrame();
+
+	// the render resolution of the frame
+	// The transient textures of the frame graph are of the render resolution, such that they are recreated only when the level of the dynamic resolution changes.
+	m_render_width = m_output_width;
+	m_render_height = m_output_height;
+	if (m_settings.dynamic_resolution)
+	{
+		m_dynamic_resolution.Update(render_backend->GetGPUFrameTime());
+		m_dynamic_resolution.GetRenderSize(m_output_width, m_output_height, &m_render_width, &m_render_height);
+	}
+	if (m_live_resize_frame_count < g_demo_live_resize_settle_frame_count)
+	{
+		m_render_width = demo_live_resize_bucket(m_render_width);
+		m_render_height = demo_live_resize_bucket(m_render_height);
+		++m_live_resize_frame_count;
+	}
+	if (m_settings.checkerboard_shading)
+	{
+		// the pixels are shaded in the pairs of the row
+		m_render_width = std::max(m_render_width & (~1U), 2U);
+
+		// the history of the other size is NOT reprojected
+		if (m_render_width != m_history_width || m_render_height != m_history_height)
+		{
+			this->CreateHistoryTextures(render_backend);
+			m_history_valid = false;
+		}
+	}
+
 	// Upload
-	plane_uniform_buffer_per_frame_binding_t plane_uniform_buffer_data_per_frame_binding;
-	rect_light_uniform_buffer_per_frame_binding_t rect_light_uniform_buffer_data_per_frame_binding;
 	{
 		// camera
+		// The camera is changed by the input, such that the dirty state is determined by the comparison.
+		uniform_buffer_per_view_binding_t &uniform_buffer_data_per_view_binding = *m_frame_arena.Allocate<uniform_buffer_per_view_binding_t>(1U);
+		memset(&uniform_buffer_data_per_view_binding, 0, sizeof(uniform_buffer_per_view_binding_t));
 		{
 			DirectX::XMFLOAT3 eye_position = g_camera_controller.m_eye_position;
 			DirectX::XMFLOAT3 eye_direction = g_camera_controller.m_eye_direction;
@@ -492,132 +511,575 @@ void Demo::Tick(ID3D11Device* d3d_device, ID3D11DeviceContext* d3d_device_contex
 			DirectX::XMFLOAT4X4 view_transform;
 			DirectX::XMStoreFloat4x4(&view_transform, tmp_view_transform);
 
+			// the aspect of the backbuffer (the render resolution is scaled uniformly)
 			float fov_angle_y = 2.0 * atan((1.0 / 2.0));
-			DirectX::XMMATRIX tmp_projection_transform = DirectX::XMMatrixPerspectiveFovRH(fov_angle_y, 1.0, 7.0, 7777.0);
+			float aspect_ratio = static_cast<float>(m_output_width) / static_cast<float>(m_output_height);
+			DirectX::XMMATRIX tmp_projection_transform = DirectX::XMMatrixPerspectiveFovRH(fov_angle_y, aspect_ratio, 7.0, 7777.0);
 			DirectX::XMFLOAT4X4 projection_transform;
 			DirectX::XMStoreFloat4x4(&projection_transform, tmp_projection_transform);
 
-			plane_uniform_buffer_data_per_frame_binding.view_transform = view_transform;
-			plane_uniform_buffer_data_per_frame_binding.projection_transform = projection_transform;
-			plane_uniform_buffer_data_per_frame_binding.eye_position = eye_position;
+			uniform_buffer_data_per_view_binding.view_transform = view_transform;
+			uniform_buffer_data_per_view_binding.projection_transform = projection_transform;
+			uniform_buffer_data_per_view_binding.eye_position = eye_position;
+		}
 
-			rect_light_uniform_buffer_data_per_frame_binding.view_transform = view_transform;
-			rect_light_uniform_buffer_data_per_frame_binding.projection_transform = projection_transform;
+		if (0 != memcmp(&m_uniform_buffer_data_per_view_binding, &uniform_buffer_data_per_view_binding, sizeof(uniform_buffer_per_view_binding_t)))
+		{
+			m_uniform_buffer_data_per_view_binding = uniform_buffer_data_per_view_binding;
+			m_uniform_buffer_per_view_binding_dirty = true;
 		}
 
-		// light
+		// the temporal state
+		// The history of the frame "N" is reprojected by the camera of the frame "N - 1", the block stays constant if the checkerboard is NOT used.
+		uniform_buffer_per_frame_binding_t &uniform_buffer_data_per_frame_binding = *m_frame_arena.Allocate<uniform_buffer_per_frame_binding_t>(1U);
+		memset(&uniform_buffer_data_per_frame_binding, 0, sizeof(uniform_buffer_per_frame_binding_t));
 		{
-			plane_uniform_buffer_data_per_frame_binding.rect_light_vetices[0] = DirectX::XMFLOAT4(-4.0, 2.0, 32.0, 1.0);
-			plane_uniform_buffer_data_per_frame_binding.rect_light_vetices[1] = DirectX::XMFLOAT4(4.0, 2.0, 32.0, 1.0);
-			plane_uniform_buffer_data_per_frame_binding.rect_light_vetices[2] = DirectX::XMFLOAT4(4.0, 10.0, 32.0, 1.0);
-			plane_uniform_buffer_data_per_frame_binding.rect_light_vetices[3] = DirectX::XMFLOAT4(-4.0, 10.0, 32.0, 1.0);
-			plane_uniform_buffer_data_per_frame_binding.twoSided = -1.0;
-			plane_uniform_buffer_data_per_frame_binding.intensity = 4.0;
-
-			rect_light_uniform_buffer_data_per_frame_binding.rect_light_vetices[0] = DirectX::XMFLOAT4(-4.0, 2.0, 32.0, 1.0);
-			rect_light_uniform_buffer_data_per_frame_binding.rect_light_vetices[1] = DirectX::XMFLOAT4(4.0, 2.0, 32.0, 1.0);
-			rect_light_uniform_buffer_data_per_frame_binding.rect_light_vetices[2] = DirectX::XMFLOAT4(-4.0, 10.0, 32.0, 1.0);
-			rect_light_uniform_buffer_data_per_frame_binding.rect_light_vetices[3] = DirectX::XMFLOAT4(4.0, 10.0, 32.0, 1.0);
-			rect_light_uniform_buffer_data_per_frame_binding.intensity = 4.0;
+			uniform_buffer_data_per_frame_binding.previous_view_projection_transform = m_previous_view_projection_transform;
+			uniform_buffer_data_per_frame_binding.checkerboard_parity = m_settings.checkerboard_shading ? (m_frame_index & 1U) : 0U;
+			uniform_buffer_data_per_frame_binding.checkerboard_width_scale = m_settings.checkerboard_shading ? 2U : 1U;
+			uniform_buffer_data_per_frame_binding.history_valid = m_history_valid ? 1U : 0U;
+
+			if (m_settings.checkerboard_shading)
+			{
+				DirectX::XMMATRIX tmp_view_projection_transform = DirectX::XMMatrixMultiply(DirectX::XMLoadFloat4x4(&m_uniform_buffer_data_per_view_binding.view_transform), DirectX::XMLoadFloat4x4(&m_uniform_buffer_data_per_view_binding.projection_transform));
+				DirectX::XMStoreFloat4x4(&m_previous_view_projection_transform, tmp_view_projection_transform);
+			}
 		}
 
-		// mesh
+		if (0 != memcmp(&m_uniform_buffer_data_per_frame_binding, &uniform_buffer_data_per_frame_binding, sizeof(uniform_buffer_per_frame_binding_t)))
 		{
-			DirectX::XMFLOAT4X4 model_transform;
-			DirectX::XMStoreFloat4x4(&model_transform, DirectX::XMMatrixIdentity());
-			plane_uniform_buffer_data_per_frame_binding.model_transform = model_transform;
-			plane_uniform_buffer_data_per_frame_binding.dcolor = DirectX::XMFLOAT3(1.0, 1.0, 1.0);
-			plane_uniform_buffer_data_per_frame_binding.scolor = DirectX::XMFLOAT3(0.23, 0.23, 0.23);
-			plane_uniform_buffer_data_per_frame_binding.roughness = 0.25;
+			m_uniform_buffer_data_per_frame_binding = uniform_buffer_data_per_frame_binding;
+			m_uniform_buffer_per_frame_binding_dirty = true;
 		}
 	}
-	d3d_device_context->UpdateSubresource(m_plane_uniform_buffer_per_frame_binding, 0U, NULL, &plane_uniform_buffer_data_per_frame_binding, sizeof(plane_uniform_buffer_per_frame_binding_t), sizeof(plane_uniform_buffer_per_frame_binding_t));
-	d3d_device_context->UpdateSubresource(m_rect_light_uniform_buffer_per_frame_binding, 0U, NULL, &rect_light_uniform_buffer_data_per_frame_binding, sizeof(rect_light_uniform_buffer_per_frame_binding_t), sizeof(rect_light_uniform_buffer_per_frame_binding_t));
 
-	// Light Pass
+	if (m_uniform_buffer_per_view_binding_dirty)
 	{
-		d3d_device_context->OMSetRenderTargets(1U, &m_attachment_backup_odd_rtv, m_attachment_depth_dsv);
+		render_backend->UpdateBuffer(m_uniform_buffer_per_view_binding, &m_uniform_buffer_data_per_view_binding, sizeof(uniform_buffer_per_view_binding_t));
+		m_uniform_buffer_per_view_binding_dirty = false;
+	}
 
-		FLOAT color[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
-		d3d_device_context->ClearRenderTargetView(m_attachment_backup_odd_rtv, color);
+	if (m_uniform_buffer_per_frame_binding_dirty)
+	{
+		render_backend->UpdateBuffer(m_uniform_buffer_per_frame_binding, &m_uniform_buffer_data_per_frame_binding, sizeof(uniform_buffer_per_frame_binding_t));
+		m_uniform_buffer_per_frame_binding_dirty = false;
+	}
+
+	if (m_uniform_buffer_per_light_set_binding_dirty)
+	{
+		render_backend->UpdateBuffer(m_uniform_buffer_per_light_set_binding, &m_uniform_buffer_data_per_light_set_binding, sizeof(uniform_buffer_per_light_set_binding_t));
+		m_uniform_buffer_per_light_set_binding_dirty = false;
+	}
 
-		FLOAT depth = 1.0f;
-		d3d_device_context->ClearDepthStencilView(m_attachment_depth_dsv, D3D11_CLEAR_DEPTH, depth, 0U);
+	if (m_uniform_buffer_per_material_binding_dirty)
+	{
+		for (uint32_t layer_index = 0U; layer_index < m_settings.overdraw_layer_count; ++layer_index)
+		{
+			uniform_buffer_per_material_binding_t &uniform_buffer_data_per_material_binding = *m_frame_arena.Allocate<uniform_buffer_per_material_binding_t>(1U);
+			uniform_buffer_data_per_material_binding = m_uniform_buffer_data_per_material_binding;
 
+			// the layer "N" is above the layer "N - 1"
+			DirectX::XMMATRIX tmp_model_transform = DirectX::XMMatrixMultiply(DirectX::XMLoadFloat4x4(&m_uniform_buffer_data_per_material_binding.model_transform), DirectX::XMMatrixTranslation(0.0f, g_demo_overdraw_layer_spacing * static_cast<float>(layer_index), 0.0f));
+			DirectX::XMStoreFloat4x4(&uniform_buffer_data_per_material_binding.model_transform, tmp_model_transform);
 
-		// glEnable(GL_DEPTH_TEST);
-		// glDepthFunc(GL_LESS);
-		// glColorMaski(0, GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+			render_backend->UpdateBuffer(m_uniform_buffer_per_material_bindings[layer_index], &uniform_buffer_data_per_material_binding, sizeof(uniform_buffer_per_material_binding_t));
+		}
+		m_uniform_buffer_per_material_binding_dirty = false;
+	}
 
-		D3D11_VIEWPORT viewport = { 0.0f, 0.0f, g_resolution_width, g_resolution_height, 0.0f, 1.0f };
-		d3d_device_context->RSSetViewports(1U, &viewport);
+	// The passes are sequenced by the frame graph, which also resolves the hazard between the attachment and the sampling.
+	m_frame_graph.Reset();
+	{
+		frame_graph_resource_t const backbuffer = m_frame_graph.ImportTexture(NULL, RENDER_BACKEND_TEXTURE_STATE_COLOR_ATTACHMENT);
 
-		// Draw Plane
+		// the checkerboard: the output of the current frame is kept as the history of the next frame
+		frame_graph_resource_t hdr_color;
+		frame_graph_resource_t history;
+		if (m_settings.checkerboard_shading)
 		{
-			d3d_device_context->RSSetState(m_plane_rs);
+			hdr_color = m_frame_graph.ImportTexture(m_history_textures[m_frame_index & 1U], RENDER_BACKEND_TEXTURE_STATE_SAMPLED);
+			history = m_frame_graph.ImportTexture(m_history_textures[(m_frame_index + 1U) & 1U], RENDER_BACKEND_TEXTURE_STATE_SAMPLED);
+		}
+		else
+		{
+			render_backend_texture_desc_t texture_desc;
+			texture_desc.width = m_render_width;
+			texture_desc.height = m_render_height;
+			texture_desc.depth = 1U;
+			texture_desc.mip_level_count = 1U;
+			texture_desc.format = RENDER_BACKEND_FORMAT_R16G16B16A16_FLOAT;
+			texture_desc.usage = RENDER_BACKEND_TEXTURE_USAGE_SAMPLED | RENDER_BACKEND_TEXTURE_USAGE_COLOR_ATTACHMENT;
+			texture_desc.view_dimension = RENDER_BACKEND_TEXTURE_VIEW_DIMENSION_2D;
+			hdr_color = m_frame_graph.CreateTexture(texture_desc);
+			history = 0U;
+		}
 
-			d3d_device_context->VSSetShader(m_plane_vs, NULL, 0U);
-			d3d_device_context->PSSetShader(m_plane_fs, NULL, 0U);
+		frame_graph_resource_t depth;
+		{
+			render_backend_texture_desc_t texture_desc;
+			texture_desc.width = m_render_width;
+			texture_desc.height = m_render_height;
+			texture_desc.depth = 1U;
+			texture_desc.mip_level_count = 1U;
+			texture_desc.format = RENDER_BACKEND_FORMAT_D32_FLOAT;
+			texture_desc.usage = RENDER_BACKEND_TEXTURE_USAGE_DEPTH_ATTACHMENT;
+			texture_desc.view_dimension = RENDER_BACKEND_TEXTURE_VIEW_DIMENSION_2D;
+			depth = m_frame_graph.CreateTexture(texture_desc);
+		}
 
-			d3d_device_context->VSSetConstantBuffers(0U, 1U, &m_plane_uniform_buffer_per_frame_binding);
-			d3d_device_context->PSSetConstantBuffers(0U, 1U, &m_plane_uniform_buffer_per_frame_binding);
+		float const clear_color_value[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
 
-			d3d_device_context->PSSetSamplers(0U, 1U, &m_ltc_lut_sampler);
-			d3d_device_context->PSSetShaderResources(0U, 1U, &m_ltc_matrix_lut_srv);
-			d3d_device_context->PSSetShaderResources(1U, 1U, &m_ltc_norm_lut_srv);
+		if (DEMO_SHADING_MODE_DEFERRED != m_settings.shading_mode)
+		{
+			// Light Pass
+			frame_graph_pass_t const pass = m_frame_graph.AddPass("Light Pass", &Demo::ExecuteLightPass, this);
+			m_frame_graph.SetColorAttachment(pass, 0U, hdr_color, true, clear_color_value);
+			m_frame_graph.SetDepthAttachment(pass, depth, true, 1.0f);
+		}
+		else
+		{
+			frame_graph_resource_t gbuffer[4];
+			for (uint32_t gbuffer_index = 0U; gbuffer_index < 4U; ++gbuffer_index)
+			{
+				render_backend_texture_desc_t texture_desc;
+				texture_desc.width = m_render_width;
+				texture_desc.height = m_render_height;
+				texture_desc.depth = 1U;
+				texture_desc.mip_level_count = 1U;
+				// the position needs the full precision (the plane is large)
+				texture_desc.format = (0U == gbuffer_index) ? RENDER_BACKEND_FORMAT_R32G32B32A32_FLOAT : RENDER_BACKEND_FORMAT_R16G16B16A16_FLOAT;
+				texture_desc.usage = RENDER_BACKEND_TEXTURE_USAGE_SAMPLED | RENDER_BACKEND_TEXTURE_USAGE_COLOR_ATTACHMENT;
+				texture_desc.view_dimension = RENDER_BACKEND_TEXTURE_VIEW_DIMENSION_2D;
+				gbuffer[gbuffer_index] = m_frame_graph.CreateTexture(texture_desc);
+			}
+
+			// G-Buffer Pass
+			// the "w" of the position is the coverage, which is 0 where cleared
+			{
+				frame_graph_pass_t const pass = m_frame_graph.AddPass("G-Buffer Pass", &Demo::ExecuteGBufferPass, this);
+				for (uint32_t gbuffer_index = 0U; gbuffer_index < 4U; ++gbuffer_index)
+				{
+					m_frame_graph.SetColorAttachment(pass, gbuffer_index, gbuffer[gbuffer_index], true, clear_color_value);
+				}
+				m_frame_graph.SetDepthAttachment(pass, depth, true, 1.0f);
+			}
+
+			// Deferred Lighting Pass
+			// the depth is loaded such that the rect light is occluded by the plane
+			if (!m_settings.checkerboard_shading)
+			{
+				frame_graph_pass_t const pass = m_frame_graph.AddPass("Deferred Lighting Pass", &Demo::ExecuteDeferredLightingPass, this);
+				for (uint32_t gbuffer_index = 0U; gbuffer_index < 4U; ++gbuffer_index)
+				{
+					m_frame_graph.AddRead(pass, gbuffer[gbuffer_index]);
+				}
+				m_frame_graph.SetColorAttachment(pass, 0U, hdr_color, true, clear_color_value);
+				m_frame_graph.SetDepthAttachment(pass, depth, false, 1.0f);
+			}
+			else
+			{
+				// the shaded half of the pixels, packed into the half width
+				frame_graph_resource_t checkerboard_color;
+				{
+					render_backend_texture_desc_t texture_desc;
+					texture_desc.width = m_render_width / 2U;
+					texture_desc.height = m_render_height;
+					texture_desc.depth = 1U;
+					texture_desc.mip_level_count = 1U;
+					texture_desc.format = RENDER_BACKEND_FORMAT_R16G16B16A16_FLOAT;
+					texture_desc.usage = RENDER_BACKEND_TEXTURE_USAGE_SAMPLED | RENDER_BACKEND_TEXTURE_USAGE_COLOR_ATTACHMENT;
+					texture_desc.view_dimension = RENDER_BACKEND_TEXTURE_VIEW_DIMENSION_2D;
+					checkerboard_color = m_frame_graph.CreateTexture(texture_desc);
+				}
+
+				{
+					frame_graph_pass_t const pass = m_frame_graph.AddPass("Deferred Lighting Pass", &Demo::ExecuteDeferredLightingPass, this);
+					for (uint32_t gbuffer_index = 0U; gbuffer_index < 4U; ++gbuffer_index)
+					{
+						m_frame_graph.AddRead(pass, gbuffer[gbuffer_index]);
+					}
+					m_frame_graph.SetColorAttachment(pass, 0U, checkerboard_color, true, clear_color_value);
+				}
+
+				// Checkerboard Resolve Pass
+				// the depth is loaded such that the rect light is occluded by the plane
+				{
+					frame_graph_pass_t const pass = m_frame_graph.AddPass("Checkerboard Resolve Pass", &Demo::ExecuteCheckerboardResolvePass, this);
+					m_frame_graph.AddRead(pass, checkerboard_color);
+					m_frame_graph.AddRead(pass, gbuffer[0]);
+					m_frame_graph.AddRead(pass, gbuffer[1]);
+					m_frame_graph.AddRead(pass, history);
+					m_frame_graph.SetColorAttachment(pass, 0U, hdr_color, true, clear_color_value);
+					m_frame_graph.SetDepthAttachment(pass, depth, false, 1.0f);
+				}
+
+				m_frame_graph_checkerboard_color = checkerboard_color;
+				m_frame_graph_history = history;
+			}
+
+			for (uint32_t gbuffer_index = 0U; gbuffer_index < 4U; ++gbuffer_index)
+			{
+				m_frame_graph_gbuffer[gbuffer_index] = gbuffer[gbuffer_index];
+			}
+		}
 
-			d3d_device_context->IASetInputLayout(m_plane_vao);
+		// the auto exposure: the exposure of the current frame is adapted from the exposure of the previous frame
+		frame_graph_resource_t exposure;
+		if (m_settings.auto_exposure)
+		{
+			exposure = m_frame_graph.ImportTexture(m_exposure_textures[m_frame_index & 1U], RENDER_BACKEND_TEXTURE_STATE_SAMPLED);
+			frame_graph_resource_t const previous_exposure = m_frame_graph.ImportTexture(m_exposure_textures[(m_frame_index + 1U) & 1U], RENDER_BACKEND_TEXTURE_STATE_SAMPLED);
+
+			frame_graph_resource_t exposure_histogram;
+			{
+				render_backend_texture_desc_t texture_desc;
+				texture_desc.width = AUTO_EXPOSURE_HISTOGRAM_BIN_COUNT;
+				texture_desc.height = AUTO_EXPOSURE_HISTOGRAM_GROUP_COUNT;
+				texture_desc.depth = 1U;
+				texture_desc.mip_level_count = 1U;
+				texture_desc.format = RENDER_BACKEND_FORMAT_R32G32B32A32_FLOAT;
+				texture_desc.usage = RENDER_BACKEND_TEXTURE_USAGE_SAMPLED | RENDER_BACKEND_TEXTURE_USAGE_COLOR_ATTACHMENT;
+				texture_desc.view_dimension = RENDER_BACKEND_TEXTURE_VIEW_DIMENSION_2D;
+				exposure_histogram = m_frame_graph.CreateTexture(texture_desc);
+			}
+
+			// Auto Exposure Histogram Pass
+			// every texel is written by the full screen triangle
+			{
+				frame_graph_pass_t const pass = m_frame_graph.AddPass("Auto Exposure Histogram Pass", &Demo::ExecuteAutoExposureHistogramPass, this);
+				m_frame_graph.AddRead(pass, hdr_color);
+				m_frame_graph.SetColorAttachment(pass, 0U, exposure_histogram, false, NULL);
+			}
+
+			// Auto Exposure Pass
+			{
+				frame_graph_pass_t const pass = m_frame_graph.AddPass("Auto Exposure Pass", &Demo::ExecuteAutoExposurePass, this);
+				m_frame_graph.AddRead(pass, exposure_histogram);
+				m_frame_graph.AddRead(pass, previous_exposure);
+				m_frame_graph.SetColorAttachment(pass, 0U, exposure, false, NULL);
+			}
+
+			m_frame_graph_exposure_histogram = exposure_histogram;
+			m_frame_graph_previous_exposure = previous_exposure;
+		}
+		else
+		{
+			exposure = m_frame_graph.ImportTexture(m_exposure_textures[0], RENDER_BACKEND_TEXTURE_STATE_SAMPLED);
+		}
 
-			ID3D11Buffer* vertex_buffers[2] = { m_plane_vb_position , m_plane_vb_varying };
-			UINT strides[2] = { sizeof(float) * 3,  sizeof(float) * 3 };
-			UINT offsets[2] = { 0U,0U };
-			d3d_device_context->IASetVertexBuffers(0U, 2U, vertex_buffers, strides, offsets);
-			d3d_device_context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
-			d3d_device_context->DrawInstanced(4U, 1U, 0U, 0U);
+		// Post Process Pass
+		{
+			frame_graph_pass_t const pass = m_frame_graph.AddPass("Post Process Pass", &Demo::ExecutePostProcessPass, this);
+			m_frame_graph.AddRead(pass, hdr_color);
+			m_frame_graph.AddRead(pass, exposure);
+			m_frame_graph.SetColorAttachment(pass, 0U, backbuffer, false, NULL);
 		}
 
-		// Draw Rect Light
+		m_frame_graph_exposure = exposure;
+
+		m_frame_graph_hdr_color = hdr_color;
+	}
+	m_frame_graph.Compile();
+	m_frame_graph.Execute();
+
+	m_history_valid = m_settings.checkerboard_shading;
+	m_exposure_valid = m_settings.auto_exposure;
+	++m_frame_index;
+
+	render_backend->Present();
+}
+
+void Demo::Resize(RenderBackend *render_backend, uint32_t width, uint32_t height)
+{
+	assert(width > 0U && height > 0U);
+
+	if (width == m_output_width && height == m_output_height)
+	{
+		return;
+	}
+
+	render_backend->ResizeBackbuffer(width, height);
+	m_output_width = width;
+	m_output_height = height;
+
+	// the render resolution of the next frames (see "Tick")
+	m_live_resize_frame_count = 0U;
+}
+
+void Demo::CreateHistoryTextures(RenderBackend *render_backend)
+{
+	for (uint32_t history_index = 0U; history_index < 2U; ++history_index)
+	{
+		if (NULL != m_history_textures[history_index])
 		{
-			d3d_device_context->RSSetState(m_rect_light_rs);
+			render_backend->DestroyTexture(m_history_textures[history_index]);
+		}
+
+		render_backend_texture_desc_t texture_desc;
+		texture_desc.width = m_render_width;
+		texture_desc.height = m_render_height;
+		texture_desc.depth = 1U;
+		texture_desc.mip_level_count = 1U;
+		texture_desc.format = RENDER_BACKEND_FORMAT_R16G16B16A16_FLOAT;
+		texture_desc.usage = RENDER_BACKEND_TEXTURE_USAGE_SAMPLED | RENDER_BACKEND_TEXTURE_USAGE_COLOR_ATTACHMENT;
+		texture_desc.view_dimension = RENDER_BACKEND_TEXTURE_VIEW_DIMENSION_2D;
+
+		m_history_textures[history_index] = render_backend->CreateTexture(texture_desc, NULL);
+		assert(NULL != m_history_textures[history_index]);
+	}
+	m_history_width = m_render_width;
+	m_history_height = m_render_height;
+}
+
+void Demo::ExecuteLightPass(RenderBackend *render_backend, FrameGraph const *, void *user_data)
+{
+	Demo *demo = static_cast<Demo *>(user_data);
+
+	// glEnable(GL_DEPTH_TEST);
+	// glDepthFunc(GL_LESS);
+	// glColorMaski(0, GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+
+	// Draw Plane Depth
+	// The depth pre-pass shares the attachments of the light pass, such that the "equal" test of the plane reads the depth which is just written.
+	if (demo->m_settings.depth_prepass)
+	{
+		render_backend->SetPipeline(demo->m_plane_depth_pipeline);
+
+		demo->DrawPlaneLayers(render_backend);
+	}
+
+	// Draw Plane
+	{
+		render_backend->SetPipeline(demo->m_plane_pipeline);
+
+		render_backend->SetSampler(0U, demo->m_ltc_lut_sampler);
+		render_backend->SetTexture(0U, demo->m_ltc_matrix_lut);
+		render_backend->SetTexture(1U, demo->m_ltc_norm_lut);
+		render_backend->SetSampler(1U, demo->m_light_texture_sampler);
+		render_backend->SetTexture(2U, demo->m_light_texture);
+
+		demo->DrawPlaneLayers(render_backend);
+	}
+
+	demo->DrawRectLight(render_backend);
+}
+
+void Demo::ExecuteGBufferPass(RenderBackend *render_backend, FrameGraph const *, void *user_data)
+{
+	Demo *demo = static_cast<Demo *>(user_data);
+
+	render_backend->SetPipeline(demo->m_plane_gbuffer_pipeline);
 
-			d3d_device_context->VSSetShader(m_rect_light_vs, NULL, 0U);
-			d3d_device_context->PSSetShader(m_rect_light_fs, NULL, 0U);
+	demo->DrawPlaneLayers(render_backend);
+}
 
-			d3d_device_context->VSSetConstantBuffers(0U, 1U, &m_rect_light_uniform_buffer_per_frame_binding);
-			d3d_device_context->PSSetConstantBuffers(0U, 1U, &m_rect_light_uniform_buffer_per_frame_binding);
+void Demo::ExecuteDeferredLightingPass(RenderBackend *render_backend, FrameGraph const *frame_graph, void *user_data)
+{
+	Demo *demo = static_cast<Demo *>(user_data);
 
-			d3d_device_context->IASetInputLayout(m_rect_light_vao);
-			d3d_device_context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
-			d3d_device_context->DrawInstanced(4U, 1U, 0U, 0U);
+	// Draw Lighting
+	// the LTC is evaluated once per pixel covered by the G-buffer, regardless of the overdraw layers
+	{
+		render_backend->SetPipeline(demo->m_deferred_lighting_pipeline);
+
+		render_backend->SetConstantBuffer(DEMO_UNIFORM_BUFFER_PER_VIEW_BINDING, demo->m_uniform_buffer_per_view_binding);
+		render_backend->SetConstantBuffer(DEMO_UNIFORM_BUFFER_PER_LIGHT_SET_BINDING, demo->m_uniform_buffer_per_light_set_binding);
+		render_backend->SetConstantBuffer(DEMO_UNIFORM_BUFFER_PER_FRAME_BINDING, demo->m_uniform_buffer_per_frame_binding);
+
+		render_backend->SetSampler(0U, demo->m_ltc_lut_sampler);
+		render_backend->SetTexture(0U, demo->m_ltc_matrix_lut);
+		render_backend->SetTexture(1U, demo->m_ltc_norm_lut);
+		render_backend->SetSampler(1U, demo->m_light_texture_sampler);
+		render_backend->SetTexture(2U, demo->m_light_texture);
+		for (uint32_t gbuffer_index = 0U; gbuffer_index < 4U; ++gbuffer_index)
+		{
+			render_backend->SetTexture(3U + gbuffer_index, frame_graph->GetTexture(demo->m_frame_graph_gbuffer[gbuffer_index]));
 		}
+
+		render_backend->Draw(3U);
+	}
+
+	// checkerboard: drawn by the resolve into the full resolution
+	if (!demo->m_settings.checkerboard_shading)
+	{
+		demo->DrawRectLight(render_backend);
 	}
+}
+
+void Demo::ExecuteCheckerboardResolvePass(RenderBackend *render_backend, FrameGraph const *frame_graph, void *user_data)
+{
+	Demo *demo = static_cast<Demo *>(user_data);
 
-	// Post Process Pass
+	// Draw Resolve
 	{
-		d3d_device_context->OMSetRenderTargets(1U, &m_attachment_backbuffer_rtv, NULL);
+		render_backend->SetPipeline(demo->m_checkerboard_resolve_pipeline);
 
-		d3d_device_context->RSSetState(m_post_process_rs);
+		render_backend->SetConstantBuffer(DEMO_UNIFORM_BUFFER_PER_VIEW_BINDING, demo->m_uniform_buffer_per_view_binding);
+		render_backend->SetConstantBuffer(DEMO_UNIFORM_BUFFER_PER_FRAME_BINDING, demo->m_uniform_buffer_per_frame_binding);
 
-		// glDisable(GL_DEPTH_TEST);
+		render_backend->SetSampler(0U, demo->m_light_texture_sampler);
+		render_backend->SetTexture(0U, frame_graph->GetTexture(demo->m_frame_graph_checkerboard_color));
+		render_backend->SetTexture(1U, frame_graph->GetTexture(demo->m_frame_graph_gbuffer[0]));
+		render_backend->SetTexture(2U, frame_graph->GetTexture(demo->m_frame_graph_gbuffer[1]));
+		render_backend->SetTexture(3U, frame_graph->GetTexture(demo->m_frame_graph_history));
 
-		d3d_device_context->VSSetShader(m_post_process_vs, NULL, 0U);
-		d3d_device_context->PSSetShader(m_post_process_fs, NULL, 0U);
+		render_backend->Draw(3U);
+	}
 
-		d3d_device_context->PSSetSamplers(0U, 1U, &m_ltc_lut_sampler);
-		d3d_device_context->PSSetShaderResources(0U, 1U, &m_attachment_backup_odd_srv);
+	demo->DrawRectLight(render_backend);
+}
 
-		d3d_device_context->IASetInputLayout(m_post_process_vao);
-		d3d_device_context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
-		d3d_device_context->DrawInstanced(3U, 1U, 0U, 0U);
+void Demo::DrawPlaneLayers(RenderBackend *render_backend)
+{
+	render_backend->SetConstantBuffer(DEMO_UNIFORM_BUFFER_PER_VIEW_BINDING, m_uniform_buffer_per_view_binding);
+	render_backend->SetConstantBuffer(DEMO_UNIFORM_BUFFER_PER_LIGHT_SET_BINDING, m_uniform_buffer_per_light_set_binding);
 
-		// unbind
-		ID3D11ShaderResourceView* shader_resource_views = { NULL };
-		d3d_device_context->PSSetShaderResources(0U, 1U, &shader_resource_views);
+	render_backend_buffer_t *vertex_buffers[2] = { m_plane_vb_position, m_plane_vb_varying };
+	uint32_t strides[2] = { sizeof(float) * 3, sizeof(float) * 3 };
+	render_backend->SetVertexBuffers(0U, 2U, vertex_buffers, strides);
 
+	// back to front
+	for (uint32_t layer_index = 0U; layer_index < m_settings.overdraw_layer_count; ++layer_index)
+	{
+		render_backend->SetConstantBuffer(DEMO_UNIFORM_BUFFER_PER_MATERIAL_BINDING, m_uniform_buffer_per_material_bindings[layer_index]);
+		render_backend->Draw(4U);
 	}
+}
+
+void Demo::DrawRectLight(RenderBackend *render_backend)
+{
+	render_backend->SetPipeline(m_rect_light_pipeline);
 
-	HRESULT res_dxgi_swap_chain_present = dxgi_swap_chain->Present(1U, 0U);
-	assert(SUCCEEDED(res_dxgi_swap_chain_present));
+	render_backend->SetConstantBuffer(DEMO_UNIFORM_BUFFER_PER_VIEW_BINDING, m_uniform_buffer_per_view_binding);
+	render_backend->SetConstantBuffer(DEMO_UNIFORM_BUFFER_PER_LIGHT_SET_BINDING, m_uniform_buffer_per_light_set_binding);
+
+	render_backend->SetSampler(0U, m_light_texture_sampler);
+	render_backend->SetTexture(0U, m_light_texture);
+
+	render_backend->Draw(4U);
+}
+
+void Demo::ExecuteAutoExposureHistogramPass(RenderBackend *render_backend, FrameGraph const *frame_graph, void *user_data)
+{
+	Demo *demo = static_cast<Demo *>(user_data);
+
+	render_backend->SetPipeline(demo->m_auto_exposure_histogram_pipeline);
+
+	render_backend->SetSampler(0U, demo->m_light_texture_sampler);
+	render_backend->SetTexture(0U, frame_graph->GetTexture(demo->m_frame_graph_hdr_color));
+
+	render_backend->Draw(3U);
+}
+
+void Demo::ExecuteAutoExposurePass(RenderBackend *render_backend, FrameGraph const *frame_graph, void *user_data)
+{
+	Demo *demo = static_cast<Demo *>(user_data);
+
+	render_backend->SetPipeline(demo->m_auto_exposure_pipeline);
+
+	render_backend->SetConstantBuffer(DEMO_UNIFORM_BUFFER_PER_FRAME_BINDING, demo->m_uniform_buffer_per_frame_binding);
+
+	render_backend->SetTexture(0U, frame_graph->GetTexture(demo->m_frame_graph_exposure_histogram));
+	render_backend->SetTexture(1U, frame_graph->GetTexture(demo->m_frame_graph_previous_exposure));
+
+	render_backend->Draw(3U);
+}
+
+void Demo::ExecutePostProcessPass(RenderBackend *render_backend, FrameGraph const *frame_graph, void *user_data)
+{
+	Demo *demo = static_cast<Demo *>(user_data);
+
+	render_backend->SetPipeline(demo->m_post_process_pipeline);
+
+	// glDisable(GL_DEPTH_TEST);
+
+	// the dynamic resolution: the HDR color is magnified, which is bilinear (the "MAG_LINEAR")
+	render_backend->SetSampler(0U, demo->m_ltc_lut_sampler);
+	render_backend->SetTexture(0U, frame_graph->GetTexture(demo->m_frame_graph_hdr_color));
+	render_backend->SetSampler(1U, demo->m_tonemap_lut_sampler);
+	render_backend->SetTexture(1U, demo->m_tonemap_lut);
+	render_backend->SetTexture(2U, frame_graph->GetTexture(demo->m_frame_graph_exposure));
+
+	render_backend->Draw(3U);
+}
+
+void Demo::Destroy(RenderBackend *render_backend)
+{
+	m_frame_graph.Destroy();
+	render_backend->DestroyTexture(m_light_texture);
+	render_backend->DestroySampler(m_light_texture_sampler);
+	render_backend->DestroyTexture(m_ltc_norm_lut);
+	render_backend->DestroyTexture(m_ltc_matrix_lut);
+	render_backend->DestroySampler(m_ltc_lut_sampler);
+	render_backend->DestroyTexture(m_tonemap_lut);
+	render_backend->DestroySampler(m_tonemap_lut_sampler);
+	render_backend->DestroyPipeline(m_post_process_pipeline);
+	for (uint32_t exposure_index = 0U; exposure_index < 2U; ++exposure_index)
+	{
+		render_backend->DestroyTexture(m_exposure_textures[exposure_index]);
+	}
+	render_backend->DestroyPipeline(m_auto_exposure_pipeline);
+	render_backend->DestroyPipeline(m_auto_exposure_histogram_pipeline);
+	for (uint32_t history_index = 0U; history_index < 2U; ++history_index)
+	{
+		if (NULL != m_history_textures[history_index])
+		{
+			render_backend->DestroyTexture(m_history_textures[history_index]);
+		}
+	}
+	render_backend->DestroyBuffer(m_uniform_buffer_per_frame_binding);
+	for (uint32_t layer_index = 0U; layer_index < m_settings.overdraw_layer_count; ++layer_index)
+	{
+		render_backend->DestroyBuffer(m_uniform_buffer_per_material_bindings[layer_index]);
+	}
+	render_backend->DestroyBuffer(m_uniform_buffer_per_light_set_binding);
+	render_backend->DestroyBuffer(m_uniform_buffer_per_view_binding);
+	render_backend->DestroyPipeline(m_rect_light_pipeline);
+	render_backend->DestroyPipeline(m_checkerboard_resolve_pipeline);
+	render_backend->DestroyPipeline(m_deferred_lighting_pipeline);
+	render_backend->DestroyPipeline(m_plane_gbuffer_pipeline);
+	render_backend->DestroyPipeline(m_plane_depth_pipeline);
+	render_backend->DestroyPipeline(m_plane_pipeline);
+	render_backend->DestroyBuffer(m_plane_vb_varying);
+	render_backend->DestroyBuffer(m_plane_vb_position);
+
+	m_frame_arena.Destroy();
+}
+
+demo_settings_t const &Demo::GetSettings() const
+{
+	return m_settings;
+}
+
+FrameArena const &Demo::GetFrameArena() const
+{
+	return m_frame_arena;
+}
+
+FrameGraph const &Demo::GetFrameGraph() const
+{
+	return m_frame_graph;
+}
+
+uint32_t Demo::GetRenderWidth() const
+{
+	return m_render_width;
+}
+
+uint32_t Demo::GetRenderHeight() const
+{
+	return m_render_height;
+}
+
+DynamicResolution const &Demo::GetDynamicResolution() const
+{
+	return m_dynamic_resolution;
+}
+
+static inline uint32_t demo_live_resize_bucket(uint32_t size)
+{
+	// the size below the bucket is kept
+	return (size >= g_demo_live_resize_bucket_size) ? (size - (size % g_demo_live_resize_bucket_size)) : size;
 }
 
 static uint8_t float_to_unorm(float unpacked_input)
@@ -640,4 +1102,41 @@ static int8_t float_to_snorm(float unpacked_input)
 	float float_to_int = saturate_signed_float * 127.0f + (saturate_signed_float >= 0 ? 0.5f : -0.5f);
 	float truncate_float = float_to_int >= 0 ? std::floor(float_to_int) : std::ceil(float_to_int);
 	return ((int8_t)truncate_float);
+}
+
+static void generate_video_wall_light_image(uint32_t width, uint32_t height, float *light_image)
+{
+	// 4x4 panels separated by the dark bezels, each panel shows a vertical gradient of a different hue
+	static uint32_t const panel_count = 4U;
+	static float const bezel_width = 0.04f;
+
+	for (uint32_t y = 0U; y < height; ++y)
+	{
+		for (uint32_t x = 0U; x < width; ++x)
+		{
+			float u = (static_cast<float>(x) + 0.5f) / static_cast<float>(width) * static_cast<float>(panel_count);
+			float v = (static_cast<float>(y) + 0.5f) / static_cast<float>(height) * static_cast<float>(panel_count);
+			float panel_x = std::floor(u);
+			float panel_y = std::floor(v);
+			float local_u = u - panel_x;
+			float local_v = v - panel_y;
+
+			float *texel = light_image + (static_cast<size_t>(width) * y + x) * 4U;
+			if (local_u < bezel_width || local_u > (1.0f - bezel_width) || local_v < bezel_width || local_v > (1.0f - bezel_width))
+			{
+				texel[0] = 0.02f;
+				texel[1] = 0.02f;
+				texel[2] = 0.02f;
+			}
+			else
+			{
+				float hue = (panel_y * static_cast<float>(panel_count) + panel_x) / static_cast<float>(panel_count * panel_count);
+				float brightness = 1.0f - 0.65f * local_v;
+				texel[0] = brightness * (0.5f + 0.5f * std::cos(2.0f * DirectX::XM_PI * (hue + 0.0f / 3.0f)));
+				texel[1] = brightness * (0.5f + 0.5f * std::cos(2.0f * DirectX::XM_PI * (hue + 1.0f / 3.0f)));
+				texel[2] = brightness * (0.5f + 0.5f * std::cos(2.0f * DirectX::XM_PI * (hue + 2.0f / 3.0f)));
+			}
+			texel[3] = 1.0f;
+		}
+	}
 }
\ No newline at end of file
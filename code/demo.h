@@ -1,56 +1,164 @@
 #ifndef _DEMO_H_
 #define _DEMO_H_ 1
 
-#include <sdkddkver.h>
-#ifndef WIN32_LEAN_AND_MEAN
-#define WIN32_LEAN_AND_MEAN 1
-#endif
-#ifndef NOMINMAX
-#define NOMINMAX 1
-#endif
-#include <windows.h>
-
-#include <dxgi.h>
-#include <d3d11.h>
+#include "backend/render_backend.h"
+
+#include "backend/frame_graph.h"
+
+#include "demo_uniform_buffer.h"
+
+#include "cpu/frame_arena.h"
+
+#include "cpu/dynamic_resolution.h"
+
+#define DEMO_MAX_OVERDRAW_LAYER_COUNT 16U
+
+enum DEMO_SHADING_MODE
+{
+	// the plane evaluates the LTC when it is rasterized, such that the overdraw multiplies the cost of the LTC
+	DEMO_SHADING_MODE_FORWARD = 0,
+	// the plane only writes the G-buffer, the LTC is evaluated once per pixel by the full screen lighting pass
+	DEMO_SHADING_MODE_DEFERRED = 1
+};
+
+struct demo_settings_t
+{
+	DEMO_SHADING_MODE shading_mode;
+	// the copies of the plane stacked slightly above each other and drawn back to front (every layer passes the depth test), 1 means the plane itself
+	// used to measure the forward and the deferred shading as the overdraw grows
+	uint32_t overdraw_layer_count;
+	// forward only: the layers are drawn into the depth first, and then shaded by the "equal" depth test (the LTC is evaluated at most once per pixel)
+	bool depth_prepass;
+	// deferred only: the LTC is evaluated on half of the pixels in the checkerboard pattern (alternating every frame),
+	// the other half is reconstructed by the reprojected output of the previous frame and the neighbors (see "checkerboard_resolve_fs.hlsl")
+	bool checkerboard_shading;
+	// the exposure of the post process is adapted to the histogram of the luminance of the HDR color (see "cpu/auto_exposure.h"), otherwise the exposure is 1
+	bool auto_exposure;
+	// the passes before the post process are rendered at the scale of the backbuffer which fits the frame time into the budget (see "cpu/dynamic_resolution.h"),
+	// and upscaled by the post process (NOT used with the checkerboard, of which the history is reprojected at the full resolution)
+	bool dynamic_resolution;
+	float frame_time_budget_ms;
+};
 
 class Demo
 {
-	ID3D11RenderTargetView* m_attachment_backbuffer_rtv;
-
-	ID3D11Buffer *m_plane_vb_position;
-	ID3D11Buffer *m_plane_vb_varying;
-	ID3D11InputLayout *m_plane_vao;
-	ID3D11VertexShader *m_plane_vs;
-	ID3D11PixelShader *m_plane_fs;
-	ID3D11RasterizerState *m_plane_rs;
-	ID3D11Buffer *m_plane_uniform_buffer_per_frame_binding;
-
-	ID3D11InputLayout *m_rect_light_vao;
-	ID3D11VertexShader *m_rect_light_vs;
-	ID3D11PixelShader *m_rect_light_fs;
-	ID3D11RasterizerState* m_rect_light_rs;
-	ID3D11Buffer *m_rect_light_uniform_buffer_per_frame_binding;
-
-	ID3D11InputLayout *m_post_process_vao;
-	ID3D11VertexShader *m_post_process_vs;
-	ID3D11PixelShader *m_post_process_fs;
-	ID3D11RasterizerState* m_post_process_rs;
-
-	ID3D11SamplerState *m_ltc_lut_sampler;
-	ID3D11Texture2D *m_ltc_matrix_lut;
-	ID3D11ShaderResourceView* m_ltc_matrix_lut_srv;
-	ID3D11Texture2D *m_ltc_norm_lut;
-	ID3D11ShaderResourceView* m_ltc_norm_lut_srv;
-
-	ID3D11Texture2D *m_attachment_backup_odd;
-	ID3D11RenderTargetView* m_attachment_backup_odd_rtv;
-	ID3D11ShaderResourceView *m_attachment_backup_odd_srv;
-	ID3D11Texture2D *m_attachment_depth;
-	ID3D11DepthStencilView *m_attachment_depth_dsv;
+	demo_settings_t m_settings;
+
+	// the size of the backbuffer
+	uint32_t m_output_width;
+	uint32_t m_output_height;
+	// the size of the attachments of the passes before the post process (the output size unless the dynamic resolution is used)
+	DynamicResolution m_dynamic_resolution;
+	uint32_t m_render_width;
+	uint32_t m_render_height;
+	// the frames since the last "Resize", the render resolution is rounded down to the bucket until the size settles
+	uint32_t m_live_resize_frame_count;
+
+	render_backend_buffer_t *m_plane_vb_position;
+	render_backend_buffer_t *m_plane_vb_varying;
+	render_backend_pipeline_t *m_plane_pipeline;
+	render_backend_pipeline_t *m_plane_depth_pipeline;
+	render_backend_pipeline_t *m_plane_gbuffer_pipeline;
+	render_backend_pipeline_t *m_deferred_lighting_pipeline;
+	render_backend_pipeline_t *m_checkerboard_resolve_pipeline;
+
+	render_backend_pipeline_t *m_rect_light_pipeline;
+
+	// The CPU copies of the constant buffers, uploaded only if dirty (see "demo_uniform_buffer.h").
+	render_backend_buffer_t *m_uniform_buffer_per_view_binding;
+	uniform_buffer_per_view_binding_t m_uniform_buffer_data_per_view_binding;
+	bool m_uniform_buffer_per_view_binding_dirty;
+	render_backend_buffer_t *m_uniform_buffer_per_light_set_binding;
+	uniform_buffer_per_light_set_binding_t m_uniform_buffer_data_per_light_set_binding;
+	bool m_uniform_buffer_per_light_set_binding_dirty;
+	// one per overdraw layer, which only differ in the "model_transform"
+	render_backend_buffer_t *m_uniform_buffer_per_material_bindings[DEMO_MAX_OVERDRAW_LAYER_COUNT];
+	uniform_buffer_per_material_binding_t m_uniform_buffer_data_per_material_binding;
+	bool m_uniform_buffer_per_material_binding_dirty;
+	render_backend_buffer_t *m_uniform_buffer_per_frame_binding;
+	uniform_buffer_per_frame_binding_t m_uniform_buffer_data_per_frame_binding;
+	bool m_uniform_buffer_per_frame_binding_dirty;
+
+	uint32_t m_frame_index;
+	// the "view_transform * projection_transform" of the last "Tick"
+	DirectX::XMFLOAT4X4 m_previous_view_projection_transform;
+
+	// The checkerboard: the output of the frame "N" is the history of the frame "N + 1", the two textures swap every frame (NULL if the checkerboard is NOT used).
+	render_backend_texture_t *m_history_textures[2];
+	bool m_history_valid;
+	// of the render resolution, recreated when it changes
+	uint32_t m_history_width;
+	uint32_t m_history_height;
+	void CreateHistoryTextures(RenderBackend *render_backend);
+
+	render_backend_pipeline_t *m_auto_exposure_histogram_pipeline;
+	render_backend_pipeline_t *m_auto_exposure_pipeline;
+	// The auto exposure: the exposure of the frame "N" is adapted from the exposure of the frame "N - 1", the two 1x1 textures swap every frame.
+	// Both are initialized to the exposure 1, the first one is used as is if the auto exposure is NOT used.
+	render_backend_texture_t *m_exposure_textures[2];
+	bool m_exposure_valid;
+
+	render_backend_pipeline_t *m_post_process_pipeline;
+	// The tone mapping of the post process (see "cpu/tonemap_lut.h")
+	render_backend_sampler_t *m_tonemap_lut_sampler;
+	render_backend_texture_t *m_tonemap_lut;
+
+	render_backend_sampler_t *m_ltc_lut_sampler;
+	render_backend_texture_t *m_ltc_matrix_lut;
+	render_backend_texture_t *m_ltc_norm_lut;
+
+	// The prefiltered light texture of the textured quad (see "cpu/texture_prefilter.h")
+	render_backend_sampler_t *m_light_texture_sampler;
+	render_backend_texture_t *m_light_texture;
+	float m_light_texture_uv_scale_bias[4];
+
+	// The attachments are the transient textures of the frame graph.
+	FrameGraph m_frame_graph;
+	frame_graph_resource_t m_frame_graph_hdr_color;
+	// position, normal, diffuse color, specular color (see "RENDER_BACKEND_PROGRAM_PLANE_GBUFFER")
+	frame_graph_resource_t m_frame_graph_gbuffer[4];
+	// checkerboard: the half width lighting and the history of the previous frame
+	frame_graph_resource_t m_frame_graph_checkerboard_color;
+	frame_graph_resource_t m_frame_graph_history;
+	// auto exposure: the histogram, the exposure of the current and the previous frame
+	frame_graph_resource_t m_frame_graph_exposure_histogram;
+	frame_graph_resource_t m_frame_graph_exposure;
+	frame_graph_resource_t m_frame_graph_previous_exposure;
+
+	// forward
+	static void ExecuteLightPass(RenderBackend *render_backend, FrameGraph const *frame_graph, void *user_data);
+	// deferred
+	static void ExecuteGBufferPass(RenderBackend *render_backend, FrameGraph const *frame_graph, void *user_data);
+	static void ExecuteDeferredLightingPass(RenderBackend *render_backend, FrameGraph const *frame_graph, void *user_data);
+	static void ExecuteCheckerboardResolvePass(RenderBackend *render_backend, FrameGraph const *frame_graph, void *user_data);
+	static void ExecuteAutoExposureHistogramPass(RenderBackend *render_backend, FrameGraph const *frame_graph, void *user_data);
+	static void ExecuteAutoExposurePass(RenderBackend *render_backend, FrameGraph const *frame_graph, void *user_data);
+	static void ExecutePostProcessPass(RenderBackend *render_backend, FrameGraph const *frame_graph, void *user_data);
+
+	// the layers of the plane by the pipeline which is bound by the caller
+	void DrawPlaneLayers(RenderBackend *render_backend);
+	void DrawRectLight(RenderBackend *render_backend);
+
+	// The transient data of the frame (the staging of the constant buffers, etc.), valid for the frames in flight.
+	FrameArena m_frame_arena;
 
 public:
-	void Init(ID3D11Device *d3d11_device, ID3D11DeviceContext* d3d11_device_context, IDXGISwapChain* dxgi_swap_chain);
-	void Tick(ID3D11Device* d3d11_device, ID3D11DeviceContext *d3d11_device_context, IDXGISwapChain* dxgi_swap_chain);
+	void Init(RenderBackend *render_backend, demo_settings_t const &settings);
+	void Tick(RenderBackend *render_backend);
+	// The live resize (e.g. the border of the window is dragged): only the backbuffer is recreated, the pipelines, the LUTs and the constant buffers are kept.
+	// The transient textures of the frame graph follow the render resolution of the next frames, which is rounded down to the bucket until the size settles,
+	// such that the textures (and the software renderer of the CPU backend) are reused across the similar sizes while the size keeps changing.
+	void Resize(RenderBackend *render_backend, uint32_t width, uint32_t height);
+	void Destroy(RenderBackend *render_backend);
+
+	// the clamped settings
+	demo_settings_t const &GetSettings() const;
+	FrameArena const &GetFrameArena() const;
+	FrameGraph const &GetFrameGraph() const;
+	// the render resolution of the last "Tick"
+	uint32_t GetRenderWidth() const;
+	uint32_t GetRenderHeight() const;
+	DynamicResolution const &GetDynamicResolution() const;
 };
 
 #endif
\ No newline at end of file
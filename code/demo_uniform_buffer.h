@@ -0,0 +1,70 @@
+#ifndef _DEMO_UNIFORM_BUFFER_H_
+#define _DEMO_UNIFORM_BUFFER_H_ 1
+
+//
+// The layouts of the constant buffers, shared by the "Demo" and the backends which interpret them (see "backend/render_backend_cpu.h").
+// Must match the "cbuffer" in the shaders.
+//
+// The constant data is split by the update frequency, such that the unchanged blocks are never uploaded again:
+// b0 per view: changes when the camera moves
+// b1 per light set: the same for all the programs which use the light
+// b2 per material: the mesh and its material
+// b3 per frame: the temporal state of the checkerboard shading (see "DEMO_SHADING_MODE_DEFERRED" in "demo.h") and of the auto exposure, constant if the checkerboard is NOT used (after the first frame)
+//
+
+#include <DirectXMath.h>
+
+#define DEMO_UNIFORM_BUFFER_PER_VIEW_BINDING 0U
+#define DEMO_UNIFORM_BUFFER_PER_LIGHT_SET_BINDING 1U
+#define DEMO_UNIFORM_BUFFER_PER_MATERIAL_BINDING 2U
+#define DEMO_UNIFORM_BUFFER_PER_FRAME_BINDING 3U
+
+struct uniform_buffer_per_view_binding_t
+{
+	DirectX::XMFLOAT4X4 view_transform;
+	DirectX::XMFLOAT4X4 projection_transform;
+	DirectX::XMFLOAT3 eye_position;
+	float _padding_eye_position;
+};
+
+struct uniform_buffer_per_light_set_binding_t
+{
+	// the order of the quad (NOT the triangle strip)
+	DirectX::XMFLOAT4 rect_light_vetices[4];
+	float intensity;
+	float twoSided;
+	float __padding_align16_1;
+	float __padding_align16_2;
+	DirectX::XMFLOAT4 light_texture_uv_scale_bias;
+};
+
+struct uniform_buffer_per_material_binding_t
+{
+	// mesh
+	DirectX::XMFLOAT4X4 model_transform;
+	DirectX::XMFLOAT3 dcolor;
+	float _padding_dcolor;
+	DirectX::XMFLOAT3 scolor;
+	float _padding_scolor;
+	float roughness;
+	float _padding_roughness_1;
+	float _padding_roughness_2;
+	float _padding_roughness_3;
+};
+
+struct uniform_buffer_per_frame_binding_t
+{
+	// the "view_transform * projection_transform" of the previous frame, the reprojection of the history
+	DirectX::XMFLOAT4X4 previous_view_projection_transform;
+	// the pixels of which "(x + y + checkerboard_parity) & 1" is 0 are shaded by the current frame
+	uint32_t checkerboard_parity;
+	// the width of the G-buffer divided by the width of the lighting target
+	// 1: every pixel is shaded, 2: the shaded pixels are packed into the half width (the pixel "x" of the row "y" is at "x / 2")
+	uint32_t checkerboard_width_scale;
+	// 0: the history is NOT valid (e.g. the first frame), the skipped pixels are reconstructed by the neighbors only
+	uint32_t history_valid;
+	// 0: the exposure of the previous frame is NOT valid (the first frame), the auto exposure is set to the average instead of adapted
+	uint32_t exposure_valid;
+};
+
+#endif
@@ -1,101 +1,53 @@
-#include <sdkddkver.h>
-#define NOMINMAX 1
-#define WIN32_LEAN_AND_MEAN 1
-#include <Windows.h>
-
+#include <stdint.h>
 #include <cmath>
 #include <algorithm>
 
+#include "input_event_queue.h"
 #include "camera_controller.h"
 
 class CameraController g_camera_controller;
 
-static float g_SpeedTranslate = 0.5f;
+// the units per second while the key is held (about the 0.5 per "WM_KEYDOWN" at the auto repeat of 30 per second)
+static float const g_camera_controller_translate_speed = 15.0f;
 
-void CameraController::MoveForward()
-{
-	m_eye_position.x += m_eye_direction.x * g_SpeedTranslate;
-	m_eye_position.y += m_eye_direction.y * g_SpeedTranslate;
-	m_eye_position.z += m_eye_direction.z * g_SpeedTranslate;
-}
+// the radians per the client size dragged
+static float const g_camera_controller_rotate_speed = 2.0f;
 
-void CameraController::MoveBack()
-{
-	m_eye_position.x -= m_eye_direction.x * g_SpeedTranslate;
-	m_eye_position.y -= m_eye_direction.y * g_SpeedTranslate;
-	m_eye_position.z -= m_eye_direction.z * g_SpeedTranslate;
-}
+// the frame after the stall (e.g. the window is being dragged) does NOT move the camera further than this
+static float const g_camera_controller_max_delta_seconds = 0.1f;
 
-void CameraController::MoveLeft()
+void CameraController::Init(DirectX::XMFLOAT3 const &eye_position, DirectX::XMFLOAT3 const &eye_direction, DirectX::XMFLOAT3 const &up_direction)
 {
-	DirectX::XMFLOAT3 EyeDirection = { m_eye_direction.x, m_eye_direction.y, m_eye_direction.z };
-	DirectX::XMFLOAT3 UpDirection = { m_up_direction.x, m_up_direction.y, m_up_direction.z };
-
-	DirectX::XMVECTOR NegEyeDirection = DirectX::XMVectorNegate(DirectX::XMLoadFloat3(&EyeDirection));
-	DirectX::XMVECTOR AxisForwardDirection = DirectX::XMVector3Normalize(NegEyeDirection);
-	DirectX::XMVECTOR AxisRightDirection = DirectX::XMVector3Normalize(DirectX::XMVector3Cross(DirectX::XMLoadFloat3(&UpDirection), AxisForwardDirection));
-	// DirectX::XMVECTOR AxisViewUpDirection = DirectX::XMVector3Cross(AxisForwardDirection, AxisRightDirection);
+	m_eye_position = eye_position;
+	m_eye_direction = eye_direction;
+	m_up_direction = up_direction;
 
-	DirectX::XMFLOAT3 AxisRightDirectionF;
-	DirectX::XMStoreFloat3(&AxisRightDirectionF, AxisRightDirection);
+	Previous_X = 0.5f;
+	Previous_Y = 0.5f;
+	m_held_keys = 0U;
+	m_pending_yaw = 0.0f;
+	m_pending_pitch = 0.0f;
 
-	m_eye_position.x -= AxisRightDirectionF.x * g_SpeedTranslate;
-	m_eye_position.y -= AxisRightDirectionF.y * g_SpeedTranslate;
-	m_eye_position.z -= AxisRightDirectionF.z * g_SpeedTranslate;
+	this->UpdateBasis();
 }
 
-void CameraController::MoveRight()
+void CameraController::UpdateBasis()
 {
-	DirectX::XMFLOAT3 EyeDirection = { m_eye_direction.x, m_eye_direction.y, m_eye_direction.z };
-	DirectX::XMFLOAT3 UpDirection = { m_up_direction.x, m_up_direction.y, m_up_direction.z };
-
-	DirectX::XMVECTOR NegEyeDirection = DirectX::XMVectorNegate(DirectX::XMLoadFloat3(&EyeDirection));
-	DirectX::XMVECTOR AxisForwardDirection = DirectX::XMVector3Normalize(NegEyeDirection);
-	DirectX::XMVECTOR AxisRightDirection = DirectX::XMVector3Normalize(DirectX::XMVector3Cross(DirectX::XMLoadFloat3(&UpDirection), AxisForwardDirection));
-	// DirectX::XMVECTOR AxisViewUpDirection = DirectX::XMVector3Cross(AxisForwardDirection, AxisRightDirection);
+	DirectX::XMVECTOR AxisForwardDirection = DirectX::XMVector3Normalize(DirectX::XMLoadFloat3(&m_eye_direction));
+	DirectX::XMVECTOR AxisRightDirection = DirectX::XMVector3Normalize(DirectX::XMVector3Cross(AxisForwardDirection, DirectX::XMLoadFloat3(&m_up_direction)));
+	DirectX::XMVECTOR AxisViewUpDirection = DirectX::XMVector3Cross(AxisRightDirection, AxisForwardDirection);
 
-	DirectX::XMFLOAT3 AxisRightDirectionF;
-	DirectX::XMStoreFloat3(&AxisRightDirectionF, AxisRightDirection);
-
-	m_eye_position.x += AxisRightDirectionF.x * g_SpeedTranslate;
-	m_eye_position.y += AxisRightDirectionF.y * g_SpeedTranslate;
-	m_eye_position.z += AxisRightDirectionF.z * g_SpeedTranslate;
+	DirectX::XMStoreFloat3(&m_axis_forward, AxisForwardDirection);
+	DirectX::XMStoreFloat3(&m_axis_right, AxisRightDirection);
+	DirectX::XMStoreFloat3(&m_axis_view_up, AxisViewUpDirection);
 }
 
-void CameraController::MoveUp()
+void CameraController::OnKey(uint32_t key, bool down)
 {
-	DirectX::XMFLOAT3 EyeDirection = { m_eye_direction.x, m_eye_direction.y, m_eye_direction.z };
-	DirectX::XMFLOAT3 UpDirection = { m_up_direction.x, m_up_direction.y, m_up_direction.z };
-
-	DirectX::XMVECTOR NegEyeDirection = DirectX::XMVectorNegate(DirectX::XMLoadFloat3(&EyeDirection));
-	DirectX::XMVECTOR AxisForwardDirection = DirectX::XMVector3Normalize(NegEyeDirection);
-	DirectX::XMVECTOR AxisRightDirection = DirectX::XMVector3Normalize(DirectX::XMVector3Cross(DirectX::XMLoadFloat3(&UpDirection), AxisForwardDirection));
-	DirectX::XMVECTOR AxisViewUpDirection = DirectX::XMVector3Cross(AxisForwardDirection, AxisRightDirection);
-
-	DirectX::XMFLOAT3 AxisViewUpDirectionF;
-	DirectX::XMStoreFloat3(&AxisViewUpDirectionF, AxisViewUpDirection);
-
-	m_eye_position.x += AxisViewUpDirectionF.x * g_SpeedTranslate;
-	m_eye_position.y += AxisViewUpDirectionF.y * g_SpeedTranslate;
-	m_eye_position.z += AxisViewUpDirectionF.z * g_SpeedTranslate;
-}
-
-void CameraController::MoveDown()
-{
-	DirectX::XMFLOAT3 EyeDirection = { m_eye_direction.x, m_eye_direction.y, m_eye_direction.z };
-	DirectX::XMFLOAT3 UpDirection = { m_up_direction.x, m_up_direction.y, m_up_direction.z };
-
-	DirectX::XMVECTOR NegEyeDirection = DirectX::XMVectorNegate(DirectX::XMLoadFloat3(&EyeDirection));
-	DirectX::XMVECTOR AxisForwardDirection = DirectX::XMVector3Normalize(NegEyeDirection);
-	DirectX::XMVECTOR AxisRightDirection = DirectX::XMVector3Normalize(DirectX::XMVector3Cross(DirectX::XMLoadFloat3(&UpDirection), AxisForwardDirection));
-	DirectX::XMVECTOR AxisViewUpDirection = DirectX::XMVector3Cross(AxisForwardDirection, AxisRightDirection);
-
-	DirectX::XMFLOAT3 AxisViewUpDirectionF;
-	DirectX::XMStoreFloat3(&AxisViewUpDirectionF, AxisViewUpDirection);
-
-	m_eye_position.x -= AxisViewUpDirectionF.x * g_SpeedTranslate;
-	m_eye_position.y -= AxisViewUpDirectionF.y * g_SpeedTranslate;
-	m_eye_position.z -= AxisViewUpDirectionF.z * g_SpeedTranslate;
+	if (key < INPUT_KEY_COUNT)
+	{
+		m_held_keys = down ? (m_held_keys | (1U << key)) : (m_held_keys & (~(1U << key)));
+	}
 }
 
 void CameraController::OnMouseMove(float x, float y, bool hold)
@@ -108,78 +60,97 @@ void CameraController::OnMouseMove(float x, float y, bool hold)
 
 	if (hold)
 	{
-		float LengthNormalized = ::sqrtf(Offset_X * Offset_X + Offset_Y * Offset_Y);
+		float Angle = g_camera_controller_rotate_speed * ::sqrtf(Offset_X * Offset_X + Offset_Y * Offset_Y);
 
 		if ((Offset_Y < Offset_X) && (Offset_Y > -Offset_X))
 		{
 			// right
-			DirectX::XMFLOAT3 EyeDirection = { m_eye_direction.x, m_eye_direction.y, m_eye_direction.z };
-			DirectX::XMFLOAT3 UpDirection = { m_up_direction.x, m_up_direction.y, m_up_direction.z };
-
-			DirectX::XMVECTOR NegEyeDirection = DirectX::XMVectorNegate(DirectX::XMLoadFloat3(&EyeDirection));
-			DirectX::XMVECTOR AxisForwardDirection = DirectX::XMVector3Normalize(NegEyeDirection);
-			DirectX::XMVECTOR AxisRightDirection = DirectX::XMVector3Normalize(DirectX::XMVector3Cross(DirectX::XMLoadFloat3(&UpDirection), AxisForwardDirection));
-			DirectX::XMVECTOR AxisViewUpDirection = DirectX::XMVector3Cross(AxisForwardDirection, AxisRightDirection);
-
-			DirectX::XMFLOAT3 EyeDirectionNew;
-			DirectX::XMStoreFloat3(&EyeDirectionNew, DirectX::XMVectorNegate(DirectX::XMVector3Transform(AxisForwardDirection, DirectX::XMMatrixRotationAxis(AxisViewUpDirection, -2.0f * LengthNormalized))));
-			m_eye_direction.x = EyeDirectionNew.x;
-			m_eye_direction.y = EyeDirectionNew.y;
-			m_eye_direction.z = EyeDirectionNew.z;
+			m_pending_yaw -= Angle;
 		}
 		else if ((Offset_Y < -Offset_X) && (Offset_Y > Offset_X))
 		{
 			// left
-			DirectX::XMFLOAT3 EyeDirection = { m_eye_direction.x, m_eye_direction.y, m_eye_direction.z };
-			DirectX::XMFLOAT3 UpDirection = { m_up_direction.x, m_up_direction.y, m_up_direction.z };
-
-			DirectX::XMVECTOR NegEyeDirection = DirectX::XMVectorNegate(DirectX::XMLoadFloat3(&EyeDirection));
-			DirectX::XMVECTOR AxisForwardDirection = DirectX::XMVector3Normalize(NegEyeDirection);
-			DirectX::XMVECTOR AxisRightDirection = DirectX::XMVector3Normalize(DirectX::XMVector3Cross(DirectX::XMLoadFloat3(&UpDirection), AxisForwardDirection));
-			DirectX::XMVECTOR AxisViewUpDirection = DirectX::XMVector3Cross(AxisForwardDirection, AxisRightDirection);
-
-			DirectX::XMFLOAT3 EyeDirectionNew;
-			DirectX::XMStoreFloat3(&EyeDirectionNew, DirectX::XMVectorNegate(DirectX::XMVector3Transform(AxisForwardDirection, DirectX::XMMatrixRotationAxis(AxisViewUpDirection, 2.0f * LengthNormalized))));
-			m_eye_direction.x = EyeDirectionNew.x;
-			m_eye_direction.y = EyeDirectionNew.y;
-			m_eye_direction.z = EyeDirectionNew.z;
+			m_pending_yaw += Angle;
 		}
 		else if ((Offset_Y < Offset_X) && (Offset_Y < -Offset_X))
 		{
 			// up
-			DirectX::XMFLOAT3 EyeDirection = { m_eye_direction.x, m_eye_direction.y, m_eye_direction.z };
-			DirectX::XMFLOAT3 UpDirection = { m_up_direction.x, m_up_direction.y, m_up_direction.z };
-
-			DirectX::XMVECTOR NegEyeDirection = DirectX::XMVectorNegate(DirectX::XMLoadFloat3(&EyeDirection));
-			DirectX::XMVECTOR AxisForwardDirection = DirectX::XMVector3Normalize(NegEyeDirection);
-			DirectX::XMVECTOR AxisRightDirection = DirectX::XMVector3Normalize(DirectX::XMVector3Cross(DirectX::XMLoadFloat3(&UpDirection), AxisForwardDirection));
-			DirectX::XMVECTOR AxisViewUpDirection = DirectX::XMVector3Cross(AxisForwardDirection, AxisRightDirection);
-
-			DirectX::XMFLOAT3 EyeDirectionNew;
-			DirectX::XMStoreFloat3(&EyeDirectionNew, DirectX::XMVectorNegate(DirectX::XMVector3Transform(AxisForwardDirection, DirectX::XMMatrixRotationAxis(AxisRightDirection, 2.0f * LengthNormalized))));
-			m_eye_direction.x = EyeDirectionNew.x;
-			m_eye_direction.y = EyeDirectionNew.y;
-			m_eye_direction.z = EyeDirectionNew.z;
+			m_pending_pitch += Angle;
 		}
 		else if ((Offset_Y > Offset_X) && (Offset_Y > -Offset_X))
 		{
 			// down
-			DirectX::XMFLOAT3 EyeDirection = { m_eye_direction.x, m_eye_direction.y, m_eye_direction.z };
-			DirectX::XMFLOAT3 UpDirection = { m_up_direction.x, m_up_direction.y, m_up_direction.z };
-
-			DirectX::XMVECTOR NegEyeDirection = DirectX::XMVectorNegate(DirectX::XMLoadFloat3(&EyeDirection));
-			DirectX::XMVECTOR AxisForwardDirection = DirectX::XMVector3Normalize(NegEyeDirection);
-			DirectX::XMVECTOR AxisRightDirection = DirectX::XMVector3Normalize(DirectX::XMVector3Cross(DirectX::XMLoadFloat3(&UpDirection), AxisForwardDirection));
-			DirectX::XMVECTOR AxisViewUpDirection = DirectX::XMVector3Cross(AxisForwardDirection, AxisRightDirection);
-
-			DirectX::XMFLOAT3 EyeDirectionNew;
-			DirectX::XMStoreFloat3(&EyeDirectionNew, DirectX::XMVectorNegate(DirectX::XMVector3Transform(AxisForwardDirection, DirectX::XMMatrixRotationAxis(AxisRightDirection, -2.0f * LengthNormalized))));
-			m_eye_direction.x = EyeDirectionNew.x;
-			m_eye_direction.y = EyeDirectionNew.y;
-			m_eye_direction.z = EyeDirectionNew.z;
+			m_pending_pitch -= Angle;
 		}
 	}
 
 	Previous_X = Current_X;
 	Previous_Y = Current_Y;
 }
+
+void CameraController::ApplyInputEvent(input_event_t const &event)
+{
+	switch (event.type)
+	{
+	case INPUT_EVENT_TYPE_KEY_DOWN:
+	{
+		this->OnKey(event.key, true);
+	}
+	break;
+	case INPUT_EVENT_TYPE_KEY_UP:
+	{
+		this->OnKey(event.key, false);
+	}
+	break;
+	case INPUT_EVENT_TYPE_MOUSE_MOVE:
+	{
+		this->OnMouseMove(event.x, event.y, (0U != event.hold));
+	}
+	break;
+	}
+}
+
+void CameraController::SetHeldKeys(uint32_t held_keys)
+{
+	m_held_keys = held_keys & ((1U << INPUT_KEY_COUNT) - 1U);
+}
+
+uint32_t CameraController::GetHeldKeys() const
+{
+	return m_held_keys;
+}
+
+void CameraController::ReleaseKeys()
+{
+	m_held_keys = 0U;
+}
+
+void CameraController::Update(float delta_seconds)
+{
+	// the rotation of the events since the last frame: around the axes of the basis before the rotation
+	if (0.0f != m_pending_yaw || 0.0f != m_pending_pitch)
+	{
+		DirectX::XMVECTOR EyeDirection = DirectX::XMLoadFloat3(&m_eye_direction);
+		EyeDirection = DirectX::XMVector3Transform(EyeDirection, DirectX::XMMatrixRotationAxis(DirectX::XMLoadFloat3(&m_axis_view_up), m_pending_yaw));
+		EyeDirection = DirectX::XMVector3Transform(EyeDirection, DirectX::XMMatrixRotationAxis(DirectX::XMLoadFloat3(&m_axis_right), m_pending_pitch));
+		DirectX::XMStoreFloat3(&m_eye_direction, EyeDirection);
+
+		m_pending_yaw = 0.0f;
+		m_pending_pitch = 0.0f;
+
+		this->UpdateBasis();
+	}
+
+	float const forward = ((0U != (m_held_keys & (1U << INPUT_KEY_FORWARD))) ? 1.0f : 0.0f) - ((0U != (m_held_keys & (1U << INPUT_KEY_BACK))) ? 1.0f : 0.0f);
+	float const right = ((0U != (m_held_keys & (1U << INPUT_KEY_RIGHT))) ? 1.0f : 0.0f) - ((0U != (m_held_keys & (1U << INPUT_KEY_LEFT))) ? 1.0f : 0.0f);
+	float const up = ((0U != (m_held_keys & (1U << INPUT_KEY_UP))) ? 1.0f : 0.0f) - ((0U != (m_held_keys & (1U << INPUT_KEY_DOWN))) ? 1.0f : 0.0f);
+	if (0.0f != forward || 0.0f != right || 0.0f != up)
+	{
+		// the diagonal is NOT faster than the single key
+		float const distance = g_camera_controller_translate_speed * std::min(std::max(0.0f, delta_seconds), g_camera_controller_max_delta_seconds) / ::sqrtf(forward * forward + right * right + up * up);
+
+		m_eye_position.x += (m_axis_forward.x * forward + m_axis_right.x * right + m_axis_view_up.x * up) * distance;
+		m_eye_position.y += (m_axis_forward.y * forward + m_axis_right.y * right + m_axis_view_up.y * up) * distance;
+		m_eye_position.z += (m_axis_forward.z * forward + m_axis_right.z * right + m_axis_view_up.z * up) * distance;
+	}
+}
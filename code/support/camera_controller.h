@@ -1,15 +1,12 @@
 #ifndef _CAMERA_CONTROLLER_H_
 #define _CAMERA_CONTROLLER_H_ 1
 
-#include <sdkddkver.h>
-#ifndef WIN32_LEAN_AND_MEAN
-#define WIN32_LEAN_AND_MEAN 1
-#endif
-#ifndef NOMINMAX
-#define NOMINMAX 1
-#endif
-#include <windows.h>
+//
+// The camera moves by the velocity of the held keys integrated over the time of the frame (see "Update"), such that the speed does NOT depend on the frame rate or on the auto repeat of the keyboard.
+// The orthonormal basis of the view is cached and recomputed only when the camera rotates, the rotation of the mouse is accumulated by the events and applied once per frame.
+//
 
+#include <stdint.h>
 #include <DirectXMath.h>
 
 class CameraController
@@ -17,21 +14,43 @@ class CameraController
 	float Previous_X;
 	float Previous_Y;
 
+	// the bits of the "INPUT_KEY"
+	uint32_t m_held_keys;
+	// the radians since the last "Update": around the view up and around the right
+	float m_pending_yaw;
+	float m_pending_pitch;
+
+	// the unit vectors of the eye direction, of the right and of the view up
+	DirectX::XMFLOAT3 m_axis_forward;
+	DirectX::XMFLOAT3 m_axis_right;
+	DirectX::XMFLOAT3 m_axis_view_up;
+
+	void UpdateBasis();
+
 public:
 	DirectX::XMFLOAT3 m_eye_position;
 	DirectX::XMFLOAT3 m_eye_direction;
 	DirectX::XMFLOAT3 m_up_direction;
 
-	void MoveForward();
-	void MoveBack();
-	void MoveLeft();
-	void MoveRight();
-	void MoveUp();
-	void MoveDown();
+	void Init(DirectX::XMFLOAT3 const &eye_position, DirectX::XMFLOAT3 const &eye_direction, DirectX::XMFLOAT3 const &up_direction);
 
+	// [in] key: see "INPUT_KEY"
+	void OnKey(uint32_t key, bool down);
 	void OnMouseMove(float x, float y, bool hold);
+
+	// the event of the window thread (see "input_event_queue.h")
+	void ApplyInputEvent(struct input_event_t const &event);
+	// the keys of the window thread which replace the keys of the events (see "InputEventQueue::ReconcileHeldKeys")
+	void SetHeldKeys(uint32_t held_keys);
+	uint32_t GetHeldKeys() const;
+	// the event is lost (see "InputEventQueue::GetDroppedEventCount"): the camera stops at once rather than moving by the key which may have been released, until the held keys are reconciled
+	void ReleaseKeys();
+
+	// once per frame before the camera is used: the rotation of the mouse is applied, and the camera moves by the held keys over the "delta_seconds"
+	void Update(float delta_seconds);
 };
 
+// owned by the render thread: the window thread sends the input events rather than changing the camera
 extern class CameraController g_camera_controller;
 
-#endif
\ No newline at end of file
+#endif
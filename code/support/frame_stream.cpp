@@ -0,0 +1,302 @@
+#if defined(_WIN32)
+#include <sdkddkver.h>
+#define WIN32_LEAN_AND_MEAN 1
+#define NOMINMAX 1
+#include <winsock2.h>
+#include <afunix.h>
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <vector>
+
+#include "frame_stream.h"
+
+#if defined(_WIN32)
+typedef SOCKET frame_stream_socket_t;
+static frame_stream_socket_t const g_frame_stream_invalid_socket = INVALID_SOCKET;
+#else
+typedef int frame_stream_socket_t;
+static frame_stream_socket_t const g_frame_stream_invalid_socket = -1;
+#endif
+
+// [return] the socket of the AF_UNIX stream, and the address of the path
+static frame_stream_socket_t frame_stream_socket(char const *path, struct sockaddr_un *address);
+
+static void frame_stream_close(frame_stream_socket_t socket);
+
+static void frame_stream_unlink(char const *path);
+
+// [return] false if the connection is closed before all the bytes are transferred
+static bool frame_stream_send_all(frame_stream_socket_t socket, uint8_t const *data, size_t size);
+
+static bool frame_stream_receive_all(frame_stream_socket_t socket, uint8_t *data, size_t size);
+
+void FrameStream::Init()
+{
+#if defined(_WIN32)
+	WSADATA wsa_data;
+	int res_wsa_startup = WSAStartup(MAKEWORD(2, 2), &wsa_data);
+	assert(0 == res_wsa_startup);
+	(void)res_wsa_startup;
+#endif
+
+	m_listen_socket = static_cast<intptr_t>(g_frame_stream_invalid_socket);
+	m_socket = static_cast<intptr_t>(g_frame_stream_invalid_socket);
+	m_path[0] = '\0';
+	m_message_count = 0U;
+	m_byte_count = 0U;
+}
+
+void FrameStream::Destroy()
+{
+	if (static_cast<intptr_t>(g_frame_stream_invalid_socket) != m_socket)
+	{
+		frame_stream_close(static_cast<frame_stream_socket_t>(m_socket));
+		m_socket = static_cast<intptr_t>(g_frame_stream_invalid_socket);
+	}
+
+	if (static_cast<intptr_t>(g_frame_stream_invalid_socket) != m_listen_socket)
+	{
+		frame_stream_close(static_cast<frame_stream_socket_t>(m_listen_socket));
+		m_listen_socket = static_cast<intptr_t>(g_frame_stream_invalid_socket);
+		frame_stream_unlink(m_path);
+	}
+
+#if defined(_WIN32)
+	WSACleanup();
+#endif
+}
+
+bool FrameStream::Connect(char const *path)
+{
+	assert(static_cast<intptr_t>(g_frame_stream_invalid_socket) == m_socket);
+
+	struct sockaddr_un address;
+	frame_stream_socket_t const socket = frame_stream_socket(path, &address);
+	if (g_frame_stream_invalid_socket == socket)
+	{
+		return false;
+	}
+
+	if (0 != connect(socket, reinterpret_cast<struct sockaddr const *>(&address), sizeof(address)))
+	{
+		frame_stream_close(socket);
+		return false;
+	}
+
+	m_socket = static_cast<intptr_t>(socket);
+	return true;
+}
+
+bool FrameStream::Listen(char const *path)
+{
+	assert(static_cast<intptr_t>(g_frame_stream_invalid_socket) == m_listen_socket);
+
+	struct sockaddr_un address;
+	frame_stream_socket_t const socket = frame_stream_socket(path, &address);
+	if (g_frame_stream_invalid_socket == socket)
+	{
+		return false;
+	}
+
+	frame_stream_unlink(path);
+	if (0 != bind(socket, reinterpret_cast<struct sockaddr const *>(&address), sizeof(address)) || 0 != listen(socket, 1))
+	{
+		frame_stream_close(socket);
+		return false;
+	}
+
+	snprintf(m_path, sizeof(m_path), "%s", path);
+	m_listen_socket = static_cast<intptr_t>(socket);
+	return true;
+}
+
+bool FrameStream::Accept()
+{
+	assert(static_cast<intptr_t>(g_frame_stream_invalid_socket) != m_listen_socket && static_cast<intptr_t>(g_frame_stream_invalid_socket) == m_socket);
+
+	frame_stream_socket_t const socket = accept(static_cast<frame_stream_socket_t>(m_listen_socket), NULL, NULL);
+	if (g_frame_stream_invalid_socket == socket)
+	{
+		return false;
+	}
+
+	m_socket = static_cast<intptr_t>(socket);
+	return true;
+}
+
+bool FrameStream::Send(uint8_t const *message, uint32_t message_size)
+{
+	assert(static_cast<intptr_t>(g_frame_stream_invalid_socket) != m_socket);
+
+	uint8_t size_prefix[4];
+	memcpy(size_prefix, &message_size, sizeof(uint32_t));
+
+	frame_stream_socket_t const socket = static_cast<frame_stream_socket_t>(m_socket);
+	if (!frame_stream_send_all(socket, size_prefix, sizeof(size_prefix)) || !frame_stream_send_all(socket, message, message_size))
+	{
+		return false;
+	}
+
+	++m_message_count;
+	m_byte_count += sizeof(size_prefix) + message_size;
+	return true;
+}
+
+bool FrameStream::Receive(std::vector<uint8_t> &message, uint32_t max_message_size)
+{
+	assert(static_cast<intptr_t>(g_frame_stream_invalid_socket) != m_socket);
+
+	frame_stream_socket_t const socket = static_cast<frame_stream_socket_t>(m_socket);
+
+	uint8_t size_prefix[4];
+	if (!frame_stream_receive_all(socket, size_prefix, sizeof(size_prefix)))
+	{
+		return false;
+	}
+	uint32_t message_size;
+	memcpy(&message_size, size_prefix, sizeof(uint32_t));
+	if (message_size > max_message_size)
+	{
+		return false;
+	}
+
+	message.resize(message_size);
+	if (message_size > 0U && !frame_stream_receive_all(socket, &message[0], message_size))
+	{
+		return false;
+	}
+
+	++m_message_count;
+	m_byte_count += sizeof(size_prefix) + message_size;
+	return true;
+}
+
+uint64_t FrameStream::GetMessageCount() const
+{
+	return m_message_count;
+}
+
+uint64_t FrameStream::GetByteCount() const
+{
+	return m_byte_count;
+}
+
+static frame_stream_socket_t frame_stream_socket(char const *path, struct sockaddr_un *address)
+{
+	memset(address, 0, sizeof(struct sockaddr_un));
+	address->sun_family = AF_UNIX;
+	if (strlen(path) >= sizeof(address->sun_path))
+	{
+		return g_frame_stream_invalid_socket;
+	}
+	memcpy(address->sun_path, path, strlen(path));
+
+	return socket(AF_UNIX, SOCK_STREAM, 0);
+}
+
+#if defined(_WIN32)
+static void frame_stream_close(frame_stream_socket_t socket)
+{
+	closesocket(socket);
+}
+
+static void frame_stream_unlink(char const *path)
+{
+	DeleteFileA(path);
+}
+
+static bool frame_stream_send_all(frame_stream_socket_t socket, uint8_t const *data, size_t size)
+{
+	while (size > 0U)
+	{
+		int const sent = send(socket, reinterpret_cast<char const *>(data), static_cast<int>((size < 0X40000000U) ? size : 0X40000000U), 0);
+		if (sent <= 0)
+		{
+			return false;
+		}
+		data += sent;
+		size -= static_cast<size_t>(sent);
+	}
+	return true;
+}
+
+static bool frame_stream_receive_all(frame_stream_socket_t socket, uint8_t *data, size_t size)
+{
+	while (size > 0U)
+	{
+		int const received = recv(socket, reinterpret_cast<char *>(data), static_cast<int>((size < 0X40000000U) ? size : 0X40000000U), 0);
+		if (received <= 0)
+		{
+			return false;
+		}
+		data += received;
+		size -= static_cast<size_t>(received);
+	}
+	return true;
+}
+#else
+static void frame_stream_close(frame_stream_socket_t socket)
+{
+	close(socket);
+}
+
+static void frame_stream_unlink(char const *path)
+{
+	unlink(path);
+}
+
+static bool frame_stream_send_all(frame_stream_socket_t socket, uint8_t const *data, size_t size)
+{
+	// the closed connection is reported by the result rather than the SIGPIPE
+#if defined(MSG_NOSIGNAL)
+	int const flags = MSG_NOSIGNAL;
+#else
+	int const flags = 0;
+#endif
+	while (size > 0U)
+	{
+		ssize_t const sent = send(socket, data, size, flags);
+		if (sent < 0 && EINTR == errno)
+		{
+			continue;
+		}
+		if (sent <= 0)
+		{
+			return false;
+		}
+		data += sent;
+		size -= static_cast<size_t>(sent);
+	}
+	return true;
+}
+
+static bool frame_stream_receive_all(frame_stream_socket_t socket, uint8_t *data, size_t size)
+{
+	while (size > 0U)
+	{
+		ssize_t const received = recv(socket, data, size, 0);
+		if (received < 0 && EINTR == errno)
+		{
+			continue;
+		}
+		if (received <= 0)
+		{
+			return false;
+		}
+		data += received;
+		size -= static_cast<size_t>(received);
+	}
+	return true;
+}
+#endif
@@ -0,0 +1,49 @@
+#ifndef _FRAME_STREAM_H_
+#define _FRAME_STREAM_H_ 1
+
+//
+// The stream of the messages (e.g. the frames of "cpu/tile_delta.h") over the Unix domain socket to the local viewer, or to the relay which forwards them (e.g. into the tunnel to the other machine).
+// The viewer (or the relay) listens on the path, the renderer connects to it. Each message is prefixed by its size (uint32, little endian).
+// The "Send" blocks while the socket buffer is full, such that the slow viewer slows down the renderer rather than the messages being dropped (the delta of the frame can NOT be skipped).
+//
+// Windows: the AF_UNIX of the Winsock (Windows 10 1803 or later).
+//
+
+#include <stdint.h>
+#include <vector>
+
+class FrameStream
+{
+	intptr_t m_listen_socket;
+	intptr_t m_socket;
+	char m_path[108];
+
+	uint64_t m_message_count;
+	uint64_t m_byte_count;
+
+public:
+	void Init();
+	// the path of the listener is removed
+	void Destroy();
+
+	// the sender
+	// [return] false if nothing listens on the path
+	bool Connect(char const *path);
+
+	// the viewer: listens on the path (the stale socket file of the previous run is replaced), and waits for the sender
+	bool Listen(char const *path);
+	bool Accept();
+
+	// [return] false if the other side has closed the connection
+	bool Send(uint8_t const *message, uint32_t message_size);
+	// [in] max_message_size: the size prefix above it is treated as the corrupted (or hostile) stream rather than being allocated, and the connection can NOT be used any more (the rest of the message is NOT read)
+	// [out] message: resized to the message (the capacity is kept)
+	// [return] false if the other side has closed the connection, or the message is larger than the "max_message_size"
+	bool Receive(std::vector<uint8_t> &message, uint32_t max_message_size);
+
+	// sent or received, including the size prefixes
+	uint64_t GetMessageCount() const;
+	uint64_t GetByteCount() const;
+};
+
+#endif
@@ -0,0 +1,2004 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <cmath>
+#include <algorithm>
+#include <vector>
+#include <chrono>
+#include <atomic>
+#include <new>
+#include <thread>
+
+#include "../cpu/thread_pool.h"
+#include "../cpu/software_renderer.h"
+#include "../cpu/tonemap_lut.h"
+#include "../cpu/half.h"
+#include "../cpu/tonemap_encoder.h"
+#include "../cpu/auto_exposure.h"
+#include "../cpu/dynamic_resolution.h"
+#include "../cpu/image_sequence_writer.h"
+#include "../cpu/shared_framebuffer.h"
+#include "../cpu/tile_delta.h"
+
+#include "../backend/render_backend_null.h"
+#include "../backend/render_backend_cpu.h"
+#include "../backend/render_backend_state_tracker.h"
+#include "../backend/frame_graph.h"
+
+#include "../demo.h"
+
+#include "resolution.h"
+#include "frame_stream.h"
+#include "input_event_queue.h"
+#include "camera_controller.h"
+
+#include "headless_main.h"
+
+// the same as the "Demo::Init" and the "Demo::Tick"
+static void headless_build_demo_scene(std::vector<float> &triangle_vertices, software_renderer_scene_t &scene);
+
+static void headless_append_box(std::vector<float> &triangle_vertices, float const box_min[3], float const box_max[3]);
+
+// the camera path of the sequence: the camera of the "headless_build_demo_scene" pans from the left to the right over the frames
+static void headless_camera_path(software_renderer_scene_t const &scene, uint32_t frame_index, uint32_t frame_count, float eye_position[3], float eye_direction[3]);
+
+static bool headless_write_pfm(char const *path, uint32_t width, uint32_t height, float const *radiance);
+
+// The cost of the tone mapping of the rendered image by the analytic curve and by the tonemap LUT (the same loop as the post process of the CPU backend),
+// and the error of the LUT over the image and over the whole HDR range.
+static void headless_tonemap_report(ThreadPool *thread_pool, uint32_t width, uint32_t height, float const *radiance);
+
+// The cost of the SIMD encoder of the rendered image (as RGBA32F and as RGBA16F), and the error against the analytic curve.
+// [in] analytic_image: RGBA8, the "TonemapAnalytic" of the image
+static void headless_tonemap_encoder_report(ThreadPool *thread_pool, uint32_t width, uint32_t height, float const *radiance, uint8_t const *analytic_image);
+
+// The cost of the histogram of the auto exposure of the rendered image against the frame time of the software renderer,
+// and the frames for the adapted exposure to follow the light 4 times as bright.
+static void headless_auto_exposure_report(ThreadPool *thread_pool, uint32_t width, uint32_t height, float const *radiance, double frame_milliseconds);
+
+// The viewer of the shared framebuffer of the other headless process (see "cpu/shared_framebuffer.h"): the "frame_count" new frames are read in place (the checksum of the pixels, as the blit of the viewer would),
+// the frames which are skipped (the viewer is slower than the producer) and the frames which are torn (the slot is reused while being read) are reported.
+static int headless_view_main(char const *shared_framebuffer_name, uint32_t frame_count);
+
+struct headless_stream_statistics_t
+{
+	uint32_t frame_count;
+	uint64_t tile_count;
+	uint64_t dirty_tile_count;
+	uint64_t raw_byte_count;
+	double encode_milliseconds;
+	// blocked while the viewer is behind
+	double send_milliseconds;
+};
+
+// the delta of the presented frame of the CPU backend (see "cpu/tile_delta.h") is sent to the viewer
+// [return] false if the viewer has closed the connection
+static bool headless_stream_frame(ThreadPool *thread_pool, RenderBackendCPU const *render_backend_cpu, uint32_t frame_index, TileDeltaEncoder *tile_delta_encoder, FrameStream *frame_stream, headless_stream_statistics_t *statistics);
+
+// The viewer of the "--stream" of the other headless process (see "support/frame_stream.h"): the messages are applied until the sender closes the connection,
+// the bytes received against the raw frames, the cost of the decode and the checksum of the last frame (the same as the checksum reported by the sender) are reported.
+static int headless_stream_view_main(char const *stream_path);
+
+// The regression of the header of the stream which is NOT trusted: the messages of the hostile headers (e.g. the key frame of 0XFFFF0000 x 0XFFFF0000) are applied to the decoder of the "max_frame_size".
+// [return] false if any message is applied (rather than rejected)
+static bool headless_stream_view_hostile_headers(uint32_t max_frame_size);
+
+// the sum of the bytes of the BGRA8 frame
+static uint64_t headless_frame_checksum(uint8_t const *pixels, uint32_t width, uint32_t height);
+
+// The synthetic window thread: the held keys and the right button drag of the mouse are pushed into the queue at "event_rate" events per second until the "quit",
+// such that the frame loop drains them as the render thread does (see "render_main.cpp").
+static void headless_input_producer_main(InputEventQueue *input_event_queue, uint32_t event_rate, std::atomic<bool> const *quit, uint64_t *pushed_event_count);
+
+// The regression of the full input event queue: the synthetic window thread holds each key in turn and floods the "flood_count" mouse moves between its KEY_DOWN and its KEY_UP (much faster than the frames drain them),
+// the frames drain the events and reconcile the held keys as the "render_main" does.
+// [return] 1 if any key is still held after the last frame (the KEY_UP is lost), or the queue is never full
+static int headless_input_flood_main(uint32_t flood_count);
+
+static void headless_input_flood_producer_main(InputEventQueue *input_event_queue, uint32_t flood_count, std::atomic<bool> *done);
+
+static void headless_input_flood_push_key(InputEventQueue *input_event_queue, uint32_t type, uint32_t key);
+
+// as fast as possible (the "event_index" is the angle of the drag)
+static void headless_input_flood_push_mouse_moves(InputEventQueue *input_event_queue, uint32_t move_count, uint64_t *event_index);
+
+// the number of the "new" since the process started (0 on Windows where the operator new is NOT replaced)
+static inline uint64_t headless_heap_allocation_count();
+
+// the frame loop of the "Demo" on the null or the CPU backend
+static int headless_demo_main(char const *backend_name, ThreadPool *thread_pool, uint32_t width, uint32_t height, uint32_t frame_count, uint32_t frame_graph_pass_count, uint32_t resize_step_count, char const *shared_framebuffer_name, char const *stream_path, uint32_t input_event_rate, software_renderer_shadow_settings_t const &settings, demo_settings_t const &demo_settings);
+
+// The synthetic chain of the post process passes, used to measure the cost of the frame graph itself.
+// Every 4th pass is the dead branch (culled), the full and the half resolution targets alternate (aliased).
+static void headless_build_frame_graph(FrameGraph &frame_graph, uint32_t pass_count, uint32_t width, uint32_t height);
+
+static void headless_frame_graph_execute_nothing(RenderBackend *render_backend, FrameGraph const *frame_graph, void *user_data);
+
+// The regression of the culling: the writer clears the scratch color and the depth, the loader writes the backbuffer and loads the depth (e.g. the decals on the depth of the earlier pass).
+// Nothing samples the depth, the load alone keeps the writer alive.
+// [return] false if either pass is culled
+static bool headless_frame_graph_load_after_clear(FrameGraph &frame_graph, uint32_t width, uint32_t height);
+
+int headless_main(int argc, char *argv[])
+{
+	uint32_t width = g_resolution_width;
+	uint32_t height = g_resolution_height;
+	uint32_t thread_count = 0U;
+	uint32_t frame_count = 1U;
+	uint32_t reference_sample_count = 0U;
+	char const *output_path = NULL;
+	char const *backend_name = NULL;
+	uint32_t frame_graph_pass_count = 0U;
+	uint32_t resize_step_count = 0U;
+	char const *sequence_prefix = NULL;
+	char const *shared_framebuffer_name = NULL;
+	char const *view_name = NULL;
+	char const *stream_path = NULL;
+	char const *stream_view_path = NULL;
+	uint32_t input_event_rate = 0U;
+	uint32_t input_flood_count = 0U;
+	image_sequence_format_t sequence_format = IMAGE_SEQUENCE_FORMAT_EXR;
+	uint32_t sequence_writer_count = 2U;
+	uint32_t sequence_queue_length = 4U;
+	bool tonemap_report = false;
+	bool auto_exposure_report = false;
+
+	software_renderer_shadow_settings_t settings;
+	settings.min_sample_count = 4U;
+	settings.max_sample_count = 64U;
+	settings.target_standard_error = 0.02f;
+	settings.denoise = true;
+
+	demo_settings_t demo_settings;
+	demo_settings.shading_mode = DEMO_SHADING_MODE_FORWARD;
+	demo_settings.overdraw_layer_count = 1U;
+	demo_settings.depth_prepass = false;
+	demo_settings.checkerboard_shading = false;
+	demo_settings.auto_exposure = false;
+	demo_settings.dynamic_resolution = false;
+	demo_settings.frame_time_budget_ms = 0.0f;
+
+	for (int arg_index = 1; arg_index < argc; ++arg_index)
+	{
+		char const *const arg = argv[arg_index];
+		char const *const value = ((arg_index + 1) < argc) ? argv[arg_index + 1] : NULL;
+
+		if (0 == strcmp(arg, "--headless"))
+		{
+			continue;
+		}
+		else if (0 == strcmp(arg, "--no-denoise"))
+		{
+			settings.denoise = false;
+			continue;
+		}
+		else if (0 == strcmp(arg, "--tonemap"))
+		{
+			tonemap_report = true;
+			continue;
+		}
+		else if (0 == strcmp(arg, "--auto-exposure"))
+		{
+			auto_exposure_report = true;
+			demo_settings.auto_exposure = true;
+			continue;
+		}
+		else if (0 == strcmp(arg, "--deferred"))
+		{
+			demo_settings.shading_mode = DEMO_SHADING_MODE_DEFERRED;
+			continue;
+		}
+		else if (0 == strcmp(arg, "--depth-prepass"))
+		{
+			demo_settings.depth_prepass = true;
+			continue;
+		}
+		else if (0 == strcmp(arg, "--checkerboard"))
+		{
+			demo_settings.checkerboard_shading = true;
+			continue;
+		}
+		else if (NULL == value)
+		{
+			fprintf(stderr, "headless: missing the value of \"%s\"\n", arg);
+			return 1;
+		}
+		else if (0 == strcmp(arg, "--width"))
+		{
+			width = static_cast<uint32_t>(strtoul(value, NULL, 10));
+		}
+		else if (0 == strcmp(arg, "--height"))
+		{
+			height = static_cast<uint32_t>(strtoul(value, NULL, 10));
+		}
+		else if (0 == strcmp(arg, "--threads"))
+		{
+			thread_count = static_cast<uint32_t>(strtoul(value, NULL, 10));
+		}
+		else if (0 == strcmp(arg, "--samples-min"))
+		{
+			settings.min_sample_count = static_cast<uint32_t>(strtoul(value, NULL, 10));
+		}
+		else if (0 == strcmp(arg, "--samples-max"))
+		{
+			settings.max_sample_count = static_cast<uint32_t>(strtoul(value, NULL, 10));
+		}
+		else if (0 == strcmp(arg, "--target-error"))
+		{
+			settings.target_standard_error = static_cast<float>(strtod(value, NULL));
+		}
+		else if (0 == strcmp(arg, "--frames"))
+		{
+			frame_count = static_cast<uint32_t>(strtoul(value, NULL, 10));
+		}
+		else if (0 == strcmp(arg, "--reference"))
+		{
+			reference_sample_count = static_cast<uint32_t>(strtoul(value, NULL, 10));
+		}
+		else if (0 == strcmp(arg, "--output"))
+		{
+			output_path = value;
+		}
+		else if (0 == strcmp(arg, "--backend"))
+		{
+			backend_name = value;
+		}
+		else if (0 == strcmp(arg, "--frame-graph-passes"))
+		{
+			frame_graph_pass_count = static_cast<uint32_t>(strtoul(value, NULL, 10));
+		}
+		else if (0 == strcmp(arg, "--overdraw"))
+		{
+			demo_settings.overdraw_layer_count = static_cast<uint32_t>(strtoul(value, NULL, 10));
+		}
+		else if (0 == strcmp(arg, "--sequence"))
+		{
+			sequence_prefix = value;
+		}
+		else if (0 == strcmp(arg, "--sequence-format"))
+		{
+			if (NULL != value && 0 == strcmp(value, "exr"))
+			{
+				sequence_format = IMAGE_SEQUENCE_FORMAT_EXR;
+			}
+			else if (NULL != value && 0 == strcmp(value, "pfm"))
+			{
+				sequence_format = IMAGE_SEQUENCE_FORMAT_PFM;
+			}
+			else if (NULL != value && 0 == strcmp(value, "png"))
+			{
+				sequence_format = IMAGE_SEQUENCE_FORMAT_PNG;
+			}
+			else if (NULL != value && 0 == strcmp(value, "bgra"))
+			{
+				sequence_format = IMAGE_SEQUENCE_FORMAT_BGRA;
+			}
+			else
+			{
+				fprintf(stderr, "headless: unknown sequence format \"%s\"\n", (NULL != value) ? value : "");
+				return 1;
+			}
+		}
+		else if (0 == strcmp(arg, "--sequence-writers"))
+		{
+			sequence_writer_count = static_cast<uint32_t>(strtoul(value, NULL, 10));
+		}
+		else if (0 == strcmp(arg, "--sequence-queue"))
+		{
+			sequence_queue_length = static_cast<uint32_t>(strtoul(value, NULL, 10));
+		}
+		else if (0 == strcmp(arg, "--shared-framebuffer"))
+		{
+			shared_framebuffer_name = value;
+		}
+		else if (0 == strcmp(arg, "--view"))
+		{
+			view_name = value;
+		}
+		else if (0 == strcmp(arg, "--stream"))
+		{
+			stream_path = value;
+		}
+		else if (0 == strcmp(arg, "--stream-view"))
+		{
+			stream_view_path = value;
+		}
+		else if (0 == strcmp(arg, "--input-events"))
+		{
+			input_event_rate = static_cast<uint32_t>(strtoul(value, NULL, 10));
+		}
+		else if (0 == strcmp(arg, "--input-flood"))
+		{
+			input_flood_count = static_cast<uint32_t>(strtoul(value, NULL, 10));
+		}
+		else if (0 == strcmp(arg, "--resize"))
+		{
+			resize_step_count = static_cast<uint32_t>(strtoul(value, NULL, 10));
+		}
+		else if (0 == strcmp(arg, "--frame-budget"))
+		{
+			demo_settings.dynamic_resolution = true;
+			demo_settings.frame_time_budget_ms = static_cast<float>(strtod(value, NULL));
+		}
+		else
+		{
+			fprintf(stderr, "headless: unknown option \"%s\"\n", arg);
+			return 1;
+		}
+
+		++arg_index;
+	}
+
+	if (0U == width || 0U == height || 0U == frame_count)
+	{
+		fprintf(stderr, "headless: invalid size\n");
+		return 1;
+	}
+
+	if (NULL != view_name)
+	{
+		return headless_view_main(view_name, frame_count);
+	}
+
+	if (NULL != stream_view_path)
+	{
+		return headless_stream_view_main(stream_view_path);
+	}
+
+	if (input_flood_count > 0U)
+	{
+		return headless_input_flood_main(input_flood_count);
+	}
+
+	if (NULL != shared_framebuffer_name && (NULL == backend_name || 0 != strcmp(backend_name, "cpu")))
+	{
+		fprintf(stderr, "headless: \"--shared-framebuffer\" requires \"--backend cpu\"\n");
+		return 1;
+	}
+
+	if (NULL != stream_path && (NULL == backend_name || 0 != strcmp(backend_name, "cpu")))
+	{
+		fprintf(stderr, "headless: \"--stream\" requires \"--backend cpu\"\n");
+		return 1;
+	}
+
+	if (NULL != backend_name)
+	{
+		if (0 != strcmp(backend_name, "null") && 0 != strcmp(backend_name, "cpu"))
+		{
+			fprintf(stderr, "headless: unknown backend \"%s\"\n", backend_name);
+			return 1;
+		}
+
+		if (NULL != output_path || reference_sample_count > 0U || NULL != sequence_prefix)
+		{
+			fprintf(stderr, "headless: \"--output\", \"--reference\" and \"--sequence\" are not supported by \"--backend\"\n");
+			return 1;
+		}
+
+		ThreadPool thread_pool;
+		thread_pool.Init(thread_count);
+		int const result = headless_demo_main(backend_name, &thread_pool, width, height, frame_count, frame_graph_pass_count, resize_step_count, shared_framebuffer_name, stream_path, input_event_rate, settings, demo_settings);
+		thread_pool.Destroy();
+		return result;
+	}
+
+	ThreadPool thread_pool;
+	thread_pool.Init(thread_count);
+
+	std::vector<float> triangle_vertices;
+	software_renderer_scene_t scene;
+	headless_build_demo_scene(triangle_vertices, scene);
+
+	SoftwareRenderer renderer;
+	renderer.Init(width, height);
+	renderer.SetScene(scene);
+
+	printf("resolution: %u x %u, threads: %u\n", width, height, thread_pool.GetThreadCount());
+	printf("bvh: %u triangles, %u nodes, max depth %u\n", scene.triangle_count, renderer.GetBVH().GetNodeCount(), renderer.GetBVH().GetMaxDepth());
+	printf("shadow: samples [%u, %u], target error %g, denoise %s\n", settings.min_sample_count, settings.max_sample_count, settings.target_standard_error, settings.denoise ? "on" : "off");
+
+	software_renderer_statistics_t average_statistics;
+	memset(&average_statistics, 0, sizeof(software_renderer_statistics_t));
+	software_renderer_statistics_t statistics;
+
+	// the sequence: the frames along the camera path are written by the writer threads while the next frame renders
+	ImageSequenceWriter sequence_writer;
+	if (NULL != sequence_prefix)
+	{
+		sequence_writer.Init(sequence_prefix, sequence_format, width, height, sequence_queue_length, sequence_writer_count);
+	}
+
+	std::chrono::steady_clock::time_point const sequence_begin = std::chrono::steady_clock::now();
+	for (uint32_t frame_index = 0U; frame_index < frame_count; ++frame_index)
+	{
+		if (NULL != sequence_prefix)
+		{
+			float eye_position[3];
+			float eye_direction[3];
+			headless_camera_path(scene, frame_index, frame_count, eye_position, eye_direction);
+			renderer.SetCamera(eye_position, eye_direction, scene.up_direction);
+		}
+
+		renderer.Render(&thread_pool, settings, frame_index, statistics);
+		average_statistics.primary_milliseconds += statistics.primary_milliseconds / frame_count;
+		average_statistics.shading_milliseconds += statistics.shading_milliseconds / frame_count;
+		average_statistics.shadow_milliseconds += statistics.shadow_milliseconds / frame_count;
+		average_statistics.denoise_milliseconds += statistics.denoise_milliseconds / frame_count;
+		average_statistics.total_milliseconds += statistics.total_milliseconds / frame_count;
+
+		if (NULL != sequence_prefix)
+		{
+			sequence_writer.Write(frame_index, renderer.GetRadiance());
+		}
+	}
+
+	if (NULL != sequence_prefix)
+	{
+		sequence_writer.Flush();
+		double const sequence_milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - sequence_begin).count();
+
+		// the serial estimate: the same frames encoded and written on the render thread after each frame
+		image_sequence_writer_statistics_t const &sequence_statistics = sequence_writer.GetStatistics();
+		printf("sequence: %u frames \"%s*.%s\", %u writers, queue %u; %u written (%u failed), %.1f KB per frame\n",
+			   frame_count,
+			   sequence_prefix,
+			   ImageSequenceWriter::GetExtension(sequence_format),
+			   sequence_writer_count,
+			   sequence_queue_length,
+			   sequence_statistics.written_frame_count,
+			   sequence_statistics.failed_frame_count,
+			   (sequence_statistics.written_frame_count > 0U) ? (static_cast<double>(sequence_statistics.written_byte_count) / 1024.0 / sequence_statistics.written_frame_count) : 0.0);
+		printf("sequence time (ms per frame): wall %.3f against render %.3f; writer encode %.3f, io %.3f (serial estimate %.3f); render thread stalled %.3f in %u frames\n",
+			   sequence_milliseconds / frame_count,
+			   average_statistics.total_milliseconds,
+			   sequence_statistics.encode_milliseconds / frame_count,
+			   sequence_statistics.io_milliseconds / frame_count,
+			   average_statistics.total_milliseconds + (sequence_statistics.encode_milliseconds + sequence_statistics.io_milliseconds) / frame_count,
+			   sequence_statistics.stall_milliseconds / frame_count,
+			   sequence_statistics.stall_count);
+
+		sequence_writer.Destroy();
+	}
+
+	printf("time (ms): primary %.3f, shading %.3f, shadow %.3f, denoise %.3f, total %.3f\n", average_statistics.primary_milliseconds, average_statistics.shading_milliseconds, average_statistics.shadow_milliseconds, average_statistics.denoise_milliseconds, average_statistics.total_milliseconds);
+	printf("light paths (pixels): back face %u, below horizon %u, above horizon %u, straddle (clipped) %u\n", statistics.light_back_face_pixel_count, statistics.horizon_below_pixel_count, statistics.horizon_above_pixel_count, statistics.horizon_straddle_pixel_count);
+	printf("shadow rays: %llu (%.2f per lit pixel, max %u), %.2f Mrays/s\n",
+		   static_cast<unsigned long long>(statistics.shadow_ray_count),
+		   (statistics.lit_pixel_count > 0U) ? (static_cast<double>(statistics.shadow_ray_count) / statistics.lit_pixel_count) : 0.0,
+		   statistics.max_pixel_sample_count,
+		   (statistics.shadow_milliseconds > 0.0) ? (static_cast<double>(statistics.shadow_ray_count) / (statistics.shadow_milliseconds * 1000.0)) : 0.0);
+	printf("pixels: %u lit, %u penumbra; tiles: %u of %u denoised\n", statistics.lit_pixel_count, statistics.penumbra_pixel_count, statistics.denoised_tile_count, statistics.tile_count);
+
+	// copy before the reference overwrites the renderer
+	std::vector<float> radiance(renderer.GetRadiance(), renderer.GetRadiance() + static_cast<size_t>(width) * height * 3U);
+
+	if (tonemap_report)
+	{
+		headless_tonemap_report(&thread_pool, width, height, &radiance[0]);
+	}
+
+	if (auto_exposure_report)
+	{
+		headless_auto_exposure_report(&thread_pool, width, height, &radiance[0], average_statistics.total_milliseconds);
+	}
+
+	if (reference_sample_count > 0U)
+	{
+		software_renderer_shadow_settings_t reference_settings;
+		reference_settings.min_sample_count = reference_sample_count;
+		reference_settings.max_sample_count = reference_sample_count;
+		reference_settings.target_standard_error = 0.0f;
+		reference_settings.denoise = false;
+
+		software_renderer_statistics_t reference_statistics;
+		renderer.Render(&thread_pool, reference_settings, 0XFFFFFFFFU, reference_statistics);
+
+		float const *const reference = renderer.GetRadiance();
+		double sum_squared_error = 0.0;
+		for (size_t component_index = 0U; component_index < radiance.size(); ++component_index)
+		{
+			double const error = static_cast<double>(radiance[component_index]) - static_cast<double>(reference[component_index]);
+			sum_squared_error += error * error;
+		}
+
+		printf("reference: %u spp in %.3f ms, RMSE %.6f\n", reference_sample_count, reference_statistics.total_milliseconds, std::sqrt(sum_squared_error / static_cast<double>(radiance.size())));
+	}
+
+	if (NULL != output_path)
+	{
+		if (!headless_write_pfm(output_path, width, height, &radiance[0]))
+		{
+			fprintf(stderr, "headless: failed to write \"%s\"\n", output_path);
+			renderer.Destroy();
+			thread_pool.Destroy();
+			return 1;
+		}
+	}
+
+	renderer.Destroy();
+	thread_pool.Destroy();
+	return 0;
+}
+
+#if !defined(_WIN32)
+int main(int argc, char *argv[])
+{
+	return headless_main(argc, argv);
+}
+
+// The heap allocations are counted, such that the steady state frame can be verified to never allocate (see "cpu/frame_arena.h").
+// The replacement is process wide: every "new" of the executable which links this file (including the standard library and the other threads) is counted and served by the "malloc".
+static std::atomic<uint64_t> g_headless_heap_allocation_count(0U);
+
+void *operator new(size_t size)
+{
+	g_headless_heap_allocation_count.fetch_add(1U, std::memory_order_relaxed);
+	void *memory = malloc((size > 0U) ? size : 1U);
+	if (NULL == memory)
+	{
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+void *operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void *memory) noexcept
+{
+	free(memory);
+}
+
+void operator delete[](void *memory) noexcept
+{
+	free(memory);
+}
+
+// the sized deallocation (C++14) is called instead of the unsized one when the size is known
+void operator delete(void *memory, size_t) noexcept
+{
+	free(memory);
+}
+
+void operator delete[](void *memory, size_t) noexcept
+{
+	free(memory);
+}
+
+#if defined(__cpp_aligned_new)
+// the over-aligned types (C++17)
+void *operator new(size_t size, std::align_val_t alignment)
+{
+	g_headless_heap_allocation_count.fetch_add(1U, std::memory_order_relaxed);
+	void *memory = NULL;
+	if (0 != posix_memalign(&memory, std::max(static_cast<size_t>(alignment), sizeof(void *)), (size > 0U) ? size : 1U))
+	{
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+void *operator new[](size_t size, std::align_val_t alignment)
+{
+	return operator new(size, alignment);
+}
+
+void operator delete(void *memory, std::align_val_t) noexcept
+{
+	free(memory);
+}
+
+void operator delete[](void *memory, std::align_val_t) noexcept
+{
+	free(memory);
+}
+
+void operator delete(void *memory, size_t, std::align_val_t) noexcept
+{
+	free(memory);
+}
+
+void operator delete[](void *memory, size_t, std::align_val_t) noexcept
+{
+	free(memory);
+}
+#endif
+
+static inline uint64_t headless_heap_allocation_count()
+{
+	return g_headless_heap_allocation_count.load(std::memory_order_relaxed);
+}
+#else
+static inline uint64_t headless_heap_allocation_count()
+{
+	return 0U;
+}
+#endif
+
+static int headless_demo_main(char const *backend_name, ThreadPool *thread_pool, uint32_t width, uint32_t height, uint32_t frame_count, uint32_t frame_graph_pass_count, uint32_t resize_step_count, char const *shared_framebuffer_name, char const *stream_path, uint32_t input_event_rate, software_renderer_shadow_settings_t const &settings, demo_settings_t const &demo_settings)
+{
+	RenderBackendNull render_backend_null;
+	RenderBackendCPU render_backend_cpu;
+	RenderBackend *wrapped_render_backend = NULL;
+	if (0 == strcmp(backend_name, "null"))
+	{
+		render_backend_null.Init(width, height);
+		wrapped_render_backend = &render_backend_null;
+	}
+	else
+	{
+		render_backend_cpu.Init(thread_pool, width, height, settings);
+		wrapped_render_backend = &render_backend_cpu;
+	}
+
+	// the viewer (or the relay) may start after the renderer
+	FrameStream frame_stream;
+	TileDeltaEncoder tile_delta_encoder;
+	headless_stream_statistics_t stream_statistics = {};
+	bool stream_connected = false;
+	if (NULL != stream_path)
+	{
+		frame_stream.Init();
+		for (uint32_t attempt_index = 0U; attempt_index < 500U && !stream_connected; ++attempt_index)
+		{
+			stream_connected = frame_stream.Connect(stream_path);
+			if (!stream_connected)
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			}
+		}
+		if (!stream_connected)
+		{
+			fprintf(stderr, "headless: failed to connect to the stream \"%s\"\n", stream_path);
+			frame_stream.Destroy();
+			render_backend_cpu.Destroy();
+			return 1;
+		}
+		tile_delta_encoder.Init(thread_pool->GetThreadCount(), width, height);
+		printf("stream: \"%s\", %u x %u tiles\n", stream_path, TILE_DELTA_TILE_SIZE, TILE_DELTA_TILE_SIZE);
+	}
+
+	// the slots also fit the sizes of the "--resize"
+	SharedFramebuffer shared_framebuffer;
+	if (NULL != shared_framebuffer_name)
+	{
+		if (!shared_framebuffer.Create(shared_framebuffer_name, width + 7U * resize_step_count, height + 5U * resize_step_count, 3U))
+		{
+			fprintf(stderr, "headless: failed to create the shared framebuffer \"%s\"\n", shared_framebuffer_name);
+			render_backend_cpu.Destroy();
+			return 1;
+		}
+		render_backend_cpu.SetSharedFramebuffer(&shared_framebuffer);
+		printf("shared framebuffer: \"%s\", %u slots\n", shared_framebuffer_name, shared_framebuffer.GetSlotCount());
+	}
+
+	// the same layer as the window (see "render_main.cpp"), such that the null backend counts the commands which would reach the device
+	RenderBackendStateTracker render_backend_state_tracker;
+	render_backend_state_tracker.Init(wrapped_render_backend);
+	RenderBackend *render_backend = &render_backend_state_tracker;
+
+	printf("backend: %s, backbuffer: %u x %u, threads: %u, frames: %u\n", render_backend->GetName(), render_backend->GetBackbufferWidth(), render_backend->GetBackbufferHeight(), thread_pool->GetThreadCount(), frame_count);
+
+	class Demo demo;
+	demo.Init(render_backend, demo_settings);
+
+	printf("shading: %s, overdraw layers: %u, depth pre-pass: %s, checkerboard: %s, auto exposure: %s, dynamic resolution: %s\n", (DEMO_SHADING_MODE_DEFERRED == demo.GetSettings().shading_mode) ? "deferred" : "forward", demo.GetSettings().overdraw_layer_count, demo.GetSettings().depth_prepass ? "on" : "off", demo.GetSettings().checkerboard_shading ? "on" : "off", demo.GetSettings().auto_exposure ? "on" : "off", demo.GetSettings().dynamic_resolution ? "on" : "off");
+
+	// the commands of the "Init" are excluded from the per frame counts
+	render_backend_null_statistics_t const init_statistics = render_backend_null.GetStatistics();
+	render_backend_state_tracker_statistics_t const init_state_tracker_statistics = render_backend_state_tracker.GetStatistics();
+
+	// The process CPU time includes the worker threads, such that "cpu / wall" is the average parallelism.
+	double wall_milliseconds = 0.0;
+	double min_wall_milliseconds = INFINITY;
+	double max_wall_milliseconds = 0.0;
+	// the first frame creates the lazily allocated resources (e.g. the G-buffer of the CPU backend)
+	uint64_t first_frame_heap_allocation_count = 0U;
+	uint64_t steady_state_heap_allocation_count = 0U;
+	// the dynamic resolution: the frames rendered at each level, and the frames of which the device time exceeds the budget
+	uint32_t dynamic_resolution_level_frame_counts[DYNAMIC_RESOLUTION_LEVEL_COUNT] = {};
+	uint32_t over_budget_frame_count = 0U;
+	uint32_t measured_frame_count = 0U;
+
+	// the input events: the latency from the push (the window thread) to the end of the frame which applied the event
+	InputEventQueue input_event_queue;
+	std::atomic<bool> input_producer_quit(false);
+	uint64_t input_pushed_event_count = 0U;
+	std::thread input_producer;
+	uint64_t input_applied_event_count = 0U;
+	uint64_t input_out_of_order_event_count = 0U;
+	uint64_t input_last_timestamp = 0U;
+	uint64_t input_dropped_event_count = 0U;
+	uint32_t input_max_frame_event_count = 0U;
+	double input_latency_milliseconds = 0.0;
+	double input_max_latency_milliseconds = 0.0;
+	std::chrono::steady_clock::time_point input_previous_frame_time = std::chrono::steady_clock::now();
+	if (input_event_rate > 0U)
+	{
+		input_event_queue.Init();
+		input_producer = std::thread(headless_input_producer_main, &input_event_queue, input_event_rate, &input_producer_quit, &input_pushed_event_count);
+	}
+
+	clock_t const cpu_begin = clock();
+	for (uint32_t frame_index = 0U; frame_index < frame_count; ++frame_index)
+	{
+		uint64_t const heap_allocation_begin = headless_heap_allocation_count();
+		std::chrono::steady_clock::time_point const frame_begin = std::chrono::steady_clock::now();
+
+		// the same as the "render_main": the events since the last frame are applied, and the camera moves by the time since the last frame, before the "Tick"
+		uint32_t frame_event_count = 0U;
+		uint64_t frame_timestamp_sum = 0U;
+		uint64_t frame_oldest_timestamp = 0U;
+		if (input_event_rate > 0U)
+		{
+			input_event_t event;
+			while (input_event_queue.Pop(&event))
+			{
+				g_camera_controller.ApplyInputEvent(event);
+
+				input_out_of_order_event_count += (event.timestamp < input_last_timestamp) ? 1U : 0U;
+				input_last_timestamp = event.timestamp;
+				frame_oldest_timestamp = (0U == frame_event_count) ? event.timestamp : frame_oldest_timestamp;
+				frame_timestamp_sum += event.timestamp;
+				++frame_event_count;
+			}
+
+			uint64_t const dropped_event_count = input_event_queue.GetDroppedEventCount();
+			if (dropped_event_count != input_dropped_event_count)
+			{
+				input_dropped_event_count = dropped_event_count;
+				g_camera_controller.ReleaseKeys();
+			}
+			uint32_t held_keys;
+			if (input_event_queue.ReconcileHeldKeys(&held_keys))
+			{
+				g_camera_controller.SetHeldKeys(held_keys);
+			}
+
+			g_camera_controller.Update(std::chrono::duration<float>(frame_begin - input_previous_frame_time).count());
+			input_previous_frame_time = frame_begin;
+		}
+
+		demo.Tick(render_backend);
+
+		if (frame_event_count > 0U)
+		{
+			uint64_t const frame_end_timestamp = InputEventTimestamp();
+			input_latency_milliseconds += static_cast<double>(frame_end_timestamp * frame_event_count - frame_timestamp_sum) / 1000000.0;
+			input_max_latency_milliseconds = std::max(input_max_latency_milliseconds, static_cast<double>(frame_end_timestamp - frame_oldest_timestamp) / 1000000.0);
+			input_applied_event_count += frame_event_count;
+			input_max_frame_event_count = std::max(input_max_frame_event_count, frame_event_count);
+		}
+		double const frame_milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frame_begin).count();
+		uint64_t const heap_allocation_count = headless_heap_allocation_count() - heap_allocation_begin;
+		((0U == frame_index) ? first_frame_heap_allocation_count : steady_state_heap_allocation_count) += heap_allocation_count;
+
+		if (stream_connected)
+		{
+			stream_connected = headless_stream_frame(thread_pool, &render_backend_cpu, frame_index, &tile_delta_encoder, &frame_stream, &stream_statistics);
+		}
+
+		wall_milliseconds += frame_milliseconds;
+		min_wall_milliseconds = std::min(min_wall_milliseconds, frame_milliseconds);
+		max_wall_milliseconds = std::max(max_wall_milliseconds, frame_milliseconds);
+
+		++dynamic_resolution_level_frame_counts[demo.GetDynamicResolution().GetLevel()];
+		float const gpu_frame_milliseconds = render_backend->GetGPUFrameTime();
+		if (gpu_frame_milliseconds >= 0.0f)
+		{
+			++measured_frame_count;
+			over_budget_frame_count += (gpu_frame_milliseconds > demo.GetSettings().frame_time_budget_ms) ? 1U : 0U;
+		}
+	}
+	double const cpu_milliseconds = static_cast<double>(clock() - cpu_begin) * 1000.0 / static_cast<double>(CLOCKS_PER_SEC);
+
+	if (input_event_rate > 0U)
+	{
+		input_producer_quit.store(true, std::memory_order_relaxed);
+		input_producer.join();
+
+		// the events pushed after the last frame are NOT applied
+		printf("input events: %llu pushed (%u per second), %llu applied, %llu dropped, %llu out of order, up to %u per frame; event to frame latency %.4f ms (max %.4f ms)\n",
+			   static_cast<unsigned long long>(input_pushed_event_count),
+			   input_event_rate,
+			   static_cast<unsigned long long>(input_applied_event_count),
+			   static_cast<unsigned long long>(input_event_queue.GetDroppedEventCount()),
+			   static_cast<unsigned long long>(input_out_of_order_event_count),
+			   input_max_frame_event_count,
+			   (input_applied_event_count > 0U) ? (input_latency_milliseconds / static_cast<double>(input_applied_event_count)) : 0.0,
+			   input_max_latency_milliseconds);
+
+		input_event_queue.Destroy();
+	}
+
+	printf("frame time (ms): wall %.4f (min %.4f, max %.4f), cpu %.4f; %.1f frames/s\n",
+		   wall_milliseconds / frame_count,
+		   min_wall_milliseconds,
+		   max_wall_milliseconds,
+		   cpu_milliseconds / frame_count,
+		   (wall_milliseconds > 0.0) ? (1000.0 * frame_count / wall_milliseconds) : 0.0);
+
+	if (demo.GetSettings().dynamic_resolution)
+	{
+		DynamicResolution const &dynamic_resolution = demo.GetDynamicResolution();
+		printf("dynamic resolution: budget %.2f ms, last frame %u x %u (scale %.4f), smoothed device frame time %.3f ms, %u level changes, %u of %u measured frames over the budget\n",
+			   demo.GetSettings().frame_time_budget_ms,
+			   demo.GetRenderWidth(),
+			   demo.GetRenderHeight(),
+			   dynamic_resolution.GetScale(),
+			   dynamic_resolution.GetSmoothedFrameTime(),
+			   dynamic_resolution.GetLevelChangeCount(),
+			   over_budget_frame_count,
+			   measured_frame_count);
+		printf("dynamic resolution frames per scale:");
+		for (uint32_t level = 0U; level < DYNAMIC_RESOLUTION_LEVEL_COUNT; ++level)
+		{
+			printf(" %.4f: %u%s", DYNAMIC_RESOLUTION_MIN_SCALE + (1.0f - DYNAMIC_RESOLUTION_MIN_SCALE) * (static_cast<float>(level) / static_cast<float>(DYNAMIC_RESOLUTION_LEVEL_COUNT - 1U)), dynamic_resolution_level_frame_counts[level], ((level + 1U) < DYNAMIC_RESOLUTION_LEVEL_COUNT) ? "," : "\n");
+		}
+	}
+
+#if !defined(_WIN32)
+	printf("heap allocations: first frame %llu, steady state %llu (over %u frames)\n",
+		   static_cast<unsigned long long>(first_frame_heap_allocation_count),
+		   static_cast<unsigned long long>(steady_state_heap_allocation_count),
+		   (frame_count > 0U) ? (frame_count - 1U) : 0U);
+#endif
+	{
+		frame_arena_statistics_t const &statistics = demo.GetFrameArena().GetStatistics();
+		printf("frame arena: last frame %u allocations (%llu bytes), high water %llu bytes, %llu overflows, %llu grows\n",
+			   statistics.allocation_count,
+			   static_cast<unsigned long long>(statistics.byte_count),
+			   static_cast<unsigned long long>(statistics.high_water_byte_count),
+			   static_cast<unsigned long long>(statistics.overflow_allocation_count),
+			   static_cast<unsigned long long>(statistics.grow_count));
+	}
+
+	{
+		render_backend_state_tracker_statistics_t const &statistics = render_backend_state_tracker.GetStatistics();
+		double const frame_count_double = static_cast<double>(frame_count);
+
+		printf("state tracker: %u pipelines, %llu pipeline cache hits\n",
+			   statistics.pipeline_count,
+			   static_cast<unsigned long long>(statistics.pipeline_cache_hit_count));
+		printf("state tracker per frame (elided / issued): %.2f / %.2f pipelines, %.2f / %.2f vertex buffers, %.2f / %.2f constant buffers, %.2f / %.2f textures, %.2f / %.2f samplers\n",
+			   static_cast<double>(statistics.elided_set_pipeline_count - init_state_tracker_statistics.elided_set_pipeline_count) / frame_count_double,
+			   static_cast<double>(statistics.set_pipeline_count - init_state_tracker_statistics.set_pipeline_count) / frame_count_double,
+			   static_cast<double>(statistics.elided_set_vertex_buffer_count - init_state_tracker_statistics.elided_set_vertex_buffer_count) / frame_count_double,
+			   static_cast<double>(statistics.set_vertex_buffer_count - init_state_tracker_statistics.set_vertex_buffer_count) / frame_count_double,
+			   static_cast<double>(statistics.elided_set_constant_buffer_count - init_state_tracker_statistics.elided_set_constant_buffer_count) / frame_count_double,
+			   static_cast<double>(statistics.set_constant_buffer_count - init_state_tracker_statistics.set_constant_buffer_count) / frame_count_double,
+			   static_cast<double>(statistics.elided_set_texture_count - init_state_tracker_statistics.elided_set_texture_count) / frame_count_double,
+			   static_cast<double>(statistics.set_texture_count - init_state_tracker_statistics.set_texture_count) / frame_count_double,
+			   static_cast<double>(statistics.elided_set_sampler_count - init_state_tracker_statistics.elided_set_sampler_count) / frame_count_double,
+			   static_cast<double>(statistics.set_sampler_count - init_state_tracker_statistics.set_sampler_count) / frame_count_double);
+	}
+
+	if (wrapped_render_backend == &render_backend_null)
+	{
+		render_backend_null_statistics_t const &statistics = render_backend_null.GetStatistics();
+		double const frame_count_double = static_cast<double>(frame_count);
+
+		printf("init: %u buffers, %u textures, %u samplers, %u pipelines, %llu bytes\n",
+			   init_statistics.buffer_count,
+			   init_statistics.texture_count,
+			   init_statistics.sampler_count,
+			   init_statistics.pipeline_count,
+			   static_cast<unsigned long long>(init_statistics.create_byte_count));
+		printf("per frame: %.2f passes, %.2f draws (%.2f vertices), %.2f pipelines, %.2f vertex buffers, %.2f constant buffers, %.2f textures, %.2f samplers\n",
+			   static_cast<double>(statistics.pass_count - init_statistics.pass_count) / frame_count_double,
+			   static_cast<double>(statistics.draw_count - init_statistics.draw_count) / frame_count_double,
+			   static_cast<double>(statistics.vertex_count - init_statistics.vertex_count) / frame_count_double,
+			   static_cast<double>(statistics.set_pipeline_count - init_statistics.set_pipeline_count) / frame_count_double,
+			   static_cast<double>(statistics.set_vertex_buffer_count - init_statistics.set_vertex_buffer_count) / frame_count_double,
+			   static_cast<double>(statistics.set_constant_buffer_count - init_statistics.set_constant_buffer_count) / frame_count_double,
+			   static_cast<double>(statistics.set_texture_count - init_statistics.set_texture_count) / frame_count_double,
+			   static_cast<double>(statistics.set_sampler_count - init_statistics.set_sampler_count) / frame_count_double);
+		// saved: against uploading all the constant buffers every frame
+		double const uploaded_byte_count = static_cast<double>(statistics.update_buffer_byte_count - init_statistics.update_buffer_byte_count) / frame_count_double;
+		printf("per frame: %.2f buffer updates, %.1f bytes uploaded, %.1f bytes saved (of %u bytes of the constant buffers), %.2f presents\n",
+			   static_cast<double>(statistics.update_buffer_count - init_statistics.update_buffer_count) / frame_count_double,
+			   uploaded_byte_count,
+			   std::max(static_cast<double>(statistics.constant_buffer_byte_count) - uploaded_byte_count, 0.0),
+			   statistics.constant_buffer_byte_count,
+			   static_cast<double>(statistics.present_count - init_statistics.present_count) / frame_count_double);
+	}
+	else
+	{
+		software_renderer_statistics_t const &statistics = render_backend_cpu.GetStatistics();
+		printf("software renderer (last frame, ms): primary %.3f, shading %.3f, shadow %.3f, denoise %.3f, total %.3f\n", statistics.primary_milliseconds, statistics.shading_milliseconds, statistics.shadow_milliseconds, statistics.denoise_milliseconds, statistics.total_milliseconds);
+		printf("software renderer (last frame): %u pixels shaded, %u pixels rejected by the depth pre-pass, %u pixels skipped by the checkerboard\n",
+			   statistics.light_back_face_pixel_count + statistics.horizon_below_pixel_count + statistics.horizon_above_pixel_count + statistics.horizon_straddle_pixel_count,
+			   statistics.depth_rejected_pixel_count,
+			   statistics.checkerboard_skipped_pixel_count);
+	}
+
+	{
+		frame_graph_statistics_t const &statistics = demo.GetFrameGraph().GetStatistics();
+		printf("frame graph: %u passes (%u culled), %u transient textures on %u physical textures, %u barriers\n",
+			   statistics.pass_count,
+			   statistics.culled_pass_count,
+			   statistics.transient_texture_count,
+			   statistics.physical_texture_count,
+			   statistics.barrier_count);
+	}
+
+	// the live resize: the drag of the border is simulated by the size which changes every frame, followed by the frames at the final size
+	if (resize_step_count > 0U)
+	{
+		double resize_milliseconds = 0.0;
+		double max_resize_milliseconds = 0.0;
+		uint32_t resize_created_texture_count = 0U;
+		uint64_t resize_heap_allocation_count = 0U;
+		for (uint32_t step_index = 0U; step_index < resize_step_count; ++step_index)
+		{
+			uint64_t const heap_allocation_begin = headless_heap_allocation_count();
+			std::chrono::steady_clock::time_point const resize_begin = std::chrono::steady_clock::now();
+			demo.Resize(render_backend, width + 7U * (step_index + 1U), height + 5U * (step_index + 1U));
+			demo.Tick(render_backend);
+			double const step_milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - resize_begin).count();
+			resize_heap_allocation_count += (headless_heap_allocation_count() - heap_allocation_begin);
+
+			resize_milliseconds += step_milliseconds;
+			max_resize_milliseconds = std::max(max_resize_milliseconds, step_milliseconds);
+			resize_created_texture_count += demo.GetFrameGraph().GetStatistics().created_texture_count;
+
+			if (stream_connected)
+			{
+				stream_connected = headless_stream_frame(thread_pool, &render_backend_cpu, frame_count + step_index, &tile_delta_encoder, &frame_stream, &stream_statistics);
+			}
+		}
+
+		// the render resolution settles to the exact size
+		uint32_t const settle_frame_count = 16U;
+		uint32_t settle_created_texture_count = 0U;
+		for (uint32_t frame_index = 0U; frame_index < settle_frame_count; ++frame_index)
+		{
+			demo.Tick(render_backend);
+			settle_created_texture_count += demo.GetFrameGraph().GetStatistics().created_texture_count;
+
+			if (stream_connected)
+			{
+				stream_connected = headless_stream_frame(thread_pool, &render_backend_cpu, frame_count + resize_step_count + frame_index, &tile_delta_encoder, &frame_stream, &stream_statistics);
+			}
+		}
+
+		printf("live resize: %u steps to %u x %u, resize + frame (ms) %.4f (max %.4f) against the steady frame %.4f; %.2f frame graph textures created per step, %u created by the %u frames after the drag (render %u x %u)\n",
+			   resize_step_count,
+			   render_backend->GetBackbufferWidth(),
+			   render_backend->GetBackbufferHeight(),
+			   resize_milliseconds / resize_step_count,
+			   max_resize_milliseconds,
+			   wall_milliseconds / frame_count,
+			   static_cast<double>(resize_created_texture_count) / static_cast<double>(resize_step_count),
+			   settle_created_texture_count,
+			   settle_frame_count,
+			   demo.GetRenderWidth(),
+			   demo.GetRenderHeight());
+#if !defined(_WIN32)
+		printf("live resize heap allocations: %.2f per step\n", static_cast<double>(resize_heap_allocation_count) / static_cast<double>(resize_step_count));
+#endif
+	}
+
+	if (NULL != stream_path)
+	{
+		double const stream_frame_count = static_cast<double>(std::max(stream_statistics.frame_count, 1U));
+		uint64_t const stream_byte_count = frame_stream.GetByteCount();
+		printf("stream: %u frames sent%s, %.2f of %.2f tiles dirty per frame, %.1f bytes per frame against %.1f raw bytes (%.2f%%), encode %.4f ms, send %.4f ms per frame\n",
+			   stream_statistics.frame_count,
+			   stream_connected ? "" : " (the viewer has closed the connection)",
+			   static_cast<double>(stream_statistics.dirty_tile_count) / stream_frame_count,
+			   static_cast<double>(stream_statistics.tile_count) / stream_frame_count,
+			   static_cast<double>(stream_byte_count) / stream_frame_count,
+			   static_cast<double>(stream_statistics.raw_byte_count) / stream_frame_count,
+			   (stream_statistics.raw_byte_count > 0U) ? (100.0 * static_cast<double>(stream_byte_count) / static_cast<double>(stream_statistics.raw_byte_count)) : 0.0,
+			   stream_statistics.encode_milliseconds / stream_frame_count,
+			   stream_statistics.send_milliseconds / stream_frame_count);
+		printf("stream: last frame %u x %u, checksum %llu\n",
+			   render_backend->GetBackbufferWidth(),
+			   render_backend->GetBackbufferHeight(),
+			   static_cast<unsigned long long>(headless_frame_checksum(render_backend_cpu.GetBackbuffer(), render_backend->GetBackbufferWidth(), render_backend->GetBackbufferHeight())));
+
+		// the viewer sees the end of the stream
+		tile_delta_encoder.Destroy();
+		frame_stream.Destroy();
+	}
+
+	demo.Destroy(render_backend);
+
+	if (frame_graph_pass_count > 0U)
+	{
+		FrameGraph frame_graph;
+		frame_graph.Init(render_backend);
+
+		double compile_milliseconds = 0.0;
+		double execute_milliseconds = 0.0;
+		uint64_t steady_state_heap_allocation_count = 0U;
+		for (uint32_t frame_index = 0U; frame_index < frame_count; ++frame_index)
+		{
+			uint64_t const heap_allocation_begin = headless_heap_allocation_count();
+
+			std::chrono::steady_clock::time_point const compile_begin = std::chrono::steady_clock::now();
+			headless_build_frame_graph(frame_graph, frame_graph_pass_count, width, height);
+			frame_graph.Compile();
+			std::chrono::steady_clock::time_point const execute_begin = std::chrono::steady_clock::now();
+			frame_graph.Execute();
+			render_backend->Present();
+			std::chrono::steady_clock::time_point const execute_end = std::chrono::steady_clock::now();
+
+			compile_milliseconds += std::chrono::duration<double, std::milli>(execute_begin - compile_begin).count();
+			execute_milliseconds += std::chrono::duration<double, std::milli>(execute_end - execute_begin).count();
+			steady_state_heap_allocation_count += (frame_index > 0U) ? (headless_heap_allocation_count() - heap_allocation_begin) : 0U;
+		}
+
+		frame_graph_statistics_t const &statistics = frame_graph.GetStatistics();
+		printf("frame graph benchmark: %u passes (%u culled), %u transient textures on %u physical textures, %u barriers\n",
+			   statistics.pass_count,
+			   statistics.culled_pass_count,
+			   statistics.transient_texture_count,
+			   statistics.physical_texture_count,
+			   statistics.barrier_count);
+		printf("frame graph benchmark (ms per frame): declare + compile %.4f, execute %.4f; steady state heap allocations %llu\n",
+			   compile_milliseconds / frame_count,
+			   execute_milliseconds / frame_count,
+			   static_cast<unsigned long long>(steady_state_heap_allocation_count));
+
+		if (!headless_frame_graph_load_after_clear(frame_graph, width, height))
+		{
+			fprintf(stderr, "headless: the frame graph culled the writer of the loaded attachment\n");
+			frame_graph.Destroy();
+			render_backend_state_tracker.Destroy();
+			if (wrapped_render_backend == &render_backend_cpu)
+			{
+				render_backend_cpu.Destroy();
+			}
+			return 1;
+		}
+
+		frame_graph.Destroy();
+	}
+
+	render_backend_state_tracker.Destroy();
+
+	if (wrapped_render_backend == &render_backend_cpu)
+	{
+		render_backend_cpu.Destroy();
+	}
+
+	if (NULL != shared_framebuffer_name)
+	{
+		printf("shared framebuffer: %llu frames published\n", static_cast<unsigned long long>(shared_framebuffer.GetPublishedCount()));
+		shared_framebuffer.Destroy();
+	}
+
+	return 0;
+}
+
+static int headless_view_main(char const *shared_framebuffer_name, uint32_t frame_count)
+{
+	// the producer may start after the viewer
+	SharedFramebuffer shared_framebuffer;
+	bool opened = false;
+	for (uint32_t attempt_index = 0U; attempt_index < 500U && !opened; ++attempt_index)
+	{
+		opened = shared_framebuffer.Open(shared_framebuffer_name);
+		if (!opened)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+	}
+	if (!opened)
+	{
+		fprintf(stderr, "headless: failed to open the shared framebuffer \"%s\"\n", shared_framebuffer_name);
+		return 1;
+	}
+
+	printf("view: \"%s\", %u slots\n", shared_framebuffer_name, shared_framebuffer.GetSlotCount());
+
+	uint32_t viewed_frame_count = 0U;
+	uint32_t torn_frame_count = 0U;
+	uint64_t skipped_frame_count = 0U;
+	uint64_t last_published_count = 0U;
+	uint64_t checksum = 0U;
+	double read_milliseconds = 0.0;
+	std::chrono::steady_clock::time_point idle_begin = std::chrono::steady_clock::now();
+	while (viewed_frame_count < frame_count)
+	{
+		shared_framebuffer_frame_t frame;
+		if (!shared_framebuffer.AcquireLatest(&frame) || frame.published_count == last_published_count)
+		{
+			// the producer has exited
+			if (std::chrono::steady_clock::now() - idle_begin > std::chrono::seconds(5))
+			{
+				break;
+			}
+			std::this_thread::yield();
+			continue;
+		}
+
+		std::chrono::steady_clock::time_point const read_begin = std::chrono::steady_clock::now();
+		uint64_t frame_checksum = 0U;
+		for (uint32_t y = 0U; y < frame.height; ++y)
+		{
+			uint8_t const *const row = frame.pixels + static_cast<size_t>(frame.stride) * y;
+			for (uint32_t x = 0U; x < (frame.width * 4U); ++x)
+			{
+				frame_checksum += row[x];
+			}
+		}
+		read_milliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - read_begin).count();
+
+		if (!shared_framebuffer.Validate(frame))
+		{
+			++torn_frame_count;
+			continue;
+		}
+
+		skipped_frame_count += (last_published_count > 0U) ? (frame.published_count - last_published_count - 1U) : 0U;
+		last_published_count = frame.published_count;
+		checksum += frame_checksum;
+		++viewed_frame_count;
+		idle_begin = std::chrono::steady_clock::now();
+	}
+
+	printf("view: %u frames viewed in place (%.4f ms per frame), %llu frames skipped, %u torn reads discarded, checksum %llu\n",
+		   viewed_frame_count,
+		   (viewed_frame_count > 0U) ? (read_milliseconds / viewed_frame_count) : 0.0,
+		   static_cast<unsigned long long>(skipped_frame_count),
+		   torn_frame_count,
+		   static_cast<unsigned long long>(checksum));
+
+	shared_framebuffer.Destroy();
+	return 0;
+}
+
+static void headless_input_producer_main(InputEventQueue *input_event_queue, uint32_t event_rate, std::atomic<bool> const *quit, uint64_t *pushed_event_count)
+{
+	// the keys are held in turn such that the camera returns to about where it started, the mouse circles around the center of the client area
+	static INPUT_KEY const keys[4] = {INPUT_KEY_FORWARD, INPUT_KEY_LEFT, INPUT_KEY_BACK, INPUT_KEY_RIGHT};
+
+	std::chrono::steady_clock::duration const event_interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / static_cast<double>(event_rate)));
+	std::chrono::steady_clock::time_point next_event_time = std::chrono::steady_clock::now();
+
+	uint64_t event_index = 0U;
+	while (!quit->load(std::memory_order_relaxed))
+	{
+		input_event_t event;
+		if (0U == (event_index % 8U))
+		{
+			event.type = (0U == ((event_index / 8U) % 2U)) ? INPUT_EVENT_TYPE_KEY_DOWN : INPUT_EVENT_TYPE_KEY_UP;
+			event.key = keys[(event_index / 16U) % 4U];
+			event.hold = 0U;
+			event.x = 0.0f;
+			event.y = 0.0f;
+		}
+		else
+		{
+			float const angle = 0.05f * static_cast<float>(event_index);
+			event.type = INPUT_EVENT_TYPE_MOUSE_MOVE;
+			event.key = INPUT_KEY_COUNT;
+			event.hold = 1U;
+			event.x = 0.5f + 0.01f * std::cos(angle);
+			event.y = 0.5f + 0.01f * std::sin(angle);
+		}
+		event.timestamp = InputEventTimestamp();
+		input_event_queue->Push(event);
+		++event_index;
+
+		next_event_time += event_interval;
+		std::this_thread::sleep_until(next_event_time);
+	}
+
+	(*pushed_event_count) = event_index;
+}
+
+static int headless_input_flood_main(uint32_t flood_count)
+{
+	InputEventQueue input_event_queue;
+	input_event_queue.Init();
+
+	CameraController camera_controller;
+	camera_controller.Init(DirectX::XMFLOAT3(0.0f, 6.0f, -0.5f), DirectX::XMFLOAT3(0.0f, 0.0f, 1.0f), DirectX::XMFLOAT3(0.0f, 1.0f, 0.0f));
+
+	std::atomic<bool> producer_done(false);
+	std::thread producer(headless_input_flood_producer_main, &input_event_queue, flood_count, &producer_done);
+
+	uint64_t applied_event_count = 0U;
+	uint64_t released_dropped_event_count = 0U;
+	uint32_t released_frame_count = 0U;
+	uint32_t reconciled_frame_count = 0U;
+	uint32_t held_frame_count = 0U;
+	uint32_t frame_count = 0U;
+	bool last_frame = false;
+	while (!last_frame)
+	{
+		// every event is pushed before the "done", the last frame drains all of them
+		last_frame = producer_done.load(std::memory_order_acquire);
+
+		input_event_t event;
+		while (input_event_queue.Pop(&event))
+		{
+			camera_controller.ApplyInputEvent(event);
+			++applied_event_count;
+		}
+
+		uint64_t const dropped_event_count = input_event_queue.GetDroppedEventCount();
+		if (dropped_event_count != released_dropped_event_count)
+		{
+			released_dropped_event_count = dropped_event_count;
+			camera_controller.ReleaseKeys();
+			++released_frame_count;
+		}
+		uint32_t held_keys;
+		if (input_event_queue.ReconcileHeldKeys(&held_keys))
+		{
+			camera_controller.SetHeldKeys(held_keys);
+			++reconciled_frame_count;
+		}
+
+		camera_controller.Update(1.0f / 60.0f);
+		held_frame_count += (0U != camera_controller.GetHeldKeys()) ? 1U : 0U;
+		++frame_count;
+
+		// the frame is much slower than the flood
+		if (!last_frame)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(2));
+		}
+	}
+	producer.join();
+
+	uint64_t const dropped_event_count = input_event_queue.GetDroppedEventCount();
+	uint32_t const final_held_keys = camera_controller.GetHeldKeys();
+	printf("input flood: %u mouse moves between each KEY_DOWN and KEY_UP of %u keys; %u frames, %llu events applied, %llu dropped, released in %u frames, reconciled in %u frames, keys held in %u frames, held keys after the last frame 0X%X\n",
+		   flood_count,
+		   static_cast<uint32_t>(INPUT_KEY_COUNT),
+		   frame_count,
+		   static_cast<unsigned long long>(applied_event_count),
+		   static_cast<unsigned long long>(dropped_event_count),
+		   released_frame_count,
+		   reconciled_frame_count,
+		   held_frame_count,
+		   final_held_keys);
+
+	input_event_queue.Destroy();
+
+	if (0U == dropped_event_count)
+	{
+		fprintf(stderr, "headless: the input event queue is never full, increase the \"--input-flood\"\n");
+		return 1;
+	}
+
+	if (0U != final_held_keys)
+	{
+		fprintf(stderr, "headless: the key is still held after its KEY_UP\n");
+		return 1;
+	}
+
+	return 0;
+}
+
+static void headless_input_flood_producer_main(InputEventQueue *input_event_queue, uint32_t flood_count, std::atomic<bool> *done)
+{
+	uint64_t event_index = 0U;
+	for (uint32_t key = 0U; key < INPUT_KEY_COUNT; ++key)
+	{
+		// the KEY_DOWN (right after the flood of the last key, the queue is full), the key is held over a few frames, and the KEY_UP right after the flood
+		headless_input_flood_push_key(input_event_queue, INPUT_EVENT_TYPE_KEY_DOWN, key);
+		headless_input_flood_push_mouse_moves(input_event_queue, flood_count, &event_index);
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		headless_input_flood_push_mouse_moves(input_event_queue, flood_count, &event_index);
+		headless_input_flood_push_key(input_event_queue, INPUT_EVENT_TYPE_KEY_UP, key);
+		headless_input_flood_push_mouse_moves(input_event_queue, flood_count, &event_index);
+	}
+
+	// the last position, as the timer of the window thread flushes it
+	while (!input_event_queue->Flush())
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	done->store(true, std::memory_order_release);
+}
+
+static void headless_input_flood_push_key(InputEventQueue *input_event_queue, uint32_t type, uint32_t key)
+{
+	input_event_t event;
+	event.type = type;
+	event.key = key;
+	event.hold = 0U;
+	event.x = 0.0f;
+	event.y = 0.0f;
+	event.timestamp = InputEventTimestamp();
+	input_event_queue->Push(event);
+}
+
+static void headless_input_flood_push_mouse_moves(InputEventQueue *input_event_queue, uint32_t move_count, uint64_t *event_index)
+{
+	for (uint32_t move_index = 0U; move_index < move_count; ++move_index)
+	{
+		// the right button drag around the center of the client area
+		float const angle = 0.05f * static_cast<float>((*event_index)++);
+		input_event_t event;
+		event.type = INPUT_EVENT_TYPE_MOUSE_MOVE;
+		event.key = INPUT_KEY_COUNT;
+		event.hold = 1U;
+		event.x = 0.5f + 0.01f * std::cos(angle);
+		event.y = 0.5f + 0.01f * std::sin(angle);
+		event.timestamp = InputEventTimestamp();
+		input_event_queue->Push(event);
+	}
+}
+
+static bool headless_stream_frame(ThreadPool *thread_pool, RenderBackendCPU const *render_backend_cpu, uint32_t frame_index, TileDeltaEncoder *tile_delta_encoder, FrameStream *frame_stream, headless_stream_statistics_t *statistics)
+{
+	uint32_t const width = render_backend_cpu->GetBackbufferWidth();
+	uint32_t const height = render_backend_cpu->GetBackbufferHeight();
+
+	uint32_t message_size;
+	uint8_t const *const message = tile_delta_encoder->Encode(thread_pool, render_backend_cpu->GetBackbuffer(), width, height, frame_index, &message_size);
+
+	std::chrono::steady_clock::time_point const send_begin = std::chrono::steady_clock::now();
+	bool const sent = frame_stream->Send(message, message_size);
+	statistics->send_milliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - send_begin).count();
+
+	tile_delta_statistics_t const &encoder_statistics = tile_delta_encoder->GetStatistics();
+	++statistics->frame_count;
+	statistics->tile_count += encoder_statistics.tile_count;
+	statistics->dirty_tile_count += encoder_statistics.dirty_tile_count;
+	statistics->raw_byte_count += static_cast<uint64_t>(width) * height * 4U;
+	statistics->encode_milliseconds += encoder_statistics.encode_milliseconds;
+
+	return sent;
+}
+
+static int headless_stream_view_main(char const *stream_path)
+{
+	// the message is NOT larger than the key frame of the max size of the 2D texture of the D3D11 (neither the size prefix nor the header is trusted)
+	static uint32_t const max_frame_size = 16384U;
+	uint32_t const max_message_size = TileDeltaMaxMessageSize(max_frame_size, max_frame_size);
+
+	if (!headless_stream_view_hostile_headers(max_frame_size))
+	{
+		fprintf(stderr, "headless: the message of the hostile header is applied\n");
+		return 1;
+	}
+
+	FrameStream frame_stream;
+	frame_stream.Init();
+	if (!frame_stream.Listen(stream_path))
+	{
+		fprintf(stderr, "headless: failed to listen on the stream \"%s\"\n", stream_path);
+		frame_stream.Destroy();
+		return 1;
+	}
+
+	printf("stream view: \"%s\", waiting for the sender\n", stream_path);
+	if (!frame_stream.Accept())
+	{
+		fprintf(stderr, "headless: failed to accept the sender of the stream \"%s\"\n", stream_path);
+		frame_stream.Destroy();
+		return 1;
+	}
+
+	TileDeltaDecoder tile_delta_decoder;
+	tile_delta_decoder.Init(max_frame_size);
+
+	std::vector<uint8_t> message;
+	uint32_t applied_frame_count = 0U;
+	uint32_t failed_frame_count = 0U;
+	uint32_t key_frame_count = 0U;
+	uint64_t raw_byte_count = 0U;
+	double decode_milliseconds = 0.0;
+	while (frame_stream.Receive(message, max_message_size))
+	{
+		std::chrono::steady_clock::time_point const decode_begin = std::chrono::steady_clock::now();
+		bool const applied = (!message.empty()) && tile_delta_decoder.Apply(&message[0], static_cast<uint32_t>(message.size()));
+		decode_milliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - decode_begin).count();
+
+		if (!applied)
+		{
+			++failed_frame_count;
+			continue;
+		}
+
+		tile_delta_message_header_t header;
+		memcpy(&header, &message[0], sizeof(tile_delta_message_header_t));
+		key_frame_count += header.key_frame;
+		raw_byte_count += static_cast<uint64_t>(header.width) * header.height * 4U;
+		++applied_frame_count;
+	}
+
+	double const frame_count = static_cast<double>(std::max(applied_frame_count, 1U));
+	printf("stream view: %u frames applied (%u key frames), %u messages rejected, %.1f bytes per frame against %.1f raw bytes, decode %.4f ms per frame\n",
+		   applied_frame_count,
+		   key_frame_count,
+		   failed_frame_count,
+		   static_cast<double>(frame_stream.GetByteCount()) / frame_count,
+		   static_cast<double>(raw_byte_count) / frame_count,
+		   decode_milliseconds / frame_count);
+	if (NULL != tile_delta_decoder.GetFrame())
+	{
+		printf("stream view: last frame %u x %u, checksum %llu\n",
+			   tile_delta_decoder.GetWidth(),
+			   tile_delta_decoder.GetHeight(),
+			   static_cast<unsigned long long>(headless_frame_checksum(tile_delta_decoder.GetFrame(), tile_delta_decoder.GetWidth(), tile_delta_decoder.GetHeight())));
+	}
+
+	tile_delta_decoder.Destroy();
+	frame_stream.Destroy();
+	return 0;
+}
+
+static bool headless_stream_view_hostile_headers(uint32_t max_frame_size)
+{
+	static uint32_t const hostile_header_count = 5U;
+
+	TileDeltaDecoder tile_delta_decoder;
+	tile_delta_decoder.Init(max_frame_size);
+
+	uint32_t rejected_count = 0U;
+	for (uint32_t hostile_index = 0U; hostile_index < hostile_header_count; ++hostile_index)
+	{
+		// the valid key frame of 64 x 64 without any dirty tile, followed by one field broken
+		tile_delta_message_header_t header;
+		header.magic = TILE_DELTA_MAGIC;
+		header.frame_index = hostile_index;
+		header.width = 64U;
+		header.height = 64U;
+		header.tile_size = TILE_DELTA_TILE_SIZE;
+		header.dirty_tile_count = 0U;
+		header.payload_size = 0U;
+		header.key_frame = 1U;
+		switch (hostile_index)
+		{
+		case 0U:
+		{
+			// the "m_width * m_height * 4" of 32 bits wraps around, and the size_t is beyond the "max_size"
+			header.width = 0XFFFF0000U;
+			header.height = 0XFFFF0000U;
+		}
+		break;
+		case 1U:
+		{
+			header.width = max_frame_size + 1U;
+		}
+		break;
+		case 2U:
+		{
+			header.height = max_frame_size + 1U;
+		}
+		break;
+		case 3U:
+		{
+			header.tile_size = TILE_DELTA_TILE_SIZE * 2U;
+		}
+		break;
+		default:
+		{
+			// 4 tiles of 64 x 64
+			header.dirty_tile_count = 5U;
+		}
+		}
+
+		uint8_t message[sizeof(tile_delta_message_header_t)];
+		memcpy(message, &header, sizeof(tile_delta_message_header_t));
+		rejected_count += (!tile_delta_decoder.Apply(message, sizeof(tile_delta_message_header_t))) ? 1U : 0U;
+	}
+
+	tile_delta_decoder.Destroy();
+
+	printf("stream view: %u of %u hostile headers rejected\n", rejected_count, hostile_header_count);
+	return (hostile_header_count == rejected_count);
+}
+
+static uint64_t headless_frame_checksum(uint8_t const *pixels, uint32_t width, uint32_t height)
+{
+	uint64_t checksum = 0U;
+	size_t const byte_count = static_cast<size_t>(width) * height * 4U;
+	for (size_t byte_index = 0U; byte_index < byte_count; ++byte_index)
+	{
+		checksum += pixels[byte_index];
+	}
+	return checksum;
+}
+
+static void headless_build_frame_graph(FrameGraph &frame_graph, uint32_t pass_count, uint32_t width, uint32_t height)
+{
+	frame_graph.Reset();
+
+	render_backend_texture_desc_t texture_descs[2];
+	for (uint32_t desc_index = 0U; desc_index < 2U; ++desc_index)
+	{
+		texture_descs[desc_index].width = std::max(width >> desc_index, 1U);
+		texture_descs[desc_index].height = std::max(height >> desc_index, 1U);
+		texture_descs[desc_index].depth = 1U;
+		texture_descs[desc_index].mip_level_count = 1U;
+		texture_descs[desc_index].format = RENDER_BACKEND_FORMAT_R16G16B16A16_FLOAT;
+		texture_descs[desc_index].usage = RENDER_BACKEND_TEXTURE_USAGE_SAMPLED | RENDER_BACKEND_TEXTURE_USAGE_COLOR_ATTACHMENT;
+		texture_descs[desc_index].view_dimension = RENDER_BACKEND_TEXTURE_VIEW_DIMENSION_2D;
+	}
+
+	float const clear_color_value[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+	frame_graph_resource_t const backbuffer = frame_graph.ImportTexture(NULL, RENDER_BACKEND_TEXTURE_STATE_COLOR_ATTACHMENT);
+
+	// the last two live outputs
+	frame_graph_resource_t previous = 0U;
+	frame_graph_resource_t previous_previous = 0U;
+	uint32_t live_count = 0U;
+	for (uint32_t pass_index = 0U; (pass_index + 1U) < pass_count; ++pass_index)
+	{
+		frame_graph_resource_t const output = frame_graph.CreateTexture(texture_descs[pass_index & 1U]);
+
+		frame_graph_pass_t const pass = frame_graph.AddPass("Synthetic Pass", &headless_frame_graph_execute_nothing, NULL);
+		if (live_count > 0U)
+		{
+			frame_graph.AddRead(pass, previous);
+		}
+		if (live_count > 1U && 0U == (pass_index % 3U))
+		{
+			frame_graph.AddRead(pass, previous_previous);
+		}
+		frame_graph.SetColorAttachment(pass, 0U, output, true, clear_color_value);
+
+		// the dead branch
+		if (3U != (pass_index & 3U))
+		{
+			previous_previous = previous;
+			previous = output;
+			++live_count;
+		}
+	}
+
+	frame_graph_pass_t const pass = frame_graph.AddPass("Synthetic Present", &headless_frame_graph_execute_nothing, NULL);
+	if (live_count > 0U)
+	{
+		frame_graph.AddRead(pass, previous);
+	}
+	frame_graph.SetColorAttachment(pass, 0U, backbuffer, false, NULL);
+}
+
+static void headless_frame_graph_execute_nothing(RenderBackend *render_backend, FrameGraph const *, void *)
+{
+	render_backend->Draw(3U);
+}
+
+static bool headless_frame_graph_load_after_clear(FrameGraph &frame_graph, uint32_t width, uint32_t height)
+{
+	frame_graph.Reset();
+
+	render_backend_texture_desc_t color_desc;
+	color_desc.width = width;
+	color_desc.height = height;
+	color_desc.depth = 1U;
+	color_desc.mip_level_count = 1U;
+	color_desc.format = RENDER_BACKEND_FORMAT_R16G16B16A16_FLOAT;
+	color_desc.usage = RENDER_BACKEND_TEXTURE_USAGE_SAMPLED | RENDER_BACKEND_TEXTURE_USAGE_COLOR_ATTACHMENT;
+	color_desc.view_dimension = RENDER_BACKEND_TEXTURE_VIEW_DIMENSION_2D;
+
+	render_backend_texture_desc_t depth_desc = color_desc;
+	depth_desc.format = RENDER_BACKEND_FORMAT_D32_FLOAT;
+	depth_desc.usage = RENDER_BACKEND_TEXTURE_USAGE_DEPTH_ATTACHMENT;
+
+	float const clear_color_value[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+	frame_graph_resource_t const backbuffer = frame_graph.ImportTexture(NULL, RENDER_BACKEND_TEXTURE_STATE_COLOR_ATTACHMENT);
+	frame_graph_resource_t const scratch = frame_graph.CreateTexture(color_desc);
+	frame_graph_resource_t const depth = frame_graph.CreateTexture(depth_desc);
+
+	frame_graph_pass_t const writer = frame_graph.AddPass("Depth Writer", &headless_frame_graph_execute_nothing, NULL);
+	frame_graph.SetColorAttachment(writer, 0U, scratch, true, clear_color_value);
+	frame_graph.SetDepthAttachment(writer, depth, true, 1.0f);
+
+	frame_graph_pass_t const loader = frame_graph.AddPass("Depth Loader", &headless_frame_graph_execute_nothing, NULL);
+	frame_graph.SetColorAttachment(loader, 0U, backbuffer, false, NULL);
+	frame_graph.SetDepthAttachment(loader, depth, false, 1.0f);
+
+	frame_graph.Compile();
+	frame_graph.Execute();
+
+	bool const writer_culled = frame_graph.IsPassCulled(writer);
+	bool const loader_culled = frame_graph.IsPassCulled(loader);
+	printf("frame graph load after clear: writer culled %u, loader culled %u\n", writer_culled ? 1U : 0U, loader_culled ? 1U : 0U);
+	return !(writer_culled || loader_culled);
+}
+
+static void headless_build_demo_scene(std::vector<float> &triangle_vertices, software_renderer_scene_t &scene)
+{
+	triangle_vertices.clear();
+
+	// plane
+	{
+		float const plane_vertices[4][3] = {
+			{-7777.0f, 0.0f, -7777.0f},
+			{7777.0f, 0.0f, -7777.0f},
+			{7777.0f, 0.0f, 7777.0f},
+			{-7777.0f, 0.0f, 7777.0f}};
+		int const plane_indices[6] = {0, 2, 1, 0, 3, 2};
+		for (int index = 0; index < 6; ++index)
+		{
+			triangle_vertices.insert(triangle_vertices.end(), plane_vertices[plane_indices[index]], plane_vertices[plane_indices[index]] + 3);
+		}
+	}
+
+	// occluders between the camera and the light such that the penumbrae are in the view
+	{
+		float const pillar_min[3][3] = {{-3.5f, 0.0f, 21.5f}, {2.0f, 0.0f, 19.5f}, {-0.5f, 0.0f, 25.5f}};
+		float const pillar_max[3][3] = {{-2.5f, 5.0f, 22.5f}, {3.0f, 3.0f, 20.5f}, {0.5f, 1.5f, 26.5f}};
+		for (int pillar_index = 0; pillar_index < 3; ++pillar_index)
+		{
+			headless_append_box(triangle_vertices, pillar_min[pillar_index], pillar_max[pillar_index]);
+		}
+	}
+
+	scene.triangle_vertices = &triangle_vertices[0];
+	scene.triangle_count = static_cast<uint32_t>(triangle_vertices.size() / 9U);
+
+	// "ToLinear" in "plane_fs.hlsl"
+	for (int component = 0; component < 3; ++component)
+	{
+		scene.diffuse_color[component] = std::pow(1.0f, 2.2f);
+		scene.specular_color[component] = std::pow(0.23f, 2.2f);
+	}
+	scene.roughness = 0.25f;
+
+	float const rect_light_vertices[4][3] = {
+		{-4.0f, 2.0f, 32.0f},
+		{4.0f, 2.0f, 32.0f},
+		{4.0f, 10.0f, 32.0f},
+		{-4.0f, 10.0f, 32.0f}};
+	memcpy(scene.rect_light_vertices, rect_light_vertices, sizeof(rect_light_vertices));
+	scene.intensity = 4.0f;
+
+	float const eye_position[3] = {0.0f, 6.0f, -0.5f};
+	float const eye_direction[3] = {0.0f, 0.174311504f, 1.99238944f};
+	float const up_direction[3] = {0.0f, 1.0f, 0.0f};
+	memcpy(scene.eye_position, eye_position, sizeof(eye_position));
+	memcpy(scene.eye_direction, eye_direction, sizeof(eye_direction));
+	memcpy(scene.up_direction, up_direction, sizeof(up_direction));
+	scene.fov_angle_y = 2.0f * std::atan(0.5f);
+}
+
+static void headless_camera_path(software_renderer_scene_t const &scene, uint32_t frame_index, uint32_t frame_count, float eye_position[3], float eye_direction[3])
+{
+	// [-0.25, 0.25] radians around the vertical axis, the eye moves against the turn such that the plane stays in the view
+	float const t = (frame_count > 1U) ? (static_cast<float>(frame_index) / static_cast<float>(frame_count - 1U)) : 0.5f;
+	float const angle = 0.5f * (t - 0.5f);
+	float const sin_angle = std::sin(angle);
+	float const cos_angle = std::cos(angle);
+
+	eye_direction[0] = cos_angle * scene.eye_direction[0] + sin_angle * scene.eye_direction[2];
+	eye_direction[1] = scene.eye_direction[1];
+	eye_direction[2] = -sin_angle * scene.eye_direction[0] + cos_angle * scene.eye_direction[2];
+
+	eye_position[0] = scene.eye_position[0] - 4.0f * sin_angle;
+	eye_position[1] = scene.eye_position[1];
+	eye_position[2] = scene.eye_position[2];
+}
+
+static void headless_append_box(std::vector<float> &triangle_vertices, float const box_min[3], float const box_max[3])
+{
+	// corner "i": x = (i & 1), y = (i & 2), z = (i & 4)
+	float corners[8][3];
+	for (int corner_index = 0; corner_index < 8; ++corner_index)
+	{
+		corners[corner_index][0] = (0 != (corner_index & 1)) ? box_max[0] : box_min[0];
+		corners[corner_index][1] = (0 != (corner_index & 2)) ? box_max[1] : box_min[1];
+		corners[corner_index][2] = (0 != (corner_index & 4)) ? box_max[2] : box_min[2];
+	}
+
+	// the winding order does NOT matter (the normal faces the eye in the "PassPrimary")
+	int const face_indices[6][4] = {
+		{0, 1, 3, 2},
+		{4, 6, 7, 5},
+		{0, 4, 5, 1},
+		{2, 3, 7, 6},
+		{0, 2, 6, 4},
+		{1, 5, 7, 3}};
+	for (int face_index = 0; face_index < 6; ++face_index)
+	{
+		int const triangle_indices[6] = {0, 1, 2, 0, 2, 3};
+		for (int index = 0; index < 6; ++index)
+		{
+			float const *const corner = corners[face_indices[face_index][triangle_indices[index]]];
+			triangle_vertices.insert(triangle_vertices.end(), corner, corner + 3);
+		}
+	}
+}
+
+static void headless_tonemap_report(ThreadPool *thread_pool, uint32_t width, uint32_t height, float const *radiance)
+{
+	static uint32_t const repeat_count = 16U;
+
+	std::vector<float> lut;
+	double bake_milliseconds = 1.0E+30;
+	for (uint32_t repeat_index = 0U; repeat_index < repeat_count; ++repeat_index)
+	{
+		std::chrono::steady_clock::time_point const begin = std::chrono::steady_clock::now();
+		BakeTonemapLUT(thread_pool, lut);
+		bake_milliseconds = std::min(bake_milliseconds, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count());
+	}
+
+	// RGBA8, the same rounding as the post process of the CPU backend
+	std::vector<uint8_t> analytic_image(static_cast<size_t>(width) * height * 4U);
+	std::vector<uint8_t> lut_image(static_cast<size_t>(width) * height * 4U);
+
+	double post_process_milliseconds[2] = {1.0E+30, 1.0E+30};
+	for (uint32_t repeat_index = 0U; repeat_index < repeat_count; ++repeat_index)
+	{
+		for (int use_lut = 0; use_lut < 2; ++use_lut)
+		{
+			float const *const tonemap_lut = &lut[0];
+			uint8_t *const image = (0 != use_lut) ? &lut_image[0] : &analytic_image[0];
+
+			std::chrono::steady_clock::time_point const begin = std::chrono::steady_clock::now();
+			thread_pool->ParallelFor(height, 8U, [=](uint32_t row_begin, uint32_t row_end, uint32_t) {
+				for (uint32_t y = row_begin; y < row_end; ++y)
+				{
+					for (uint32_t x = 0U; x < width; ++x)
+					{
+						size_t const pixel_index = static_cast<size_t>(width) * y + x;
+
+						float display_color[3];
+						if (0 != use_lut)
+						{
+							TonemapLUT(tonemap_lut, radiance + 3U * pixel_index, display_color);
+						}
+						else
+						{
+							TonemapAnalytic(radiance + 3U * pixel_index, display_color);
+						}
+
+						for (int component = 0; component < 3; ++component)
+						{
+							image[4U * pixel_index + component] = static_cast<uint8_t>(display_color[component] * 255.0f + 0.5f);
+						}
+						image[4U * pixel_index + 3U] = 255U;
+					}
+				}
+			});
+			post_process_milliseconds[use_lut] = std::min(post_process_milliseconds[use_lut], std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count());
+		}
+	}
+
+	uint32_t image_max_error = 0U;
+	uint32_t image_different_pixel_count = 0U;
+	double image_sum_squared_error = 0.0;
+	for (size_t pixel_index = 0U; pixel_index < static_cast<size_t>(width) * height; ++pixel_index)
+	{
+		bool different = false;
+		for (int component = 0; component < 3; ++component)
+		{
+			int const error = std::abs(static_cast<int>(lut_image[4U * pixel_index + component]) - static_cast<int>(analytic_image[4U * pixel_index + component]));
+			image_max_error = std::max(image_max_error, static_cast<uint32_t>(error));
+			image_sum_squared_error += static_cast<double>(error * error);
+			different = different || (0 != error);
+		}
+		image_different_pixel_count += different ? 1U : 0U;
+	}
+
+	// the grid of the log2 HDR values over the range of the LUT (and the black) which falls between the texels of the LUT, in the 8-bit units
+	static uint32_t const range_axis_count = 97U;
+	float range_axis_values[range_axis_count];
+	range_axis_values[0] = 0.0f;
+	for (uint32_t value_index = 1U; value_index < range_axis_count; ++value_index)
+	{
+		range_axis_values[value_index] = std::exp2(TONEMAP_LUT_LOG2_MIN + (TONEMAP_LUT_LOG2_MAX - TONEMAP_LUT_LOG2_MIN) * static_cast<float>(value_index - 1U) / static_cast<float>(range_axis_count - 2U));
+	}
+
+	double range_max_error = 0.0;
+	double range_sum_squared_error = 0.0;
+	float range_max_error_color[3] = {0.0f, 0.0f, 0.0f};
+	for (uint32_t z = 0U; z < range_axis_count; ++z)
+	{
+		for (uint32_t y = 0U; y < range_axis_count; ++y)
+		{
+			for (uint32_t x = 0U; x < range_axis_count; ++x)
+			{
+				float const color[3] = {range_axis_values[x], range_axis_values[y], range_axis_values[z]};
+				float analytic_color[3];
+				float lut_color[3];
+				TonemapAnalytic(color, analytic_color);
+				TonemapLUT(&lut[0], color, lut_color);
+				for (int component = 0; component < 3; ++component)
+				{
+					double const error = std::abs(static_cast<double>(lut_color[component]) - static_cast<double>(analytic_color[component])) * 255.0;
+					range_sum_squared_error += error * error;
+					if (error > range_max_error)
+					{
+						range_max_error = error;
+						range_max_error_color[0] = color[0];
+						range_max_error_color[1] = color[1];
+						range_max_error_color[2] = color[2];
+					}
+				}
+			}
+		}
+	}
+
+	printf("tonemap LUT: %u^3 texels, log2 range [%g, %g], baked in %.3f ms\n", TONEMAP_LUT_SIZE, TONEMAP_LUT_LOG2_MIN, TONEMAP_LUT_LOG2_MAX, bake_milliseconds);
+	printf("tone mapping (ms, min of %u): analytic %.3f, LUT %.3f\n", repeat_count, post_process_milliseconds[0], post_process_milliseconds[1]);
+	printf("tonemap LUT error (8-bit): image max %u, RMSE %.4f, %.3f%% of the pixels differ; range max %.3f (at %g %g %g), RMSE %.4f\n",
+		   image_max_error,
+		   std::sqrt(image_sum_squared_error / (3.0 * width * height)),
+		   100.0 * image_different_pixel_count / (static_cast<double>(width) * height),
+		   range_max_error,
+		   range_max_error_color[0], range_max_error_color[1], range_max_error_color[2],
+		   std::sqrt(range_sum_squared_error / (3.0 * range_axis_count * range_axis_count * range_axis_count)));
+
+	headless_tonemap_encoder_report(thread_pool, width, height, radiance, &analytic_image[0]);
+}
+
+static void headless_tonemap_encoder_report(ThreadPool *thread_pool, uint32_t width, uint32_t height, float const *radiance, uint8_t const *analytic_image)
+{
+	static uint32_t const repeat_count = 16U;
+
+	// the HDR image of the post process: RGBA32F (the color attachment of the CPU backend) and RGBA16F (the color attachment of the D3D11 backend)
+	std::vector<float> hdr_image(static_cast<size_t>(width) * height * 4U);
+	std::vector<uint16_t> hdr_half_image(static_cast<size_t>(width) * height * 4U);
+	for (size_t pixel_index = 0U; pixel_index < static_cast<size_t>(width) * height; ++pixel_index)
+	{
+		for (int component = 0; component < 3; ++component)
+		{
+			hdr_image[4U * pixel_index + component] = radiance[3U * pixel_index + component];
+			hdr_half_image[4U * pixel_index + component] = float_to_half(radiance[3U * pixel_index + component]);
+		}
+		hdr_image[4U * pixel_index + 3U] = 1.0f;
+		hdr_half_image[4U * pixel_index + 3U] = float_to_half(1.0f);
+	}
+
+	// BGRA8, the output of the RGBA32F and the output of the RGBA16F
+	std::vector<uint8_t> encoder_images(static_cast<size_t>(width) * height * 4U * 2U);
+
+	double encoder_milliseconds[2] = {1.0E+30, 1.0E+30};
+	for (uint32_t repeat_index = 0U; repeat_index < repeat_count; ++repeat_index)
+	{
+		for (int use_half = 0; use_half < 2; ++use_half)
+		{
+			float const *const source = &hdr_image[0];
+			uint16_t const *const half_source = &hdr_half_image[0];
+			uint8_t *const image = &encoder_images[static_cast<size_t>(width) * height * 4U * use_half];
+
+			std::chrono::steady_clock::time_point const begin = std::chrono::steady_clock::now();
+			thread_pool->ParallelFor(height, 8U, [=](uint32_t row_begin, uint32_t row_end, uint32_t) {
+				for (uint32_t y = row_begin; y < row_end; ++y)
+				{
+					size_t const row_offset = static_cast<size_t>(width) * y * 4U;
+					if (0 != use_half)
+					{
+						TonemapEncodeRowHalf(half_source + row_offset, width, 1.0f, image + row_offset);
+					}
+					else
+					{
+						TonemapEncodeRow(source + row_offset, width, 1.0f, image + row_offset);
+					}
+				}
+			});
+			encoder_milliseconds[use_half] = std::min(encoder_milliseconds[use_half], std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count());
+		}
+	}
+
+	// against the analytic (RGBA8)
+	uint32_t encoder_max_error[2] = {0U, 0U};
+	uint32_t encoder_different_pixel_count[2] = {0U, 0U};
+	for (size_t pixel_index = 0U; pixel_index < static_cast<size_t>(width) * height; ++pixel_index)
+	{
+		for (int use_half = 0; use_half < 2; ++use_half)
+		{
+			uint8_t const *const pixel = &encoder_images[static_cast<size_t>(width) * height * 4U * use_half + 4U * pixel_index];
+			bool different = false;
+			for (int component = 0; component < 3; ++component)
+			{
+				int const error = std::abs(static_cast<int>(pixel[2 - component]) - static_cast<int>(analytic_image[4U * pixel_index + component]));
+				encoder_max_error[use_half] = std::max(encoder_max_error[use_half], static_cast<uint32_t>(error));
+				different = different || (0 != error);
+			}
+			encoder_different_pixel_count[use_half] += different ? 1U : 0U;
+		}
+	}
+
+	// all the threads of the pool encode the rows: the Mpixels/s of the pool and of each thread
+	double const pixel_count = static_cast<double>(width) * height;
+	double const thread_count = static_cast<double>(thread_pool->GetThreadCount());
+	printf("tonemap encoder (ms, min of %u, %s, %u threads): RGBA32F %.3f (%.1f Mpixels/s, %.1f per thread), RGBA16F %.3f (%.1f Mpixels/s, %.1f per thread)\n",
+		   repeat_count, TonemapEncoderGetPath(), thread_pool->GetThreadCount(),
+		   encoder_milliseconds[0], pixel_count / (encoder_milliseconds[0] * 1000.0), pixel_count / (encoder_milliseconds[0] * 1000.0 * thread_count),
+		   encoder_milliseconds[1], pixel_count / (encoder_milliseconds[1] * 1000.0), pixel_count / (encoder_milliseconds[1] * 1000.0 * thread_count));
+	printf("tonemap encoder error (8-bit): RGBA32F max %u, %.3f%% of the pixels differ; RGBA16F max %u, %.3f%% of the pixels differ\n",
+		   encoder_max_error[0], 100.0 * encoder_different_pixel_count[0] / pixel_count,
+		   encoder_max_error[1], 100.0 * encoder_different_pixel_count[1] / pixel_count);
+}
+
+static void headless_auto_exposure_report(ThreadPool *thread_pool, uint32_t width, uint32_t height, float const *radiance, double frame_milliseconds)
+{
+	size_t const pixel_count = static_cast<size_t>(width) * height;
+
+	// the layout of the HDR color attachment of the CPU backend
+	std::vector<float> hdr_color(pixel_count * 4U);
+	for (size_t pixel_index = 0U; pixel_index < pixel_count; ++pixel_index)
+	{
+		hdr_color[4U * pixel_index + 0U] = radiance[3U * pixel_index + 0U];
+		hdr_color[4U * pixel_index + 1U] = radiance[3U * pixel_index + 1U];
+		hdr_color[4U * pixel_index + 2U] = radiance[3U * pixel_index + 2U];
+		hdr_color[4U * pixel_index + 3U] = 1.0f;
+	}
+
+	AutoExposureHistogram histogram;
+	histogram.Init(thread_pool->GetThreadCount());
+
+	static uint32_t const repeat_count = 16U;
+	double histogram_milliseconds = INFINITY;
+	for (uint32_t repeat_index = 0U; repeat_index < repeat_count; ++repeat_index)
+	{
+		std::chrono::steady_clock::time_point const begin = std::chrono::steady_clock::now();
+		histogram.Build(thread_pool, &hdr_color[0], width, height);
+		histogram_milliseconds = std::min(histogram_milliseconds, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count());
+	}
+
+	float bins[AUTO_EXPOSURE_HISTOGRAM_BIN_COUNT];
+	uint32_t counted_pixel_count = 0U;
+	for (uint32_t bin_index = 0U; bin_index < AUTO_EXPOSURE_HISTOGRAM_BIN_COUNT; ++bin_index)
+	{
+		bins[bin_index] = static_cast<float>(histogram.GetHistogram()[bin_index]);
+		counted_pixel_count += histogram.GetHistogram()[bin_index];
+	}
+	histogram.Destroy();
+
+	float const adapted_log2_luminance = AutoExposureAdapt(bins, 0.0f, false);
+
+	// the light 4 times as bright is exactly 8 bins up (a quarter of the stop per bin)
+	static uint32_t const shift_bin_count = 8U;
+	float brighter_bins[AUTO_EXPOSURE_HISTOGRAM_BIN_COUNT];
+	for (uint32_t bin_index = 0U; bin_index < AUTO_EXPOSURE_HISTOGRAM_BIN_COUNT; ++bin_index)
+	{
+		brighter_bins[bin_index] = 0.0f;
+	}
+	for (uint32_t bin_index = 0U; bin_index < AUTO_EXPOSURE_HISTOGRAM_BIN_COUNT; ++bin_index)
+	{
+		brighter_bins[std::min(bin_index + shift_bin_count, AUTO_EXPOSURE_HISTOGRAM_BIN_COUNT - 1U)] += bins[bin_index];
+	}
+	float const brighter_target_log2_luminance = AutoExposureAdapt(brighter_bins, 0.0f, false);
+
+	// the frames until the adapted luminance is within the quarter of the stop
+	uint32_t adaptation_frame_count = 0U;
+	float brighter_log2_luminance = adapted_log2_luminance;
+	while (std::abs(brighter_target_log2_luminance - brighter_log2_luminance) > 0.25f && adaptation_frame_count < 1000U)
+	{
+		brighter_log2_luminance = AutoExposureAdapt(brighter_bins, brighter_log2_luminance, true);
+		++adaptation_frame_count;
+	}
+
+	printf("auto exposure: %u of %llu pixels counted, average log2 luminance %.3f, exposure %.3f\n",
+		   counted_pixel_count, static_cast<unsigned long long>(pixel_count), adapted_log2_luminance, AutoExposureFromLuminance(adapted_log2_luminance));
+	printf("auto exposure histogram (ms, min of %u): %.3f (%.1f Mpixels/s), %.2f%% of the frame (%.3f ms)\n",
+		   repeat_count, histogram_milliseconds, static_cast<double>(pixel_count) / (histogram_milliseconds * 1000.0), 100.0 * histogram_milliseconds / frame_milliseconds, frame_milliseconds);
+	printf("auto exposure adaptation: the light x4, exposure %.3f -> %.3f in %u frames (within a quarter of the stop)\n",
+		   AutoExposureFromLuminance(adapted_log2_luminance), AutoExposureFromLuminance(brighter_target_log2_luminance), adaptation_frame_count);
+}
+
+static bool headless_write_pfm(char const *path, uint32_t width, uint32_t height, float const *radiance)
+{
+	FILE *file = fopen(path, "wb");
+	if (NULL == file)
+	{
+		return false;
+	}
+
+	// The negative scale means little endian, the rows are from the bottom to the top.
+	fprintf(file, "PF\n%u %u\n-1.0\n", width, height);
+
+	bool success = true;
+	for (uint32_t y = 0U; y < height && success; ++y)
+	{
+		size_t const row_index = height - 1U - y;
+		success = (static_cast<size_t>(width) * 3U == fwrite(radiance + row_index * width * 3U, sizeof(float), static_cast<size_t>(width) * 3U, file));
+	}
+
+	fclose(file);
+	return success;
+}
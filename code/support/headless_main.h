@@ -0,0 +1,46 @@
+#ifndef _HEADLESS_MAIN_H_
+#define _HEADLESS_MAIN_H_ 1
+
+//
+// Render the demo scene by the CPU renderer (see "cpu/software_renderer.h") without any window or GPU.
+// Used to measure the cost and the noise of the area light shadows.
+//
+// With "--backend", the frame loop of the "Demo" is run on the backend instead (see "backend/render_backend.h"),
+// used to measure the throughput and the CPU overhead per frame without any GPU.
+// null: records the command counts and the byte volumes
+// cpu: the software renderer drives the light pass (the shadow options above apply)
+// As in the window, the backend is wrapped by the state tracker (see "backend/render_backend_state_tracker.h"), the null backend counts the commands which are NOT elided.
+//
+// --width N --height N            (default: resolution.h)
+// --threads N                     (default: 0, one thread per hardware thread)
+// --samples-min N --samples-max N (default: 4 64, "--samples-max 0" means unshadowed)
+// --target-error E                (default: 0.02, the standard error of the ratio at which the pixel stops sampling)
+// --no-denoise
+// --frames N                      (default: 1, the timings are averaged)
+// --reference N                   (the RMSE against the reference rendered with N samples per pixel, neither adaptive nor denoised)
+// --tonemap                       (the cost of the tone mapping of the image by the analytic curve, by the tonemap LUT and by the SIMD encoder, and their errors, see "cpu/tonemap_lut.h" and "cpu/tonemap_encoder.h")
+// --output FILE.pfm
+// --sequence PREFIX               (the "--frames" along the camera path are written to "PREFIX00000.exr", ... by the writer threads while the next frame renders, see "cpu/image_sequence_writer.h")
+// --sequence-format exr|pfm|png|bgra (default: exr, the half float)
+// --sequence-writers N            (default: 2)
+// --sequence-queue N              (default: 4, the frames queued before the render thread stalls)
+// --backend null|cpu              (the "--frames" is the length of the frame loop, "--output" and "--reference" are not supported)
+// --frame-graph-passes N          (with "--backend", the frame graph of N synthetic passes is also run for "--frames" frames, see "backend/frame_graph.h", followed by the check that the writer of the loaded depth is NOT culled)
+// --deferred                      (with "--backend", the G-buffer pass and the full screen lighting pass instead of the forward light pass)
+// --overdraw N                    (with "--backend", default: 1, the plane is drawn N times as the stacked layers, the forward shading lights every layer while the deferred shading lights each pixel once)
+// --depth-prepass                 (with "--backend", forward only: the layers are drawn into the depth first, such that the light pass shades each pixel once)
+// --checkerboard                  (with "--backend", deferred only: half of the pixels are lit per frame, the other half is reconstructed by the history and the neighbors)
+// --frame-budget MS               (with "--backend", the dynamic resolution scales the passes before the post process such that the frame time of the backend fits into MS, see "cpu/dynamic_resolution.h")
+// --resize N                      (with "--backend", after "--frames": N frames each resized by (7, 5) pixels as by dragging the border, the latency of the resize and the recreated textures are reported, see "Demo::Resize")
+// --shared-framebuffer NAME       (with "--backend cpu", the backbuffer is the slot of the shared memory ring "NAME" which is published by each frame, see "cpu/shared_framebuffer.h")
+// --view NAME                     (the viewer of the "--shared-framebuffer NAME" of the other process: the "--frames" new frames are read in place, the skipped and the torn frames are reported)
+// --stream PATH                   (with "--backend cpu", each frame is compared against the last one by the tiles, the changed tiles are compressed and sent over the Unix domain socket PATH, see "cpu/tile_delta.h" and "support/frame_stream.h")
+// --input-events N                (with "--backend", the synthetic window thread pushes N input events per second into the queue which the frame loop drains before each "Tick", the latency from the event to the end of the frame is reported, see "support/input_event_queue.h")
+// --input-flood N                 (the regression of the full input event queue: N mouse moves are flooded between each KEY_DOWN and its KEY_UP, fails if any key is still held after the last frame, see "support/input_event_queue.h")
+// --stream-view PATH              (the viewer of the "--stream PATH" of the other process: listens on PATH and applies the frames until the sender closes the connection; the hostile headers are checked to be rejected first)
+// --auto-exposure                 (the cost of the histogram of the auto exposure against the frame time and the adaptation, see "cpu/auto_exposure.h"; with "--backend", the auto exposure stage runs before the post process)
+//
+
+int headless_main(int argc, char *argv[]);
+
+#endif
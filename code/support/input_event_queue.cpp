@@ -0,0 +1,131 @@
+#include <stdint.h>
+#include <chrono>
+#include <atomic>
+
+#include "input_event_queue.h"
+
+uint64_t InputEventTimestamp()
+{
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void InputEventQueue::Init()
+{
+	m_write_index.store(0U, std::memory_order_relaxed);
+	m_cached_read_index = 0U;
+	m_dropped_event_count.store(0U, std::memory_order_relaxed);
+	m_held_keys.store(0U, std::memory_order_relaxed);
+	m_dropped_write_index.store(0U, std::memory_order_relaxed);
+	m_has_pending_mouse_move = false;
+
+	m_read_index.store(0U, std::memory_order_relaxed);
+	m_cached_write_index = 0U;
+	m_reconciled_event_count = 0U;
+}
+
+void InputEventQueue::Destroy()
+{
+}
+
+bool InputEventQueue::Push(input_event_t const &event)
+{
+	bool const key_event = (INPUT_EVENT_TYPE_KEY_DOWN == event.type || INPUT_EVENT_TYPE_KEY_UP == event.type) && (event.key < INPUT_KEY_COUNT);
+	if (key_event)
+	{
+		uint32_t const held_keys = m_held_keys.load(std::memory_order_relaxed);
+		m_held_keys.store((INPUT_EVENT_TYPE_KEY_DOWN == event.type) ? (held_keys | (1U << event.key)) : (held_keys & (~(1U << event.key))), std::memory_order_relaxed);
+	}
+
+	// the pending mouse move is older than the event
+	bool const queued = this->Flush() && this->PushRing(event);
+	if (!queued)
+	{
+		// the later position replaces the pending one (the offset is measured from the last position applied)
+		bool const dropped = (INPUT_EVENT_TYPE_MOUSE_MOVE == event.type) ? m_has_pending_mouse_move : true;
+		if (INPUT_EVENT_TYPE_MOUSE_MOVE == event.type)
+		{
+			m_pending_mouse_move = event;
+			m_has_pending_mouse_move = true;
+		}
+
+		if (dropped)
+		{
+			// the held keys are visible to the render thread which sees the count
+			m_dropped_write_index.store(m_write_index.load(std::memory_order_relaxed), std::memory_order_relaxed);
+			m_dropped_event_count.store(m_dropped_event_count.load(std::memory_order_relaxed) + 1U, std::memory_order_release);
+		}
+	}
+	return queued;
+}
+
+bool InputEventQueue::Flush()
+{
+	if (m_has_pending_mouse_move)
+	{
+		m_has_pending_mouse_move = !this->PushRing(m_pending_mouse_move);
+	}
+	return !m_has_pending_mouse_move;
+}
+
+bool InputEventQueue::PushRing(input_event_t const &event)
+{
+	// the indices wrap around (the unsigned difference is the count of the events in the ring)
+	uint32_t const write_index = m_write_index.load(std::memory_order_relaxed);
+	if ((write_index - m_cached_read_index) >= INPUT_EVENT_QUEUE_CAPACITY)
+	{
+		// the slot is reused only after the consumer has copied the event out of it
+		m_cached_read_index = m_read_index.load(std::memory_order_acquire);
+		if ((write_index - m_cached_read_index) >= INPUT_EVENT_QUEUE_CAPACITY)
+		{
+			return false;
+		}
+	}
+
+	m_events[write_index & (INPUT_EVENT_QUEUE_CAPACITY - 1U)] = event;
+	m_write_index.store(write_index + 1U, std::memory_order_release);
+	return true;
+}
+
+bool InputEventQueue::Pop(input_event_t *event)
+{
+	uint32_t const read_index = m_read_index.load(std::memory_order_relaxed);
+	if (read_index == m_cached_write_index)
+	{
+		// the event is visible after the index which publishes it
+		m_cached_write_index = m_write_index.load(std::memory_order_acquire);
+		if (read_index == m_cached_write_index)
+		{
+			return false;
+		}
+	}
+
+	(*event) = m_events[read_index & (INPUT_EVENT_QUEUE_CAPACITY - 1U)];
+	m_read_index.store(read_index + 1U, std::memory_order_release);
+	return true;
+}
+
+bool InputEventQueue::ReconcileHeldKeys(uint32_t *held_keys)
+{
+	uint64_t const dropped_event_count = m_dropped_event_count.load(std::memory_order_acquire);
+	if (dropped_event_count == m_reconciled_event_count)
+	{
+		return false;
+	}
+
+	// e.g. the KEY_DOWN still in the ring, followed by the dropped KEY_UP: the reconciliation waits for the next drain
+	uint32_t const read_index = m_read_index.load(std::memory_order_relaxed);
+	if (static_cast<int32_t>(m_dropped_write_index.load(std::memory_order_relaxed) - read_index) > 0)
+	{
+		return false;
+	}
+	m_reconciled_event_count = dropped_event_count;
+
+	// NOT older than the dropped event (the events still in the ring are applied again by the next drain, which is the same state)
+	(*held_keys) = m_held_keys.load(std::memory_order_relaxed);
+	return true;
+}
+
+uint64_t InputEventQueue::GetDroppedEventCount() const
+{
+	return m_dropped_event_count.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,100 @@
+#ifndef _INPUT_EVENT_QUEUE_H_
+#define _INPUT_EVENT_QUEUE_H_ 1
+
+//
+// The input events from the window thread to the render thread: the single producer single consumer ring without any lock.
+// The window thread pushes the events from the "wnd_proc", the render thread pops them once per frame before the "Demo::Tick" and applies them to the camera (see "CameraController::ApplyInputEvent"),
+// such that the camera is owned by the render thread and is NOT changed while the frame is being recorded.
+//
+// Each side keeps its own index and the cached copy of the index of the other side, such that the shared indices are loaded only when the ring looks full (or empty).
+// The event of the full ring is NOT queued (counted) rather than blocking the window thread, but the key is never lost:
+// the window thread also keeps the held keys, which the render thread reconciles after the drain (see "ReconcileHeldKeys"), such that the KEY_UP of the full ring does NOT leave the key held.
+// The mouse move of the full ring is coalesced with the later ones (the position is absolute) and queued before the next event once there is the room (see "Flush").
+//
+
+#include <stdint.h>
+#include <atomic>
+
+// the power of 2
+static const uint32_t INPUT_EVENT_QUEUE_CAPACITY = 256U;
+
+enum INPUT_EVENT_TYPE
+{
+	// key: see "INPUT_KEY", the auto repeat is NOT sent (the camera moves while the key is held)
+	INPUT_EVENT_TYPE_KEY_DOWN = 0,
+	INPUT_EVENT_TYPE_KEY_UP = 1,
+	// x, y: normalized by the client size, hold: the right button
+	INPUT_EVENT_TYPE_MOUSE_MOVE = 2
+};
+
+enum INPUT_KEY
+{
+	INPUT_KEY_FORWARD = 0,
+	INPUT_KEY_BACK = 1,
+	INPUT_KEY_LEFT = 2,
+	INPUT_KEY_RIGHT = 3,
+	INPUT_KEY_UP = 4,
+	INPUT_KEY_DOWN = 5,
+	INPUT_KEY_COUNT = 6
+};
+
+struct input_event_t
+{
+	uint32_t type;
+	uint32_t key;
+	uint32_t hold;
+	float x;
+	float y;
+	// see "InputEventTimestamp", used to measure the latency from the event to the frame
+	uint64_t timestamp;
+};
+
+// the nanoseconds of the steady clock (the same clock on both threads)
+uint64_t InputEventTimestamp();
+
+class InputEventQueue
+{
+	// the producer
+	alignas(64) std::atomic<uint32_t> m_write_index;
+	uint32_t m_cached_read_index;
+	// published after the "m_held_keys" and the "m_dropped_write_index"
+	std::atomic<uint64_t> m_dropped_event_count;
+	// the bits of the "INPUT_KEY" of every key event, including the ones NOT queued
+	std::atomic<uint32_t> m_held_keys;
+	// the events queued before the last dropped event
+	std::atomic<uint32_t> m_dropped_write_index;
+	input_event_t m_pending_mouse_move;
+	bool m_has_pending_mouse_move;
+
+	// the consumer
+	alignas(64) std::atomic<uint32_t> m_read_index;
+	uint32_t m_cached_write_index;
+	uint64_t m_reconciled_event_count;
+
+	alignas(64) input_event_t m_events[INPUT_EVENT_QUEUE_CAPACITY];
+
+	bool PushRing(input_event_t const &event);
+
+public:
+	void Init();
+	void Destroy();
+
+	// the window thread
+	// [return] false if the ring is full: the key is reconciled by the held keys, the mouse move is pending until the "Flush" (or the next "Push")
+	bool Push(input_event_t const &event);
+	// [return] false if the pending mouse move is still NOT queued (e.g. try again by the timer)
+	bool Flush();
+
+	// the render thread
+	// [return] false if the ring is empty
+	bool Pop(input_event_t *event);
+	// after the "Pop" returns false
+	// [out] held_keys: the bits of the "INPUT_KEY" held by the window thread
+	// [return] false if no event has been dropped since the last call (the events popped are the whole state of the keys), or the events queued before the dropped event are NOT popped yet (they would override the held keys)
+	bool ReconcileHeldKeys(uint32_t *held_keys);
+
+	// the events lost from the ring: the mouse moves replaced by the later pending one and the key events reconciled by the held keys
+	uint64_t GetDroppedEventCount() const;
+};
+
+#endif
@@ -6,88 +6,94 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <assert.h>
-
-#include <dxgi.h>
-#include <d3d11.h>
+#include <chrono>
 
 #include "resolution.h"
 
 #include "window_main.h"
 
+#include "input_event_queue.h"
+
+#include "camera_controller.h"
+
 #include "render_main.h"
 
+#include "../backend/render_backend_d3d11.h"
+
+#include "../backend/render_backend_state_tracker.h"
+
 #include "../demo.h"
 
 unsigned __stdcall render_main(void* pVoid)
 {
 	HWND hWnd = static_cast<HWND>(pVoid);
 
-	ID3D11Device* d3d11_device = NULL;
-	ID3D11DeviceContext* d3d11_device_context = NULL;
-	IDXGISwapChain* dxgi_swap_chain = NULL;
-	{
-		IDXGIFactory1* dxgi_factory = NULL;
-		HRESULT res_create_dxgi_factory = CreateDXGIFactory1(IID_PPV_ARGS(&dxgi_factory));
-		assert(SUCCEEDED(res_create_dxgi_factory));
-
-		IDXGIAdapter1* dxgi_adapter = NULL;
-		// "0U" means "default" adapter // perhaps user-select
-		HRESULT res_dxgi_factory_enum_adapters = dxgi_factory->EnumAdapters1(0U, &dxgi_adapter);
-		assert(SUCCEEDED(res_dxgi_factory_enum_adapters));
-
-		D3D_FEATURE_LEVEL pFeatureLevels[1] = { D3D_FEATURE_LEVEL_11_0 };
-		HRESULT res_d3d11_create_device = D3D11CreateDevice(
-			dxgi_adapter,
-			D3D_DRIVER_TYPE_UNKNOWN,
-			NULL,
-#ifndef NDEBUG
-			D3D11_CREATE_DEVICE_SINGLETHREADED | D3D11_CREATE_DEVICE_DEBUG,
-#else
-			D3D11_CREATE_DEVICE_SINGLETHREADED,
-#endif
-			pFeatureLevels,
-			sizeof(pFeatureLevels) / sizeof(pFeatureLevels[0]),
-			D3D11_SDK_VERSION,
-			&d3d11_device,
-			NULL,
-			&d3d11_device_context
-		);
-		assert(SUCCEEDED(res_d3d11_create_device));
-
-		DXGI_SWAP_CHAIN_DESC dxgi_swap_chain_desc;
-		dxgi_swap_chain_desc.BufferDesc.Width = g_resolution_width;
-		dxgi_swap_chain_desc.BufferDesc.Height = g_resolution_height;
-		dxgi_swap_chain_desc.BufferDesc.RefreshRate.Numerator = 60U;
-		dxgi_swap_chain_desc.BufferDesc.RefreshRate.Denominator = 1U;
-		dxgi_swap_chain_desc.BufferDesc.Format = DXGI_FORMAT_B8G8R8A8_UNORM;
-		dxgi_swap_chain_desc.BufferDesc.ScanlineOrdering = DXGI_MODE_SCANLINE_ORDER_UNSPECIFIED;
-		dxgi_swap_chain_desc.BufferDesc.Scaling = DXGI_MODE_SCALING_UNSPECIFIED;
-		dxgi_swap_chain_desc.SampleDesc.Count = 1U;
-		dxgi_swap_chain_desc.SampleDesc.Quality = 0U;
-		dxgi_swap_chain_desc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
-		dxgi_swap_chain_desc.BufferCount = 1U;
-		dxgi_swap_chain_desc.OutputWindow = hWnd;
-		dxgi_swap_chain_desc.Windowed = TRUE;
-		dxgi_swap_chain_desc.SwapEffect = DXGI_SWAP_EFFECT_DISCARD;
-		dxgi_swap_chain_desc.Flags = 0U;
-		HRESULT res_dxgi_factory_create_swap_chain = dxgi_factory->CreateSwapChain(d3d11_device, &dxgi_swap_chain_desc, &dxgi_swap_chain);
-		assert(SUCCEEDED(res_dxgi_factory_create_swap_chain));
-
-		dxgi_adapter->Release();
-		dxgi_factory->Release();
-	}
+	RenderBackendD3D11 render_backend_d3d11;
+	render_backend_d3d11.Init(hWnd, g_resolution_width, g_resolution_height);
 
-	class Demo demo;
+	// elides the redundant commands before they reach the device context
+	RenderBackendStateTracker render_backend;
+	render_backend.Init(&render_backend_d3d11);
 
-	demo.Init(d3d11_device, d3d11_device_context, dxgi_swap_chain);
+	class Demo demo;
 
-	while (!g_window_quit)
+	demo_settings_t demo_settings;
+	demo_settings.shading_mode = DEMO_SHADING_MODE_FORWARD;
+	demo_settings.overdraw_layer_count = 1U;
+	demo_settings.depth_prepass = false;
+	demo_settings.checkerboard_shading = false;
+	demo_settings.auto_exposure = true;
+	// below the refresh interval of the vsync (60 Hz), such that the frame which would miss the vsync is scaled down before it misses
+	demo_settings.dynamic_resolution = true;
+	demo_settings.frame_time_budget_ms = 14.0f;
+	demo.Init(&render_backend, demo_settings);
+
+	uint32_t client_size = g_window_client_size.load(std::memory_order_relaxed);
+	std::chrono::steady_clock::time_point previous_frame_time = std::chrono::steady_clock::now();
+	uint64_t dropped_event_count = 0U;
+	while (!g_window_quit.load(std::memory_order_acquire))
 	{
-		demo.Tick(d3d11_device, d3d11_device_context, dxgi_swap_chain);
+		// the live resize: the window thread is NOT blocked by the render thread while the border is dragged
+		uint32_t const current_client_size = g_window_client_size.load(std::memory_order_relaxed);
+		if (current_client_size != client_size)
+		{
+			client_size = current_client_size;
+			demo.Resize(&render_backend, client_size >> 16U, client_size & 0XFFFFU);
+		}
+
+		// the events since the last frame, such that the camera is NOT changed during the frame
+		input_event_t event;
+		while (g_input_event_queue.Pop(&event))
+		{
+			g_camera_controller.ApplyInputEvent(event);
+		}
+
+		// the key event of the full ring is NOT lost: the keys of the events are released, and the keys still held by the window thread are pressed once the ring is drained past the dropped event
+		uint64_t const current_dropped_event_count = g_input_event_queue.GetDroppedEventCount();
+		if (current_dropped_event_count != dropped_event_count)
+		{
+			dropped_event_count = current_dropped_event_count;
+			g_camera_controller.ReleaseKeys();
+		}
+		uint32_t held_keys;
+		if (g_input_event_queue.ReconcileHeldKeys(&held_keys))
+		{
+			g_camera_controller.SetHeldKeys(held_keys);
+		}
+
+		// the camera moves by the time since the last frame, such that the speed does NOT depend on the frame rate
+		std::chrono::steady_clock::time_point const frame_time = std::chrono::steady_clock::now();
+		g_camera_controller.Update(std::chrono::duration<float>(frame_time - previous_frame_time).count());
+		previous_frame_time = frame_time;
+
+		demo.Tick(&render_backend);
 	}
 
-	d3d11_device_context->Release();
-	d3d11_device->Release();
+	demo.Destroy(&render_backend);
+
+	render_backend.Destroy();
+
+	render_backend_d3d11.Destroy();
 
 	return 0U;
 }
@@ -1,5 +1,6 @@
 #ifndef _RESOLUTION_H_
 #define _RESOLUTION_H_ 1
+// the default size of the backbuffer (the window and the "--width"/"--height" of the headless), the "Demo" reads the size from the backend at runtime
 static const int g_resolution_width = 512;
 static const int g_resolution_height = 512;
 #endif
\ No newline at end of file
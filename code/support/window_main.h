@@ -1,7 +1,16 @@
 #ifndef _WINDOW_MAIN_H_
 #define _WINDOW_MAIN_H_ 1
 
-// TODO: use Load/Store
-extern bool volatile g_window_quit;
+#include <stdint.h>
+#include <atomic>
+
+// written by the window thread (WM_DESTROY, release), polled by the render thread (acquire) which then exits
+extern std::atomic<bool> g_window_quit;
+
+// the size of the client area: (width << 16) | height, written by the window thread (WM_SIZE) and polled by the render thread (a single store, such that the width and the height are consistent)
+extern std::atomic<uint32_t> g_window_client_size;
+
+// the keys and the mouse of the window thread, drained by the render thread once per frame (see "input_event_queue.h")
+extern class InputEventQueue g_input_event_queue;
 
 #endif
\ No newline at end of file
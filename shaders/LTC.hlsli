@@ -18,19 +18,97 @@
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 //
 
+// The permutation is selected by the user before the "#include" (see "RENDER_BACKEND_PERMUTATION_BIT" in "code/backend/render_backend.h").
+// The default is the highest quality.
+// 0: Lambert, 1: Burley
+#ifndef LTC_PERMUTATION_DIFFUSE_BURLEY
+#define LTC_PERMUTATION_DIFFUSE_BURLEY 1
+#endif
+// 0: the single GGX lobe, 1: the dual specular lobes
+#ifndef LTC_PERMUTATION_DUAL_LOBE
+#define LTC_PERMUTATION_DUAL_LOBE 1
+#endif
+// 0: the quad straddling the horizon is approximated by the proxy sphere, 1: the quad is clipped to the horizon
+#ifndef LTC_PERMUTATION_HORIZON_CLIPPING
+#define LTC_PERMUTATION_HORIZON_CLIPPING 1
+#endif
+
 // This function is provided by the user
 void LTC_DECODE_GGX_LUT(float roughness, float NoV, out float3x3 linear_transform_inversed, out float n_d_norm, out float f_d_norm);
 
+// This function is provided by the user (only required by the textured quad)
+// [in] uv: The texture coordinate of the light image (NOT including the border). The vertex "0" of the quad is (0, 1), the vertex "1" is (1, 1) and the vertex "3" is (0, 0).
+// [in] footprint_radius: The radius of the filter footprint, in the unit of the size of the light image.
+float3 LTC_SAMPLE_FILTERED_LIGHT_TEXTURE(float2 uv, float footprint_radius);
+
 // [in] P: The surface position in world space.
 // [in] vertices_world_space: The vertices of the quad in world space. The facing of the quad is determined by the winding order of the vertices.
 float EvaluateBRDFLTCLightAttenuation(float3 P, float3 vertices_world_space[4]);
 
+// The quad against the horizon (the tangent plane) of the surface position.
+#define LTC_HORIZON_BELOW 0
+#define LTC_HORIZON_ABOVE 1
+#define LTC_HORIZON_STRADDLE 2
+
+// [in] P: The surface position in world space.
+// [in] N: The surface normal in world space.
+// [in] vertices_world_space: The vertices of the quad in world space.
+// The "EvaluateBRDFLTC" is NOT necessary if the quad is below the horizon, and the quad is clipped only if it straddles the horizon.
+int EvaluateBRDFLTCLightHorizon(float3 P, float3 N, float3 vertices_world_space[4]);
+
 // [in] P: The surface position in world space.
 // [in] N: The surface normal in world space.
 // [in] V: The outgoing direction in world space.
 // [in] vertices_world_space: The vertices of the quad in world space. The facing of the quad is determined by the winding order of the vertices.
 float3 EvaluateBRDFLTC(float3 diffuse_color, float roughness, float3 specular_color, float3 P, float3 N, float3 V, float3 vertices_world_space[4]);
 
+// [in] P: The surface position in world space.
+// [in] N: The surface normal in world space.
+// [in] V: The outgoing direction in world space.
+// [in] line_vertices_world_space: The end points of the line in world space.
+// [in] line_width: The line is regarded as a ribbon of infinitesimal width facing the surface position, the radiance is scaled by this width.
+float3 EvaluateBRDFLTCLine(float3 diffuse_color, float roughness, float3 specular_color, float3 P, float3 N, float3 V, float3 line_vertices_world_space[2], float line_width);
+
+// [in] P: The surface position in world space.
+// [in] N: The surface normal in world space.
+// [in] V: The outgoing direction in world space.
+// [in] tube_vertices_world_space: The end points of the axis of the tube (capsule) in world space.
+// [in] tube_radius: The radius of the tube (capsule).
+float3 EvaluateBRDFLTCTube(float3 diffuse_color, float roughness, float3 specular_color, float3 P, float3 N, float3 V, float3 tube_vertices_world_space[2], float tube_radius);
+
+// [in] P: The surface position in world space.
+// [in] disk_center_world_space: The center of the disk (ellipse) in world space.
+// [in] disk_axis_0_world_space: The first semi-axis of the disk (ellipse) in world space.
+// [in] disk_axis_1_world_space: The second semi-axis of the disk (ellipse) in world space. The facing of the disk is determined by the order of the axes (the same as the winding order of the quad).
+float EvaluateBRDFLTCDiskLightAttenuation(float3 P, float3 disk_center_world_space, float3 disk_axis_0_world_space, float3 disk_axis_1_world_space);
+
+// [in] P: The surface position in world space.
+// [in] N: The surface normal in world space.
+// [in] V: The outgoing direction in world space.
+// [in] disk_center_world_space: The center of the disk (ellipse) in world space.
+// [in] disk_axis_0_world_space: The first semi-axis of the disk (ellipse) in world space.
+// [in] disk_axis_1_world_space: The second semi-axis of the disk (ellipse) in world space. The facing of the disk is determined by the order of the axes (the same as the winding order of the quad).
+float3 EvaluateBRDFLTCDisk(float3 diffuse_color, float roughness, float3 specular_color, float3 P, float3 N, float3 V, float3 disk_center_world_space, float3 disk_axis_0_world_space, float3 disk_axis_1_world_space);
+
+// [in] P: The surface position in world space.
+// [in] N: The surface normal in world space.
+// [in] V: The outgoing direction in world space.
+// [in] sphere_center_world_space: The center of the sphere in world space.
+// [in] sphere_radius: The radius of the sphere.
+float3 EvaluateBRDFLTCSphere(float3 diffuse_color, float roughness, float3 specular_color, float3 P, float3 N, float3 V, float3 sphere_center_world_space, float sphere_radius);
+
+// [in] P: The surface position in world space.
+// [in] N: The surface normal in world space.
+// [in] V: The outgoing direction in world space.
+// [in] vertices_world_space: The vertices of the quad in world space. The facing of the quad is determined by the winding order of the vertices.
+// The radiance of the quad is modulated by the prefiltered light texture (see "LTC_SAMPLE_FILTERED_LIGHT_TEXTURE").
+float3 EvaluateBRDFLTCTextured(float3 diffuse_color, float roughness, float3 specular_color, float3 P, float3 N, float3 V, float3 vertices_world_space[4]);
+
+// [in] P: The surface position in world space.
+// [in] N: The surface normal in world space.
+// [in] V: The outgoing direction in world space.
+float4x4 EvaluateWorldToTangentTransform(float3 P, float3 N, float3 V);
+
 // [in] vertices_tangent_space: The vertices of the quad in tangent space. The facing of the quad is determined by the winding order of the vertices.
 float3 DiffuseLambertLTC(float3 diffuse_color, float3 vertices_tangent_space[4]);
 
@@ -43,12 +121,51 @@ float3 SpecularGGXLTC(float roughness, float3 specular_color, float3 N, float3 V
 // [in] vertices_tangent_space: The vertices of the quad in tangent space. The facing of the quad is determined by the winding order of the vertices.
 float3 DualSpecularGGXLTC(float material_roughness_0, float material_roughness_1, float material_lobe_mix, float subsurface_mask, float roughness, float3 specular_color, float3 N, float3 V, float3 vertices_tangent_space[4]);
 
+// [in] vertices_tangent_space: The vertices of the quad in tangent space. The facing of the quad is determined by the winding order of the vertices.
+float3 DiffuseLambertLTCTextured(float3 diffuse_color, float3 vertices_tangent_space[4]);
+
+// [in] vertices_tangent_space: The vertices of the quad in tangent space. The facing of the quad is determined by the winding order of the vertices.
+float3 DiffuseBurleyLTCTextured(float3 diffuse_color, float roughness, float3 N, float3 V, float3 vertices_tangent_space[4]);
+
+// [in] vertices_tangent_space: The vertices of the quad in tangent space. The facing of the quad is determined by the winding order of the vertices.
+float3 SpecularGGXLTCTextured(float roughness, float3 specular_color, float3 N, float3 V, float3 vertices_tangent_space[4]);
+
+// [in] vertices_tangent_space: The vertices of the quad in tangent space. The facing of the quad is determined by the winding order of the vertices.
+float3 DualSpecularGGXLTCTextured(float material_roughness_0, float material_roughness_1, float material_lobe_mix, float subsurface_mask, float roughness, float3 specular_color, float3 N, float3 V, float3 vertices_tangent_space[4]);
+
+// [in] vertices_cosine_space: The vertices of the quad in the space where the distribution is the clamped cosine.
+// [in] vector_form_factor: The vector form factor of the quad in the same space.
+float3 FetchFilteredLightTexture(float3 vertices_cosine_space[4], float3 vector_form_factor);
+
+// [in] line_vertices_tangent_space: The end points of the line in tangent space.
+float3 DiffuseBurleyLTCLine(float3 diffuse_color, float roughness, float3 N, float3 V, float3 line_vertices_tangent_space[2]);
+
+// [in] line_vertices_tangent_space: The end points of the line in tangent space.
+float3 SpecularGGXLTCLine(float roughness, float3 specular_color, float3 N, float3 V, float3 line_vertices_tangent_space[2]);
+
+// [in] line_vertices_tangent_space: The end points of the line in tangent space.
+float3 DualSpecularGGXLTCLine(float material_roughness_0, float material_roughness_1, float material_lobe_mix, float subsurface_mask, float roughness, float3 specular_color, float3 N, float3 V, float3 line_vertices_tangent_space[2]);
+
+// [in] disk_tangent_space: The center, the first semi-axis and the second semi-axis of the disk in tangent space.
+float3 DiffuseBurleyLTCDisk(float3 diffuse_color, float roughness, float3 N, float3 V, float3 disk_tangent_space[3]);
+
+// [in] disk_tangent_space: The center, the first semi-axis and the second semi-axis of the disk in tangent space.
+float3 SpecularGGXLTCDisk(float roughness, float3 specular_color, float3 N, float3 V, float3 disk_tangent_space[3]);
+
+// [in] disk_tangent_space: The center, the first semi-axis and the second semi-axis of the disk in tangent space.
+float3 DualSpecularGGXLTCDisk(float material_roughness_0, float material_roughness_1, float material_lobe_mix, float subsurface_mask, float roughness, float3 specular_color, float3 N, float3 V, float3 disk_tangent_space[3]);
+
 // [in] vertices_tangent_space: The vertices of the quad in tangent space. The facing of the quad is determined by the winding order of the vertices.
 float EvaluateFormFactorOverQuad(float3 vertices_tangent_space[4]);
 
 // [in] vertices_tangent_space: The vertices of the quad in tangent space. The facing of the quad is determined by the winding order of the vertices.
 float3 EvaluateVectorFormFactorOverQuad(float3 vertices_tangent_space[4]);
 
+// [in] linear_transform_inversed: The inverse of the LTC matrix. The identity matrix means the clamped cosine distribution.
+// [in] vertices_tangent_space: The vertices of the quad in tangent space (NOT linear transformed). The facing of the quad is determined by the winding order of the vertices.
+// The quad is clipped to the upper hemisphere in tangent space before the linear transform, the result is in the linear transformed space.
+float3 EvaluateVectorFormFactorOverQuadClipped(float3x3 linear_transform_inversed, float3 vertices_tangent_space[4]);
+
 // [in] v1: The first normalized vertex which is projected onto the sphere. The facing of the quad is determined by the winding order of the vertices.
 // [in] v2: The second normalized vertex which is projected onto the sphere. The facing of the quad is determined by the winding order of the vertices.
 float3 EvaluateVectorFormFactorOverQuadEdge(float3 v1, float3 v2);
@@ -57,6 +174,24 @@ float3 EvaluateVectorFormFactorOverQuadEdge(float3 v1, float3 v2);
 // [in] sin_angular_extent : implies the length of the vector irrandiance of the sphere proxy
 float EvaluateFormFactorOverSphere(float cos_elevation_angle, float sin_angular_extent);
 
+// [in] vector_form_factor_over_disk: The "EvaluateVectorFormFactorOverDisk" of the disk (ellipse), which the caller may also use (e.g. the direction of the diffuse), such that it is computed once.
+float EvaluateFormFactorOverDisk(float3 vector_form_factor_over_disk);
+
+// [in] disk_tangent_space: The center, the first semi-axis and the second semi-axis of the disk (ellipse) in tangent space.
+float3 EvaluateVectorFormFactorOverDisk(float3 disk_tangent_space[3]);
+
+// [in] coefficient: c0 + c1·x + c2·x² + c3·x³ = 0
+// The three real roots are returned (the middle root is the "y" component).
+float3 SolveCubic(float4 coefficient);
+
+// [in] linear_transform_inversed: The inverse of the LTC matrix. The identity matrix means the clamped cosine distribution.
+// [in] line_vertices_tangent_space: The end points of the line in tangent space (NOT linear transformed).
+// The result is the form factor per unit width of the line.
+float EvaluateFormFactorOverLine(float3x3 linear_transform_inversed, float3 line_vertices_tangent_space[2]);
+
+// [in] line_vertices_cosine_space: The end points of the line in the space where the distribution is the clamped cosine.
+float EvaluateFormFactorOverLineCosine(float3 line_vertices_cosine_space[2]);
+
 float EvaluateBRDFLTCLightAttenuation(float3 P, float3 vertices_world_space[4])
 {
 	if (dot((vertices_world_space[0].xyz - P), (cross(vertices_world_space[1] - vertices_world_space[0], vertices_world_space[2] - vertices_world_space[0]))) > 0.0)
@@ -67,11 +202,34 @@ float EvaluateBRDFLTCLightAttenuation(float3 P, float3 vertices_world_space[4])
 	else
 	{
 		// back face
-		// TODO: some parts of the quad may still in the upper hemisphere 
+		// The horizon of the surface position is handled by the "EvaluateBRDFLTCLightHorizon".
 		return 0.0;
 	}
 }
 
+int EvaluateBRDFLTCLightHorizon(float3 P, float3 N, float3 vertices_world_space[4])
+{
+	// The same as the "z" of the vertices in tangent space.
+	float4 heights = float4(
+		dot(N, vertices_world_space[0] - P),
+		dot(N, vertices_world_space[1] - P),
+		dot(N, vertices_world_space[2] - P),
+		dot(N, vertices_world_space[3] - P));
+
+	if (all(heights > 0.0))
+	{
+		return LTC_HORIZON_ABOVE;
+	}
+	else if (any(heights > 0.0))
+	{
+		return LTC_HORIZON_STRADDLE;
+	}
+	else
+	{
+		return LTC_HORIZON_BELOW;
+	}
+}
+
 float3 EvaluateBRDFLTC(float3 diffuse_color, float roughness, float3 specular_color, float3 P, float3 N, float3 V, float3 vertices_world_space[4])
 {
 	float3 radiance = float3(0.0, 0.0, 0.0);
@@ -79,17 +237,7 @@ float3 EvaluateBRDFLTC(float3 diffuse_color, float roughness, float3 specular_co
 	// Transform the vertices to the tangent space of the current shading position.
 	float3 vertices_tangent_space[4];
 	{
-		// The LUTs are precomputed by assuming that the outgoing direction V is in the XOY plane, since the GGX BRDF is isotropic.
-		float3 T1 = normalize(V - N * dot(V, N));
-
-		float3 T2 = cross(N, T1);
-
-		float4x4 world_to_tangent_transform = float4x4(
-			float4(T1, dot(T1, -P)),   // row 0
-			float4(T2, dot(T2, -P)),   // row 1
-			float4(N, dot(N, -P)),	   // row 2
-			float4(0.0, 0.0, 0.0, 1.0) // row 3
-			);
+		float4x4 world_to_tangent_transform = EvaluateWorldToTangentTransform(P, N, V);
 
 		vertices_tangent_space[0] = mul(world_to_tangent_transform, float4(vertices_world_space[0], 1.0)).xyz;
 		vertices_tangent_space[1] = mul(world_to_tangent_transform, float4(vertices_world_space[1], 1.0)).xyz;
@@ -97,18 +245,171 @@ float3 EvaluateBRDFLTC(float3 diffuse_color, float roughness, float3 specular_co
 		vertices_tangent_space[3] = mul(world_to_tangent_transform, float4(vertices_world_space[3], 1.0)).xyz;
 	}
 
-	// radiance += DiffuseLambertLTC(diffuse_color, vertices_tangent_space);
+#if LTC_PERMUTATION_DIFFUSE_BURLEY
 	radiance += DiffuseBurleyLTC(diffuse_color, roughness, N, V, vertices_tangent_space);
+#else
+	radiance += DiffuseLambertLTC(diffuse_color, vertices_tangent_space);
+#endif
 
-	// radiance += SpecularGGXLTC(roughness, specular_color, N, V, vertices_tangent_space);
+#if LTC_PERMUTATION_DUAL_LOBE
 	radiance += DualSpecularGGXLTC(0.75, 1.30, 0.85, 1.0, roughness, specular_color, N, V, vertices_tangent_space);
+#else
+	radiance += SpecularGGXLTC(roughness, specular_color, N, V, vertices_tangent_space);
+#endif
+
+	return radiance;
+}
+
+float3 EvaluateBRDFLTCLine(float3 diffuse_color, float roughness, float3 specular_color, float3 P, float3 N, float3 V, float3 line_vertices_world_space[2], float line_width)
+{
+	float3 radiance = float3(0.0, 0.0, 0.0);
+
+	// Transform the end points to the tangent space of the current shading position.
+	float3 line_vertices_tangent_space[2];
+	{
+		float4x4 world_to_tangent_transform = EvaluateWorldToTangentTransform(P, N, V);
+
+		line_vertices_tangent_space[0] = mul(world_to_tangent_transform, float4(line_vertices_world_space[0], 1.0)).xyz;
+		line_vertices_tangent_space[1] = mul(world_to_tangent_transform, float4(line_vertices_world_space[1], 1.0)).xyz;
+	}
+
+	radiance += DiffuseBurleyLTCLine(diffuse_color, roughness, N, V, line_vertices_tangent_space);
+
+	radiance += DualSpecularGGXLTCLine(0.75, 1.30, 0.85, 1.0, roughness, specular_color, N, V, line_vertices_tangent_space);
+
+	return radiance * line_width;
+}
+
+float3 EvaluateBRDFLTCTube(float3 diffuse_color, float roughness, float3 specular_color, float3 P, float3 N, float3 V, float3 tube_vertices_world_space[2], float tube_radius)
+{
+	// [Heitz 2017] [Eric Heitz, Stephen Hill. "Real-Time Line- and Disk-Light Shading." SIGGRAPH 2017.](https://blog.selfshadow.com/publications/s2017-shading-course/)
+	// The cylinder is approximated by the line of which the width is the diameter of the cylinder.
+
+	// Capsule approximation:
+	// The projected area of the two hemispherical caps is π·r·r, which equals the area of a ribbon of width 2·r and length π·r/2.
+	// Thus the caps are approximated by extending each end point of the axis by π·r/4.
+	float3 tube_axis = tube_vertices_world_space[1] - tube_vertices_world_space[0];
+	float3 cap_extent = tube_axis * ((PI * 0.25 * tube_radius) / max(length(tube_axis), 1e-7));
+
+	float3 line_vertices_world_space[2] = {
+		tube_vertices_world_space[0] - cap_extent,
+		tube_vertices_world_space[1] + cap_extent };
+
+	return EvaluateBRDFLTCLine(diffuse_color, roughness, specular_color, P, N, V, line_vertices_world_space, 2.0 * tube_radius);
+}
+
+float EvaluateBRDFLTCDiskLightAttenuation(float3 P, float3 disk_center_world_space, float3 disk_axis_0_world_space, float3 disk_axis_1_world_space)
+{
+	if (dot((disk_center_world_space - P), cross(disk_axis_0_world_space, disk_axis_1_world_space)) > 0.0)
+	{
+		// front face
+		return 1.0;
+	}
+	else
+	{
+		// back face
+		return 0.0;
+	}
+}
+
+float3 EvaluateBRDFLTCDisk(float3 diffuse_color, float roughness, float3 specular_color, float3 P, float3 N, float3 V, float3 disk_center_world_space, float3 disk_axis_0_world_space, float3 disk_axis_1_world_space)
+{
+	float3 radiance = float3(0.0, 0.0, 0.0);
+
+	// Transform the disk to the tangent space of the current shading position.
+	float3 disk_tangent_space[3];
+	{
+		float4x4 world_to_tangent_transform = EvaluateWorldToTangentTransform(P, N, V);
+
+		disk_tangent_space[0] = mul(world_to_tangent_transform, float4(disk_center_world_space, 1.0)).xyz;
+		disk_tangent_space[1] = mul(world_to_tangent_transform, float4(disk_axis_0_world_space, 0.0)).xyz;
+		disk_tangent_space[2] = mul(world_to_tangent_transform, float4(disk_axis_1_world_space, 0.0)).xyz;
+	}
+
+	radiance += DiffuseBurleyLTCDisk(diffuse_color, roughness, N, V, disk_tangent_space);
+
+	radiance += DualSpecularGGXLTCDisk(0.75, 1.30, 0.85, 1.0, roughness, specular_color, N, V, disk_tangent_space);
 
 	return radiance;
 }
 
+float3 EvaluateBRDFLTCSphere(float3 diffuse_color, float roughness, float3 specular_color, float3 P, float3 N, float3 V, float3 sphere_center_world_space, float sphere_radius)
+{
+	// The sphere is replaced by the silhouette disk as seen from the shading position, which subtends exactly the same solid angle.
+	// The disk always faces the shading position.
+	float3 to_center = sphere_center_world_space - P;
+	float distance_squared = max(dot(to_center, to_center), 1e-7);
+	// The shading position is NOT allowed to be inside the sphere.
+	float radius_squared = min(sphere_radius * sphere_radius, 0.999 * distance_squared);
+
+	float silhouette_scale = 1.0 - radius_squared / distance_squared;
+	float3 disk_center_world_space = P + to_center * silhouette_scale;
+	float disk_radius = sqrt(radius_squared * silhouette_scale);
+
+	float3 W = to_center * rsqrt(distance_squared);
+	float3 T1 = normalize(cross(W, (abs(W.y) < 0.999) ? float3(0.0, 1.0, 0.0) : float3(1.0, 0.0, 0.0)));
+	float3 T2 = cross(W, T1);
+
+	// cross(T1, T2) = W: the front face
+	return EvaluateBRDFLTCDisk(diffuse_color, roughness, specular_color, P, N, V, disk_center_world_space, T1 * disk_radius, T2 * disk_radius);
+}
+
+float3 EvaluateBRDFLTCTextured(float3 diffuse_color, float roughness, float3 specular_color, float3 P, float3 N, float3 V, float3 vertices_world_space[4])
+{
+	float3 radiance = float3(0.0, 0.0, 0.0);
+
+	// Transform the vertices to the tangent space of the current shading position.
+	float3 vertices_tangent_space[4];
+	{
+		float4x4 world_to_tangent_transform = EvaluateWorldToTangentTransform(P, N, V);
+
+		vertices_tangent_space[0] = mul(world_to_tangent_transform, float4(vertices_world_space[0], 1.0)).xyz;
+		vertices_tangent_space[1] = mul(world_to_tangent_transform, float4(vertices_world_space[1], 1.0)).xyz;
+		vertices_tangent_space[2] = mul(world_to_tangent_transform, float4(vertices_world_space[2], 1.0)).xyz;
+		vertices_tangent_space[3] = mul(world_to_tangent_transform, float4(vertices_world_space[3], 1.0)).xyz;
+	}
+
+#if LTC_PERMUTATION_DIFFUSE_BURLEY
+	radiance += DiffuseBurleyLTCTextured(diffuse_color, roughness, N, V, vertices_tangent_space);
+#else
+	radiance += DiffuseLambertLTCTextured(diffuse_color, vertices_tangent_space);
+#endif
+
+#if LTC_PERMUTATION_DUAL_LOBE
+	radiance += DualSpecularGGXLTCTextured(0.75, 1.30, 0.85, 1.0, roughness, specular_color, N, V, vertices_tangent_space);
+#else
+	radiance += SpecularGGXLTCTextured(roughness, specular_color, N, V, vertices_tangent_space);
+#endif
+
+	return radiance;
+}
+
+float4x4 EvaluateWorldToTangentTransform(float3 P, float3 N, float3 V)
+{
+	// The LUTs are precomputed by assuming that the outgoing direction V is in the XOY plane, since the GGX BRDF is isotropic.
+	float3 T1 = normalize(V - N * dot(V, N));
+
+	float3 T2 = cross(N, T1);
+
+	float4x4 world_to_tangent_transform = float4x4(
+		float4(T1, dot(T1, -P)),   // row 0
+		float4(T2, dot(T2, -P)),   // row 1
+		float4(N, dot(N, -P)),	   // row 2
+		float4(0.0, 0.0, 0.0, 1.0) // row 3
+		);
+
+	return world_to_tangent_transform;
+}
+
 float3 DiffuseLambertLTC(float3 diffuse_color, float3 vertices_tangent_space[4])
 {
-	float form_factor_over_quad = EvaluateFormFactorOverQuad(vertices_tangent_space);
+	float3x3 identity = float3x3(
+		float3(1.0, 0.0, 0.0), // row 0
+		float3(0.0, 1.0, 0.0), // row 1
+		float3(0.0, 0.0, 1.0)  // row 2
+	);
+	float3 vector_form_factor_over_quad = EvaluateVectorFormFactorOverQuadClipped(identity, vertices_tangent_space);
+	float form_factor_over_quad = EvaluateFormFactorOverSphere(normalize(vector_form_factor_over_quad).z, sqrt(length(vector_form_factor_over_quad)));
 
 	float3 radiance_diffuse = Diffuse_Lambert(diffuse_color) * PI * form_factor_over_quad;
 	return radiance_diffuse;
@@ -116,8 +417,13 @@ float3 DiffuseLambertLTC(float3 diffuse_color, float3 vertices_tangent_space[4])
 
 float3 DiffuseBurleyLTC(float3 diffuse_color, float roughness, float3 N, float3 V, float3 vertices_tangent_space[4])
 {
-	float3 vector_form_factor_over_quad = EvaluateVectorFormFactorOverQuad(vertices_tangent_space);
-	float form_factor_over_quad = EvaluateFormFactorOverQuad(vertices_tangent_space);
+	float3x3 identity = float3x3(
+		float3(1.0, 0.0, 0.0), // row 0
+		float3(0.0, 1.0, 0.0), // row 1
+		float3(0.0, 0.0, 1.0)  // row 2
+	);
+	float3 vector_form_factor_over_quad = EvaluateVectorFormFactorOverQuadClipped(identity, vertices_tangent_space);
+	float form_factor_over_quad = EvaluateFormFactorOverSphere(normalize(vector_form_factor_over_quad).z, sqrt(length(vector_form_factor_over_quad)));
 
 	// UE4: RectIrradianceLambert
 	float3 L = normalize(vector_form_factor_over_quad);
@@ -140,6 +446,85 @@ float3 SpecularGGXLTC(float roughness, float3 specular_color, float3 N, float3 V
 	float f_d_norm;
 	LTC_DECODE_GGX_LUT(roughness, saturate(dot(N, V)), linear_transform_inversed, n_d_norm, f_d_norm);
 
+	// LT "linear transform"
+	float3 vector_form_factor_over_quad = EvaluateVectorFormFactorOverQuadClipped(linear_transform_inversed, vertices_tangent_space);
+	float form_factor_over_quad = EvaluateFormFactorOverSphere(normalize(vector_form_factor_over_quad).z, sqrt(length(vector_form_factor_over_quad)));
+
+	// [Hill 2016] [Stephen Hill. "LTC Fresnel Approximation." SIGGRAPH 2016.](https://blog.selfshadow.com/publications/s2016-advances/)
+	float3 radiance_specular = specular_color * n_d_norm * form_factor_over_quad + (1.0 - specular_color) * f_d_norm * form_factor_over_quad;
+
+	return radiance_specular;
+}
+
+float3 DualSpecularGGXLTC(float material_roughness_0, float material_roughness_1, float material_lobe_mix, float subsurface_mask, float roughness, float3 specular_color, float3 N, float3 V, float3 vertices_tangent_space[4])
+{
+	float material_roughness_average = lerp(material_roughness_0, material_roughness_1, material_lobe_mix);
+	float average_to_roughness_0 = material_roughness_0 / material_roughness_average;
+	float average_to_roughness_1 = material_roughness_1 / material_roughness_average;
+
+	float surface_roughness_average = roughness;
+	float surface_roughness_0 = max(saturate(average_to_roughness_0 * surface_roughness_average), 0.02);
+	float surface_roughness_1 = saturate(average_to_roughness_1 * surface_roughness_average);
+
+	// UE4: SubsurfaceProfileBxDF
+	surface_roughness_0 = lerp(1.0f, surface_roughness_0, saturate(10.0 * subsurface_mask));
+	surface_roughness_1 = lerp(1.0f, surface_roughness_1, saturate(10.0 * subsurface_mask));
+
+	float3 radiance_specular_0 = SpecularGGXLTC(surface_roughness_0, specular_color, N, V, vertices_tangent_space);
+	float3 radiance_specular_1 = SpecularGGXLTC(surface_roughness_1, specular_color, N, V, vertices_tangent_space);
+	float3 radiance_specular = lerp(radiance_specular_0, radiance_specular_1, material_lobe_mix);
+	return radiance_specular;
+}
+
+float3 DiffuseLambertLTCTextured(float3 diffuse_color, float3 vertices_tangent_space[4])
+{
+	float3x3 identity = float3x3(
+		float3(1.0, 0.0, 0.0), // row 0
+		float3(0.0, 1.0, 0.0), // row 1
+		float3(0.0, 0.0, 1.0)  // row 2
+	);
+	float3 vector_form_factor_over_quad = EvaluateVectorFormFactorOverQuadClipped(identity, vertices_tangent_space);
+	float form_factor_over_quad = EvaluateFormFactorOverSphere(normalize(vector_form_factor_over_quad).z, sqrt(length(vector_form_factor_over_quad)));
+
+	// The tangent space is the space where the diffuse distribution is the clamped cosine.
+	float3 light_color = FetchFilteredLightTexture(vertices_tangent_space, vector_form_factor_over_quad);
+
+	float3 radiance_diffuse = Diffuse_Lambert(diffuse_color) * PI * form_factor_over_quad * light_color;
+	return radiance_diffuse;
+}
+
+float3 DiffuseBurleyLTCTextured(float3 diffuse_color, float roughness, float3 N, float3 V, float3 vertices_tangent_space[4])
+{
+	float3x3 identity = float3x3(
+		float3(1.0, 0.0, 0.0), // row 0
+		float3(0.0, 1.0, 0.0), // row 1
+		float3(0.0, 0.0, 1.0)  // row 2
+	);
+	float3 vector_form_factor_over_quad = EvaluateVectorFormFactorOverQuadClipped(identity, vertices_tangent_space);
+	float form_factor_over_quad = EvaluateFormFactorOverSphere(normalize(vector_form_factor_over_quad).z, sqrt(length(vector_form_factor_over_quad)));
+
+	// UE4: RectIrradianceLambert
+	float3 L = normalize(vector_form_factor_over_quad);
+	float NoL = form_factor_over_quad / length(vector_form_factor_over_quad);
+
+	float3 H = normalize(V + L);
+	float NoV = saturate(dot(N, V));
+	float VoH = saturate(dot(V, H));
+
+	// The tangent space is the space where the diffuse distribution is the clamped cosine.
+	float3 light_color = FetchFilteredLightTexture(vertices_tangent_space, vector_form_factor_over_quad);
+
+	float3 radiance_diffuse = Diffuse_Burley(diffuse_color, roughness, NoV, NoL, VoH) * PI * form_factor_over_quad * light_color;
+	return radiance_diffuse;
+}
+
+float3 SpecularGGXLTCTextured(float roughness, float3 specular_color, float3 N, float3 V, float3 vertices_tangent_space[4])
+{
+	float3x3 linear_transform_inversed;
+	float n_d_norm;
+	float f_d_norm;
+	LTC_DECODE_GGX_LUT(roughness, saturate(dot(N, V)), linear_transform_inversed, n_d_norm, f_d_norm);
+
 	// LT "linear transform"
 	float3 vertices_tangent_space_linear_transformed[4] = {
 		mul(linear_transform_inversed, vertices_tangent_space[0]),
@@ -147,15 +532,19 @@ float3 SpecularGGXLTC(float roughness, float3 specular_color, float3 N, float3 V
 		mul(linear_transform_inversed, vertices_tangent_space[2]),
 		mul(linear_transform_inversed, vertices_tangent_space[3]) };
 
-	float form_factor_over_quad = EvaluateFormFactorOverQuad(vertices_tangent_space_linear_transformed);
+	// The vector form factor is reused by the texture lookup (the plane of the light is NOT changed by the clipping).
+	float3 vector_form_factor_over_quad = EvaluateVectorFormFactorOverQuadClipped(linear_transform_inversed, vertices_tangent_space);
+	float form_factor_over_quad = EvaluateFormFactorOverSphere(normalize(vector_form_factor_over_quad).z, sqrt(length(vector_form_factor_over_quad)));
+
+	float3 light_color = FetchFilteredLightTexture(vertices_tangent_space_linear_transformed, vector_form_factor_over_quad);
 
 	// [Hill 2016] [Stephen Hill. "LTC Fresnel Approximation." SIGGRAPH 2016.](https://blog.selfshadow.com/publications/s2016-advances/)
-	float3 radiance_specular = specular_color * n_d_norm * form_factor_over_quad + (1.0 - specular_color) * f_d_norm * form_factor_over_quad;
+	float3 radiance_specular = (specular_color * n_d_norm * form_factor_over_quad + (1.0 - specular_color) * f_d_norm * form_factor_over_quad) * light_color;
 
 	return radiance_specular;
 }
 
-float3 DualSpecularGGXLTC(float material_roughness_0, float material_roughness_1, float material_lobe_mix, float subsurface_mask, float roughness, float3 specular_color, float3 N, float3 V, float3 vertices_tangent_space[4])
+float3 DualSpecularGGXLTCTextured(float material_roughness_0, float material_roughness_1, float material_lobe_mix, float subsurface_mask, float roughness, float3 specular_color, float3 N, float3 V, float3 vertices_tangent_space[4])
 {
 	float material_roughness_average = lerp(material_roughness_0, material_roughness_1, material_lobe_mix);
 	float average_to_roughness_0 = material_roughness_0 / material_roughness_average;
@@ -169,8 +558,162 @@ float3 DualSpecularGGXLTC(float material_roughness_0, float material_roughness_1
 	surface_roughness_0 = lerp(1.0f, surface_roughness_0, saturate(10.0 * subsurface_mask));
 	surface_roughness_1 = lerp(1.0f, surface_roughness_1, saturate(10.0 * subsurface_mask));
 
-	float3 radiance_specular_0 = SpecularGGXLTC(surface_roughness_0, specular_color, N, V, vertices_tangent_space);
-	float3 radiance_specular_1 = SpecularGGXLTC(surface_roughness_1, specular_color, N, V, vertices_tangent_space);
+	float3 radiance_specular_0 = SpecularGGXLTCTextured(surface_roughness_0, specular_color, N, V, vertices_tangent_space);
+	float3 radiance_specular_1 = SpecularGGXLTCTextured(surface_roughness_1, specular_color, N, V, vertices_tangent_space);
+	float3 radiance_specular = lerp(radiance_specular_0, radiance_specular_1, material_lobe_mix);
+	return radiance_specular;
+}
+
+float3 FetchFilteredLightTexture(float3 vertices_cosine_space[4], float3 vector_form_factor)
+{
+	// [Heitz 2016] [Eric Heitz, Jonathan Dupuy, Stephen Hill, David Neubelt. "Real-Time Polygonal-Light Shading with Linearly Transformed Cosines." SIGGRAPH 2016.](https://eheitzresearch.wordpress.com/415-2/)
+	// 5.2 Textured Polygonal Lights
+
+	float3 V1 = vertices_cosine_space[1] - vertices_cosine_space[0];
+	float3 V2 = vertices_cosine_space[3] - vertices_cosine_space[0];
+	float3 plane_normal = cross(V1, V2);
+	float plane_area_squared = dot(plane_normal, plane_normal);
+	float plane_distance_x_plane_area = dot(plane_normal, vertices_cosine_space[0]);
+
+	// The lookup position is the intersection of the light plane and the direction of the vector form factor (the average direction of the cosine distribution over the light).
+	// The orthogonal projection of the shading position is used if the direction is parallel to (or points away from) the light plane.
+	float direction_o_normal = dot(vector_form_factor, plane_normal);
+	float3 lookup_position = ((direction_o_normal * plane_distance_x_plane_area) > 0.0) ? (vector_form_factor * (plane_distance_x_plane_area / direction_o_normal)) : (plane_normal * (plane_distance_x_plane_area / plane_area_squared));
+
+	// Solve "lookup_position - vertex0 = s·V1 + t·V2" (the quad is NOT necessarily a rectangle after the linear transform).
+	float3 P_local = lookup_position - vertices_cosine_space[0];
+	float dot_V1_V2 = dot(V1, V2);
+	float inv_dot_V1_V1 = 1.0 / dot(V1, V1);
+	float3 V2_orthogonal = V2 - V1 * dot_V1_V2 * inv_dot_V1_V1;
+	float t = dot(V2_orthogonal, P_local) / dot(V2_orthogonal, V2_orthogonal);
+	float s = (dot(V1, P_local) - t * dot_V1_V2) * inv_dot_V1_V1;
+
+	// The footprint of the cosine distribution grows with the distance to the light plane, relative to the size of the light.
+	float footprint_radius = abs(plane_distance_x_plane_area) / pow(plane_area_squared, 0.75);
+
+	return LTC_SAMPLE_FILTERED_LIGHT_TEXTURE(float2(s, 1.0 - t), footprint_radius);
+}
+
+float3 DiffuseBurleyLTCLine(float3 diffuse_color, float roughness, float3 N, float3 V, float3 line_vertices_tangent_space[2])
+{
+	float3x3 identity = float3x3(
+		float3(1.0, 0.0, 0.0), // row 0
+		float3(0.0, 1.0, 0.0), // row 1
+		float3(0.0, 0.0, 1.0)  // row 2
+	);
+	float form_factor_over_line = EvaluateFormFactorOverLine(identity, line_vertices_tangent_space);
+
+	// The vector form factor is not available for the line.
+	// The direction to the closest point on the line is used as the representative direction.
+	float3 line_direction = line_vertices_tangent_space[1] - line_vertices_tangent_space[0];
+	float closest_t = saturate(dot(-line_vertices_tangent_space[0], line_direction) / max(dot(line_direction, line_direction), 1e-7));
+	float3 L_tangent_space = normalize(line_vertices_tangent_space[0] + line_direction * closest_t);
+
+	// The tangent space is (T1, T2, N) and V is in the XOZ plane.
+	float NoV = saturate(dot(N, V));
+	float3 V_tangent_space = float3(sqrt(1.0 - NoV * NoV), 0.0, NoV);
+
+	float3 H = normalize(V_tangent_space + L_tangent_space);
+	float NoL = saturate(L_tangent_space.z);
+	float VoH = saturate(dot(V_tangent_space, H));
+
+	float3 radiance_diffuse = Diffuse_Burley(diffuse_color, roughness, NoV, NoL, VoH) * PI * form_factor_over_line;
+	return radiance_diffuse;
+}
+
+float3 SpecularGGXLTCLine(float roughness, float3 specular_color, float3 N, float3 V, float3 line_vertices_tangent_space[2])
+{
+	float3x3 linear_transform_inversed;
+	float n_d_norm;
+	float f_d_norm;
+	LTC_DECODE_GGX_LUT(roughness, saturate(dot(N, V)), linear_transform_inversed, n_d_norm, f_d_norm);
+
+	float form_factor_over_line = EvaluateFormFactorOverLine(linear_transform_inversed, line_vertices_tangent_space);
+
+	// [Hill 2016] [Stephen Hill. "LTC Fresnel Approximation." SIGGRAPH 2016.](https://blog.selfshadow.com/publications/s2016-advances/)
+	float3 radiance_specular = specular_color * n_d_norm * form_factor_over_line + (1.0 - specular_color) * f_d_norm * form_factor_over_line;
+
+	return radiance_specular;
+}
+
+float3 DualSpecularGGXLTCLine(float material_roughness_0, float material_roughness_1, float material_lobe_mix, float subsurface_mask, float roughness, float3 specular_color, float3 N, float3 V, float3 line_vertices_tangent_space[2])
+{
+	float material_roughness_average = lerp(material_roughness_0, material_roughness_1, material_lobe_mix);
+	float average_to_roughness_0 = material_roughness_0 / material_roughness_average;
+	float average_to_roughness_1 = material_roughness_1 / material_roughness_average;
+
+	float surface_roughness_average = roughness;
+	float surface_roughness_0 = max(saturate(average_to_roughness_0 * surface_roughness_average), 0.02);
+	float surface_roughness_1 = saturate(average_to_roughness_1 * surface_roughness_average);
+
+	// UE4: SubsurfaceProfileBxDF
+	surface_roughness_0 = lerp(1.0f, surface_roughness_0, saturate(10.0 * subsurface_mask));
+	surface_roughness_1 = lerp(1.0f, surface_roughness_1, saturate(10.0 * subsurface_mask));
+
+	float3 radiance_specular_0 = SpecularGGXLTCLine(surface_roughness_0, specular_color, N, V, line_vertices_tangent_space);
+	float3 radiance_specular_1 = SpecularGGXLTCLine(surface_roughness_1, specular_color, N, V, line_vertices_tangent_space);
+	float3 radiance_specular = lerp(radiance_specular_0, radiance_specular_1, material_lobe_mix);
+	return radiance_specular;
+}
+
+float3 DiffuseBurleyLTCDisk(float3 diffuse_color, float roughness, float3 N, float3 V, float3 disk_tangent_space[3])
+{
+	float3 vector_form_factor_over_disk = EvaluateVectorFormFactorOverDisk(disk_tangent_space);
+	float form_factor_over_disk = EvaluateFormFactorOverDisk(vector_form_factor_over_disk);
+
+	// UE4: RectIrradianceLambert
+	float3 L_tangent_space = normalize(vector_form_factor_over_disk);
+	float NoL = form_factor_over_disk / length(vector_form_factor_over_disk);
+
+	// The tangent space is (T1, T2, N) and V is in the XOZ plane.
+	float NoV = saturate(dot(N, V));
+	float3 V_tangent_space = float3(sqrt(1.0 - NoV * NoV), 0.0, NoV);
+
+	float3 H = normalize(V_tangent_space + L_tangent_space);
+	float VoH = saturate(dot(V_tangent_space, H));
+
+	float3 radiance_diffuse = Diffuse_Burley(diffuse_color, roughness, NoV, NoL, VoH) * PI * form_factor_over_disk;
+	return radiance_diffuse;
+}
+
+float3 SpecularGGXLTCDisk(float roughness, float3 specular_color, float3 N, float3 V, float3 disk_tangent_space[3])
+{
+	float3x3 linear_transform_inversed;
+	float n_d_norm;
+	float f_d_norm;
+	LTC_DECODE_GGX_LUT(roughness, saturate(dot(N, V)), linear_transform_inversed, n_d_norm, f_d_norm);
+
+	// LT "linear transform"
+	// The disk is transformed to the ellipse (the linear transform preserves the center and the conjugate semi-axes).
+	float3 disk_tangent_space_linear_transformed[3] = {
+		mul(linear_transform_inversed, disk_tangent_space[0]),
+		mul(linear_transform_inversed, disk_tangent_space[1]),
+		mul(linear_transform_inversed, disk_tangent_space[2]) };
+
+	float form_factor_over_disk = EvaluateFormFactorOverDisk(EvaluateVectorFormFactorOverDisk(disk_tangent_space_linear_transformed));
+
+	// [Hill 2016] [Stephen Hill. "LTC Fresnel Approximation." SIGGRAPH 2016.](https://blog.selfshadow.com/publications/s2016-advances/)
+	float3 radiance_specular = specular_color * n_d_norm * form_factor_over_disk + (1.0 - specular_color) * f_d_norm * form_factor_over_disk;
+
+	return radiance_specular;
+}
+
+float3 DualSpecularGGXLTCDisk(float material_roughness_0, float material_roughness_1, float material_lobe_mix, float subsurface_mask, float roughness, float3 specular_color, float3 N, float3 V, float3 disk_tangent_space[3])
+{
+	float material_roughness_average = lerp(material_roughness_0, material_roughness_1, material_lobe_mix);
+	float average_to_roughness_0 = material_roughness_0 / material_roughness_average;
+	float average_to_roughness_1 = material_roughness_1 / material_roughness_average;
+
+	float surface_roughness_average = roughness;
+	float surface_roughness_0 = max(saturate(average_to_roughness_0 * surface_roughness_average), 0.02);
+	float surface_roughness_1 = saturate(average_to_roughness_1 * surface_roughness_average);
+
+	// UE4: SubsurfaceProfileBxDF
+	surface_roughness_0 = lerp(1.0f, surface_roughness_0, saturate(10.0 * subsurface_mask));
+	surface_roughness_1 = lerp(1.0f, surface_roughness_1, saturate(10.0 * subsurface_mask));
+
+	float3 radiance_specular_0 = SpecularGGXLTCDisk(surface_roughness_0, specular_color, N, V, disk_tangent_space);
+	float3 radiance_specular_1 = SpecularGGXLTCDisk(surface_roughness_1, specular_color, N, V, disk_tangent_space);
 	float3 radiance_specular = lerp(radiance_specular_0, radiance_specular_1, material_lobe_mix);
 	return radiance_specular;
 }
@@ -211,6 +754,71 @@ float3 EvaluateVectorFormFactorOverQuad(float3 vertices_tangent_space[4])
 	return vector_form_factor_over_quad;
 }
 
+float3 EvaluateVectorFormFactorOverQuadClipped(float3x3 linear_transform_inversed, float3 vertices_tangent_space[4])
+{
+	// [Heitz 2016] [Eric Heitz, Jonathan Dupuy, Stephen Hill, David Neubelt. "Real-Time Polygonal-Light Shading with Linearly Transformed Cosines." SIGGRAPH 2016.](https://eheitzresearch.wordpress.com/415-2/)
+	// ClipQuadToHorizon
+
+	// fast path: the quad is entirely above the horizon (or the horizon-clipping is approximated by the proxy sphere, see "EvaluateFormFactorOverQuad")
+	if ((!LTC_PERMUTATION_HORIZON_CLIPPING) || vertices_tangent_space[0].z > 0.0 && vertices_tangent_space[1].z > 0.0 && vertices_tangent_space[2].z > 0.0 && vertices_tangent_space[3].z > 0.0)
+	{
+		float3 vertices_tangent_space_linear_transformed[4] = {
+			mul(linear_transform_inversed, vertices_tangent_space[0]),
+			mul(linear_transform_inversed, vertices_tangent_space[1]),
+			mul(linear_transform_inversed, vertices_tangent_space[2]),
+			mul(linear_transform_inversed, vertices_tangent_space[3]) };
+
+		return EvaluateVectorFormFactorOverQuad(vertices_tangent_space_linear_transformed);
+	}
+
+	// Each edge is clipped independently instead of building the clipped polygon (3 to 5 vertices).
+	// The convex quad leaves the upper hemisphere at most once, the horizon edge from the exit point to the entry point closes the clipped polygon.
+	// The linear transform maps the segments to the segments, such that the clipping can be performed before the linear transform.
+	float3 vector_form_factor_over_quad = float3(0.0, 0.0, 0.0);
+	float3 exit_point = float3(0.0, 0.0, 0.0);
+	float3 entry_point = float3(0.0, 0.0, 0.0);
+	bool any_above = false;
+
+	[unroll]
+	for (int edge_index = 0; edge_index < 4; ++edge_index)
+	{
+		float3 v1 = vertices_tangent_space[edge_index];
+		float3 v2 = vertices_tangent_space[(edge_index + 1) & 3];
+		bool v1_above = (v1.z > 0.0);
+		bool v2_above = (v2.z > 0.0);
+
+		if (v1_above || v2_above)
+		{
+			// only used if the edge straddles (the denominator is NOT zero)
+			float3 horizon_point = v1 + (v2 - v1) * (v1.z / (v1.z - v2.z));
+			horizon_point.z = 0.0;
+
+			if (!v2_above)
+			{
+				exit_point = horizon_point;
+			}
+
+			if (!v1_above)
+			{
+				entry_point = horizon_point;
+			}
+
+			float3 v1_clipped = v1_above ? v1 : horizon_point;
+			float3 v2_clipped = v2_above ? v2 : horizon_point;
+			vector_form_factor_over_quad += EvaluateVectorFormFactorOverQuadEdge(normalize(mul(linear_transform_inversed, v1_clipped)), normalize(mul(linear_transform_inversed, v2_clipped)));
+
+			any_above = true;
+		}
+	}
+
+	if (any_above)
+	{
+		vector_form_factor_over_quad += EvaluateVectorFormFactorOverQuadEdge(normalize(mul(linear_transform_inversed, exit_point)), normalize(mul(linear_transform_inversed, entry_point)));
+	}
+
+	return vector_form_factor_over_quad;
+}
+
 float3 EvaluateVectorFormFactorOverQuadEdge(float3 v1, float3 v2)
 {
 	// [Hill 2016] [Stephen Hill, Eric Heitz. "Real-Time Area Lighting: a Journey from Research to Production." SIGGRAPH 2016.](https://blog.selfshadow.com/publications/s2016-advances/)
@@ -257,10 +865,262 @@ float EvaluateFormFactorOverSphere(float cos_omega, float sin_sigma)
 	}
 #else
 	// Unity3D: PolygonIrradianceFromVectorFormFactor
-	form_factor_over_sphere = sin_sigma * sin_sigma * (sin_sigma * sin_sigma + cos_omega) / (sin_sigma * sin_sigma + 1.0);
+	// The fit is negative if the proxy sphere is below the horizon (the surface faces away from the light).
+	form_factor_over_sphere = max(sin_sigma * sin_sigma * (sin_sigma * sin_sigma + cos_omega) / (sin_sigma * sin_sigma + 1.0), 0.0);
 #endif
 
 	return form_factor_over_sphere;
 }
 
+float EvaluateFormFactorOverDisk(float3 vector_form_factor_over_disk)
+{
+	// The same as the quad: the horizon-clipping is approximated by the proxy sphere with the same vector form factor
+	float cos_elevation_angle = normalize(vector_form_factor_over_disk).z;
+	float sin_angular_extent = sqrt(length(vector_form_factor_over_disk));
+
+	float form_factor_over_sphere = EvaluateFormFactorOverSphere(cos_elevation_angle, sin_angular_extent);
+
+	return form_factor_over_sphere;
+}
+
+float3 EvaluateVectorFormFactorOverDisk(float3 disk_tangent_space[3])
+{
+	// [Heitz 2017] [Eric Heitz, Stephen Hill. "Real-Time Line- and Disk-Light Shading." SIGGRAPH 2017.](https://blog.selfshadow.com/publications/s2017-shading-course/)
+	// The solid angle subtended by the ellipse is an elliptic cone, which is symmetric with respect to the average direction.
+
+	float3 C = disk_tangent_space[0];
+	float3 V1 = disk_tangent_space[1];
+	float3 V2 = disk_tangent_space[2];
+
+	// The conjugate semi-axes are NOT necessarily orthogonal after the linear transform.
+	// Find the principal axes by the eigen decomposition.
+	float a;
+	float b;
+	{
+		float d11 = dot(V1, V1);
+		float d22 = dot(V2, V2);
+		float d12 = dot(V1, V2);
+
+		if (abs(d12) / sqrt(d11 * d22) > 0.0001)
+		{
+			float tr = d11 + d22;
+			float det = sqrt(max(-d12 * d12 + d11 * d22, 0.0));
+
+			// use sqrt matrix to solve for eigenvalues
+			float u = 0.5 * sqrt(max(tr - 2.0 * det, 0.0));
+			float v = 0.5 * sqrt(tr + 2.0 * det);
+			float e_max = (u + v) * (u + v);
+			float e_min = (u - v) * (u - v);
+
+			float3 V1_;
+			float3 V2_;
+			if (d11 > d22)
+			{
+				V1_ = d12 * V1 + (e_max - d11) * V2;
+				V2_ = d12 * V1 + (e_min - d11) * V2;
+			}
+			else
+			{
+				V1_ = d12 * V2 + (e_max - d22) * V1;
+				V2_ = d12 * V2 + (e_min - d22) * V1;
+			}
+
+			a = 1.0 / e_max;
+			b = 1.0 / e_min;
+			V1 = normalize(V1_);
+			V2 = normalize(V2_);
+		}
+		else
+		{
+			a = 1.0 / dot(V1, V1);
+			b = 1.0 / dot(V2, V2);
+			V1 *= sqrt(a);
+			V2 *= sqrt(b);
+		}
+	}
+
+	float3 V3 = cross(V1, V2);
+	if (dot(C, V3) < 0.0)
+	{
+		V3 *= -1.0;
+	}
+
+	// The distance from the origin to the plane of the ellipse
+	float L = max(dot(V3, C), 1e-7);
+	float x0 = dot(V1, C) / L;
+	float y0 = dot(V2, C) / L;
+
+	a *= L * L;
+	b *= L * L;
+
+	// The eigenvalues of the cone
+	float c0 = a * b;
+	float c1 = a * b * (1.0 + x0 * x0 + y0 * y0) - a - b;
+	float c2 = 1.0 - a * (1.0 + x0 * x0) - b * (1.0 + y0 * y0);
+	float c3 = 1.0;
+
+	float3 roots = SolveCubic(float4(c0, c1, c2, c3));
+	float e1 = roots.x;
+	float e2 = roots.y;
+	float e3 = roots.z;
+
+	float3 average_direction = float3(a * x0 / (a - e2), b * y0 / (b - e2), 1.0);
+	average_direction = normalize(V1 * average_direction.x + V2 * average_direction.y + V3 * average_direction.z);
+
+	float L1 = sqrt(-e2 / e3);
+	float L2 = sqrt(-e2 / e1);
+
+	// The form factor of the elliptic cone without horizon-clipping
+	float form_factor_over_disk = L1 * L2 * rsqrt((1.0 + L1 * L1) * (1.0 + L2 * L2));
+
+	return average_direction * form_factor_over_disk;
+}
+
+float3 SolveCubic(float4 coefficient)
+{
+	// [Blinn 2007] [James F. Blinn. "How to Solve a Cubic Equation, Part 5: Back to Numerics." IEEE Computer Graphics and Applications 2007.](https://ieeexplore.ieee.org/document/4178165)
+
+	// Normalize the polynomial
+	coefficient.xyz /= coefficient.w;
+	// Divide middle coefficients by three
+	coefficient.yz /= 3.0;
+
+	float A = coefficient.w;
+	float B = coefficient.z;
+	float C = coefficient.y;
+	float D = coefficient.x;
+
+	// Compute the Hessian and the discriminant
+	float3 delta = float3(
+		-coefficient.z * coefficient.z + coefficient.y,
+		-coefficient.y * coefficient.z + coefficient.x,
+		dot(float2(coefficient.z, -coefficient.y), coefficient.xy));
+
+	float discriminant = dot(float2(4.0 * delta.x, -delta.y), delta.zy);
+
+	// Algorithm A
+	float2 xlc;
+	{
+		float C_a = delta.x;
+		float D_a = -2.0 * B * delta.x + delta.y;
+
+		// Take the cubic root of a normalized complex number
+		float theta = atan2(sqrt(discriminant), -D_a) / 3.0;
+
+		float x_1a = 2.0 * sqrt(-C_a) * cos(theta);
+		float x_3a = 2.0 * sqrt(-C_a) * cos(theta + (2.0 / 3.0) * PI);
+
+		float xl = ((x_1a + x_3a) > 2.0 * B) ? x_1a : x_3a;
+
+		xlc = float2(xl - B, A);
+	}
+
+	// Algorithm D
+	float2 xsc;
+	{
+		float C_d = delta.z;
+		float D_d = -D * delta.y + 2.0 * C * delta.z;
+
+		// Take the cubic root of a normalized complex number
+		float theta = atan2(D * sqrt(discriminant), -D_d) / 3.0;
+
+		float x_1d = 2.0 * sqrt(-C_d) * cos(theta);
+		float x_3d = 2.0 * sqrt(-C_d) * cos(theta + (2.0 / 3.0) * PI);
+
+		float xs = ((x_1d + x_3d) < 2.0 * C) ? x_1d : x_3d;
+
+		xsc = float2(-D, xs + C);
+	}
+
+	float E = xlc.y * xsc.y;
+	float F = -xlc.x * xsc.y - xlc.y * xsc.x;
+	float G = xlc.x * xsc.x;
+
+	float2 xmc = float2(C * F - B * G, -B * F + C * E);
+
+	float3 root = float3(xsc.x / xsc.y, xmc.x / xmc.y, xlc.x / xlc.y);
+
+	if (root.x < root.y && root.x < root.z)
+	{
+		root.xyz = root.yxz;
+	}
+	else if (root.z < root.x && root.z < root.y)
+	{
+		root.xyz = root.xzy;
+	}
+
+	return root;
+}
+
+float EvaluateFormFactorOverLine(float3x3 linear_transform_inversed, float3 line_vertices_tangent_space[2])
+{
+	// [Heitz 2017] [Eric Heitz, Stephen Hill. "Real-Time Line- and Disk-Light Shading." SIGGRAPH 2017.](https://blog.selfshadow.com/publications/s2017-shading-course/)
+
+	// LT "linear transform"
+	float3 line_vertices_cosine_space[2] = {
+		mul(linear_transform_inversed, line_vertices_tangent_space[0]),
+		mul(linear_transform_inversed, line_vertices_tangent_space[1]) };
+
+	float form_factor_over_line_cosine = EvaluateFormFactorOverLineCosine(line_vertices_cosine_space);
+
+	// The width of the line is NOT preserved by the linear transform.
+	// The width factor is given by the normal of the plane, which contains the line and the origin, transformed by the inverse-transpose of the linear transform.
+	float3 r0 = linear_transform_inversed[0];
+	float3 r1 = linear_transform_inversed[1];
+	float3 r2 = linear_transform_inversed[2];
+
+	// inverse(transpose(M)) = cofactor(M) / determinant(M)
+	float3x3 linear_transform_inversed_cofactor = float3x3(
+		cross(r1, r2), // row 0
+		cross(r2, r0), // row 1
+		cross(r0, r1)  // row 2
+	);
+	float linear_transform_inversed_determinant = dot(r0, cross(r1, r2));
+
+	float3 plane_normal = normalize(cross(line_vertices_tangent_space[0], line_vertices_tangent_space[1]));
+	float width_factor = abs(linear_transform_inversed_determinant) / max(length(mul(linear_transform_inversed_cofactor, plane_normal)), 1e-7);
+
+	return width_factor * form_factor_over_line_cosine;
+}
+
+float EvaluateFormFactorOverLineCosine(float3 line_vertices_cosine_space[2])
+{
+	float3 p1 = line_vertices_cosine_space[0];
+	float3 p2 = line_vertices_cosine_space[1];
+
+	float3 wt = normalize(p2 - p1);
+
+	// Clip the line to upper hemisphere
+	if (p1.z <= 0.0 && p2.z <= 0.0)
+	{
+		return 0.0;
+	}
+	else if (p1.z < 0.0)
+	{
+		p1 = (p1 * p2.z - p2 * p1.z) / (p2.z - p1.z);
+	}
+	else if (p2.z < 0.0)
+	{
+		p2 = (p2 * p1.z - p1 * p2.z) / (p1.z - p2.z);
+	}
+
+	// Parameterize the line by the orthonormal projection of the origin
+	float l1 = dot(p1, wt);
+	float l2 = dot(p2, wt);
+	float3 po = p1 - l1 * wt;
+	float d = max(length(po), 1e-7);
+
+	// The ribbon element faces the origin: cos(θ_light) = d / |po + l·wt|
+	// (1 / PI) ∫ d · (po + l·wt).z / |po + l·wt|^4 dl = (1 / 2PI) (po.z · Fpo(l) + wt.z · Fwt(l))
+	float d2 = d * d;
+	float fpo_l1 = l1 / (d * (d2 + l1 * l1)) + atan(l1 / d) / d2;
+	float fpo_l2 = l2 / (d * (d2 + l2 * l2)) + atan(l2 / d) / d2;
+	float fwt_l1 = (l1 * l1) / (d * (d2 + l1 * l1));
+	float fwt_l2 = (l2 * l2) / (d * (d2 + l2 * l2));
+
+	float form_factor_over_line = ((fpo_l2 - fpo_l1) * po.z + (fwt_l2 - fwt_l1) * wt.z) / (2.0 * PI);
+
+	return max(form_factor_over_line, 0.0);
+}
+
 #endif
\ No newline at end of file
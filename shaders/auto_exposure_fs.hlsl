@@ -0,0 +1,93 @@
+// The exposure adapted to the histogram of the "auto_exposure_histogram_fs.hlsl" (see "RENDER_BACKEND_PROGRAM_AUTO_EXPOSURE" in "code/backend/render_backend.h").
+// The same as the "AutoExposureAdapt" and the "AutoExposureFromLuminance" of the "code/cpu/auto_exposure.h".
+
+cbuffer _unused_name_uniform_buffer_global_layout_per_frame_binding : register(b3)
+{
+	column_major float4x4 previous_view_projection_transform;
+	uint checkerboard_parity;
+	uint checkerboard_width_scale;
+	uint history_valid;
+	uint exposure_valid;
+};
+
+Texture2D histogram : register(t0);
+Texture2D previous_exposure : register(t1);
+
+// the same as the "code/cpu/auto_exposure.h"
+#define AUTO_EXPOSURE_HISTOGRAM_BIN_COUNT 64
+static const float auto_exposure_log2_min = -10.0;
+static const float auto_exposure_log2_max = 6.0;
+static const uint auto_exposure_histogram_group_count = 16;
+static const float auto_exposure_low_percentile = 0.5;
+static const float auto_exposure_high_percentile = 0.95;
+static const float auto_exposure_key = 1.0;
+static const float auto_exposure_log2_exposure_min = -6.0;
+static const float auto_exposure_log2_exposure_max = 6.0;
+static const float auto_exposure_adaptation_brighter = 0.1;
+static const float auto_exposure_adaptation_darker = 0.05;
+
+void main(
+	in float4 d3d_Position
+	: SV_POSITION,
+	  in float2 in_uv
+	: TEXCOORD0,
+	  out float4 out_color
+	: SV_TARGET0)
+{
+	// the sum over the groups
+	float bins[AUTO_EXPOSURE_HISTOGRAM_BIN_COUNT];
+	float total_count = 0.0;
+	for (int bin_index = 0; bin_index < AUTO_EXPOSURE_HISTOGRAM_BIN_COUNT; ++bin_index)
+	{
+		float count = 0.0;
+		for (uint group = 0; group < auto_exposure_histogram_group_count; ++group)
+		{
+			count += histogram.Load(int3(bin_index, group, 0)).x;
+		}
+		bins[bin_index] = count;
+		total_count += count;
+	}
+
+	float previous_log2_luminance = previous_exposure.Load(int3(0, 0, 0)).y;
+
+	float adapted_log2_luminance;
+	if (total_count > 0.0)
+	{
+		// the part of each bin within the percentiles, weighted by the center of the bin
+		float window_begin = total_count * auto_exposure_low_percentile;
+		float window_end = total_count * auto_exposure_high_percentile;
+		float cumulative_count = 0.0;
+		float window_count = 0.0;
+		float window_log2_luminance = 0.0;
+		for (int bin_index = 0; bin_index < AUTO_EXPOSURE_HISTOGRAM_BIN_COUNT; ++bin_index)
+		{
+			float bin_begin = cumulative_count;
+			cumulative_count += bins[bin_index];
+			float count = max(min(cumulative_count, window_end) - max(bin_begin, window_begin), 0.0);
+
+			float bin_log2_luminance = auto_exposure_log2_min + (float(bin_index) + 0.5) * ((auto_exposure_log2_max - auto_exposure_log2_min) / float(AUTO_EXPOSURE_HISTOGRAM_BIN_COUNT));
+			window_count += count;
+			window_log2_luminance += count * bin_log2_luminance;
+		}
+
+		float average_log2_luminance = window_log2_luminance / window_count;
+		if (0 != exposure_valid)
+		{
+			float adaptation = (average_log2_luminance > previous_log2_luminance) ? auto_exposure_adaptation_brighter : auto_exposure_adaptation_darker;
+			adapted_log2_luminance = previous_log2_luminance + (average_log2_luminance - previous_log2_luminance) * adaptation;
+		}
+		else
+		{
+			adapted_log2_luminance = average_log2_luminance;
+		}
+	}
+	else
+	{
+		// nothing to meter
+		adapted_log2_luminance = (0 != exposure_valid) ? previous_log2_luminance : log2(auto_exposure_key);
+	}
+
+	float exposure = exp2(clamp(log2(auto_exposure_key) - adapted_log2_luminance, auto_exposure_log2_exposure_min, auto_exposure_log2_exposure_max));
+
+	out_color = float4(exposure, adapted_log2_luminance, 0.0, 1.0);
+}
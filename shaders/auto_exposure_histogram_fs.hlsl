@@ -0,0 +1,46 @@
+// The histogram of the log2 luminance of the HDR color (see "RENDER_BACKEND_PROGRAM_AUTO_EXPOSURE_HISTOGRAM" in "code/backend/render_backend.h").
+// The histogram is gathered instead of scattered (neither the UAV nor the blending is used): the texel (bin, group) counts the bilinear taps of the rows of its group which fall into its bin.
+
+SamplerState linear_sampler : register(s0);
+
+Texture2D in_color : register(t0);
+
+// the same as the "code/cpu/auto_exposure.h"
+static const float auto_exposure_histogram_bin_count = 64.0;
+static const float auto_exposure_log2_min = -10.0;
+static const float auto_exposure_log2_max = 6.0;
+static const uint auto_exposure_tap_grid_size = 64;
+static const uint auto_exposure_histogram_group_count = 16;
+
+void main(
+	in float4 d3d_Position
+	: SV_POSITION,
+	  in float2 in_uv
+	: TEXCOORD0,
+	  out float4 out_color
+	: SV_TARGET0)
+{
+	float bin = floor(d3d_Position.x);
+	uint group = uint(d3d_Position.y);
+
+	static const uint group_row_count = auto_exposure_tap_grid_size / auto_exposure_histogram_group_count;
+
+	float count = 0.0;
+	for (uint row = group * group_row_count; row < ((group + 1) * group_row_count); ++row)
+	{
+		for (uint column = 0; column < auto_exposure_tap_grid_size; ++column)
+		{
+			float2 uv = (float2(column, row) + 0.5) * (1.0 / float(auto_exposure_tap_grid_size));
+			float3 color = in_color.SampleLevel(linear_sampler, uv, 0.0).rgb;
+
+			// Rec. 709
+			float luminance = dot(color, float3(0.2126, 0.7152, 0.0722));
+
+			// the pixels below the range (the background) are NOT counted, the pixels above are counted by the last bin
+			float tap_bin = min(floor((log2(max(luminance, exp2(auto_exposure_log2_min))) - auto_exposure_log2_min) * (auto_exposure_histogram_bin_count / (auto_exposure_log2_max - auto_exposure_log2_min))), auto_exposure_histogram_bin_count - 1.0);
+			count += (luminance >= exp2(auto_exposure_log2_min) && tap_bin == bin) ? 1.0 : 0.0;
+		}
+	}
+
+	out_color = float4(count, 0.0, 0.0, 1.0);
+}
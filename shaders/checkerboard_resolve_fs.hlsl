@@ -0,0 +1,118 @@
+// The reconstruction of the checkerboard shading (see "RENDER_BACKEND_PROGRAM_CHECKERBOARD_RESOLVE" in "code/backend/render_backend.h").
+// The shaded pixel is copied from the half width target of the "deferred_lighting_fs.hlsl".
+// The skipped pixel is the history (the output of the previous frame, reprojected by the camera of the previous frame) clamped to the range of the 4 shaded neighbors,
+// or the neighbors weighted by the similarity of the depth and the normal if the history is NOT valid or off screen.
+// [El Mansouri 2016] Jalal El Mansouri. "Rendering Rainbow Six Siege." GDC 2016.
+
+cbuffer _unused_name_uniform_buffer_global_layout_per_view_binding : register(b0)
+{
+	column_major float4x4 view_transform;
+	column_major float4x4 projection_transform;
+	float3 eye_position;
+	float _padding_eye_position;
+};
+
+cbuffer _unused_name_uniform_buffer_global_layout_per_frame_binding : register(b3)
+{
+	column_major float4x4 previous_view_projection_transform;
+	uint checkerboard_parity;
+	uint checkerboard_width_scale;
+	uint history_valid;
+	uint exposure_valid;
+};
+
+SamplerState history_sampler : register(s0);
+
+Texture2D checkerboard_color : register(t0);
+Texture2D gbuffer_position : register(t1);
+Texture2D gbuffer_normal : register(t2);
+Texture2D history_color : register(t3);
+
+// the relative distance to the tangent plane at which the neighbor is rejected
+#define CHECKERBOARD_PLANE_DISTANCE_SCALE 64.0
+#define CHECKERBOARD_NORMAL_POWER 8.0
+
+void main(
+	in float4 d3d_Position
+	: SV_POSITION,
+	  in float2 in_uv
+	: TEXCOORD0,
+	  out float4 out_color
+	: SV_TARGET0)
+{
+	int2 pixel = int2(d3d_Position.xy);
+
+	float4 position = gbuffer_position.Load(int3(pixel, 0));
+	if (position.w <= 0.0)
+	{
+		// the same as the cleared color of the deferred lighting
+		out_color = float4(0.0, 0.0, 0.0, 1.0);
+		return;
+	}
+
+	if (0 == ((pixel.x + pixel.y + int(checkerboard_parity)) & 1))
+	{
+		out_color = float4(checkerboard_color.Load(int3(pixel.x / 2, pixel.y, 0)).rgb, 1.0);
+		return;
+	}
+
+	float3 P = position.xyz;
+	float3 N = normalize(gbuffer_normal.Load(int3(pixel, 0)).xyz);
+	float eye_distance = max(length(eye_position - P), 1e-4);
+
+	float gbuffer_width;
+	float gbuffer_height;
+	gbuffer_position.GetDimensions(gbuffer_width, gbuffer_height);
+
+	// the 4 neighbors are all shaded by the current frame
+	const int2 neighbor_offsets[4] = {int2(-1, 0), int2(1, 0), int2(0, -1), int2(0, 1)};
+
+	float3 spatial_sum = float3(0.0, 0.0, 0.0);
+	float spatial_weight_sum = 0.0;
+	float3 neighbor_min = float3(1e+30, 1e+30, 1e+30);
+	float3 neighbor_max = float3(0.0, 0.0, 0.0);
+	int neighbor_count = 0;
+	[unroll] for (int neighbor_index = 0; neighbor_index < 4; ++neighbor_index)
+	{
+		int2 neighbor_pixel = pixel + neighbor_offsets[neighbor_index];
+		if (any(neighbor_pixel < int2(0, 0)) || any(neighbor_pixel >= int2(gbuffer_width, gbuffer_height)))
+		{
+			continue;
+		}
+
+		float4 neighbor_position = gbuffer_position.Load(int3(neighbor_pixel, 0));
+		if (neighbor_position.w <= 0.0)
+		{
+			continue;
+		}
+
+		float3 neighbor_normal = normalize(gbuffer_normal.Load(int3(neighbor_pixel, 0)).xyz);
+		float3 neighbor_color = checkerboard_color.Load(int3(neighbor_pixel.x / 2, neighbor_pixel.y, 0)).rgb;
+
+		float plane_distance = abs(dot(N, neighbor_position.xyz - P)) / eye_distance;
+		float weight = pow(saturate(dot(N, neighbor_normal)), CHECKERBOARD_NORMAL_POWER) * saturate(1.0 - plane_distance * CHECKERBOARD_PLANE_DISTANCE_SCALE);
+
+		spatial_sum += neighbor_color * weight;
+		spatial_weight_sum += weight;
+		neighbor_min = min(neighbor_min, neighbor_color);
+		neighbor_max = max(neighbor_max, neighbor_color);
+		++neighbor_count;
+	}
+
+	// the isolated pixel (e.g. the silhouette of the thin geometry) keeps the unweighted range
+	float3 spatial_color = (spatial_weight_sum > 0.0) ? (spatial_sum / spatial_weight_sum) : ((neighbor_count > 0) ? (0.5 * (neighbor_min + neighbor_max)) : float3(0.0, 0.0, 0.0));
+
+	float3 color = spatial_color;
+	if (0 != history_valid && neighbor_count > 0)
+	{
+		float4 previous_clip_position = mul(previous_view_projection_transform, float4(P, 1.0));
+		float2 previous_uv = float2(0.5, -0.5) * (previous_clip_position.xy / previous_clip_position.w) + float2(0.5, 0.5);
+		if (previous_clip_position.w > 0.0 && all(previous_uv >= float2(0.0, 0.0)) && all(previous_uv <= float2(1.0, 1.0)))
+		{
+			// the clamp rejects the history which is disoccluded or changed by the light
+			color = clamp(history_color.SampleLevel(history_sampler, previous_uv, 0.0).rgb, neighbor_min, neighbor_max);
+		}
+	}
+
+	out_color = float4(color, 1.0);
+}
@@ -0,0 +1,49 @@
+// The full screen lighting of the G-buffer written by the "plane_gbuffer_fs.hlsl", the LTC is evaluated once per pixel regardless of the overdraw.
+// With the checkerboard, only half of the pixels are shaded into the half width target (see "checkerboard_resolve_fs.hlsl").
+
+#include "plane_lighting.hlsli"
+
+cbuffer _unused_name_uniform_buffer_global_layout_per_frame_binding : register(b3)
+{
+	column_major float4x4 previous_view_projection_transform;
+	uint checkerboard_parity;
+	uint checkerboard_width_scale;
+	uint history_valid;
+	uint exposure_valid;
+};
+
+Texture2D gbuffer_position : register(t3);
+Texture2D gbuffer_normal : register(t4);
+Texture2D gbuffer_diffuse_color : register(t5);
+Texture2D gbuffer_specular_color : register(t6);
+
+void main(
+	in float4 d3d_Position
+	: SV_POSITION,
+	  in float2 in_uv
+	: TEXCOORD0,
+	  out float4 out_color
+	: SV_TARGET0)
+{
+	// the pixel of the G-buffer (the same pixel if the "checkerboard_width_scale" is 1)
+	int2 pixel = int2(d3d_Position.xy);
+	// the packed checkerboard: the pixel "x" of which "(x + y + checkerboard_parity) & 1" is 0 is at "x / 2"
+	pixel.x = pixel.x * int(checkerboard_width_scale) + ((pixel.y + int(checkerboard_parity)) & 1) * (int(checkerboard_width_scale) - 1);
+	int3 texel = int3(pixel, 0);
+
+	float4 position = gbuffer_position.Load(texel);
+	if (position.w <= 0.0)
+	{
+		discard;
+	}
+
+	float4 normal = gbuffer_normal.Load(texel);
+
+	float3 P = position.xyz;
+	float3 N = normal.xyz;
+	float3 V = normalize(eye_position - P);
+	float3 diffuse_color = gbuffer_diffuse_color.Load(texel).rgb;
+	float3 specular_color = gbuffer_specular_color.Load(texel).rgb;
+
+	out_color = float4(EvaluatePlaneLighting(P, N, V, diffuse_color, specular_color, normal.w), 1.0);
+}
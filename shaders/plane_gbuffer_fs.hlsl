@@ -0,0 +1,41 @@
+// The G-buffer of the deferred shading (see "RENDER_BACKEND_PROGRAM_PLANE_GBUFFER" in "code/backend/render_backend.h"), the lighting is evaluated by the "deferred_lighting_fs.hlsl".
+
+cbuffer _unused_name_uniform_buffer_global_layout_per_material_binding : register(b2)
+{
+	// mesh
+	column_major float4x4 model_transform;
+	float3 dcolor;
+	float _padding_dcolor;
+	float3 scolor;
+	float _padding_scolor;
+	float roughness;
+};
+
+float3 ToLinear(float3 v)
+{
+	return pow(v, 2.2);
+}
+
+void main(
+	in float4 d3d_Position
+	: SV_POSITION,
+	  in float3 in_position
+	: TEXCOORD0,
+	  in float3 in_normal
+	: TEXCOORD1,
+	  out float4 out_position
+	: SV_TARGET0,
+	  out float4 out_normal
+	: SV_TARGET1,
+	  out float4 out_diffuse_color
+	: SV_TARGET2,
+	  out float4 out_specular_color
+	: SV_TARGET3)
+{
+	// w: the coverage, the cleared texels (0.0) are NOT lit
+	out_position = float4(in_position, 1.0);
+	// the same interpolated normal as the forward shading (NOT renormalized)
+	out_normal = float4(in_normal, roughness);
+	out_diffuse_color = float4(ToLinear(dcolor), 1.0);
+	out_specular_color = float4(ToLinear(scolor), 1.0);
+}
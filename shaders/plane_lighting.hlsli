@@ -0,0 +1,126 @@
+// The lighting of the plane by the rect light, shared by the forward ("plane_fs.hlsl") and the deferred ("deferred_lighting_fs.hlsl") shading.
+// https://github.com/selfshadow/ltc_code/tree/master/webgl/shaders/ltc/ltc_quad.fs
+
+cbuffer _unused_name_uniform_buffer_global_layout_per_view_binding : register(b0)
+{
+	column_major float4x4 view_transform;
+	column_major float4x4 projection_transform;
+	float3 eye_position;
+	float _padding_eye_position;
+};
+
+cbuffer _unused_name_uniform_buffer_global_layout_per_light_set_binding : register(b1)
+{
+	float4 rect_light_vetices[4];
+	float intensity;
+	float twoSided;
+	float4 light_texture_uv_scale_bias;
+};
+
+SamplerState ltc_lut_sampler : register(s0);
+Texture2DArray ltc_matrix_lut : register(t0);
+Texture2DArray ltc_norm_lut : register(t1);
+
+// The prefiltered light texture (see "code/cpu/texture_prefilter.h")
+SamplerState light_texture_sampler : register(s1);
+Texture2D light_texture : register(t2);
+
+float3 ToLinear(float3 v)
+{
+	return pow(v, 2.2);
+}
+
+#include "BRDF.hlsli"
+
+void LTC_DECODE_GGX_LUT(float roughness, float NoV, out float3x3 linear_transform_inversed, out float n_d_norm, out float f_d_norm);
+
+float3 LTC_SAMPLE_FILTERED_LIGHT_TEXTURE(float2 uv, float footprint_radius);
+
+// The permutation is defined by the build (see "RENDER_BACKEND_PERMUTATION_BIT" in "code/backend/render_backend.h"), the "twoSided" of the light set is NOT read by the shader.
+#ifndef LTC_PERMUTATION_TWO_SIDED
+#define LTC_PERMUTATION_TWO_SIDED 0
+#endif
+
+#include "LTC.hlsli"
+
+// [in] diffuse_color, specular_color: linear
+float3 EvaluatePlaneLighting(float3 P, float3 N, float3 V, float3 diffuse_color, float3 specular_color, float roughness)
+{
+	const float3 points[4] = {rect_light_vetices[0].xyz, rect_light_vetices[1].xyz, rect_light_vetices[2].xyz, rect_light_vetices[3].xyz};
+	const float3 lcol = float3(intensity, intensity, intensity);
+
+	// The reversed quad is on the same side of the horizon.
+	const int light_horizon = EvaluateBRDFLTCLightHorizon(P, N, points);
+
+	float3 col = float3(0.0, 0.0, 0.0);
+#if LTC_PERMUTATION_TWO_SIDED
+	{
+		if (EvaluateBRDFLTCLightAttenuation(P, points) > 0.0 && LTC_HORIZON_BELOW != light_horizon)
+		{
+			col += lcol * EvaluateBRDFLTCTextured(diffuse_color, roughness, specular_color, P, N, V, points);
+		}
+
+		// The facing of the quad is determined by the winding order of the vertices.
+		// The reversed order starts from the vertex "1" such that the light texture is mirrored horizontally (NOT flipped vertically) on the back face.
+		const float3 points_reverse[4] = {points[1], points[0], points[3], points[2]};
+		if (EvaluateBRDFLTCLightAttenuation(P, points_reverse) > 0.0 && LTC_HORIZON_BELOW != light_horizon)
+		{
+			col += lcol * EvaluateBRDFLTCTextured(diffuse_color, roughness, specular_color, P, N, V, points_reverse);
+		}
+	}
+#else
+	{
+		if (EvaluateBRDFLTCLightAttenuation(P, points) > 0.0 && LTC_HORIZON_BELOW != light_horizon)
+		{
+			col += lcol * EvaluateBRDFLTCTextured(diffuse_color, roughness, specular_color, P, N, V, points);
+		}
+	}
+#endif
+
+	return col;
+}
+
+#define LTC_GGX_LUT_INDEX 0
+
+void LTC_DECODE_GGX_LUT(float roughness, float NoV, out float3x3 linear_transform_inversed, out float n_d_norm, out float f_d_norm)
+{
+	float out_width;
+	float out_height;
+	float out_elements;
+	float out_number_of_levels;
+	ltc_matrix_lut.GetDimensions(0, out_width, out_height, out_elements, out_number_of_levels);
+
+	float LUT_SIZE = out_width;
+	float LUT_SCALE = (LUT_SIZE - 1.0) / LUT_SIZE;
+	float LUT_BIAS = 0.5 / LUT_SIZE;
+
+	float2 lut_uv = LUT_BIAS + LUT_SCALE * float2(roughness, sqrt(1.0 - NoV));
+	float4 ltc_ggx_matrix_lut_encoded = ltc_matrix_lut.SampleLevel(ltc_lut_sampler, float3(lut_uv, float(LTC_GGX_LUT_INDEX)), 0.0).rgba;
+	float2 ltc_ggx_norm_lut_encoded = ltc_norm_lut.SampleLevel(ltc_lut_sampler, float3(lut_uv, float(LTC_GGX_LUT_INDEX)), 0.0).rg;
+
+	linear_transform_inversed = float3x3(
+		float3(ltc_ggx_matrix_lut_encoded.x, 0.0, ltc_ggx_matrix_lut_encoded.z), // row 0
+		float3(0.0, 1.0, 0.0),													 // row 1
+		float3(ltc_ggx_matrix_lut_encoded.y, 0.0, ltc_ggx_matrix_lut_encoded.w)  // row 2
+	);
+
+	n_d_norm = ltc_ggx_norm_lut_encoded.x;
+	f_d_norm = ltc_ggx_norm_lut_encoded.y;
+}
+
+float3 LTC_SAMPLE_FILTERED_LIGHT_TEXTURE(float2 uv, float footprint_radius)
+{
+	float out_width;
+	float out_height;
+	float out_number_of_levels;
+	light_texture.GetDimensions(0, out_width, out_height, out_number_of_levels);
+
+	// The light image occupies the center of the border extended texture.
+	float2 light_texture_uv = uv * light_texture_uv_scale_bias.xy + light_texture_uv_scale_bias.zw;
+
+	// The level "n" is blurred by the footprint of 2^n texels of the level 0.
+	float light_image_size = max(out_width * light_texture_uv_scale_bias.x, out_height * light_texture_uv_scale_bias.y);
+	float lod = clamp(log2(max(footprint_radius * light_image_size, 1.0)), 0.0, out_number_of_levels - 1.0);
+
+	return light_texture.SampleLevel(light_texture_sampler, light_texture_uv, lod).rgb;
+}
\ No newline at end of file
@@ -1,26 +1,28 @@
-cbuffer _unused_name_uniform_buffer_global_layout_per_frame_binding : register(b0)
+cbuffer _unused_name_uniform_buffer_global_layout_per_view_binding : register(b0)
 {
-	// mesh
-	column_major float4x4 model_transform;
-	float3 dcolor;
-	float _padding_dcolor;
-	float3 scolor;
-	float _padding_scolor;
-	float roughness;
-	float _padding_roughness_1;
-	float _padding_roughness_2;
-	float _padding_roughness_3;
-
-	// camera
 	column_major float4x4 view_transform;
 	column_major float4x4 projection_transform;
 	float3 eye_position;
 	float _padding_eye_position;
+};
 
-	// light
+cbuffer _unused_name_uniform_buffer_global_layout_per_light_set_binding : register(b1)
+{
 	float4 rect_light_vetices[4];
 	float intensity;
 	float twoSided;
+	float4 light_texture_uv_scale_bias;
+};
+
+cbuffer _unused_name_uniform_buffer_global_layout_per_material_binding : register(b2)
+{
+	// mesh
+	column_major float4x4 model_transform;
+	float3 dcolor;
+	float _padding_dcolor;
+	float3 scolor;
+	float _padding_scolor;
+	float roughness;
 };
 
 void main(
@@ -1,21 +1,26 @@
-cbuffer _unused_name_uniform_buffer_global_layout_per_frame_binding : register(b0)
+cbuffer _unused_name_uniform_buffer_global_layout_per_light_set_binding : register(b1)
 {
-	// camera
-	column_major float4x4 view_transform;
-	column_major float4x4 projection_transform;
-
-	// light
 	float4 rect_light_vetices[4];
 	float intensity;
+	float twoSided;
+	float4 light_texture_uv_scale_bias;
 };
 
+// The prefiltered light texture (see "code/cpu/texture_prefilter.h")
+SamplerState light_texture_sampler : register(s0);
+Texture2D light_texture : register(t0);
+
 void main(
 	in float4 d3d_Position : SV_POSITION,
+	in float2 in_uv : TEXCOORD0,
 	out float4 out_color : SV_TARGET0
 	)
 {
 	const float3 lcol = float3(intensity, intensity, intensity);
 
-	float3 col = lcol;
+	// The light image occupies the center of the border extended texture.
+	float2 light_texture_uv = in_uv * light_texture_uv_scale_bias.xy + light_texture_uv_scale_bias.zw;
+
+	float3 col = lcol * light_texture.Sample(light_texture_sampler, light_texture_uv).rgb;
 	out_color = float4(col, 1.0);
 }
\ No newline at end of file
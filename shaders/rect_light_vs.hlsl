@@ -1,21 +1,32 @@
-cbuffer _unused_name_uniform_buffer_global_layout_per_frame_binding : register(b0)
+cbuffer _unused_name_uniform_buffer_global_layout_per_view_binding : register(b0)
 {
-	// camera
 	column_major float4x4 view_transform;
 	column_major float4x4 projection_transform;
+	float3 eye_position;
+	float _padding_eye_position;
+};
 
-	// light
+cbuffer _unused_name_uniform_buffer_global_layout_per_light_set_binding : register(b1)
+{
 	float4 rect_light_vetices[4];
 	float intensity;
+	float twoSided;
+	float4 light_texture_uv_scale_bias;
 };
 
 void main(
 	in uint d3d_VertexID  : SV_VertexID, 
-	out float4 d3d_Position : SV_POSITION
+	out float4 d3d_Position : SV_POSITION,
+	out float2 out_uv : TEXCOORD0
 	)
 {
-	float3 world_position = rect_light_vetices[d3d_VertexID].xyz;
+	// the light set is in the order of the quad
+	const uint strip_to_quad[4] = { 0U, 1U, 3U, 2U };
+	float3 world_position = rect_light_vetices[strip_to_quad[d3d_VertexID]].xyz;
 	float4 clip_position = mul(projection_transform, mul(view_transform, float4(world_position, 1.0)));
 
+	// triangle strip: (0, 1) (1, 1) (0, 0) (1, 0)
+	out_uv = float2(float(d3d_VertexID & 1U), 1.0 - float(d3d_VertexID >> 1U));
+
 	d3d_Position = clip_position;
 }
\ No newline at end of file